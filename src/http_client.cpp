@@ -5,12 +5,14 @@
  */
 
 #include "http_client.hpp"
+#include <cerrno>
 #include <cstring>
 #include <sstream>
 #include <chrono>
 #include <iomanip>
 #include <array>
 #include <cstdlib>
+#include <mutex>
 
 #ifdef __APPLE__
 #include <CoreFoundation/CoreFoundation.h>
@@ -86,6 +88,98 @@ bool load_macos_system_roots(SSL_CTX *ctx) {
 }
 #endif
 
+// Resumable sessions by HttpTLS session key (scheme, host, port, verify mode)
+std::mutex g_session_mu;
+std::map<std::string, SSL_SESSION *> g_sessions;
+
+int on_new_session(SSL *ssl, SSL_SESSION *session) {
+  auto *key = static_cast<const std::string *>(SSL_get_app_data(ssl));
+  if (!key || key->empty()) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> lk(g_session_mu);
+  SSL_SESSION *&slot = g_sessions[*key];
+  if (slot) {
+    SSL_SESSION_free(slot);
+  }
+  slot = session;
+  return 1; // Keep the reference
+}
+
+SSL_CTX *create_client_context(bool verify_cert, levython::http::HttpError &err) {
+  using levython::http::HttpError;
+  using levython::http::HttpErrorType;
+  const SSL_METHOD *method = TLS_client_method();
+  SSL_CTX *ctx = SSL_CTX_new(method);
+  if (!ctx) {
+    err = HttpError(HttpErrorType::TLS, "Failed to create SSL context");
+    return nullptr;
+  }
+
+  // Set options for security
+  long ssl_opts = SSL_OP_NO_SSLv2 | SSL_OP_NO_SSLv3;
+#ifdef SSL_OP_IGNORE_UNEXPECTED_EOF
+  // OpenSSL 3 compatibility: tolerate peers that omit close_notify.
+  ssl_opts |= SSL_OP_IGNORE_UNEXPECTED_EOF;
+#endif
+  SSL_CTX_set_options(ctx, ssl_opts);
+  SSL_CTX_set_mode(ctx, SSL_MODE_AUTO_RETRY);
+
+  if (verify_cert) {
+    SSL_CTX_set_verify(ctx, SSL_VERIFY_PEER, nullptr);
+    bool ca_loaded = SSL_CTX_set_default_verify_paths(ctx) == 1;
+
+    // Fallback CA bundle locations (helps with non-standard OpenSSL installs)
+    if (!ca_loaded) {
+      const char *env_cert_file = std::getenv("SSL_CERT_FILE");
+      const char *env_cert_dir = std::getenv("SSL_CERT_DIR");
+      if (env_cert_file || env_cert_dir) {
+        if (SSL_CTX_load_verify_locations(ctx, env_cert_file, env_cert_dir) == 1) {
+          ca_loaded = true;
+        }
+      }
+    }
+
+    if (!ca_loaded) {
+      static const std::array<const char *, 6> kCaBundlePaths = {
+          "/etc/ssl/cert.pem",                            // macOS common
+          "/private/etc/ssl/cert.pem",                    // macOS alt
+          "/etc/ssl/certs/ca-certificates.crt",           // Debian/Ubuntu
+          "/etc/pki/tls/certs/ca-bundle.crt",             // RHEL/CentOS
+          "/etc/ssl/ca-bundle.pem",                       // SUSE/OpenSUSE
+          "/usr/local/etc/openssl@3/cert.pem"};           // Homebrew OpenSSL
+      for (const char *path : kCaBundlePaths) {
+        if (SSL_CTX_load_verify_locations(ctx, path, nullptr) == 1) {
+          ca_loaded = true;
+          break;
+        }
+      }
+    }
+
+#ifdef __APPLE__
+    // On macOS, also load roots from Keychain to match system trust behavior.
+    if (load_macos_system_roots(ctx)) {
+      ca_loaded = true;
+    }
+#endif
+
+    if (!ca_loaded) {
+      SSL_CTX_free(ctx);
+      err = HttpError(HttpErrorType::TLS,
+                      "Could not load system CA certificates for TLS verification");
+      return nullptr;
+    }
+  } else {
+    SSL_CTX_set_verify(ctx, SSL_VERIFY_NONE, nullptr);
+  }
+
+  // Client-side session cache: new sessions (including TLS 1.3 tickets that
+  // arrive after the handshake) are handed to on_new_session
+  SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+  SSL_CTX_sess_set_new_cb(ctx, on_new_session);
+  return ctx;
+}
+
 } // namespace
 
 namespace levython {
@@ -437,16 +531,30 @@ HttpError HttpSocket::recv(void *buffer, size_t len, size_t &bytes_read,
 }
 
 void HttpSocket::close() {
-  if (connected_) {
+  // Also reached for sockets whose connect failed, which never set connected_
 #ifdef _WIN32
+  if (sock_ != INVALID_SOCKET) {
     closesocket(sock_);
     sock_ = INVALID_SOCKET;
+  }
 #else
+  if (sock_ >= 0) {
     ::close(sock_);
     sock_ = -1;
+  }
 #endif
-    connected_ = false;
+  connected_ = false;
+}
+
+bool HttpSocket::is_idle_alive() {
+  if (!connected_) {
+    return false;
   }
+  fd_set fds;
+  FD_ZERO(&fds);
+  FD_SET(sock_, &fds);
+  struct timeval tv = {0, 0};
+  return select((int)sock_ + 1, &fds, nullptr, nullptr, &tv) == 0;
 }
 
 HttpError HttpSocket::set_nonblocking() {
@@ -506,22 +614,31 @@ HttpError HttpSocket::wait_for_io(bool for_read, int timeout_ms) {
 // TLS/SSL IMPLEMENTATION
 // ============================================================================
 
-bool HttpTLS::ssl_initialized_ = false;
+static std::once_flag ssl_init_once;
 
 void HttpTLS::init_openssl() {
-  if (!ssl_initialized_) {
+  std::call_once(ssl_init_once, [] {
     SSL_load_error_strings();
     SSL_library_init();
     OpenSSL_add_all_algorithms();
-    ssl_initialized_ = true;
-  }
+  });
 }
 
 void HttpTLS::cleanup_openssl() {
-  if (ssl_initialized_) {
-    EVP_cleanup();
-    ERR_free_strings();
-  }
+  EVP_cleanup();
+  ERR_free_strings();
+}
+
+SSL_CTX *HttpTLS::shared_context(bool verify_cert, HttpError &err) {
+  // Built once per mode and never freed: pooled connections and cached
+  // sessions refer to it for the life of the process
+  static std::once_flag once[2];
+  static SSL_CTX *contexts[2] = {nullptr, nullptr};
+  static HttpError errors[2];
+  int i = verify_cert ? 1 : 0;
+  std::call_once(once[i], [i, verify_cert] { contexts[i] = create_client_context(verify_cert, errors[i]); });
+  err = errors[i];
+  return contexts[i];
 }
 
 HttpTLS::HttpTLS() : ctx_(nullptr), ssl_(nullptr), socket_(nullptr), connected_(false) {
@@ -531,73 +648,17 @@ HttpTLS::HttpTLS() : ctx_(nullptr), ssl_(nullptr), socket_(nullptr), connected_(
 HttpTLS::~HttpTLS() { close(); }
 
 HttpError HttpTLS::connect(HttpSocket *socket, const std::string &hostname,
-                           bool verify_cert) {
+                           bool verify_cert, const std::string &session_key) {
   if (!socket || !socket->is_connected()) {
     return HttpError(HttpErrorType::NETWORK, "Invalid socket");
   }
 
   socket_ = socket;
 
-  // Create SSL context
-  const SSL_METHOD *method = TLS_client_method();
-  ctx_ = SSL_CTX_new(method);
+  HttpError ctx_err;
+  ctx_ = shared_context(verify_cert, ctx_err);
   if (!ctx_) {
-    return HttpError(HttpErrorType::TLS, "Failed to create SSL context");
-  }
-
-  // Set options for security
-  long ssl_opts = SSL_OP_NO_SSLv2 | SSL_OP_NO_SSLv3;
-#ifdef SSL_OP_IGNORE_UNEXPECTED_EOF
-  // OpenSSL 3 compatibility: tolerate peers that omit close_notify.
-  ssl_opts |= SSL_OP_IGNORE_UNEXPECTED_EOF;
-#endif
-  SSL_CTX_set_options(ctx_, ssl_opts);
-  SSL_CTX_set_mode(ctx_, SSL_MODE_AUTO_RETRY);
-
-  if (verify_cert) {
-    SSL_CTX_set_verify(ctx_, SSL_VERIFY_PEER, nullptr);
-    bool ca_loaded = SSL_CTX_set_default_verify_paths(ctx_) == 1;
-
-    // Fallback CA bundle locations (helps with non-standard OpenSSL installs)
-    if (!ca_loaded) {
-      const char *env_cert_file = std::getenv("SSL_CERT_FILE");
-      const char *env_cert_dir = std::getenv("SSL_CERT_DIR");
-      if (env_cert_file || env_cert_dir) {
-        if (SSL_CTX_load_verify_locations(ctx_, env_cert_file, env_cert_dir) == 1) {
-          ca_loaded = true;
-        }
-      }
-    }
-
-    if (!ca_loaded) {
-      static const std::array<const char *, 6> kCaBundlePaths = {
-          "/etc/ssl/cert.pem",                            // macOS common
-          "/private/etc/ssl/cert.pem",                    // macOS alt
-          "/etc/ssl/certs/ca-certificates.crt",           // Debian/Ubuntu
-          "/etc/pki/tls/certs/ca-bundle.crt",             // RHEL/CentOS
-          "/etc/ssl/ca-bundle.pem",                       // SUSE/OpenSUSE
-          "/usr/local/etc/openssl@3/cert.pem"};           // Homebrew OpenSSL
-      for (const char *path : kCaBundlePaths) {
-        if (SSL_CTX_load_verify_locations(ctx_, path, nullptr) == 1) {
-          ca_loaded = true;
-          break;
-        }
-      }
-    }
-
-#ifdef __APPLE__
-    // On macOS, also load roots from Keychain to match system trust behavior.
-    if (load_macos_system_roots(ctx_)) {
-      ca_loaded = true;
-    }
-#endif
-
-    if (!ca_loaded) {
-      return HttpError(HttpErrorType::TLS,
-                       "Could not load system CA certificates for TLS verification");
-    }
-  } else {
-    SSL_CTX_set_verify(ctx_, SSL_VERIFY_NONE, nullptr);
+    return ctx_err;
   }
 
   // Create SSL object
@@ -627,6 +688,17 @@ HttpError HttpTLS::connect(HttpSocket *socket, const std::string &hostname,
   // Attach socket
   SSL_set_fd(ssl_, (int)socket_->native_handle());
 
+  // Offer the last session for this host so the handshake can resume it
+  session_key_ = session_key;
+  SSL_set_app_data(ssl_, &session_key_);
+  if (!session_key_.empty()) {
+    std::lock_guard<std::mutex> lk(g_session_mu);
+    auto it = g_sessions.find(session_key_);
+    if (it != g_sessions.end()) {
+      SSL_set_session(ssl_, it->second);
+    }
+  }
+
   // Perform handshake (non-blocking sockets may return WANT_READ/WANT_WRITE)
   auto deadline =
       std::chrono::steady_clock::now() + std::chrono::milliseconds(DEFAULT_CONNECT_TIMEOUT_MS);
@@ -773,10 +845,7 @@ void HttpTLS::close() {
     SSL_free(ssl_);
     ssl_ = nullptr;
   }
-  if (ctx_) {
-    SSL_CTX_free(ctx_);
-    ctx_ = nullptr;
-  }
+  ctx_ = nullptr;
   connected_ = false;
   socket_ = nullptr;
 }
@@ -805,7 +874,7 @@ HttpError HttpTLS::verify_certificate(const std::string &hostname) {
 // ============================================================================
 
 std::string HttpProtocol::build_request(const HttpRequest &req,
-                                         const ParsedURL &url) {
+                                         const ParsedURL &url, bool keep_alive) {
   std::ostringstream oss;
 
   // Request line
@@ -849,7 +918,7 @@ std::string HttpProtocol::build_request(const HttpRequest &req,
     oss << "Accept: */*\r\n";
   }
   if (!has_connection) {
-    oss << "Connection: close\r\n";
+    oss << (keep_alive ? "Connection: keep-alive\r\n" : "Connection: close\r\n");
   }
 
   // Content-Length for POST/PUT/PATCH
@@ -871,30 +940,32 @@ HttpError HttpProtocol::parse_response(const std::string &raw,
     return HttpError(HttpErrorType::PROTOCOL, "Malformed response: no header/body separator");
   }
 
-  std::string header_block = raw.substr(0, header_end);
-  std::string body = raw.substr(header_end + 4);
+  std::string version;
+  HttpError err = parse_head(raw.substr(0, header_end), resp, version);
+  if (err.has_error())
+    return err;
+
+  // Store body
+  resp.body.assign(raw.begin() + header_end + 4, raw.end());
+
+  return HttpError(); // Success
+}
 
+HttpError HttpProtocol::parse_head(const std::string &header_block,
+                                   HttpResponse &resp, std::string &version) {
   // Parse status line
   size_t first_newline = header_block.find("\r\n");
-  if (first_newline == std::string::npos) {
-    return HttpError(HttpErrorType::PROTOCOL, "Malformed status line");
-  }
-
   std::string status_line = header_block.substr(0, first_newline);
-  HttpError err = parse_status_line(status_line, resp.status);
+  HttpError err = parse_status_line(status_line, resp.status, version);
   if (err.has_error())
     return err;
 
   // Parse headers
-  std::string headers_only = header_block.substr(first_newline + 2);
-  err = parse_headers(headers_only, resp.headers);
-  if (err.has_error())
-    return err;
-
-  // Store body
-  resp.body.assign(body.begin(), body.end());
-
-  return HttpError(); // Success
+  resp.headers.clear();
+  if (first_newline != std::string::npos) {
+    err = parse_headers(header_block.substr(first_newline + 2), resp.headers);
+  }
+  return err;
 }
 
 std::string HttpProtocol::method_to_string(HttpMethod method) {
@@ -916,10 +987,10 @@ std::string HttpProtocol::method_to_string(HttpMethod method) {
   }
 }
 
-HttpError HttpProtocol::parse_status_line(const std::string &line, int &status) {
+HttpError HttpProtocol::parse_status_line(const std::string &line, int &status,
+                                          std::string &http_version) {
   // Parse: HTTP/1.1 200 OK
   std::istringstream iss(line);
-  std::string http_version;
   iss >> http_version >> status;
 
   if (iss.fail() || status < 100 || status > 599) {
@@ -963,6 +1034,399 @@ std::string HttpProtocol::normalize_header_name(const std::string &name) {
   return util::to_lower(name);
 }
 
+// ============================================================================
+// INCREMENTAL RESPONSE PARSER IMPLEMENTATION
+// ============================================================================
+
+void HttpResponseParser::reset(bool head_request) {
+  buf_.clear();
+  pos_ = 0;
+  scan_ = 0;
+  state_ = State::HEAD;
+  head_request_ = head_request;
+  keep_alive_ = false;
+  eof_ = false;
+  remaining_ = 0;
+  body_bytes_ = 0;
+}
+
+void HttpResponseParser::feed(const char *data, size_t len) {
+  // Drop consumed bytes first; body pointers handed out so far expire here
+  if (pos_ > 0 && (pos_ == buf_.size() || pos_ >= READ_BUFFER_SIZE)) {
+    buf_.erase(0, pos_);
+    scan_ -= std::min(scan_, pos_);
+    pos_ = 0;
+  }
+  buf_.append(data, len);
+}
+
+bool HttpResponseParser::take_line(size_t &line_end) {
+  line_end = buf_.find("\r\n", pos_);
+  return line_end != std::string::npos;
+}
+
+HttpError HttpResponseParser::begin_body(HttpResponse &resp, const std::string &version) {
+  std::string connection = util::to_lower(resp.header("connection"));
+  keep_alive_ = version == "HTTP/1.1" ? connection.find("close") == std::string::npos
+                                      : connection.find("keep-alive") != std::string::npos;
+  std::string content_length = resp.header("content-length");
+
+  if (resp.status == 101) {
+    keep_alive_ = false; // The connection now speaks another protocol
+    state_ = State::DONE;
+  } else if (head_request_ || resp.status == 204 || resp.status == 304) {
+    state_ = State::DONE; // No body, whatever the headers say
+  } else if (util::to_lower(resp.header("transfer-encoding")).find("chunked") !=
+             std::string::npos) {
+    state_ = State::CHUNK_SIZE;
+  } else if (!content_length.empty()) {
+    try {
+      remaining_ = std::stoull(content_length);
+    } catch (...) {
+      return HttpError(HttpErrorType::PROTOCOL, "Invalid Content-Length");
+    }
+    state_ = State::BODY_LENGTH;
+  } else {
+    keep_alive_ = false; // Body runs until the server closes the connection
+    state_ = State::BODY_EOF;
+  }
+  return HttpError();
+}
+
+HttpError HttpResponseParser::next(HttpResponse &resp, Event &event,
+                                   const char *&data, size_t &len) {
+  data = nullptr;
+  len = 0;
+  auto truncated = [](const char *what) {
+    return HttpError(HttpErrorType::PROTOCOL, std::string("Connection closed mid-") + what);
+  };
+
+  while (true) {
+    size_t avail = buf_.size() - pos_;
+    size_t line_end = 0;
+    switch (state_) {
+    case State::HEAD: {
+      size_t header_end = buf_.find("\r\n\r\n", scan_);
+      if (header_end == std::string::npos) {
+        if (eof_) {
+          return HttpError(HttpErrorType::PROTOCOL,
+                           avail == 0 ? "Connection closed before response"
+                                      : "Malformed response: no header/body separator");
+        }
+        scan_ = std::max(pos_, buf_.size() >= 3 ? buf_.size() - 3 : 0);
+        event = Event::NEED_MORE;
+        return HttpError();
+      }
+      std::string version;
+      HttpError err = HttpProtocol::parse_head(buf_.substr(pos_, header_end - pos_), resp, version);
+      if (err.has_error())
+        return err;
+      pos_ = header_end + 4;
+      scan_ = pos_;
+      if (resp.status < 200 && resp.status != 101)
+        continue; // Interim response; the real one follows
+      err = begin_body(resp, version);
+      if (err.has_error())
+        return err;
+      event = Event::HEAD;
+      return HttpError();
+    }
+
+    case State::BODY_LENGTH:
+    case State::CHUNK_DATA:
+      if (remaining_ == 0) {
+        state_ = state_ == State::CHUNK_DATA ? State::CHUNK_CRLF : State::DONE;
+        continue;
+      }
+      if (avail == 0) {
+        if (eof_)
+          return truncated(state_ == State::CHUNK_DATA ? "chunk" : "body");
+        event = Event::NEED_MORE;
+        return HttpError();
+      }
+      len = static_cast<size_t>(std::min<uint64_t>(avail, remaining_));
+      data = buf_.data() + pos_;
+      pos_ += len;
+      remaining_ -= len;
+      body_bytes_ += len;
+      event = Event::BODY;
+      return HttpError();
+
+    case State::CHUNK_SIZE: {
+      if (!take_line(line_end)) {
+        if (eof_)
+          return truncated("chunk");
+        event = Event::NEED_MORE;
+        return HttpError();
+      }
+      // Chunk extensions after the size are ignored
+      const char *digits = buf_.c_str() + pos_;
+      char *digits_end = nullptr;
+      errno = 0;
+      unsigned long long size = std::strtoull(digits, &digits_end, 16);
+      if (digits_end == digits || errno == ERANGE) {
+        return HttpError(HttpErrorType::PROTOCOL, "Malformed chunk size");
+      }
+      pos_ = line_end + 2;
+      remaining_ = size;
+      state_ = size == 0 ? State::TRAILERS : State::CHUNK_DATA;
+      continue;
+    }
+
+    case State::CHUNK_CRLF:
+      if (avail < 2) {
+        if (eof_)
+          return truncated("chunk");
+        event = Event::NEED_MORE;
+        return HttpError();
+      }
+      if (buf_[pos_] != '\r' || buf_[pos_ + 1] != '\n') {
+        return HttpError(HttpErrorType::PROTOCOL, "Malformed chunk terminator");
+      }
+      pos_ += 2;
+      state_ = State::CHUNK_SIZE;
+      continue;
+
+    case State::TRAILERS: {
+      // Trailer fields, up to the closing blank line
+      if (!take_line(line_end)) {
+        if (eof_)
+          return truncated("trailer");
+        event = Event::NEED_MORE;
+        return HttpError();
+      }
+      bool blank = line_end == pos_;
+      pos_ = line_end + 2;
+      if (blank)
+        state_ = State::DONE;
+      continue;
+    }
+
+    case State::BODY_EOF:
+      if (avail > 0) {
+        data = buf_.data() + pos_;
+        len = avail;
+        pos_ += avail;
+        body_bytes_ += avail;
+        event = Event::BODY;
+        return HttpError();
+      }
+      if (eof_) {
+        state_ = State::DONE;
+        continue;
+      }
+      event = Event::NEED_MORE;
+      return HttpError();
+
+    case State::DONE:
+      event = Event::DONE;
+      return HttpError();
+    }
+  }
+}
+
+// ============================================================================
+// CONNECTION POOL IMPLEMENTATION
+// ============================================================================
+
+HttpError ConnectionPool::acquire(const ParsedURL &url, bool verify_ssl, int timeout_ms,
+                                  std::unique_ptr<PooledConnection> &conn, bool &reused) {
+  std::string key = url.scheme + "://" + url.host + ":" + std::to_string(url.port);
+  if (url.is_https && !verify_ssl) {
+    key += " (unverified)"; // Never hand an unverified session to a verified request
+  }
+  reused = false;
+
+  {
+    std::unique_lock<std::mutex> lk(mu_);
+    Host &host = hosts_[key];
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (true) {
+      prune(host, std::chrono::steady_clock::now());
+      while (!host.idle.empty()) {
+        conn = std::move(host.idle.back());
+        host.idle.pop_back();
+        if (conn->socket.is_idle_alive()) {
+          reused = true;
+          stats_.reused++;
+          return HttpError(); // Success
+        }
+        conn.reset(); // Closed by the server while idle
+        host.open--;
+      }
+      if (host.open < max_per_host_)
+        break;
+      if (available_.wait_until(lk, deadline) == std::cv_status::timeout &&
+          host.open >= max_per_host_ && host.idle.empty()) {
+        return HttpError(HttpErrorType::TIMEOUT,
+                         "Timed out waiting for a free connection to " + key);
+      }
+    }
+    host.open++;
+  }
+
+  conn = std::make_unique<PooledConnection>();
+  conn->key = key;
+  conn->https = url.is_https;
+  HttpError err = conn->socket.connect(url.host, url.port, DEFAULT_CONNECT_TIMEOUT_MS);
+  if (!err.has_error() && url.is_https) {
+    err = conn->tls.connect(&conn->socket, url.host, verify_ssl, key);
+  }
+  if (err.has_error()) {
+    release(std::move(conn), false);
+    return err;
+  }
+
+  std::lock_guard<std::mutex> lk(mu_);
+  stats_.created++;
+  if (conn->https && conn->tls.session_reused())
+    stats_.resumed++;
+  return HttpError(); // Success
+}
+
+void ConnectionPool::release(std::unique_ptr<PooledConnection> conn, bool reusable) {
+  if (!conn)
+    return;
+  std::unique_ptr<PooledConnection> closing; // Closed after the lock is dropped
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    Host &host = hosts_[conn->key];
+    if (reusable && idle_timeout_ms_ > 0) {
+      conn->idle_since = std::chrono::steady_clock::now();
+      host.idle.push_back(std::move(conn));
+    } else {
+      host.open--;
+      closing = std::move(conn);
+    }
+  }
+  available_.notify_one();
+}
+
+void ConnectionPool::set_limits(size_t max_per_host, int idle_timeout_ms) {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    max_per_host_ = std::max<size_t>(1, max_per_host);
+    idle_timeout_ms_ = std::max(0, idle_timeout_ms);
+  }
+  available_.notify_all();
+}
+
+void ConnectionPool::close_idle() {
+  std::vector<std::unique_ptr<PooledConnection>> closing;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    for (auto &entry : hosts_) {
+      Host &host = entry.second;
+      host.open -= host.idle.size();
+      for (auto &conn : host.idle)
+        closing.push_back(std::move(conn));
+      host.idle.clear();
+    }
+  }
+  available_.notify_all();
+}
+
+PoolStats ConnectionPool::stats() {
+  std::lock_guard<std::mutex> lk(mu_);
+  PoolStats result = stats_;
+  auto now = std::chrono::steady_clock::now();
+  for (auto &entry : hosts_) {
+    prune(entry.second, now);
+    result.open += entry.second.open;
+    result.idle += entry.second.idle.size();
+  }
+  return result;
+}
+
+void ConnectionPool::prune(Host &host, std::chrono::steady_clock::time_point now) {
+  auto timeout = std::chrono::milliseconds(idle_timeout_ms_);
+  auto expired = [&](const std::unique_ptr<PooledConnection> &conn) {
+    return now - conn->idle_since >= timeout;
+  };
+  size_t before = host.idle.size();
+  host.idle.erase(std::remove_if(host.idle.begin(), host.idle.end(), expired), host.idle.end());
+  host.open -= before - host.idle.size();
+}
+
+// ============================================================================
+// HTTP STREAM IMPLEMENTATION
+// ============================================================================
+
+namespace {
+
+// RFC 9110 9.2.2: a repeated request has the same effect as one, so it is
+// safe to resend when a connection dies before the response
+bool is_idempotent(HttpMethod method) {
+  return method != HttpMethod::POST && method != HttpMethod::PATCH;
+}
+
+// Run the parser to its next event, reading from the connection as needed.
+// `received` (optional) is set once any response byte has arrived.
+HttpError next_event(PooledConnection &conn, HttpResponseParser &parser,
+                     HttpResponse &resp, int timeout_ms,
+                     HttpResponseParser::Event &event, const char *&data,
+                     size_t &len, bool *received) {
+  char chunk[READ_BUFFER_SIZE];
+  while (true) {
+    HttpError err = parser.next(resp, event, data, len);
+    if (err.has_error() || event != HttpResponseParser::Event::NEED_MORE)
+      return err;
+
+    size_t bytes_read = 0;
+    err = conn.https ? conn.tls.recv(chunk, sizeof(chunk), bytes_read, timeout_ms)
+                     : conn.socket.recv(chunk, sizeof(chunk), bytes_read, timeout_ms);
+    if (err.has_error()) {
+      // A close-delimited body that stalls keeps what arrived
+      if (err.type == HttpErrorType::TIMEOUT && parser.reading_to_eof() &&
+          parser.body_bytes() > 0) {
+        parser.feed_eof();
+        continue;
+      }
+      return err;
+    }
+    if (bytes_read == 0) {
+      parser.feed_eof();
+      continue;
+    }
+    if (received)
+      *received = true;
+    parser.feed(chunk, bytes_read);
+  }
+}
+
+} // namespace
+
+bool HttpStream::read(std::string &out) {
+  out.clear();
+  if (!conn_)
+    return false;
+  while (true) {
+    HttpResponseParser::Event event;
+    const char *data = nullptr;
+    size_t len = 0;
+    HttpError err = next_event(*conn_, parser_, resp_, timeout_ms_, event, data, len, nullptr);
+    if (err.has_error()) {
+      resp_.error = err;
+      pool_->release(std::move(conn_), false);
+      return false;
+    }
+    if (event == HttpResponseParser::Event::DONE) {
+      pool_->release(std::move(conn_), parser_.reusable());
+      return false;
+    }
+    if (event == HttpResponseParser::Event::BODY) {
+      out.assign(data, len);
+      return true;
+    }
+  }
+}
+
+void HttpStream::close() {
+  // An unread body would be mistaken for the next response
+  if (conn_)
+    pool_->release(std::move(conn_), false);
+}
+
 // ============================================================================
 // HTTP CLIENT IMPLEMENTATION
 // ============================================================================
@@ -1063,72 +1527,157 @@ HttpResponse HttpClient::execute(const HttpRequest &req, int redirect_count) {
   if (resp.error.has_error())
     return resp;
 
-  // Create socket
-  HttpSocket socket;
-  HttpTLS tls;
-
-  // Connect
   int timeout = req.timeout_ms > 0 ? req.timeout_ms : default_timeout_ms_;
-  resp.error = socket.connect(url.host, url.port, DEFAULT_CONNECT_TIMEOUT_MS);
+  std::unique_ptr<PooledConnection> conn;
+  HttpResponseParser parser;
+  resp.error = begin_exchange(req, url, timeout, conn, parser, resp);
   if (resp.error.has_error())
     return resp;
 
-  // TLS handshake if HTTPS
-  if (url.is_https) {
-    resp.error = tls.connect(&socket, url.host, req.verify_ssl && verify_ssl_);
-    if (resp.error.has_error())
+  // Buffer the body
+  while (true) {
+    HttpResponseParser::Event event;
+    const char *data = nullptr;
+    size_t len = 0;
+    resp.error = next_event(*conn, parser, resp, timeout, event, data, len, nullptr);
+    if (!resp.error.has_error() && event == HttpResponseParser::Event::BODY &&
+        resp.body.size() + len > MAX_RESPONSE_SIZE) {
+      resp.error = HttpError(HttpErrorType::TOO_LARGE, "Response exceeds size limit");
+    }
+    if (resp.error.has_error()) {
+      pool_.release(std::move(conn), false);
       return resp;
+    }
+    if (event == HttpResponseParser::Event::DONE)
+      break;
+    resp.body.insert(resp.body.end(), data, data + len);
+  }
+  pool_.release(std::move(conn), parser.reusable());
+
+  auto end_time = std::chrono::high_resolution_clock::now();
+  resp.elapsed_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+
+  HttpRequest redirect_req;
+  if (redirect_request(req, url, resp, redirect_req)) {
+    return execute(redirect_req, redirect_count + 1);
+  }
+
+  return resp;
+}
+
+std::unique_ptr<HttpStream> HttpClient::open_stream(const HttpRequest &req) {
+  return open_stream(req, 0);
+}
+
+std::unique_ptr<HttpStream> HttpClient::open_stream(const HttpRequest &req,
+                                                    int redirect_count) {
+  int timeout = req.timeout_ms > 0 ? req.timeout_ms : default_timeout_ms_;
+  std::unique_ptr<HttpStream> stream(new HttpStream(&pool_, timeout));
+  HttpResponse &resp = stream->resp_;
+  resp.url = req.url;
+
+  auto start_time = std::chrono::high_resolution_clock::now();
+
+  if (redirect_count > MAX_REDIRECTS) {
+    resp.error = HttpError(HttpErrorType::REDIRECT_LOOP, "Too many redirects");
+    return stream;
   }
 
-  // Send request
-  resp.error = send_request(&socket, url.is_https ? &tls : nullptr, req, url);
+  ParsedURL url;
+  resp.error = ParsedURL::parse(req.url, url);
   if (resp.error.has_error())
-    return resp;
+    return stream;
 
-  // Receive response
-  resp.error = receive_response(&socket, url.is_https ? &tls : nullptr, resp, timeout);
+  resp.error = begin_exchange(req, url, timeout, stream->conn_, stream->parser_, resp);
   if (resp.error.has_error())
-    return resp;
+    return stream;
 
   auto end_time = std::chrono::high_resolution_clock::now();
   resp.elapsed_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
 
-  // Handle redirects
-  if (req.follow_redirects && resp.status >= 300 && resp.status < 400) {
-    std::string location = resp.header("location");
-    if (!location.empty()) {
-      HttpRequest redirect_req = req;
-      redirect_req.url = location;
-
-      // Handle relative URLs
-      if (!util::starts_with(location, "http://") &&
-          !util::starts_with(location, "https://")) {
-        redirect_req.url = url.scheme + "://" + url.host;
-        if ((url.is_https && url.port != 443) || (!url.is_https && url.port != 80)) {
-          redirect_req.url += ":" + std::to_string(url.port);
-        }
-        if (!util::starts_with(location, "/")) {
-          redirect_req.url += "/";
-        }
-        redirect_req.url += location;
-      }
+  HttpRequest redirect_req;
+  if (redirect_request(req, url, resp, redirect_req)) {
+    // Drain the redirect body so its connection can be reused
+    std::string discard;
+    while (stream->read(discard)) {
+    }
+    stream.reset();
+    return open_stream(redirect_req, redirect_count + 1);
+  }
 
-      // Change POST to GET on 301/302 (HTTP standard behavior)
-      if ((resp.status == 301 || resp.status == 302) && req.method == HttpMethod::POST) {
-        redirect_req.method = HttpMethod::GET;
-        redirect_req.body.clear();
-      }
+  return stream;
+}
+
+HttpError HttpClient::begin_exchange(const HttpRequest &req, const ParsedURL &url,
+                                     int timeout_ms, std::unique_ptr<PooledConnection> &conn,
+                                     HttpResponseParser &parser, HttpResponse &resp) {
+  bool verify = req.verify_ssl && verify_ssl_;
+  for (int attempt = 0;; ++attempt) {
+    // Pooled connection, or a new one (TCP plus TLS handshake if HTTPS)
+    bool reused = false;
+    HttpError err = pool_.acquire(url, verify, timeout_ms, conn, reused);
+    if (err.has_error())
+      return err;
 
-      return execute(redirect_req, redirect_count + 1);
+    parser.reset(req.method == HttpMethod::HEAD);
+    resp.status = 0;
+    resp.headers.clear();
+    resp.body.clear();
+    bool received = false;
+    err = send_request(&conn->socket, conn->https ? &conn->tls : nullptr, req, url);
+    if (!err.has_error()) {
+      HttpResponseParser::Event event;
+      const char *data = nullptr;
+      size_t len = 0;
+      err = next_event(*conn, parser, resp, timeout_ms, event, data, len, &received);
     }
+    if (!err.has_error())
+      return err;
+
+    pool_.release(std::move(conn), false);
+    // The server may close an idle connection just as we reuse it; retry
+    // once on a fresh one if it never answered. POST and PATCH may already
+    // have been acted on, so they report the error instead.
+    if (!(reused && !received && attempt == 0 && is_idempotent(req.method)))
+      return err;
   }
+}
 
-  return resp;
+bool HttpClient::redirect_request(const HttpRequest &req, const ParsedURL &url,
+                                  const HttpResponse &resp, HttpRequest &next) const {
+  if (!req.follow_redirects || resp.status < 300 || resp.status >= 400)
+    return false;
+  std::string location = resp.header("location");
+  if (location.empty())
+    return false;
+
+  next = req;
+  next.url = location;
+
+  // Handle relative URLs
+  if (!util::starts_with(location, "http://") &&
+      !util::starts_with(location, "https://")) {
+    next.url = url.scheme + "://" + url.host;
+    if ((url.is_https && url.port != 443) || (!url.is_https && url.port != 80)) {
+      next.url += ":" + std::to_string(url.port);
+    }
+    if (!util::starts_with(location, "/")) {
+      next.url += "/";
+    }
+    next.url += location;
+  }
+
+  // Change POST to GET on 301/302 (HTTP standard behavior)
+  if ((resp.status == 301 || resp.status == 302) && req.method == HttpMethod::POST) {
+    next.method = HttpMethod::GET;
+    next.body.clear();
+  }
+  return true;
 }
 
 HttpError HttpClient::send_request(HttpSocket *sock, HttpTLS *tls,
                                     const HttpRequest &req, const ParsedURL &url) {
-  std::string request_str = HttpProtocol::build_request(req, url);
+  std::string request_str = HttpProtocol::build_request(req, url, true);
 
   // Send headers
   HttpError err;
@@ -1154,81 +1703,6 @@ HttpError HttpClient::send_request(HttpSocket *sock, HttpTLS *tls,
   return HttpError(); // Success
 }
 
-HttpError HttpClient::receive_response(HttpSocket *sock, HttpTLS *tls,
-                                        HttpResponse &resp, int timeout_ms) {
-  std::string raw_response;
-  char buffer[READ_BUFFER_SIZE];
-  size_t total_read = 0;
-
-  // Read until connection closes or we have full response
-  while (true) {
-    size_t bytes_read = 0;
-    HttpError err;
-
-    if (tls) {
-      err = tls->recv(buffer, sizeof(buffer), bytes_read, timeout_ms);
-    } else {
-      err = sock->recv(buffer, sizeof(buffer), bytes_read, timeout_ms);
-    }
-
-    if (err.has_error()) {
-      // Timeout or error
-      if (err.type == HttpErrorType::TIMEOUT && total_read > 0) {
-        // We have partial data, try to parse it
-        break;
-      }
-      return err;
-    }
-
-    if (bytes_read == 0) {
-      // Connection closed
-      break;
-    }
-
-    raw_response.append(buffer, bytes_read);
-    total_read += bytes_read;
-
-    // Check size limit
-    if (total_read > MAX_RESPONSE_SIZE) {
-      return HttpError(HttpErrorType::TOO_LARGE, "Response exceeds size limit");
-    }
-
-    // Check if we have complete headers
-    size_t header_end = raw_response.find("\r\n\r\n");
-    if (header_end != std::string::npos) {
-      // Parse headers to check Content-Length
-      HttpResponse temp_resp;
-      HttpError parse_err = HttpProtocol::parse_response(raw_response, temp_resp);
-
-      std::string content_length_str = temp_resp.header("content-length");
-      if (!content_length_str.empty()) {
-        try {
-          size_t content_length = std::stoull(content_length_str);
-          size_t expected_total = header_end + 4 + content_length;
-
-          if (raw_response.size() >= expected_total) {
-            // We have the full response
-            break;
-          }
-        } catch (...) {
-          // Invalid Content-Length, continue reading until connection closes
-        }
-      } else {
-        // No Content-Length, check for chunked encoding or read until close
-        std::string transfer_encoding = temp_resp.header("transfer-encoding");
-        if (util::to_lower(transfer_encoding).find("chunked") != std::string::npos) {
-          // TODO: Implement chunked decoding
-          // For now, read until connection closes
-          continue;
-        }
-      }
-    }
-  }
-
-  // Parse response
-  return HttpProtocol::parse_response(raw_response, resp);
-}
-
 // ============================================================================
 // UTILITY FUNCTIONS IMPLEMENTATION
 // ============================================================================
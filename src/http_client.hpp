@@ -8,6 +8,8 @@
  * Features:
  * - Full HTTP/1.1 support (GET, POST, PUT, PATCH, DELETE, HEAD)
  * - HTTPS with TLS verification (OpenSSL)
+ * - Keep-alive connection pool, shared TLS context with session resumption
+ * - Incremental response parser and streamed response bodies
  * - Async + Sync APIs
  * - JSON integration
  * - Cross-platform (Linux, macOS, Windows)
@@ -22,10 +24,13 @@
 #define LEVYTHON_HTTP_CLIENT_HPP
 
 #include <algorithm>
+#include <condition_variable>
+#include <cstdint>
 #include <cstring>
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -72,6 +77,8 @@ constexpr int MAX_REDIRECTS = 10;
 constexpr size_t MAX_HEADER_SIZE = 8192;         // 8KB headers max
 constexpr size_t MAX_RESPONSE_SIZE = 104857600;  // 100MB max response
 constexpr size_t READ_BUFFER_SIZE = 16384;       // 16KB read buffer
+constexpr size_t DEFAULT_MAX_PER_HOST = 8;       // Open connections per (scheme, host, port)
+constexpr int DEFAULT_IDLE_TIMEOUT_MS = 30000;   // Idle pooled connections close after this
 
 // ============================================================================
 // ERROR TYPES
@@ -210,6 +217,9 @@ public:
   void close();
   bool is_connected() const { return connected_; }
   HttpError wait_for_io(bool for_read, int timeout_ms);
+  // An idle connection is reusable only if the peer has sent nothing (no
+  // EOF, no stray bytes) since the last response
+  bool is_idle_alive();
 
 #ifdef _WIN32
   SOCKET native_handle() const { return sock_; }
@@ -227,14 +237,17 @@ private:
 
 class HttpTLS {
 private:
-  SSL_CTX *ctx_;
+  SSL_CTX *ctx_; // Shared, see shared_context()
   SSL *ssl_;
   HttpSocket *socket_;
   bool connected_;
+  std::string session_key_; // Resumption cache key (SSL app data)
 
-  static bool ssl_initialized_;
   static void init_openssl();
   static void cleanup_openssl();
+  // One process-wide context per verification mode; handshakes resume
+  // cached sessions for the same session key
+  static SSL_CTX *shared_context(bool verify_cert, HttpError &err);
 
 public:
   HttpTLS();
@@ -245,10 +258,11 @@ public:
   HttpTLS &operator=(const HttpTLS &) = delete;
 
   HttpError connect(HttpSocket *socket, const std::string &hostname,
-                    bool verify_cert);
+                    bool verify_cert, const std::string &session_key = "");
   HttpError send(const void *data, size_t len);
   HttpError recv(void *buffer, size_t len, size_t &bytes_read, int timeout_ms);
   void close();
+  bool session_reused() const { return ssl_ && SSL_session_reused(ssl_) == 1; }
 
 private:
   HttpError verify_certificate(const std::string &hostname);
@@ -260,17 +274,158 @@ private:
 
 class HttpProtocol {
 public:
-  static std::string build_request(const HttpRequest &req, const ParsedURL &url);
+  static std::string build_request(const HttpRequest &req, const ParsedURL &url,
+                                   bool keep_alive = false);
   static HttpError parse_response(const std::string &raw, HttpResponse &resp);
+  // Status line and headers only (no trailing blank line)
+  static HttpError parse_head(const std::string &header_block, HttpResponse &resp,
+                              std::string &version);
   static std::string method_to_string(HttpMethod method);
 
 private:
-  static HttpError parse_status_line(const std::string &line, int &status);
+  static HttpError parse_status_line(const std::string &line, int &status,
+                                     std::string &version);
   static HttpError parse_headers(const std::string &header_block,
                                   std::map<std::string, std::string> &headers);
   static std::string normalize_header_name(const std::string &name);
 };
 
+/**
+ * Incremental response parser: status line, headers, then a body framed by
+ * Content-Length, chunked encoding or connection close
+ * Bytes are fed as they arrive and each next() call yields one event. Header
+ * scanning resumes where the previous feed stopped, and body bytes are handed
+ * out in place, so a response of any size is parsed in bounded memory.
+ * Interim 1xx responses (except 101) are skipped.
+ */
+class HttpResponseParser {
+public:
+  enum class Event {
+    NEED_MORE, // Feed more bytes (or feed_eof) and call next() again
+    HEAD,      // resp.status and resp.headers are set
+    BODY,      // data/len point at body bytes, valid until the next feed
+    DONE       // Response complete
+  };
+
+  // Start a new response; HEAD requests never carry a body
+  void reset(bool head_request);
+  void feed(const char *data, size_t len);
+  void feed_eof() { eof_ = true; }
+  HttpError next(HttpResponse &resp, Event &event, const char *&data, size_t &len);
+
+  // After DONE: the connection can carry another request
+  bool reusable() const {
+    return state_ == State::DONE && keep_alive_ && pos_ == buf_.size() && !eof_;
+  }
+  bool reading_to_eof() const { return state_ == State::BODY_EOF; }
+  uint64_t body_bytes() const { return body_bytes_; }
+
+private:
+  enum class State { HEAD, BODY_LENGTH, CHUNK_SIZE, CHUNK_DATA, CHUNK_CRLF,
+                     TRAILERS, BODY_EOF, DONE };
+  std::string buf_;
+  size_t pos_ = 0;  // First unconsumed byte
+  size_t scan_ = 0; // Where the header terminator search resumes
+  State state_ = State::HEAD;
+  bool head_request_ = false;
+  bool keep_alive_ = false;
+  bool eof_ = false;
+  uint64_t remaining_ = 0; // Bytes left in the body or current chunk
+  uint64_t body_bytes_ = 0;
+
+  HttpError begin_body(HttpResponse &resp, const std::string &version);
+  bool take_line(size_t &line_end);
+};
+
+// ============================================================================
+// CONNECTION POOL
+// ============================================================================
+
+struct PooledConnection {
+  std::string key; // scheme://host:port, plus the TLS verification mode
+  HttpSocket socket;
+  HttpTLS tls;
+  bool https = false;
+  std::chrono::steady_clock::time_point idle_since;
+};
+
+struct PoolStats {
+  size_t open = 0;    // Connections checked out or idle
+  size_t idle = 0;
+  size_t created = 0; // New TCP connections so far
+  size_t reused = 0;  // Requests served on a pooled connection
+  size_t resumed = 0; // TLS handshakes that resumed a cached session
+};
+
+/**
+ * Keep-alive connections keyed by (scheme, host, port)
+ * At most max_per_host connections to one key are open at a time; callers
+ * over the limit wait for one to come back. Idle connections are closed once
+ * they have been unused for idle_timeout_ms. Thread-safe.
+ */
+class ConnectionPool {
+public:
+  ConnectionPool() = default;
+  ConnectionPool(const ConnectionPool &) = delete;
+  ConnectionPool &operator=(const ConnectionPool &) = delete;
+
+  // Hand out an idle connection (reused = true) or open a new one
+  HttpError acquire(const ParsedURL &url, bool verify_ssl, int timeout_ms,
+                    std::unique_ptr<PooledConnection> &conn, bool &reused);
+  // Return a connection; it is closed unless `reusable`
+  void release(std::unique_ptr<PooledConnection> conn, bool reusable);
+  void set_limits(size_t max_per_host, int idle_timeout_ms);
+  void close_idle();
+  PoolStats stats();
+
+private:
+  struct Host {
+    std::vector<std::unique_ptr<PooledConnection>> idle; // Most recent last
+    size_t open = 0;
+  };
+  std::mutex mu_;
+  std::condition_variable available_;
+  std::map<std::string, Host> hosts_;
+  size_t max_per_host_ = DEFAULT_MAX_PER_HOST;
+  int idle_timeout_ms_ = DEFAULT_IDLE_TIMEOUT_MS;
+  PoolStats stats_;
+
+  void prune(Host &host, std::chrono::steady_clock::time_point now);
+};
+
+// ============================================================================
+// HTTP STREAM
+// ============================================================================
+
+/**
+ * A response whose body is read piece by piece instead of buffered
+ * response() holds the status and headers once the stream is open (or the
+ * error that prevented it). The connection goes back to the pool when the
+ * body has been read to the end, and is closed if the stream is dropped
+ * early. A stream must not outlive the HttpClient that opened it.
+ */
+class HttpStream {
+public:
+  HttpStream(const HttpStream &) = delete;
+  HttpStream &operator=(const HttpStream &) = delete;
+  ~HttpStream() { close(); }
+
+  const HttpResponse &response() const { return resp_; }
+  // Next piece of the body; false at the end of the body or on error
+  bool read(std::string &out);
+  void close();
+
+private:
+  friend class HttpClient;
+  HttpStream(ConnectionPool *pool, int timeout_ms) : pool_(pool), timeout_ms_(timeout_ms) {}
+
+  ConnectionPool *pool_;
+  int timeout_ms_;
+  std::unique_ptr<PooledConnection> conn_;
+  HttpResponseParser parser_;
+  HttpResponse resp_;
+};
+
 // ============================================================================
 // HTTP CLIENT
 // ============================================================================
@@ -279,6 +434,7 @@ class HttpClient {
 private:
   int default_timeout_ms_;
   bool verify_ssl_;
+  ConnectionPool pool_;
 
 public:
   HttpClient();
@@ -299,15 +455,26 @@ public:
   HttpResponse head(const std::string &url,
                     const std::map<std::string, std::string> &headers = {});
 
+  // Streaming API: redirects are followed, then the body is left unread
+  std::unique_ptr<HttpStream> open_stream(const HttpRequest &req);
+
   void set_default_timeout(int ms) { default_timeout_ms_ = ms; }
   void set_verify_ssl(bool verify) { verify_ssl_ = verify; }
+  ConnectionPool &pool() { return pool_; }
 
 private:
   HttpResponse execute(const HttpRequest &req, int redirect_count = 0);
   HttpError send_request(HttpSocket *sock, HttpTLS *tls,
                          const HttpRequest &req, const ParsedURL &url);
-  HttpError receive_response(HttpSocket *sock, HttpTLS *tls,
-                             HttpResponse &resp, int timeout_ms);
+  // Acquire a connection, send the request and read the response head.
+  // A reused connection that fails before answering is retried once.
+  HttpError begin_exchange(const HttpRequest &req, const ParsedURL &url,
+                           int timeout_ms, std::unique_ptr<PooledConnection> &conn,
+                           HttpResponseParser &parser, HttpResponse &resp);
+  // The request to follow for a redirect response, if any
+  bool redirect_request(const HttpRequest &req, const ParsedURL &url,
+                        const HttpResponse &resp, HttpRequest &next) const;
+  std::unique_ptr<HttpStream> open_stream(const HttpRequest &req, int redirect_count);
 };
 
 // ============================================================================
@@ -86,6 +86,15 @@
 #include <cctype>
 #include <cstdlib>
 #include <cstdio>
+#include <charconv>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>  // JSON string scanning
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>  // JSON scanning, tensor kernels
+#endif
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>  // Tensor kernels (AVX2, selected at run time)
+#endif
 #include <openssl/evp.h>
 #include <openssl/hmac.h>
 #include <openssl/rand.h>
@@ -168,6 +177,9 @@ extern "C" char **environ;
     #include <fcntl.h>     // For open()
     #include <unistd.h>    // For close(), getuid(), geteuid(), setuid()
     #include <signal.h>
+    #include <sys/time.h>  // setitimer (sampling profiler)
+    #include <sys/uio.h>   // writev (async logger)
+    #include <pthread.h>
     #include <sys/mount.h>
     #include <pwd.h>       // Password database (getpwuid)
     #include <grp.h>       // Group database (getgrgid)
@@ -185,6 +197,8 @@ extern "C" char **environ;
 #if __linux__
     #include <sys/sysinfo.h>
     #include <sys/inotify.h>  // For file system event monitoring
+    #include <sys/epoll.h>    // Async reactor readiness
+    #include <sys/eventfd.h>  // Async reactor wakeups
     #include <dlfcn.h>      // For dynamic library loading (hook injection)
     #include <sys/ptrace.h> // For process tracing/hooking
     #include <linux/input.h>  // For input event structures
@@ -197,6 +211,7 @@ extern "C" char **environ;
     #include <alsa/asoundlib.h> // ALSA audio library
 #elif __APPLE__
     #include <sys/sysctl.h>
+    #include <sys/event.h>    // Async reactor readiness (kqueue)
     #include <mach/mach.h>
     #include <mach/mach_host.h>
     #include <dlfcn.h>      // For dynamic library loading (hook injection)
@@ -344,6 +359,7 @@ constexpr uint64_t TAG_OBJ      = SIGN_BIT;               // Object pointer tag
 constexpr uint64_t VAL_NONE     = QNAN_BITS | TAG_NONE;
 constexpr uint64_t VAL_TRUE     = QNAN_BITS | TAG_TRUE;
 constexpr uint64_t VAL_FALSE    = QNAN_BITS | TAG_FALSE;
+constexpr uint64_t VAL_UNDEFINED = QNAN_BITS | TAG_NONE | 1;  // Internal: unset global slot
 constexpr uint64_t INT_MASK     = 0x0000FFFFFFFFFFFFULL;  // 48-bit integer mask
 constexpr uint64_t PTR_MASK     = 0x0000FFFFFFFFFFFFULL;  // 48-bit pointer mask
 
@@ -359,8 +375,14 @@ enum class ObjType : uint8_t {
     RANGE,     // Lazy range iterator
     MAP,       // Hash map
     CLASS,     // Class definition
-    INSTANCE   // Class instance
+    INSTANCE,  // Class instance
+    NATIVE,    // Builtin module function
+    COROUTINE, // Running or suspended async function call
+    TENSOR,    // Unboxed N-dimensional numeric array
+    BYTES,     // Mutable raw byte buffer
+    READER     // Streaming file reader
 };
+constexpr size_t OBJ_TYPE_COUNT = (size_t)ObjType::READER + 1;
 
 /**
  * Base heap object header
@@ -368,20 +390,28 @@ enum class ObjType : uint8_t {
  */
 struct Obj {
     ObjType type;
-    bool marked;  // For future GC
-    Obj* next;    // For GC linked list
+    bool marked;   // GC mark bit (see GCHeap)
+    uint8_t heap;  // Owning GCHeap id; collectors never touch another heap's objects
+    Obj* next;     // GCHeap object list link
 };
 
 /**
  * String object with flexible array member
- * Strings are interned for fast equality comparison.
+ * Identifiers, constants and map keys are interned, so they compare by
+ * identity; strings built at run time are plain heap strings that compare
+ * by length, cached hash and contents.
  */
 struct ObjString : Obj {
     uint32_t hash;
     uint32_t length;
+    uint32_t capacity;  // Bytes allocated for chars (excluding the NUL)
+    bool interned;      // Owned by the thread's StringPool
+    bool owned;         // Append buffer of one local (OP_APPEND_LOCAL); hash is stale
     char chars[];  // Flexible array member
     
     static ObjString* create(const char* str, uint32_t len);
+    static ObjString* alloc(uint32_t len, uint32_t capacity);  // chars left for the caller
+    void rehash();
     std::string str() const { return std::string(chars, length); }
 };
 
@@ -399,14 +429,20 @@ struct ObjFunc : Obj {
 
 /**
  * Dynamic list (array) with amortized O(1) append
+ * Small lists keep their items inline; larger ones spill to a malloc buffer.
  */
 struct ObjList : Obj {
-    uint64_t* items;
+    static constexpr size_t INLINE_CAPACITY = 4;
+
+    uint64_t* items;  // inline_items until the list outgrows them
     size_t count;
     size_t capacity;
+    uint64_t inline_items[INLINE_CAPACITY];
     
     static ObjList* create();
     void push(uint64_t val);
+    void reserve(size_t n);
+    bool is_inline() const { return items == inline_items; }
     uint64_t get(size_t idx) { return items[idx]; }
     void set(size_t idx, uint64_t val) { items[idx] = val; }
 };
@@ -422,6 +458,10 @@ struct ObjRange : Obj {
 struct ObjClass;
 struct ObjInstance;
 
+// Bumped whenever any class hierarchy changes; stale ObjClass::resolve() data
+// is recomputed on the next instantiation
+static std::atomic<uint64_t> g_class_version{1};
+
 /**
  * Class object containing methods and parent reference
  * Supports single inheritance and method lookup
@@ -433,21 +473,229 @@ struct ObjClass : Obj {
     std::unordered_set<std::string> abstract_methods;  // Declared abstract methods
     bool is_abstract;  // Whether class is explicitly abstract
     uint8_t arity;  // Number of init parameters
+
+    // Instantiation data, valid while resolved_version == g_class_version
+    std::atomic<uint64_t> resolved_version{0};
+    bool instantiable = false;
+    std::string missing_abstract;  // An unimplemented abstract method, if any
+    ObjFunc* init = nullptr;       // init(), possibly inherited
     
     static ObjClass* create(const char* name);
     uint64_t find_method(const std::string& name) const;
     void collect_missing_abstract_methods(std::unordered_set<std::string>& missing) const;
+    void resolve();
+    bool needs_resolve() const {
+        return resolved_version.load(std::memory_order_acquire) != g_class_version.load(std::memory_order_relaxed);
+    }
+};
+
+/**
+ * Hidden class describing an instance's field layout
+ * Instances that gain the same fields in the same order share a Shape, so the
+ * VM can cache a field's slot per access site. Shapes are immutable and live
+ * for the whole run; adding a field follows (or creates) a transition.
+ */
+struct Shape {
+    static constexpr size_t MAX_SLOTS = 64;    // Later fields go to ObjInstance::overflow
+    static constexpr size_t LINEAR_SCAN = 8;   // Above this, lookups use `index`
+
+    std::vector<ObjString*> keys;  // Slot index -> field name (interned)
+    std::unordered_map<ObjString*, uint32_t> index;
+    std::unordered_map<ObjString*, Shape*> transitions;
+
+    int lookup(ObjString* name) const;
+    Shape* with_field(ObjString* name);
+
+    static Shape* root();
+    static std::vector<Shape*>& all();  // Every shape, for marking field names
 };
 
 /**
  * Instance object with attribute storage
- * Points to its class for method lookup
+ * Points to its class for method lookup; fields live in a flat slot array
+ * laid out by `shape`.
  */
 struct ObjInstance : Obj {
     ObjClass* klass;  // The class this is an instance of
-    std::unordered_map<std::string, uint64_t> fields;  // Instance attributes
+    Shape* shape;
+    std::vector<uint64_t> slots;  // slots[i] holds field shape->keys[i]
+    std::unordered_map<ObjString*, uint64_t> overflow;  // Fields past Shape::MAX_SLOTS
 
     static ObjInstance* create(ObjClass* klass);
+    uint64_t* find_field(ObjString* name);
+    void set_field(ObjString* name, uint64_t value);
+};
+
+/**
+ * Insertion-ordered hash table behind ObjMap
+ * Entries sit in one dense array in insertion order, like CPython's compact
+ * dict, so iteration is a linear scan. Past SMALL_MAX entries a Swiss-table
+ * style index is added: groups of 16 control bytes (7 hash bits or EMPTY),
+ * probed a group at a time with SIMD, each followed by the entry positions
+ * of its slots. Stored keys are interned; a lookup with a run-time string
+ * compares contents. Maps only grow, so there are no tombstones.
+ */
+class MapTable {
+public:
+    using value_type = std::pair<ObjString*, uint64_t>;
+    using iterator = value_type*;
+    using const_iterator = value_type*;
+
+    MapTable() = default;
+    MapTable(const MapTable&) = delete;
+    MapTable& operator=(const MapTable&) = delete;
+    ~MapTable() { free(groups_); }
+
+    iterator begin() const { return const_cast<value_type*>(entries_.data()); }
+    iterator end() const { return begin() + entries_.size(); }
+    size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+
+    iterator find(const ObjString* key) const {
+        size_t i = locate(key);
+        return i == NPOS ? end() : begin() + i;
+    }
+
+    // Inserting keys must be interned (map_key)
+    uint64_t& operator[](ObjString* key) { return entries_[insert(key, 0).first].second; }
+
+    std::pair<iterator, bool> emplace(ObjString* key, uint64_t value) {
+        auto r = insert(key, value);
+        return {begin() + r.first, r.second};
+    }
+
+    // Pre-sizes both arrays so n inserts never rebuild
+    void reserve(size_t n) {
+        entries_.reserve(n);
+        if (n > SMALL_MAX && groups_for(n) > group_count_) rebuild(groups_for(n));
+    }
+
+    size_t memory_bytes() const {
+        return entries_.capacity() * sizeof(value_type) + group_count_ * sizeof(Group);
+    }
+
+private:
+    static constexpr size_t NPOS = ~size_t(0);
+    static constexpr size_t SMALL_MAX = 8;  // Linear scan up to here, no index
+    static constexpr size_t GROUP = 16;
+    static constexpr uint8_t EMPTY = 0x80;
+
+    // Tags and positions share cache lines, so a probe touches one group
+    struct Group {
+        uint8_t ctrl[GROUP];
+        uint32_t pos[GROUP];
+    };
+
+    std::vector<value_type> entries_;
+    Group* groups_ = nullptr;  // Power-of-two count; nullptr while small
+    size_t group_count_ = 0;
+
+    static uint32_t fnv(const ObjString* s) {
+        uint32_t h = 2166136261u;
+        for (uint32_t i = 0; i < s->length; i++) {
+            h ^= (uint8_t)s->chars[i];
+            h *= 16777619u;
+        }
+        return h;
+    }
+    // Builder buffers (owned) do not keep their hash current
+    static uint64_t hash_of(const ObjString* key) {
+        return (uint64_t)(key->owned ? fnv(key) : key->hash) * 0x9E3779B97F4A7C15ull;
+    }
+    static uint8_t h2(uint64_t h) { return (uint8_t)(h >> 57); }
+    size_t home(uint64_t h) const { return (size_t)(h >> 25) & (group_count_ - 1); }
+    // Keep the index at most 7/8 full
+    static size_t groups_for(size_t n) {
+        size_t cap = GROUP;
+        while (cap - cap / 8 < n) cap *= 2;
+        return cap / GROUP;
+    }
+
+    static bool same_key(const ObjString* stored, const ObjString* key, uint64_t h) {
+        if (stored == key) return true;
+        if (key->interned || stored->length != key->length) return false;
+        return hash_of(stored) == h && memcmp(stored->chars, key->chars, key->length) == 0;
+    }
+
+    // Bit i set where ctrl byte i equals b
+    static uint32_t match(const uint8_t* ctrl, uint8_t b) {
+#if defined(__SSE2__) || defined(_M_X64)
+        __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+        return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8((char)b)));
+#elif defined(__ARM_NEON)
+        // Narrow the byte mask to 4 bits per lane, then keep one bit each
+        uint8x16_t eq = vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(b));
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+        uint32_t mask = 0;
+        for (int i = 0; i < 16; i++) mask |= (uint32_t)((nibbles >> (i * 4)) & 1) << i;
+        return mask;
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < GROUP; i++) mask |= (uint32_t)(ctrl[i] == b) << i;
+        return mask;
+#endif
+    }
+
+    size_t locate(const ObjString* key) const {
+        if (!key) return NPOS;
+        if (!groups_) {
+            for (size_t i = 0; i < entries_.size(); i++)
+                if (entries_[i].first == key) return i;
+            if (key->interned) return NPOS;
+            uint64_t h = hash_of(key);
+            for (size_t i = 0; i < entries_.size(); i++)
+                if (same_key(entries_[i].first, key, h)) return i;
+            return NPOS;
+        }
+        uint64_t h = hash_of(key);
+        uint8_t tag = h2(h);
+        size_t g = home(h);
+        for (size_t step = 1;; step++) {
+            const Group& group = groups_[g];
+            for (uint32_t m = match(group.ctrl, tag); m; m &= m - 1) {
+                uint32_t e = group.pos[__builtin_ctz(m)];
+                if (same_key(entries_[e].first, key, h)) return e;
+            }
+            if (match(group.ctrl, EMPTY)) return NPOS;
+            g = (g + step) & (group_count_ - 1);  // Triangular probing visits every group
+        }
+    }
+
+    void place(size_t e) {
+        uint64_t h = hash_of(entries_[e].first);
+        size_t g = home(h);
+        for (size_t step = 1;; step++) {
+            Group& group = groups_[g];
+            if (uint32_t m = match(group.ctrl, EMPTY)) {
+                int slot = __builtin_ctz(m);
+                group.ctrl[slot] = h2(h);
+                group.pos[slot] = (uint32_t)e;
+                return;
+            }
+            g = (g + step) & (group_count_ - 1);
+        }
+    }
+
+    void rebuild(size_t count) {
+        Group* groups = static_cast<Group*>(malloc(count * sizeof(Group)));
+        if (!groups) throw std::bad_alloc();
+        free(groups_);
+        groups_ = groups;
+        group_count_ = count;
+        for (size_t g = 0; g < count; g++) memset(groups_[g].ctrl, EMPTY, GROUP);
+        for (size_t i = 0; i < entries_.size(); i++) place(i);
+    }
+
+    std::pair<size_t, bool> insert(ObjString* key, uint64_t value) {
+        size_t i = locate(key);
+        if (i != NPOS) return {i, false};
+        size_t n = entries_.size() + 1;
+        size_t cap = group_count_ * GROUP;
+        if (n > SMALL_MAX && n > cap - cap / 8) rebuild(groups_for(n * 2));
+        entries_.emplace_back(key, value);
+        if (groups_) place(entries_.size() - 1);
+        return {entries_.size() - 1, true};
+    }
 };
 
 /**
@@ -455,11 +703,140 @@ struct ObjInstance : Obj {
  * Used for the import system to store module functions
  */
 struct ObjMap : Obj {
-  std::unordered_map<ObjString*, uint64_t> data; // Key -> NaN-boxed value
+  MapTable data; // Key -> NaN-boxed value, in insertion order
+  uint32_t version = 0; // Bumped on stores into module maps
+  bool module = false;  // Builtin module or .levy exports; never collected
 
   static ObjMap *create();
 };
 
+enum class DType : uint8_t { F32, F64, I64 };
+
+/**
+ * N-dimensional numeric array with unboxed elements
+ * An owner holds a 64-byte aligned, row-major buffer. Reshape, transpose and
+ * row views share it through `base` and differ only in shape, strides and
+ * offset; kernels take the contiguous fast path and copy anything else.
+ */
+struct ObjTensor : Obj {
+    static constexpr int MAX_DIMS = 8;
+
+    DType dtype;
+    uint8_t ndim;
+    int64_t shape[MAX_DIMS];
+    int64_t strides[MAX_DIMS];  // In elements
+    size_t count;               // Product of shape
+    size_t offset;              // First element's index in data
+    void* data;                 // Buffer start (the base's, for views)
+    ObjTensor* base;            // Buffer owner for views, else nullptr
+
+    static ObjTensor* create(DType dtype, const int64_t* shape, int ndim);  // Zero-filled
+    static ObjTensor* view(ObjTensor* src, const int64_t* shape, const int64_t* strides, int ndim, size_t offset);
+    size_t elem_size() const { return dtype == DType::F32 ? 4 : 8; }
+    bool contiguous() const;
+    size_t element_index(size_t flat) const;  // Row-major position -> index into data
+    double get(size_t flat) const;
+    void set(size_t flat, double v);
+    template <class T> T* ptr() const { return static_cast<T*>(data) + offset; }
+    void* elements() const { return static_cast<char*>(data) + offset * elem_size(); }
+};
+
+/**
+ * Raw byte buffer for binary data (file contents, socket payloads, digests)
+ * An owner holds its own allocation; slices are views that point into the
+ * owner's buffer and keep it alive through `base`, so slicing never copies.
+ */
+struct ObjBytes : Obj {
+    uint8_t* data;   // First byte (inside the base's buffer, for views)
+    size_t length;
+    ObjBytes* base;  // Buffer owner for views, else nullptr
+
+    static ObjBytes* create(size_t length);  // Zero-filled
+    static ObjBytes* create(const void* src, size_t length);
+    static ObjBytes* view(ObjBytes* src, size_t start, size_t length);
+};
+
+/**
+ * Streaming reader over one file, from fs.open() or fs.lines()
+ * Regular files are mapped read-only (MADV_SEQUENTIAL) and scanned in place;
+ * pipes, devices and anything else that cannot be mapped are read through a
+ * refilled buffer. Views returned by next_line/read_chunk stay valid only
+ * until the next call. The file is released by close(), when a for-in
+ * loop over the reader ends or is left by break or ->, or when the reader
+ * is collected. An open reader also counts toward GC pressure, since the
+ * collector is otherwise driven by bytes and would never run for fds.
+ */
+struct ObjReader : Obj {
+    static constexpr size_t FILL_BYTES = 64 * 1024;
+    static constexpr size_t OPENS_PER_COLLECTION = 64;  // At most this many dropped readers stay open
+
+    int fd = -1;
+    char* map = nullptr;  // Whole-file mapping, or nullptr
+    size_t map_size = 0;
+    size_t pos = 0;       // Next unread byte of map, or of buf
+    std::string buf;      // Read-ahead when unmapped
+    bool eof = false;     // Unmapped input is exhausted beyond buf
+
+    static ObjReader* open(const std::string& path);  // nullptr if the file cannot be opened
+    bool next_line(std::string_view& line);  // Strips \n or \r\n; false at end
+    std::string_view read_chunk(size_t n);   // Up to n bytes; empty at end
+    bool fill();                             // Appends to buf; false at end
+    void close();
+};
+
+// Native module ABI: natives read NaN-boxed arguments straight from the VM
+// stack; legacy bindings still take a converted Value vector.
+class Value;
+class FastVM;
+struct VMContext {
+    std::string scratch;  // Reused output buffer for string-building natives
+    FastVM* vm = nullptr; // Calling VM, for natives that run or copy Levython code
+};
+using NativeFn = uint64_t (*)(VMContext& ctx, const uint64_t* args, uint8_t argc);
+using LegacyNativeFn = Value (*)(const std::vector<Value>& args);
+
+/**
+ * Builtin module function stored in a module map
+ * Calls use the zero-copy fn when a binding provides one, else legacy.
+ */
+struct ObjNative : Obj {
+    ObjString* name;
+    NativeFn fn;            // Zero-copy entry point (nullable)
+    LegacyNativeFn legacy;  // Value-vector entry point (nullable)
+
+    static ObjNative* create(ObjString* name, NativeFn fn, LegacyNativeFn legacy);
+};
+
+// State of one active for-loop; FastVM keeps a stack of these
+struct FastIter { uint64_t obj; size_t idx; int64_t cur; int64_t stop; int64_t step; };
+
+/**
+ * Coroutine created by calling an `async act` function
+ * While suspended it owns its CallFrames, stack slice, loop iterators and
+ * try handlers. Positions are stored relative to its first stack slot and
+ * frame so it can be copied back onto the VM stack at any depth.
+ */
+struct ObjCoroutine : Obj {
+    enum class State : uint8_t { RUNNING, SUSPENDED, DONE };
+    struct Frame { Chunk* chunk; uint8_t* ip; size_t slots; const char* name; };
+    struct Handler { uint8_t* catch_ip; uint8_t* saved_ip; size_t sp; size_t frame; };
+
+    State state;
+    bool queued;                          // In the VM ready queue
+    ObjString* name;
+    uint64_t result;                      // Return value once DONE
+    std::vector<uint64_t> stack;
+    std::vector<Frame> frames;
+    std::vector<FastIter> iters;
+    std::vector<Handler> handlers;
+    std::vector<ObjCoroutine*> waiters;   // Suspended in await on this coroutine
+    bool has_deadline;                    // Pending await(x, timeout_ms)
+    std::chrono::steady_clock::time_point deadline;
+    long deadline_timer;                  // async task that wakes it at the deadline
+
+    static ObjCoroutine* create(ObjString* name);
+};
+
 // ============================================================================
 // ADVANCED JIT COMPILER: x86-64 NATIVE CODE GENERATION
 // ============================================================================
@@ -468,37 +845,24 @@ struct ObjMap : Obj {
  * x86-64 JIT COMPILER
  * ===========================================================================
  * 
- * The JIT compiler translates Levython functions directly to native x86-64
- * machine code at runtime. This achieves C-level performance for hot paths.
- * 
- * OPTIMIZATION TECHNIQUES
- * -----------------------
- * 1. Register allocation: Arguments in RDI, return in RAX (System V ABI)
- * 2. Tail call optimization: Jump instead of call for recursive tail calls
- * 3. Branch prediction hints: Short jumps (rel8) for likely paths
- * 4. Memory alignment: 16-byte aligned loops for cache efficiency
- * 5. Zero-copy function pointers: Direct execution via mmap RWX memory
- * 
- * GENERATED CODE QUALITY
- * ----------------------
- * The JIT output matches GCC -O3 for recursive functions:
- *   fib:    cmp rdi, 2
- *           jl  .base_case
- *           push rbx
- *           mov rbx, rdi
- *           lea rdi, [rbx-1]
- *           call fib
- *           lea rdi, [rbx-2]
- *           mov rbx, rax
- *           call fib
- *           add rax, rbx
- *           pop rbx
- *           ret
- *   .base_case:
- *           mov rax, rdi
- *           ret
+ * JITCompiler is the machine-code emitter: an executable code buffer plus
+ * x86-64 instruction encoders. BaselineJIT (next to FastVM) uses it to lower
+ * whole function chunks, one instruction template per opcode.
  * 
- * This makes Levython faster than interpreted languages - approaching C speed!
+ * BASELINE JIT DESIGN
+ * -------------------
+ * 1. Same frame layout as the interpreter: locals and the operand stack stay
+ *    in VM stack memory (RBX = slots, R12 = stack top), so no state needs to
+ *    be rebuilt when handing a frame back to the interpreter.
+ * 2. Type guards: integer fast paths are inlined; other operand types take
+ *    the same helpers the interpreter uses (fast_add, fast_lt, ...).
+ * 3. Deoptimization: an instruction the native code cannot finish (division
+ *    by zero, undefined global, calling a class) records its bytecode address
+ *    in the current CallFrame and returns JIT_DEOPT; the interpreter resumes
+ *    there. Native calls push real CallFrames, so nested activations unwind
+ *    the same way.
+ * 4. Functions are compiled per Chunk after HOT_CALL_THRESHOLD calls and
+ *    dropped back to the interpreter after DEOPT_THRESHOLD bailouts.
  */
 
 class JITCompiler {
@@ -511,8 +875,9 @@ public:
         uint8_t* code;
         size_t size;
         size_t capacity;
+        bool overflow = false;  // Set when an emit did not fit
         
-        CodeBuffer() : size(0), capacity(4096) {
+        explicit CodeBuffer(size_t bytes = 4096) : size(0), capacity(bytes) {
             // Allocate executable memory (RWX) for JIT code
             code = (uint8_t*)platform_mmap(nullptr, capacity, 
                 PROT_READ | PROT_WRITE | PROT_EXEC,
@@ -529,6 +894,7 @@ public:
         
         void emit(uint8_t byte) {
             if (size < capacity) code[size++] = byte;
+            else overflow = true;
         }
         
         void emit16(uint16_t val) {
@@ -595,6 +961,8 @@ public:
     
     CodeBuffer buf;
     std::vector<size_t> jump_patches;  // For fixing up forward jumps
+
+    explicit JITCompiler(size_t code_bytes = 4096) : buf(code_bytes) {}
     
     // REX prefix for 64-bit operations
     void rex(bool w, bool r, bool x, bool b) {
@@ -804,449 +1172,96 @@ public:
         int32_t rel = (int32_t)(target - (patch_pos + 4));
         buf.patch32(patch_pos, rel);
     }
-    
-    // ============== HIGH-LEVEL JIT FUNCTIONS ==============
-    
-    // Compiled function pointer type: int64_t (*)(int64_t arg)
-    typedef int64_t (*JITFunc)(int64_t);
-    typedef int64_t (*JITFunc2)(int64_t, int64_t);
-    
-    // OPTIMIZED ITERATIVE FIBONACCI IMPLEMENTATION
-    // Computes fib(n) in O(n) instead of O(2^n) using iterative approach.
-    // 
-    // Equivalent C code:
-    //   int64_t fib(int64_t n) {
-    //       if (n <= 1) return n;
-    //       int64_t a = 0, b = 1;
-    //       for (int64_t i = 2; i <= n; i++) {
-    //           int64_t tmp = a + b;
-    //           a = b;
-    //           b = tmp;
-    //       }
-    //       return b;
-    //   }
-    //
-    // Register allocation:
-    //   RDI = n (input)
-    //   RAX = a (fib[i-2])
-    //   RBX = b (fib[i-1]) -> becomes return value
-    //   RCX = i (loop counter)
-    //   RDX = tmp (for swap)
-    
-    JITFunc compile_fib_optimized() {
-        size_t start = buf.pos();
-        
-        // Prologue
-        push_r64(RBX);           // Save callee-saved register
-        
-        // if (n <= 1) return n
-        cmp_r64_imm32(RDI, 1);
-        size_t jle_base = jle_rel32();
-        
-        // Initialize: a = 0, b = 1, i = 2
-        // xor rax, rax  (a = 0)
-        buf.emit(0x48); buf.emit(0x31); buf.emit(0xC0);
-        
-        // mov rbx, 1  (b = 1)
-        mov_r64_imm64(RBX, 1);
-        
-        // mov rcx, 2  (i = 2)
-        mov_r64_imm64(RCX, 2);
-        
-        // Loop: while (i <= n)
-        size_t loop_start = buf.pos();
-        
-        // cmp rcx, rdi  (i vs n)
-        cmp_r64_r64(RCX, RDI);
-        size_t jg_exit = 0;
-        // jg exit (if i > n, exit)
-        buf.emit(0x0F); buf.emit(0x8F);
-        jg_exit = buf.pos();
-        buf.emit32(0);
-        
-        // tmp = a + b -> rdx = rax + rbx
-        mov_r64_r64(RDX, RAX);
-        add_r64_r64(RDX, RBX);
-        
-        // a = b -> rax = rbx
-        mov_r64_r64(RAX, RBX);
-        
-        // b = tmp -> rbx = rdx
-        mov_r64_r64(RBX, RDX);
-        
-        // i++ -> inc rcx
-        buf.emit(0x48); buf.emit(0xFF); buf.emit(0xC1);
-        
-        // jmp loop_start
-        size_t jmp_loop = jmp_rel32();
-        patch_rel32(jmp_loop, loop_start);
-        
-        // Exit: return b (already in rbx, move to rax)
-        size_t exit_label = buf.pos();
-        patch_rel32(jg_exit, exit_label);
-        mov_r64_r64(RAX, RBX);
-        
-        size_t jmp_ret = jmp_rel32();
-        
-        // Base case: return n
-        size_t base_case = buf.pos();
-        patch_rel32(jle_base, base_case);
-        mov_r64_r64(RAX, RDI);
-        
-        // Return
-        size_t ret_label = buf.pos();
-        patch_rel32(jmp_ret, ret_label);
-        pop_r64(RBX);
-        ret();
-        
-        #ifdef __APPLE__
-        pthread_jit_write_protect_np(1);
-        #endif
-        
-        return (JITFunc)(buf.code + start);
+
+    // Condition codes for jcc/cmovcc
+    enum Cond : uint8_t {
+        CC_B = 0x2, CC_AE = 0x3, CC_E = 0x4, CC_NE = 0x5,
+        CC_L = 0xC, CC_GE = 0xD, CC_LE = 0xE, CC_G = 0xF
+    };
+
+    // [base + disp32] memory operand (RSP/R12 bases need a SIB byte)
+    void mem_operand(uint8_t reg, Reg base, int32_t disp) {
+        modrm(2, reg, base);
+        if ((base & 7) == RSP) sib(0, RSP, RSP);
+        buf.emit32((uint32_t)disp);
     }
-    
-    // Original recursive fib (kept for comparison)
-    JITFunc compile_fib() {
-        size_t start = buf.pos();
-        
-        // Function prologue - System V AMD64 ABI
-        // RDI = first argument (n)
-        push_r64(RBP);
-        mov_r64_r64(RBP, RSP);
-        push_r64(RBX);           // Callee-saved, we'll use it
-        push_r64(R12);           // Callee-saved
-        sub_rsp_imm8(8);         // Align stack to 16 bytes
-        
-        // if (n <= 1) return n
-        cmp_r64_imm32(RDI, 1);
-        size_t jle_patch = jle_rel32();
-        
-        // n > 1 path: compute fib(n-1) + fib(n-2)
-        mov_r64_r64(RBX, RDI);   // Save n in RBX (callee-saved)
-        
-        // fib(n-1)
-        mov_r64_r64(RDI, RBX);
-        sub_rsp_imm8(8);          // Keep stack aligned
-        cmp_r64_imm32(RDI, 1);
-        buf.emit(0x48); buf.emit(0x8D); buf.emit(0x7F); buf.emit(0xFF);  // lea rdi, [rdi-1]
-        
-        // Recursive call to self
-        size_t call1_patch = call_rel32();
-        patch_rel32(call1_patch, start);
-        
-        mov_r64_r64(R12, RAX);   // Save fib(n-1) in R12 (callee-saved)
-        
-        // fib(n-2)  
-        mov_r64_r64(RDI, RBX);
-        buf.emit(0x48); buf.emit(0x83); buf.emit(0xEF); buf.emit(0x02);  // sub rdi, 2
-        
-        size_t call2_patch = call_rel32();
-        patch_rel32(call2_patch, start);
-        
-        // RAX = fib(n-2), R12 = fib(n-1)
-        add_r64_r64(RAX, R12);   // RAX = fib(n-1) + fib(n-2)
-        
-        add_rsp_imm8(8);          // Restore stack
-        size_t jmp_end = jmp_rel32();
-        
-        // Base case: return n
-        size_t base_case = buf.pos();
-        patch_rel32(jle_patch, base_case);
-        mov_r64_r64(RAX, RDI);   // return n
-        
-        // Epilogue
-        size_t epilogue = buf.pos();
-        patch_rel32(jmp_end, epilogue);
-        add_rsp_imm8(8);
-        pop_r64(R12);
-        pop_r64(RBX);
-        pop_r64(RBP);
-        ret();
-        
-        // Mark memory as executable
-        #ifdef __APPLE__
-        pthread_jit_write_protect_np(1);  // Enable JIT execute protection
-        #endif
-        
-        return (JITFunc)(buf.code + start);
+
+    // mov reg64, [base + disp]
+    void mov_r64_mem(Reg dst, Reg base, int32_t disp) {
+        rex(true, dst >= R8, false, base >= R8);
+        buf.emit(0x8B);
+        mem_operand(dst, base, disp);
     }
-    
-    // Generic integer function compiler for simple recursive functions
-    // =================================================================
-    // OPTIMIZED RECURSIVE FIBONACCI - NATIVE x86-64 IMPLEMENTATION
-    // Generates assembly code equivalent to gcc -O3 output.
-    // =================================================================
-    JITFunc compile_recursive_int(int base_case_val, int decrement1, int decrement2) {
-        // Align function start to 32-byte boundary for optimal CPU performance
-        buf.nop_align(32);
-        
-        size_t start = buf.pos();
-        
-        // GCC output byte-for-byte:
-        // 100003e20: 55                 pushq   %rbp
-        push_r64(RBP);
-        // 100003e21: 48 89 e5           movq    %rsp, %rbp
-        mov_r64_r64(RBP, RSP);
-        // 100003e24: 41 56              pushq   %r14
-        push_r64(R14);
-        // 100003e26: 53                 pushq   %rbx
-        push_r64(RBX);
-        
-        // 100003e27: 45 31 f6           xorl    %r14d, %r14d
-        buf.emit(0x45); buf.emit(0x31); buf.emit(0xF6);
-        
-        // 100003e2a: 48 83 ff 02        cmpq    $2, %rdi
-        cmp_r64_imm32(RDI, 2);
-        
-        // 100003e2e: 7c 29              jl      base_case (SHORT jump!)
-        size_t jl_base = jl_rel8();
-        
-        // 100003e30: 48 89 fb           movq    %rdi, %rbx
-        mov_r64_r64(RBX, RDI);
-        
-        // Pad to align loop to 16-byte boundary (GCC uses multibyte NOPs)
-        // We need loop_start to be at offset 0x20 from function start
-        buf.nop_align(16);
-        
-        // Loop: while (rbx >= 2)
-        size_t loop_start = buf.pos();
-        
-        // 100003e40: 48 8d 7b ff        leaq    -1(%rbx), %rdi
-        buf.emit(0x48); buf.emit(0x8D); buf.emit(0x7B); buf.emit(0xFF);
-        
-        // 100003e44: e8 d7 ff ff ff     callq   fib
-        size_t call1 = call_rel32();
-        patch_rel32(call1, start);
-        
-        // 100003e49: 48 8d 7b fe        leaq    -2(%rbx), %rdi
-        buf.emit(0x48); buf.emit(0x8D); buf.emit(0x7B); buf.emit(0xFE);
-        
-        // 100003e4d: 49 01 c6           addq    %rax, %r14
-        buf.emit(0x49); buf.emit(0x01); buf.emit(0xC6);
-        
-        // 100003e50: 48 83 fb 03        cmpq    $3, %rbx
-        cmp_r64_imm32(RBX, 3);
-        
-        // 100003e54: 48 89 fb           movq    %rdi, %rbx
-        mov_r64_r64(RBX, RDI);
-        
-        // 100003e57: 7f e7              jg      loop_start (SHORT jump!)
-        size_t jg_loop = jg_rel8();
-        patch_rel8(jg_loop, loop_start);
-        
-        // Base case exit:
-        // 100003e59: 49 01 fe           addq    %rdi, %r14
-        size_t base_case = buf.pos();
-        patch_rel8(jl_base, base_case);
-        buf.emit(0x49); buf.emit(0x01); buf.emit(0xFE);
-        
-        // 100003e5c: 4c 89 f0           movq    %r14, %rax
-        buf.emit(0x4C); buf.emit(0x89); buf.emit(0xF0);
-        
-        // 100003e5f: 5b                 popq    %rbx
-        pop_r64(RBX);
-        // 100003e60: 41 5e              popq    %r14
-        pop_r64(R14);
-        // 100003e62: 5d                 popq    %rbp
-        pop_r64(RBP);
-        // 100003e63: c3                 retq
-        ret();
-        
-        #ifdef __APPLE__
-        pthread_jit_write_protect_np(1);
-        #endif
-        
-        return (JITFunc)(buf.code + start);
+
+    // mov [base + disp], reg64
+    void mov_mem_r64(Reg base, int32_t disp, Reg src) {
+        rex(true, src >= R8, false, base >= R8);
+        buf.emit(0x89);
+        mem_operand(src, base, disp);
     }
-    
-    // =================================================================
-    // LOOP JIT: Compile a simple summation loop to native code
-    // Pattern: s = 0; for i in range(0, N): s += i
-    // Returns: sum from 0 to N-1
-    // =================================================================
-    JITFunc compile_sum_loop() {
-        size_t start = buf.pos();
-        
-        // RDI = N (loop limit)
-        // Returns: sum = 0 + 1 + 2 + ... + (N-1) = N*(N-1)/2
-        
-        // Use formula: sum = N * (N-1) / 2 - O(1)!
-        // mov rax, rdi         ; rax = N
-        buf.emit(0x48); buf.emit(0x89); buf.emit(0xF8);
-        
-        // dec rax              ; rax = N-1
-        buf.emit(0x48); buf.emit(0xFF); buf.emit(0xC8);
-        
-        // imul rax, rdi        ; rax = N * (N-1)
-        buf.emit(0x48); buf.emit(0x0F); buf.emit(0xAF); buf.emit(0xC7);
-        
-        // shr rax, 1           ; rax = N*(N-1)/2
-        buf.emit(0x48); buf.emit(0xD1); buf.emit(0xE8);
-        
-        ret();
-        
-        #ifdef __APPLE__
-        pthread_jit_write_protect_np(1);
-        #endif
-        
-        return (JITFunc)(buf.code + start);
+
+    // add reg64, imm32 (negative values subtract)
+    void add_r64_imm32(Reg r, int32_t imm) {
+        rex(true, false, false, r >= R8);
+        buf.emit(0x81);
+        modrm(3, 0, r & 7);
+        buf.emit32((uint32_t)imm);
     }
-    
-    // Generic counting loop: s=0; for i in range(start, stop, step): s += i
-    typedef int64_t (*LoopFunc)(int64_t start, int64_t stop, int64_t step);
-    
-    LoopFunc compile_range_sum() {
-        size_t start = buf.pos();
-        
-        // RDI = start, RSI = stop, RDX = step
-        // xor rax, rax   ; sum = 0
-        buf.emit(0x48); buf.emit(0x31); buf.emit(0xC0);
-        
-        // mov rcx, rdi   ; i = start
-        buf.emit(0x48); buf.emit(0x89); buf.emit(0xF9);
-        
-        size_t loop_start = buf.pos();
-        
-        // cmp rcx, rsi   ; i < stop?
-        buf.emit(0x48); buf.emit(0x39); buf.emit(0xF1);
-        
-        // jge exit
-        buf.emit(0x7D);
-        size_t jge_patch = buf.pos();
-        buf.emit(0x00);
-        
-        // add rax, rcx   ; sum += i
-        buf.emit(0x48); buf.emit(0x01); buf.emit(0xC8);
-        
-        // add rcx, rdx   ; i += step
-        buf.emit(0x48); buf.emit(0x01); buf.emit(0xD1);
-        
-        // jmp loop_start
-        buf.emit(0xEB);
-        buf.emit((uint8_t)(loop_start - buf.pos() - 1));
-        
-        // exit:
-        buf.code[jge_patch] = (uint8_t)(buf.pos() - jge_patch - 1);
-        
-        ret();
-        
-        #ifdef __APPLE__
-        pthread_jit_write_protect_np(1);
-        #endif
-        
-        return (LoopFunc)(buf.code + start);
-    }
-    
-    // OPTIMIZED PRIMALITY TEST - Native x86-64 implementation
-    // Returns 1 if prime, 0 if not
-    // 
-    // Equivalent C code:
-    //   int64_t is_prime(int64_t n) {
-    //       if (n < 2) return 0;
-    //       if (n == 2) return 1;
-    //       if (n % 2 == 0) return 0;
-    //       for (int64_t i = 3; i * i <= n; i += 2) {
-    //           if (n % i == 0) return 0;
-    //       }
-    //       return 1;
-    //   }
-    //
-    // Register allocation:
-    //   RDI = n (input, preserved for division)
-    //   RAX = temp/division result  
-    //   RCX = i (loop counter)
-    //   RDX = division remainder
-    
-    JITFunc compile_is_prime() {
-        #ifdef __APPLE__
-        pthread_jit_write_protect_np(0);
-        #endif
-        
-        size_t start = buf.pos();
-        
-        // if (n < 2) return 0
-        cmp_r64_imm32(RDI, 2);
-        size_t jl_not_prime = jl_rel32();  // jl -> not prime
-        
-        // if (n == 2) return 1
-        // We check n > 2 with jg, otherwise return 1
-        size_t jg_check_more = buf.pos();
-        buf.emit(0x0F); buf.emit(0x8F);  // jg rel32
-        size_t jg_patch = buf.pos();
-        buf.emit32(0);
-        // n == 2, return 1
-        mov_r64_imm64(RAX, 1);
-        ret();
-        
-        // Patch jg to here
-        patch_rel32(jg_patch, buf.pos());
-        
-        // if (n % 2 == 0) return 0
-        // test rdi, 1  - check if odd
-        buf.emit(0x48); buf.emit(0xF7); buf.emit(0xC7); buf.emit32(1);  // test rdi, 1
-        // jz not_prime (even number)
-        buf.emit(0x0F); buf.emit(0x84);
-        size_t jz_even = buf.pos();
-        buf.emit32(0);
-        
-        // i = 3
-        mov_r64_imm64(RCX, 3);
-        
-        // Loop: while (i * i <= n)
-        size_t loop_start = buf.pos();
-        
-        // Calculate i * i in RAX
-        mov_r64_r64(RAX, RCX);
-        // imul rax, rcx  
-        buf.emit(0x48); buf.emit(0x0F); buf.emit(0xAF); buf.emit(0xC1);
-        
-        // cmp rax, rdi (i*i vs n)
-        cmp_r64_r64(RAX, RDI);
-        // jg prime (i*i > n means we're done, number is prime)
-        buf.emit(0x0F); buf.emit(0x8F);
-        size_t jg_prime = buf.pos();
-        buf.emit32(0);
-        
-        // n % i == 0 check
-        // mov rax, rdi
-        mov_r64_r64(RAX, RDI);
-        // xor rdx, rdx (clear high bits for division)
-        buf.emit(0x48); buf.emit(0x31); buf.emit(0xD2);
-        // div rcx (rax = rax / rcx, rdx = rax % rcx)
-        buf.emit(0x48); buf.emit(0xF7); buf.emit(0xF1);
-        // test rdx, rdx
-        buf.emit(0x48); buf.emit(0x85); buf.emit(0xD2);
-        // jz not_prime (remainder is 0, not prime)
-        buf.emit(0x0F); buf.emit(0x84);
-        size_t jz_divisible = buf.pos();
+
+    // Two-register ALU op: opcode is 0x01 add, 0x29 sub, 0x21 and, 0x09 or,
+    // 0x39 cmp, 0x85 test (dst op= src)
+    void alu_r64_r64(uint8_t opcode, Reg dst, Reg src) {
+        rex(true, src >= R8, false, dst >= R8);
+        buf.emit(opcode);
+        modrm(3, src & 7, dst & 7);
+    }
+
+    // imul dst, src
+    void imul_r64_r64(Reg dst, Reg src) {
+        rex(true, dst >= R8, false, src >= R8);
+        buf.emit(0x0F);
+        buf.emit(0xAF);
+        modrm(3, dst & 7, src & 7);
+    }
+
+    // Shift by immediate: ext is 4 shl, 5 shr, 7 sar
+    void shift_r64_imm8(uint8_t ext, Reg r, uint8_t amount) {
+        rex(true, false, false, r >= R8);
+        buf.emit(0xC1);
+        modrm(3, ext, r & 7);
+        buf.emit(amount);
+    }
+
+    // cqo; idiv r64 (RDX:RAX / r -> RAX quotient, RDX remainder)
+    void idiv_r64(Reg r) {
+        buf.emit(0x48);
+        buf.emit(0x99);
+        rex(true, false, false, r >= R8);
+        buf.emit(0xF7);
+        modrm(3, 7, r & 7);
+    }
+
+    // cmovcc dst, src
+    void cmov_r64_r64(Cond cc, Reg dst, Reg src) {
+        rex(true, dst >= R8, false, src >= R8);
+        buf.emit(0x0F);
+        buf.emit(0x40 + cc);
+        modrm(3, dst & 7, src & 7);
+    }
+
+    // jcc rel32
+    size_t jcc_rel32(Cond cc) {
+        buf.emit(0x0F);
+        buf.emit(0x80 + cc);
+        size_t patch_pos = buf.pos();
         buf.emit32(0);
-        
-        // i += 2
-        buf.emit(0x48); buf.emit(0x83); buf.emit(0xC1); buf.emit(0x02);  // add rcx, 2
-        
-        // jmp loop_start
-        buf.emit(0xE9);
-        int32_t loop_rel = (int32_t)(loop_start - buf.pos() - 4);
-        buf.emit32(loop_rel);
-        
-        // Prime label (return 1)
-        patch_rel32(jg_prime, buf.pos());
-        mov_r64_imm64(RAX, 1);
-        ret();
-        
-        // Not prime label (return 0)
-        patch_rel32(jl_not_prime, buf.pos());
-        patch_rel32(jz_even, buf.pos());
-        patch_rel32(jz_divisible, buf.pos());
-        mov_r64_imm64(RAX, 0);
-        ret();
-        
-        #ifdef __APPLE__
-        pthread_jit_write_protect_np(1);
-        #endif
-        
-        return (JITFunc)(buf.code + start);
+        return patch_pos;
+    }
+
+    // Call an absolute address through RAX
+    void call_abs(const void* target) {
+        mov_r64_imm64(RAX, (uint64_t)(uintptr_t)target);
+        call_r64(RAX);
     }
 };
 
@@ -1415,121 +1430,319 @@ static int64_t native_collatz_length(int64_t n) {
     return steps;
 }
 
-// Global JIT compiler instance with lazy initialization
-static JITCompiler* g_jit_ptr = nullptr;
-static JITCompiler& get_jit() {
-    if (!g_jit_ptr) {
-        g_jit_ptr = new JITCompiler();
-    }
-    return *g_jit_ptr;
-}
-#define g_jit get_jit()
 
-// JIT-compiled function cache
-struct JITCache {
-    std::unordered_map<std::string, JITCompiler::JITFunc> funcs;
-    std::unordered_map<std::string, size_t> call_counts;
-    static constexpr size_t HOT_THRESHOLD = 3;  // Compile after 3 calls (aggressive JIT!)
-    
-    void record_call(const std::string& name) {
-        call_counts[name]++;
-    }
-    
-    bool is_hot(const std::string& name) {
-        return call_counts[name] >= HOT_THRESHOLD;
-    }
-    
-    bool has_jit(const std::string& name) {
-        return funcs.count(name) > 0;
-    }
-    
-    JITCompiler::JITFunc get(const std::string& name) {
-        return funcs[name];
-    }
-    
-    void store(const std::string& name, JITCompiler::JITFunc fn) {
-        funcs[name] = fn;
+// ============================================================================
+// STRING INTERNING - Avoid allocations, enable pointer comparison
+// ============================================================================
+// ============================================================================
+// GARBAGE COLLECTOR HEAP
+// ============================================================================
+// Objects allocated while a FastVM runs are linked into `objects` and reclaimed
+// by mark-sweep at VM safepoints (loop back-edges and calls), where every live
+// value is reachable from the VM roots. Objects created before that (compile-
+// time constants) go on `permanent`: traced every cycle, never freed.
+//
+// Each thread has its own heap. Thread isolates (see thread_isolates) read
+// the main thread's permanent objects but only ever mark and free their own.
+struct GCHeap {
+    static constexpr size_t MIN_THRESHOLD = 8 * 1024 * 1024;
+    static constexpr uint8_t MAIN_PERMANENT = 0;  // Compile-time objects of the main program
+    static constexpr uint8_t MAIN = 1;
+
+    uint8_t id = MAIN;                     // Stamped on objects tracked here
+    uint8_t permanent_id = MAIN_PERMANENT; // Stamped on permanent objects
+    bool isolate = false;                  // Worker thread heap
+    size_t permanent_count = 0;
+
+    Obj* objects = nullptr;
+    Obj* permanent = nullptr;
+    bool tracking = false;            // Set once a FastVM starts running
+    size_t allocated = 0;             // Bytes allocated since the last collection
+    size_t live_bytes = 0;            // Bytes that survived the last collection
+    size_t threshold = MIN_THRESHOLD; // Collect once `allocated` reaches this
+    size_t object_count = 0;          // Collectable objects currently linked
+    uint64_t collections = 0;
+    uint64_t freed_objects = 0;
+    uint64_t freed_bytes = 0;
+    double pause_ms = 0.0;            // Total time spent collecting
+    uint64_t allocations[OBJ_TYPE_COUNT] = {};  // Objects created, by ObjType
+
+    // Root enumeration supplied by the running VM
+    void (*mark_roots)(void* owner) = nullptr;
+    void* roots_owner = nullptr;
+    std::vector<Obj*> gray;           // Mark worklist
+
+    void track(Obj* o, size_t bytes) {
+        allocations[(size_t)o->type]++;
+        o->heap = tracking ? id : permanent_id;
+        if (tracking) {
+            o->next = objects;
+            objects = o;
+            object_count++;
+            allocated += bytes;
+        } else {
+            o->next = permanent;
+            permanent = o;
+            permanent_count++;
+        }
     }
+    void account(size_t bytes) { if (tracking) allocated += bytes; }
+    bool should_collect() const { return allocated >= threshold; }
+    bool owns(const Obj* o) const { return o->heap == id || o->heap == permanent_id; }
 };
 
-static JITCache g_jit_cache;
+static thread_local GCHeap g_heap;
+
+// Allocate as permanent while compiling at runtime (module imports), like the
+// main program's constants, so compiled chunks stay shareable with isolates
+struct PermanentAllocScope {
+    bool saved;
+    PermanentAllocScope() : saved(g_heap.tracking) { g_heap.tracking = false; }
+    ~PermanentAllocScope() { g_heap.tracking = saved; }
+};
+size_t gc_collect();
 
 // ============================================================================
-// STRING INTERNING - Avoid allocations, enable pointer comparison
+// OBJECT POOL: size-class free lists for VM objects
 // ============================================================================
-class StringPool {
-    std::unordered_map<std::string, ObjString*> pool;  // Use std::string for safe keys
+// Objects up to MAX_SMALL bytes are carved from 64 KB blocks with a bump
+// pointer, and freed cells go onto a per-size-class free list for reuse. The
+// collector hands dead objects back here, so churning through short-lived
+// lists, strings and ranges rarely reaches malloc. Larger cells use malloc.
+class ObjPool {
 public:
-    ObjString* intern(const char* str, size_t len) {
-        std::string key(str, len);
-        auto it = pool.find(key);
-        if (it != pool.end()) return it->second;
-        
-        ObjString* s = ObjString::create(str, len);
-        pool[key] = s;  // Key is a copy, safe from dangling
-        return s;
+    static constexpr size_t GRANULE = 16;
+    static constexpr size_t MAX_SMALL = 256;
+    static constexpr size_t CLASS_COUNT = MAX_SMALL / GRANULE;
+    static constexpr size_t CHUNK_BYTES = 64 * 1024;
+
+    struct Stats {
+        uint64_t bump_allocs = 0;   // Fresh cells carved from a block
+        uint64_t reused = 0;        // Cells served from a free list
+        uint64_t large_allocs = 0;  // Oversized requests passed to malloc
+        uint64_t released = 0;      // Cells returned to a free list
+        size_t block_bytes = 0;     // Memory reserved in blocks
+    };
+
+    void* allocate(size_t bytes) {
+        if (bytes > MAX_SMALL) {
+            stats.large_allocs++;
+            return malloc(bytes);
+        }
+        size_t cls = size_class(bytes);
+        if (FreeCell* cell = free_lists[cls]) {
+            free_lists[cls] = cell->next;
+            stats.reused++;
+            return cell;
+        }
+        size_t cell_size = (cls + 1) * GRANULE;
+        if (bump + cell_size > bump_end) new_block();
+        void* p = bump;
+        bump += cell_size;
+        stats.bump_allocs++;
+        return p;
     }
-    ObjString* intern(const std::string& str) { return intern(str.c_str(), str.size()); }
-};
 
-// Global string pool
-static StringPool g_strings;
+    void release(void* p, size_t bytes) {
+        if (bytes > MAX_SMALL) {
+            free(p);
+            return;
+        }
+        FreeCell* cell = static_cast<FreeCell*>(p);
+        size_t cls = size_class(bytes);
+        cell->next = free_lists[cls];
+        free_lists[cls] = cell;
+        stats.released++;
+    }
 
-// Object allocation
-ObjString* ObjString::create(const char* str, uint32_t len) {
-    ObjString* s = (ObjString*)malloc(sizeof(ObjString) + len + 1);
-    s->type = ObjType::STRING;
-    s->marked = false;
-    s->next = nullptr;
+    const Stats& get_stats() const { return stats; }
+    size_t block_count() const { return blocks.size(); }
+
+private:
+    struct FreeCell { FreeCell* next; };
+
+    static size_t size_class(size_t bytes) { return bytes ? (bytes - 1) / GRANULE : 0; }
+
+    void new_block() {
+        char* block = static_cast<char*>(malloc(CHUNK_BYTES));
+        if (!block) throw std::bad_alloc();
+        blocks.push_back(block);
+        bump = block;
+        bump_end = block + CHUNK_BYTES;
+        stats.block_bytes += CHUNK_BYTES;
+    }
+
+    FreeCell* free_lists[CLASS_COUNT] = {};
+    char* bump = nullptr;
+    char* bump_end = nullptr;
+    std::vector<char*> blocks;  // Never returned: cells are recycled instead
+    Stats stats;
+};
+
+static thread_local ObjPool g_pool;
+
+// Placement-construct a VM object with non-trivial members in pool memory
+template <typename T>
+inline T* pool_new() { return new (g_pool.allocate(sizeof(T))) T(); }
+
+template <typename T>
+inline void pool_delete(T* p) {
+    p->~T();
+    g_pool.release(p, sizeof(T));
+}
+
+// Read-only snapshot of the main thread's permanent strings. Isolates intern
+// through it first, so a name has the same ObjString* in shared chunks and in
+// isolate code. Replaced (never mutated) when new permanent strings appear.
+struct SharedStrings {
+    std::unordered_map<std::string_view, ObjString*> strings;  // Views into the permanent strings
+    size_t permanent_count = 0;  // Main heap permanent_count it was built at
+};
+static std::atomic<const SharedStrings*> g_shared_strings{nullptr};
+
+class StringPool {
+    // Keys view the interned string's own chars, which live as long as the
+    // entry (remove_unmarked drops entries before their strings are swept)
+    std::unordered_map<std::string_view, ObjString*> pool;
+public:
+    // The interned copy of a string, or nullptr if it was never interned
+    ObjString* find(const char* str, size_t len) {
+        std::string_view key(str, len);
+        auto it = pool.find(key);
+        if (it != pool.end()) return it->second;
+        if (g_heap.isolate) {
+            if (const SharedStrings* shared = g_shared_strings.load(std::memory_order_acquire)) {
+                auto found = shared->strings.find(key);
+                if (found != shared->strings.end()) {
+                    pool.emplace(found->first, found->second);  // Not key: the caller's buffer may not outlive the entry
+                    return found->second;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    ObjString* intern(const char* str, size_t len) {
+        if (ObjString* existing = find(str, len)) return existing;
+        ObjString* s = ObjString::create(str, len);
+        s->interned = true;
+        pool.emplace(std::string_view(s->chars, s->length), s);
+        return s;
+    }
+    ObjString* intern(const std::string& str) { return intern(str.c_str(), str.size()); }
+
+    // Interning is weak: drop strings the collector is about to free
+    void remove_unmarked() {
+        for (auto it = pool.begin(); it != pool.end();) {
+            if (g_heap.owns(it->second) && !it->second->marked) it = pool.erase(it);
+            else ++it;
+        }
+    }
+
+    // Main thread: publish permanent strings for isolates (before they run
+    // any chunk that uses them). Superseded snapshots stay allocated, since an
+    // isolate may still be reading one.
+    void publish_shared() {
+        const SharedStrings* current = g_shared_strings.load(std::memory_order_acquire);
+        if (current && current->permanent_count == g_heap.permanent_count) return;
+        SharedStrings* next = new SharedStrings();
+        next->permanent_count = g_heap.permanent_count;
+        for (const auto& entry : pool) {
+            if (entry.second->heap == GCHeap::MAIN_PERMANENT) next->strings.emplace(entry.first, entry.second);
+        }
+        g_shared_strings.store(next, std::memory_order_release);
+    }
+};
+
+// Per-thread string pool
+static thread_local StringPool g_strings;
+
+// Object allocation
+ObjString* ObjString::alloc(uint32_t len, uint32_t capacity) {
+    ObjString* s = (ObjString*)g_pool.allocate(sizeof(ObjString) + capacity + 1);
+    s->type = ObjType::STRING;
+    s->marked = false;
+    s->next = nullptr;
+    s->hash = 0;
     s->length = len;
-    memcpy(s->chars, str, len);
+    s->capacity = capacity;
+    s->interned = false;
+    s->owned = false;
     s->chars[len] = '\0';
+    g_heap.track(s, sizeof(ObjString) + capacity + 1);
+    return s;
+}
+
+void ObjString::rehash() {
     // FNV-1a hash
-    uint32_t hash = 2166136261u;
-    for (uint32_t i = 0; i < len; i++) {
-        hash ^= (uint8_t)str[i];
-        hash *= 16777619u;
+    uint32_t h = 2166136261u;
+    for (uint32_t i = 0; i < length; i++) {
+        h ^= (uint8_t)chars[i];
+        h *= 16777619u;
     }
-    s->hash = hash;
+    hash = h;
+}
+
+ObjString* ObjString::create(const char* str, uint32_t len) {
+    ObjString* s = alloc(len, len);
+    memcpy(s->chars, str, len);
+    s->rehash();
     return s;
 }
 
+// ObjMap keys are interned pointers. Lookups may pass a run-time string
+// (MapTable compares its contents); stores must intern it first.
+inline ObjString* map_key(ObjString* s) { return s->interned ? s : g_strings.intern(s->chars, s->length); }
+
 ObjFunc* make_func(Chunk* c, const char* n, uint8_t a) {
-    ObjFunc* f = (ObjFunc*)malloc(sizeof(ObjFunc));
+    ObjFunc* f = (ObjFunc*)g_pool.allocate(sizeof(ObjFunc));
     f->type = ObjType::FUNCTION;
     f->marked = false;
     f->next = nullptr;
     f->chunk = c;
     f->name = n ? g_strings.intern(n, strlen(n)) : nullptr;
     f->arity = a;
+    g_heap.track(f, sizeof(ObjFunc));
     return f;
 }
 
 ObjList* ObjList::create() {
-    ObjList* l = (ObjList*)malloc(sizeof(ObjList));
+    ObjList* l = (ObjList*)g_pool.allocate(sizeof(ObjList));
     l->type = ObjType::LIST;
     l->marked = false;
     l->next = nullptr;
     l->count = 0;
-    l->capacity = 8;
-    l->items = (uint64_t*)malloc(8 * sizeof(uint64_t));
+    l->capacity = INLINE_CAPACITY;
+    l->items = l->inline_items;
+    g_heap.track(l, sizeof(ObjList));
     return l;
 }
 
-void ObjList::push(uint64_t val) {
-    if (count >= capacity) {
-        capacity *= 2;
-        items = (uint64_t*)realloc(items, capacity * sizeof(uint64_t));
+void ObjList::reserve(size_t n) {
+    if (n <= capacity) return;
+    g_heap.account((n - (is_inline() ? 0 : capacity)) * sizeof(uint64_t));
+    if (is_inline()) {
+        uint64_t* heap_items = (uint64_t*)malloc(n * sizeof(uint64_t));
+        memcpy(heap_items, inline_items, count * sizeof(uint64_t));
+        items = heap_items;
+    } else {
+        items = (uint64_t*)realloc(items, n * sizeof(uint64_t));
     }
+    capacity = n;
+}
+
+void ObjList::push(uint64_t val) {
+    if (count >= capacity) reserve(capacity * 2);
     items[count++] = val;
 }
 
 ObjRange* ObjRange::create(int64_t a, int64_t b, int64_t c) {
-    ObjRange* r = (ObjRange*)malloc(sizeof(ObjRange));
+    ObjRange* r = (ObjRange*)g_pool.allocate(sizeof(ObjRange));
     r->type = ObjType::RANGE;
     r->marked = false;
     r->next = nullptr;
     r->start = a; r->stop = b; r->step = c;
+    g_heap.track(r, sizeof(ObjRange));
     return r;
 }
 
@@ -1537,7 +1750,7 @@ ObjRange* ObjRange::create(int64_t a, int64_t b, int64_t c) {
 // OOP OBJECT CREATION FUNCTIONS
 // ============================================================================
 ObjClass* ObjClass::create(const char* name) {
-    ObjClass* c = new ObjClass();
+    ObjClass* c = pool_new<ObjClass>();
     c->type = ObjType::CLASS;
     c->marked = false;
     c->next = nullptr;
@@ -1545,6 +1758,7 @@ ObjClass* ObjClass::create(const char* name) {
     c->parent = nullptr;
     c->is_abstract = false;
     c->arity = 0;
+    g_heap.track(c, sizeof(ObjClass));
     return c;
 }
 
@@ -1569,22 +1783,344 @@ void ObjClass::collect_missing_abstract_methods(std::unordered_set<std::string>&
 }
 
 ObjInstance* ObjInstance::create(ObjClass* klass) {
-    ObjInstance* inst = new ObjInstance();
+    ObjInstance* inst = pool_new<ObjInstance>();
     inst->type = ObjType::INSTANCE;
     inst->marked = false;
     inst->next = nullptr;
     inst->klass = klass;
+    inst->shape = Shape::root();
+    g_heap.track(inst, sizeof(ObjInstance));
     return inst;
 }
 
+uint64_t* ObjInstance::find_field(ObjString* name) {
+    int slot = shape->lookup(name);
+    if (slot >= 0) return &slots[slot];
+    if (!overflow.empty()) {
+        auto it = overflow.find(name);
+        if (it != overflow.end()) return &it->second;
+    }
+    return nullptr;
+}
+
+void ObjInstance::set_field(ObjString* name, uint64_t value) {
+    if (uint64_t* field = find_field(name)) {
+        *field = value;
+    } else if (shape->keys.size() < Shape::MAX_SLOTS) {
+        shape = shape->with_field(name);
+        slots.push_back(value);
+        g_heap.account(sizeof(uint64_t));
+    } else {
+        overflow[name] = value;
+    }
+}
+
+// Shapes are per thread, like the heaps whose instances use them
+Shape* Shape::root() {
+    static thread_local Shape* empty = new Shape();
+    return empty;
+}
+
+std::vector<Shape*>& Shape::all() {
+    static thread_local std::vector<Shape*> shapes;
+    return shapes;
+}
+
+int Shape::lookup(ObjString* name) const {
+    if (keys.size() <= LINEAR_SCAN) {
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (keys[i] == name) return (int)i;
+        }
+        return -1;
+    }
+    auto it = index.find(name);
+    return it == index.end() ? -1 : (int)it->second;
+}
+
+Shape* Shape::with_field(ObjString* name) {
+    auto it = transitions.find(name);
+    if (it != transitions.end()) return it->second;
+
+    Shape* next = new Shape();
+    next->keys = keys;
+    next->keys.push_back(name);
+    if (next->keys.size() > LINEAR_SCAN) {
+        for (size_t i = 0; i < next->keys.size(); ++i) next->index[next->keys[i]] = (uint32_t)i;
+    }
+    transitions[name] = next;
+    all().push_back(next);
+    return next;
+}
+
 ObjMap *ObjMap::create() {
-  ObjMap *m = new ObjMap();
+  ObjMap *m = pool_new<ObjMap>();
   m->type = ObjType::MAP;
   m->marked = false;
   m->next = nullptr;
+  g_heap.track(m, sizeof(ObjMap));
   return m;
 }
 
+ObjNative* ObjNative::create(ObjString* name, NativeFn fn, LegacyNativeFn legacy) {
+    ObjNative* n = pool_new<ObjNative>();
+    n->type = ObjType::NATIVE;
+    n->marked = false;
+    n->next = nullptr;
+    n->name = name;
+    n->fn = fn;
+    n->legacy = legacy;
+    g_heap.track(n, sizeof(ObjNative));
+    return n;
+}
+
+static void* tensor_buffer_alloc(size_t bytes) {
+    bytes = (std::max<size_t>(bytes, 1) + 63) & ~size_t(63);
+#ifdef _WIN32
+    void* p = _aligned_malloc(bytes, 64);
+#else
+    void* p = nullptr;
+    if (posix_memalign(&p, 64, bytes) != 0) p = nullptr;
+#endif
+    if (!p) throw std::bad_alloc();
+    memset(p, 0, bytes);
+    return p;
+}
+
+static void tensor_buffer_free(void* p) {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+ObjTensor* ObjTensor::create(DType dtype, const int64_t* shape, int ndim) {
+    ObjTensor* t = pool_new<ObjTensor>();
+    t->type = ObjType::TENSOR;
+    t->marked = false;
+    t->next = nullptr;
+    t->dtype = dtype;
+    t->ndim = (uint8_t)ndim;
+    t->count = 1;
+    for (int i = ndim - 1; i >= 0; i--) {
+        t->shape[i] = shape[i];
+        t->strides[i] = (int64_t)t->count;
+        t->count *= (size_t)shape[i];
+    }
+    t->offset = 0;
+    t->base = nullptr;
+    t->data = tensor_buffer_alloc(t->count * t->elem_size());
+    g_heap.track(t, sizeof(ObjTensor) + t->count * t->elem_size());
+    return t;
+}
+
+ObjTensor* ObjTensor::view(ObjTensor* src, const int64_t* shape, const int64_t* strides, int ndim, size_t offset) {
+    ObjTensor* t = pool_new<ObjTensor>();
+    t->type = ObjType::TENSOR;
+    t->marked = false;
+    t->next = nullptr;
+    t->dtype = src->dtype;
+    t->ndim = (uint8_t)ndim;
+    t->count = 1;
+    for (int i = 0; i < ndim; i++) {
+        t->shape[i] = shape[i];
+        t->strides[i] = strides[i];
+        t->count *= (size_t)shape[i];
+    }
+    t->offset = offset;
+    t->base = src->base ? src->base : src;
+    t->data = src->data;
+    g_heap.track(t, sizeof(ObjTensor));
+    return t;
+}
+
+ObjBytes* ObjBytes::create(size_t length) {
+    ObjBytes* b = pool_new<ObjBytes>();
+    b->type = ObjType::BYTES;
+    b->marked = false;
+    b->next = nullptr;
+    b->data = static_cast<uint8_t*>(calloc(length ? length : 1, 1));
+    if (!b->data) throw std::bad_alloc();
+    b->length = length;
+    b->base = nullptr;
+    g_heap.track(b, sizeof(ObjBytes) + length);
+    return b;
+}
+
+ObjBytes* ObjBytes::create(const void* src, size_t length) {
+    ObjBytes* b = create(length);
+    if (length) memcpy(b->data, src, length);
+    return b;
+}
+
+ObjBytes* ObjBytes::view(ObjBytes* src, size_t start, size_t length) {
+    ObjBytes* b = pool_new<ObjBytes>();
+    b->type = ObjType::BYTES;
+    b->marked = false;
+    b->next = nullptr;
+    b->data = src->data + start;
+    b->length = length;
+    b->base = src->base ? src->base : src;
+    g_heap.track(b, sizeof(ObjBytes));
+    return b;
+}
+
+ObjReader* ObjReader::open(const std::string& path) {
+#ifdef _WIN32
+    int fd = _open(path.c_str(), _O_RDONLY | _O_BINARY);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+#endif
+    if (fd < 0) return nullptr;
+    ObjReader* r = pool_new<ObjReader>();
+    r->type = ObjType::READER;
+    r->marked = false;
+    r->next = nullptr;
+    r->fd = fd;
+    std::error_code ec;
+    uintmax_t size = fs::is_regular_file(path, ec) ? fs::file_size(path, ec) : 0;
+    if (!ec && size > 0) {
+        void* mapped = platform_mmap(nullptr, (size_t)size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED) {
+            platform_madvise(mapped, (size_t)size, MADV_SEQUENTIAL);
+            r->map = static_cast<char*>(mapped);
+            r->map_size = (size_t)size;
+        }
+    }
+    g_heap.track(r, sizeof(ObjReader) + g_heap.threshold / OPENS_PER_COLLECTION);
+    return r;
+}
+
+bool ObjReader::fill() {
+    if (eof || fd < 0) return false;
+    if (pos > 0) {
+        buf.erase(0, pos);
+        pos = 0;
+    }
+    size_t have = buf.size();
+    buf.resize(have + FILL_BYTES);
+#ifdef _WIN32
+    int n = _read(fd, &buf[have], (unsigned int)FILL_BYTES);
+#else
+    ssize_t n = read(fd, &buf[have], FILL_BYTES);
+#endif
+    buf.resize(have + (n > 0 ? (size_t)n : 0));
+    if (n <= 0) eof = true;
+    return n > 0;
+}
+
+bool ObjReader::next_line(std::string_view& line) {
+    const char* base;
+    size_t end;
+    const char* nl;
+    if (map) {
+        base = map;
+        end = map_size;
+        nl = pos < end ? static_cast<const char*>(memchr(map + pos, '\n', end - pos)) : nullptr;
+    } else {
+        size_t scanned = pos;  // Bytes before this have no newline
+        for (;;) {
+            nl = scanned < buf.size() ? static_cast<const char*>(memchr(&buf[scanned], '\n', buf.size() - scanned)) : nullptr;
+            if (nl) break;
+            scanned = buf.size() - pos;  // fill() moves the unread bytes to the front
+            if (!fill()) break;
+        }
+        base = buf.data();
+        end = buf.size();
+    }
+    if (pos >= end) return false;
+    size_t stop = nl ? (size_t)(nl - base) : end;
+    size_t len = stop - pos;
+    if (len > 0 && base[pos + len - 1] == '\r') len--;
+    line = std::string_view(base + pos, len);
+    pos = nl ? stop + 1 : end;
+    return true;
+}
+
+std::string_view ObjReader::read_chunk(size_t n) {
+    if (map) {
+        size_t take = std::min(n, map_size - std::min(pos, map_size));
+        std::string_view out(map + pos, take);
+        pos += take;
+        return out;
+    }
+    while (buf.size() - pos < n && fill()) {}
+    size_t take = std::min(n, buf.size() - pos);
+    std::string_view out(buf.data() + pos, take);
+    pos += take;
+    return out;
+}
+
+void ObjReader::close() {
+    if (map) platform_munmap(map, map_size);
+    map = nullptr;
+    map_size = 0;
+    pos = 0;
+    if (fd >= 0) {
+#ifdef _WIN32
+        _close(fd);
+#else
+        ::close(fd);
+#endif
+    }
+    fd = -1;
+    eof = true;
+    std::string().swap(buf);
+}
+
+bool ObjTensor::contiguous() const {
+    int64_t expect = 1;
+    for (int i = ndim - 1; i >= 0; i--) {
+        if (shape[i] != 1 && strides[i] != expect) return false;
+        expect *= shape[i];
+    }
+    return true;
+}
+
+size_t ObjTensor::element_index(size_t flat) const {
+    size_t index = offset;
+    for (int i = ndim - 1; i >= 0; i--) {
+        size_t dim = (size_t)shape[i];
+        index += (flat % dim) * (size_t)strides[i];
+        flat /= dim;
+    }
+    return index;
+}
+
+double ObjTensor::get(size_t flat) const {
+    size_t i = contiguous() ? offset + flat : element_index(flat);
+    switch (dtype) {
+        case DType::F32: return static_cast<float*>(data)[i];
+        case DType::F64: return static_cast<double*>(data)[i];
+        case DType::I64: return (double)static_cast<int64_t*>(data)[i];
+    }
+    return 0.0;
+}
+
+void ObjTensor::set(size_t flat, double v) {
+    size_t i = contiguous() ? offset + flat : element_index(flat);
+    switch (dtype) {
+        case DType::F32: static_cast<float*>(data)[i] = (float)v; break;
+        case DType::F64: static_cast<double*>(data)[i] = v; break;
+        case DType::I64: static_cast<int64_t*>(data)[i] = (int64_t)v; break;
+    }
+}
+
+ObjCoroutine* ObjCoroutine::create(ObjString* name) {
+    ObjCoroutine* c = pool_new<ObjCoroutine>();
+    c->type = ObjType::COROUTINE;
+    c->marked = false;
+    c->next = nullptr;
+    c->state = State::RUNNING;
+    c->queued = false;
+    c->name = name;
+    c->result = VAL_NONE;
+    c->has_deadline = false;
+    c->deadline_timer = 0;
+    g_heap.track(c, sizeof(ObjCoroutine));
+    return c;
+}
+
 // ============================================================================
 // FAST VALUE OPERATIONS (all inline for speed)
 // ============================================================================
@@ -1593,8 +2129,9 @@ inline uint64_t val_number(double d) { uint64_t v; memcpy(&v, &d, 8); return v;
 inline uint64_t val_int(int64_t i) { return QNAN_BITS | TAG_INT | (i & INT_MASK); }
 inline uint64_t val_obj(Obj* o) { return QNAN_BITS | TAG_OBJ | (uint64_t)(uintptr_t)o; }
 inline uint64_t val_string(ObjString* s) { return val_obj((Obj*)s); }
-inline uint64_t val_string(const std::string& s) { return val_obj((Obj*)g_strings.intern(s)); }
-inline uint64_t val_string(const char* s) { return val_obj((Obj*)g_strings.intern(s, strlen(s))); }
+// Run-time strings are not interned; constants and names go through g_strings
+inline uint64_t val_string(const std::string& s) { return val_obj((Obj*)ObjString::create(s.data(), (uint32_t)s.size())); }
+inline uint64_t val_string(const char* s) { return val_obj((Obj*)ObjString::create(s, (uint32_t)strlen(s))); }
 inline uint64_t val_func(ObjFunc* f) { return val_obj((Obj*)f); }
 inline uint64_t val_list(ObjList* l) { return val_obj((Obj*)l); }
 
@@ -1620,6 +2157,11 @@ inline ObjRange* as_range(uint64_t v) { return (ObjRange*)as_obj(v); }
 inline ObjClass* as_class(uint64_t v) { return (ObjClass*)as_obj(v); }
 inline ObjInstance* as_instance(uint64_t v) { return (ObjInstance*)as_obj(v); }
 inline ObjMap* as_map(uint64_t v) { return (ObjMap*)as_obj(v); }
+inline ObjNative* as_native(uint64_t v) { return (ObjNative*)as_obj(v); }
+inline ObjCoroutine* as_coroutine(uint64_t v) { return (ObjCoroutine*)as_obj(v); }
+inline ObjTensor* as_tensor(uint64_t v) { return (ObjTensor*)as_obj(v); }
+inline ObjBytes* as_bytes(uint64_t v) { return (ObjBytes*)as_obj(v); }
+inline ObjReader* as_reader(uint64_t v) { return (ObjReader*)as_obj(v); }
 inline ObjType obj_type(uint64_t v) { return as_obj(v)->type; }
 
 // OOP value helpers
@@ -1631,6 +2173,108 @@ inline bool is_instance(uint64_t v) { return is_obj(v) && obj_type(v) == ObjType
 inline bool is_map(uint64_t v) {
   return is_obj(v) && obj_type(v) == ObjType::MAP;
 }
+inline bool is_native(uint64_t v) { return is_obj(v) && obj_type(v) == ObjType::NATIVE; }
+inline bool is_coroutine(uint64_t v) { return is_obj(v) && obj_type(v) == ObjType::COROUTINE; }
+inline bool is_tensor(uint64_t v) { return is_obj(v) && obj_type(v) == ObjType::TENSOR; }
+inline bool is_bytes(uint64_t v) { return is_obj(v) && obj_type(v) == ObjType::BYTES; }
+inline bool is_reader(uint64_t v) { return is_obj(v) && obj_type(v) == ObjType::READER; }
+inline const char* dtype_name(DType d) { return d == DType::F32 ? "f32" : d == DType::F64 ? "f64" : "i64"; }
+
+static double tensor_load_f(const ObjTensor* t, size_t i) {
+    switch (t->dtype) {
+        case DType::F32: return static_cast<const float*>(t->data)[i];
+        case DType::F64: return static_cast<const double*>(t->data)[i];
+        case DType::I64: return (double)static_cast<const int64_t*>(t->data)[i];
+    }
+    return 0.0;
+}
+
+static uint64_t tensor_load(const ObjTensor* t, size_t i) {
+    if (t->dtype == DType::I64) return val_int(static_cast<const int64_t*>(t->data)[i]);
+    return val_number(tensor_load_f(t, i));
+}
+
+// t itself when it is already contiguous in dtype, else a packed copy
+static ObjTensor* tensor_dense(ObjTensor* t, DType dtype) {
+    if (t->dtype == dtype && t->contiguous()) return t;
+    ObjTensor* out = ObjTensor::create(dtype, t->shape, t->ndim);
+    bool packed = t->contiguous();
+    for (size_t f = 0; f < t->count; f++) {
+        size_t i = packed ? t->offset + f : t->element_index(f);
+        if (dtype == DType::I64 && t->dtype == DType::I64) {
+            out->ptr<int64_t>()[f] = static_cast<const int64_t*>(t->data)[i];
+        } else if (dtype == DType::I64) {
+            out->ptr<int64_t>()[f] = (int64_t)tensor_load_f(t, i);
+        } else if (dtype == DType::F32) {
+            out->ptr<float>()[f] = (float)tensor_load_f(t, i);
+        } else {
+            out->ptr<double>()[f] = tensor_load_f(t, i);
+        }
+    }
+    return out;
+}
+
+static uint64_t tensor_to_list(const ObjTensor* t, int dim, size_t at) {
+    ObjList* out = ObjList::create();
+    out->reserve((size_t)t->shape[dim]);
+    for (int64_t i = 0; i < t->shape[dim]; i++) {
+        size_t pos = at + (size_t)(i * t->strides[dim]);
+        out->push(dim + 1 < t->ndim ? tensor_to_list(t, dim + 1, pos) : tensor_load(t, pos));
+    }
+    return val_list(out);
+}
+
+void ObjClass::resolve() {
+    // Classes are shared with thread isolates; resolve one at a time
+    static std::mutex resolve_mu;
+    std::lock_guard<std::mutex> lk(resolve_mu);
+    std::unordered_set<std::string> missing;
+    collect_missing_abstract_methods(missing);
+    missing_abstract = missing.empty() ? std::string() : *missing.begin();
+    instantiable = !is_abstract && missing.empty();
+    uint64_t init_method = find_method("init");
+    init = init_method != VAL_NONE ? as_func(init_method) : nullptr;
+    resolved_version.store(g_class_version.load(), std::memory_order_release);
+}
+
+// String equality for two distinct string objects. Two interned strings of
+// one heap are equal only if they are the same object; everything else falls
+// back to length, cached hash and contents.
+inline bool string_values_equal(uint64_t a, uint64_t b) {
+    if (!is_obj(a) || !is_obj(b) || obj_type(a) != ObjType::STRING || obj_type(b) != ObjType::STRING) return false;
+    ObjString* sa = as_string(a);
+    ObjString* sb = as_string(b);
+    if (sa->interned && sb->interned && sa->heap == sb->heap) return false;
+    if (sa->length != sb->length) return false;
+    if (!sa->owned && !sb->owned && sa->hash != sb->hash) return false;  // Owned buffers have no hash yet
+    return memcmp(sa->chars, sb->chars, sa->length) == 0;
+}
+
+// Byte buffers compare by contents
+inline bool bytes_values_equal(uint64_t a, uint64_t b) {
+    if (!is_bytes(a) || !is_bytes(b)) return false;
+    ObjBytes* ba = as_bytes(a);
+    ObjBytes* bb = as_bytes(b);
+    return ba->length == bb->length && memcmp(ba->data, bb->data, ba->length) == 0;
+}
+
+// Offset of the first match of a byte value, bytes or string in b, or -1
+inline int64_t bytes_find(const ObjBytes* b, uint64_t needle) {
+    if (is_int(needle) && !is_bool(needle)) {
+        const void* hit = b->length ? memchr(b->data, (int)(as_int(needle) & 0xFF), b->length) : nullptr;
+        return hit ? (int64_t)(static_cast<const uint8_t*>(hit) - b->data) : -1;
+    }
+    const uint8_t* n = nullptr;
+    size_t n_len = 0;
+    if (is_bytes(needle)) { n = as_bytes(needle)->data; n_len = as_bytes(needle)->length; }
+    else if (is_obj(needle) && obj_type(needle) == ObjType::STRING) {
+        n = reinterpret_cast<const uint8_t*>(as_string(needle)->chars);
+        n_len = as_string(needle)->length;
+    } else return -1;
+    if (n_len == 0) return 0;
+    const uint8_t* hit = std::search(b->data, b->data + b->length, n, n + n_len);
+    return hit == b->data + b->length ? -1 : (int64_t)(hit - b->data);
+}
 
 // Value equality comparison
 inline bool values_equal(uint64_t a, uint64_t b) {
@@ -1643,8 +2287,7 @@ inline bool values_equal(uint64_t a, uint64_t b) {
         double vb = is_int(b) ? (double)as_int(b) : as_number(b);
         return va == vb;
     }
-    // Strings are interned, so identity = equality  
-    return false;
+    return string_values_equal(a, b) || bytes_values_equal(a, b);
 }
 
 // Truthiness
@@ -1663,15 +2306,23 @@ inline uint64_t fast_add(uint64_t a, uint64_t b) {
         (b & (QNAN_BITS | TAG_INT)) == (QNAN_BITS | TAG_INT)) {
         return QNAN_BITS | TAG_INT | ((a + b) & INT_MASK);
     }
-    // String concatenation
+    // String concatenation: one allocation, both halves copied straight in
     if (is_obj(a) && obj_type(a) == ObjType::STRING) {
-        std::string result = as_string(a)->str();
-        if (is_obj(b) && obj_type(b) == ObjType::STRING) result += as_string(b)->str();
-        else if (is_int(b)) result += std::to_string(as_int(b));
-        else if (is_number(b)) result += std::to_string(as_number(b));
-        else if (is_bool(b)) result += (b == VAL_TRUE) ? "true" : "false";
-        else if (is_none(b)) result += "none";
-        return val_string(result);
+        ObjString* left = as_string(a);
+        std::string formatted;
+        const char* rhs = nullptr;
+        size_t rhs_len = 0;
+        if (is_obj(b) && obj_type(b) == ObjType::STRING) { rhs = as_string(b)->chars; rhs_len = as_string(b)->length; }
+        else if (is_bool(b)) { rhs = (b == VAL_TRUE) ? "true" : "false"; rhs_len = strlen(rhs); }
+        else if (is_int(b)) formatted = std::to_string(as_int(b));
+        else if (is_number(b)) formatted = std::to_string(as_number(b));
+        else if (is_none(b)) formatted = "none";
+        if (!rhs) { rhs = formatted.data(); rhs_len = formatted.size(); }
+        ObjString* out = ObjString::alloc(left->length + (uint32_t)rhs_len, left->length + (uint32_t)rhs_len);
+        memcpy(out->chars, left->chars, left->length);
+        memcpy(out->chars + left->length, rhs, rhs_len);
+        out->rehash();
+        return val_obj((Obj*)out);
     }
     // List concatenation operation
     if (is_obj(a) && obj_type(a) == ObjType::LIST && 
@@ -1689,6 +2340,14 @@ inline uint64_t fast_add(uint64_t a, uint64_t b) {
         }
         return val_list(result);
     }
+    if (is_bytes(a) && is_bytes(b)) {
+        ObjBytes* ba = as_bytes(a);
+        ObjBytes* bb = as_bytes(b);
+        ObjBytes* out = ObjBytes::create(ba->length + bb->length);
+        if (ba->length) memcpy(out->data, ba->data, ba->length);
+        if (bb->length) memcpy(out->data + ba->length, bb->data, bb->length);
+        return val_obj((Obj*)out);
+    }
     // Float addition
     double da = is_int(a) ? (double)as_int(a) : as_number(a);
     double db = is_int(b) ? (double)as_int(b) : as_number(b);
@@ -1726,7 +2385,51 @@ inline uint64_t fast_le(uint64_t a, uint64_t b) {
     return da <= db ? VAL_TRUE : VAL_FALSE;
 }
 
-inline uint64_t fast_eq(uint64_t a, uint64_t b) { return a == b ? VAL_TRUE : VAL_FALSE; }
+inline uint64_t fast_eq(uint64_t a, uint64_t b) {
+    if (a == b) return VAL_TRUE;
+    return string_values_equal(a, b) || bytes_values_equal(a, b) ? VAL_TRUE : VAL_FALSE;
+}
+
+// OP_APPEND_LOCAL / OP_APPEND_GLOBAL: slot <- slot + rhs. A string variable
+// that is appended to becomes an owned buffer with spare capacity, so a loop
+// of appends copies each piece once instead of the whole string every time.
+// Every other read of the variable (OP_GET_LOCAL_SEAL, OP_GET_GLOBAL) freezes
+// the buffer first, so no alias ever sees it grow.
+inline void append_in_place(uint64_t& slot, uint64_t rhs) {
+    uint64_t cur = slot;
+    if (is_obj(cur) && obj_type(cur) == ObjType::STRING && is_obj(rhs) && obj_type(rhs) == ObjType::STRING) {
+        ObjString* s = as_string(cur);
+        ObjString* r = as_string(rhs);
+        uint64_t need = (uint64_t)s->length + r->length;
+        if (s->owned && need <= s->capacity) {
+            memcpy(s->chars + s->length, r->chars, r->length);
+            s->length = (uint32_t)need;
+            s->chars[need] = '\0';
+            return;
+        }
+        if (need < UINT32_MAX / 2) {
+            ObjString* out = ObjString::alloc((uint32_t)need, (uint32_t)std::max<uint64_t>(need * 2, 32));
+            memcpy(out->chars, s->chars, s->length);
+            memcpy(out->chars + s->length, r->chars, r->length);
+            out->owned = true;
+            slot = val_obj((Obj*)out);
+            return;
+        }
+    }
+    slot = fast_add(cur, rhs);
+}
+
+// An owned buffer becomes an ordinary immutable string
+inline uint64_t seal_string(uint64_t v) {
+    if (is_obj(v) && obj_type(v) == ObjType::STRING) {
+        ObjString* s = as_string(v);
+        if (s->owned) {
+            s->owned = false;
+            s->rehash();
+        }
+    }
+    return v;
+}
 
 // Convert fast value to string for printing
 std::string val_to_string(uint64_t v) {
@@ -1752,6 +2455,23 @@ std::string val_to_string(uint64_t v) {
             case ObjType::RANGE: return "<range>";
             case ObjType::MAP:
               return "<map>";
+            case ObjType::NATIVE: return "<native fn " + as_native(v)->name->str() + ">";
+            case ObjType::COROUTINE: return "<coroutine " + as_coroutine(v)->name->str() + ">";
+            case ObjType::TENSOR: {
+                ObjTensor* t = as_tensor(v);
+                std::string s = std::string("<tensor ") + dtype_name(t->dtype) + " [";
+                for (int i = 0; i < t->ndim; i++) {
+                    if (i > 0) s += ", ";
+                    s += std::to_string(t->shape[i]);
+                }
+                return s + "]>";
+            }
+            case ObjType::BYTES: {
+                // Raw contents, so text sinks (say, os.write, HTTP bodies) take bytes as-is
+                ObjBytes* b = as_bytes(v);
+                return std::string(reinterpret_cast<const char*>(b->data), b->length);
+            }
+            case ObjType::READER: return as_reader(v)->fd >= 0 ? "<reader>" : "<reader closed>";
             default: return "<object>";
         }
     }
@@ -1816,6 +2536,24 @@ enum class OpCode : uint8_t {
     OP_BUILD_TUPLE, OP_UNPACK_TUPLE,
     // Module import
     OP_IMPORT,
+    OP_MODULE_EXPORTS,     // End of a .levy module body: push its exports map
+    OP_AWAIT,              // await(target, timeout?): suspends a running coroutine
+    OP_APPEND_LOCAL,       // local <- local + pop(), in place for string builders
+    OP_APPEND_GLOBAL,      // Same for a global slot
+    OP_GET_LOCAL_SEAL,     // Push a string-builder local, freezing its buffer
+    OP_ITER_POP,           // Drop n for-in iterators (break/return out of the loops)
+    // Superinstructions emitted by the compile-time peephole pass
+    OP_POP_JUMP_IF_FALSE,  // Pop the condition; jump if it is falsy
+    OP_JUMP_IF_NOT_EQ,     // Pop b and a; jump unless a == b (same order as OP_EQ..OP_GE)
+    OP_JUMP_IF_NOT_NE,
+    OP_JUMP_IF_NOT_LT,
+    OP_JUMP_IF_NOT_GT,
+    OP_JUMP_IF_NOT_LE,
+    OP_JUMP_IF_NOT_GE,
+    OP_JUMP_IF_LOCAL_NOT_LT,  // <slot> <imm8> <off16>: jump unless local < imm
+    OP_ADD_LOCALS,         // <a> <b>: push local a + local b
+    OP_INC_LOCAL,          // <slot> <int8>: local <- local + delta (a whole statement)
+    OP_INDEX_LOCAL,        // <slot>: replace the top with top[local]
 
     // ============================================================================
     // FUTURE-PROOF: HARDWARE & EMBEDDED SYSTEMS PRIMITIVES
@@ -1850,6 +2588,11 @@ enum class OpCode : uint8_t {
     OP_TENSOR_MEAN,        // Mean of all elements
     OP_TENSOR_RESHAPE,     // Reshape tensor
     OP_TENSOR_TRANSPOSE,   // Transpose matrix/tensor
+    OP_TENSOR_FROM,        // Tensor from a nested number list
+    OP_TENSOR_TOLIST,      // Tensor to nested lists
+    OP_TENSOR_SHAPE,       // Dimensions as a list
+    OP_BYTES_NEW,          // Byte buffer from a string, int list or size
+    OP_BYTES_SLICE,        // Zero-copy view of a byte range
     
     // ============================================================================
     // FUTURE-PROOF: SIMD/VECTORIZATION PRIMITIVES
@@ -1873,6 +2616,476 @@ enum class OpCode : uint8_t {
     OP_CHANNEL_RECV        // Receive from channel
 };
 
+// Opcode names in enum order, for profiles and bytecode dumps
+static const char* const OPCODE_NAMES[] = {
+    "CONST", "CONST_INT", "NONE", "TRUE", "FALSE", "POP", "DUP", "ADD", "SUB", "MUL", "DIV", "MOD",
+    "POW", "NEG", "EQ", "NE", "LT", "GT", "LE", "GE", "NOT", "AND", "OR", "GET_GLOBAL",
+    "SET_GLOBAL", "DEFINE_GLOBAL", "GET_LOCAL", "SET_LOCAL", "JUMP", "JUMP_IF_FALSE", "LOOP",
+    "CALL", "RETURN", "GET_INDEX", "SET_INDEX", "ITER_INIT", "ITER_NEXT", "BUILTIN_SAY",
+    "BUILTIN_LEN", "BUILTIN_RANGE", "BUILTIN_APPEND", "BUILTIN_ASK", "BUILD_LIST", "FAST_LOOP_SUM",
+    "FAST_LOOP_COUNT", "FAST_LOOP_GENERIC", "BUILTIN_TIME", "BUILTIN_MIN", "BUILTIN_MAX",
+    "BUILTIN_ABS", "BUILTIN_SUM", "BUILTIN_SORTED", "BUILTIN_REVERSED", "BUILTIN_SQRT",
+    "BUILTIN_POW", "BUILTIN_FLOOR", "BUILTIN_CEIL", "BUILTIN_ROUND", "BUILTIN_UPPER",
+    "BUILTIN_LOWER", "BUILTIN_TRIM", "BUILTIN_REPLACE", "BUILTIN_SPLIT", "BUILTIN_JOIN",
+    "BUILTIN_CONTAINS", "BUILTIN_FIND", "BUILTIN_STARTSWITH", "BUILTIN_ENDSWITH", "BUILTIN_KEYS",
+    "BUILTIN_ENUMERATE", "BUILTIN_ZIP", "BUILTIN_PRINT", "BUILTIN_PRINTLN", "BUILTIN_STR",
+    "BUILTIN_INT", "BUILTIN_FLOAT", "BUILTIN_TYPE", "BUILTIN_ISINSTANCE", "BUILTIN_HASATTR",
+    "BUILTIN_GETATTR", "BUILTIN_SETATTR", "BUILTIN_SIN", "BUILTIN_COS", "BUILTIN_TAN",
+    "BUILTIN_ATAN", "BUILTIN_EXP", "BUILTIN_LOG", "BUILTIN_COUNT_PRIMES", "BUILTIN_IS_PRIME",
+    "FILE_OPEN", "FILE_READ", "FILE_WRITE", "FILE_CLOSE", "BUILTIN_WRITE_FILE", "BUILTIN_READ_FILE",
+    "BUILTIN_FILE_EXISTS", "METHOD_CALL", "GET_PROPERTY", "BUILD_MAP", "CLASS_DEF", "NEW_INSTANCE",
+    "SET_PROPERTY", "GET_SELF", "INVOKE_METHOD", "SUPER_INVOKE", "WRITE_MILLION_LINES",
+    "READ_MILLION_LINES", "LIST_BUILD_TEST", "LIST_SUM_TEST", "LIST_ACCESS_TEST", "STRING_LEN_TEST",
+    "INT_TO_STRING_TEST", "MIXED_WORKLOAD_TEST", "TRY", "CATCH", "THROW", "BUILD_TUPLE",
+    "UNPACK_TUPLE", "IMPORT", "MODULE_EXPORTS", "AWAIT", "APPEND_LOCAL", "APPEND_GLOBAL",
+    "GET_LOCAL_SEAL", "ITER_POP", "POP_JUMP_IF_FALSE", "JUMP_IF_NOT_EQ", "JUMP_IF_NOT_NE",
+    "JUMP_IF_NOT_LT", "JUMP_IF_NOT_GT", "JUMP_IF_NOT_LE", "JUMP_IF_NOT_GE", "JUMP_IF_LOCAL_NOT_LT",
+    "ADD_LOCALS", "INC_LOCAL", "INDEX_LOCAL", "MEM_ALLOC", "MEM_FREE", "MEM_READ8", "MEM_READ16", "MEM_READ32",
+    "MEM_READ64", "MEM_WRITE8", "MEM_WRITE16", "MEM_WRITE32", "MEM_WRITE64", "BITWISE_AND",
+    "BITWISE_OR", "BITWISE_XOR", "BITWISE_NOT", "SHIFT_LEFT", "SHIFT_RIGHT", "SHIFT_RIGHT_ARITH",
+    "TENSOR_CREATE", "TENSOR_ADD", "TENSOR_MUL", "TENSOR_MATMUL", "TENSOR_DOT", "TENSOR_SUM",
+    "TENSOR_MEAN", "TENSOR_RESHAPE", "TENSOR_TRANSPOSE", "TENSOR_FROM", "TENSOR_TOLIST",
+    "TENSOR_SHAPE", "BYTES_NEW", "BYTES_SLICE", "SIMD_ADD_F32X4", "SIMD_MUL_F32X4",
+    "SIMD_ADD_F64X2", "SIMD_MUL_F64X2", "SIMD_DOT_F32X4", "ATOMIC_LOAD", "ATOMIC_STORE",
+    "ATOMIC_ADD", "ATOMIC_CAS", "SPAWN_THREAD", "JOIN_THREAD", "CHANNEL_SEND", "CHANNEL_RECV",
+};
+static_assert(sizeof(OPCODE_NAMES) / sizeof(OPCODE_NAMES[0]) == (size_t)OpCode::OP_CHANNEL_RECV + 1,
+              "OPCODE_NAMES must list every opcode");
+
+// ============================================================================
+// PROFILER (--profile)
+// ============================================================================
+// A SIGPROF timer samples the main interpreter's call stack every
+// interval_us of CPU time. The handler resolves frame names into fixed
+// tables (no allocation or locking in signal context); everything else is
+// derived when the report is written: at exit, when the profiled VM shuts
+// down, or whenever a signal armed with os.signal(sig, "profile") arrives.
+namespace profiler {
+
+// Copies up to max frame names (root first) of the attached VM; sets *jit
+// when the innermost frame is running compiled code
+using WalkFn = size_t (*)(void* vm, const char** names, size_t max, bool* jit);
+
+struct CacheStats {
+    uint64_t hits = 0, misses = 0;
+    uint64_t sites = 0, monomorphic = 0, polymorphic = 0, megamorphic = 0;
+};
+struct CacheReport {
+    CacheStats property, method, module_call;
+};
+using CacheFn = void (*)(void* vm, CacheReport& out);
+
+constexpr size_t MAX_DEPTH = 64;           // Deepest frames kept per sample
+constexpr size_t NAME_SLOTS = 1 << 12;     // Distinct function names
+constexpr size_t NAME_CHARS = 64;
+constexpr size_t STACK_SLOTS = 1 << 14;    // Distinct stacks
+constexpr size_t FRAME_POOL = 1 << 20;     // Name ids of all distinct stacks
+constexpr size_t PROBE_LIMIT = 64;
+
+struct NameSlot {
+    std::atomic<const char*> key{nullptr};  // Published after text is copied
+    char text[NAME_CHARS];
+};
+
+struct StackSlot {
+    std::atomic<uint64_t> hash{0};  // 0 = empty; published after the frames
+    uint32_t offset = 0;
+    uint32_t depth = 0;
+    std::atomic<uint64_t> samples{0};
+    std::atomic<uint64_t> jit_samples{0};
+};
+
+struct State {
+    std::string path;
+    long interval_us = 1000;  // Requested; the kernel delivers at its tick granularity
+    std::chrono::steady_clock::time_point started;
+    double cpu_started_ms = 0.0;
+#ifndef _WIN32
+    pthread_t owner;
+    int dump_pipe[2] = {-1, -1};
+#endif
+    std::atomic<void*> vm{nullptr};
+    WalkFn walk = nullptr;
+    CacheFn caches = nullptr;
+    bool finished = false;
+
+    std::atomic<uint64_t> samples{0}, other_threads{0}, dropped{0};
+    NameSlot names[NAME_SLOTS];
+    StackSlot stacks[STACK_SLOTS];
+    uint16_t frames[FRAME_POOL];
+    size_t frames_used = 0;
+
+    std::mutex report_mutex;
+};
+
+inline State* g_state = nullptr;
+
+// Exact dispatch counts (--profile-ops); execute() only counts when set
+inline bool g_count_ops = false;
+inline std::atomic<uint64_t> g_op_counts[256];
+
+// JIT events, counted whether or not profiling is on (they are rare)
+inline std::atomic<uint64_t> g_jit_compiled{0}, g_jit_failed{0}, g_jit_deopts{0}, g_jit_disabled{0};
+
+inline bool active() { return g_state != nullptr; }
+
+// CPU time of the whole process, which is what ITIMER_PROF samples
+inline double process_cpu_ms() {
+#ifndef _WIN32
+    timespec ts{};
+    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) == 0) return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+#endif
+    return 0.0;
+}
+
+inline void count_op(uint8_t op) {
+    std::atomic<uint64_t>& c = g_op_counts[op];
+    c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+inline void note_jit_compile(bool ok) { (ok ? g_jit_compiled : g_jit_failed).fetch_add(1, std::memory_order_relaxed); }
+inline void note_jit_deopt(bool disabled) {
+    g_jit_deopts.fetch_add(1, std::memory_order_relaxed);
+    if (disabled) g_jit_disabled.fetch_add(1, std::memory_order_relaxed);
+}
+
+// ---- Signal context: fixed tables only ----
+
+// Names are keyed by pointer; the text check catches a freed name whose
+// address was reused for another function
+inline int name_id(State* s, const char* name) {
+    size_t i = (reinterpret_cast<uintptr_t>(name) >> 3) & (NAME_SLOTS - 1);
+    for (size_t probe = 0; probe < PROBE_LIMIT; ++probe, i = (i + 1) & (NAME_SLOTS - 1)) {
+        NameSlot& slot = s->names[i];
+        const char* key = slot.key.load(std::memory_order_relaxed);
+        if (!key) {
+            size_t n = 0;
+            while (n + 1 < NAME_CHARS && name[n]) { slot.text[n] = name[n]; n++; }
+            slot.text[n] = '\0';
+            slot.key.store(name, std::memory_order_release);
+            return (int)i;
+        }
+        if (key == name && std::strncmp(slot.text, name, NAME_CHARS - 1) == 0) return (int)i;
+    }
+    return -1;
+}
+
+inline void record(State* s, const uint16_t* ids, size_t depth, bool jit) {
+    uint64_t h = 1469598103934665603ULL;
+    for (size_t i = 0; i < depth; ++i) h = (h ^ ids[i]) * 1099511628211ULL;
+    h |= 1;
+    size_t i = h & (STACK_SLOTS - 1);
+    for (size_t probe = 0; probe < PROBE_LIMIT; ++probe, i = (i + 1) & (STACK_SLOTS - 1)) {
+        StackSlot& slot = s->stacks[i];
+        uint64_t key = slot.hash.load(std::memory_order_acquire);
+        if (key == 0) {
+            if (s->frames_used + depth > FRAME_POOL) break;
+            std::memcpy(s->frames + s->frames_used, ids, depth * sizeof(uint16_t));
+            slot.offset = (uint32_t)s->frames_used;
+            slot.depth = (uint32_t)depth;
+            s->frames_used += depth;
+            slot.samples.store(1, std::memory_order_relaxed);
+            slot.jit_samples.store(jit ? 1 : 0, std::memory_order_relaxed);
+            slot.hash.store(h, std::memory_order_release);
+            return;
+        }
+        if (key == h && slot.depth == depth &&
+            std::memcmp(s->frames + slot.offset, ids, depth * sizeof(uint16_t)) == 0) {
+            slot.samples.fetch_add(1, std::memory_order_relaxed);
+            if (jit) slot.jit_samples.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+    s->dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+#ifndef _WIN32
+inline void on_sample(int) {
+    State* s = g_state;
+    if (!s) return;
+    int saved_errno = errno;
+    if (!pthread_equal(pthread_self(), s->owner)) {
+        s->other_threads.fetch_add(1, std::memory_order_relaxed);
+        errno = saved_errno;
+        return;
+    }
+    s->samples.fetch_add(1, std::memory_order_relaxed);
+    const char* names[MAX_DEPTH];
+    size_t depth = 0;
+    bool jit = false;
+    void* vm = s->vm.load(std::memory_order_acquire);
+    if (vm) depth = s->walk(vm, names, MAX_DEPTH, &jit);
+    if (depth == 0) {
+        names[0] = "[runtime]";  // Compiling, loading the cache, or tearing down
+        depth = 1;
+    }
+    uint16_t ids[MAX_DEPTH];
+    for (size_t i = 0; i < depth; ++i) {
+        int id = name_id(s, names[i]);
+        if (id < 0) {
+            s->dropped.fetch_add(1, std::memory_order_relaxed);
+            errno = saved_errno;
+            return;
+        }
+        ids[i] = (uint16_t)id;
+    }
+    record(s, ids, depth, jit);
+    errno = saved_errno;
+}
+
+inline void on_dump_signal(int) {
+    State* s = g_state;
+    if (!s || s->dump_pipe[1] < 0) return;
+    int saved_errno = errno;
+    char byte = 1;
+    ssize_t ignored = ::write(s->dump_pipe[1], &byte, 1);
+    (void)ignored;
+    errno = saved_errno;
+}
+#endif
+
+// ---- Reporting ----
+
+inline std::string json_string(const char* s) {
+    std::string out = "\"";
+    for (; *s; ++s) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') { out += '\\'; out += (char)c; }
+        else if (c < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        } else out += (char)c;
+    }
+    return out + "\"";
+}
+
+inline void write_cache_stats(std::ostream& out, const char* name, const CacheStats& c, bool last) {
+    uint64_t lookups = c.hits + c.misses;
+    char rate[32];
+    std::snprintf(rate, sizeof(rate), "%.4f", lookups ? (double)c.hits / (double)lookups : 0.0);
+    out << "    \"" << name << "\": {\"hits\": " << c.hits << ", \"misses\": " << c.misses
+        << ", \"hit_rate\": " << rate << ", \"sites\": " << c.sites
+        << ", \"monomorphic\": " << c.monomorphic << ", \"polymorphic\": " << c.polymorphic
+        << ", \"megamorphic\": " << c.megamorphic << "}" << (last ? "\n" : ",\n");
+}
+
+// caches is null for on-demand reports, which run off the VM thread
+inline void write_report(State* s, const CacheReport* caches, bool summary) {
+    std::lock_guard<std::mutex> lock(s->report_mutex);
+
+    struct Stack { std::vector<uint16_t> ids; uint64_t samples, jit_samples; };
+    std::vector<Stack> stacks;
+    for (size_t i = 0; i < STACK_SLOTS; ++i) {
+        StackSlot& slot = s->stacks[i];
+        if (slot.hash.load(std::memory_order_acquire) == 0) continue;
+        Stack st;
+        st.ids.assign(s->frames + slot.offset, s->frames + slot.offset + slot.depth);
+        st.samples = slot.samples.load(std::memory_order_relaxed);
+        st.jit_samples = slot.jit_samples.load(std::memory_order_relaxed);
+        stacks.push_back(std::move(st));
+    }
+    std::sort(stacks.begin(), stacks.end(),
+              [](const Stack& a, const Stack& b) { return a.samples > b.samples; });
+
+    // Self time is the innermost frame; inclusive time counts each function
+    // once per sample, however often it recurses
+    struct Func { uint16_t id; uint64_t self = 0, total = 0, jit = 0; };
+    std::vector<Func> funcs;
+    std::vector<int> func_index(NAME_SLOTS, -1);
+    std::vector<uint64_t> seen(NAME_SLOTS, 0);
+    uint64_t recorded = 0;
+    for (size_t si = 0; si < stacks.size(); ++si) {
+        const Stack& st = stacks[si];
+        recorded += st.samples;
+        for (size_t k = 0; k < st.ids.size(); ++k) {
+            uint16_t id = st.ids[k];
+            if (func_index[id] < 0) {
+                func_index[id] = (int)funcs.size();
+                funcs.push_back(Func{id});
+            }
+            Func& f = funcs[func_index[id]];
+            if (seen[id] != si + 1) {
+                seen[id] = si + 1;
+                f.total += st.samples;
+            }
+            if (k + 1 == st.ids.size()) {
+                f.self += st.samples;
+                f.jit += st.jit_samples;
+            }
+        }
+    }
+    std::sort(funcs.begin(), funcs.end(), [](const Func& a, const Func& b) {
+        return a.total != b.total ? a.total > b.total : a.self > b.self;
+    });
+
+    // ITIMER_PROF fires at kernel-tick granularity, not every interval_us,
+    // so a sample is worth the measured CPU time over every sample taken
+    double wall_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - s->started).count();
+    double cpu_ms = process_cpu_ms() - s->cpu_started_ms;
+    uint64_t delivered = s->samples.load() + s->other_threads.load();
+    const double ms_per_sample = delivered && cpu_ms > 0 ? cpu_ms / (double)delivered : s->interval_us / 1000.0;
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "{\n";
+    out << "  \"interval_us\": " << s->interval_us << ",\n";
+    out << "  \"wall_ms\": " << wall_ms << ",\n";
+    out << "  \"cpu_ms\": " << cpu_ms << ",\n";
+    out << "  \"ms_per_sample\": " << ms_per_sample << ",\n";
+    out << "  \"samples\": " << s->samples.load() << ",\n";
+    out << "  \"dropped_samples\": " << s->dropped.load() << ",\n";
+    out << "  \"other_thread_samples\": " << s->other_threads.load() << ",\n";
+    out << "  \"functions\": [";
+    for (size_t i = 0; i < funcs.size(); ++i) {
+        const Func& f = funcs[i];
+        out << (i ? ",\n" : "\n") << "    {\"name\": " << json_string(s->names[f.id].text)
+            << ", \"self_samples\": " << f.self << ", \"total_samples\": " << f.total
+            << ", \"self_ms\": " << f.self * ms_per_sample << ", \"total_ms\": " << f.total * ms_per_sample
+            << ", \"jit_samples\": " << f.jit << "}";
+    }
+    out << (funcs.empty() ? "],\n" : "\n  ],\n");
+    out << "  \"stacks\": [";
+    std::ostringstream folded;
+    for (size_t i = 0; i < stacks.size(); ++i) {
+        std::string line;
+        for (size_t k = 0; k < stacks[i].ids.size(); ++k) {
+            if (k) line += ';';
+            line += s->names[stacks[i].ids[k]].text;
+        }
+        folded << line << ' ' << stacks[i].samples << '\n';
+        out << (i ? ",\n" : "\n") << "    {\"stack\": " << json_string(line.c_str())
+            << ", \"samples\": " << stacks[i].samples << "}";
+    }
+    out << (stacks.empty() ? "],\n" : "\n  ],\n");
+    if (g_count_ops) {
+        std::vector<std::pair<uint64_t, size_t>> ops;
+        for (size_t op = 0; op < sizeof(OPCODE_NAMES) / sizeof(OPCODE_NAMES[0]); ++op) {
+            uint64_t n = g_op_counts[op].load(std::memory_order_relaxed);
+            if (n) ops.push_back({n, op});
+        }
+        std::sort(ops.begin(), ops.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+        out << "  \"opcodes\": {";
+        for (size_t i = 0; i < ops.size(); ++i) {
+            out << (i ? ",\n" : "\n") << "    \"" << OPCODE_NAMES[ops[i].second] << "\": " << ops[i].first;
+        }
+        out << (ops.empty() ? "},\n" : "\n  },\n");
+    }
+    out << "  \"jit\": {\"compiled\": " << g_jit_compiled.load() << ", \"compile_failures\": " << g_jit_failed.load()
+        << ", \"deopts\": " << g_jit_deopts.load() << ", \"disabled_after_deopts\": " << g_jit_disabled.load() << "}";
+    if (caches) {
+        out << ",\n  \"inline_caches\": {\n";
+        write_cache_stats(out, "property", caches->property, false);
+        write_cache_stats(out, "method", caches->method, false);
+        write_cache_stats(out, "module_call", caches->module_call, true);
+        out << "  }";
+    }
+    out << "\n}\n";
+
+    std::string folded_path = s->path;
+    if (folded_path.size() > 5 && folded_path.compare(folded_path.size() - 5, 5, ".json") == 0) {
+        folded_path.resize(folded_path.size() - 5);
+    }
+    folded_path += ".folded";
+    std::ofstream(s->path, std::ios::binary) << out.str();
+    std::ofstream(folded_path, std::ios::binary) << folded.str();
+
+    if (!summary) return;
+    std::fprintf(stderr, "\n=== profile: %llu samples, %.2f ms each (%s, %s) ===\n",
+                 (unsigned long long)recorded, ms_per_sample, s->path.c_str(), folded_path.c_str());
+    std::fprintf(stderr, "   self%%  total%%  function\n");
+    std::vector<Func> by_self = funcs;
+    std::sort(by_self.begin(), by_self.end(), [](const Func& a, const Func& b) { return a.self > b.self; });
+    for (size_t i = 0; i < by_self.size() && i < 10; ++i) {
+        if (!recorded || !by_self[i].self) break;
+        std::fprintf(stderr, "  %5.1f%%  %5.1f%%  %s\n", 100.0 * by_self[i].self / recorded,
+                     100.0 * by_self[i].total / recorded, s->names[by_self[i].id].text);
+    }
+}
+
+// Stop sampling and write the final report (once)
+inline void finish() {
+    State* s = g_state;
+    if (!s || s->finished) return;
+    s->finished = true;
+#ifndef _WIN32
+    itimerval off{};
+    setitimer(ITIMER_PROF, &off, nullptr);
+#endif
+    CacheReport caches;
+    void* vm = s->vm.load();
+    if (vm && s->caches) s->caches(vm, caches);
+    write_report(s, vm ? &caches : nullptr, true);
+    s->vm.store(nullptr);
+}
+
+inline void start(const std::string& path, bool count_ops) {
+    if (g_state) return;  // --profile and --profile-ops together
+    State* s = new State();
+    s->path = path.empty() ? "levython-profile.json" : path;
+    s->started = std::chrono::steady_clock::now();
+    s->cpu_started_ms = process_cpu_ms();
+    g_count_ops = count_ops;
+    g_state = s;
+    std::atexit(finish);
+#ifndef _WIN32
+    s->owner = pthread_self();
+    struct sigaction sa {};
+    sa.sa_handler = on_sample;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGPROF, &sa, nullptr);
+    itimerval timer{};
+    timer.it_interval.tv_usec = s->interval_us;
+    timer.it_value.tv_usec = s->interval_us;
+    setitimer(ITIMER_PROF, &timer, nullptr);
+#else
+    std::fprintf(stderr, "levython: stack sampling is not available on Windows; "
+                         "only counters are reported\n");
+#endif
+}
+
+// The first VM started on the profiling thread is the one sampled
+inline void attach(void* vm, WalkFn walk, CacheFn caches) {
+    State* s = g_state;
+    if (!s || s->finished || s->vm.load()) return;
+#ifndef _WIN32
+    if (!pthread_equal(pthread_self(), s->owner)) return;
+#endif
+    s->walk = walk;
+    s->caches = caches;
+    s->vm.store(vm, std::memory_order_release);
+}
+
+inline bool attached(const void* vm) { return g_state && g_state->vm.load() == vm; }
+
+// os.signal(sig, "profile"): the handler only pokes a pipe; a helper thread
+// writes the report so nothing unsafe runs in signal context
+inline void arm_dump_signal(int sig) {
+#ifndef _WIN32
+    State* s = g_state;
+    if (!s) throw std::runtime_error("os.signal action 'profile' requires running with --profile");
+    if (s->dump_pipe[0] < 0) {
+        if (pipe(s->dump_pipe) != 0) throw std::runtime_error("os.signal: cannot create profile pipe");
+        std::thread([s]() {
+            char byte;
+            for (;;) {
+                ssize_t n = ::read(s->dump_pipe[0], &byte, 1);
+                if (n > 0) write_report(s, nullptr, false);
+                else if (n < 0 && errno == EINTR) continue;
+                else break;
+            }
+        }).detach();
+    }
+    if (signal(sig, on_dump_signal) == SIG_ERR) throw std::runtime_error("os.signal failed for signal");
+#else
+    (void)sig;
+    throw std::runtime_error("os.signal action 'profile' is not supported on Windows");
+#endif
+}
+
+}  // namespace profiler
+
 // Forward declarations
 class ASTNode;
 class Environment;
@@ -1926,9 +3139,10 @@ public:
     std::vector<std::string> params;
     std::string class_name;
     bool is_abstract = false;
+    bool is_async = false;  // `async act` declaration
 
     ASTNode(NodeType t, Token tok) : type(t), token(std::move(tok)) {}
-    ASTNode(const ASTNode& other) : type(other.type), token(other.token), value(other.value), params(other.params), class_name(other.class_name), is_abstract(other.is_abstract) {
+    ASTNode(const ASTNode& other) : type(other.type), token(other.token), value(other.value), params(other.params), class_name(other.class_name), is_abstract(other.is_abstract), is_async(other.is_async) {
         children.reserve(other.children.size());
         for (const auto& child : other.children) {
             children.push_back(child ? std::make_unique<ASTNode>(*child) : nullptr);
@@ -1943,6 +3157,7 @@ public:
             params = other.params;
             class_name = other.class_name;
             is_abstract = other.is_abstract;
+            is_async = other.is_async;
             children.clear();
             children.reserve(other.children.size());
             for (const auto& child : other.children) {
@@ -2191,48 +3406,329 @@ public:
 // ============================================================================
 // BYTECODE CHUNK - Storage for compiled bytecode
 // ============================================================================
+// Native code produced by BaselineJIT for one chunk. Returns the function's
+// result, or JIT_DEOPT once the innermost frame has been handed back to the
+// interpreter (its CallFrame ip and the VM stack pointer are already stored).
+class FastVM;
+using JitEntry = uint64_t (*)(FastVM* vm, uint64_t* slots, uint64_t* sp);
+constexpr uint64_t JIT_DEOPT = VAL_UNDEFINED;
+constexpr uint64_t JIT_UNHANDLED = QNAN_BITS | TAG_NONE | 2;  // Helper declined: interpret this op
+
 struct Chunk {
     std::vector<uint8_t> code;
     std::vector<Value> constants;
-    
+    std::vector<uint64_t> fast_constants;  // NaN-boxed mirror of constants (built once)
+    std::vector<std::pair<ObjString*, uint16_t>> module_exports;  // Module chunks: name -> global slot
+    std::vector<uint64_t> embedded_objects;  // Objects referenced from raw code bytes (GC roots)
+    std::vector<uint32_t> embedded_offsets;  // Code offset of each embedded_objects pointer
+    std::vector<uint32_t> global_refs;       // Code offsets of 16-bit global slot operands
+    uint64_t gc_epoch = 0;  // Collection that last traced this chunk
+
+    // Baseline JIT state
+    JitEntry jit_entry = nullptr;
+    uint32_t jit_calls = 0;     // Interpreted calls so far
+    uint32_t jit_deopts = 0;    // Bailouts from jit_entry
+    bool jit_disabled = false;  // Not compilable, or deopted too often
+    bool is_async = false;      // `async act`: calls create a coroutine
+
     size_t add_constant(Value value) {
         constants.push_back(std::move(value));
         return constants.size() - 1;
     }
-    
+
     void write(uint8_t byte) { code.push_back(byte); }
     void write_op(OpCode op) { write(static_cast<uint8_t>(op)); }
+
+    // Convert every constant to its NaN-boxed form so OP_CONST is a plain load.
+    // Constants are immutable, so strings/functions are shared by all loads.
+    void materialize_constants();
 };
 
-// Environment Methods
-void Environment::define(const std::string& name, Value value) {
-    variables[name] = std::move(value);
+// Convert a compile-time constant to a fast value (runs once per constant)
+static uint64_t materialize_constant(const Value& v) {
+    switch (v.type) {
+        case ObjectType::INTEGER: return val_int(v.data.integer);
+        case ObjectType::FLOAT: return val_number(v.data.floating);
+        case ObjectType::BOOLEAN: return v.data.boolean ? VAL_TRUE : VAL_FALSE;
+        case ObjectType::NONE: return VAL_NONE;
+        case ObjectType::STRING: return val_string(g_strings.intern(v.data.string));
+        case ObjectType::FUNCTION: {
+            if (v.data.compiled_func.chunk) {
+                return val_func(make_func(v.data.compiled_func.chunk.get(),
+                                          v.data.compiled_func.name.c_str(),
+                                          v.data.compiled_func.arity));
+            }
+            if (v.data.function.is_builtin) {
+                return val_string("<builtin " + v.data.function.builtin_name + ">");
+            }
+            return VAL_NONE;
+        }
+        case ObjectType::LIST: {
+            ObjList* l = ObjList::create();
+            for (const auto& item : v.data.list) l->push(materialize_constant(item));
+            return val_list(l);
+        }
+        case ObjectType::MAP: {
+            ObjMap* m = ObjMap::create();
+            for (const auto& pair : v.data.map) {
+                m->data[g_strings.intern(pair.first)] = materialize_constant(pair.second);
+            }
+            return val_map(m);
+        }
+        case ObjectType::RANGE:
+            return val_obj((Obj*)ObjRange::create(v.data.range.start, v.data.range.stop, v.data.range.step));
+        default: return VAL_NONE;
+    }
 }
 
-Value Environment::get(const std::string& name) {
-    auto it = variables.find(name);
-    if (it != variables.end()) return it->second;
-    if (parent) return parent->get(name);
-    throw std::runtime_error("Undefined variable: " + name);
+void Chunk::materialize_constants() {
+    // Only convert constants added since the last call
+    fast_constants.reserve(constants.size());
+    for (size_t i = fast_constants.size(); i < constants.size(); ++i) {
+        fast_constants.push_back(materialize_constant(constants[i]));
+    }
 }
 
-void Environment::assign(const std::string& name, Value value) {
-    auto it = variables.find(name);
-    if (it != variables.end()) {
-        it->second = std::move(value);
-        return;
-    }
-    if (parent) {
-        try {
-            parent->get(name);
-            parent->assign(name, std::move(value));
-            return;
-        } catch (const std::runtime_error&) {}
-    }
-    define(name, std::move(value));
+// ============================================================================
+// GARBAGE COLLECTOR: mark-sweep over GCHeap
+// ============================================================================
+inline void gc_mark_object(Obj* o) {
+    if (!o || !g_heap.owns(o) || o->marked) return;
+    o->marked = true;
+    g_heap.gray.push_back(o);
 }
 
-// Lexer
+inline void gc_mark_value(uint64_t v) {
+    if (is_obj(v)) gc_mark_object(as_obj(v));
+}
+
+// Chunks are not heap objects, but their constants keep strings/functions alive
+void gc_mark_chunk(Chunk* c) {
+    // Isolates: constants are permanent (shared main chunks, or compiled
+    // under PermanentAllocScope) and the epoch belongs to the main heap
+    if (g_heap.isolate) return;
+    if (!c || c->gc_epoch == g_heap.collections + 1) return;
+    c->gc_epoch = g_heap.collections + 1;
+    for (uint64_t v : c->fast_constants) gc_mark_value(v);
+    for (uint64_t v : c->embedded_objects) gc_mark_value(v);
+    for (const auto& e : c->module_exports) gc_mark_object(e.first);
+}
+
+static void gc_trace(Obj* o) {
+    switch (o->type) {
+        case ObjType::STRING:
+        case ObjType::RANGE:
+            break;
+        case ObjType::FUNCTION: {
+            ObjFunc* f = (ObjFunc*)o;
+            gc_mark_object(f->name);
+            gc_mark_chunk(f->chunk);
+            break;
+        }
+        case ObjType::LIST: {
+            ObjList* l = (ObjList*)o;
+            for (size_t i = 0; i < l->count; ++i) gc_mark_value(l->items[i]);
+            break;
+        }
+        case ObjType::MAP:
+            for (const auto& kv : ((ObjMap*)o)->data) {
+                gc_mark_object(kv.first);
+                gc_mark_value(kv.second);
+            }
+            break;
+        case ObjType::CLASS: {
+            ObjClass* c = (ObjClass*)o;
+            gc_mark_object(c->name);
+            gc_mark_object(c->parent);
+            for (const auto& m : c->methods) gc_mark_value(m.second);
+            break;
+        }
+        case ObjType::INSTANCE: {
+            ObjInstance* inst = (ObjInstance*)o;
+            gc_mark_object(inst->klass);
+            for (uint64_t v : inst->slots) gc_mark_value(v);
+            for (const auto& f : inst->overflow) {
+                gc_mark_object(f.first);
+                gc_mark_value(f.second);
+            }
+            break;
+        }
+        case ObjType::NATIVE:
+            gc_mark_object(((ObjNative*)o)->name);
+            break;
+        case ObjType::COROUTINE: {
+            ObjCoroutine* c = (ObjCoroutine*)o;
+            gc_mark_object(c->name);
+            gc_mark_value(c->result);
+            for (uint64_t v : c->stack) gc_mark_value(v);
+            for (const auto& f : c->frames) gc_mark_chunk(f.chunk);
+            for (const auto& it : c->iters) gc_mark_value(it.obj);
+            for (ObjCoroutine* w : c->waiters) gc_mark_object(w);
+            break;
+        }
+        case ObjType::TENSOR:
+            gc_mark_object(((ObjTensor*)o)->base);
+            break;
+        case ObjType::BYTES:
+            gc_mark_object(((ObjBytes*)o)->base);
+            break;
+        case ObjType::READER:
+            break;
+    }
+}
+
+// Approximate footprint, used for the allocation trigger and gc.stats()
+static size_t gc_object_size(Obj* o) {
+    switch (o->type) {
+        case ObjType::STRING: return sizeof(ObjString) + ((ObjString*)o)->capacity + 1;
+        case ObjType::LIST: {
+            ObjList* l = (ObjList*)o;
+            return sizeof(ObjList) + (l->is_inline() ? 0 : l->capacity * sizeof(uint64_t));
+        }
+        case ObjType::MAP: return sizeof(ObjMap) + ((ObjMap*)o)->data.memory_bytes();
+        case ObjType::INSTANCE: {
+            ObjInstance* inst = (ObjInstance*)o;
+            return sizeof(ObjInstance) + inst->slots.capacity() * sizeof(uint64_t) +
+                   inst->overflow.size() * 48;
+        }
+        case ObjType::CLASS: return sizeof(ObjClass) + ((ObjClass*)o)->methods.size() * 48;
+        case ObjType::FUNCTION: return sizeof(ObjFunc);
+        case ObjType::RANGE: return sizeof(ObjRange);
+        case ObjType::NATIVE: return sizeof(ObjNative);
+        case ObjType::COROUTINE: {
+            ObjCoroutine* c = (ObjCoroutine*)o;
+            return sizeof(ObjCoroutine) + c->stack.capacity() * sizeof(uint64_t) +
+                   c->frames.capacity() * sizeof(ObjCoroutine::Frame);
+        }
+        case ObjType::TENSOR: {
+            ObjTensor* t = (ObjTensor*)o;
+            return sizeof(ObjTensor) + (t->base ? 0 : t->count * t->elem_size());
+        }
+        case ObjType::BYTES: {
+            ObjBytes* b = (ObjBytes*)o;
+            return sizeof(ObjBytes) + (b->base ? 0 : b->length);
+        }
+        case ObjType::READER: return sizeof(ObjReader) + ((ObjReader*)o)->buf.capacity();
+    }
+    return sizeof(Obj);
+}
+
+static void gc_free_object(Obj* o) {
+    switch (o->type) {
+        case ObjType::STRING:
+            g_pool.release(o, sizeof(ObjString) + ((ObjString*)o)->capacity + 1);
+            break;
+        case ObjType::FUNCTION: g_pool.release(o, sizeof(ObjFunc)); break;
+        case ObjType::RANGE: g_pool.release(o, sizeof(ObjRange)); break;
+        case ObjType::LIST: {
+            ObjList* l = (ObjList*)o;
+            if (!l->is_inline()) free(l->items);
+            g_pool.release(l, sizeof(ObjList));
+            break;
+        }
+        case ObjType::MAP: pool_delete((ObjMap*)o); break;
+        case ObjType::CLASS: pool_delete((ObjClass*)o); break;
+        case ObjType::INSTANCE: pool_delete((ObjInstance*)o); break;
+        case ObjType::NATIVE: pool_delete((ObjNative*)o); break;
+        case ObjType::COROUTINE: pool_delete((ObjCoroutine*)o); break;
+        case ObjType::TENSOR: {
+            ObjTensor* t = (ObjTensor*)o;
+            if (!t->base) tensor_buffer_free(t->data);
+            pool_delete(t);
+            break;
+        }
+        case ObjType::BYTES: {
+            ObjBytes* b = (ObjBytes*)o;
+            if (!b->base) free(b->data);
+            pool_delete(b);
+            break;
+        }
+        case ObjType::READER: {
+            ObjReader* r = (ObjReader*)o;
+            r->close();
+            pool_delete(r);
+            break;
+        }
+    }
+}
+
+// Full collection. Only call at a VM safepoint: anything not reachable from
+// the registered roots (or the permanent list) is freed. Returns objects freed.
+size_t gc_collect() {
+    if (!g_heap.mark_roots) return 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (Obj* o = g_heap.permanent; o; o = o->next) gc_mark_object(o);
+    // Shapes are never freed, so the field names they key on must stay interned
+    for (Shape* shape : Shape::all()) gc_mark_object(shape->keys.back());
+    g_heap.mark_roots(g_heap.roots_owner);
+    while (!g_heap.gray.empty()) {
+        Obj* o = g_heap.gray.back();
+        g_heap.gray.pop_back();
+        gc_trace(o);
+    }
+
+    g_strings.remove_unmarked();
+
+    size_t freed = 0, freed_bytes = 0, live = 0;
+    Obj** link = &g_heap.objects;
+    while (Obj* o = *link) {
+        size_t bytes = gc_object_size(o);
+        if (o->marked) {
+            o->marked = false;
+            live += bytes;
+            link = &o->next;
+        } else {
+            *link = o->next;
+            gc_free_object(o);
+            freed++;
+            freed_bytes += bytes;
+        }
+    }
+    for (Obj* o = g_heap.permanent; o; o = o->next) o->marked = false;
+
+    g_heap.object_count -= freed;
+    g_heap.freed_objects += freed;
+    g_heap.freed_bytes += freed_bytes;
+    g_heap.live_bytes = live;
+    g_heap.allocated = 0;
+    // Next cycle once the heap has roughly doubled
+    g_heap.threshold = std::max(GCHeap::MIN_THRESHOLD, live);
+    g_heap.collections++;
+    g_heap.pause_ms += std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    return freed;
+}
+
+// Environment Methods
+void Environment::define(const std::string& name, Value value) {
+    variables[name] = std::move(value);
+}
+
+Value Environment::get(const std::string& name) {
+    auto it = variables.find(name);
+    if (it != variables.end()) return it->second;
+    if (parent) return parent->get(name);
+    throw std::runtime_error("Undefined variable: " + name);
+}
+
+void Environment::assign(const std::string& name, Value value) {
+    auto it = variables.find(name);
+    if (it != variables.end()) {
+        it->second = std::move(value);
+        return;
+    }
+    if (parent) {
+        try {
+            parent->get(name);
+            parent->assign(name, std::move(value));
+            return;
+        } catch (const std::runtime_error&) {}
+    }
+    define(name, std::move(value));
+}
+
+// Lexer
 class Lexer {
     std::string source;
     size_t pos;
@@ -2437,6 +3933,7 @@ private:
 class Parser {
     std::vector<Token> tokens;
     size_t pos;
+    bool had_error = false;  // A statement was reported and skipped
 
     Token current() const { return pos < tokens.size() ? tokens[pos] : Token(TokType::EOF_TOKEN, "", tokens.empty() ? 0 : tokens.back().line); }
     Token previous() const { return pos > 0 ? tokens[pos - 1] : Token(TokType::UNKNOWN, "", 0); }
@@ -2477,6 +3974,7 @@ class Parser {
         if (match({TokType::REPEAT})) return parse_repeat_statement();
         if (match({TokType::RETURN_TOKEN})) return parse_return_statement();
         if (match({TokType::ACT})) return parse_function_definition("act");
+        if (check_async_act()) return parse_async_function();
         if (match({TokType::ABSTRACT})) {
             Token abs_kw = previous();
             consume(TokType::CLASS, "Expect 'class' after 'abstract'.");
@@ -2510,6 +4008,19 @@ class Parser {
         return parse_expression_statement();
     }
 
+    // `async` is only a keyword in front of `act`; elsewhere it names the module
+    bool check_async_act() const {
+        return check(TokType::IDENTIFIER) && current().lexeme == "async" && peek().type == TokType::ACT;
+    }
+
+    std::unique_ptr<ASTNode> parse_async_function() {
+        advance();  // async
+        advance();  // act
+        auto fn = parse_function_definition("act");
+        fn->is_async = true;
+        return fn;
+    }
+
     std::unique_ptr<ASTNode> parse_block() {
         auto block_node = std::make_unique<ASTNode>(NodeType::BLOCK, previous());
         while (!check(TokType::RBRACE) && !is_at_end()) {
@@ -2521,6 +4032,7 @@ class Parser {
 
     std::unique_ptr<ASTNode> parse_declaration_or_statement() {
         if (match({TokType::ACT})) return parse_function_definition("act");
+        if (check_async_act()) return parse_async_function();
         if (match({TokType::ABSTRACT})) {
             Token abs_kw = previous();
             consume(TokType::CLASS, "Expect 'class' after 'abstract'.");
@@ -3031,6 +4543,7 @@ class Parser {
 
 public:
     explicit Parser(std::vector<Token> t) : tokens(std::move(t)), pos(0) {}
+    bool had_errors() const { return had_error; }
     std::unique_ptr<ASTNode> parse() {
         auto program = std::make_unique<ASTNode>(NodeType::PROGRAM, Token(TokType::UNKNOWN, "program", 0));
         while (!is_at_end()) {
@@ -3038,6 +4551,7 @@ public:
                 program->addChild(parse_declaration_or_statement());
             } catch (const std::runtime_error& e) {
                 std::cerr << e.what() << std::endl;
+                had_error = true;
                 while (!is_at_end()) {
                     if (previous().type == TokType::SEMICOLON) break;
                     switch (current().type) {
@@ -3089,6 +4603,14 @@ Value builtin_http_head(const std::vector<Value> &args);
 Value builtin_http_request(const std::vector<Value> &args);
 Value builtin_http_set_timeout(const std::vector<Value> &args);
 Value builtin_http_set_verify_ssl(const std::vector<Value> &args);
+Value builtin_http_set_pool(const std::vector<Value> &args);
+Value builtin_http_pool_stats(const std::vector<Value> &args);
+Value builtin_http_close_idle(const std::vector<Value> &args);
+Value builtin_http_stream(const std::vector<Value> &args);
+Value builtin_http_read_chunk(const std::vector<Value> &args);
+Value builtin_http_close_stream(const std::vector<Value> &args);
+Value builtin_http_download(const std::vector<Value> &args);
+Value builtin_http_request_many(const std::vector<Value> &args);
 Value create_http_module();
 } // namespace http_bindings
 
@@ -3488,6 +5010,14 @@ Value builtin_log_info(const std::vector<Value>& args);
 Value builtin_log_warn(const std::vector<Value>& args);
 Value builtin_log_error(const std::vector<Value>& args);
 Value builtin_log_flush(const std::vector<Value>& args);
+Value builtin_log_set_async(const std::vector<Value>& args);
+Value builtin_log_set_sample(const std::vector<Value>& args);
+Value builtin_log_stats(const std::vector<Value>& args);
+uint64_t native_log_log(VMContext& ctx, const uint64_t* args, uint8_t argc);
+uint64_t native_log_debug(VMContext& ctx, const uint64_t* args, uint8_t argc);
+uint64_t native_log_info(VMContext& ctx, const uint64_t* args, uint8_t argc);
+uint64_t native_log_warn(VMContext& ctx, const uint64_t* args, uint8_t argc);
+uint64_t native_log_error(VMContext& ctx, const uint64_t* args, uint8_t argc);
 Value create_log_module();
 }
 
@@ -3513,18 +5043,57 @@ Value builtin_input_chr(const std::vector<Value>& args);
 Value create_input_module();
 }
 
+namespace thread_isolates {
+// Held around a wait that parks the calling thread outside the isolate pool
+// (channel send/recv, sleeps, a server's readiness loop). On a pool worker
+// it lets the pool start a spare worker so jobs queued behind keep running.
+struct BlockingWait {
+    BlockingWait();
+    ~BlockingWait();
+    BlockingWait(const BlockingWait&) = delete;
+    BlockingWait& operator=(const BlockingWait&) = delete;
+private:
+    bool counted = false;
+};
+}
+
 namespace thread_bindings {
 Value builtin_thread_spawn(const std::vector<Value>& args);
 Value builtin_thread_join(const std::vector<Value>& args);
 Value builtin_thread_is_done(const std::vector<Value>& args);
 Value builtin_thread_sleep(const std::vector<Value>& args);
 Value create_thread_module();
+uint64_t native_thread_spawn(VMContext& ctx, const uint64_t* args, uint8_t argc);
+uint64_t native_thread_join(VMContext& ctx, const uint64_t* args, uint8_t argc);
+uint64_t native_thread_is_done(VMContext& ctx, const uint64_t* args, uint8_t argc);
+uint64_t native_thread_pool_size(VMContext& ctx, const uint64_t* args, uint8_t argc);
+uint64_t native_thread_atomic(VMContext& ctx, const uint64_t* args, uint8_t argc);
+uint64_t native_thread_atomic_free(VMContext& ctx, const uint64_t* args, uint8_t argc);
+std::atomic<int64_t>* find_atomic_cell(int64_t id);
+}
+
+namespace http_bindings {
+uint64_t native_http_get(VMContext& ctx, const uint64_t* args, uint8_t argc);
+uint64_t native_http_post(VMContext& ctx, const uint64_t* args, uint8_t argc);
+uint64_t native_http_put(VMContext& ctx, const uint64_t* args, uint8_t argc);
+uint64_t native_http_patch(VMContext& ctx, const uint64_t* args, uint8_t argc);
+uint64_t native_http_delete(VMContext& ctx, const uint64_t* args, uint8_t argc);
+uint64_t native_http_head(VMContext& ctx, const uint64_t* args, uint8_t argc);
+uint64_t native_http_request(VMContext& ctx, const uint64_t* args, uint8_t argc);
+uint64_t native_http_request_many(VMContext& ctx, const uint64_t* args, uint8_t argc);
+}
+
+namespace http_server {
+uint64_t native_http_serve(VMContext& ctx, const uint64_t* args, uint8_t argc);
+uint64_t native_http_shutdown(VMContext& ctx, const uint64_t* args, uint8_t argc);
 }
 
 namespace channel_bindings {
 Value builtin_channel_create(const std::vector<Value>& args);
 Value builtin_channel_send(const std::vector<Value>& args);
+Value builtin_channel_send_many(const std::vector<Value>& args);
 Value builtin_channel_recv(const std::vector<Value>& args);
+Value builtin_channel_recv_many(const std::vector<Value>& args);
 Value builtin_channel_try_recv(const std::vector<Value>& args);
 Value builtin_channel_close(const std::vector<Value>& args);
 Value create_channel_module();
@@ -3535,6 +5104,7 @@ Value builtin_async_spawn(const std::vector<Value>& args);
 Value builtin_async_sleep(const std::vector<Value>& args);
 Value builtin_async_tcp_recv(const std::vector<Value>& args);
 Value builtin_async_tcp_send(const std::vector<Value>& args);
+Value builtin_async_http(const std::vector<Value>& args);
 Value builtin_async_tick(const std::vector<Value>& args);
 Value builtin_async_done(const std::vector<Value>& args);
 Value builtin_async_status(const std::vector<Value>& args);
@@ -3543,6 +5113,10 @@ Value builtin_async_cancel(const std::vector<Value>& args);
 Value builtin_async_pending(const std::vector<Value>& args);
 Value builtin_async_await(const std::vector<Value>& args);
 Value create_async_module();
+void close_socket_tasks(int fd);
+uint64_t native_async_status(VMContext& ctx, const uint64_t* args, uint8_t argc);
+uint64_t native_async_result(VMContext& ctx, const uint64_t* args, uint8_t argc);
+uint64_t native_async_await(VMContext& ctx, const uint64_t* args, uint8_t argc);
 }
 
 // Interpreter
@@ -5815,6 +7389,14 @@ Value Interpreter::call_method(Value& instance,
         if (name == "http_set_timeout") return http_bindings::builtin_http_set_timeout(args);
         if (name == "http_set_verify_ssl")
             return http_bindings::builtin_http_set_verify_ssl(args);
+        if (name == "http_set_pool") return http_bindings::builtin_http_set_pool(args);
+        if (name == "http_pool_stats") return http_bindings::builtin_http_pool_stats(args);
+        if (name == "http_close_idle") return http_bindings::builtin_http_close_idle(args);
+        if (name == "http_stream") return http_bindings::builtin_http_stream(args);
+        if (name == "http_read_chunk") return http_bindings::builtin_http_read_chunk(args);
+        if (name == "http_close_stream") return http_bindings::builtin_http_close_stream(args);
+        if (name == "http_download") return http_bindings::builtin_http_download(args);
+        if (name == "http_request_many") return http_bindings::builtin_http_request_many(args);
         if (name == "os_name") return os_bindings::builtin_os_name(args);
         if (name == "os_sep") return os_bindings::builtin_os_sep(args);
         if (name == "os_cwd") return os_bindings::builtin_os_cwd(args);
@@ -5946,6 +7528,7 @@ Value Interpreter::call_method(Value& instance,
         if (name == "os_readlink_info") return os_bindings::builtin_os_readlink_info(args);
         if (name == "os_realpath_ex") return os_bindings::builtin_os_realpath_ex(args);
         
+#ifndef LEVYTHON_NO_HOOKS
         // OS.Hook submodule builtins
         if (name == "os_hooks_register") return os_bindings::builtin_os_hooks_register(args);
         if (name == "os_hooks_unregister") return os_bindings::builtin_os_hooks_unregister(args);
@@ -5962,6 +7545,7 @@ Value Interpreter::call_method(Value& instance,
         if (name == "os_hooks_hook_syscall") return os_bindings::builtin_os_hooks_hook_syscall(args);
         if (name == "os_hooks_inject_library") return os_bindings::builtin_os_hooks_inject_library(args);
         if (name == "os_hooks_hook_memory_access") return os_bindings::builtin_os_hooks_hook_memory_access(args);
+#endif
         
         // OS.InputControl submodule builtins
         if (name == "os_inputcontrol_capture_keyboard") return os_bindings::builtin_os_inputcontrol_capture_keyboard(args);
@@ -6007,6 +7591,7 @@ Value Interpreter::call_method(Value& instance,
         if (name == "os_processes_get_priority") return os_bindings::builtin_os_processes_get_priority(args);
         if (name == "os_processes_set_priority") return os_bindings::builtin_os_processes_set_priority(args);
         
+#ifndef LEVYTHON_NO_DISPLAY
         // OS.DisplayAccess submodule builtins
         if (name == "os_display_list") return os_bindings::builtin_os_display_list(args);
         if (name == "os_display_get_primary") return os_bindings::builtin_os_display_get_primary(args);
@@ -6028,7 +7613,9 @@ Value Interpreter::call_method(Value& instance,
         if (name == "os_display_write_buffer") return os_bindings::builtin_os_display_write_buffer(args);
         if (name == "os_display_show_cursor") return os_bindings::builtin_os_display_show_cursor(args);
         if (name == "os_display_hide_cursor") return os_bindings::builtin_os_display_hide_cursor(args);
+#endif
         
+#ifndef LEVYTHON_NO_AUDIO
         // OS.AudioControl submodule builtins
         if (name == "os_audio_list_devices") return os_bindings::builtin_os_audio_list_devices(args);
         if (name == "os_audio_get_default_device") return os_bindings::builtin_os_audio_get_default_device(args);
@@ -6050,6 +7637,7 @@ Value Interpreter::call_method(Value& instance,
         if (name == "os_audio_stop_recording") return os_bindings::builtin_os_audio_stop_recording(args);
         if (name == "os_audio_mix_streams") return os_bindings::builtin_os_audio_mix_streams(args);
         if (name == "os_audio_apply_effect") return os_bindings::builtin_os_audio_apply_effect(args);
+#endif
         
         // OS.PrivilegeEscalator builtins
         if (name == "os_privileges_is_elevated") return os_bindings::builtin_os_privileges_is_elevated(args);
@@ -6153,6 +7741,9 @@ Value Interpreter::call_method(Value& instance,
         if (name == "log_warn") return log_bindings::builtin_log_warn(args);
         if (name == "log_error") return log_bindings::builtin_log_error(args);
         if (name == "log_flush") return log_bindings::builtin_log_flush(args);
+        if (name == "log_set_async") return log_bindings::builtin_log_set_async(args);
+        if (name == "log_set_sample") return log_bindings::builtin_log_set_sample(args);
+        if (name == "log_stats") return log_bindings::builtin_log_stats(args);
         if (name == "config_load_env") return config_bindings::builtin_config_load_env(args);
         if (name == "config_get") return config_bindings::builtin_config_get(args);
         if (name == "config_set") return config_bindings::builtin_config_set(args);
@@ -6193,13 +7784,16 @@ Value Interpreter::call_method(Value& instance,
         if (name == "thread_sleep") return thread_bindings::builtin_thread_sleep(args);
         if (name == "channel_create") return channel_bindings::builtin_channel_create(args);
         if (name == "channel_send") return channel_bindings::builtin_channel_send(args);
+        if (name == "channel_send_many") return channel_bindings::builtin_channel_send_many(args);
         if (name == "channel_recv") return channel_bindings::builtin_channel_recv(args);
+        if (name == "channel_recv_many") return channel_bindings::builtin_channel_recv_many(args);
         if (name == "channel_try_recv") return channel_bindings::builtin_channel_try_recv(args);
         if (name == "channel_close") return channel_bindings::builtin_channel_close(args);
         if (name == "async_spawn") return async_bindings::builtin_async_spawn(args);
         if (name == "async_sleep") return async_bindings::builtin_async_sleep(args);
         if (name == "async_tcp_recv") return async_bindings::builtin_async_tcp_recv(args);
         if (name == "async_tcp_send") return async_bindings::builtin_async_tcp_send(args);
+        if (name == "async_http") return async_bindings::builtin_async_http(args);
         if (name == "async_tick") return async_bindings::builtin_async_tick(args);
         if (name == "async_done") return async_bindings::builtin_async_done(args);
         if (name == "async_status") return async_bindings::builtin_async_status(args);
@@ -6277,6 +7871,11 @@ namespace http_bindings {
 class HttpModuleState {
 private:
   levython::http::HttpClient client_instance;
+  // Open response streams by handle; shared_ptr so a reader can drop the
+  // table lock while it blocks on the socket
+  std::mutex streams_mutex;
+  std::map<long, std::shared_ptr<levython::http::HttpStream>> streams;
+  long next_stream_id = 1;
   HttpModuleState() {}
 
 public:
@@ -6286,6 +7885,32 @@ public:
   }
 
   levython::http::HttpClient &client() { return client_instance; }
+
+  long add_stream(std::unique_ptr<levython::http::HttpStream> stream) {
+    std::lock_guard<std::mutex> lock(streams_mutex);
+    long id = next_stream_id++;
+    streams[id] = std::move(stream);
+    return id;
+  }
+
+  std::shared_ptr<levython::http::HttpStream> find_stream(long id) {
+    std::lock_guard<std::mutex> lock(streams_mutex);
+    auto it = streams.find(id);
+    return it != streams.end() ? it->second : nullptr;
+  }
+
+  void remove_stream(long id) {
+    std::shared_ptr<levython::http::HttpStream> stream;
+    {
+      std::lock_guard<std::mutex> lock(streams_mutex);
+      auto it = streams.find(id);
+      if (it == streams.end())
+        return;
+      stream = std::move(it->second);
+      streams.erase(it);
+    }
+    stream->close();
+  }
 };
 
 std::string value_to_string(const Value &v) {
@@ -6349,7 +7974,8 @@ levython::http::HttpMethod parse_http_method(const std::string &method) {
   throw std::runtime_error("Invalid HTTP method: " + method);
 }
 
-Value response_to_value(const levython::http::HttpResponse &resp) {
+// FastVM callers pass list_body = false and attach the body as bytes instead
+Value response_to_value(const levython::http::HttpResponse &resp, bool list_body = true) {
   Value response(ObjectType::MAP);
 
   response.data.map["status"] = Value(static_cast<long>(resp.status));
@@ -6363,12 +7989,14 @@ Value response_to_value(const levython::http::HttpResponse &resp) {
   }
   response.data.map["headers"] = headers_map;
 
-  Value body_list(ObjectType::LIST);
-  body_list.data.list.reserve(resp.body.size());
-  for (uint8_t byte : resp.body) {
-    body_list.data.list.push_back(Value(static_cast<long>(byte)));
+  if (list_body) {
+    Value body_list(ObjectType::LIST);
+    body_list.data.list.reserve(resp.body.size());
+    for (uint8_t byte : resp.body) {
+      body_list.data.list.push_back(Value(static_cast<long>(byte)));
+    }
+    response.data.map["body"] = body_list;
   }
-  response.data.map["body"] = body_list;
   response.data.map["text"] = Value(resp.text());
   response.data.map["json_text"] = Value(resp.json_text());
 
@@ -6386,7 +8014,48 @@ Value response_to_value(const levython::http::HttpResponse &resp) {
   return response;
 }
 
-Value builtin_http_get(const std::vector<Value> &args) {
+// A request given as a url (GET) or a map with url plus optional method,
+// body, headers, timeout_ms and verify_ssl
+levython::http::HttpRequest value_to_request(const Value &v, const char *fn) {
+  levython::http::HttpRequest req;
+  req.method = levython::http::HttpMethod::GET;
+  req.timeout_ms = 0; // use client default timeout unless explicitly provided
+  if (v.type == ObjectType::STRING) {
+    req.url = v.data.string;
+    return req;
+  }
+  if (v.type != ObjectType::MAP) {
+    throw std::runtime_error(std::string(fn) + " expects a url or a request map");
+  }
+  auto field = [&](const char *key) -> const Value * {
+    auto it = v.data.map.find(key);
+    return it != v.data.map.end() && it->second.type != ObjectType::NONE ? &it->second
+                                                                          : nullptr;
+  };
+  const Value *url = field("url");
+  if (!url) {
+    throw std::runtime_error(std::string(fn) + " request map needs a url");
+  }
+  req.url = value_to_string(*url);
+  if (const Value *method = field("method"))
+    req.method = parse_http_method(value_to_string(*method));
+  if (const Value *body = field("body"))
+    req.set_body(value_to_string(*body));
+  if (const Value *headers = field("headers"))
+    req.headers = value_to_headers(*headers);
+  if (const Value *timeout = field("timeout_ms"))
+    req.timeout_ms = value_to_int(*timeout);
+  if (const Value *verify = field("verify_ssl"))
+    req.verify_ssl = value_to_bool(*verify);
+  return req;
+}
+
+// Safe to call from any thread: the client's pool is shared and locked
+levython::http::HttpResponse perform_request(const levython::http::HttpRequest &req) {
+  return HttpModuleState::get_instance().client().request(req);
+}
+
+levython::http::HttpResponse http_get_response(const std::vector<Value> &args) {
   if (args.empty()) {
     throw std::runtime_error("http.get() requires at least 1 argument (url)");
   }
@@ -6397,11 +8066,14 @@ Value builtin_http_get(const std::vector<Value> &args) {
     headers = value_to_headers(args[1]);
   }
 
-  auto resp = HttpModuleState::get_instance().client().get(url, headers);
-  return response_to_value(resp);
+  return HttpModuleState::get_instance().client().get(url, headers);
 }
 
-Value builtin_http_post(const std::vector<Value> &args) {
+Value builtin_http_get(const std::vector<Value> &args) {
+  return response_to_value(http_get_response(args));
+}
+
+levython::http::HttpResponse http_post_response(const std::vector<Value> &args) {
   if (args.size() < 2) {
     throw std::runtime_error("http.post() requires at least 2 arguments (url, body)");
   }
@@ -6413,11 +8085,14 @@ Value builtin_http_post(const std::vector<Value> &args) {
     headers = value_to_headers(args[2]);
   }
 
-  auto resp = HttpModuleState::get_instance().client().post(url, body, headers);
-  return response_to_value(resp);
+  return HttpModuleState::get_instance().client().post(url, body, headers);
 }
 
-Value builtin_http_put(const std::vector<Value> &args) {
+Value builtin_http_post(const std::vector<Value> &args) {
+  return response_to_value(http_post_response(args));
+}
+
+levython::http::HttpResponse http_put_response(const std::vector<Value> &args) {
   if (args.size() < 2) {
     throw std::runtime_error("http.put() requires at least 2 arguments (url, body)");
   }
@@ -6429,11 +8104,14 @@ Value builtin_http_put(const std::vector<Value> &args) {
     headers = value_to_headers(args[2]);
   }
 
-  auto resp = HttpModuleState::get_instance().client().put(url, body, headers);
-  return response_to_value(resp);
+  return HttpModuleState::get_instance().client().put(url, body, headers);
 }
 
-Value builtin_http_patch(const std::vector<Value> &args) {
+Value builtin_http_put(const std::vector<Value> &args) {
+  return response_to_value(http_put_response(args));
+}
+
+levython::http::HttpResponse http_patch_response(const std::vector<Value> &args) {
   if (args.size() < 2) {
     throw std::runtime_error("http.patch() requires at least 2 arguments (url, body)");
   }
@@ -6445,11 +8123,14 @@ Value builtin_http_patch(const std::vector<Value> &args) {
     headers = value_to_headers(args[2]);
   }
 
-  auto resp = HttpModuleState::get_instance().client().patch(url, body, headers);
-  return response_to_value(resp);
+  return HttpModuleState::get_instance().client().patch(url, body, headers);
 }
 
-Value builtin_http_delete(const std::vector<Value> &args) {
+Value builtin_http_patch(const std::vector<Value> &args) {
+  return response_to_value(http_patch_response(args));
+}
+
+levython::http::HttpResponse http_delete_response(const std::vector<Value> &args) {
   if (args.empty()) {
     throw std::runtime_error("http.delete() requires at least 1 argument (url)");
   }
@@ -6460,11 +8141,14 @@ Value builtin_http_delete(const std::vector<Value> &args) {
     headers = value_to_headers(args[1]);
   }
 
-  auto resp = HttpModuleState::get_instance().client().del(url, headers);
-  return response_to_value(resp);
+  return HttpModuleState::get_instance().client().del(url, headers);
 }
 
-Value builtin_http_head(const std::vector<Value> &args) {
+Value builtin_http_delete(const std::vector<Value> &args) {
+  return response_to_value(http_delete_response(args));
+}
+
+levython::http::HttpResponse http_head_response(const std::vector<Value> &args) {
   if (args.empty()) {
     throw std::runtime_error("http.head() requires at least 1 argument (url)");
   }
@@ -6475,11 +8159,14 @@ Value builtin_http_head(const std::vector<Value> &args) {
     headers = value_to_headers(args[1]);
   }
 
-  auto resp = HttpModuleState::get_instance().client().head(url, headers);
-  return response_to_value(resp);
+  return HttpModuleState::get_instance().client().head(url, headers);
 }
 
-Value builtin_http_request(const std::vector<Value> &args) {
+Value builtin_http_head(const std::vector<Value> &args) {
+  return response_to_value(http_head_response(args));
+}
+
+levython::http::HttpResponse http_request_response(const std::vector<Value> &args) {
   if (args.size() < 2) {
     throw std::runtime_error(
         "http.request() requires at least 2 arguments (method, url)");
@@ -6503,8 +8190,11 @@ Value builtin_http_request(const std::vector<Value> &args) {
     req.verify_ssl = value_to_bool(args[5]);
   }
 
-  auto resp = HttpModuleState::get_instance().client().request(req);
-  return response_to_value(resp);
+  return HttpModuleState::get_instance().client().request(req);
+}
+
+Value builtin_http_request(const std::vector<Value> &args) {
+  return response_to_value(http_request_response(args));
 }
 
 Value builtin_http_set_timeout(const std::vector<Value> &args) {
@@ -6523,6 +8213,212 @@ Value builtin_http_set_verify_ssl(const std::vector<Value> &args) {
   return Value();
 }
 
+Value builtin_http_set_pool(const std::vector<Value> &args) {
+  if (args.empty()) {
+    throw std::runtime_error(
+        "http.set_pool() requires at least 1 argument (max_per_host)");
+  }
+  int max_per_host = value_to_int(args[0]);
+  int idle_timeout_ms = args.size() > 1 ? value_to_int(args[1])
+                                        : levython::http::DEFAULT_IDLE_TIMEOUT_MS;
+  if (max_per_host < 1) {
+    throw std::runtime_error("http.set_pool() max_per_host must be at least 1");
+  }
+  HttpModuleState::get_instance().client().pool().set_limits(
+      static_cast<size_t>(max_per_host), idle_timeout_ms);
+  return Value();
+}
+
+Value builtin_http_pool_stats(const std::vector<Value> &args) {
+  (void)args;
+  levython::http::PoolStats stats = HttpModuleState::get_instance().client().pool().stats();
+  Value result(ObjectType::MAP);
+  result.data.map["open"] = Value(static_cast<long>(stats.open));
+  result.data.map["idle"] = Value(static_cast<long>(stats.idle));
+  result.data.map["created"] = Value(static_cast<long>(stats.created));
+  result.data.map["reused"] = Value(static_cast<long>(stats.reused));
+  result.data.map["tls_resumed"] = Value(static_cast<long>(stats.resumed));
+  return result;
+}
+
+Value builtin_http_close_idle(const std::vector<Value> &args) {
+  (void)args;
+  HttpModuleState::get_instance().client().pool().close_idle();
+  return Value();
+}
+
+// Request for the streaming calls: url plus optional headers
+levython::http::HttpRequest stream_request(const std::vector<Value> &args, size_t headers_at) {
+  levython::http::HttpRequest req;
+  req.method = levython::http::HttpMethod::GET;
+  req.url = value_to_string(args[0]);
+  req.timeout_ms = 0; // use client default timeout
+  if (args.size() > headers_at) {
+    req.headers = value_to_headers(args[headers_at]);
+  }
+  return req;
+}
+
+long stream_handle(const Value &v, const char *fn) {
+  if (v.type == ObjectType::MAP) {
+    auto it = v.data.map.find("stream");
+    if (it != v.data.map.end() && it->second.type == ObjectType::INTEGER) {
+      return it->second.data.integer;
+    }
+  }
+  if (v.type == ObjectType::INTEGER) {
+    return v.data.integer;
+  }
+  throw std::runtime_error(std::string(fn) + " expects a stream from http.stream()");
+}
+
+Value builtin_http_stream(const std::vector<Value> &args) {
+  if (args.empty()) {
+    throw std::runtime_error("http.stream() requires at least 1 argument (url)");
+  }
+
+  auto &state = HttpModuleState::get_instance();
+  std::unique_ptr<levython::http::HttpStream> stream =
+      state.client().open_stream(stream_request(args, 1));
+  Value result = response_to_value(stream->response());
+  result.data.map.erase("body");
+  result.data.map.erase("text");
+  result.data.map.erase("json_text");
+  if (stream->response().error.has_error()) {
+    result.data.map["stream"] = Value();
+  } else {
+    result.data.map["stream"] = Value(state.add_stream(std::move(stream)));
+  }
+  return result;
+}
+
+Value builtin_http_read_chunk(const std::vector<Value> &args) {
+  if (args.empty()) {
+    throw std::runtime_error("http.read_chunk() requires 1 argument (stream)");
+  }
+
+  auto &state = HttpModuleState::get_instance();
+  long id = stream_handle(args[0], "http.read_chunk()");
+  std::shared_ptr<levython::http::HttpStream> stream = state.find_stream(id);
+  if (!stream) {
+    return Value(); // Finished or closed
+  }
+  std::string chunk;
+  if (stream->read(chunk)) {
+    return Value(chunk);
+  }
+  // End of body; a transfer error surfaces instead of a silent short read
+  levython::http::HttpError error = stream->response().error;
+  state.remove_stream(id);
+  if (error.has_error()) {
+    throw std::runtime_error("http.read_chunk(): " + error.to_string());
+  }
+  return Value();
+}
+
+Value builtin_http_close_stream(const std::vector<Value> &args) {
+  if (args.empty()) {
+    throw std::runtime_error("http.close_stream() requires 1 argument (stream)");
+  }
+  HttpModuleState::get_instance().remove_stream(stream_handle(args[0], "http.close_stream()"));
+  return Value();
+}
+
+Value builtin_http_download(const std::vector<Value> &args) {
+  if (args.size() < 2) {
+    throw std::runtime_error("http.download() requires at least 2 arguments (url, path)");
+  }
+
+  const std::string path = value_to_string(args[1]);
+  std::unique_ptr<levython::http::HttpStream> stream =
+      HttpModuleState::get_instance().client().open_stream(stream_request(args, 2));
+  levython::http::HttpResponse resp = stream->response();
+  long written = 0;
+  if (!resp.error.has_error()) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+      throw std::runtime_error("http.download(): cannot open " + path);
+    }
+    std::string chunk;
+    while (stream->read(chunk)) {
+      out.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+      written += static_cast<long>(chunk.size());
+    }
+    if (!out) {
+      throw std::runtime_error("http.download(): write failed for " + path);
+    }
+    resp.error = stream->response().error;
+  }
+
+  Value result = response_to_value(resp);
+  result.data.map.erase("body");
+  result.data.map.erase("text");
+  result.data.map.erase("json_text");
+  result.data.map["path"] = Value(path);
+  result.data.map["bytes"] = Value(written);
+  return result;
+}
+
+constexpr size_t HTTP_MANY_MAX_WORKERS = 32;  // Threads one request_many call may start
+
+std::vector<levython::http::HttpResponse> http_request_many_responses(const std::vector<Value> &args) {
+  if (args.empty() || args[0].type != ObjectType::LIST) {
+    throw std::runtime_error(
+        "http.request_many() requires a list of requests (urls or request maps)");
+  }
+
+  const std::vector<Value> &items = args[0].data.list;
+  std::vector<levython::http::HttpRequest> requests;
+  requests.reserve(items.size());
+  for (const Value &item : items) {
+    requests.push_back(value_to_request(item, "http.request_many()"));
+  }
+  long concurrency = args.size() > 1 ? value_to_int(args[1])
+                                     : static_cast<long>(levython::http::DEFAULT_MAX_PER_HOST);
+  if (concurrency < 1) {
+    throw std::runtime_error("http.request_many() concurrency must be at least 1");
+  }
+
+  // Workers take the next request index until none are left; the pool's
+  // per-host limit still caps connections to any one server. Each worker is
+  // a thread, so the count is capped however high concurrency is set.
+  auto &client = HttpModuleState::get_instance().client();
+  std::vector<levython::http::HttpResponse> responses(requests.size());
+  std::atomic<size_t> next{0};
+  std::mutex error_mu;
+  std::exception_ptr error;
+  auto worker = [&]() {
+    for (size_t i = next++; i < requests.size(); i = next++) {
+      try {
+        responses[i] = client.request(requests[i]);
+      } catch (...) {
+        std::lock_guard<std::mutex> lk(error_mu);
+        if (!error) error = std::current_exception();
+        next = requests.size();  // Stop handing out work
+      }
+    }
+  };
+  size_t workers = std::min({requests.size(), static_cast<size_t>(concurrency), HTTP_MANY_MAX_WORKERS});
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < workers; i++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto &t : threads) {
+    t.join();
+  }
+  if (error) std::rethrow_exception(error);
+  return responses;
+}
+
+Value builtin_http_request_many(const std::vector<Value> &args) {
+  Value result(ObjectType::LIST);
+  for (const auto &resp : http_request_many_responses(args)) {
+    result.data.list.push_back(response_to_value(resp));
+  }
+  return result;
+}
+
 Value create_http_module() {
   Value http_module(ObjectType::MAP);
 
@@ -6544,6 +8440,14 @@ Value create_http_module() {
   add_builtin("request", "http_request", {"method", "url"});
   add_builtin("set_timeout", "http_set_timeout", {"milliseconds"});
   add_builtin("set_verify_ssl", "http_set_verify_ssl", {"enabled"});
+  add_builtin("set_pool", "http_set_pool", {"max_per_host", "idle_timeout_ms"});
+  add_builtin("pool_stats", "http_pool_stats", {});
+  add_builtin("close_idle", "http_close_idle", {});
+  add_builtin("stream", "http_stream", {"url"});
+  add_builtin("read_chunk", "http_read_chunk", {"stream"});
+  add_builtin("close_stream", "http_close_stream", {"stream"});
+  add_builtin("download", "http_download", {"url", "path"});
+  add_builtin("request_many", "http_request_many", {"requests", "concurrency"});
 
   return http_module;
 }
@@ -10191,7 +12095,11 @@ Value builtin_os_signal(const std::vector<Value> &args) {
     void (*handler)(int) = nullptr;
     if (action == "ignore") handler = SIG_IGN;
     else if (action == "default") handler = SIG_DFL;
-    else throw std::runtime_error("os.signal action must be 'ignore' or 'default'.");
+    else if (action == "profile") {
+        profiler::arm_dump_signal(sig);
+        return Value("profile");
+    }
+    else throw std::runtime_error("os.signal action must be 'ignore', 'default' or 'profile'.");
 
     void (*prev)(int) = signal(sig, handler);
     if (prev == SIG_ERR) {
@@ -11432,6 +13340,7 @@ Value builtin_os_sleep(const std::vector<Value> &args) {
   }
   long seconds = value_to_long(args[0]);
   if (seconds < 0) seconds = 0;
+  thread_isolates::BlockingWait parked;
   std::this_thread::sleep_for(std::chrono::seconds(seconds));
   return Value(true);
 }
@@ -11954,6 +13863,7 @@ Value builtin_os_sleep_ms(const std::vector<Value> &args) {
   }
   long ms = value_to_long(args[0]);
   if (ms < 0) ms = 0;
+  thread_isolates::BlockingWait parked;
   std::this_thread::sleep_for(std::chrono::milliseconds(ms));
   return Value(true);
 }
@@ -18841,33 +20751,269 @@ inline Value make_builtin(const char* name, const char* builtin_name, std::vecto
     func.data.function.builtin_name = builtin_name;
     return func;
 }
+
+// ----------------------------------------------------------------------------
+// Zero-copy native ABI: FastVM hands natives its NaN-boxed stack slots, so
+// arguments are read in place instead of being rebuilt as Value trees.
+// ----------------------------------------------------------------------------
+struct NativeEntry { const char* name; NativeFn fn; };
+
+inline uint64_t native_arg(const uint64_t* args, uint8_t argc, uint8_t i) {
+    if (i >= argc) throw std::runtime_error("missing argument " + std::to_string(i + 1));
+    return args[i];
+}
+inline bool is_string_val(uint64_t v) { return is_obj(v) && obj_type(v) == ObjType::STRING; }
+// String and bytes args are borrowed; other values are formatted into `tmp` (like to_string)
+inline std::string_view native_string(uint64_t v, std::string& tmp) {
+    if (is_string_val(v)) {
+        ObjString* s = as_string(v);
+        return std::string_view(s->chars, s->length);
+    }
+    if (is_bytes(v)) {
+        ObjBytes* b = as_bytes(v);
+        return std::string_view(reinterpret_cast<const char*>(b->data), b->length);
+    }
+    tmp = val_to_string(v);
+    return tmp;
+}
+inline long native_long(uint64_t v) {
+    if (v == VAL_TRUE) return 1;
+    if (v == VAL_FALSE) return 0;
+    if (is_int(v)) return static_cast<long>(as_int(v));
+    if (is_number(v)) return static_cast<long>(as_number(v));
+    return std::stol(val_to_string(v));
+}
+inline bool native_bool(uint64_t v) {
+    if (is_obj(v)) {
+        switch (obj_type(v)) {
+            case ObjType::STRING: return as_string(v)->length != 0;
+            case ObjType::LIST: return as_list(v)->count != 0;
+            case ObjType::MAP: return !as_map(v)->data.empty();
+            case ObjType::BYTES: return as_bytes(v)->length != 0;
+            default: return true;
+        }
+    }
+    return is_truthy(v);
+}
+inline uint64_t native_str_val(const char* s, size_t len) { return val_obj((Obj*)ObjString::create(s, (uint32_t)len)); }
+inline uint64_t native_str_val(const std::string& s) { return native_str_val(s.data(), s.size()); }
+inline uint64_t native_bytes_val(const void* data, size_t len) { return val_obj((Obj*)ObjBytes::create(data, len)); }
+inline void native_map_set(ObjMap* m, const char* key, uint64_t v) { m->data[g_strings.intern(key)] = v; }
 } // namespace native_module_util
 
 // ============================================================================
-// FS + PATH BINDINGS
+// GC BINDINGS
 // ============================================================================
-namespace fs_bindings {
+namespace gc_bindings {
 using namespace native_module_util;
 
-Value builtin_fs_exists(const std::vector<Value>& args) { return Value(fs::exists(fs::path(to_string(args.at(0))))); }
-Value builtin_fs_is_file(const std::vector<Value>& args) { return Value(fs::is_regular_file(fs::path(to_string(args.at(0))))); }
-Value builtin_fs_is_dir(const std::vector<Value>& args) { return Value(fs::is_directory(fs::path(to_string(args.at(0))))); }
-Value builtin_fs_mkdir(const std::vector<Value>& args) {
-    fs::path p(to_string(args.at(0)));
-    bool recursive = args.size() >= 2 ? to_bool(args[1]) : false;
-    bool ok = recursive ? fs::create_directories(p) : fs::create_directory(p);
-    return Value(ok || fs::exists(p));
+// gc.collect() -> number of objects freed
+uint64_t native_gc_collect(VMContext&, const uint64_t*, uint8_t) {
+    return val_int((int64_t)gc_collect());
 }
-Value builtin_fs_remove(const std::vector<Value>& args) { return Value(fs::remove(fs::path(to_string(args.at(0))))); }
-Value builtin_fs_rmdir(const std::vector<Value>& args) {
-    fs::path p(to_string(args.at(0)));
-    return Value(fs::is_directory(p) && fs::remove(p));
+
+uint64_t native_gc_stats(VMContext&, const uint64_t*, uint8_t) {
+    ObjMap* m = ObjMap::create();
+    native_map_set(m, "collections", val_int((int64_t)g_heap.collections));
+    native_map_set(m, "objects", val_int((int64_t)g_heap.object_count));
+    native_map_set(m, "live_bytes", val_int((int64_t)g_heap.live_bytes));
+    native_map_set(m, "allocated_bytes", val_int((int64_t)g_heap.allocated));
+    native_map_set(m, "threshold_bytes", val_int((int64_t)g_heap.threshold));
+    native_map_set(m, "freed_objects", val_int((int64_t)g_heap.freed_objects));
+    native_map_set(m, "freed_bytes", val_int((int64_t)g_heap.freed_bytes));
+    native_map_set(m, "pause_ms", val_number(g_heap.pause_ms));
+    return val_map(m);
 }
-Value builtin_fs_listdir(const std::vector<Value>& args) {
-    fs::path p = args.empty() ? fs::path(".") : fs::path(to_string(args[0]));
-    Value out(ObjectType::LIST);
-    std::vector<std::string> names;
-    for (const auto& e : fs::directory_iterator(p)) names.push_back(e.path().filename().string());
+
+const NativeEntry natives[] = {
+    {"collect", native_gc_collect},
+    {"stats", native_gc_stats},
+};
+} // namespace gc_bindings
+
+// ============================================================================
+// OS FD + FILESYSTEM BINDINGS (zero-copy)
+// ============================================================================
+namespace os_bindings {
+using namespace native_module_util;
+
+// os.write(fd, data): strings and bytes are written from their own buffers
+static uint64_t native_os_write(VMContext&, const uint64_t* args, uint8_t argc) {
+    if (argc != 2) throw std::runtime_error("os.write(fd, data) expects 2 arguments.");
+    int fd = static_cast<int>(native_long(args[0]));
+    std::string tmp;
+    std::string_view data = native_string(args[1], tmp);
+#ifdef _WIN32
+    int written = _write(fd, data.data(), static_cast<unsigned int>(data.size()));
+#else
+    ssize_t written = write(fd, data.data(), data.size());
+#endif
+    return val_int(written < 0 ? 0 : static_cast<int64_t>(written));
+}
+
+// os.read_bytes(fd, n): up to n bytes (n < 0 reads to EOF) as a bytes buffer
+static uint64_t native_os_read_bytes(VMContext& ctx, const uint64_t* args, uint8_t argc) {
+    if (argc != 2) throw std::runtime_error("os.read_bytes(fd, n) expects 2 arguments.");
+    int fd = static_cast<int>(native_long(args[0]));
+    long want = native_long(args[1]);
+    std::string& out = ctx.scratch;
+    out.clear();
+    char buf[4096];
+    while (want < 0 || static_cast<long>(out.size()) < want) {
+        size_t chunk = sizeof(buf);
+        if (want >= 0 && want - static_cast<long>(out.size()) < static_cast<long>(chunk)) {
+            chunk = static_cast<size_t>(want - static_cast<long>(out.size()));
+        }
+#ifdef _WIN32
+        int n = _read(fd, buf, static_cast<unsigned int>(chunk));
+#else
+        ssize_t n = read(fd, buf, chunk);
+#endif
+        if (n <= 0) break;
+        out.append(buf, static_cast<size_t>(n));
+    }
+    return native_bytes_val(out.data(), out.size());
+}
+
+// The filesystem and environment core of os. The rest of os (processes,
+// users, services, hardware and the OS.* subsystems) stays on the Value
+// path: those calls are dominated by the syscalls they make.
+static fs::path native_os_path(const uint64_t* args, uint8_t i) {
+    std::string tmp;
+    return fs::path(native_string(args[i], tmp));
+}
+static std::string native_os_key(const uint64_t* args, uint8_t i) {
+    std::string tmp;
+    return std::string(native_string(args[i], tmp));
+}
+
+static uint64_t native_os_cwd(VMContext&, const uint64_t*, uint8_t) {
+    return native_str_val(fs::current_path().string());
+}
+static uint64_t native_os_chdir(VMContext&, const uint64_t* args, uint8_t argc) {
+    if (argc != 1) throw std::runtime_error("os.chdir(path) expects 1 argument.");
+    fs::current_path(native_os_path(args, 0));
+    return VAL_TRUE;
+}
+static uint64_t native_os_listdir(VMContext&, const uint64_t* args, uint8_t argc) {
+    fs::path p = argc == 0 ? fs::path(".") : native_os_path(args, 0);
+    std::vector<std::string> names;
+    for (const auto& e : fs::directory_iterator(p)) names.push_back(e.path().filename().string());
+    std::sort(names.begin(), names.end());
+    ObjList* out = ObjList::create();
+    for (const auto& n : names) out->push(native_str_val(n));
+    return val_list(out);
+}
+static uint64_t native_os_exists(VMContext&, const uint64_t* args, uint8_t argc) {
+    if (argc != 1) throw std::runtime_error("os.exists(path) expects 1 argument.");
+    return fs::exists(native_os_path(args, 0)) ? VAL_TRUE : VAL_FALSE;
+}
+static uint64_t native_os_is_file(VMContext&, const uint64_t* args, uint8_t argc) {
+    if (argc != 1) throw std::runtime_error("os.is_file(path) expects 1 argument.");
+    return fs::is_regular_file(native_os_path(args, 0)) ? VAL_TRUE : VAL_FALSE;
+}
+static uint64_t native_os_is_dir(VMContext&, const uint64_t* args, uint8_t argc) {
+    if (argc != 1) throw std::runtime_error("os.is_dir(path) expects 1 argument.");
+    return fs::is_directory(native_os_path(args, 0)) ? VAL_TRUE : VAL_FALSE;
+}
+static uint64_t native_os_mkdir(VMContext&, const uint64_t* args, uint8_t argc) {
+    if (argc < 1 || argc > 2) throw std::runtime_error("os.mkdir(path, recursive=no) expects 1 or 2 arguments.");
+    fs::path p = native_os_path(args, 0);
+    bool recursive = argc == 2 ? native_bool(args[1]) : false;
+    bool ok = recursive ? fs::create_directories(p) : fs::create_directory(p);
+    return (ok || fs::exists(p)) ? VAL_TRUE : VAL_FALSE;
+}
+static uint64_t native_os_remove(VMContext&, const uint64_t* args, uint8_t argc) {
+    if (argc != 1) throw std::runtime_error("os.remove(path) expects 1 argument.");
+    return fs::remove(native_os_path(args, 0)) ? VAL_TRUE : VAL_FALSE;
+}
+static uint64_t native_os_rmdir(VMContext&, const uint64_t* args, uint8_t argc) {
+    if (argc != 1) throw std::runtime_error("os.rmdir(path) expects 1 argument.");
+    fs::path p = native_os_path(args, 0);
+    return (fs::is_directory(p) && fs::remove(p)) ? VAL_TRUE : VAL_FALSE;
+}
+static uint64_t native_os_rename(VMContext&, const uint64_t* args, uint8_t argc) {
+    if (argc != 2) throw std::runtime_error("os.rename(src, dst) expects 2 arguments.");
+    fs::rename(native_os_path(args, 0), native_os_path(args, 1));
+    return VAL_TRUE;
+}
+static uint64_t native_os_abspath(VMContext&, const uint64_t* args, uint8_t argc) {
+    if (argc != 1) throw std::runtime_error("os.abspath(path) expects 1 argument.");
+    return native_str_val(fs::absolute(native_os_path(args, 0)).string());
+}
+static uint64_t native_os_getenv(VMContext&, const uint64_t* args, uint8_t argc) {
+    if (argc < 1 || argc > 2) throw std::runtime_error("os.getenv(key, default=\"\") expects 1 or 2 arguments.");
+    const char* val = std::getenv(native_os_key(args, 0).c_str());
+    if (val) return native_str_val(val, std::strlen(val));
+    if (argc == 2) return is_string_val(args[1]) ? args[1] : native_str_val(val_to_string(args[1]));
+    return native_str_val("", 0);
+}
+static uint64_t native_os_setenv(VMContext&, const uint64_t* args, uint8_t argc) {
+    if (argc != 2) throw std::runtime_error("os.setenv(key, value) expects 2 arguments.");
+    std::string key = native_os_key(args, 0), value = native_os_key(args, 1);
+#ifdef _WIN32
+    int rc = _putenv_s(key.c_str(), value.c_str());
+#else
+    int rc = setenv(key.c_str(), value.c_str(), 1);
+#endif
+    return rc == 0 ? VAL_TRUE : VAL_FALSE;
+}
+static uint64_t native_os_unsetenv(VMContext&, const uint64_t* args, uint8_t argc) {
+    if (argc != 1) throw std::runtime_error("os.unsetenv(key) expects 1 argument.");
+    std::string key = native_os_key(args, 0);
+#ifdef _WIN32
+    int rc = _putenv_s(key.c_str(), "");
+#else
+    int rc = unsetenv(key.c_str());
+#endif
+    return rc == 0 ? VAL_TRUE : VAL_FALSE;
+}
+static uint64_t native_os_getpid(VMContext&, const uint64_t*, uint8_t argc) {
+    if (argc != 0) throw std::runtime_error("os.getpid() expects 0 arguments.");
+#ifdef _WIN32
+    return val_int(static_cast<int64_t>(GetCurrentProcessId()));
+#else
+    return val_int(static_cast<int64_t>(getpid()));
+#endif
+}
+
+const NativeEntry natives[] = {
+    {"write", native_os_write},
+    {"read_bytes", native_os_read_bytes},
+    {"cwd", native_os_cwd}, {"chdir", native_os_chdir}, {"listdir", native_os_listdir},
+    {"exists", native_os_exists}, {"is_file", native_os_is_file}, {"is_dir", native_os_is_dir},
+    {"mkdir", native_os_mkdir}, {"remove", native_os_remove}, {"rmdir", native_os_rmdir},
+    {"rename", native_os_rename}, {"abspath", native_os_abspath},
+    {"getenv", native_os_getenv}, {"setenv", native_os_setenv}, {"unsetenv", native_os_unsetenv},
+    {"getpid", native_os_getpid},
+};
+} // namespace os_bindings
+
+// ============================================================================
+// FS + PATH BINDINGS
+// ============================================================================
+namespace fs_bindings {
+using namespace native_module_util;
+
+Value builtin_fs_exists(const std::vector<Value>& args) { return Value(fs::exists(fs::path(to_string(args.at(0))))); }
+Value builtin_fs_is_file(const std::vector<Value>& args) { return Value(fs::is_regular_file(fs::path(to_string(args.at(0))))); }
+Value builtin_fs_is_dir(const std::vector<Value>& args) { return Value(fs::is_directory(fs::path(to_string(args.at(0))))); }
+Value builtin_fs_mkdir(const std::vector<Value>& args) {
+    fs::path p(to_string(args.at(0)));
+    bool recursive = args.size() >= 2 ? to_bool(args[1]) : false;
+    bool ok = recursive ? fs::create_directories(p) : fs::create_directory(p);
+    return Value(ok || fs::exists(p));
+}
+Value builtin_fs_remove(const std::vector<Value>& args) { return Value(fs::remove(fs::path(to_string(args.at(0))))); }
+Value builtin_fs_rmdir(const std::vector<Value>& args) {
+    fs::path p(to_string(args.at(0)));
+    return Value(fs::is_directory(p) && fs::remove(p));
+}
+Value builtin_fs_listdir(const std::vector<Value>& args) {
+    fs::path p = args.empty() ? fs::path(".") : fs::path(to_string(args[0]));
+    Value out(ObjectType::LIST);
+    std::vector<std::string> names;
+    for (const auto& e : fs::directory_iterator(p)) names.push_back(e.path().filename().string());
     std::sort(names.begin(), names.end());
     for (const auto& n : names) out.data.list.push_back(Value(n));
     return out;
@@ -18902,6 +21048,116 @@ Value builtin_fs_move(const std::vector<Value>& args) {
 }
 Value builtin_fs_abspath(const std::vector<Value>& args) { return Value(fs::absolute(fs::path(to_string(args.at(0)))).string()); }
 
+// Zero-copy FastVM entry points (same behaviour as the Value versions above)
+static fs::path native_path(const uint64_t* args, uint8_t argc, uint8_t i) {
+    std::string tmp;
+    return fs::path(native_string(native_arg(args, argc, i), tmp));
+}
+static uint64_t native_fs_exists(VMContext&, const uint64_t* args, uint8_t argc) {
+    return fs::exists(native_path(args, argc, 0)) ? VAL_TRUE : VAL_FALSE;
+}
+static uint64_t native_fs_is_file(VMContext&, const uint64_t* args, uint8_t argc) {
+    return fs::is_regular_file(native_path(args, argc, 0)) ? VAL_TRUE : VAL_FALSE;
+}
+static uint64_t native_fs_is_dir(VMContext&, const uint64_t* args, uint8_t argc) {
+    return fs::is_directory(native_path(args, argc, 0)) ? VAL_TRUE : VAL_FALSE;
+}
+static uint64_t native_fs_mkdir(VMContext&, const uint64_t* args, uint8_t argc) {
+    fs::path p = native_path(args, argc, 0);
+    bool recursive = argc >= 2 ? native_bool(args[1]) : false;
+    bool ok = recursive ? fs::create_directories(p) : fs::create_directory(p);
+    return (ok || fs::exists(p)) ? VAL_TRUE : VAL_FALSE;
+}
+static uint64_t native_fs_remove(VMContext&, const uint64_t* args, uint8_t argc) {
+    return fs::remove(native_path(args, argc, 0)) ? VAL_TRUE : VAL_FALSE;
+}
+static uint64_t native_fs_rmdir(VMContext&, const uint64_t* args, uint8_t argc) {
+    fs::path p = native_path(args, argc, 0);
+    return (fs::is_directory(p) && fs::remove(p)) ? VAL_TRUE : VAL_FALSE;
+}
+static uint64_t native_fs_listdir(VMContext&, const uint64_t* args, uint8_t argc) {
+    fs::path p = argc == 0 ? fs::path(".") : native_path(args, argc, 0);
+    std::vector<std::string> names;
+    for (const auto& e : fs::directory_iterator(p)) names.push_back(e.path().filename().string());
+    std::sort(names.begin(), names.end());
+    ObjList* out = ObjList::create();
+    for (const auto& n : names) out->push(native_str_val(n));
+    return val_list(out);
+}
+static uint64_t native_fs_read_text(VMContext& ctx, const uint64_t* args, uint8_t argc) {
+    std::ifstream in(native_path(args, argc, 0));
+    if (!in) throw std::runtime_error("fs.read_text() cannot open file");
+    ctx.scratch.assign((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return native_str_val(ctx.scratch);
+}
+static uint64_t write_text_impl(const uint64_t* args, uint8_t argc, std::ios::openmode mode, const char* err) {
+    std::ofstream out(native_path(args, argc, 0), mode);
+    if (!out) throw std::runtime_error(err);
+    std::string tmp;
+    std::string_view text = native_string(native_arg(args, argc, 1), tmp);
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    return VAL_TRUE;
+}
+static uint64_t native_fs_write_text(VMContext&, const uint64_t* args, uint8_t argc) {
+    return write_text_impl(args, argc, std::ios::trunc, "fs.write_text() cannot open file");
+}
+static uint64_t native_fs_append_text(VMContext&, const uint64_t* args, uint8_t argc) {
+    return write_text_impl(args, argc, std::ios::app, "fs.append_text() cannot open file");
+}
+static uint64_t native_fs_read_bytes(VMContext&, const uint64_t* args, uint8_t argc) {
+    std::ifstream in(native_path(args, argc, 0), std::ios::binary | std::ios::ate);
+    if (!in) throw std::runtime_error("fs.read_bytes() cannot open file");
+    std::streamoff size = in.tellg();
+    if (size < 0) throw std::runtime_error("fs.read_bytes() cannot size file");
+    ObjBytes* out = ObjBytes::create(static_cast<size_t>(size));
+    in.seekg(0);
+    if (size > 0 && !in.read(reinterpret_cast<char*>(out->data), size)) {
+        throw std::runtime_error("fs.read_bytes() read failed");
+    }
+    return val_obj((Obj*)out);
+}
+static uint64_t native_fs_write_bytes(VMContext&, const uint64_t* args, uint8_t argc) {
+    std::ofstream out(native_path(args, argc, 0), std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("fs.write_bytes() cannot open file");
+    std::string tmp;
+    std::string_view data = native_string(native_arg(args, argc, 1), tmp);
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    return VAL_TRUE;
+}
+static uint64_t native_fs_open(VMContext&, const uint64_t* args, uint8_t argc) {
+    ObjReader* r = ObjReader::open(native_path(args, argc, 0).string());
+    if (!r) throw std::runtime_error("fs.open() cannot open file");
+    return val_obj((Obj*)r);
+}
+static uint64_t native_fs_lines(VMContext&, const uint64_t* args, uint8_t argc) {
+    ObjReader* r = ObjReader::open(native_path(args, argc, 0).string());
+    if (!r) throw std::runtime_error("fs.lines() cannot open file");
+    return val_obj((Obj*)r);
+}
+static uint64_t native_fs_copy(VMContext&, const uint64_t* args, uint8_t argc) {
+    bool overwrite = argc >= 3 ? native_bool(args[2]) : true;
+    fs::copy_options opt = overwrite ? fs::copy_options::overwrite_existing : fs::copy_options::none;
+    fs::copy_file(native_path(args, argc, 0), native_path(args, argc, 1), opt);
+    return VAL_TRUE;
+}
+static uint64_t native_fs_move(VMContext&, const uint64_t* args, uint8_t argc) {
+    fs::rename(native_path(args, argc, 0), native_path(args, argc, 1));
+    return VAL_TRUE;
+}
+static uint64_t native_fs_abspath(VMContext&, const uint64_t* args, uint8_t argc) {
+    return native_str_val(fs::absolute(native_path(args, argc, 0)).string());
+}
+
+const NativeEntry natives[] = {
+    {"exists", native_fs_exists}, {"is_file", native_fs_is_file}, {"is_dir", native_fs_is_dir},
+    {"mkdir", native_fs_mkdir}, {"remove", native_fs_remove}, {"rmdir", native_fs_rmdir},
+    {"listdir", native_fs_listdir}, {"read_text", native_fs_read_text},
+    {"write_text", native_fs_write_text}, {"append_text", native_fs_append_text},
+    {"read_bytes", native_fs_read_bytes}, {"write_bytes", native_fs_write_bytes},
+    {"open", native_fs_open}, {"lines", native_fs_lines},
+    {"copy", native_fs_copy}, {"move", native_fs_move}, {"abspath", native_fs_abspath},
+};
+
 Value create_fs_module() {
     Value m(ObjectType::MAP);
     m.data.map["exists"] = make_builtin("exists", "fs_exists", {"path"});
@@ -18972,6 +21228,53 @@ Value builtin_path_mkdir(const std::vector<Value>& args) {
 Value builtin_path_remove(const std::vector<Value>& args) { return Value(fs::remove(fs::path(to_string(args.at(0))))); }
 Value builtin_path_rmdir(const std::vector<Value>& args) { fs::remove_all(fs::path(to_string(args.at(0)))); return Value(true); }
 
+static uint64_t native_path_join(VMContext&, const uint64_t* args, uint8_t argc) {
+    if (argc < 2) throw std::runtime_error("path.join() expects >=2 args");
+    std::string tmp;
+    fs::path p(native_string(args[0], tmp));
+    for (uint8_t i = 1; i < argc; ++i) p /= native_string(args[i], tmp);
+    return native_str_val(p.string());
+}
+static uint64_t native_path_basename(VMContext&, const uint64_t* args, uint8_t argc) {
+    return native_str_val(fs_bindings::native_path(args, argc, 0).filename().string());
+}
+static uint64_t native_path_dirname(VMContext&, const uint64_t* args, uint8_t argc) {
+    return native_str_val(fs_bindings::native_path(args, argc, 0).parent_path().string());
+}
+static uint64_t native_path_ext(VMContext&, const uint64_t* args, uint8_t argc) {
+    return native_str_val(fs_bindings::native_path(args, argc, 0).extension().string());
+}
+static uint64_t native_path_stem(VMContext&, const uint64_t* args, uint8_t argc) {
+    return native_str_val(fs_bindings::native_path(args, argc, 0).stem().string());
+}
+static uint64_t native_path_norm(VMContext&, const uint64_t* args, uint8_t argc) {
+    return native_str_val(fs_bindings::native_path(args, argc, 0).lexically_normal().string());
+}
+static uint64_t native_path_read_text(VMContext& ctx, const uint64_t* args, uint8_t argc) {
+    std::ifstream in(fs_bindings::native_path(args, argc, 0));
+    if (!in) throw std::runtime_error("path.read_text() cannot open file");
+    ctx.scratch.assign((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return native_str_val(ctx.scratch);
+}
+static uint64_t native_path_write_text(VMContext&, const uint64_t* args, uint8_t argc) {
+    return fs_bindings::write_text_impl(args, argc, std::ios::trunc, "path.write_text() cannot open file");
+}
+static uint64_t native_path_rmdir(VMContext&, const uint64_t* args, uint8_t argc) {
+    fs::remove_all(fs_bindings::native_path(args, argc, 0));
+    return VAL_TRUE;
+}
+
+// Where path and fs agree, path shares the fs natives
+const NativeEntry natives[] = {
+    {"join", native_path_join}, {"basename", native_path_basename}, {"dirname", native_path_dirname},
+    {"ext", native_path_ext}, {"stem", native_path_stem}, {"norm", native_path_norm},
+    {"abspath", fs_bindings::native_fs_abspath}, {"exists", fs_bindings::native_fs_exists},
+    {"is_file", fs_bindings::native_fs_is_file}, {"is_dir", fs_bindings::native_fs_is_dir},
+    {"read_text", native_path_read_text}, {"write_text", native_path_write_text},
+    {"listdir", fs_bindings::native_fs_listdir}, {"mkdir", fs_bindings::native_fs_mkdir},
+    {"remove", fs_bindings::native_fs_remove}, {"rmdir", native_path_rmdir},
+};
+
 Value create_path_module() {
     Value m(ObjectType::MAP);
     m.data.map["join"] = make_builtin("join", "path_join", {"a", "b"});
@@ -19129,6 +21432,53 @@ Value builtin_process_unsetenv(const std::vector<Value>& args) {
     return Value(unsetenv(key.c_str()) == 0);
 #endif
 }
+// process.run stays on the Value path; popen dominates it
+static std::string native_process_key(const uint64_t* args, uint8_t argc, uint8_t i) {
+    std::string tmp;
+    return std::string(native_string(native_arg(args, argc, i), tmp));
+}
+static uint64_t native_process_getpid(VMContext&, const uint64_t*, uint8_t) {
+#ifdef _WIN32
+    return val_int(static_cast<int64_t>(GetCurrentProcessId()));
+#else
+    return val_int(static_cast<int64_t>(getpid()));
+#endif
+}
+static uint64_t native_process_cwd(VMContext&, const uint64_t*, uint8_t) {
+    return native_str_val(fs::current_path().string());
+}
+static uint64_t native_process_chdir(VMContext&, const uint64_t* args, uint8_t argc) {
+    fs::current_path(fs_bindings::native_path(args, argc, 0));
+    return VAL_TRUE;
+}
+static uint64_t native_process_getenv(VMContext&, const uint64_t* args, uint8_t argc) {
+    const char* v = std::getenv(native_process_key(args, argc, 0).c_str());
+    if (v) return native_str_val(v, std::strlen(v));
+    if (argc >= 2) return is_string_val(args[1]) ? args[1] : native_str_val(val_to_string(args[1]));
+    return native_str_val("", 0);
+}
+static uint64_t native_process_setenv(VMContext&, const uint64_t* args, uint8_t argc) {
+    std::string key = native_process_key(args, argc, 0), val = native_process_key(args, argc, 1);
+#ifdef _WIN32
+    return _putenv_s(key.c_str(), val.c_str()) == 0 ? VAL_TRUE : VAL_FALSE;
+#else
+    return setenv(key.c_str(), val.c_str(), 1) == 0 ? VAL_TRUE : VAL_FALSE;
+#endif
+}
+static uint64_t native_process_unsetenv(VMContext&, const uint64_t* args, uint8_t argc) {
+    std::string key = native_process_key(args, argc, 0);
+#ifdef _WIN32
+    return _putenv_s(key.c_str(), "") == 0 ? VAL_TRUE : VAL_FALSE;
+#else
+    return unsetenv(key.c_str()) == 0 ? VAL_TRUE : VAL_FALSE;
+#endif
+}
+
+const NativeEntry natives[] = {
+    {"getpid", native_process_getpid}, {"cwd", native_process_cwd}, {"chdir", native_process_chdir},
+    {"getenv", native_process_getenv}, {"setenv", native_process_setenv}, {"unsetenv", native_process_unsetenv},
+};
+
 Value create_process_module() {
     Value m(ObjectType::MAP);
     m.data.map["getpid"] = make_builtin("getpid", "process_getpid", {});
@@ -19203,37 +21553,46 @@ static std::vector<uint8_t> hex_decode_bytes(const std::string& hex) {
     return out;
 }
 
-Value builtin_crypto_sha256(const std::vector<Value>& args) {
-    auto bytes = value_to_bytes(args.at(0));
+static std::string digest_hex(const EVP_MD* md, const uint8_t* data, size_t len) {
     unsigned int out_len = 0;
     unsigned char out[EVP_MAX_MD_SIZE];
     EVP_MD_CTX* ctx = EVP_MD_CTX_new();
-    EVP_DigestInit_ex(ctx, EVP_sha256(), nullptr);
-    EVP_DigestUpdate(ctx, bytes.data(), bytes.size());
+    EVP_DigestInit_ex(ctx, md, nullptr);
+    EVP_DigestUpdate(ctx, data, len);
     EVP_DigestFinal_ex(ctx, out, &out_len);
     EVP_MD_CTX_free(ctx);
-    return Value(hex_encode_bytes(std::vector<uint8_t>(out, out + out_len)));
+    return hex_encode_bytes(std::vector<uint8_t>(out, out + out_len));
 }
 
-Value builtin_crypto_sha512(const std::vector<Value>& args) {
-    auto bytes = value_to_bytes(args.at(0));
+static std::string hmac_sha256_hex(const uint8_t* key, size_t key_len, const uint8_t* msg, size_t msg_len) {
     unsigned int out_len = 0;
     unsigned char out[EVP_MAX_MD_SIZE];
-    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
-    EVP_DigestInit_ex(ctx, EVP_sha512(), nullptr);
-    EVP_DigestUpdate(ctx, bytes.data(), bytes.size());
-    EVP_DigestFinal_ex(ctx, out, &out_len);
-    EVP_MD_CTX_free(ctx);
-    return Value(hex_encode_bytes(std::vector<uint8_t>(out, out + out_len)));
+    HMAC(EVP_sha256(), key, (int)key_len, msg, msg_len, out, &out_len);
+    return hex_encode_bytes(std::vector<uint8_t>(out, out + out_len));
+}
+
+static std::string base64_encode_raw(const uint8_t* data, size_t len) {
+    std::string out;
+    out.resize(4 * ((len + 2) / 3));
+    int n = EVP_EncodeBlock(reinterpret_cast<unsigned char*>(&out[0]), data, (int)len);
+    out.resize(static_cast<size_t>(n));
+    return out;
+}
+
+Value builtin_crypto_sha256(const std::vector<Value>& args) {
+    auto bytes = value_to_bytes(args.at(0));
+    return Value(digest_hex(EVP_sha256(), bytes.data(), bytes.size()));
+}
+
+Value builtin_crypto_sha512(const std::vector<Value>& args) {
+    auto bytes = value_to_bytes(args.at(0));
+    return Value(digest_hex(EVP_sha512(), bytes.data(), bytes.size()));
 }
 
 Value builtin_crypto_hmac_sha256(const std::vector<Value>& args) {
     auto key = value_to_bytes(args.at(0));
     auto msg = value_to_bytes(args.at(1));
-    unsigned int out_len = 0;
-    unsigned char out[EVP_MAX_MD_SIZE];
-    HMAC(EVP_sha256(), key.data(), (int)key.size(), msg.data(), msg.size(), out, &out_len);
-    return Value(hex_encode_bytes(std::vector<uint8_t>(out, out + out_len)));
+    return Value(hmac_sha256_hex(key.data(), key.size(), msg.data(), msg.size()));
 }
 
 Value builtin_crypto_random_bytes(const std::vector<Value>& args) {
@@ -19258,12 +21617,7 @@ Value builtin_crypto_hex_decode(const std::vector<Value>& args) {
 
 Value builtin_crypto_base64_encode(const std::vector<Value>& args) {
     auto bytes = value_to_bytes(args.at(0));
-    std::string out;
-    out.resize(4 * ((bytes.size() + 2) / 3));
-    int len = EVP_EncodeBlock(reinterpret_cast<unsigned char*>(&out[0]),
-                              bytes.data(), (int)bytes.size());
-    out.resize(static_cast<size_t>(len));
-    return Value(out);
+    return Value(base64_encode_raw(bytes.data(), bytes.size()));
 }
 
 Value builtin_crypto_base64_decode(const std::vector<Value>& args) {
@@ -19277,6 +21631,98 @@ Value builtin_crypto_base64_decode(const std::vector<Value>& args) {
     return bytes_to_list(out);
 }
 
+// Zero-copy FastVM entry points: string and bytes data is hashed/encoded in
+// place; decoders and random_bytes return bytes
+struct ByteSpan { const uint8_t* data; size_t size; };
+static ByteSpan native_bytes(uint64_t v, std::vector<uint8_t>& tmp) {
+    if (is_string_val(v)) {
+        ObjString* s = as_string(v);
+        return {reinterpret_cast<const uint8_t*>(s->chars), s->length};
+    }
+    if (is_bytes(v)) return {as_bytes(v)->data, as_bytes(v)->length};
+    if (is_obj(v) && obj_type(v) == ObjType::LIST) {
+        ObjList* list = as_list(v);
+        tmp.clear();
+        tmp.reserve(list->count);
+        for (size_t i = 0; i < list->count; ++i) {
+            uint64_t item = list->items[i];
+            if (!is_int(item) || item == VAL_TRUE) throw std::runtime_error("Byte list must contain integers");
+            int64_t n = as_int(item);
+            if (n < 0 || n > 255) throw std::runtime_error("Byte out of range");
+            tmp.push_back(static_cast<uint8_t>(n));
+        }
+        return {tmp.data(), tmp.size()};
+    }
+    throw std::runtime_error("Expected string, bytes or byte list");
+}
+static uint64_t native_crypto_sha256(VMContext&, const uint64_t* args, uint8_t argc) {
+    std::vector<uint8_t> tmp;
+    ByteSpan b = native_bytes(native_arg(args, argc, 0), tmp);
+    return native_str_val(digest_hex(EVP_sha256(), b.data, b.size));
+}
+static uint64_t native_crypto_sha512(VMContext&, const uint64_t* args, uint8_t argc) {
+    std::vector<uint8_t> tmp;
+    ByteSpan b = native_bytes(native_arg(args, argc, 0), tmp);
+    return native_str_val(digest_hex(EVP_sha512(), b.data, b.size));
+}
+static uint64_t native_crypto_hmac_sha256(VMContext&, const uint64_t* args, uint8_t argc) {
+    std::vector<uint8_t> key_tmp, msg_tmp;
+    ByteSpan key = native_bytes(native_arg(args, argc, 0), key_tmp);
+    ByteSpan msg = native_bytes(native_arg(args, argc, 1), msg_tmp);
+    return native_str_val(hmac_sha256_hex(key.data, key.size, msg.data, msg.size));
+}
+static uint64_t native_crypto_random_bytes(VMContext&, const uint64_t* args, uint8_t argc) {
+    long n = native_long(native_arg(args, argc, 0));
+    if (n < 0) throw std::runtime_error("random_bytes size must be >= 0");
+    ObjBytes* out = ObjBytes::create(static_cast<size_t>(n));
+    if (n > 0 && RAND_bytes(out->data, (int)n) != 1) {
+        throw std::runtime_error("random_bytes failed");
+    }
+    return val_obj((Obj*)out);
+}
+static uint64_t native_crypto_hex_encode(VMContext& ctx, const uint64_t* args, uint8_t argc) {
+    static const char* hex = "0123456789abcdef";
+    std::vector<uint8_t> tmp;
+    ByteSpan b = native_bytes(native_arg(args, argc, 0), tmp);
+    ctx.scratch.clear();
+    ctx.scratch.reserve(b.size * 2);
+    for (size_t i = 0; i < b.size; ++i) {
+        ctx.scratch.push_back(hex[(b.data[i] >> 4) & 0xF]);
+        ctx.scratch.push_back(hex[b.data[i] & 0xF]);
+    }
+    return native_str_val(ctx.scratch);
+}
+static uint64_t native_crypto_hex_decode(VMContext&, const uint64_t* args, uint8_t argc) {
+    std::string tmp;
+    std::string_view in = native_string(native_arg(args, argc, 0), tmp);
+    auto bytes = hex_decode_bytes(std::string(in));
+    return native_bytes_val(bytes.data(), bytes.size());
+}
+static uint64_t native_crypto_base64_encode(VMContext&, const uint64_t* args, uint8_t argc) {
+    std::vector<uint8_t> tmp;
+    ByteSpan b = native_bytes(native_arg(args, argc, 0), tmp);
+    return native_str_val(base64_encode_raw(b.data, b.size));
+}
+static uint64_t native_crypto_base64_decode(VMContext&, const uint64_t* args, uint8_t argc) {
+    std::string tmp;
+    std::string_view in = native_string(native_arg(args, argc, 0), tmp);
+    std::vector<uint8_t> out((in.size() * 3) / 4 + 1);
+    int len = EVP_DecodeBlock(out.data(), reinterpret_cast<const unsigned char*>(in.data()), (int)in.size());
+    if (len < 0) throw std::runtime_error("Invalid base64");
+    // EVP_DecodeBlock counts the zero bytes that '=' padding stands for
+    size_t pad = 0;
+    while (pad < 2 && pad < in.size() && in[in.size() - 1 - pad] == '=') pad++;
+    size_t n = static_cast<size_t>(len) >= pad ? static_cast<size_t>(len) - pad : 0;
+    return native_bytes_val(out.data(), n);
+}
+
+const NativeEntry natives[] = {
+    {"sha256", native_crypto_sha256}, {"sha512", native_crypto_sha512},
+    {"hmac_sha256", native_crypto_hmac_sha256}, {"random_bytes", native_crypto_random_bytes},
+    {"hex_encode", native_crypto_hex_encode}, {"hex_decode", native_crypto_hex_decode},
+    {"base64_encode", native_crypto_base64_encode}, {"base64_decode", native_crypto_base64_decode},
+};
+
 Value create_crypto_module() {
     Value m(ObjectType::MAP);
     m.data.map["sha256"] = make_builtin("sha256", "crypto_sha256", {"data"});
@@ -19358,11 +21804,8 @@ Value builtin_time_format(const std::vector<Value>& args) {
     return Value(format_time(t, fmt, utc));
 }
 
-Value builtin_time_parse(const std::vector<Value>& args) {
-    if (args.size() < 2) throw std::runtime_error("time.parse() expects (text, fmt, utc?)");
-    std::string text = to_string(args.at(0));
-    std::string fmt = to_string(args.at(1));
-    bool utc = args.size() >= 3 ? to_bool(args.at(2)) : true;
+// Epoch ms for `text` read with strptime-style `fmt`
+static int64_t parse_time(const std::string& text, const std::string& fmt, bool utc) {
     std::tm tm_val{};
     std::istringstream iss(text);
     iss >> std::get_time(&tm_val, fmt.c_str());
@@ -19373,12 +21816,19 @@ Value builtin_time_parse(const std::vector<Value>& args) {
     std::time_t t = utc ? timegm(&tm_val) : std::mktime(&tm_val);
 #endif
     if (t == (std::time_t)-1) throw std::runtime_error("time.parse() invalid time");
-    return Value(static_cast<long>(static_cast<int64_t>(t) * 1000));
+    return static_cast<int64_t>(t) * 1000;
+}
+
+Value builtin_time_parse(const std::vector<Value>& args) {
+    if (args.size() < 2) throw std::runtime_error("time.parse() expects (text, fmt, utc?)");
+    bool utc = args.size() >= 3 ? to_bool(args.at(2)) : true;
+    return Value(static_cast<long>(parse_time(to_string(args.at(0)), to_string(args.at(1)), utc)));
 }
 
 Value builtin_time_sleep_ms(const std::vector<Value>& args) {
     long ms = to_long(args.at(0));
     if (ms < 0) ms = 0;
+    thread_isolates::BlockingWait parked;
     std::this_thread::sleep_for(std::chrono::milliseconds(ms));
     return Value();
 }
@@ -19387,6 +21837,54 @@ Value builtin_time_epoch_ms(const std::vector<Value>&) {
     return Value(static_cast<long>(epoch_ms_now()));
 }
 
+static uint64_t native_time_now_utc(VMContext&, const uint64_t*, uint8_t) {
+    int64_t ms = epoch_ms_now();
+    ObjMap* m = ObjMap::create();
+    native_map_set(m, "epoch_ms", val_int(ms));
+    native_map_set(m, "iso", native_str_val(format_time(static_cast<std::time_t>(ms / 1000), "%Y-%m-%dT%H:%M:%SZ", true)));
+    return val_map(m);
+}
+static uint64_t native_time_now_local(VMContext&, const uint64_t*, uint8_t) {
+    int64_t ms = epoch_ms_now();
+    ObjMap* m = ObjMap::create();
+    native_map_set(m, "epoch_ms", val_int(ms));
+    native_map_set(m, "iso", native_str_val(format_time(static_cast<std::time_t>(ms / 1000), "%Y-%m-%dT%H:%M:%S", false)));
+    native_map_set(m, "tz_offset_min", val_int(tz_offset_minutes()));
+    return val_map(m);
+}
+static uint64_t native_time_format(VMContext&, const uint64_t* args, uint8_t argc) {
+    if (argc < 2) throw std::runtime_error("time.format() expects (epoch_ms, fmt, utc?)");
+    int64_t ms = static_cast<int64_t>(native_long(args[0]));
+    std::string tmp;
+    std::string fmt(native_string(args[1], tmp));
+    bool utc = argc >= 3 ? native_bool(args[2]) : true;
+    return native_str_val(format_time(static_cast<std::time_t>(ms / 1000), fmt, utc));
+}
+static uint64_t native_time_parse(VMContext&, const uint64_t* args, uint8_t argc) {
+    if (argc < 2) throw std::runtime_error("time.parse() expects (text, fmt, utc?)");
+    std::string tmp;
+    std::string text(native_string(args[0], tmp));
+    std::string fmt(native_string(args[1], tmp));
+    bool utc = argc >= 3 ? native_bool(args[2]) : true;
+    return val_int(parse_time(text, fmt, utc));
+}
+static uint64_t native_time_sleep_ms(VMContext&, const uint64_t* args, uint8_t argc) {
+    long ms = native_long(native_arg(args, argc, 0));
+    if (ms < 0) ms = 0;
+    thread_isolates::BlockingWait parked;
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    return VAL_NONE;
+}
+static uint64_t native_time_epoch_ms(VMContext&, const uint64_t*, uint8_t) {
+    return val_int(epoch_ms_now());
+}
+
+const NativeEntry natives[] = {
+    {"now_utc", native_time_now_utc}, {"now_local", native_time_now_local},
+    {"format", native_time_format}, {"parse", native_time_parse},
+    {"sleep_ms", native_time_sleep_ms}, {"epoch_ms", native_time_epoch_ms},
+};
+
 Value create_time_module() {
     Value m(ObjectType::MAP);
     m.data.map["now_utc"] = make_builtin("now_utc", "time_now_utc", {});
@@ -19406,6 +21904,297 @@ enum class LogLevel { DEBUG = 0, INFO = 1, WARN = 2, ERR = 3 };
 static LogLevel g_level = LogLevel::INFO;
 static bool g_json = true;
 static std::unique_ptr<std::ofstream> g_log_file;
+static std::string g_output_path;  // Empty for stdout
+static std::mutex g_sync_write;    // Guards g_log_file and std::cout on the synchronous path
+
+// log.set_sample(level, rate): keep that fraction of a level's records,
+// evenly spread (rate 0.25 keeps every 4th), before any formatting happens
+static std::atomic<uint32_t> g_sample_ppm[4] = {{1000000}, {1000000}, {1000000}, {1000000}};
+static std::atomic<uint64_t> g_sample_seen[4];
+static std::atomic<uint64_t> g_sampled_out{0};
+
+static bool sampled_in(LogLevel level) {
+    int i = static_cast<int>(level);
+    uint64_t ppm = g_sample_ppm[i].load(std::memory_order_relaxed);
+    if (ppm >= 1000000) return true;
+    uint64_t n = g_sample_seen[i].fetch_add(1, std::memory_order_relaxed);
+    if ((n + 1) * ppm / 1000000 > n * ppm / 1000000) return true;
+    g_sampled_out.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+// log.set_async(): callers only format a record and claim a slot in a
+// bounded ring (Vyukov-style per-slot sequence numbers, so producers never
+// take a lock); a writer thread wakes every flush_ms, or when the ring is
+// half full, and writes whole batches with one writev. Whoever holds the
+// `draining` flag owns the consumer side: the writer, a flush()ing caller,
+// or a producer that found the ring full under the "block" policy.
+struct AsyncLog {
+    struct Slot {
+        std::atomic<size_t> seq{0};
+        std::string record;
+    };
+    static constexpr size_t BATCH = 256;
+
+    std::unique_ptr<Slot[]> ring;
+    size_t mask = 0;
+    std::atomic<size_t> head{0};  // Next slot a producer claims
+    std::atomic<size_t> tail{0};  // Next slot to write (advanced under `draining`)
+    std::atomic<bool> draining{false};
+    std::atomic<bool> stop{false};
+    bool drop_when_full = false;
+    int flush_ms = 100;
+    int fd = 1;
+    std::vector<std::string> batch;
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+    std::thread writer;
+    std::atomic<uint64_t> written{0};
+    std::atomic<uint64_t> dropped{0};
+};
+// Callers reach the running logger through AsyncUse. stop_async() swaps it
+// out, waits for g_async_users to drain, joins the writer and frees it.
+static std::atomic<AsyncLog*> g_async{nullptr};
+static std::atomic<int> g_async_users{0};
+static std::mutex g_async_control;  // Held by whoever starts or stops the logger
+
+// Pins the running logger (or nullptr) for one call. The count is raised
+// before the pointer is read, so stop_async() either sees this caller and
+// waits for it, or swapped g_async first and this caller reads nullptr.
+struct AsyncUse {
+    AsyncLog* log;
+    AsyncUse() {
+        g_async_users.fetch_add(1);
+        log = g_async.load();
+    }
+    ~AsyncUse() { g_async_users.fetch_sub(1); }
+    AsyncUse(const AsyncUse&) = delete;
+    AsyncUse& operator=(const AsyncUse&) = delete;
+};
+
+static void write_fully(int fd, const char* data, size_t len) {
+    while (len > 0) {
+#ifdef _WIN32
+        int n = _write(fd, data, static_cast<unsigned int>(len));
+#else
+        ssize_t n = write(fd, data, len);
+        if (n < 0 && errno == EINTR) continue;
+#endif
+        if (n <= 0) return;
+        data += n;
+        len -= static_cast<size_t>(n);
+    }
+}
+
+static void write_batch(int fd, const std::vector<std::string>& records) {
+#ifdef _WIN32
+    std::string joined;
+    for (const std::string& r : records) joined += r;
+    write_fully(fd, joined.data(), joined.size());
+#else
+    struct iovec iov[AsyncLog::BATCH];
+    size_t count = 0;
+    for (const std::string& r : records) {
+        iov[count].iov_base = const_cast<char*>(r.data());
+        iov[count].iov_len = r.size();
+        count++;
+    }
+    size_t first = 0;
+    while (first < count) {
+        ssize_t n = writev(fd, iov + first, static_cast<int>(count - first));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return;
+        // Skip what was written; a partial record continues mid-buffer
+        size_t left = static_cast<size_t>(n);
+        while (first < count && left >= iov[first].iov_len) left -= iov[first++].iov_len;
+        if (first < count) {
+            iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + left;
+            iov[first].iov_len -= left;
+        }
+    }
+#endif
+}
+
+static bool try_push(AsyncLog& a, std::string& record) {
+    size_t pos = a.head.load(std::memory_order_relaxed);
+    for (;;) {
+        AsyncLog::Slot& slot = a.ring[pos & a.mask];
+        size_t seq = slot.seq.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (a.head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.record = std::move(record);
+                slot.seq.store(pos + 1, std::memory_order_release);
+                if (pos + 1 - a.tail.load(std::memory_order_relaxed) > a.mask / 2) a.wake.notify_one();
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;  // Full
+        } else {
+            pos = a.head.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+// Caller holds `draining`
+static void drain_ring(AsyncLog& a) {
+    for (;;) {
+        size_t tail = a.tail.load(std::memory_order_relaxed);
+        while (a.batch.size() < AsyncLog::BATCH) {
+            AsyncLog::Slot& slot = a.ring[tail & a.mask];
+            if (slot.seq.load(std::memory_order_acquire) != tail + 1) break;
+            a.batch.push_back(std::move(slot.record));
+            slot.seq.store(tail + a.mask + 1, std::memory_order_release);
+            tail++;
+        }
+        a.tail.store(tail, std::memory_order_relaxed);
+        if (a.batch.empty()) return;
+        write_batch(a.fd, a.batch);
+        a.written.fetch_add(a.batch.size(), std::memory_order_relaxed);
+        a.batch.clear();
+    }
+}
+
+static bool try_lock_drain(AsyncLog& a) { return !a.draining.exchange(true, std::memory_order_acquire); }
+static void unlock_drain(AsyncLog& a) { a.draining.store(false, std::memory_order_release); }
+
+static void flush_async(AsyncLog& a) {
+    while (!try_lock_drain(a)) std::this_thread::yield();
+    drain_ring(a);
+    unlock_drain(a);
+}
+
+static void enqueue_async(AsyncLog& a, std::string record) {
+    while (!try_push(a, record)) {
+        if (a.drop_when_full) {
+            a.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        // Block: write a backlog ourselves rather than wait for the writer
+        if (try_lock_drain(a)) {
+            drain_ring(a);
+            unlock_drain(a);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+static void writer_loop(AsyncLog* a) {
+    while (!a->stop.load(std::memory_order_acquire)) {
+        {
+            std::unique_lock<std::mutex> lock(a->wake_mutex);
+            a->wake.wait_for(lock, std::chrono::milliseconds(a->flush_ms));
+        }
+        if (try_lock_drain(*a)) {
+            drain_ring(*a);
+            unlock_drain(*a);
+        }
+    }
+}
+
+// Caller holds g_async_control
+static void stop_async() {
+    AsyncLog* a = g_async.exchange(nullptr);  // New records take the synchronous path from here on
+    if (!a) return;
+    // A caller that pinned the logger before the swap may still be queueing;
+    // the writer keeps draining until it is done
+    while (g_async_users.load() != 0) std::this_thread::yield();
+    a->stop.store(true, std::memory_order_release);
+    a->wake.notify_one();
+    if (a->writer.joinable()) a->writer.join();
+    flush_async(*a);
+    if (a->fd != 1) {
+#ifdef _WIN32
+        _close(a->fd);
+#else
+        close(a->fd);
+#endif
+    }
+    delete a;
+}
+
+#ifndef _WIN32
+static const int CRASH_SIGNALS[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+static struct sigaction g_prev_crash_actions[sizeof(CRASH_SIGNALS) / sizeof(CRASH_SIGNALS[0])];
+
+// Writes what is still queued without allocating or freeing, then hands
+// the signal to whatever handled it before. Best effort: if the drain lock
+// is still held after the wait (a writer stuck mid-batch, or the crash hit
+// the thread holding it), the records already moved into that holder's
+// `batch` are lost, and slots it is moving concurrently may come out torn.
+static void on_crash_signal(int sig) {
+    g_async_users.fetch_add(1);  // Keeps a concurrent stop_async() from freeing the logger
+    if (AsyncLog* a = g_async.load()) {
+        // The writer may be mid-batch; give it a moment, but not forever in
+        // case the crash happened on that thread
+        bool locked = false;
+        for (int i = 0; i < 1000 && !(locked = try_lock_drain(*a)); i++) sched_yield();
+        size_t tail = a->tail.load(std::memory_order_relaxed);
+        for (;;) {
+            AsyncLog::Slot& slot = a->ring[tail & a->mask];
+            if (slot.seq.load(std::memory_order_acquire) != tail + 1) break;
+            write_fully(a->fd, slot.record.data(), slot.record.size());
+            tail++;
+        }
+        a->tail.store(tail, std::memory_order_relaxed);
+        if (locked) unlock_drain(*a);
+    }
+    g_async_users.fetch_sub(1);
+    for (size_t i = 0; i < sizeof(CRASH_SIGNALS) / sizeof(CRASH_SIGNALS[0]); i++) {
+        if (CRASH_SIGNALS[i] == sig) sigaction(sig, &g_prev_crash_actions[i], nullptr);
+    }
+    raise(sig);
+}
+#endif
+
+// Caller holds g_async_control
+static void start_async(size_t capacity, int flush_ms, bool drop_when_full) {
+    static bool hooks_installed = false;
+    if (!hooks_installed) {
+        hooks_installed = true;
+        // os.exit() and normal exits flush the ring
+        std::atexit([] {
+            std::lock_guard<std::mutex> lock(g_async_control);
+            stop_async();
+        });
+#ifndef _WIN32
+        struct sigaction sa {};
+        sa.sa_handler = on_crash_signal;
+        sigemptyset(&sa.sa_mask);
+        for (size_t i = 0; i < sizeof(CRASH_SIGNALS) / sizeof(CRASH_SIGNALS[0]); i++) {
+            sigaction(CRASH_SIGNALS[i], &sa, &g_prev_crash_actions[i]);
+        }
+#endif
+    }
+    int fd = 1;
+    if (!g_output_path.empty()) {
+#ifdef _WIN32
+        fd = _open(g_output_path.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+        fd = open(g_output_path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+#endif
+        if (fd < 0) throw std::runtime_error("log.set_async() cannot open " + g_output_path);
+    }
+    size_t size = 16;
+    while (size < capacity) size <<= 1;
+    AsyncLog* a = new AsyncLog();
+    a->ring.reset(new AsyncLog::Slot[size]);
+    for (size_t i = 0; i < size; i++) a->ring[i].seq.store(i, std::memory_order_relaxed);
+    a->mask = size - 1;
+    a->flush_ms = flush_ms;
+    a->drop_when_full = drop_when_full;
+    a->fd = fd;
+    a->batch.reserve(AsyncLog::BATCH);
+    // Anything the synchronous path buffered goes out first
+    {
+        std::lock_guard<std::mutex> lock(g_sync_write);
+        if (g_log_file) g_log_file->flush();
+        std::cout.flush();
+    }
+    a->writer = std::thread(writer_loop, a);
+    g_async.store(a);
+}
 
 static LogLevel parse_level(const std::string& s) {
     std::string l = s;
@@ -19417,7 +22206,7 @@ static LogLevel parse_level(const std::string& s) {
     return LogLevel::INFO;
 }
 
-static std::string json_escape(const std::string& s) {
+static std::string json_escape(std::string_view s) {
     std::string out;
     out.reserve(s.size() + 8);
     for (char c : s) {
@@ -19442,41 +22231,65 @@ static std::string value_json(const Value& v) {
     return "\"" + json_escape(v.to_string()) + "\"";
 }
 
-static void emit_log(LogLevel level, const std::string& message, const Value* fields) {
-    if (static_cast<int>(level) < static_cast<int>(g_level)) return;
+static bool should_emit(LogLevel level) {
+    return static_cast<int>(level) >= static_cast<int>(g_level) && sampled_in(level);
+}
+
+static const char* level_name(LogLevel level, bool json) {
+    switch (level) {
+        case LogLevel::DEBUG: return json ? "debug" : "DEBUG";
+        case LogLevel::INFO: return json ? "info" : "INFO";
+        case LogLevel::WARN: return json ? "warn" : "WARN";
+        case LogLevel::ERR: return json ? "error" : "ERROR";
+    }
+    return "";
+}
+
+// Formats and writes one record that passed should_emit(). write_fields(oss)
+// appends the fields part in the current format, or nothing.
+template <typename WriteFields>
+static void write_record(LogLevel level, std::string_view message, WriteFields&& write_fields) {
     int64_t ms = time_bindings::epoch_ms_now();
     std::string ts = time_bindings::format_time(static_cast<std::time_t>(ms / 1000), "%Y-%m-%dT%H:%M:%S", false);
     std::ostringstream oss;
     if (g_json) {
-        oss << "{\"ts\":\"" << json_escape(ts) << "\",\"level\":\"";
-        switch (level) {
-            case LogLevel::DEBUG: oss << "debug"; break;
-            case LogLevel::INFO: oss << "info"; break;
-            case LogLevel::WARN: oss << "warn"; break;
-            case LogLevel::ERR: oss << "error"; break;
-        }
+        oss << "{\"ts\":\"" << json_escape(ts) << "\",\"level\":\"" << level_name(level, true);
         oss << "\",\"msg\":\"" << json_escape(message) << "\"";
-        if (fields && fields->type == ObjectType::MAP) {
-            oss << ",\"fields\":{";
-            bool first = true;
-            for (const auto& kv : fields->data.map) {
-                if (!first) oss << ",";
-                first = false;
+        write_fields(oss);
+        oss << "}\n";
+    } else {
+        oss << "[" << ts << "] " << level_name(level, false) << ": " << message;
+        write_fields(oss);
+        oss << "\n";
+    }
+    AsyncUse use;
+    if (AsyncLog* a = use.log) {
+        enqueue_async(*a, oss.str());
+        return;
+    }
+    std::lock_guard<std::mutex> lock(g_sync_write);
+    if (g_log_file && g_log_file->is_open()) {
+        (*g_log_file) << oss.str();
+        g_log_file->flush();
+    } else {
+        std::cout << oss.str();
+    }
+}
+
+static void emit_log(LogLevel level, const std::string& message, const Value* fields) {
+    if (!should_emit(level)) return;
+    write_record(level, message, [fields](std::ostringstream& oss) {
+        if (!fields || fields->type != ObjectType::MAP) return;
+        if (g_json) {
+            oss << ",\"fields\":{";
+            bool first = true;
+            for (const auto& kv : fields->data.map) {
+                if (!first) oss << ",";
+                first = false;
                 oss << "\"" << json_escape(kv.first) << "\":" << value_json(kv.second);
             }
             oss << "}";
-        }
-        oss << "}\n";
-    } else {
-        oss << "[" << ts << "] ";
-        switch (level) {
-            case LogLevel::DEBUG: oss << "DEBUG"; break;
-            case LogLevel::INFO: oss << "INFO"; break;
-            case LogLevel::WARN: oss << "WARN"; break;
-            case LogLevel::ERR: oss << "ERROR"; break;
-        }
-        oss << ": " << message;
-        if (fields && fields->type == ObjectType::MAP && !fields->data.map.empty()) {
+        } else if (!fields->data.map.empty()) {
             oss << " {";
             bool first = true;
             for (const auto& kv : fields->data.map) {
@@ -19486,14 +22299,7 @@ static void emit_log(LogLevel level, const std::string& message, const Value* fi
             }
             oss << "}";
         }
-        oss << "\n";
-    }
-    if (g_log_file && g_log_file->is_open()) {
-        (*g_log_file) << oss.str();
-        g_log_file->flush();
-    } else {
-        std::cout << oss.str();
-    }
+    });
 }
 
 Value builtin_log_set_level(const std::vector<Value>& args) {
@@ -19502,14 +22308,72 @@ Value builtin_log_set_level(const std::vector<Value>& args) {
 }
 Value builtin_log_set_output(const std::vector<Value>& args) {
     std::string path = to_string(args.at(0));
-    if (path == "stdout") {
-        g_log_file.reset();
-        return Value(true);
+    // An async logger is restarted on the new output once its queue is written
+    std::lock_guard<std::mutex> lock(g_async_control);
+    AsyncLog* running = g_async.load();
+    size_t capacity = running ? running->mask + 1 : 0;
+    int flush_ms = running ? running->flush_ms : 0;
+    bool drop_when_full = running && running->drop_when_full;
+    if (running) stop_async();
+    {
+        std::lock_guard<std::mutex> write_lock(g_sync_write);
+        if (path == "stdout") {
+            g_log_file.reset();
+            g_output_path.clear();
+        } else {
+            g_log_file = std::make_unique<std::ofstream>(path, std::ios::app);
+            if (!g_log_file->is_open()) throw std::runtime_error("log.set_output() cannot open file");
+            g_output_path = path;
+        }
     }
-    g_log_file = std::make_unique<std::ofstream>(path, std::ios::app);
-    if (!g_log_file->is_open()) throw std::runtime_error("log.set_output() cannot open file");
+    if (running) start_async(capacity, flush_ms, drop_when_full);
+    return Value(true);
+}
+// log.set_async(enabled, {flush_ms: 100, capacity: 8192, overflow: "block"|"drop"})
+Value builtin_log_set_async(const std::vector<Value>& args) {
+    if (args.empty()) throw std::runtime_error("log.set_async() expects (enabled, options?)");
+    size_t capacity = 8192;
+    int flush_ms = 100;
+    bool drop_when_full = false;
+    if (args.size() >= 2 && args[1].type == ObjectType::MAP) {
+        const auto& opts = args[1].data.map;
+        auto it = opts.find("capacity");
+        if (it != opts.end()) capacity = static_cast<size_t>(std::max(1L, to_long(it->second)));
+        it = opts.find("flush_ms");
+        if (it != opts.end()) flush_ms = static_cast<int>(std::max(1L, to_long(it->second)));
+        it = opts.find("overflow");
+        if (it != opts.end()) {
+            std::string policy = to_string(it->second);
+            if (policy == "drop") drop_when_full = true;
+            else if (policy != "block") throw std::runtime_error("log.set_async() overflow must be \"block\" or \"drop\"");
+        }
+    }
+    std::lock_guard<std::mutex> lock(g_async_control);
+    stop_async();
+    if (to_bool(args[0])) start_async(capacity, flush_ms, drop_when_full);
+    return Value(true);
+}
+// log.set_sample(level, rate): keep a fraction (0..1) of that level's records
+Value builtin_log_set_sample(const std::vector<Value>& args) {
+    if (args.size() < 2) throw std::runtime_error("log.set_sample() expects (level, rate)");
+    double rate = args[1].type == ObjectType::FLOAT ? args[1].data.floating : static_cast<double>(to_long(args[1]));
+    rate = std::min(1.0, std::max(0.0, rate));
+    int i = static_cast<int>(parse_level(to_string(args[0])));
+    g_sample_ppm[i].store(static_cast<uint32_t>(rate * 1000000 + 0.5), std::memory_order_relaxed);
     return Value(true);
 }
+Value builtin_log_stats(const std::vector<Value>&) {
+    AsyncUse use;
+    AsyncLog* a = use.log;
+    Value m(ObjectType::MAP);
+    m.data.map["async"] = Value(a != nullptr);
+    long queued = a ? static_cast<long>(a->head.load() - a->tail.load()) : 0;
+    m.data.map["queued"] = Value(queued);
+    m.data.map["written"] = Value(a ? static_cast<long>(a->written.load()) : 0L);
+    m.data.map["dropped"] = Value(a ? static_cast<long>(a->dropped.load()) : 0L);
+    m.data.map["sampled_out"] = Value(static_cast<long>(g_sampled_out.load()));
+    return m;
+}
 Value builtin_log_set_json(const std::vector<Value>& args) {
     g_json = to_bool(args.at(0));
     return Value(true);
@@ -19526,7 +22390,23 @@ Value builtin_log_debug(const std::vector<Value>& args) { emit_log(LogLevel::DEB
 Value builtin_log_info(const std::vector<Value>& args) { emit_log(LogLevel::INFO, to_string(args.at(0)), args.size() >= 2 ? &args.at(1) : nullptr); return Value(); }
 Value builtin_log_warn(const std::vector<Value>& args) { emit_log(LogLevel::WARN, to_string(args.at(0)), args.size() >= 2 ? &args.at(1) : nullptr); return Value(); }
 Value builtin_log_error(const std::vector<Value>& args) { emit_log(LogLevel::ERR, to_string(args.at(0)), args.size() >= 2 ? &args.at(1) : nullptr); return Value(); }
-Value builtin_log_flush(const std::vector<Value>&) { if (g_log_file) g_log_file->flush(); return Value(true); }
+Value builtin_log_flush(const std::vector<Value>&) {
+    {
+        AsyncUse use;
+        if (AsyncLog* a = use.log) flush_async(*a);
+    }
+    std::lock_guard<std::mutex> lock(g_sync_write);
+    if (g_log_file) g_log_file->flush();
+    return Value(true);
+}
+
+// The record calls are defined after FastVM, so nested field values render
+// as they do on the Value path. The setters, flush and stats stay there;
+// they run once, not per record.
+const NativeEntry natives[] = {
+    {"log", native_log_log}, {"debug", native_log_debug}, {"info", native_log_info},
+    {"warn", native_log_warn}, {"error", native_log_error},
+};
 
 Value create_log_module() {
     Value m(ObjectType::MAP);
@@ -19539,6 +22419,9 @@ Value create_log_module() {
     m.data.map["warn"] = make_builtin("warn", "log_warn", {"message", "fields"});
     m.data.map["error"] = make_builtin("error", "log_error", {"message", "fields"});
     m.data.map["flush"] = make_builtin("flush", "log_flush", {});
+    m.data.map["set_async"] = make_builtin("set_async", "log_set_async", {"enabled", "options"});
+    m.data.map["set_sample"] = make_builtin("set_sample", "log_set_sample", {"level", "rate"});
+    m.data.map["stats"] = make_builtin("stats", "log_stats", {});
     return m;
 }
 } // namespace log_bindings
@@ -19555,8 +22438,8 @@ static std::string trim_env(const std::string& s) {
     return s.substr(start, end - start);
 }
 
-Value builtin_config_load_env(const std::vector<Value>& args) {
-    std::string path = args.empty() ? ".env" : to_string(args.at(0));
+// Reads KEY=value lines (blank lines, # comments and "quotes" allowed)
+static void load_env_file(const std::string& path) {
     std::ifstream in(path);
     if (!in) throw std::runtime_error("config.load_env() cannot open file");
     std::string line;
@@ -19572,6 +22455,10 @@ Value builtin_config_load_env(const std::vector<Value>& args) {
         }
         g_config[key] = val;
     }
+}
+
+Value builtin_config_load_env(const std::vector<Value>& args) {
+    load_env_file(args.empty() ? ".env" : to_string(args.at(0)));
     return Value(true);
 }
 
@@ -19633,6 +22520,75 @@ Value builtin_config_has(const std::vector<Value>& args) {
     return Value(g_config.find(key) != g_config.end());
 }
 
+// config.get()'s answer for the key in args[0]: the environment, then
+// loaded or set values, then the caller's default, else ""
+static std::string native_config_text(const uint64_t* args, uint8_t argc) {
+    std::string tmp;
+    std::string key(native_string(native_arg(args, argc, 0), tmp));
+    if (const char* env = std::getenv(key.c_str())) return env;
+    auto it = g_config.find(key);
+    if (it != g_config.end()) return it->second;
+    if (argc >= 2) return std::string(native_string(args[1], tmp));
+    return "";
+}
+
+static uint64_t native_config_load_env(VMContext&, const uint64_t* args, uint8_t argc) {
+    std::string tmp;
+    load_env_file(argc == 0 ? std::string(".env") : std::string(native_string(args[0], tmp)));
+    return VAL_TRUE;
+}
+static uint64_t native_config_get(VMContext&, const uint64_t* args, uint8_t argc) {
+    return native_str_val(native_config_text(args, argc));
+}
+static uint64_t native_config_set(VMContext&, const uint64_t* args, uint8_t argc) {
+    std::string tmp;
+    std::string key(native_string(native_arg(args, argc, 0), tmp));
+    g_config[key] = std::string(native_string(native_arg(args, argc, 1), tmp));
+    return VAL_TRUE;
+}
+static uint64_t native_config_get_int(VMContext&, const uint64_t* args, uint8_t argc) {
+    int64_t out = 0;
+    if (!parse_int64_strict(native_config_text(args, argc), out)) {
+        if (argc >= 2) return val_int(native_long(args[1]));
+        throw std::runtime_error("config.get_int() invalid integer");
+    }
+    return val_int(out);
+}
+static uint64_t native_config_get_float(VMContext&, const uint64_t* args, uint8_t argc) {
+    double out = 0.0;
+    if (!parse_double_strict(native_config_text(args, argc), out)) {
+        if (argc >= 2) {
+            if (!is_bool(args[1]) && is_int(args[1])) return val_number(static_cast<double>(as_int(args[1])));
+            if (is_number(args[1])) return args[1];
+            std::string tmp;
+            double def = 0.0;
+            if (parse_double_strict(std::string(native_string(args[1], tmp)), def)) return val_number(def);
+        }
+        throw std::runtime_error("config.get_float() invalid float");
+    }
+    return val_number(out);
+}
+static uint64_t native_config_get_bool(VMContext&, const uint64_t* args, uint8_t argc) {
+    std::string l = native_config_text(args, argc);
+    std::transform(l.begin(), l.end(), l.begin(), ::tolower);
+    if (l == "1" || l == "true" || l == "yes" || l == "on") return VAL_TRUE;
+    if (l == "0" || l == "false" || l == "no" || l == "off") return VAL_FALSE;
+    if (argc >= 2) return native_bool(args[1]) ? VAL_TRUE : VAL_FALSE;
+    throw std::runtime_error("config.get_bool() invalid boolean");
+}
+static uint64_t native_config_has(VMContext&, const uint64_t* args, uint8_t argc) {
+    std::string tmp;
+    std::string key(native_string(native_arg(args, argc, 0), tmp));
+    if (std::getenv(key.c_str())) return VAL_TRUE;
+    return g_config.find(key) != g_config.end() ? VAL_TRUE : VAL_FALSE;
+}
+
+const NativeEntry natives[] = {
+    {"load_env", native_config_load_env}, {"get", native_config_get}, {"set", native_config_set},
+    {"get_int", native_config_get_int}, {"get_float", native_config_get_float},
+    {"get_bool", native_config_get_bool}, {"has", native_config_has},
+};
+
 Value create_config_module() {
     Value m(ObjectType::MAP);
     m.data.map["load_env"] = make_builtin("load_env", "config_load_env", {"path"});
@@ -19781,7 +22737,7 @@ Value create_input_module() {
 namespace url_bindings {
 using namespace native_module_util;
 
-static std::string pct_encode(const std::string& s) {
+static std::string pct_encode(std::string_view s) {
     static const char* hex = "0123456789ABCDEF";
     std::string out;
     for (unsigned char c : s) {
@@ -19794,11 +22750,11 @@ static std::string pct_encode(const std::string& s) {
     }
     return out;
 }
-static std::string pct_decode(const std::string& s) {
+static std::string pct_decode(std::string_view s) {
     std::string out;
     for (size_t i = 0; i < s.size(); ++i) {
         if (s[i] == '%' && i + 2 < s.size()) {
-            int v = std::stoi(s.substr(i + 1, 2), nullptr, 16);
+            int v = std::stoi(std::string(s.substr(i + 1, 2)), nullptr, 16);
             out.push_back(static_cast<char>(v));
             i += 2;
         } else if (s[i] == '+') out.push_back(' ');
@@ -19807,45 +22763,84 @@ static std::string pct_decode(const std::string& s) {
     return out;
 }
 
-Value builtin_url_encode(const std::vector<Value>& args) { return Value(pct_encode(to_string(args.at(0)))); }
-Value builtin_url_decode(const std::vector<Value>& args) { return Value(pct_decode(to_string(args.at(0)))); }
-Value builtin_url_parse(const std::vector<Value>& args) {
-    std::string u = to_string(args.at(0));
-    Value m(ObjectType::MAP);
-    m.data.map["scheme"] = Value("");
-    m.data.map["host"] = Value("");
-    m.data.map["port"] = Value(static_cast<long>(0));
-    m.data.map["path"] = Value("");
-    m.data.map["query"] = Value("");
-    m.data.map["fragment"] = Value("");
+// Pieces of a URL, as views into the text that was split
+struct UrlParts {
+    std::string_view scheme, host, path, query, fragment;
+    long port = 0;
+};
+static UrlParts split_url(std::string_view u) {
+    UrlParts parts;
     size_t p = u.find("://");
     size_t i = 0;
-    if (p != std::string::npos) {
-        m.data.map["scheme"] = Value(u.substr(0, p));
+    if (p != std::string_view::npos) {
+        parts.scheme = u.substr(0, p);
         i = p + 3;
     }
     size_t host_end = u.find_first_of("/?#", i);
-    std::string host_port = u.substr(i, host_end == std::string::npos ? u.size() - i : host_end - i);
+    std::string_view host_port = u.substr(i, host_end == std::string_view::npos ? u.size() - i : host_end - i);
     size_t colon = host_port.rfind(':');
-    if (colon != std::string::npos && colon + 1 < host_port.size()) {
-        m.data.map["host"] = Value(host_port.substr(0, colon));
-        m.data.map["port"] = Value(static_cast<long>(std::strtol(host_port.substr(colon + 1).c_str(), nullptr, 10)));
+    if (colon != std::string_view::npos && colon + 1 < host_port.size()) {
+        parts.host = host_port.substr(0, colon);
+        parts.port = std::strtol(std::string(host_port.substr(colon + 1)).c_str(), nullptr, 10);
     } else {
-        m.data.map["host"] = Value(host_port);
+        parts.host = host_port;
     }
-    if (host_end != std::string::npos) {
+    if (host_end != std::string_view::npos) {
         size_t q = u.find('?', host_end);
         size_t h = u.find('#', host_end);
-        size_t path_end = std::min(q == std::string::npos ? u.size() : q, h == std::string::npos ? u.size() : h);
-        m.data.map["path"] = Value(u.substr(host_end, path_end - host_end));
-        if (q != std::string::npos) {
-            size_t q_end = h == std::string::npos ? u.size() : h;
-            m.data.map["query"] = Value(u.substr(q + 1, q_end - q - 1));
+        size_t path_end = std::min(q == std::string_view::npos ? u.size() : q, h == std::string_view::npos ? u.size() : h);
+        parts.path = u.substr(host_end, path_end - host_end);
+        if (q != std::string_view::npos) {
+            size_t q_end = h == std::string_view::npos ? u.size() : h;
+            parts.query = u.substr(q + 1, q_end - q - 1);
         }
-        if (h != std::string::npos) m.data.map["fragment"] = Value(u.substr(h + 1));
+        if (h != std::string_view::npos) parts.fragment = u.substr(h + 1);
     }
+    return parts;
+}
+
+Value builtin_url_encode(const std::vector<Value>& args) { return Value(pct_encode(to_string(args.at(0)))); }
+Value builtin_url_decode(const std::vector<Value>& args) { return Value(pct_decode(to_string(args.at(0)))); }
+Value builtin_url_parse(const std::vector<Value>& args) {
+    std::string u = to_string(args.at(0));
+    UrlParts parts = split_url(u);
+    Value m(ObjectType::MAP);
+    m.data.map["scheme"] = Value(std::string(parts.scheme));
+    m.data.map["host"] = Value(std::string(parts.host));
+    m.data.map["port"] = Value(parts.port);
+    m.data.map["path"] = Value(std::string(parts.path));
+    m.data.map["query"] = Value(std::string(parts.query));
+    m.data.map["fragment"] = Value(std::string(parts.fragment));
     return m;
 }
+
+static uint64_t native_url_encode(VMContext&, const uint64_t* args, uint8_t argc) {
+    std::string tmp;
+    return native_str_val(pct_encode(native_string(native_arg(args, argc, 0), tmp)));
+}
+static uint64_t native_url_decode(VMContext&, const uint64_t* args, uint8_t argc) {
+    std::string tmp;
+    return native_str_val(pct_decode(native_string(native_arg(args, argc, 0), tmp)));
+}
+// Keys go in in the order the Value path's sorted map has always shown them
+static uint64_t native_url_parse(VMContext&, const uint64_t* args, uint8_t argc) {
+    std::string tmp;
+    UrlParts parts = split_url(native_string(native_arg(args, argc, 0), tmp));
+    ObjMap* m = ObjMap::create();
+    m->data.reserve(6);
+    native_map_set(m, "fragment", native_str_val(parts.fragment.data(), parts.fragment.size()));
+    native_map_set(m, "host", native_str_val(parts.host.data(), parts.host.size()));
+    native_map_set(m, "path", native_str_val(parts.path.data(), parts.path.size()));
+    native_map_set(m, "port", val_int(parts.port));
+    native_map_set(m, "query", native_str_val(parts.query.data(), parts.query.size()));
+    native_map_set(m, "scheme", native_str_val(parts.scheme.data(), parts.scheme.size()));
+    return val_map(m);
+}
+
+const NativeEntry natives[] = {
+    {"parse", native_url_parse}, {"encode", native_url_encode}, {"decode", native_url_decode},
+};
+
 Value create_url_module() {
     Value m(ObjectType::MAP);
     m.data.map["parse"] = make_builtin("parse", "url_parse", {"url"});
@@ -20025,49 +23020,571 @@ public:
     }
 };
 
-static std::string stringify_value(const Value& v) {
-    switch (v.type) {
-        case ObjectType::NONE: return "null";
-        case ObjectType::BOOLEAN: return v.data.boolean ? "true" : "false";
-        case ObjectType::INTEGER: return std::to_string(v.data.integer);
-        case ObjectType::FLOAT: { std::ostringstream ss; ss << v.data.floating; return ss.str(); }
-        case ObjectType::STRING: {
-            std::string out = "\"";
-            for (char c : v.data.string) {
-                if (c == '"' || c == '\\') out.push_back('\\');
-                out.push_back(c);
+// First byte in [p, end) that is '"', '\\' or a control character (or end).
+// These are the only bytes string scanning and escaping have to stop at, so
+// 16 bytes are tested per step where SSE2 or NEON is available.
+static const char* json_scan_plain(const char* p, const char* end) {
+#if defined(__SSE2__) || defined(_M_X64)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i slash = _mm_set1_epi8('\\');
+    const __m128i ctrl = _mm_set1_epi8(0x1F);
+    while (end - p >= 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, quote), _mm_cmpeq_epi8(x, slash)),
+                                   _mm_cmpeq_epi8(_mm_max_epu8(x, ctrl), ctrl));  // x <= 0x1F
+        int mask = _mm_movemask_epi8(hit);
+        if (mask) return p + __builtin_ctz(static_cast<unsigned>(mask));
+        p += 16;
+    }
+#elif defined(__ARM_NEON)
+    const uint8x16_t quote = vdupq_n_u8('"');
+    const uint8x16_t slash = vdupq_n_u8('\\');
+    const uint8x16_t ctrl = vdupq_n_u8(0x20);
+    while (end - p >= 16) {
+        uint8x16_t x = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+        uint8x16_t hit = vorrq_u8(vorrq_u8(vceqq_u8(x, quote), vceqq_u8(x, slash)), vcltq_u8(x, ctrl));
+        if (vmaxvq_u8(hit)) break;  // Locate it in the scalar tail below
+        p += 16;
+    }
+#endif
+    while (p < end) {
+        unsigned char c = static_cast<unsigned char>(*p);
+        if (c == '"' || c == '\\' || c < 0x20) return p;
+        ++p;
+    }
+    return end;
+}
+
+static void append_json_string(std::string& out, const char* s, size_t len) {
+    static const char hex[] = "0123456789abcdef";
+    const char* end = s + len;
+    out.push_back('"');
+    while (s < end) {
+        const char* stop = json_scan_plain(s, end);
+        out.append(s, static_cast<size_t>(stop - s));
+        if (stop == end) break;
+        unsigned char c = static_cast<unsigned char>(*stop);
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            default: {
+                char u[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+                out.append(u, 6);
             }
-            out.push_back('"');
-            return out;
         }
-        case ObjectType::LIST: {
-            std::string out = "[";
+        s = stop + 1;
+    }
+    out.push_back('"');
+}
+
+// Shortest text that reads back as the same double; JSON has no NaN/Infinity
+static void append_json_number(std::string& out, double d) {
+    if (!std::isfinite(d)) {
+        out += "null";
+        return;
+    }
+    char buf[32];
+    auto r = std::to_chars(buf, buf + sizeof(buf), d);
+    out.append(buf, static_cast<size_t>(r.ptr - buf));
+}
+
+static void append_json_int(std::string& out, int64_t n) {
+    char buf[24];
+    auto r = std::to_chars(buf, buf + sizeof(buf), n);
+    out.append(buf, static_cast<size_t>(r.ptr - buf));
+}
+
+static void stringify_value(const Value& v, std::string& out) {
+    switch (v.type) {
+        case ObjectType::NONE: out += "null"; return;
+        case ObjectType::BOOLEAN: out += v.data.boolean ? "true" : "false"; return;
+        case ObjectType::INTEGER: append_json_int(out, v.data.integer); return;
+        case ObjectType::FLOAT: append_json_number(out, v.data.floating); return;
+        case ObjectType::STRING:
+            append_json_string(out, v.data.string.data(), v.data.string.size());
+            return;
+        case ObjectType::LIST:
+            out.push_back('[');
             for (size_t i = 0; i < v.data.list.size(); ++i) {
-                if (i) out += ",";
-                out += stringify_value(v.data.list[i]);
+                if (i) out.push_back(',');
+                stringify_value(v.data.list[i], out);
             }
-            out += "]";
-            return out;
-        }
+            out.push_back(']');
+            return;
         case ObjectType::MAP: {
-            std::string out = "{";
+            out.push_back('{');
             bool first = true;
             for (const auto& kv : v.data.map) {
-                if (!first) out += ",";
+                if (!first) out.push_back(',');
                 first = false;
-                out += stringify_value(Value(kv.first));
-                out += ":";
-                out += stringify_value(kv.second);
+                append_json_string(out, kv.first.data(), kv.first.size());
+                out.push_back(':');
+                stringify_value(kv.second, out);
             }
-            out += "}";
-            return out;
+            out.push_back('}');
+            return;
+        }
+        default: {
+            std::string text = v.to_string();
+            append_json_string(out, text.data(), text.size());
+            return;
+        }
+    }
+}
+
+/**
+ * JSON straight to VM objects
+ * Builds ObjList/ObjMap with interned keys while scanning, with no Value
+ * tree in between. Runs inside a native call, where nothing collects, so
+ * partly built containers need no rooting. Integers outside the VM's 48-bit
+ * range become floats.
+ */
+class VmJsonParser {
+    const char* begin;
+    const char* p;
+    const char* end;
+    std::string scratch;  // Unescaped string contents
+    int depth = 0;
+
+    static constexpr int MAX_DEPTH = 512;
+
+    [[noreturn]] void err(const char* m) const {
+        throw std::runtime_error(std::string("json.parse: ") + m + " at index " + std::to_string(p - begin));
+    }
+    void ws() {
+        while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) ++p;
+    }
+    unsigned hex4() {
+        if (end - p < 4) err("incomplete unicode escape");
+        unsigned value = 0;
+        for (int n = 0; n < 4; ++n) {
+            char c = *p++;
+            value <<= 4;
+            if (c >= '0' && c <= '9') value |= static_cast<unsigned>(c - '0');
+            else if (c >= 'a' && c <= 'f') value |= static_cast<unsigned>(10 + (c - 'a'));
+            else if (c >= 'A' && c <= 'F') value |= static_cast<unsigned>(10 + (c - 'A'));
+            else err("invalid hex in unicode escape");
+        }
+        return value;
+    }
+    static void append_utf8(std::string& out, unsigned cp) {
+        if (cp <= 0x7F) {
+            out.push_back(static_cast<char>(cp));
+        } else if (cp <= 0x7FF) {
+            out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else if (cp <= 0xFFFF) {
+            out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+    }
+
+    // String at p (past the opening quote). Escape-free strings are returned
+    // as a view into the input; others are unescaped into `scratch`.
+    std::string_view string_body() {
+        const char* start = p;
+        const char* stop = json_scan_plain(p, end);
+        if (stop < end && *stop == '"') {
+            p = stop + 1;
+            return std::string_view(start, static_cast<size_t>(stop - start));
+        }
+        scratch.assign(start, static_cast<size_t>(stop - start));
+        p = stop;
+        while (p < end) {
+            char c = *p;
+            if (c == '"') {
+                ++p;
+                return scratch;
+            }
+            if (static_cast<unsigned char>(c) < 0x20) err("control character in string");
+            // c is a backslash
+            if (++p >= end) break;
+            switch (*p++) {
+                case '"': scratch.push_back('"'); break;
+                case '\\': scratch.push_back('\\'); break;
+                case '/': scratch.push_back('/'); break;
+                case 'b': scratch.push_back('\b'); break;
+                case 'f': scratch.push_back('\f'); break;
+                case 'n': scratch.push_back('\n'); break;
+                case 'r': scratch.push_back('\r'); break;
+                case 't': scratch.push_back('\t'); break;
+                case 'u': {
+                    unsigned cp = hex4();
+                    if (cp >= 0xD800 && cp <= 0xDBFF) {
+                        if (end - p < 2 || p[0] != '\\' || p[1] != 'u') err("missing low surrogate");
+                        p += 2;
+                        unsigned low = hex4();
+                        if (low < 0xDC00 || low > 0xDFFF) err("invalid low surrogate");
+                        cp = 0x10000u + (((cp - 0xD800u) << 10) | (low - 0xDC00u));
+                    } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                        err("unexpected low surrogate");
+                    }
+                    append_utf8(scratch, cp);
+                    break;
+                }
+                default: --p; err("invalid escape");
+            }
+            const char* run = json_scan_plain(p, end);
+            scratch.append(p, static_cast<size_t>(run - p));
+            p = run;
+        }
+        err("unterminated string");
+    }
+
+    uint64_t number() {
+        const char* start = p;
+        if (p < end && *p == '-') ++p;
+        if (p < end && *p == '0') {
+            ++p;
+            if (p < end && *p >= '0' && *p <= '9') err("leading zero");
+        } else {
+            if (p >= end || *p < '0' || *p > '9') err("expected digit");
+            while (p < end && *p >= '0' && *p <= '9') ++p;
+        }
+        bool is_float = false;
+        if (p < end && *p == '.') {
+            is_float = true;
+            ++p;
+            if (p >= end || *p < '0' || *p > '9') err("missing fraction digits");
+            while (p < end && *p >= '0' && *p <= '9') ++p;
+        }
+        if (p < end && (*p == 'e' || *p == 'E')) {
+            is_float = true;
+            ++p;
+            if (p < end && (*p == '+' || *p == '-')) ++p;
+            if (p >= end || *p < '0' || *p > '9') err("missing exponent digits");
+            while (p < end && *p >= '0' && *p <= '9') ++p;
+        }
+        if (!is_float) {
+            int64_t n = 0;
+            auto r = std::from_chars(start, p, n);
+            constexpr int64_t INT_LIMIT = int64_t(1) << 47;
+            if (r.ec == std::errc() && n >= -INT_LIMIT && n < INT_LIMIT) return val_int(n);
+        }
+        // strtod needs a terminator; numbers are short, so copy
+        char buf[64];
+        size_t len = static_cast<size_t>(p - start);
+        if (len < sizeof(buf)) {
+            std::memcpy(buf, start, len);
+            buf[len] = '\0';
+            return val_number(std::strtod(buf, nullptr));
+        }
+        return val_number(std::strtod(std::string(start, len).c_str(), nullptr));
+    }
+
+    bool literal(const char* word, size_t len) {
+        if (static_cast<size_t>(end - p) >= len && std::memcmp(p, word, len) == 0) {
+            p += len;
+            return true;
+        }
+        return false;
+    }
+
+public:
+    VmJsonParser(const char* data, size_t len) : begin(data), p(data), end(data + len) {}
+
+    uint64_t value() {
+        ws();
+        if (p >= end) err("unexpected end of input");
+        switch (*p) {
+            case '"': {
+                ++p;
+                std::string_view sv = string_body();
+                return native_str_val(sv.data(), sv.size());
+            }
+            case '[': {
+                if (++depth > MAX_DEPTH) err("nesting too deep");
+                ++p;
+                ObjList* list = ObjList::create();
+                ws();
+                if (p < end && *p == ']') {
+                    ++p;
+                } else {
+                    while (true) {
+                        list->push(value());
+                        ws();
+                        if (p < end && *p == ',') { ++p; continue; }
+                        if (p < end && *p == ']') { ++p; break; }
+                        err("expected ',' in array");
+                    }
+                }
+                --depth;
+                return val_list(list);
+            }
+            case '{': {
+                if (++depth > MAX_DEPTH) err("nesting too deep");
+                ++p;
+                ObjMap* map = ObjMap::create();
+                ws();
+                if (p < end && *p == '}') {
+                    ++p;
+                } else {
+                    while (true) {
+                        ws();
+                        if (p >= end || *p != '"') err("expected string");
+                        ++p;
+                        std::string_view key = string_body();
+                        ObjString* k = g_strings.intern(key.data(), key.size());
+                        ws();
+                        if (p >= end || *p != ':') err("expected ':'");
+                        ++p;
+                        map->data[k] = value();
+                        ws();
+                        if (p < end && *p == ',') { ++p; continue; }
+                        if (p < end && *p == '}') { ++p; break; }
+                        err("expected ',' in object");
+                    }
+                }
+                --depth;
+                return val_map(map);
+            }
+            case 't': if (literal("true", 4)) return VAL_TRUE; break;
+            case 'f': if (literal("false", 5)) return VAL_FALSE; break;
+            case 'n': if (literal("null", 4)) return VAL_NONE; break;
+            default:
+                if (*p == '-' || (*p >= '0' && *p <= '9')) return number();
+        }
+        err("invalid token");
+    }
+
+    uint64_t parse() {
+        uint64_t v = value();
+        ws();
+        if (p != end) err("trailing characters");
+        return v;
+    }
+
+    // On-demand lookup: skip to the value at `path` (keys and list indices)
+    // without building anything else. False if the path does not exist.
+    bool seek(const std::vector<std::string_view>& keys, const std::vector<long>& indices,
+              const std::vector<bool>& is_index) {
+        for (size_t step = 0; step < is_index.size(); ++step) {
+            ws();
+            if (p >= end) err("unexpected end of input");
+            if (is_index[step]) {
+                if (*p != '[') return false;
+                ++p;
+                ws();
+                if (p < end && *p == ']') return false;
+                for (long i = 0;; ++i) {
+                    if (i == indices[step]) break;
+                    skip();
+                    ws();
+                    if (p < end && *p == ',') { ++p; continue; }
+                    if (p < end && *p == ']') return false;
+                    err("expected ',' in array");
+                }
+            } else {
+                if (*p != '{') return false;
+                ++p;
+                ws();
+                if (p < end && *p == '}') return false;
+                while (true) {
+                    ws();
+                    if (p >= end || *p != '"') err("expected string");
+                    ++p;
+                    std::string_view key = string_body();
+                    bool match = key == keys[step];
+                    ws();
+                    if (p >= end || *p != ':') err("expected ':'");
+                    ++p;
+                    if (match) break;
+                    skip();
+                    ws();
+                    if (p < end && *p == ',') { ++p; continue; }
+                    if (p < end && *p == '}') return false;
+                    err("expected ',' in object");
+                }
+            }
+        }
+        return true;
+    }
+
+    // Pass over one value, checking structure only
+    void skip() {
+        ws();
+        if (p >= end) err("unexpected end of input");
+        char c = *p;
+        if (c == '"') {
+            ++p;
+            while (true) {
+                const char* stop = json_scan_plain(p, end);
+                if (stop == end) { p = end; err("unterminated string"); }
+                p = stop + 1;
+                if (*stop == '"') return;
+                if (*stop != '\\') { p = stop; err("control character in string"); }
+                if (p >= end) err("unterminated string");
+                ++p;  // Escaped character; \uXXXX digits are plain bytes
+            }
+        }
+        if (c == '[' || c == '{') {
+            // Brackets inside strings are skipped with the strings
+            int nesting = 0;
+            while (p < end) {
+                c = *p;
+                if (c == '"') {
+                    skip();
+                    continue;
+                }
+                ++p;
+                if (c == '[' || c == '{') {
+                    ++nesting;
+                } else if (c == ']' || c == '}') {
+                    if (--nesting == 0) return;
+                }
+            }
+            err("unterminated container");
+        }
+        value();  // Scalars are cheap to build and drop
+    }
+};
+
+Value builtin_json_parse(const std::vector<Value>& args) {
+    std::string text = to_string(args.at(0));  // JsonParser keeps a reference
+    JsonParser p(text);
+    return p.parse();
+}
+Value builtin_json_stringify(const std::vector<Value>& args) {
+    std::string out;
+    stringify_value(args.at(0), out);
+    return Value(std::move(out));
+}
+
+// Zero-copy stringify: walks the VM's lists/maps directly into one buffer
+static void stringify_fast(uint64_t v, std::string& out) {
+    if (v == VAL_NONE) { out += "null"; return; }
+    if (v == VAL_TRUE) { out += "true"; return; }
+    if (v == VAL_FALSE) { out += "false"; return; }
+    if (is_int(v)) { append_json_int(out, as_int(v)); return; }
+    if (is_number(v)) { append_json_number(out, as_number(v)); return; }
+    if (!is_obj(v)) { out += "null"; return; }
+    switch (obj_type(v)) {
+        case ObjType::STRING: {
+            ObjString* s = as_string(v);
+            append_json_string(out, s->chars, s->length);
+            return;
+        }
+        case ObjType::LIST: {
+            ObjList* list = as_list(v);
+            out.push_back('[');
+            for (size_t i = 0; i < list->count; ++i) {
+                if (i) out.push_back(',');
+                stringify_fast(list->items[i], out);
+            }
+            out.push_back(']');
+            return;
+        }
+        case ObjType::MAP: {
+            // Insertion order, straight from the map's entry array
+            ObjMap* map = as_map(v);
+            out.push_back('{');
+            bool first = true;
+            for (const auto& entry : map->data) {
+                if (!first) out.push_back(',');
+                first = false;
+                append_json_string(out, entry.first->chars, entry.first->length);
+                out.push_back(':');
+                stringify_fast(entry.second, out);
+            }
+            out.push_back('}');
+            return;
+        }
+        case ObjType::RANGE:
+            append_json_string(out, "<unknown>", 9);  // Value::to_string() of a range
+            return;
+        case ObjType::TENSOR: {
+            ObjTensor* t = as_tensor(v);
+            stringify_fast(tensor_to_list(t, 0, t->offset), out);
+            return;
+        }
+        default: {
+            std::string text = val_to_string(v);
+            append_json_string(out, text.data(), text.size());
+            return;
+        }
+    }
+}
+static uint64_t native_json_stringify(VMContext& ctx, const uint64_t* args, uint8_t argc) {
+    ctx.scratch.clear();
+    stringify_fast(native_arg(args, argc, 0), ctx.scratch);
+    return native_str_val(ctx.scratch);
+}
+
+static uint64_t native_json_parse(VMContext&, const uint64_t* args, uint8_t argc) {
+    uint64_t text = native_arg(args, argc, 0);
+    std::string tmp;
+    std::string_view src = native_string(text, tmp);
+    VmJsonParser parser(src.data(), src.size());
+    return parser.parse();
+}
+
+// json.get(text, path, default): path is a list of keys and indices or a
+// dotted string ("items.0.name"); only the value it names is built
+static uint64_t native_json_get(VMContext&, const uint64_t* args, uint8_t argc) {
+    std::string text_tmp, path_tmp;
+    std::string_view src = native_string(native_arg(args, argc, 0), text_tmp);
+    uint64_t path = native_arg(args, argc, 1);
+    uint64_t fallback = argc > 2 ? args[2] : VAL_NONE;
+
+    std::vector<std::string_view> keys;
+    std::vector<long> indices;
+    std::vector<bool> is_index;
+    std::vector<std::string> key_tmp;
+    auto add_step = [&](std::string_view part, bool numeric_ok) {
+        long idx = 0;
+        auto r = std::from_chars(part.data(), part.data() + part.size(), idx);
+        bool numeric = numeric_ok && !part.empty() && r.ec == std::errc() &&
+                       r.ptr == part.data() + part.size() && idx >= 0;
+        keys.push_back(part);
+        indices.push_back(numeric ? idx : -1);
+        is_index.push_back(numeric);
+    };
+    if (is_obj(path) && obj_type(path) == ObjType::LIST) {
+        ObjList* list = as_list(path);
+        key_tmp.reserve(list->count);
+        for (size_t i = 0; i < list->count; ++i) {
+            uint64_t step = list->items[i];
+            if (is_int(step) && !is_bool(step)) {
+                keys.emplace_back();
+                indices.push_back(static_cast<long>(as_int(step)));
+                is_index.push_back(true);
+            } else {
+                key_tmp.emplace_back();
+                add_step(native_string(step, key_tmp.back()), false);
+            }
+        }
+    } else {
+        std::string_view dotted = native_string(path, path_tmp);
+        size_t start = 0;
+        while (start <= dotted.size()) {
+            size_t dot = dotted.find('.', start);
+            if (dot == std::string_view::npos) dot = dotted.size();
+            if (dot > start) add_step(dotted.substr(start, dot - start), true);
+            start = dot + 1;
         }
-        default: return stringify_value(Value(v.to_string()));
     }
+
+    VmJsonParser parser(src.data(), src.size());
+    if (!parser.seek(keys, indices, is_index)) return fallback;
+    return parser.value();
 }
 
-Value builtin_json_parse(const std::vector<Value>& args) { JsonParser p(to_string(args.at(0))); return p.parse(); }
-Value builtin_json_stringify(const std::vector<Value>& args) { return Value(stringify_value(args.at(0))); }
+const NativeEntry natives[] = {
+    {"parse", native_json_parse},
+    {"get", native_json_get},
+    {"stringify", native_json_stringify},
+};
 Value create_json_module() {
     Value m(ObjectType::MAP);
     m.data.map["parse"] = make_builtin("parse", "json_parse", {"text"});
@@ -20148,10 +23665,8 @@ Value builtin_net_tcp_connect(const std::vector<Value>& args) {
     if (fd < 0) throw std::runtime_error("net.tcp_connect connect failed");
     return Value(put_fd(fd, false));
 }
-Value builtin_net_tcp_listen(const std::vector<Value>& args) {
-    std::string host = to_string(args.at(0));
-    std::string port = std::to_string(to_long(args.at(1)));
-    int backlog = args.size() >= 3 ? static_cast<int>(to_long(args.at(2))) : 128;
+// Bound, listening TCP socket (IPv4 first, then IPv6), or -1 with errno set
+static int listen_socket(const std::string& host, const std::string& port, int backlog) {
     auto try_listen = [&](int family) -> int {
         addrinfo hints{}, *res = nullptr;
         hints.ai_family = family;
@@ -20189,13 +23704,25 @@ Value builtin_net_tcp_listen(const std::vector<Value>& args) {
 
     int fd = try_listen(AF_INET);
     if (fd < 0) fd = try_listen(AF_INET6);
-    if (fd < 0) {
+    return fd;
+}
+
+static std::string socket_error_text() {
 #ifdef _WIN32
-        throw std::runtime_error("net.tcp_listen bind/listen failed: " + std::to_string(WSAGetLastError()));
+    return std::to_string(WSAGetLastError());
 #else
-        throw std::runtime_error("net.tcp_listen bind/listen failed: " + std::string(strerror(errno)));
+    return strerror(errno);
 #endif
-    }
+}
+
+Value builtin_net_tcp_listen(const std::vector<Value>& args) {
+    std::string host = to_string(args.at(0));
+    std::string port = std::to_string(to_long(args.at(1)));
+    int backlog = args.size() >= 3 ? static_cast<int>(to_long(args.at(2))) : 128;
+    int fd = listen_socket(host, port, backlog);
+    if (fd < 0) {
+        throw std::runtime_error("net.tcp_listen bind/listen failed: " + socket_error_text());
+    }
     return Value(put_fd(fd, false));
 }
 Value builtin_net_tcp_accept(const std::vector<Value>& args) {
@@ -20353,6 +23880,8 @@ Value builtin_net_tcp_close(const std::vector<Value>& args) {
     long sid = to_long(args.at(0));
     int fd = take_fd(sid);
     if (fd >= 0) {
+        // Before the descriptor goes: its number may be reused right away
+        async_bindings::close_socket_tasks(fd);
 #ifdef _WIN32
         closesocket(fd);
 #else
@@ -20430,6 +23959,97 @@ Value builtin_net_dns_lookup(const std::vector<Value>& args) {
     freeaddrinfo(res);
     return out;
 }
+
+// Zero-copy FastVM entry points for the data-moving calls: payloads are sent
+// straight from the VM string or bytes and received into the context's
+// scratch buffer
+static int native_socket(const uint64_t* args, uint8_t argc, const char* err) {
+    int fd = take_fd(native_long(native_arg(args, argc, 0)));
+    if (fd < 0) throw std::runtime_error(err);
+    return fd;
+}
+static int native_recv_into(VMContext& ctx, int fd, const uint64_t* args, uint8_t argc) {
+    int maxb = argc >= 2 ? static_cast<int>(native_long(args[1])) : 4096;
+    ctx.scratch.resize(static_cast<size_t>(maxb));
+    return static_cast<int>(recv(fd, &ctx.scratch[0], maxb, 0));
+}
+static uint64_t native_net_tcp_send(VMContext&, const uint64_t* args, uint8_t argc) {
+    int fd = native_socket(args, argc, "net.tcp_send invalid socket");
+    std::string tmp;
+    std::string_view data = native_string(native_arg(args, argc, 1), tmp);
+    int n = static_cast<int>(send(fd, data.data(), static_cast<int>(data.size()), 0));
+    if (n < 0) throw std::runtime_error("net.tcp_send failed");
+    return val_int(n);
+}
+static uint64_t native_net_tcp_try_send(VMContext&, const uint64_t* args, uint8_t argc) {
+    int fd = native_socket(args, argc, "net.tcp_try_send invalid socket");
+    std::string tmp;
+    std::string_view data = native_string(native_arg(args, argc, 1), tmp);
+    int n = static_cast<int>(send(fd, data.data(), static_cast<int>(data.size()), 0));
+    ObjMap* out = ObjMap::create();
+    native_map_set(out, "ok", n > 0 ? VAL_TRUE : VAL_FALSE);
+    native_map_set(out, "sent", val_int(n > 0 ? n : 0));
+    native_map_set(out, "would_block", VAL_FALSE);
+    native_map_set(out, "error", native_str_val("", 0));
+    if (n > 0) return val_map(out);
+    if (n == 0) {
+        native_map_set(out, "error", native_str_val("send returned 0"));
+    } else if (socket_would_block()) {
+        native_map_set(out, "would_block", VAL_TRUE);
+    } else {
+        native_map_set(out, "error", native_str_val("send failed"));
+    }
+    return val_map(out);
+}
+static uint64_t native_net_tcp_recv(VMContext& ctx, const uint64_t* args, uint8_t argc) {
+    int fd = native_socket(args, argc, "net.tcp_recv invalid socket");
+    int n = native_recv_into(ctx, fd, args, argc);
+    if (n <= 0) return native_str_val("", 0);
+    return native_str_val(ctx.scratch.data(), static_cast<size_t>(n));
+}
+static uint64_t native_net_tcp_recv_bytes(VMContext& ctx, const uint64_t* args, uint8_t argc) {
+    int fd = native_socket(args, argc, "net.tcp_recv_bytes invalid socket");
+    int n = native_recv_into(ctx, fd, args, argc);
+    return native_bytes_val(ctx.scratch.data(), n > 0 ? static_cast<size_t>(n) : 0);
+}
+static uint64_t native_net_tcp_try_recv(VMContext& ctx, const uint64_t* args, uint8_t argc) {
+    int fd = native_socket(args, argc, "net.tcp_try_recv invalid socket");
+    int n = native_recv_into(ctx, fd, args, argc);
+    ObjMap* out = ObjMap::create();
+    native_map_set(out, "ok", n > 0 ? VAL_TRUE : VAL_FALSE);
+    native_map_set(out, "data", n > 0 ? native_str_val(ctx.scratch.data(), static_cast<size_t>(n))
+                                      : native_str_val("", 0));
+    native_map_set(out, "closed", n == 0 ? VAL_TRUE : VAL_FALSE);
+    native_map_set(out, "would_block", VAL_FALSE);
+    native_map_set(out, "error", native_str_val("", 0));
+    if (n < 0) {
+        if (socket_would_block()) native_map_set(out, "would_block", VAL_TRUE);
+        else native_map_set(out, "error", native_str_val("recv failed"));
+    }
+    return val_map(out);
+}
+static uint64_t native_net_udp_sendto(VMContext&, const uint64_t* args, uint8_t argc) {
+    int fd = native_socket(args, argc, "net.udp_sendto invalid socket");
+    std::string host_tmp, data_tmp;
+    std::string host(native_string(native_arg(args, argc, 1), host_tmp));
+    int port = static_cast<int>(native_long(native_arg(args, argc, 2)));
+    std::string_view data = native_string(native_arg(args, argc, 3), data_tmp);
+    sockaddr_in dst{};
+    dst.sin_family = AF_INET;
+    dst.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, host.c_str(), &dst.sin_addr) != 1) throw std::runtime_error("net.udp_sendto invalid ipv4 address");
+    int n = static_cast<int>(sendto(fd, data.data(), static_cast<int>(data.size()), 0, reinterpret_cast<sockaddr*>(&dst), sizeof(dst)));
+    if (n < 0) throw std::runtime_error("net.udp_sendto failed");
+    return val_int(n);
+}
+
+const NativeEntry natives[] = {
+    {"tcp_send", native_net_tcp_send}, {"tcp_try_send", native_net_tcp_try_send},
+    {"tcp_recv", native_net_tcp_recv}, {"tcp_try_recv", native_net_tcp_try_recv},
+    {"tcp_recv_bytes", native_net_tcp_recv_bytes},
+    {"udp_sendto", native_net_udp_sendto},
+};
+
 Value create_net_module() {
     Value m(ObjectType::MAP);
     m.data.map["tcp_connect"] = make_builtin("tcp_connect", "net_tcp_connect", {"host", "port"});
@@ -20451,6 +24071,200 @@ Value create_net_module() {
 }
 } // namespace net_bindings
 
+// ----------------------------------------------------------------------------
+// Cross-thread values: each thread allocates from its own heap, so values
+// move between threads (thread isolates, channels) as packed copies
+// ----------------------------------------------------------------------------
+namespace thread_isolates {
+
+// Thread-neutral copy of a value, unpacked into the receiving thread's heap
+struct Transfer {
+    enum class Kind : uint8_t { IMMEDIATE, SHARED, STRING, LIST, MAP, RANGE, FUNCTION, NATIVE, INSTANCE, TENSOR, BYTES };
+    Kind kind = Kind::IMMEDIATE;
+    uint64_t bits = VAL_NONE;     // IMMEDIATE value or SHARED object
+    std::string text;             // STRING/BYTES contents, FUNCTION/NATIVE name, TENSOR elements
+    Chunk* chunk = nullptr;       // FUNCTION
+    uint8_t arity = 0;
+    NativeFn fn = nullptr;        // NATIVE
+    LegacyNativeFn legacy = nullptr;
+    ObjClass* klass = nullptr;    // INSTANCE
+    int64_t range[3] = {0, 0, 0};
+    std::vector<int64_t> shape;   // TENSOR dims; range[0] holds the dtype
+    std::vector<Transfer> items;  // LIST items; MAP/INSTANCE key, value pairs
+};
+
+static constexpr int MAX_COPY_DEPTH = 64;
+
+// Compile-time objects of immutable kinds; the main heap never frees these
+static bool shareable(const Obj* o) {
+    if (o->heap != GCHeap::MAIN_PERMANENT) return false;
+    return o->type == ObjType::STRING || o->type == ObjType::FUNCTION || o->type == ObjType::CLASS;
+}
+
+static void pack_key(ObjString* key, Transfer& out) {
+    out.kind = Transfer::Kind::STRING;
+    out.text.assign(key->chars, key->length);
+}
+
+static void pack(uint64_t v, Transfer& out, int depth = 0) {
+    if (!is_obj(v)) {
+        out.kind = Transfer::Kind::IMMEDIATE;
+        out.bits = v;
+        return;
+    }
+    Obj* o = as_obj(v);
+    if (shareable(o)) {
+        out.kind = Transfer::Kind::SHARED;
+        out.bits = v;
+        return;
+    }
+    if (depth >= MAX_COPY_DEPTH) throw std::runtime_error("thread: value is nested too deeply to copy between threads");
+    switch (o->type) {
+        case ObjType::STRING: {
+            ObjString* s = static_cast<ObjString*>(o);
+            out.kind = Transfer::Kind::STRING;
+            out.text.assign(s->chars, s->length);
+            return;
+        }
+        case ObjType::LIST: {
+            ObjList* l = static_cast<ObjList*>(o);
+            out.kind = Transfer::Kind::LIST;
+            out.items.resize(l->count);
+            for (size_t i = 0; i < l->count; ++i) pack(l->items[i], out.items[i], depth + 1);
+            return;
+        }
+        case ObjType::MAP: {
+            ObjMap* m = static_cast<ObjMap*>(o);
+            out.kind = Transfer::Kind::MAP;
+            out.items.resize(m->data.size() * 2);
+            size_t i = 0;
+            for (const auto& kv : m->data) {
+                pack_key(kv.first, out.items[i++]);
+                pack(kv.second, out.items[i++], depth + 1);
+            }
+            return;
+        }
+        case ObjType::RANGE: {
+            ObjRange* r = static_cast<ObjRange*>(o);
+            out.kind = Transfer::Kind::RANGE;
+            out.range[0] = r->start;
+            out.range[1] = r->stop;
+            out.range[2] = r->step;
+            return;
+        }
+        case ObjType::FUNCTION: {
+            // Created at run time (e.g. inside a worker); its chunk outlives
+            // the run either way
+            ObjFunc* f = static_cast<ObjFunc*>(o);
+            out.kind = Transfer::Kind::FUNCTION;
+            out.chunk = f->chunk;
+            out.arity = f->arity;
+            if (f->name) out.text.assign(f->name->chars, f->name->length);
+            return;
+        }
+        case ObjType::NATIVE: {
+            ObjNative* n = static_cast<ObjNative*>(o);
+            out.kind = Transfer::Kind::NATIVE;
+            out.fn = n->fn;
+            out.legacy = n->legacy;
+            out.text.assign(n->name->chars, n->name->length);
+            return;
+        }
+        case ObjType::INSTANCE: {
+            ObjInstance* inst = static_cast<ObjInstance*>(o);
+            if (!shareable(inst->klass)) {
+                throw std::runtime_error("thread: instances of classes defined inside a thread cannot be copied out");
+            }
+            out.kind = Transfer::Kind::INSTANCE;
+            out.klass = inst->klass;
+            out.items.resize((inst->slots.size() + inst->overflow.size()) * 2);
+            size_t i = 0;
+            for (size_t s = 0; s < inst->slots.size(); ++s) {
+                pack_key(inst->shape->keys[s], out.items[i++]);
+                pack(inst->slots[s], out.items[i++], depth + 1);
+            }
+            for (const auto& kv : inst->overflow) {
+                pack_key(kv.first, out.items[i++]);
+                pack(kv.second, out.items[i++], depth + 1);
+            }
+            return;
+        }
+        case ObjType::TENSOR: {
+            ObjTensor* t = tensor_dense(static_cast<ObjTensor*>(o), static_cast<ObjTensor*>(o)->dtype);
+            out.kind = Transfer::Kind::TENSOR;
+            out.range[0] = (int64_t)t->dtype;
+            out.shape.assign(t->shape, t->shape + t->ndim);
+            out.text.assign(static_cast<const char*>(t->elements()), t->count * t->elem_size());
+            return;
+        }
+        case ObjType::BYTES: {
+            ObjBytes* b = static_cast<ObjBytes*>(o);
+            out.kind = Transfer::Kind::BYTES;
+            out.text.assign(reinterpret_cast<const char*>(b->data), b->length);
+            return;
+        }
+        case ObjType::CLASS:
+            throw std::runtime_error("thread: classes defined inside a thread cannot be copied out");
+        case ObjType::COROUTINE:
+            throw std::runtime_error("thread: coroutines cannot be copied between threads");
+        case ObjType::READER:
+            throw std::runtime_error("thread: file readers cannot be copied between threads");
+    }
+}
+
+static ObjString* unpack_key(const Transfer& t) {
+    return g_strings.intern(t.text.data(), t.text.size());
+}
+
+// Allocates in the current thread's heap; callers root the result before the
+// VM runs again
+static uint64_t unpack(const Transfer& t) {
+    switch (t.kind) {
+        case Transfer::Kind::IMMEDIATE:
+        case Transfer::Kind::SHARED:
+            return t.bits;
+        case Transfer::Kind::STRING:
+            return val_string(unpack_key(t));
+        case Transfer::Kind::LIST: {
+            ObjList* l = ObjList::create();
+            l->reserve(t.items.size());
+            for (const Transfer& item : t.items) l->push(unpack(item));
+            return val_list(l);
+        }
+        case Transfer::Kind::MAP: {
+            ObjMap* m = ObjMap::create();
+            m->data.reserve(t.items.size() / 2);
+            for (size_t i = 0; i + 1 < t.items.size(); i += 2) {
+                m->data[unpack_key(t.items[i])] = unpack(t.items[i + 1]);
+            }
+            return val_map(m);
+        }
+        case Transfer::Kind::RANGE:
+            return val_obj((Obj*)ObjRange::create(t.range[0], t.range[1], t.range[2]));
+        case Transfer::Kind::FUNCTION:
+            return val_func(make_func(t.chunk, t.text.empty() ? nullptr : t.text.c_str(), t.arity));
+        case Transfer::Kind::NATIVE:
+            return val_obj((Obj*)ObjNative::create(unpack_key(t), t.fn, t.legacy));
+        case Transfer::Kind::INSTANCE: {
+            ObjInstance* inst = ObjInstance::create(t.klass);
+            for (size_t i = 0; i + 1 < t.items.size(); i += 2) {
+                inst->set_field(unpack_key(t.items[i]), unpack(t.items[i + 1]));
+            }
+            return val_obj((Obj*)inst);
+        }
+        case Transfer::Kind::TENSOR: {
+            ObjTensor* tensor = ObjTensor::create((DType)t.range[0], t.shape.data(), (int)t.shape.size());
+            memcpy(tensor->data, t.text.data(), t.text.size());
+            return val_obj((Obj*)tensor);
+        }
+        case Transfer::Kind::BYTES:
+            return val_obj((Obj*)ObjBytes::create(t.text.data(), t.text.size()));
+    }
+    return VAL_NONE;
+}
+
+} // namespace thread_isolates
+
 namespace thread_bindings {
 using namespace native_module_util;
 static std::mutex g_task_mu;
@@ -20488,9 +24302,72 @@ Value builtin_thread_is_done(const std::vector<Value>& args) {
 }
 Value builtin_thread_sleep(const std::vector<Value>& args) {
     long ms = to_long(args.at(0));
+    thread_isolates::BlockingWait parked;
     std::this_thread::sleep_for(std::chrono::milliseconds(ms));
     return Value();
 }
+/**
+ * Shared integer cells for atomic_load/store/add/cas
+ * A cell is named by its index in a chunked table the runtime owns, so the
+ * atomic ops only ever touch memory allocated here, never an arbitrary
+ * integer address. Chunks are never unmapped; thread.atomic_free recycles
+ * the index.
+ */
+static constexpr size_t ATOMIC_CHUNK = 1024;
+static constexpr size_t ATOMIC_MAX_CHUNKS = 4096;
+static std::atomic<std::atomic<int64_t>*> g_atomic_chunks[ATOMIC_MAX_CHUNKS];
+static std::atomic<size_t> g_atomic_count{1};  // Cells below this exist; 0 is never a cell
+static std::mutex g_atomic_mu;                 // Allocation and the free list
+static std::vector<size_t> g_atomic_free;
+
+// Null unless id names a cell from thread.atomic
+std::atomic<int64_t>* find_atomic_cell(int64_t id) {
+    if (id <= 0 || static_cast<size_t>(id) >= g_atomic_count.load(std::memory_order_acquire)) return nullptr;
+    size_t i = static_cast<size_t>(id);
+    return &g_atomic_chunks[i / ATOMIC_CHUNK].load(std::memory_order_acquire)[i % ATOMIC_CHUNK];
+}
+
+uint64_t native_thread_atomic(VMContext&, const uint64_t* args, uint8_t argc) {
+    int64_t initial = argc > 0 ? native_long(args[0]) : 0;
+    std::lock_guard<std::mutex> lk(g_atomic_mu);
+    if (!g_atomic_free.empty()) {
+        size_t id = g_atomic_free.back();
+        g_atomic_free.pop_back();
+        find_atomic_cell(static_cast<int64_t>(id))->store(initial);
+        return val_int(static_cast<int64_t>(id));
+    }
+    size_t id = g_atomic_count.load(std::memory_order_relaxed);
+    size_t chunk = id / ATOMIC_CHUNK;
+    if (chunk >= ATOMIC_MAX_CHUNKS) throw std::runtime_error("thread.atomic: too many cells");
+    std::atomic<int64_t>* cells = g_atomic_chunks[chunk].load(std::memory_order_relaxed);
+    if (!cells) {
+        cells = new std::atomic<int64_t>[ATOMIC_CHUNK]();
+        g_atomic_chunks[chunk].store(cells, std::memory_order_release);
+    }
+    cells[id % ATOMIC_CHUNK].store(initial);
+    g_atomic_count.store(id + 1, std::memory_order_release);  // Publishes the chunk too
+    return val_int(static_cast<int64_t>(id));
+}
+
+uint64_t native_thread_atomic_free(VMContext&, const uint64_t* args, uint8_t argc) {
+    uint64_t v = native_arg(args, argc, 0);
+    int64_t id = is_int(v) && !is_bool(v) ? as_int(v) : 0;
+    std::lock_guard<std::mutex> lk(g_atomic_mu);
+    if (!find_atomic_cell(id) ||
+        std::find(g_atomic_free.begin(), g_atomic_free.end(), static_cast<size_t>(id)) != g_atomic_free.end()) {
+        throw std::runtime_error("thread.atomic_free: not a live atomic cell");
+    }
+    g_atomic_free.push_back(static_cast<size_t>(id));
+    return VAL_NONE;
+}
+
+// spawn, join, is_done and pool_size are defined with the thread isolates, after FastVM
+const NativeEntry natives[] = {
+    {"spawn", native_thread_spawn}, {"join", native_thread_join},
+    {"is_done", native_thread_is_done}, {"pool_size", native_thread_pool_size},
+    {"atomic", native_thread_atomic}, {"atomic_free", native_thread_atomic_free},
+};
+
 Value create_thread_module() {
     Value m(ObjectType::MAP);
     m.data.map["spawn"] = make_builtin("spawn", "thread_spawn", {"command"});
@@ -20501,87 +24378,561 @@ Value create_thread_module() {
 }
 } // namespace thread_bindings
 
+namespace http_bindings {
+// Defined with the HTTP server, after FastVM
+const native_module_util::NativeEntry natives[] = {
+    {"get", native_http_get}, {"post", native_http_post}, {"put", native_http_put},
+    {"patch", native_http_patch}, {"delete", native_http_delete}, {"head", native_http_head},
+    {"request", native_http_request}, {"request_many", native_http_request_many},
+};
+} // namespace http_bindings
+
+namespace http_server {
+// Defined with the thread isolates, after FastVM
+const native_module_util::NativeEntry natives[] = {
+    {"serve", native_http_serve}, {"shutdown", native_http_shutdown},
+};
+} // namespace http_server
+
 namespace channel_bindings {
 using namespace native_module_util;
+using thread_isolates::Transfer;
+
+/**
+ * Channel carrying packed values between threads
+ * Bounded channels are a lock-free ring: Vyukov's MPMC queue, or a plain
+ * head/tail ring for channels created with mode "spsc". The ring is a power
+ * of two, but a send is refused once `limit` values are in flight, so the
+ * capacity is exactly what was asked for. The mutex and condition variables
+ * are only used by a side that has to block, and each operation wakes only
+ * parties waiting on the other side. Unbounded channels (capacity 0) keep a
+ * locked deque.
+ */
 struct Chan {
-    std::mutex mu;
-    std::condition_variable cv;
-    std::deque<Value> q;
-    size_t cap = 0; // 0 => unbounded
-    bool closed = false;
+    struct Cell {
+        std::atomic<size_t> seq{0};  // MPMC turn: pos when free, pos + 1 when full
+        Transfer value;
+    };
+    std::unique_ptr<Cell[]> ring;  // Null for unbounded channels
+    size_t mask = 0;               // Ring size (a power of two) - 1
+    size_t limit = 0;              // Capacity; below mask + 1 when it was rounded up
+    bool spsc = false;
+    alignas(64) std::atomic<size_t> head{0};  // Next position to pop
+    alignas(64) std::atomic<size_t> tail{0};  // Next position to push
+    alignas(64) std::atomic<bool> sending{false}, receiving{false};  // SPSC misuse checks
+
+    std::mutex queue_mu;       // Unbounded channels
+    std::deque<Transfer> queue;
+
+    std::atomic<bool> closed{false};
+    std::mutex mu;             // Only for blocking waits
+    std::condition_variable readable, writable;
+    std::atomic<int> recv_waiters{0}, send_waiters{0};
+
+    // Table bookkeeping (see pin_chan): the id this slot currently answers
+    // to, the generation last handed out, and calls in progress
+    std::atomic<long> id{0};
+    std::atomic<long> gen{0};
+    alignas(64) std::atomic<long> refs{0};
+
+    // Set up a fresh channel; nothing else may be using this one
+    void reset(size_t cap, bool single) {
+        spsc = single;
+        ring.reset();
+        mask = limit = 0;
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+        sending.store(false, std::memory_order_relaxed);
+        receiving.store(false, std::memory_order_relaxed);
+        closed.store(false, std::memory_order_relaxed);
+        if (cap == 0) return;
+        size_t size = 1;
+        while (size < cap) size <<= 1;
+        ring = std::make_unique<Cell[]>(size);
+        mask = size - 1;
+        limit = cap;
+        for (size_t i = 0; i < size; ++i) ring[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    // Closed and nothing left to receive; only exact while no call is running
+    bool drained() {
+        if (!ring) {
+            std::lock_guard<std::mutex> lk(queue_mu);
+            return queue.empty();
+        }
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+    // Drop the buffers of a drained channel
+    void release() {
+        ring.reset();
+        std::lock_guard<std::mutex> lk(queue_mu);
+        std::deque<Transfer>().swap(queue);
+    }
+
+    bool try_push(Transfer& v) {
+        if (!ring) {
+            std::lock_guard<std::mutex> lk(queue_mu);
+            queue.push_back(std::move(v));
+            return true;
+        }
+        if (spsc) {
+            size_t t = tail.load(std::memory_order_relaxed);
+            if (t - head.load(std::memory_order_acquire) >= limit) return false;
+            ring[t & mask].value = std::move(v);
+            tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+        size_t pos = tail.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &ring[pos & mask];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (dif == 0) {
+                // A rounded-up ring has free cells past the capacity
+                if (limit <= mask && pos - head.load(std::memory_order_acquire) >= limit) return false;
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (dif < 0) {
+                return false;  // Full
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = std::move(v);
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(Transfer& out) {
+        if (!ring) {
+            std::lock_guard<std::mutex> lk(queue_mu);
+            if (queue.empty()) return false;
+            out = std::move(queue.front());
+            queue.pop_front();
+            return true;
+        }
+        if (spsc) {
+            size_t h = head.load(std::memory_order_relaxed);
+            if (h == tail.load(std::memory_order_acquire)) return false;
+            out = std::move(ring[h & mask].value);
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+        size_t pos = head.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &ring[pos & mask];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (dif == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (dif < 0) {
+                return false;  // Empty
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+        out = std::move(cell->value);
+        cell->seq.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Wake up to `n` parties blocked on cv. The fence pairs with the one a
+    // waiter issues after registering, so either we see it or it sees our item.
+    void wake(std::atomic<int>& waiters, std::condition_variable& cv, size_t n = 1) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters.load(std::memory_order_relaxed) == 0) return;
+        std::lock_guard<std::mutex> lk(mu);
+        if (n == 1) cv.notify_one();
+        else cv.notify_all();
+    }
+
+    // Blocks while full; false once the channel is closed
+    bool send(Transfer& v) {
+        if (closed.load(std::memory_order_acquire)) return false;
+        if (!try_push(v)) {
+            thread_isolates::BlockingWait parked;  // A pool worker hands its slot to a spare
+            std::unique_lock<std::mutex> lk(mu);
+            send_waiters.fetch_add(1);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            bool pushed = false;
+            writable.wait(lk, [&] { return (pushed = try_push(v)) || closed.load(std::memory_order_acquire); });
+            send_waiters.fetch_sub(1);
+            if (!pushed) return false;
+        }
+        wake(recv_waiters, readable);
+        return true;
+    }
+
+    // Blocks until a value arrives, the channel is closed and drained, or
+    // timeout_ms passes (negative: no timeout)
+    bool recv(Transfer& out, long timeout_ms) {
+        if (!try_pop(out)) {
+            if (timeout_ms == 0) return false;
+            thread_isolates::BlockingWait parked;
+            std::unique_lock<std::mutex> lk(mu);
+            recv_waiters.fetch_add(1);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            bool got = false;
+            auto ready = [&] { return (got = try_pop(out)) || closed.load(std::memory_order_acquire); };
+            if (timeout_ms < 0) readable.wait(lk, ready);
+            else readable.wait_for(lk, std::chrono::milliseconds(timeout_ms), ready);
+            recv_waiters.fetch_sub(1);
+            if (!got) return false;
+        }
+        wake(send_waiters, writable);
+        return true;
+    }
+
+    void close() {
+        closed.store(true, std::memory_order_release);
+        std::lock_guard<std::mutex> lk(mu);
+        readable.notify_all();
+        writable.notify_all();
+    }
+};
+
+// SPSC rings have no synchronization between two senders (or receivers);
+// catch that instead of corrupting the ring
+struct SideGuard {
+    std::atomic<bool>* flag = nullptr;
+    SideGuard(Chan& c, std::atomic<bool>& side, const char* op) {
+        if (!c.spsc || !c.ring) return;
+        if (side.exchange(true, std::memory_order_acquire)) {
+            throw std::runtime_error(std::string(op) + ": spsc channel used from two threads at once");
+        }
+        flag = &side;
+    }
+    ~SideGuard() { if (flag) flag->store(false, std::memory_order_release); }
 };
-static std::mutex g_chan_mu;
-static std::unordered_map<long, std::shared_ptr<Chan>> g_chans;
-static std::atomic<long> g_next_cid{1};
-static std::shared_ptr<Chan> get_chan(long id) {
+
+/**
+ * Channel table
+ * An id is a slot index plus a generation, and lookups index a chunked
+ * table without locking. A slot's Chan is never deleted, only recycled:
+ * once a channel is closed, drained and no call is using it, its buffers
+ * are released and the slot goes back on the free list. Every call pins
+ * the channel (refs) for its duration; the recycler takes the slot by
+ * swapping refs from 0 to CHAN_DEAD, so pins that see a negative count
+ * back off. An id whose slot has moved on behaves like a closed, empty
+ * channel.
+ */
+static constexpr size_t CHAN_CHUNK = 1024;
+static constexpr size_t CHAN_MAX_CHUNKS = 4096;
+static constexpr int CHAN_SLOT_BITS = 22;  // CHAN_CHUNK * CHAN_MAX_CHUNKS slots
+static constexpr long CHAN_SLOT_MASK = (1L << CHAN_SLOT_BITS) - 1;
+static constexpr long CHAN_MAX_GEN = LONG_MAX >> CHAN_SLOT_BITS;  // Wraps to 0 after this
+static constexpr long CHAN_DEAD = LONG_MIN / 2;
+static std::mutex g_chan_mu;  // Chunk allocation, slot numbering and the free list
+static std::atomic<std::atomic<Chan*>*> g_chan_chunks[CHAN_MAX_CHUNKS];
+static size_t g_next_slot = 1;  // 0 is never a channel
+static std::vector<size_t> g_free_slots;
+
+static Chan& closed_chan() {
+    static Chan* c = [] {
+        Chan* ch = new Chan();
+        ch->closed.store(true);
+        return ch;
+    }();
+    return *c;
+}
+
+static Chan* slot_chan(size_t index) {
+    std::atomic<Chan*>* slots = g_chan_chunks[index / CHAN_CHUNK].load(std::memory_order_acquire);
+    return slots ? slots[index % CHAN_CHUNK].load(std::memory_order_acquire) : nullptr;
+}
+
+static void try_recycle(Chan* c) {
+    long idle = 0;
+    if (!c->refs.compare_exchange_strong(idle, CHAN_DEAD)) return;
+    if (!c->closed.load() || !c->drained()) {
+        c->refs.fetch_sub(CHAN_DEAD);  // Still in use; keep pins taken meanwhile
+        return;
+    }
+    long index = c->id.load() & CHAN_SLOT_MASK;
+    c->release();
+    c->id.store(0);
     std::lock_guard<std::mutex> lk(g_chan_mu);
-    auto it = g_chans.find(id);
-    if (it == g_chans.end()) return nullptr;
-    return it->second;
+    g_free_slots.push_back(static_cast<size_t>(index));
+}
+
+static void unpin_chan(Chan* c) {
+    if (c->refs.fetch_sub(1) == 1 && c->closed.load()) try_recycle(c);
+}
+
+// Pin channel `id` for one call: its Chan, closed_chan() for an id that was
+// closed and recycled, or null for an id that was never handed out
+static Chan* pin_chan(long id) {
+    if (id <= 0) return nullptr;
+    size_t index = static_cast<size_t>(id & CHAN_SLOT_MASK);
+    if (index / CHAN_CHUNK >= CHAN_MAX_CHUNKS) return nullptr;
+    Chan* c = slot_chan(index);
+    if (!c) return nullptr;
+    if (c->refs.fetch_add(1) >= 0 && c->id.load() == id) return c;
+    bool issued = (id >> CHAN_SLOT_BITS) <= c->gen.load();
+    unpin_chan(c);
+    return issued ? &closed_chan() : nullptr;
+}
+
+struct ChanRef {
+    Chan* c;
+    explicit ChanRef(Chan* p) : c(p) {}
+    ChanRef(const ChanRef&) = delete;
+    ChanRef& operator=(const ChanRef&) = delete;
+    ~ChanRef() { if (c && c != &closed_chan()) unpin_chan(c); }
+    Chan& operator*() const { return *c; }
+};
+
+static ChanRef chan_arg(long id, const char* op) {
+    Chan* c = pin_chan(id);
+    if (!c) throw std::runtime_error(std::string(op) + " invalid id");
+    return ChanRef(c);
 }
-Value builtin_channel_create(const std::vector<Value>& args) {
-    auto c = std::make_shared<Chan>();
-    c->cap = args.empty() ? 0 : static_cast<size_t>(std::max<long>(0, to_long(args[0])));
-    long id = g_next_cid.fetch_add(1);
+static long create_chan(long cap, const std::string& mode) {
+    if (mode != "mpmc" && mode != "spsc") throw std::runtime_error("channel.create mode must be \"mpmc\" or \"spsc\"");
     std::lock_guard<std::mutex> lk(g_chan_mu);
-    g_chans[id] = c;
-    return Value(id);
+    size_t index;
+    Chan* c;
+    if (!g_free_slots.empty()) {
+        index = g_free_slots.back();
+        g_free_slots.pop_back();
+        c = slot_chan(index);
+    } else {
+        index = g_next_slot;
+        size_t chunk = index / CHAN_CHUNK;
+        if (chunk >= CHAN_MAX_CHUNKS) throw std::runtime_error("channel.create: too many open channels");
+        ++g_next_slot;
+        c = nullptr;
+        if (!g_chan_chunks[chunk].load(std::memory_order_relaxed)) {
+            g_chan_chunks[chunk].store(new std::atomic<Chan*>[CHAN_CHUNK](), std::memory_order_release);
+        }
+    }
+    bool fresh = c == nullptr;
+    if (fresh) c = new Chan();
+    c->reset(static_cast<size_t>(std::max<long>(0, cap)), mode == "spsc");
+    long gen = fresh ? 0 : (c->gen.load() + 1) % (CHAN_MAX_GEN + 1);
+    long id = (gen << CHAN_SLOT_BITS) | static_cast<long>(index);
+    c->gen.store(gen);
+    c->id.store(id);
+    if (fresh) g_chan_chunks[index / CHAN_CHUNK].load(std::memory_order_relaxed)[index % CHAN_CHUNK].store(c, std::memory_order_release);
+    else c->refs.fetch_sub(CHAN_DEAD);  // Let pins in again
+    return id;
+}
+
+// Legacy Value messages (interpreter/REPL) travel in the same packed form
+static void pack_legacy(const Value& v, Transfer& out) {
+    out.kind = Transfer::Kind::IMMEDIATE;
+    switch (v.type) {
+        case ObjectType::INTEGER: out.bits = val_int(v.data.integer); return;
+        case ObjectType::FLOAT: out.bits = val_number(v.data.floating); return;
+        case ObjectType::BOOLEAN: out.bits = v.data.boolean ? VAL_TRUE : VAL_FALSE; return;
+        case ObjectType::NONE: out.bits = VAL_NONE; return;
+        case ObjectType::STRING:
+            out.kind = Transfer::Kind::STRING;
+            out.text = v.data.string;
+            return;
+        case ObjectType::LIST:
+            out.kind = Transfer::Kind::LIST;
+            out.items.resize(v.data.list.size());
+            for (size_t i = 0; i < v.data.list.size(); ++i) pack_legacy(v.data.list[i], out.items[i]);
+            return;
+        case ObjectType::MAP: {
+            out.kind = Transfer::Kind::MAP;
+            out.items.resize(v.data.map.size() * 2);
+            size_t i = 0;
+            for (const auto& kv : v.data.map) {
+                out.items[i].kind = Transfer::Kind::STRING;
+                out.items[i++].text = kv.first;
+                pack_legacy(kv.second, out.items[i++]);
+            }
+            return;
+        }
+        case ObjectType::RANGE:
+            out.kind = Transfer::Kind::RANGE;
+            out.range[0] = v.data.range.start;
+            out.range[1] = v.data.range.stop;
+            out.range[2] = v.data.range.step;
+            return;
+        default:
+            throw std::runtime_error("channel.send: only data values (numbers, strings, lists, maps) can be sent");
+    }
+}
+static Value unpack_legacy(const Transfer& t) {
+    switch (t.kind) {
+        case Transfer::Kind::IMMEDIATE:
+            if (is_int(t.bits) && !is_bool(t.bits)) return Value(static_cast<long>(as_int(t.bits)));
+            if (t.bits == VAL_TRUE || t.bits == VAL_FALSE) return Value(t.bits == VAL_TRUE);
+            if (is_number(t.bits)) return Value(as_number(t.bits));
+            return Value();
+        case Transfer::Kind::STRING:
+        case Transfer::Kind::BYTES:
+            return Value(t.text);
+        case Transfer::Kind::LIST: {
+            std::vector<Value> items;
+            items.reserve(t.items.size());
+            for (const Transfer& item : t.items) items.push_back(unpack_legacy(item));
+            return Value(std::move(items));
+        }
+        case Transfer::Kind::MAP: {
+            Value m(ObjectType::MAP);
+            for (size_t i = 0; i + 1 < t.items.size(); i += 2) m.data.map[t.items[i].text] = unpack_legacy(t.items[i + 1]);
+            return m;
+        }
+        case Transfer::Kind::RANGE: {
+            Value r(ObjectType::RANGE);
+            r.data.range.start = t.range[0];
+            r.data.range.stop = t.range[1];
+            r.data.range.step = t.range[2];
+            return r;
+        }
+        default:
+            // Sent by compiled code: shared strings survive, code does not
+            if (t.kind == Transfer::Kind::SHARED && is_string_val(t.bits)) return Value(as_string(t.bits)->str());
+            return Value();
+    }
+}
+
+Value builtin_channel_create(const std::vector<Value>& args) {
+    long cap = args.empty() ? 0 : to_long(args[0]);
+    return Value(create_chan(cap, args.size() > 1 ? to_string(args[1]) : "mpmc"));
 }
 Value builtin_channel_send(const std::vector<Value>& args) {
-    long id = to_long(args.at(0));
-    auto c = get_chan(id);
-    if (!c) throw std::runtime_error("channel.send invalid id");
-    std::unique_lock<std::mutex> lk(c->mu);
-    c->cv.wait(lk, [&]{ return c->closed || c->cap == 0 || c->q.size() < c->cap; });
-    if (c->closed) return Value(false);
-    c->q.push_back(args.at(1));
-    c->cv.notify_all();
-    return Value(true);
+    ChanRef ref = chan_arg(to_long(args.at(0)), "channel.send");
+    Chan& c = *ref;
+    SideGuard guard(c, c.sending, "channel.send");
+    Transfer msg;
+    pack_legacy(args.at(1), msg);
+    return Value(c.send(msg));
+}
+Value builtin_channel_send_many(const std::vector<Value>& args) {
+    ChanRef ref = chan_arg(to_long(args.at(0)), "channel.send_many");
+    Chan& c = *ref;
+    const Value& items = args.at(1);
+    if (items.type != ObjectType::LIST) throw std::runtime_error("channel.send_many expects a list");
+    SideGuard guard(c, c.sending, "channel.send_many");
+    long sent = 0;
+    for (const Value& item : items.data.list) {
+        Transfer msg;
+        pack_legacy(item, msg);
+        if (!c.send(msg)) break;
+        ++sent;
+    }
+    return Value(sent);
 }
 Value builtin_channel_recv(const std::vector<Value>& args) {
-    long id = to_long(args.at(0));
+    ChanRef ref = chan_arg(to_long(args.at(0)), "channel.recv");
+    Chan& c = *ref;
     long timeout_ms = args.size() >= 2 ? to_long(args[1]) : -1;
-    auto c = get_chan(id);
-    if (!c) throw std::runtime_error("channel.recv invalid id");
-    std::unique_lock<std::mutex> lk(c->mu);
-    if (timeout_ms < 0) {
-        c->cv.wait(lk, [&]{ return c->closed || !c->q.empty(); });
-    } else {
-        c->cv.wait_for(lk, std::chrono::milliseconds(timeout_ms), [&]{ return c->closed || !c->q.empty(); });
-    }
-    if (c->q.empty()) return Value();
-    Value v = c->q.front();
-    c->q.pop_front();
-    c->cv.notify_all();
-    return v;
+    SideGuard guard(c, c.receiving, "channel.recv");
+    Transfer msg;
+    if (!c.recv(msg, timeout_ms)) return Value();
+    return unpack_legacy(msg);
+}
+Value builtin_channel_recv_many(const std::vector<Value>& args) {
+    ChanRef ref = chan_arg(to_long(args.at(0)), "channel.recv_many");
+    Chan& c = *ref;
+    long max = to_long(args.at(1));
+    long timeout_ms = args.size() >= 3 ? to_long(args[2]) : -1;
+    SideGuard guard(c, c.receiving, "channel.recv_many");
+    std::vector<Value> out;
+    Transfer msg;
+    if (max > 0 && c.recv(msg, timeout_ms)) {
+        out.push_back(unpack_legacy(msg));
+        while (static_cast<long>(out.size()) < max && c.try_pop(msg)) out.push_back(unpack_legacy(msg));
+        if (out.size() > 1) c.wake(c.send_waiters, c.writable, out.size());
+    }
+    return Value(std::move(out));
 }
 Value builtin_channel_try_recv(const std::vector<Value>& args) {
-    long id = to_long(args.at(0));
-    auto c = get_chan(id);
-    if (!c) throw std::runtime_error("channel.try_recv invalid id");
-    std::lock_guard<std::mutex> lk(c->mu);
-    if (c->q.empty()) return Value();
-    Value v = c->q.front();
-    c->q.pop_front();
-    c->cv.notify_all();
-    return v;
+    ChanRef ref = chan_arg(to_long(args.at(0)), "channel.try_recv");
+    Chan& c = *ref;
+    SideGuard guard(c, c.receiving, "channel.try_recv");
+    Transfer msg;
+    if (!c.recv(msg, 0)) return Value();
+    return unpack_legacy(msg);
 }
 Value builtin_channel_close(const std::vector<Value>& args) {
-    long id = to_long(args.at(0));
-    auto c = get_chan(id);
+    Chan* c = pin_chan(to_long(args.at(0)));
     if (!c) return Value(false);
-    {
-        std::lock_guard<std::mutex> lk(c->mu);
-        c->closed = true;
-    }
-    c->cv.notify_all();
+    ChanRef ref(c);
+    c->close();  // Recycled once drained and unused
     return Value(true);
 }
+
+// Zero-copy natives: values are packed straight from VM slots and unpacked
+// into the receiving thread's heap
+static uint64_t native_channel_send(VMContext&, const uint64_t* args, uint8_t argc) {
+    ChanRef ref = chan_arg(native_long(native_arg(args, argc, 0)), "channel.send");
+    Chan& c = *ref;
+    SideGuard guard(c, c.sending, "channel.send");
+    Transfer msg;
+    thread_isolates::pack(native_arg(args, argc, 1), msg);
+    return c.send(msg) ? VAL_TRUE : VAL_FALSE;
+}
+static uint64_t native_channel_send_many(VMContext&, const uint64_t* args, uint8_t argc) {
+    ChanRef ref = chan_arg(native_long(native_arg(args, argc, 0)), "channel.send_many");
+    Chan& c = *ref;
+    uint64_t items = native_arg(args, argc, 1);
+    if (!is_obj(items) || obj_type(items) != ObjType::LIST) throw std::runtime_error("channel.send_many expects a list");
+    SideGuard guard(c, c.sending, "channel.send_many");
+    ObjList* list = as_list(items);
+    int64_t sent = 0;
+    Transfer msg;
+    for (size_t i = 0; i < list->count; ++i) {
+        msg = Transfer();
+        thread_isolates::pack(list->items[i], msg);
+        if (!c.send(msg)) break;
+        ++sent;
+    }
+    return val_int(sent);
+}
+static uint64_t native_channel_recv(VMContext&, const uint64_t* args, uint8_t argc) {
+    ChanRef ref = chan_arg(native_long(native_arg(args, argc, 0)), "channel.recv");
+    Chan& c = *ref;
+    long timeout_ms = argc >= 2 ? native_long(args[1]) : -1;
+    SideGuard guard(c, c.receiving, "channel.recv");
+    Transfer msg;
+    if (!c.recv(msg, timeout_ms)) return VAL_NONE;
+    return thread_isolates::unpack(msg);
+}
+static uint64_t native_channel_recv_many(VMContext&, const uint64_t* args, uint8_t argc) {
+    ChanRef ref = chan_arg(native_long(native_arg(args, argc, 0)), "channel.recv_many");
+    Chan& c = *ref;
+    long max = native_long(native_arg(args, argc, 1));
+    long timeout_ms = argc >= 3 ? native_long(args[2]) : -1;
+    SideGuard guard(c, c.receiving, "channel.recv_many");
+    ObjList* out = ObjList::create();
+    Transfer msg;
+    if (max > 0 && c.recv(msg, timeout_ms)) {
+        out->push(thread_isolates::unpack(msg));
+        while (static_cast<long>(out->count) < max && c.try_pop(msg)) out->push(thread_isolates::unpack(msg));
+        if (out->count > 1) c.wake(c.send_waiters, c.writable, out->count);
+    }
+    return val_list(out);
+}
+static uint64_t native_channel_try_recv(VMContext&, const uint64_t* args, uint8_t argc) {
+    ChanRef ref = chan_arg(native_long(native_arg(args, argc, 0)), "channel.try_recv");
+    Chan& c = *ref;
+    SideGuard guard(c, c.receiving, "channel.try_recv");
+    Transfer msg;
+    if (!c.recv(msg, 0)) return VAL_NONE;
+    return thread_isolates::unpack(msg);
+}
+
+const NativeEntry natives[] = {
+    {"send", native_channel_send}, {"send_many", native_channel_send_many},
+    {"recv", native_channel_recv}, {"recv_many", native_channel_recv_many},
+    {"try_recv", native_channel_try_recv},
+};
+
 Value create_channel_module() {
     Value m(ObjectType::MAP);
-    m.data.map["create"] = make_builtin("create", "channel_create", {"capacity"});
+    m.data.map["create"] = make_builtin("create", "channel_create", {"capacity", "mode"});
     m.data.map["send"] = make_builtin("send", "channel_send", {"channel_id", "value"});
+    m.data.map["send_many"] = make_builtin("send_many", "channel_send_many", {"channel_id", "values"});
     m.data.map["recv"] = make_builtin("recv", "channel_recv", {"channel_id", "timeout_ms"});
+    m.data.map["recv_many"] = make_builtin("recv_many", "channel_recv_many", {"channel_id", "max", "timeout_ms"});
     m.data.map["try_recv"] = make_builtin("try_recv", "channel_try_recv", {"channel_id"});
     m.data.map["close"] = make_builtin("close", "channel_close", {"channel_id"});
     return m;
@@ -20595,200 +24946,634 @@ enum class AsyncTaskKind {
     PROCESS,
     TIMER,
     TCP_RECV,
-    TCP_SEND
+    TCP_SEND,
+    HTTP
 };
 
 struct AsyncTask {
     AsyncTaskKind kind = AsyncTaskKind::TIMER;
+    long id = 0;
     bool done = false;
     bool cancelled = false;
     bool ok = true;
     std::string error;
     Value result;
     std::chrono::steady_clock::time_point due_at{};
-    std::shared_ptr<std::future<long>> process_future;
+    // PROCESS and HTTP work runs on the offload threads; they fill these in
+    // and set worker_done before waking the reactor
+    long worker_code = 0;
+    levython::http::HttpResponse worker_response;
+    std::string worker_error;
+    std::atomic<bool> worker_done{false};
+    std::atomic<bool> abandoned{false};  // Cancelled: a job that has not started skips its work
     long socket_id = 0;
+    int fd = -1;  // Socket tasks: descriptor watched by the reactor
     int max_bytes = 4096;
     std::string send_data;
     size_t send_offset = 0;
+    // HTTP: the response body stays out of `result` until a caller takes it,
+    // as a list of ints (Value callers) or as bytes (FastVM, like http.get)
+    std::vector<uint8_t> body;
+    bool has_body = false;
 };
 
-static std::mutex g_async_mu;
-static std::unordered_map<long, std::shared_ptr<AsyncTask>> g_async_tasks;
-static std::atomic<long> g_async_next_id{1};
+// ----------------------------------------------------------------------------
+// Reactor: socket tasks are registered for readiness (epoll on Linux, kqueue
+// on macOS, WSAPoll on Windows) and only touched once the kernel reports them
+// ready. Timers wait in a min-heap; process workers wake the loop through an
+// eventfd (Linux) or self-pipe (macOS). Windows has no wakeup handle, so
+// waits are capped while processes are running.
+// ----------------------------------------------------------------------------
+class Reactor {
+public:
+    using Clock = std::chrono::steady_clock;
 
-static std::shared_ptr<AsyncTask> find_task(long id) {
-    std::lock_guard<std::mutex> lk(g_async_mu);
-    auto it = g_async_tasks.find(id);
-    if (it == g_async_tasks.end()) return nullptr;
-    return it->second;
-}
+    Reactor() {
+#if defined(__linux__)
+        poll_fd = epoll_create1(EPOLL_CLOEXEC);
+        wake_read = wake_write = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (poll_fd >= 0 && wake_read >= 0) {
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.fd = wake_read;
+            epoll_ctl(poll_fd, EPOLL_CTL_ADD, wake_read, &ev);
+        }
+#elif defined(__APPLE__)
+        poll_fd = kqueue();
+        int p[2];
+        if (pipe(p) == 0) {
+            wake_read = p[0];
+            wake_write = p[1];
+            fcntl(wake_read, F_SETFL, O_NONBLOCK);
+            fcntl(wake_write, F_SETFL, O_NONBLOCK);
+            struct kevent ev;
+            EV_SET(&ev, wake_read, EVFILT_READ, EV_ADD, 0, 0, nullptr);
+            kevent(poll_fd, &ev, 1, nullptr, 0, nullptr);
+        }
+#endif
+    }
 
-static long add_task(const std::shared_ptr<AsyncTask>& t) {
-    long id = g_async_next_id.fetch_add(1);
-    std::lock_guard<std::mutex> lk(g_async_mu);
-    g_async_tasks[id] = t;
-    return id;
-}
+    ~Reactor() {
+#if defined(__linux__)
+        if (wake_read >= 0) close(wake_read);
+#elif defined(__APPLE__)
+        if (wake_read >= 0) close(wake_read);
+        if (wake_write >= 0) close(wake_write);
+#endif
+#if defined(__linux__) || defined(__APPLE__)
+        if (poll_fd >= 0) close(poll_fd);
+#endif
+    }
+    Reactor(const Reactor&) = delete;
+    Reactor& operator=(const Reactor&) = delete;
 
-static bool poll_task(std::shared_ptr<AsyncTask>& task) {
-    if (!task || task->done || task->cancelled) return false;
-    bool changed = false;
-    switch (task->kind) {
-        case AsyncTaskKind::TIMER: {
-            auto now = std::chrono::steady_clock::now();
-            if (now >= task->due_at) {
-                task->done = true;
-                task->result = Value(true);
-                changed = true;
-            }
-            break;
+    // Wakeups come from worker threads, so a missing handle means polling
+    bool can_wake() const { return wake_write >= 0; }
+
+    void wake() {
+#if defined(__linux__)
+        uint64_t one = 1;
+        if (wake_write >= 0) (void)!write(wake_write, &one, sizeof(one));
+#elif defined(__APPLE__)
+        char b = 1;
+        if (wake_write >= 0) (void)!write(wake_write, &b, 1);
+#endif
+    }
+
+    // One pending recv and one pending send per socket; a second would
+    // silently replace the first task's registration
+    void watch(int fd, long task_id, bool writable) {
+        std::lock_guard<std::mutex> lk(mu);
+        FdWatch& w = fds[fd];
+        long& side = writable ? w.writer : w.reader;
+        if (side && side != task_id) {
+            throw std::runtime_error(writable ? "async.tcp_send: socket already has a pending send"
+                                              : "async.tcp_recv: socket already has a pending recv");
         }
-        case AsyncTaskKind::PROCESS: {
-            if (!task->process_future) {
-                task->done = true;
-                task->ok = false;
-                task->error = "missing process future";
-                changed = true;
-                break;
-            }
-            if (task->process_future->wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
-                long code = task->process_future->get();
-                Value out(ObjectType::MAP);
-                out.data.map["exit_code"] = Value(code);
-                out.data.map["ok"] = Value(code == 0);
-                task->result = out;
-                task->done = true;
-                changed = true;
+        side = task_id;
+        update(fd, w);
+    }
+
+    void unwatch(int fd, long task_id) {
+        std::lock_guard<std::mutex> lk(mu);
+        auto it = fds.find(fd);
+        if (it == fds.end()) return;
+        if (it->second.reader == task_id) it->second.reader = 0;
+        if (it->second.writer == task_id) it->second.writer = 0;
+        update(fd, it->second);
+        if (!it->second.reader && !it->second.writer) fds.erase(it);
+    }
+
+    void add_timer(Clock::time_point due, long task_id) {
+        std::lock_guard<std::mutex> lk(mu);
+        timers.push({due, task_id});
+    }
+
+    // Block for up to timeout_ms (-1 = no limit) but never past the next
+    // timer, then append the ids of ready socket tasks and due timers.
+    void wait(int timeout_ms, size_t max_events, std::vector<long>& ready) {
+        {
+            std::lock_guard<std::mutex> lk(mu);
+            if (!timers.empty()) {
+                auto until = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    timers.top().first - Clock::now()).count();
+                int ms = until <= 0 ? 0 : (int)std::min<long long>(until + 1, INT32_MAX);
+                if (timeout_ms < 0 || ms < timeout_ms) timeout_ms = ms;
+            }
+        }
+        if (max_events == 0) max_events = 1;
+        if (max_events > MAX_EVENTS) max_events = MAX_EVENTS;
+#if defined(__linux__)
+        epoll_event evs[MAX_EVENTS];
+        int n = poll_fd >= 0 ? epoll_wait(poll_fd, evs, (int)max_events, timeout_ms) : 0;
+        std::lock_guard<std::mutex> lk(mu);
+        for (int i = 0; i < n; i++) {
+            int fd = evs[i].data.fd;
+            if (fd == wake_read) {
+                uint64_t drained;
+                while (read(wake_read, &drained, sizeof(drained)) > 0) {}
+                continue;
             }
-            break;
+            bool failed = evs[i].events & (EPOLLERR | EPOLLHUP);
+            report(fd, (evs[i].events & EPOLLIN) || failed, (evs[i].events & EPOLLOUT) || failed, ready);
         }
-        case AsyncTaskKind::TCP_RECV: {
-            Value out = net_bindings::builtin_net_tcp_try_recv({Value(task->socket_id), Value(static_cast<long>(task->max_bytes))});
-            if (out.type != ObjectType::MAP) break;
-            bool would_block = out.data.map.count("would_block") ? to_bool(out.data.map["would_block"]) : false;
-            bool ok = out.data.map.count("ok") ? to_bool(out.data.map["ok"]) : false;
-            bool closed = out.data.map.count("closed") ? to_bool(out.data.map["closed"]) : false;
-            std::string err = out.data.map.count("error") ? to_string(out.data.map["error"]) : "";
-            if (ok || closed || !err.empty()) {
-                task->done = true;
-                task->ok = ok || closed;
-                if (!task->ok && !err.empty()) task->error = err;
-                task->result = out;
-                changed = true;
-            } else if (!would_block) {
-                task->done = true;
-                task->ok = false;
-                task->error = "tcp recv failed";
-                task->result = out;
-                changed = true;
+#elif defined(__APPLE__)
+        struct kevent evs[MAX_EVENTS];
+        timespec ts{}, *tsp = nullptr;
+        if (timeout_ms >= 0) {
+            ts.tv_sec = timeout_ms / 1000;
+            ts.tv_nsec = (long)(timeout_ms % 1000) * 1000000L;
+            tsp = &ts;
+        }
+        int n = poll_fd >= 0 ? kevent(poll_fd, nullptr, 0, evs, (int)max_events, tsp) : 0;
+        std::lock_guard<std::mutex> lk(mu);
+        for (int i = 0; i < n; i++) {
+            int fd = (int)evs[i].ident;
+            if (fd == wake_read) {
+                char drained[64];
+                while (read(wake_read, drained, sizeof(drained)) > 0) {}
+                continue;
             }
-            break;
+            bool failed = evs[i].flags & (EV_EOF | EV_ERROR);
+            report(fd, evs[i].filter == EVFILT_READ || failed, evs[i].filter == EVFILT_WRITE || failed, ready);
         }
-        case AsyncTaskKind::TCP_SEND: {
-            if (task->send_offset >= task->send_data.size()) {
-                task->done = true;
-                Value out(ObjectType::MAP);
-                out.data.map["ok"] = Value(true);
-                out.data.map["sent"] = Value(static_cast<long>(task->send_offset));
-                task->result = out;
-                changed = true;
-                break;
-            }
-            std::string chunk = task->send_data.substr(task->send_offset);
-            Value out = net_bindings::builtin_net_tcp_try_send({Value(task->socket_id), Value(chunk)});
-            if (out.type != ObjectType::MAP) break;
-            bool would_block = out.data.map.count("would_block") ? to_bool(out.data.map["would_block"]) : false;
-            bool ok = out.data.map.count("ok") ? to_bool(out.data.map["ok"]) : false;
-            long sent = out.data.map.count("sent") ? to_long(out.data.map["sent"]) : 0;
-            std::string err = out.data.map.count("error") ? to_string(out.data.map["error"]) : "";
-            if (ok && sent > 0) {
-                task->send_offset += static_cast<size_t>(sent);
-                if (task->send_offset >= task->send_data.size()) {
-                    task->done = true;
-                    Value done_out(ObjectType::MAP);
-                    done_out.data.map["ok"] = Value(true);
-                    done_out.data.map["sent"] = Value(static_cast<long>(task->send_offset));
-                    task->result = done_out;
-                    changed = true;
-                }
-            } else if (!would_block) {
-                task->done = true;
-                task->ok = false;
-                task->error = err.empty() ? "tcp send failed" : err;
-                task->result = out;
-                changed = true;
-            }
-            break;
+#else
+        std::vector<WSAPOLLFD> pfds;
+        {
+            std::lock_guard<std::mutex> lk(mu);
+            pfds.reserve(fds.size());
+            for (const auto& kv : fds) {
+                WSAPOLLFD p{};
+                p.fd = (SOCKET)kv.first;
+                p.events = (short)((kv.second.reader ? POLLRDNORM : 0) | (kv.second.writer ? POLLWRNORM : 0));
+                pfds.push_back(p);
+            }
+        }
+        int n = 0;
+        if (pfds.empty()) {
+            if (timeout_ms > 0) Sleep((DWORD)timeout_ms);
+        } else {
+            n = WSAPoll(pfds.data(), (ULONG)pfds.size(), timeout_ms);
+        }
+        std::lock_guard<std::mutex> lk(mu);
+        for (int i = 0; n > 0 && i < (int)pfds.size() && ready.size() < max_events; i++) {
+            short re = pfds[i].revents;
+            if (!re) continue;
+            bool failed = re & (POLLERR | POLLHUP | POLLNVAL);
+            report((int)pfds[i].fd, (re & POLLRDNORM) || failed, (re & POLLWRNORM) || failed, ready);
+        }
+#endif
+        auto now = Clock::now();
+        while (!timers.empty() && timers.top().first <= now) {
+            ready.push_back(timers.top().second);
+            timers.pop();
         }
     }
-    return changed;
-}
 
-static long tick_tasks(long budget = 256) {
-    if (budget <= 0) budget = 1;
-    long completed_now = 0;
-    std::vector<std::shared_ptr<AsyncTask>> snapshot;
-    snapshot.reserve(static_cast<size_t>(budget));
-    {
-        std::lock_guard<std::mutex> lk(g_async_mu);
-        for (const auto& kv : g_async_tasks) {
-            if (snapshot.size() >= static_cast<size_t>(budget)) break;
-            snapshot.push_back(kv.second);
+private:
+    static constexpr size_t MAX_EVENTS = 256;
+
+    struct FdWatch {
+        long reader = 0;  // Task waiting to recv (0 = none)
+        long writer = 0;  // Task waiting to send
+        bool registered = false;
+    };
+    using TimerEntry = std::pair<Clock::time_point, long>;
+
+    std::mutex mu;
+    std::unordered_map<int, FdWatch> fds;
+    std::priority_queue<TimerEntry, std::vector<TimerEntry>, std::greater<TimerEntry>> timers;
+    int poll_fd = -1;
+    int wake_read = -1;
+    int wake_write = -1;
+
+    void report(int fd, bool readable, bool writable, std::vector<long>& ready) {
+        auto it = fds.find(fd);
+        if (it == fds.end()) return;
+        if (readable && it->second.reader) ready.push_back(it->second.reader);
+        if (writable && it->second.writer) ready.push_back(it->second.writer);
+    }
+
+    // Sync the kernel's interest set with w (level-triggered)
+    void update(int fd, FdWatch& w) {
+#if defined(__linux__)
+        epoll_event ev{};
+        ev.events = (w.reader ? static_cast<uint32_t>(EPOLLIN) : 0u) | (w.writer ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+        ev.data.fd = fd;
+        if (!ev.events) {
+            if (w.registered) epoll_ctl(poll_fd, EPOLL_CTL_DEL, fd, &ev);
+            w.registered = false;
+            return;
         }
+        int op = w.registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+        if (epoll_ctl(poll_fd, op, fd, &ev) != 0) {
+            // A closed descriptor drops out of epoll; its number may be reused
+            op = (errno == EEXIST) ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+            epoll_ctl(poll_fd, op, fd, &ev);
+        }
+        w.registered = true;
+#elif defined(__APPLE__)
+        struct kevent ch[2];
+        EV_SET(&ch[0], fd, EVFILT_READ, w.reader ? EV_ADD : EV_DELETE, 0, 0, nullptr);
+        EV_SET(&ch[1], fd, EVFILT_WRITE, w.writer ? EV_ADD : EV_DELETE, 0, 0, nullptr);
+        for (auto& c : ch) kevent(poll_fd, &c, 1, nullptr, 0, nullptr);  // EV_DELETE of an absent filter is harmless
+        w.registered = w.reader || w.writer;
+#else
+        w.registered = w.reader || w.writer;  // WSAPoll rebuilds its set on every wait
+#endif
     }
-    for (auto& t : snapshot) {
-        bool was_done = t->done;
-        if (poll_task(t) && !was_done && t->done) completed_now++;
-    }
-    return completed_now;
-}
+};
 
-static Value task_status_map(long id, const std::shared_ptr<AsyncTask>& task) {
-    Value m(ObjectType::MAP);
-    m.data.map["id"] = Value(id);
-    if (!task) {
-        m.data.map["exists"] = Value(false);
-        m.data.map["done"] = Value(true);
-        m.data.map["ok"] = Value(false);
-        m.data.map["cancelled"] = Value(false);
-        m.data.map["error"] = Value("task not found");
-        m.data.map["result"] = Value();
-        return m;
-    }
-    m.data.map["exists"] = Value(true);
-    m.data.map["done"] = Value(task->done);
-    m.data.map["ok"] = Value(task->ok);
-    m.data.map["cancelled"] = Value(task->cancelled);
-    m.data.map["error"] = Value(task->error);
-    m.data.map["result"] = task->result;
-    return m;
+static Reactor& reactor() {
+    static Reactor r;
+    return r;
 }
 
-Value builtin_async_spawn(const std::vector<Value>& args) {
-    std::string cmd = to_string(args.at(0));
-    auto task = std::make_shared<AsyncTask>();
-    task->kind = AsyncTaskKind::PROCESS;
-    task->process_future = std::make_shared<std::future<long>>(
-        std::async(std::launch::async, [cmd]() -> long { return static_cast<long>(std::system(cmd.c_str())); })
-    );
-    return Value(add_task(task));
+/**
+ * Bounded executor for blocking task work (async.spawn, async.http)
+ * Threads start on demand up to OFFLOAD_THREADS and then stay for the life
+ * of the process; further jobs queue. Nothing waits on a job's completion
+ * except through the task, so cancelling or dropping one never blocks.
+ */
+class Offload {
+public:
+    static Offload& get() {
+        static Offload* o = new Offload();  // Never destroyed: threads may still be running at exit
+        return *o;
+    }
+
+    void submit(std::function<void()> job) {
+        std::lock_guard<std::mutex> lk(mu);
+        jobs.push_back(std::move(job));
+        if (idle == 0 && threads < OFFLOAD_THREADS) {
+            ++threads;
+            std::thread([this] { run(); }).detach();
+        } else {
+            cv.notify_one();
+        }
+    }
+
+private:
+    static constexpr size_t OFFLOAD_THREADS = 16;
+    std::mutex mu;
+    std::condition_variable cv;
+    std::deque<std::function<void()>> jobs;
+    size_t idle = 0;
+    size_t threads = 0;
+
+    void run() {
+        std::unique_lock<std::mutex> lk(mu);
+        for (;;) {
+            ++idle;
+            cv.wait(lk, [this] { return !jobs.empty(); });
+            --idle;
+            std::function<void()> job = std::move(jobs.front());
+            jobs.pop_front();
+            lk.unlock();
+            job();
+            lk.lock();
+        }
+    }
+};
+
+// Run work(task) on the offload threads; the task completes on the next tick
+static void offload_task(const std::shared_ptr<AsyncTask>& task, std::function<void(AsyncTask&)> work) {
+    std::weak_ptr<AsyncTask> weak = task;
+    Offload::get().submit([weak, work = std::move(work)] {
+        {
+            std::shared_ptr<AsyncTask> t = weak.lock();
+            if (!t || t->abandoned.load(std::memory_order_acquire)) return;
+            try {
+                work(*t);
+            } catch (const std::exception& e) {
+                t->worker_error = e.what();
+                if (t->worker_error.empty()) t->worker_error = "task failed";
+            }
+            t->worker_done.store(true, std::memory_order_release);
+        }
+        reactor().wake();
+    });
 }
 
-Value builtin_async_sleep(const std::vector<Value>& args) {
-    long ms = to_long(args.at(0));
+static std::mutex g_async_mu;
+static std::unordered_map<long, std::shared_ptr<AsyncTask>> g_async_tasks;
+static std::vector<std::shared_ptr<AsyncTask>> g_async_workers;  // Running PROCESS and HTTP tasks
+static std::atomic<long> g_async_next_id{1};
+static std::atomic<long> g_async_live{0};  // Tasks not yet done or cancelled
+// Ids the VM has coroutines suspended on; finish_task moves them to the
+// finished list, which the VM scheduler drains to resume the waiters
+static std::unordered_set<long> g_async_watched;
+static std::vector<long> g_async_finished;
+
+static std::shared_ptr<AsyncTask> find_task(long id) {
+    std::lock_guard<std::mutex> lk(g_async_mu);
+    auto it = g_async_tasks.find(id);
+    if (it == g_async_tasks.end()) return nullptr;
+    return it->second;
+}
+
+static long add_task(const std::shared_ptr<AsyncTask>& t) {
+    long id = g_async_next_id.fetch_add(1);
+    t->id = id;
+    // Socket registration may refuse the task, so it goes first
+    if (t->kind == AsyncTaskKind::TCP_RECV) reactor().watch(t->fd, id, false);
+    if (t->kind == AsyncTaskKind::TCP_SEND) reactor().watch(t->fd, id, true);
+    g_async_live++;
+    {
+        std::lock_guard<std::mutex> lk(g_async_mu);
+        g_async_tasks[id] = t;
+        if (t->kind == AsyncTaskKind::PROCESS || t->kind == AsyncTaskKind::HTTP) {
+            g_async_workers.push_back(t);
+        }
+    }
+    if (t->kind == AsyncTaskKind::TIMER) reactor().add_timer(t->due_at, id);
+    return id;
+}
+
+// Mark a task finished and drop its reactor registration
+static void finish_task(const std::shared_ptr<AsyncTask>& task) {
+    if (task->done) return;
+    task->done = true;
+    g_async_live--;
+    if (task->fd >= 0) reactor().unwatch(task->fd, task->id);
+    std::lock_guard<std::mutex> lk(g_async_mu);
+    if (g_async_watched.erase(task->id)) g_async_finished.push_back(task->id);
+}
+
+// Report task id through take_finished once it completes (immediately if it
+// already has, or no longer exists)
+static void watch_task(long id) {
+    auto task = find_task(id);
+    std::lock_guard<std::mutex> lk(g_async_mu);
+    if (!task || task->done) g_async_finished.push_back(id);
+    else g_async_watched.insert(id);
+}
+
+static void take_finished(std::vector<long>& out) {
+    std::lock_guard<std::mutex> lk(g_async_mu);
+    out.swap(g_async_finished);
+    g_async_finished.clear();
+}
+
+static long start_timer(long ms) {
     if (ms < 0) ms = 0;
     auto task = std::make_shared<AsyncTask>();
     task->kind = AsyncTaskKind::TIMER;
     task->due_at = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
-    return Value(add_task(task));
+    return add_task(task);
+}
+
+static void cancel_task(const std::shared_ptr<AsyncTask>& task) {
+    task->abandoned.store(true, std::memory_order_release);
+    task->cancelled = true;
+    task->ok = false;
+    task->error = "cancelled";
+    finish_task(task);
+}
+
+static Value recv_result(bool ok, const std::string& data, bool closed, const std::string& error) {
+    Value out(ObjectType::MAP);
+    out.data.map["ok"] = Value(ok);
+    out.data.map["data"] = Value(data);
+    out.data.map["closed"] = Value(closed);
+    out.data.map["would_block"] = Value(false);
+    out.data.map["error"] = Value(error);
+    return out;
+}
+
+static Value send_result(bool ok, size_t sent, const std::string& error) {
+    Value out(ObjectType::MAP);
+    out.data.map["ok"] = Value(ok);
+    out.data.map["sent"] = Value(static_cast<long>(sent));
+    if (!ok) {
+        out.data.map["would_block"] = Value(false);
+        out.data.map["error"] = Value(error);
+    }
+    return out;
+}
+
+// The reactor reported this socket ready: perform the pending recv/send.
+// Spurious wakeups (EAGAIN) leave the task registered.
+static void run_socket_task(const std::shared_ptr<AsyncTask>& task) {
+#ifdef _WIN32
+    const int flags = 0;
+#else
+    const int flags = MSG_DONTWAIT;
+#endif
+    if (task->kind == AsyncTaskKind::TCP_RECV) {
+        thread_local std::vector<char> buf;
+        buf.resize(static_cast<size_t>(task->max_bytes));
+        int n = static_cast<int>(recv(task->fd, buf.data(), task->max_bytes, flags));
+        if (n < 0 && net_bindings::socket_would_block()) return;
+        if (n > 0) {
+            task->result = recv_result(true, std::string(buf.data(), static_cast<size_t>(n)), false, "");
+        } else if (n == 0) {
+            task->result = recv_result(false, "", true, "");
+        } else {
+            task->ok = false;
+            task->error = "recv failed";
+            task->result = recv_result(false, "", false, task->error);
+        }
+        finish_task(task);
+        return;
+    }
+
+    while (task->send_offset < task->send_data.size()) {
+        const char* p = task->send_data.data() + task->send_offset;
+        int len = static_cast<int>(task->send_data.size() - task->send_offset);
+        int n = static_cast<int>(send(task->fd, p, len, flags));
+        if (n > 0) {
+            task->send_offset += static_cast<size_t>(n);
+            continue;
+        }
+        if (n < 0 && net_bindings::socket_would_block()) return;
+        task->ok = false;
+        task->error = n == 0 ? "send returned 0" : "send failed";
+        task->result = send_result(false, task->send_offset, task->error);
+        finish_task(task);
+        return;
+    }
+    task->result = send_result(true, task->send_offset, "");
+    finish_task(task);
+}
+
+// net.tcp_close: finish the socket's pending recv/send with an error and
+// drop their reactor watches, so nothing waits on (or is refused by) a
+// descriptor that is about to be closed
+void close_socket_tasks(int fd) {
+    std::vector<std::shared_ptr<AsyncTask>> pending;
+    {
+        std::lock_guard<std::mutex> lk(g_async_mu);
+        for (const auto& kv : g_async_tasks) {
+            const std::shared_ptr<AsyncTask>& task = kv.second;
+            if (task->fd == fd && !task->done) pending.push_back(task);
+        }
+    }
+    for (auto& task : pending) {
+        task->ok = false;
+        task->error = "socket closed";
+        task->result = task->kind == AsyncTaskKind::TCP_RECV ? recv_result(false, "", true, task->error)
+                                                             : send_result(false, task->send_offset, task->error);
+        finish_task(task);
+    }
+}
+
+static long reap_workers() {
+    std::vector<std::shared_ptr<AsyncTask>> exited;
+    {
+        std::lock_guard<std::mutex> lk(g_async_mu);
+        auto& workers = g_async_workers;
+        for (size_t i = 0; i < workers.size();) {
+            if (workers[i]->done || workers[i]->worker_done.load(std::memory_order_acquire)) {
+                exited.push_back(workers[i]);
+                workers[i] = workers.back();
+                workers.pop_back();
+            } else {
+                i++;
+            }
+        }
+    }
+    long completed = 0;
+    for (auto& task : exited) {
+        if (task->done) continue;  // Cancelled
+        if (!task->worker_error.empty()) {
+            task->ok = false;
+            task->error = task->worker_error;
+        } else if (task->kind == AsyncTaskKind::HTTP) {
+            task->result = http_bindings::response_to_value(task->worker_response, false);
+            task->body = std::move(task->worker_response.body);
+            task->has_body = true;
+        } else {
+            Value out(ObjectType::MAP);
+            out.data.map["exit_code"] = Value(task->worker_code);
+            out.data.map["ok"] = Value(task->worker_code == 0);
+            task->result = out;
+        }
+        finish_task(task);
+        completed++;
+    }
+    return completed;
+}
+
+// One event-loop pass: wait up to timeout_ms (-1 = until something is ready,
+// 0 = just poll), then complete every task that became ready. Returns how
+// many tasks finished.
+static long tick_tasks(long budget = 256, int timeout_ms = 0) {
+    if (budget <= 0) budget = 1;
+    if (g_async_live.load() <= 0) return 0;  // Nothing could ever become ready
+#ifdef _WIN32
+    if (!reactor().can_wake()) {
+        std::lock_guard<std::mutex> lk(g_async_mu);
+        if (!g_async_workers.empty() && (timeout_ms < 0 || timeout_ms > 10)) timeout_ms = 10;
+    }
+#endif
+    std::vector<long> ready;
+    reactor().wait(timeout_ms, static_cast<size_t>(budget), ready);
+    long completed = 0;
+    for (long id : ready) {
+        auto task = find_task(id);
+        if (!task || task->done) continue;
+        if (task->kind == AsyncTaskKind::TIMER) {
+            task->result = Value(true);
+            finish_task(task);
+        } else {
+            run_socket_task(task);
+        }
+        if (task->done) completed++;
+    }
+    return completed + reap_workers();
+}
+
+// The task's result for Value callers: an HTTP body as a list of ints
+static Value result_value(const AsyncTask& task) {
+    if (!task.has_body) return task.result;
+    Value out = task.result;
+    Value body(ObjectType::LIST);
+    body.data.list.reserve(task.body.size());
+    for (uint8_t byte : task.body) body.data.list.push_back(Value(static_cast<long>(byte)));
+    out.data.map["body"] = body;
+    return out;
+}
+
+// FastVM callers convert task.result themselves and get the body as a
+// string plus body_bytes
+uint64_t attach_body(const AsyncTask& task, uint64_t result) {
+    using namespace native_module_util;
+    if (task.has_body && is_obj(result) && obj_type(result) == ObjType::MAP) {
+        const char* data = reinterpret_cast<const char*>(task.body.data());
+        native_map_set(as_map(result), "body", native_str_val(data, task.body.size()));
+        native_map_set(as_map(result), "body_bytes", native_bytes_val(data, task.body.size()));
+    }
+    return result;
+}
+
+static Value task_status_map(long id, const std::shared_ptr<AsyncTask>& task, bool list_body = true) {
+    Value m(ObjectType::MAP);
+    m.data.map["id"] = Value(id);
+    if (!task) {
+        m.data.map["exists"] = Value(false);
+        m.data.map["done"] = Value(true);
+        m.data.map["ok"] = Value(false);
+        m.data.map["cancelled"] = Value(false);
+        m.data.map["error"] = Value("task not found");
+        m.data.map["result"] = Value();
+        return m;
+    }
+    m.data.map["exists"] = Value(true);
+    m.data.map["done"] = Value(task->done);
+    m.data.map["ok"] = Value(task->ok);
+    m.data.map["cancelled"] = Value(task->cancelled);
+    m.data.map["error"] = Value(task->error);
+    m.data.map["result"] = list_body ? result_value(*task) : task->result;
+    return m;
+}
+
+static int task_socket_fd(const Value& sock, const char* fn) {
+    int fd = net_bindings::take_fd(to_long(sock));
+    if (fd < 0) throw std::runtime_error(std::string(fn) + " invalid socket");
+    return fd;
+}
+
+Value builtin_async_spawn(const std::vector<Value>& args) {
+    std::string cmd = to_string(args.at(0));
+    auto task = std::make_shared<AsyncTask>();
+    task->kind = AsyncTaskKind::PROCESS;
+    long id = add_task(task);
+    offload_task(task, [cmd](AsyncTask& t) { t.worker_code = static_cast<long>(std::system(cmd.c_str())); });
+    return Value(id);
+}
+
+Value builtin_async_sleep(const std::vector<Value>& args) {
+    return Value(start_timer(to_long(args.at(0))));
 }
 
 Value builtin_async_tcp_recv(const std::vector<Value>& args) {
     auto task = std::make_shared<AsyncTask>();
     task->kind = AsyncTaskKind::TCP_RECV;
     task->socket_id = to_long(args.at(0));
+    task->fd = task_socket_fd(args.at(0), "async.tcp_recv");
     task->max_bytes = args.size() >= 2 ? static_cast<int>(to_long(args.at(1))) : 4096;
+    if (task->max_bytes <= 0) task->max_bytes = 1;
     return Value(add_task(task));
 }
 
@@ -20796,96 +25581,174 @@ Value builtin_async_tcp_send(const std::vector<Value>& args) {
     auto task = std::make_shared<AsyncTask>();
     task->kind = AsyncTaskKind::TCP_SEND;
     task->socket_id = to_long(args.at(0));
+    task->fd = task_socket_fd(args.at(0), "async.tcp_send");
     task->send_data = to_string(args.at(1));
     task->send_offset = 0;
     return Value(add_task(task));
 }
 
+// The round trip runs on an offload thread over the shared pooled client;
+// the task completes with the same response map http.request returns
+Value builtin_async_http(const std::vector<Value>& args) {
+    auto task = std::make_shared<AsyncTask>();
+    task->kind = AsyncTaskKind::HTTP;
+    levython::http::HttpRequest req = http_bindings::value_to_request(args.at(0), "async.http");
+    long id = add_task(task);
+    offload_task(task, [req](AsyncTask& t) { t.worker_response = http_bindings::perform_request(req); });
+    return Value(id);
+}
+
 Value builtin_async_tick(const std::vector<Value>& args) {
     long budget = args.empty() ? 256 : to_long(args.at(0));
-    return Value(tick_tasks(budget));
+    int timeout_ms = args.size() >= 2 ? static_cast<int>(to_long(args.at(1))) : -1;
+    return Value(tick_tasks(budget, timeout_ms));
 }
 
 Value builtin_async_done(const std::vector<Value>& args) {
     long id = to_long(args.at(0));
     auto task = find_task(id);
     if (!task) return Value(true);
-    poll_task(task);
+    if (!task->done) tick_tasks();
     return Value(task->done || task->cancelled);
 }
 
 Value builtin_async_status(const std::vector<Value>& args) {
     long id = to_long(args.at(0));
     auto task = find_task(id);
-    if (task) poll_task(task);
+    if (task && !task->done) tick_tasks();
     return task_status_map(id, task);
 }
 
-Value builtin_async_result(const std::vector<Value>& args) {
-    long id = to_long(args.at(0));
+// async.result: the finished task, or null while it is still running
+static std::shared_ptr<AsyncTask> result_task(long id) {
     auto task = find_task(id);
     if (!task) throw std::runtime_error("async.result: task not found");
-    poll_task(task);
-    if (!task->done) return Value();
+    if (!task->done) tick_tasks();
+    if (!task->done) return nullptr;
     if (!task->ok && !task->error.empty()) throw std::runtime_error("async.result: " + task->error);
-    return task->result;
+    return task;
+}
+
+Value builtin_async_result(const std::vector<Value>& args) {
+    auto task = result_task(to_long(args.at(0)));
+    return task ? result_value(*task) : Value();
 }
 
 Value builtin_async_cancel(const std::vector<Value>& args) {
     long id = to_long(args.at(0));
     auto task = find_task(id);
     if (!task) return Value(false);
-    task->cancelled = true;
-    task->done = true;
-    task->ok = false;
-    task->error = "cancelled";
+    cancel_task(task);
     return Value(true);
 }
 
 Value builtin_async_pending(const std::vector<Value>&) {
-    long n = 0;
-    std::vector<std::shared_ptr<AsyncTask>> snapshot;
-    {
-        std::lock_guard<std::mutex> lk(g_async_mu);
-        for (const auto& kv : g_async_tasks) snapshot.push_back(kv.second);
-    }
-    for (auto& t : snapshot) {
-        poll_task(t);
-        if (!t->done && !t->cancelled) n++;
-    }
-    return Value(n);
+    tick_tasks();
+    return Value(std::max(0L, g_async_live.load()));
 }
 
-Value builtin_async_await(const std::vector<Value>& args) {
-    long id = to_long(args.at(0));
-    long timeout_ms = args.size() >= 2 ? to_long(args.at(1)) : -1;
+// async.await: run the loop until the task finishes
+static std::shared_ptr<AsyncTask> await_task(long id, long timeout_ms) {
     auto task = find_task(id);
     if (!task) throw std::runtime_error("async.await: task not found");
     auto start = std::chrono::steady_clock::now();
-    while (true) {
-        poll_task(task);
-        if (task->done || task->cancelled) break;
-        tick_tasks(256);
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    while (!task->done) {
+        int wait_ms = -1;
         if (timeout_ms >= 0) {
             auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
                 std::chrono::steady_clock::now() - start).count();
             if (elapsed >= timeout_ms) {
                 throw std::runtime_error("async.await: timeout");
             }
+            wait_ms = static_cast<int>(std::min<long long>(timeout_ms - elapsed, INT32_MAX));
         }
+        tick_tasks(256, wait_ms);
     }
     if (!task->ok && !task->error.empty()) throw std::runtime_error("async.await: " + task->error);
-    return task->result;
+    return task;
+}
+
+Value builtin_async_await(const std::vector<Value>& args) {
+    long timeout_ms = args.size() >= 2 ? to_long(args.at(1)) : -1;
+    return result_value(*await_task(to_long(args.at(0)), timeout_ms));
+}
+
+// Event-loop calls made once per iteration. spawn and http stay on the
+// Value path: starting the offload job outweighs the argument conversion.
+static int native_task_fd(uint64_t sock, const char* fn) {
+    int fd = net_bindings::take_fd(native_long(sock));
+    if (fd < 0) throw std::runtime_error(std::string(fn) + " invalid socket");
+    return fd;
+}
+
+static uint64_t native_async_sleep(VMContext&, const uint64_t* args, uint8_t argc) {
+    return val_int(start_timer(native_long(native_arg(args, argc, 0))));
+}
+
+static uint64_t native_async_tcp_recv(VMContext&, const uint64_t* args, uint8_t argc) {
+    auto task = std::make_shared<AsyncTask>();
+    task->kind = AsyncTaskKind::TCP_RECV;
+    task->socket_id = native_long(native_arg(args, argc, 0));
+    task->fd = native_task_fd(args[0], "async.tcp_recv");
+    task->max_bytes = argc >= 2 ? static_cast<int>(native_long(args[1])) : 4096;
+    if (task->max_bytes <= 0) task->max_bytes = 1;
+    return val_int(add_task(task));
+}
+
+// The payload is copied once, straight from the string or bytes buffer
+static uint64_t native_async_tcp_send(VMContext&, const uint64_t* args, uint8_t argc) {
+    auto task = std::make_shared<AsyncTask>();
+    task->kind = AsyncTaskKind::TCP_SEND;
+    task->socket_id = native_long(native_arg(args, argc, 0));
+    task->fd = native_task_fd(args[0], "async.tcp_send");
+    std::string tmp;
+    task->send_data.assign(native_string(native_arg(args, argc, 1), tmp));
+    task->send_offset = 0;
+    return val_int(add_task(task));
+}
+
+static uint64_t native_async_tick(VMContext&, const uint64_t* args, uint8_t argc) {
+    long budget = argc == 0 ? 256 : native_long(args[0]);
+    int timeout_ms = argc >= 2 ? static_cast<int>(native_long(args[1])) : -1;
+    return val_int(tick_tasks(budget, timeout_ms));
+}
+
+static uint64_t native_async_done(VMContext&, const uint64_t* args, uint8_t argc) {
+    auto task = find_task(native_long(native_arg(args, argc, 0)));
+    if (!task) return VAL_TRUE;
+    if (!task->done) tick_tasks();
+    return (task->done || task->cancelled) ? VAL_TRUE : VAL_FALSE;
 }
 
+static uint64_t native_async_cancel(VMContext&, const uint64_t* args, uint8_t argc) {
+    auto task = find_task(native_long(native_arg(args, argc, 0)));
+    if (!task) return VAL_FALSE;
+    cancel_task(task);
+    return VAL_TRUE;
+}
+
+static uint64_t native_async_pending(VMContext&, const uint64_t*, uint8_t) {
+    tick_tasks();
+    return val_int(std::max(0L, g_async_live.load()));
+}
+
+// status, result and await are defined after FastVM, where an HTTP body
+// can be handed over as bytes
+const native_module_util::NativeEntry natives[] = {
+    {"sleep", native_async_sleep}, {"tcp_recv", native_async_tcp_recv}, {"tcp_send", native_async_tcp_send},
+    {"tick", native_async_tick}, {"done", native_async_done}, {"cancel", native_async_cancel},
+    {"pending", native_async_pending},
+    {"status", native_async_status}, {"result", native_async_result}, {"await", native_async_await},
+};
+
 Value create_async_module() {
     Value m(ObjectType::MAP);
     m.data.map["spawn"] = make_builtin("spawn", "async_spawn", {"command"});
     m.data.map["sleep"] = make_builtin("sleep", "async_sleep", {"ms"});
     m.data.map["tcp_recv"] = make_builtin("tcp_recv", "async_tcp_recv", {"socket", "max_bytes"});
     m.data.map["tcp_send"] = make_builtin("tcp_send", "async_tcp_send", {"socket", "data"});
-    m.data.map["tick"] = make_builtin("tick", "async_tick", {"budget"});
+    m.data.map["http"] = make_builtin("http", "async_http", {"request"});
+    m.data.map["tick"] = make_builtin("tick", "async_tick", {"budget", "timeout_ms"});
     m.data.map["done"] = make_builtin("done", "async_done", {"task_id"});
     m.data.map["status"] = make_builtin("status", "async_status", {"task_id"});
     m.data.map["result"] = make_builtin("result", "async_result", {"task_id"});
@@ -20897,62 +25760,606 @@ Value create_async_module() {
 } // namespace async_bindings
 
 // ============================================================================
-// BYTECODE COMPILER - Transforms AST to bytecode
+// GLOBAL SLOTS - Compile-time name -> dense index table
 // ============================================================================
-class Compiler {
-    std::shared_ptr<Chunk> chunk;
-    struct Local { std::string name; int depth; };
-    std::vector<Local> locals;
-    int scope_depth = 0;
-    
-    // Track loops for break/continue
-    struct LoopContext {
-        size_t start;       // Loop start for continue
-        std::vector<size_t> breaks;  // Break jumps to patch
-    };
-    std::vector<LoopContext> loops;
-
+// Every global name the Compiler sees gets a stable 16-bit slot, so
+// OP_GET_GLOBAL / OP_SET_GLOBAL index a flat vector instead of hashing.
+class GlobalSlots {
+    std::unordered_map<ObjString*, uint16_t> index;
+    std::vector<ObjString*> names;
+    mutable std::mutex mu;  // Isolates compile imports concurrently
 public:
-    std::shared_ptr<Chunk> compile(ASTNode* node) {
-        chunk = std::make_shared<Chunk>();
-        compile_node(node);
-        emit(OpCode::OP_RETURN);
-        return chunk;
-    }
-    
-    std::shared_ptr<Chunk> compile_function(ASTNode* node) {
-        chunk = std::make_shared<Chunk>();
-        begin_scope();
-        locals.push_back({"", scope_depth});  // Slot 0 for function
-        for (const auto& param : node->params) {
-            locals.push_back({param, scope_depth});
-        }
-        if (!node->children.empty()) compile_node(node->children[0].get());
-        emit(OpCode::OP_NONE);
-        emit(OpCode::OP_RETURN);
-        end_scope();
-        return chunk;
-    }
-    
-    // Compile a class method - 'self' is always slot 0
-    std::shared_ptr<Chunk> compile_method(ASTNode* node) {
-        chunk = std::make_shared<Chunk>();
-        begin_scope();
-        locals.push_back({"self", scope_depth});  // Slot 0 for 'self'
-        for (const auto& param : node->params) {
-            locals.push_back({param, scope_depth});
-        }
-        if (!node->children.empty()) compile_node(node->children[0].get());
-        emit(OpCode::OP_NONE);
-        emit(OpCode::OP_RETURN);
-        end_scope();
-        return chunk;
+    uint16_t resolve(ObjString* name) {
+        std::lock_guard<std::mutex> lk(mu);
+        auto it = index.find(name);
+        if (it != index.end()) return it->second;
+        if (names.size() > UINT16_MAX) {
+            throw std::runtime_error("Too many global variables");
+        }
+        uint16_t slot = (uint16_t)names.size();
+        names.push_back(name);
+        index[name] = slot;
+        return slot;
+    }
+    uint16_t resolve(const std::string& name) { return resolve(g_strings.intern(name)); }
+    int find(ObjString* name) const {
+        std::lock_guard<std::mutex> lk(mu);
+        auto it = index.find(name);
+        return it == index.end() ? -1 : it->second;
+    }
+    ObjString* name_of(uint16_t slot) const {
+        std::lock_guard<std::mutex> lk(mu);
+        return names[slot];
+    }
+    size_t size() const {
+        std::lock_guard<std::mutex> lk(mu);
+        return names.size();
     }
+};
 
-private:
-    void emit(OpCode op) { chunk->write_op(op); }
-    void emit_byte(uint8_t b) { chunk->write(b); }
+static GlobalSlots g_global_slots;
+
+// ============================================================================
+// BYTECODE PASSES - Peephole optimizer and disassembler
+// ============================================================================
+// Every chunk the Compiler finishes goes through optimize(): conditional
+// jumps absorb the POPs of their condition, the common local/constant/compare
+// sequences become superinstructions, jump chains are threaded and
+// unreachable code is dropped. --dump-bytecode prints the result.
+namespace bytecode {
+
+// Encoded size of the instruction at pc, or 0 if its layout is unknown here
+static size_t instruction_length(const uint8_t* code, size_t pc, size_t size) {
+    switch ((OpCode)code[pc]) {
+        case OpCode::OP_CONST: case OpCode::OP_GET_GLOBAL: case OpCode::OP_SET_GLOBAL:
+        case OpCode::OP_DEFINE_GLOBAL: case OpCode::OP_APPEND_GLOBAL:
+        case OpCode::OP_JUMP: case OpCode::OP_JUMP_IF_FALSE: case OpCode::OP_LOOP:
+        case OpCode::OP_ITER_NEXT: case OpCode::OP_GET_PROPERTY: case OpCode::OP_SET_PROPERTY:
+        case OpCode::OP_TRY: case OpCode::OP_IMPORT: case OpCode::OP_MODULE_EXPORTS:
+        case OpCode::OP_POP_JUMP_IF_FALSE:
+        case OpCode::OP_JUMP_IF_NOT_EQ: case OpCode::OP_JUMP_IF_NOT_NE:
+        case OpCode::OP_JUMP_IF_NOT_LT: case OpCode::OP_JUMP_IF_NOT_GT:
+        case OpCode::OP_JUMP_IF_NOT_LE: case OpCode::OP_JUMP_IF_NOT_GE:
+        case OpCode::OP_ADD_LOCALS: case OpCode::OP_INC_LOCAL:
+            return 3;
+        case OpCode::OP_CONST_INT: case OpCode::OP_GET_LOCAL: case OpCode::OP_SET_LOCAL:
+        case OpCode::OP_APPEND_LOCAL: case OpCode::OP_GET_LOCAL_SEAL: case OpCode::OP_ITER_POP:
+        case OpCode::OP_CALL: case OpCode::OP_BUILTIN_RANGE: case OpCode::OP_BUILTIN_ASK:
+        case OpCode::OP_BUILTIN_MIN: case OpCode::OP_BUILTIN_MAX: case OpCode::OP_BUILTIN_PRINT:
+        case OpCode::OP_BUILTIN_PRINTLN: case OpCode::OP_BUILTIN_GETATTR:
+        case OpCode::OP_BUILD_LIST: case OpCode::OP_BUILD_MAP: case OpCode::OP_BUILD_TUPLE:
+        case OpCode::OP_UNPACK_TUPLE: case OpCode::OP_FAST_LOOP_SUM: case OpCode::OP_FAST_LOOP_COUNT:
+        case OpCode::OP_AWAIT: case OpCode::OP_TENSOR_CREATE: case OpCode::OP_TENSOR_RESHAPE:
+        case OpCode::OP_TENSOR_FROM: case OpCode::OP_BYTES_NEW: case OpCode::OP_BYTES_SLICE:
+        case OpCode::OP_INDEX_LOCAL:
+            return 2;
+        case OpCode::OP_METHOD_CALL: case OpCode::OP_INVOKE_METHOD: case OpCode::OP_SUPER_INVOKE:
+            return 4;
+        case OpCode::OP_JUMP_IF_LOCAL_NOT_LT:
+            return 5;
+        case OpCode::OP_CLASS_DEF:
+            // name, 8-byte class pointer, has-parent flag, parent slot if set
+            if (pc + 11 >= size) return 0;
+            return code[pc + 11] ? 14 : 12;
+        case OpCode::OP_FAST_LOOP_GENERIC:
+            return 0;
+        default:
+            return 1;
+    }
+}
+
+// Byte offset of a branch's 16-bit operand within the instruction, or 0 if
+// it doesn't branch. Offsets count from the next instruction; OP_LOOP's
+// points backwards.
+static size_t branch_operand(OpCode op) {
+    switch (op) {
+        case OpCode::OP_JUMP: case OpCode::OP_JUMP_IF_FALSE: case OpCode::OP_LOOP:
+        case OpCode::OP_ITER_NEXT: case OpCode::OP_TRY: case OpCode::OP_POP_JUMP_IF_FALSE:
+        case OpCode::OP_JUMP_IF_NOT_EQ: case OpCode::OP_JUMP_IF_NOT_NE:
+        case OpCode::OP_JUMP_IF_NOT_LT: case OpCode::OP_JUMP_IF_NOT_GT:
+        case OpCode::OP_JUMP_IF_NOT_LE: case OpCode::OP_JUMP_IF_NOT_GE:
+            return 1;
+        case OpCode::OP_JUMP_IF_LOCAL_NOT_LT:
+            return 3;
+        default:
+            return 0;
+    }
+}
+
+static size_t branch_target(const uint8_t* code, size_t pc, size_t len) {
+    size_t at = pc + branch_operand((OpCode)code[pc]);
+    size_t off = code[at] | (code[at + 1] << 8);
+    return (OpCode)code[pc] == OpCode::OP_LOOP ? pc + len - off : pc + len + off;
+}
+
+struct Insn {
+    uint8_t bytes[14];
+    uint8_t len;
+    uint32_t old_pc;          // Where the (first fused) instruction started
+    bool rewritten = false;   // Fused or replaced: no longer the original bytes
+    bool live = true;
+    size_t target = SIZE_MAX; // Instruction index a branch lands on
+
+    OpCode op() const { return (OpCode)bytes[0]; }
+    void set(OpCode op, std::initializer_list<uint8_t> operands) {
+        bytes[0] = (uint8_t)op;
+        len = 1;
+        for (uint8_t b : operands) bytes[len++] = b;
+        rewritten = true;
+    }
+};
+
+static bool is_branch(const Insn& in) { return branch_operand(in.op()) != 0; }
+
+// Drops dead instructions; a branch to one lands on the next live one
+static void compact(std::vector<Insn>& insns) {
+    std::vector<size_t> remap(insns.size() + 1);
+    size_t live = 0;
+    for (size_t i = 0; i < insns.size(); i++) {
+        remap[i] = live;
+        if (insns[i].live) live++;
+    }
+    remap[insns.size()] = live;
+    std::vector<Insn> out;
+    out.reserve(live);
+    for (Insn& in : insns) {
+        if (!in.live) continue;
+        if (is_branch(in)) in.target = remap[in.target];
+        out.push_back(in);
+    }
+    insns.swap(out);
+}
+
+static std::vector<uint32_t> incoming_branches(const std::vector<Insn>& insns) {
+    std::vector<uint32_t> incoming(insns.size() + 1, 0);
+    for (const Insn& in : insns) {
+        if (in.live && is_branch(in)) incoming[in.target]++;
+    }
+    return incoming;
+}
+
+static bool is_op(const std::vector<Insn>& insns, size_t i, OpCode op) {
+    return i < insns.size() && insns[i].op() == op;
+}
+
+// JUMP_IF_FALSE leaves its condition for a POP on each path; when both
+// paths start with one, POP_JUMP_IF_FALSE pops it and jumps past the
+// target's POP (which stays for any other way in)
+static void fuse_condition_pops(std::vector<Insn>& insns) {
+    std::vector<uint32_t> incoming = incoming_branches(insns);
+    for (size_t i = 0; i < insns.size(); i++) {
+        Insn& in = insns[i];
+        if (in.op() != OpCode::OP_JUMP_IF_FALSE || !is_op(insns, i + 1, OpCode::OP_POP) ||
+            incoming[i + 1] || !is_op(insns, in.target, OpCode::OP_POP)) {
+            continue;
+        }
+        incoming[in.target]--;
+        in.target++;
+        incoming[in.target]++;
+        in.set(OpCode::OP_POP_JUMP_IF_FALSE, {0, 0});
+        insns[i + 1].live = false;
+        i++;
+    }
+    compact(insns);
+}
+
+static void fuse_superinstructions(std::vector<Insn>& insns) {
+    std::vector<uint32_t> incoming = incoming_branches(insns);
+    // n instructions from i, none but the first a branch target
+    auto run = [&](size_t i, size_t n) {
+        if (i + n > insns.size()) return false;
+        for (size_t k = 1; k < n; k++) {
+            if (incoming[i + k]) return false;
+        }
+        return true;
+    };
+    auto op = [&](size_t i) { return insns[i].op(); };
+    auto arg = [&](size_t i) { return insns[i].bytes[1]; };
+    auto kill = [&](size_t i, size_t n) {
+        for (size_t k = 1; k < n; k++) insns[i + k].live = false;
+    };
+    for (size_t i = 0; i < insns.size(); i++) {
+        Insn& in = insns[i];
+        if (in.op() == OpCode::OP_GET_LOCAL) {
+            // x <- x + k / x <- x - k as a statement
+            if (run(i, 5) && op(i + 1) == OpCode::OP_CONST_INT &&
+                (op(i + 2) == OpCode::OP_ADD || op(i + 2) == OpCode::OP_SUB) &&
+                op(i + 3) == OpCode::OP_SET_LOCAL && arg(i + 3) == arg(i) &&
+                op(i + 4) == OpCode::OP_POP) {
+                int delta = op(i + 2) == OpCode::OP_ADD ? arg(i + 1) : -(int)arg(i + 1);
+                if (delta >= -128 && delta <= 127) {
+                    in.set(OpCode::OP_INC_LOCAL, {arg(i), (uint8_t)(int8_t)delta});
+                    kill(i, 5);
+                    i += 4;
+                    continue;
+                }
+            }
+            // while x < k
+            if (run(i, 4) && op(i + 1) == OpCode::OP_CONST_INT && op(i + 2) == OpCode::OP_LT &&
+                op(i + 3) == OpCode::OP_POP_JUMP_IF_FALSE) {
+                in.set(OpCode::OP_JUMP_IF_LOCAL_NOT_LT, {arg(i), arg(i + 1), 0, 0});
+                in.target = insns[i + 3].target;
+                kill(i, 4);
+                i += 3;
+                continue;
+            }
+            if (run(i, 3) && op(i + 1) == OpCode::OP_GET_LOCAL && op(i + 2) == OpCode::OP_ADD) {
+                in.set(OpCode::OP_ADD_LOCALS, {arg(i), arg(i + 1)});
+                kill(i, 3);
+                i += 2;
+                continue;
+            }
+            if (run(i, 2) && op(i + 1) == OpCode::OP_GET_INDEX) {
+                in.set(OpCode::OP_INDEX_LOCAL, {arg(i)});
+                kill(i, 2);
+                i += 1;
+                continue;
+            }
+        } else if (in.op() >= OpCode::OP_EQ && in.op() <= OpCode::OP_GE) {
+            // Compare-and-branch
+            if (run(i, 2) && op(i + 1) == OpCode::OP_POP_JUMP_IF_FALSE) {
+                OpCode fused = (OpCode)((uint8_t)OpCode::OP_JUMP_IF_NOT_EQ +
+                                        ((uint8_t)in.op() - (uint8_t)OpCode::OP_EQ));
+                in.set(fused, {0, 0});
+                in.target = insns[i + 1].target;
+                kill(i, 2);
+                i += 1;
+                continue;
+            }
+        }
+    }
+    compact(insns);
+}
+
+// Forward branches skip over JUMPs; a JUMP to a back-edge becomes the
+// back-edge. Returns whether anything changed.
+static bool thread_jumps(std::vector<Insn>& insns) {
+    bool changed = false;
+    for (size_t i = 0; i < insns.size(); i++) {
+        Insn& in = insns[i];
+        if (!is_branch(in) || in.op() == OpCode::OP_LOOP || in.op() == OpCode::OP_TRY) continue;
+        size_t t = in.target;
+        while (is_op(insns, t, OpCode::OP_JUMP) && insns[t].target != t) t = insns[t].target;
+        if (t != in.target) {
+            in.target = t;
+            changed = true;
+        }
+        if (in.op() == OpCode::OP_JUMP && is_op(insns, t, OpCode::OP_LOOP) && insns[t].target <= i) {
+            in.set(OpCode::OP_LOOP, {0, 0});
+            in.target = insns[t].target;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+// Removes instructions no path from the entry reaches, and JUMPs to the
+// next instruction. Returns whether anything changed.
+static bool remove_dead_code(std::vector<Insn>& insns) {
+    size_t n = insns.size();
+    std::vector<bool> reached(n + 1, false);
+    std::vector<size_t> work;
+    if (n > 0) { reached[0] = true; work.push_back(0); }
+    auto visit = [&](size_t i) {
+        if (i < n && !reached[i]) { reached[i] = true; work.push_back(i); }
+    };
+    while (!work.empty()) {
+        size_t i = work.back();
+        work.pop_back();
+        OpCode op = insns[i].op();
+        if (is_branch(insns[i])) visit(insns[i].target);
+        if (op != OpCode::OP_JUMP && op != OpCode::OP_LOOP && op != OpCode::OP_RETURN) visit(i + 1);
+    }
+    bool changed = false;
+    for (size_t i = 0; i < n; i++) {
+        bool jump_to_next = insns[i].op() == OpCode::OP_JUMP && insns[i].target == i + 1;
+        if (!reached[i] || jump_to_next) {
+            insns[i].live = false;
+            changed = true;
+        }
+    }
+    if (changed) compact(insns);
+    return changed;
+}
+
+static void optimize(Chunk& c) {
+    const std::vector<uint8_t>& code = c.code;
+    size_t size = code.size();
+    std::vector<Insn> insns;
+    std::vector<size_t> index_of(size + 1, SIZE_MAX);
+    for (size_t pc = 0; pc < size;) {
+        size_t len = instruction_length(code.data(), pc, size);
+        if (len == 0 || pc + len > size) return;  // Unknown layout: leave the chunk as is
+        index_of[pc] = insns.size();
+        Insn in;
+        std::memcpy(in.bytes, &code[pc], len);
+        in.len = (uint8_t)len;
+        in.old_pc = (uint32_t)pc;
+        insns.push_back(in);
+        pc += len;
+    }
+    index_of[size] = insns.size();
+    for (Insn& in : insns) {
+        if (!is_branch(in)) continue;
+        size_t t = branch_target(code.data(), in.old_pc, in.len);
+        if (t > size || index_of[t] == SIZE_MAX) return;  // Lands mid-instruction
+        in.target = index_of[t];
+    }
+
+    fuse_condition_pops(insns);
+    fuse_superinstructions(insns);
+    for (int round = 0; round < 4; round++) {
+        bool changed = thread_jumps(insns);
+        changed |= remove_dead_code(insns);
+        if (!changed) break;
+    }
+
+    // Re-encode; give up if a threaded jump no longer fits its operand
+    size_t n = insns.size();
+    std::vector<size_t> new_pc(n + 1);
+    size_t pc = 0;
+    for (size_t i = 0; i < n; i++) {
+        new_pc[i] = pc;
+        pc += insns[i].len;
+    }
+    new_pc[n] = pc;
+    std::vector<uint8_t> out(pc);
+    std::vector<size_t> survivor(size, SIZE_MAX);  // Old start -> new index, for operand refs
+    for (size_t i = 0; i < n; i++) {
+        Insn& in = insns[i];
+        if (is_branch(in)) {
+            size_t next = new_pc[i] + in.len;
+            bool back = in.op() == OpCode::OP_LOOP;
+            if (back ? in.target > i : in.target <= i) return;
+            size_t off = back ? next - new_pc[in.target] : new_pc[in.target] - next;
+            if (off > UINT16_MAX) return;
+            size_t at = branch_operand(in.op());
+            in.bytes[at] = off & 0xFF;
+            in.bytes[at + 1] = (off >> 8) & 0xFF;
+        }
+        std::memcpy(&out[new_pc[i]], in.bytes, in.len);
+        if (!in.rewritten) survivor[in.old_pc] = i;
+    }
+
+    // Move global slot and embedded object offsets with their instructions;
+    // refs inside removed code go away
+    std::vector<uint32_t> starts;
+    for (size_t p = 0; p < size; p++) {
+        if (index_of[p] != SIZE_MAX) starts.push_back((uint32_t)p);
+    }
+    auto relocate = [&](uint32_t off, uint32_t& moved) {
+        uint32_t start = *(std::upper_bound(starts.begin(), starts.end(), off) - 1);
+        size_t i = survivor[start];
+        if (i == SIZE_MAX) return false;
+        moved = (uint32_t)(new_pc[i] + (off - start));
+        return true;
+    };
+    std::vector<uint32_t> global_refs;
+    for (uint32_t off : c.global_refs) {
+        uint32_t moved;
+        if (relocate(off, moved)) global_refs.push_back(moved);
+    }
+    std::vector<uint64_t> objects;
+    std::vector<uint32_t> object_offsets;
+    for (size_t k = 0; k < c.embedded_offsets.size(); k++) {
+        uint32_t moved;
+        if (relocate(c.embedded_offsets[k], moved)) {
+            objects.push_back(c.embedded_objects[k]);
+            object_offsets.push_back(moved);
+        }
+    }
+    c.code.swap(out);
+    c.global_refs.swap(global_refs);
+    c.embedded_objects.swap(objects);
+    c.embedded_offsets.swap(object_offsets);
+}
+
+static std::string constant_text(const Chunk& c, size_t idx) {
+    if (idx >= c.constants.size()) return "?";
+    const Value& v = c.constants[idx];
+    if (v.type == ObjectType::STRING) return "'" + v.data.string + "'";
+    if (v.type == ObjectType::FUNCTION) return "<fn " + v.data.compiled_func.name + ">";
+    return v.to_string();
+}
+
+// One line per instruction, then every function and method chunk it holds
+static void disassemble(const Chunk& c, const std::string& name, std::ostream& out) {
+    const uint8_t* code = c.code.data();
+    size_t size = c.code.size();
+    out << "== " << name << " (" << size << " bytes) ==\n";
+    auto u16 = [&](size_t at) { return (size_t)(code[at] | (code[at + 1] << 8)); };
+    char line[160];
+    for (size_t pc = 0; pc < size;) {
+        OpCode op = (OpCode)code[pc];
+        size_t len = instruction_length(code, pc, size);
+        if (len == 0 || pc + len > size) {
+            std::snprintf(line, sizeof(line), "%04zu  %-22s (layout unknown, stopping)\n", pc,
+                          OPCODE_NAMES[code[pc]]);
+            out << line;
+            break;
+        }
+        std::string args;
+        char buf[96];
+        switch (op) {
+            case OpCode::OP_CONST: case OpCode::OP_GET_PROPERTY: case OpCode::OP_SET_PROPERTY:
+            case OpCode::OP_IMPORT: case OpCode::OP_MODULE_EXPORTS: case OpCode::OP_CLASS_DEF:
+                std::snprintf(buf, sizeof(buf), "%zu ", u16(pc + 1));
+                args = buf + constant_text(c, u16(pc + 1));
+                break;
+            case OpCode::OP_GET_GLOBAL: case OpCode::OP_SET_GLOBAL:
+            case OpCode::OP_DEFINE_GLOBAL: case OpCode::OP_APPEND_GLOBAL:
+                std::snprintf(buf, sizeof(buf), "%zu ", u16(pc + 1));
+                args = buf + g_global_slots.name_of((uint16_t)u16(pc + 1))->str();
+                break;
+            case OpCode::OP_METHOD_CALL:
+                std::snprintf(buf, sizeof(buf), "argc %u, %zu ", code[pc + 1], u16(pc + 2));
+                args = buf + constant_text(c, u16(pc + 2));
+                break;
+            case OpCode::OP_INVOKE_METHOD: case OpCode::OP_SUPER_INVOKE:
+                std::snprintf(buf, sizeof(buf), "%zu ", u16(pc + 1));
+                args = buf + constant_text(c, u16(pc + 1)) + ", argc " + std::to_string(code[pc + 3]);
+                break;
+            case OpCode::OP_ADD_LOCALS:
+                std::snprintf(buf, sizeof(buf), "%u %u", code[pc + 1], code[pc + 2]);
+                args = buf;
+                break;
+            case OpCode::OP_INC_LOCAL:
+                std::snprintf(buf, sizeof(buf), "%u %+d", code[pc + 1], (int)(int8_t)code[pc + 2]);
+                args = buf;
+                break;
+            case OpCode::OP_JUMP_IF_LOCAL_NOT_LT:
+                std::snprintf(buf, sizeof(buf), "%u %u -> %04zu", code[pc + 1], code[pc + 2],
+                              branch_target(code, pc, len));
+                args = buf;
+                break;
+            default:
+                if (branch_operand(op)) {
+                    std::snprintf(buf, sizeof(buf), "-> %04zu", branch_target(code, pc, len));
+                    args = buf;
+                } else if (len == 2) {
+                    args = std::to_string(code[pc + 1]);
+                }
+                break;
+        }
+        std::snprintf(line, sizeof(line), "%04zu  %-22s ", pc, OPCODE_NAMES[code[pc]]);
+        out << line << args << "\n";
+        pc += len;
+    }
+    for (const Value& v : c.constants) {
+        if (v.type == ObjectType::FUNCTION && v.data.compiled_func.chunk) {
+            out << "\n";
+            disassemble(*v.data.compiled_func.chunk, v.data.compiled_func.name, out);
+        }
+    }
+    for (uint64_t obj : c.embedded_objects) {
+        if (!is_class(obj)) continue;
+        ObjClass* klass = as_class(obj);
+        std::vector<std::string> methods;
+        for (const auto& m : klass->methods) methods.push_back(m.first);
+        std::sort(methods.begin(), methods.end());
+        for (const std::string& m : methods) {
+            out << "\n";
+            disassemble(*as_func(klass->methods[m])->chunk, klass->name->str() + "." + m, out);
+        }
+    }
+}
+
+}  // namespace bytecode
+
+// ============================================================================
+// BYTECODE COMPILER - Transforms AST to bytecode
+// ============================================================================
+class Compiler {
+    std::shared_ptr<Chunk> chunk;
+    struct Local { std::string name; int depth; };
+    std::vector<Local> locals;
+    int scope_depth = 0;
+    
+    // Track loops for break/continue
+    struct LoopContext {
+        size_t start;       // Loop start for continue
+        std::vector<size_t> breaks;  // Break jumps to patch
+        bool for_in = false;         // Holds a VM iterator that break/return must drop
+    };
+    std::vector<LoopContext> loops;
+
+    // Set while compiling an imported module: its top-level names live in
+    // their own global slots ("<module>.<name>") so they can't clobber the
+    // importer's globals. Shared with nested function/method compilers.
+    struct ModuleScope {
+        std::string prefix;
+        std::unordered_set<std::string> names;
+    };
+    std::shared_ptr<ModuleScope> module_scope;
+
+    // Variables built up by appending (s <- "" ... s <- s + piece); they
+    // compile to OP_APPEND_LOCAL/OP_APPEND_GLOBAL and OP_GET_LOCAL_SEAL.
+    std::unordered_set<std::string> string_builders;
+
+public:
+    std::shared_ptr<Chunk> compile(ASTNode* node) {
+        chunk = std::make_shared<Chunk>();
+        find_string_builders(node);
+        compile_node(node);
+        emit(OpCode::OP_NONE);  // OP_RETURN pops a result; keep sp inside the stack
+        emit(OpCode::OP_RETURN);
+        finish();
+        return chunk;
+    }
+    
+    std::shared_ptr<Chunk> compile_function(ASTNode* node) {
+        chunk = std::make_shared<Chunk>();
+        begin_scope();
+        locals.push_back({"", scope_depth});  // Slot 0 for function
+        for (const auto& param : node->params) {
+            locals.push_back({param, scope_depth});
+        }
+        if (!node->children.empty()) {
+            find_string_builders(node->children[0].get());
+            compile_node(node->children[0].get());
+        }
+        emit(OpCode::OP_NONE);
+        emit(OpCode::OP_RETURN);
+        end_scope();
+        finish();
+        return chunk;
+    }
+    
+    // Compile a local .levy/.ly module; the body ends with OP_MODULE_EXPORTS,
+    // so running the chunk as a call frame returns the module's exports map
+    std::shared_ptr<Chunk> compile_module(ASTNode* node, const std::string& module_name) {
+        chunk = std::make_shared<Chunk>();
+        module_scope = std::make_shared<ModuleScope>();
+        module_scope->prefix = module_name + ".";
+        collect_module_names(node, module_scope->names);
+        find_string_builders(node);
+        compile_node(node);
+        for (const auto& name : module_scope->names) {
+            chunk->module_exports.push_back({g_strings.intern(name), global_slot(name)});
+        }
+        emit(OpCode::OP_MODULE_EXPORTS);
+        emit_short(chunk->add_constant(Value(module_name)));
+        emit(OpCode::OP_RETURN);
+        finish();
+        return chunk;
+    }
+
+    // Compile a class method - 'self' is always slot 0
+    std::shared_ptr<Chunk> compile_method(ASTNode* node) {
+        chunk = std::make_shared<Chunk>();
+        begin_scope();
+        locals.push_back({"self", scope_depth});  // Slot 0 for 'self'
+        for (const auto& param : node->params) {
+            locals.push_back({param, scope_depth});
+        }
+        if (!node->children.empty()) {
+            find_string_builders(node->children[0].get());
+            compile_node(node->children[0].get());
+        }
+        emit(OpCode::OP_NONE);
+        emit(OpCode::OP_RETURN);
+        end_scope();
+        finish();
+        return chunk;
+    }
+
+private:
+    // Peephole pass, then the constant table the VM reads
+    void finish() {
+        bytecode::optimize(*chunk);
+        chunk->materialize_constants();
+    }
+
+    void emit(OpCode op) { chunk->write_op(op); }
+    void emit_byte(uint8_t b) { chunk->write(b); }
     void emit_short(uint16_t s) { chunk->write(s & 0xFF); chunk->write((s >> 8) & 0xFF); }
+    // Slot operands are recorded so a cached chunk can be rebound to slots
+    // assigned in a later process
+    void emit_global(const std::string& name) {
+        uint16_t slot = global_slot(name);
+        chunk->global_refs.push_back(static_cast<uint32_t>(chunk->code.size()));
+        emit_short(slot);
+    }
     void emit_constant(const Value& v) {
         size_t idx = chunk->add_constant(v);
         emit(OpCode::OP_CONST);
@@ -20987,6 +26394,115 @@ private:
             if (locals[i].name == name) return i;
         return -1;
     }
+    uint16_t global_slot(const std::string& name) {
+        if (module_scope && module_scope->names.count(name)) {
+            return g_global_slots.resolve(module_scope->prefix + name);
+        }
+        return g_global_slots.resolve(name);
+    }
+    // Names a module binds at top level (function and class bodies excluded)
+    static void collect_module_names(ASTNode* node, std::unordered_set<std::string>& names) {
+        if (!node) return;
+        switch (node->type) {
+            case NodeType::ASSIGN:
+                if (node->children[0]->type != NodeType::INDEX &&
+                    node->children[0]->type != NodeType::GET_ATTR) {
+                    names.insert(node->value.empty() ? node->children[0]->token.lexeme : node->value);
+                }
+                break;
+            case NodeType::COMPOUND_ASSIGN:
+                names.insert(node->children[0]->token.lexeme);
+                break;
+            case NodeType::FUNCTION:
+                names.insert(node->value);
+                return;
+            case NodeType::CLASS:
+                names.insert(node->class_name);
+                return;
+            case NodeType::IMPORT:
+                names.insert(node->value);
+                return;
+            default: break;
+        }
+        for (auto& child : node->children) collect_module_names(child.get(), names);
+    }
+
+    // A string literal, or a + chain containing one
+    static bool is_string_expr(const ASTNode* node) {
+        if (!node) return false;
+        if (node->type == NodeType::LITERAL) return node->token.type == TokType::STRING;
+        if (node->type == NodeType::BINARY && node->token.type == TokType::PLUS) {
+            return is_string_expr(node->children[0].get()) || is_string_expr(node->children[1].get());
+        }
+        return false;
+    }
+    static bool mentions(const ASTNode* node, const std::string& name) {
+        if (!node) return false;
+        if (node->type == NodeType::VARIABLE && node->token.lexeme == name) return true;
+        for (const auto& child : node->children) {
+            if (mentions(child.get(), name)) return true;
+        }
+        return false;
+    }
+    // Right operands of "name + a + b ...", or false if the chain doesn't start at name
+    static bool append_operands(ASTNode* node, const std::string& name, std::vector<ASTNode*>& out) {
+        if (!node) return false;
+        if (node->type == NodeType::VARIABLE && node->token.lexeme == name) return true;
+        if (node->type != NodeType::BINARY || node->token.type != TokType::PLUS) return false;
+        if (!append_operands(node->children[0].get(), name, out)) return false;
+        out.push_back(node->children[1].get());
+        return true;
+    }
+    static void scan_string_builders(ASTNode* node, std::unordered_set<std::string>& seeded,
+                                     std::unordered_set<std::string>& appended) {
+        if (!node || node->type == NodeType::FUNCTION || node->type == NodeType::CLASS) return;
+        if (node->type == NodeType::ASSIGN && node->children[0]->type != NodeType::INDEX &&
+            node->children[0]->type != NodeType::GET_ATTR) {
+            std::string name = node->value.empty() ? node->children[0]->token.lexeme : node->value;
+            std::vector<ASTNode*> operands;
+            if (append_operands(node->children[1].get(), name, operands) && !operands.empty()) appended.insert(name);
+            else if (is_string_expr(node->children[1].get())) seeded.insert(name);
+        } else if (node->type == NodeType::COMPOUND_ASSIGN && node->value == "+=") {
+            appended.insert(node->children[0]->token.lexeme);
+        }
+        for (auto& child : node->children) scan_string_builders(child.get(), seeded, appended);
+    }
+    // Locals that start as a string and are then appended to
+    void find_string_builders(ASTNode* body) {
+        std::unordered_set<std::string> seeded, appended;
+        scan_string_builders(body, seeded, appended);
+        for (const auto& name : appended) {
+            if (seeded.count(name)) string_builders.insert(name);
+        }
+
+    }
+    // name <- name + a + b as a run of appends. Declines unless name is a
+    // builder and no operand after the first reads it (the earlier appends
+    // would already be visible).
+    bool compile_append(const std::string& name, ASTNode* value) {
+        if (!string_builders.count(name)) return false;
+        std::vector<ASTNode*> operands;
+        if (!append_operands(value, name, operands) || operands.empty()) return false;
+        for (size_t i = 1; i < operands.size(); i++) {
+            if (mentions(operands[i], name)) return false;
+        }
+        for (ASTNode* operand : operands) {
+            compile_node(operand);
+            emit_append(name);
+        }
+        return true;
+    }
+    void emit_append(const std::string& name) {
+        int slot = resolve_local(name);
+        if (slot != -1) { emit(OpCode::OP_APPEND_LOCAL); emit_byte(slot); }
+        else {
+            emit(OpCode::OP_APPEND_GLOBAL);
+            emit_global(name);
+        }
+    }
+    OpCode get_local_op(const std::string& name) const {
+        return string_builders.count(name) ? OpCode::OP_GET_LOCAL_SEAL : OpCode::OP_GET_LOCAL;
+    }
 
     void compile_node(ASTNode* node) {
         if (!node) return;
@@ -20998,7 +26514,8 @@ private:
                     if (child->type != NodeType::IF && child->type != NodeType::WHILE &&
                         child->type != NodeType::FOR && child->type != NodeType::REPEAT &&
                         child->type != NodeType::FUNCTION && child->type != NodeType::RETURN &&
-                        child->type != NodeType::ASSIGN)
+                        child->type != NodeType::ASSIGN && child->type != NodeType::CLASS &&
+                        child->type != NodeType::TRY && child->type != NodeType::COMPOUND_ASSIGN)
                         emit(OpCode::OP_POP);
                 }
                 break;
@@ -21029,11 +26546,10 @@ private:
                 break;
             case NodeType::VARIABLE: {
                 int slot = resolve_local(node->token.lexeme);
-                if (slot != -1) { emit(OpCode::OP_GET_LOCAL); emit_byte(slot); }
+                if (slot != -1) { emit(get_local_op(node->token.lexeme)); emit_byte(slot); }
                 else { 
-                    size_t idx = chunk->add_constant(Value(node->token.lexeme));
                     emit(OpCode::OP_GET_GLOBAL);
-                    emit_short(idx);  // Use 16-bit index
+                    emit_global(node->token.lexeme);  // Dense global slot
                 }
                 break;
             }
@@ -21059,14 +26575,14 @@ private:
                     emit(OpCode::OP_POP);
                     break;
                 }
-                compile_node(node->children[1].get());  // Value
                 std::string name = node->value.empty() ? node->children[0]->token.lexeme : node->value;
+                if (compile_append(name, node->children[1].get())) break;
+                compile_node(node->children[1].get());  // Value
                 int slot = resolve_local(name);
                 if (slot != -1) { emit(OpCode::OP_SET_LOCAL); emit_byte(slot); }
                 else { 
-                    size_t idx = chunk->add_constant(Value(name));
                     emit(OpCode::OP_SET_GLOBAL);
-                    emit_short(idx);  // Use 16-bit index
+                    emit_global(name);  // Dense global slot
                 }
                 emit(OpCode::OP_POP);
                 break;
@@ -21076,11 +26592,15 @@ private:
                 // Get current value
                 std::string name = node->children[0]->token.lexeme;
                 int slot = resolve_local(name);
-                if (slot != -1) { emit(OpCode::OP_GET_LOCAL); emit_byte(slot); }
+                if (node->value == "+=" && string_builders.count(name)) {
+                    compile_node(node->children[1].get());
+                    emit_append(name);
+                    break;
+                }
+                if (slot != -1) { emit(get_local_op(name)); emit_byte(slot); }
                 else { 
-                    size_t idx = chunk->add_constant(Value(name));
                     emit(OpCode::OP_GET_GLOBAL);
-                    emit_short(idx);  // Use 16-bit index
+                    emit_global(name);  // Dense global slot
                 }
                 // Compile RHS
                 compile_node(node->children[1].get());
@@ -21093,9 +26613,8 @@ private:
                 // Store back
                 if (slot != -1) { emit(OpCode::OP_SET_LOCAL); emit_byte(slot); }
                 else { 
-                    size_t idx = chunk->add_constant(Value(name));
                     emit(OpCode::OP_SET_GLOBAL);
-                    emit_short(idx);  // Use 16-bit index
+                    emit_global(name);  // Dense global slot
                 }
                 emit(OpCode::OP_POP);
                 break;
@@ -21217,7 +26736,7 @@ private:
                 emit(OpCode::OP_NONE);
                 size_t loop_start = chunk->code.size();
                 // Track loop for break/continue
-                loops.push_back({loop_start, {}});
+                loops.push_back({loop_start, {}, true});
                 size_t exit = emit_jump(OpCode::OP_ITER_NEXT);
                 emit(OpCode::OP_SET_LOCAL);
                 emit_byte(locals.size() - 1);
@@ -21263,6 +26782,10 @@ private:
             // Break and continue for bytecode
             case NodeType::BREAK: {
                 if (loops.empty()) throw std::runtime_error("'break' outside of loop");
+                if (loops.back().for_in) {
+                    emit(OpCode::OP_ITER_POP);
+                    emit_byte(1);
+                }
                 loops.back().breaks.push_back(emit_jump(OpCode::OP_JUMP));
                 break;
             }
@@ -21309,7 +26832,12 @@ private:
             }
             case NodeType::FUNCTION: {
                 Compiler fc;
+                fc.module_scope = module_scope;
                 auto fchunk = fc.compile_function(node);
+                if (node->is_async) {
+                    fchunk->is_async = true;
+                    fchunk->jit_disabled = true;  // Frames must be able to suspend
+                }
                 Value fv(ObjectType::FUNCTION);
                 fv.data.compiled_func.chunk = fchunk;
                 fv.data.compiled_func.name = node->value;
@@ -21321,9 +26849,8 @@ private:
                     emit(OpCode::OP_SET_LOCAL);
                     emit_byte(slot);
                 } else {
-                    size_t name_idx = chunk->add_constant(Value(node->value));
                     emit(OpCode::OP_DEFINE_GLOBAL);
-                    emit_short(name_idx);  // Use 16-bit index
+                    emit_global(node->value);  // Dense global slot
                 }
                 break;
             }
@@ -21340,10 +26867,10 @@ private:
                 if (!node->children.empty() && node->children[0] && 
                     node->children[0]->type == NodeType::VARIABLE) {
                     // Has parent class - we'll resolve it at runtime
-                    size_t parent_name_idx = chunk->add_constant(Value(node->children[0]->token.lexeme));
+                    size_t parent_slot = global_slot(node->children[0]->token.lexeme);
                     start_idx = 1;
                     // Mark that this class has a parent (will be resolved in DO_CLASS_DEF)
-                    klass->parent = (ObjClass*)(uintptr_t)parent_name_idx;  // Temporary: store index
+                    klass->parent = (ObjClass*)(uintptr_t)parent_slot;  // Temporary: store slot
                 }
                 
                 // Compile methods
@@ -21356,12 +26883,17 @@ private:
                         }
                         // Compile method with special handling for 'self'
                         Compiler mc;
+                        mc.module_scope = module_scope;
                         auto mchunk = mc.compile_method(method_node);
                         
                         // Create a new Chunk that we own (copy the data)
                         Chunk* owned_chunk = new Chunk();
                         owned_chunk->code = mchunk->code;
                         owned_chunk->constants = mchunk->constants;
+                        owned_chunk->fast_constants = mchunk->fast_constants;
+                        owned_chunk->embedded_objects = mchunk->embedded_objects;
+                        owned_chunk->embedded_offsets = mchunk->embedded_offsets;
+                        owned_chunk->global_refs = mchunk->global_refs;
                         
                         // Store method in class
                         ObjFunc* mfunc = make_func(owned_chunk, method_node->value.c_str(), 
@@ -21383,22 +26915,24 @@ private:
                 
                 // Store class pointer in code as raw bytes
                 uint64_t class_ptr = val_class(klass);
+                chunk->embedded_offsets.push_back(static_cast<uint32_t>(chunk->code.size()));
                 for (int i = 0; i < 8; i++) {
                     emit_byte((class_ptr >> (i * 8)) & 0xFF);
                 }
+                chunk->embedded_objects.push_back(class_ptr);
                 
                 // Has parent? emit 1, else 0
                 emit_byte(start_idx > 0 ? 1 : 0);
                 if (start_idx > 0) {
-                    size_t parent_name_idx = (size_t)(uintptr_t)klass->parent;
-                    emit_short(parent_name_idx);
+                    size_t parent_slot = (size_t)(uintptr_t)klass->parent;
+                    chunk->global_refs.push_back(static_cast<uint32_t>(chunk->code.size()));
+                    emit_short(parent_slot);
                     klass->parent = nullptr;  // Reset, will be set at runtime
                 }
                 
                 // Define class in environment
-                size_t name_idx = chunk->add_constant(Value(node->class_name));
                 emit(OpCode::OP_DEFINE_GLOBAL);
-                emit_short(name_idx);
+                emit_global(node->class_name);
                 break;
             }
             // ============================================================================
@@ -21446,17 +26980,14 @@ private:
 
                 std::string name = node->children[0]->token.lexeme;
                 if (name == "await") {
-                    // Rewrite await(task, timeout?) => import async; async.await(task, timeout?)
-                    size_t module_idx = chunk->add_constant(Value("async"));
-                    emit(OpCode::OP_IMPORT);
-                    emit_short(module_idx);
+                    // await(target, timeout_ms?) on a coroutine or async task id
+                    size_t argc = node->children.size() - 1;
+                    if (argc < 1 || argc > 2) throw std::runtime_error("await(target, timeout_ms?) expects 1 or 2 arguments");
                     for (size_t i = 1; i < node->children.size(); i++) {
                         compile_node(node->children[i].get());
                     }
-                    size_t method_idx = chunk->add_constant(Value("await"));
-                    emit(OpCode::OP_METHOD_CALL);
-                    emit_byte(node->children.size() - 1);
-                    emit_short(method_idx);
+                    emit(OpCode::OP_AWAIT);
+                    emit_byte(argc);
                 } else
                 if (name == "say" && node->children.size() == 2) {
                     compile_node(node->children[1].get());
@@ -21735,6 +27266,22 @@ private:
                     compile_node(node->children[1].get());  // a
                     compile_node(node->children[2].get());  // bits
                     emit(OpCode::OP_SHIFT_RIGHT);
+                } else if (name == "atomic_load" && node->children.size() == 2) {
+                    compile_node(node->children[1].get());  // addr
+                    emit(OpCode::OP_ATOMIC_LOAD);
+                } else if (name == "atomic_store" && node->children.size() == 3) {
+                    compile_node(node->children[1].get());  // addr
+                    compile_node(node->children[2].get());  // value
+                    emit(OpCode::OP_ATOMIC_STORE);
+                } else if (name == "atomic_add" && node->children.size() == 3) {
+                    compile_node(node->children[1].get());  // addr
+                    compile_node(node->children[2].get());  // delta
+                    emit(OpCode::OP_ATOMIC_ADD);
+                } else if (name == "atomic_cas" && node->children.size() == 4) {
+                    compile_node(node->children[1].get());  // addr
+                    compile_node(node->children[2].get());  // expected
+                    compile_node(node->children[3].get());  // desired
+                    emit(OpCode::OP_ATOMIC_CAS);
                 // ============================================================================
                 // FUTURE-PROOF: AI/ML TENSOR PRIMITIVES
                 // ============================================================================
@@ -21765,6 +27312,35 @@ private:
                 } else if (name == "tensor_mean" && node->children.size() == 2) {
                     compile_node(node->children[1].get());  // t
                     emit(OpCode::OP_TENSOR_MEAN);
+                } else if (name == "tensor_reshape" && node->children.size() >= 3) {
+                    for (size_t i = 1; i < node->children.size(); i++)
+                        compile_node(node->children[i].get());
+                    emit(OpCode::OP_TENSOR_RESHAPE);
+                    emit_byte(node->children.size() - 1);  // argc
+                } else if (name == "tensor_transpose" && node->children.size() == 2) {
+                    compile_node(node->children[1].get());  // t
+                    emit(OpCode::OP_TENSOR_TRANSPOSE);
+                } else if (name == "tensor_from" && (node->children.size() == 2 || node->children.size() == 3)) {
+                    for (size_t i = 1; i < node->children.size(); i++)
+                        compile_node(node->children[i].get());  // data, dtype
+                    emit(OpCode::OP_TENSOR_FROM);
+                    emit_byte(node->children.size() - 1);  // argc
+                } else if (name == "tensor_list" && node->children.size() == 2) {
+                    compile_node(node->children[1].get());  // t
+                    emit(OpCode::OP_TENSOR_TOLIST);
+                } else if (name == "tensor_shape" && node->children.size() == 2) {
+                    compile_node(node->children[1].get());  // t
+                    emit(OpCode::OP_TENSOR_SHAPE);
+                } else if (name == "bytes" && node->children.size() <= 2) {
+                    for (size_t i = 1; i < node->children.size(); i++)
+                        compile_node(node->children[i].get());  // source
+                    emit(OpCode::OP_BYTES_NEW);
+                    emit_byte(node->children.size() - 1);  // argc
+                } else if (name == "bytes_slice" && (node->children.size() == 3 || node->children.size() == 4)) {
+                    for (size_t i = 1; i < node->children.size(); i++)
+                        compile_node(node->children[i].get());  // b, start, end
+                    emit(OpCode::OP_BYTES_SLICE);
+                    emit_byte(node->children.size() - 1);  // argc
                 // ============================================================================
                 // FUTURE-PROOF: SIMD/VECTORIZED OPERATIONS
                 // ============================================================================
@@ -21790,11 +27366,18 @@ private:
                 }
                 break;
             }
-            case NodeType::RETURN:
+            case NodeType::RETURN: {
                 if (!node->children.empty()) compile_node(node->children[0].get());
                 else emit(OpCode::OP_NONE);
+                size_t iterators = std::count_if(loops.begin(), loops.end(),
+                                                 [](const LoopContext& l) { return l.for_in; });
+                if (iterators > 0) {
+                    emit(OpCode::OP_ITER_POP);
+                    emit_byte((uint8_t)iterators);
+                }
                 emit(OpCode::OP_RETURN);
                 break;
+            }
             case NodeType::SAY:
                 compile_node(node->children[0].get());
                 emit(OpCode::OP_BUILTIN_SAY);
@@ -21803,6 +27386,8 @@ private:
               size_t module_name_idx = chunk->add_constant(Value(node->value));
               emit(OpCode::OP_IMPORT);
               emit_short(module_name_idx);
+              emit(OpCode::OP_SET_GLOBAL);
+              emit_global(node->value);  // Bind module name
               break;
             }
             case NodeType::INDEX:
@@ -21816,36 +27401,2191 @@ private:
 };
 
 // ============================================================================
-// High-performance bytecode VM - NaN-boxed 8-byte values, computed goto dispatch
+// BYTECODE CACHE - Compiled chunks persisted as .levyc files
 // ============================================================================
-class FastVM {
-    static constexpr size_t STACK_MAX = 262144;  // 256K slots for deep recursion
-    static constexpr size_t FRAMES_MAX = 65536;  // Allow deep recursion
-    
-    struct CallFrame {
-        Chunk* chunk;
-        uint8_t* ip;
-        uint64_t* slots;  // Direct pointer to frame's stack slots
-        const char* name;
+// Lexing, parsing and compiling dominate startup for large scripts, so the
+// compiled Chunk tree is written to ~/.levython/bytecode/<hash>.levyc (or
+// $LEVYTHON_CACHE_DIR), keyed by a hash of the source, and decoded from a
+// read-only mapping on the next run. The directory is kept under a size cap
+// by dropping the least recently used files. Global slot operands and embedded classes are stored by name
+// and rebound on load, so a cached chunk doesn't depend on the slot layout of
+// the process that wrote it.
+namespace bytecode_cache {
+static const char MAGIC[8] = {'L', 'E', 'V', 'Y', 'C', '\r', '\n', '\x1a'};
+constexpr uint32_t FORMAT_VERSION = 7;  // Bump whenever the encoding or bytecode changes
+constexpr uint32_t OPCODE_COUNT = static_cast<uint32_t>(OpCode::OP_CHANNEL_RECV) + 1;
+// Compile time of this interpreter, stored in every header, so files from
+// another build are never trusted even when FORMAT_VERSION was not bumped
+static const char BUILD_STAMP[] = __DATE__ " " __TIME__;
+static bool g_enabled = true;  // Cleared by --no-cache
+constexpr uintmax_t DEFAULT_MAX_BYTES = 64ull << 20;  // $LEVYTHON_CACHE_MAX_MB overrides
+constexpr std::time_t TOUCH_INTERVAL = 3600;  // A hit refreshes mtime at most this often
+
+enum ConstTag : uint8_t { TAG_NONE_C, TAG_BOOL_C, TAG_INT_C, TAG_FLOAT_C, TAG_STRING_C, TAG_FUNC_C };
+
+// FNV-1a over the source plus the module name it compiles as
+static uint64_t hash_source(const std::string& source, const std::string& module_name) {
+    uint64_t h = 1469598103934665603ULL;
+    auto mix = [&h](const std::string& s) {
+        for (unsigned char c : s) {
+            h ^= c;
+            h *= 1099511628211ULL;
+        }
     };
-    
-    // ========================================================================
-    // JIT OPTIMIZATION FRAMEWORK
-    // ========================================================================
-    
-    // GUARD: Runtime type/bounds check with bailout to original bytecode
-    struct Guard {
-        enum GuardType : uint8_t {
-            TYPE_INT,           // Value must be integer
-            TYPE_FLOAT,         // Value must be float/number
-            TYPE_STRING,        // Value must be string
-            TYPE_LIST,          // Value must be list
-            BOUNDS_CHECK,       // Index within bounds
-            NOT_NONE,           // Value must not be None
-            MONOMORPHIC_FUNC,   // Call site always calls same function
-            STABLE_GLOBAL,      // Global hasn't changed since specialization
-        };
-        
+    mix(source);
+    h ^= 0xFF;  // Separator: no source byte sequence can move into the name
+    h *= 1099511628211ULL;
+    mix(module_name);
+    return h;
+}
+
+class Writer {
+    std::string out;
+public:
+    void raw(const void* p, size_t n) { out.append(static_cast<const char*>(p), n); }
+    void u8(uint8_t v) { out.push_back(static_cast<char>(v)); }
+    void u32(uint32_t v) {
+        for (int i = 0; i < 4; ++i) out.push_back(static_cast<char>((v >> (i * 8)) & 0xFF));
+    }
+    void u64(uint64_t v) {
+        for (int i = 0; i < 8; ++i) out.push_back(static_cast<char>((v >> (i * 8)) & 0xFF));
+    }
+    void str(const std::string& s) {
+        u32(static_cast<uint32_t>(s.size()));
+        out.append(s);
+    }
+    void str(const ObjString* s) {
+        u32(s ? s->length : 0);
+        if (s) out.append(s->chars, s->length);
+    }
+    std::string& data() { return out; }
+};
+
+// Bounds-checked reader; a short or damaged file throws and is recompiled
+struct Reader {
+    const uint8_t* p;
+    const uint8_t* end;
+
+    void need(size_t n) const {
+        if (static_cast<size_t>(end - p) < n) throw std::runtime_error("truncated bytecode");
+    }
+    uint8_t u8() {
+        need(1);
+        return *p++;
+    }
+    uint32_t u32() {
+        need(4);
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i) v |= static_cast<uint32_t>(p[i]) << (i * 8);
+        p += 4;
+        return v;
+    }
+    uint64_t u64() {
+        need(8);
+        uint64_t v = 0;
+        for (int i = 0; i < 8; ++i) v |= static_cast<uint64_t>(p[i]) << (i * 8);
+        p += 8;
+        return v;
+    }
+    std::string str() {
+        uint32_t n = u32();
+        need(n);
+        std::string s(reinterpret_cast<const char*>(p), n);
+        p += n;
+        return s;
+    }
+};
+
+static void write_chunk(Writer& w, const Chunk& c);
+static void read_chunk(Reader& r, Chunk& c);
+
+static uint16_t slot_operand(const std::vector<uint8_t>& code, uint32_t off) {
+    return static_cast<uint16_t>(code[off] | (code[off + 1] << 8));
+}
+
+static void write_constant(Writer& w, const Value& v) {
+    switch (v.type) {
+        case ObjectType::NONE: w.u8(TAG_NONE_C); return;
+        case ObjectType::BOOLEAN: w.u8(TAG_BOOL_C); w.u8(v.data.boolean ? 1 : 0); return;
+        case ObjectType::INTEGER: w.u8(TAG_INT_C); w.u64(static_cast<uint64_t>(v.data.integer)); return;
+        case ObjectType::FLOAT: {
+            uint64_t bits;
+            std::memcpy(&bits, &v.data.floating, sizeof(bits));
+            w.u8(TAG_FLOAT_C);
+            w.u64(bits);
+            return;
+        }
+        case ObjectType::STRING: w.u8(TAG_STRING_C); w.str(v.data.string); return;
+        case ObjectType::FUNCTION:
+            if (v.data.compiled_func.chunk) {
+                w.u8(TAG_FUNC_C);
+                w.str(v.data.compiled_func.name);
+                w.u8(v.data.compiled_func.arity);
+                w.u32(static_cast<uint32_t>(v.data.function.params.size()));
+                for (const auto& param : v.data.function.params) w.str(param);
+                write_chunk(w, *v.data.compiled_func.chunk);
+                return;
+            }
+            break;
+        default: break;
+    }
+    throw std::runtime_error("constant cannot be cached");
+}
+
+static Value read_constant(Reader& r) {
+    switch (r.u8()) {
+        case TAG_NONE_C: return Value();
+        case TAG_BOOL_C: return Value(r.u8() != 0);
+        case TAG_INT_C: return Value(static_cast<long>(r.u64()));
+        case TAG_FLOAT_C: {
+            uint64_t bits = r.u64();
+            double d;
+            std::memcpy(&d, &bits, sizeof(d));
+            return Value(d);
+        }
+        case TAG_STRING_C: return Value(r.str());
+        case TAG_FUNC_C: {
+            Value fv(ObjectType::FUNCTION);
+            fv.data.compiled_func.name = r.str();
+            fv.data.compiled_func.arity = r.u8();
+            uint32_t params = r.u32();
+            for (uint32_t i = 0; i < params; ++i) fv.data.function.params.push_back(r.str());
+            auto chunk = std::make_shared<Chunk>();
+            read_chunk(r, *chunk);
+            fv.data.compiled_func.chunk = std::move(chunk);
+            return fv;
+        }
+        default: throw std::runtime_error("bad constant tag");
+    }
+}
+
+// Classes are built at compile time and referenced from OP_CLASS_DEF by
+// pointer; parents are linked at run time, so only the methods are stored
+static void write_class(Writer& w, const ObjClass* klass) {
+    w.str(klass->name);
+    w.u8(klass->is_abstract ? 1 : 0);
+    w.u8(klass->arity);
+    w.u32(static_cast<uint32_t>(klass->abstract_methods.size()));
+    for (const auto& name : klass->abstract_methods) w.str(name);
+    w.u32(static_cast<uint32_t>(klass->methods.size()));
+    for (const auto& method : klass->methods) {
+        ObjFunc* fn = as_func(method.second);
+        w.str(method.first);
+        w.str(fn->name);
+        w.u8(fn->arity);
+        write_chunk(w, *fn->chunk);
+    }
+}
+
+static ObjClass* read_class(Reader& r) {
+    std::string name = r.str();
+    ObjClass* klass = ObjClass::create(name.c_str());
+    klass->is_abstract = r.u8() != 0;
+    klass->arity = r.u8();
+    uint32_t abstract_count = r.u32();
+    for (uint32_t i = 0; i < abstract_count; ++i) klass->abstract_methods.insert(r.str());
+    uint32_t method_count = r.u32();
+    for (uint32_t i = 0; i < method_count; ++i) {
+        std::string method = r.str();
+        std::string fn_name = r.str();
+        uint8_t arity = r.u8();
+        std::unique_ptr<Chunk> chunk(new Chunk());
+        read_chunk(r, *chunk);
+        klass->methods[method] = val_func(make_func(chunk.release(), fn_name.c_str(), arity));
+    }
+    return klass;
+}
+
+static void write_chunk(Writer& w, const Chunk& c) {
+    if (c.embedded_offsets.size() != c.embedded_objects.size()) {
+        throw std::runtime_error("untracked embedded object");
+    }
+    w.u8((c.is_async ? 1 : 0) | (c.jit_disabled ? 2 : 0));
+
+    std::vector<uint8_t> code = c.code;
+    for (uint32_t off : c.embedded_offsets) std::memset(&code[off], 0, 8);  // Patched on load
+    w.u32(static_cast<uint32_t>(code.size()));
+    w.raw(code.data(), code.size());
+
+    w.u32(static_cast<uint32_t>(c.constants.size()));
+    for (const Value& v : c.constants) write_constant(w, v);
+
+    w.u32(static_cast<uint32_t>(c.global_refs.size()));
+    for (uint32_t off : c.global_refs) {
+        w.u32(off);
+        w.str(g_global_slots.name_of(slot_operand(c.code, off)));
+    }
+
+    w.u32(static_cast<uint32_t>(c.module_exports.size()));
+    for (const auto& e : c.module_exports) {
+        w.str(e.first);
+        w.str(g_global_slots.name_of(e.second));
+    }
+
+    w.u32(static_cast<uint32_t>(c.embedded_objects.size()));
+    for (size_t i = 0; i < c.embedded_objects.size(); ++i) {
+        if (!is_class(c.embedded_objects[i])) throw std::runtime_error("unsupported embedded object");
+        w.u32(c.embedded_offsets[i]);
+        write_class(w, as_class(c.embedded_objects[i]));
+    }
+}
+
+static void read_chunk(Reader& r, Chunk& c) {
+    uint8_t flags = r.u8();
+    c.is_async = (flags & 1) != 0;
+    c.jit_disabled = (flags & 2) != 0;
+
+    uint32_t code_size = r.u32();
+    r.need(code_size);
+    c.code.assign(r.p, r.p + code_size);
+    r.p += code_size;
+
+    uint32_t constant_count = r.u32();
+    for (uint32_t i = 0; i < constant_count; ++i) c.constants.push_back(read_constant(r));
+
+    uint32_t ref_count = r.u32();
+    for (uint32_t i = 0; i < ref_count; ++i) {
+        uint32_t off = r.u32();
+        std::string name = r.str();
+        if (static_cast<size_t>(off) + 2 > c.code.size()) throw std::runtime_error("bad global ref");
+        uint16_t slot = g_global_slots.resolve(name);
+        c.code[off] = slot & 0xFF;
+        c.code[off + 1] = (slot >> 8) & 0xFF;
+        c.global_refs.push_back(off);
+    }
+
+    uint32_t export_count = r.u32();
+    for (uint32_t i = 0; i < export_count; ++i) {
+        std::string name = r.str();
+        std::string slot_name = r.str();
+        c.module_exports.push_back({g_strings.intern(name), g_global_slots.resolve(slot_name)});
+    }
+
+    uint32_t object_count = r.u32();
+    for (uint32_t i = 0; i < object_count; ++i) {
+        uint32_t off = r.u32();
+        if (static_cast<size_t>(off) + 8 > c.code.size()) throw std::runtime_error("bad object ref");
+        uint64_t class_ptr = val_class(read_class(r));
+        for (int b = 0; b < 8; ++b) c.code[off + b] = (class_ptr >> (b * 8)) & 0xFF;
+        c.embedded_objects.push_back(class_ptr);
+        c.embedded_offsets.push_back(off);
+    }
+    c.materialize_constants();
+}
+
+// Header + chunk tree, or empty if the chunk holds something unstorable
+std::string serialize(const Chunk& chunk, uint64_t key) {
+    try {
+        Writer w;
+        w.raw(MAGIC, sizeof(MAGIC));
+        w.u32(FORMAT_VERSION);
+        w.u32(OPCODE_COUNT);
+        w.str(BUILD_STAMP);
+        w.u64(key);
+        write_chunk(w, chunk);
+        return std::move(w.data());
+    } catch (const std::exception&) {
+        return {};
+    }
+}
+
+bool is_bytecode(const char* data, size_t len) {
+    return len >= sizeof(MAGIC) && std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+// Chunk tree from serialize(), or nullptr if it is stale, for another key,
+// or damaged
+std::shared_ptr<Chunk> deserialize(const uint8_t* data, size_t len, uint64_t key) {
+    if (!is_bytecode(reinterpret_cast<const char*>(data), len)) return nullptr;
+    Reader r{data + sizeof(MAGIC), data + len};
+    try {
+        if (r.u32() != FORMAT_VERSION || r.u32() != OPCODE_COUNT) return nullptr;
+        if (r.str() != BUILD_STAMP || r.u64() != key) return nullptr;
+        auto chunk = std::make_shared<Chunk>();
+        read_chunk(r, *chunk);
+        if (r.p != r.end) return nullptr;
+        return chunk;
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+static fs::path cache_dir() {
+    const char* dir = std::getenv("LEVYTHON_CACHE_DIR");
+    if (dir && *dir) return fs::path(dir);
+    const char* home = std::getenv("HOME");
+    if (!home) home = std::getenv("USERPROFILE");
+    if (!home) return {};
+    return fs::path(home) / ".levython" / "bytecode";
+}
+
+static std::shared_ptr<Chunk> load_file(const fs::path& path, uint64_t key) {
+    int fd = open(path.string().c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return nullptr;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* mapped = platform_mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) return nullptr;
+    auto chunk = deserialize(static_cast<const uint8_t*>(mapped), size, key);
+    platform_munmap(mapped, size);
+    // mtime doubles as the last-use time that prune() evicts by
+    if (chunk && std::time(nullptr) - st.st_mtime > TOUCH_INTERVAL) {
+        std::error_code ec;
+        fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    }
+    return chunk;
+}
+
+static uintmax_t max_cache_bytes() {
+    const char* mb = std::getenv("LEVYTHON_CACHE_MAX_MB");
+    if (mb && *mb) {
+        char* end = nullptr;
+        unsigned long long v = std::strtoull(mb, &end, 10);
+        if (end && *end == '\0') return static_cast<uintmax_t>(v) << 20;
+    }
+    return DEFAULT_MAX_BYTES;
+}
+
+// Deletes the least recently used .levyc files until the directory is back
+// to three quarters of the cap, so a full cache isn't rescanned on every
+// store. `keep`, the file just written, is never evicted. Temporaries a
+// crashed run left behind go too.
+static void prune(const fs::path& dir, const fs::path& keep) {
+    struct Entry {
+        fs::file_time_type used;
+        uintmax_t size;
+        fs::path path;
+    };
+    std::vector<Entry> entries;
+    uintmax_t total = 0;
+    auto stale_tmp = fs::file_time_type::clock::now() - std::chrono::seconds(TOUCH_INTERVAL);
+    std::error_code ec;
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        std::error_code entry_ec;
+        if (!it->is_regular_file(entry_ec)) continue;
+        const fs::path& p = it->path();
+        fs::file_time_type used = it->last_write_time(entry_ec);
+        if (entry_ec) continue;
+        if (p.extension() == ".levyc" && p != keep) {
+            uintmax_t size = it->file_size(entry_ec);
+            if (entry_ec) continue;
+            entries.push_back({used, size, p});
+            total += size;
+        } else if (p.filename().string().find(".levyc.tmp") != std::string::npos && used < stale_tmp) {
+            fs::remove(p, entry_ec);
+        }
+    }
+    uintmax_t cap = max_cache_bytes();
+    if (total <= cap) return;
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.used < b.used; });
+    uintmax_t target = cap / 4 * 3;
+    for (const Entry& e : entries) {
+        if (total <= target) break;
+        std::error_code rm_ec;
+        if (fs::remove(e.path, rm_ec)) total -= e.size;
+    }
+}
+
+// Best effort: write to a temporary name and rename, so a concurrent run
+// never maps a half-written file
+static void store_file(const fs::path& path, const std::string& bytes) {
+    if (bytes.empty()) return;
+    std::error_code ec;
+    fs::create_directories(path.parent_path(), ec);
+    fs::path tmp = path;
+    tmp += ".tmp" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) return;
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (!out.good()) {
+            out.close();
+            fs::remove(tmp, ec);
+            return;
+        }
+    }
+    fs::rename(tmp, path, ec);
+    if (ec) {
+        fs::remove(tmp, ec);
+        return;
+    }
+    prune(path.parent_path(), path);
+}
+
+static std::shared_ptr<Chunk> compile_uncached(const std::string& source, const std::string& module_name,
+                                               bool* clean) {
+    Lexer lexer(source);
+    auto tokens = lexer.tokenize();
+    Parser parser(tokens);
+    auto ast = parser.parse();
+    *clean = !parser.had_errors();
+    Compiler compiler;
+    return module_name.empty() ? compiler.compile(ast.get()) : compiler.compile_module(ast.get(), module_name);
+}
+
+// Front end for a script (empty module_name) or a local module: the cached
+// chunk when one matches the source, otherwise a fresh compile that refreshes
+// the cache. Sources with syntax errors are never cached, so the errors are
+// reported on every run.
+std::shared_ptr<Chunk> compile(const std::string& source, const std::string& module_name = "") {
+    uint64_t key = hash_source(source, module_name);
+    fs::path path;
+    if (g_enabled) {
+        fs::path dir = cache_dir();
+        if (!dir.empty()) {
+            char name[24];
+            std::snprintf(name, sizeof(name), "%016llx.levyc", static_cast<unsigned long long>(key));
+            path = dir / name;
+            if (auto chunk = load_file(path, key)) return chunk;
+        }
+    }
+    bool clean = false;
+    auto chunk = compile_uncached(source, module_name, &clean);
+    if (!path.empty() && clean) store_file(path, serialize(*chunk, key));
+    return chunk;
+}
+
+// Bytecode image for `levython build`; empty if the script can't be stored
+std::string compile_image(const std::string& source) {
+    bool clean = false;
+    auto chunk = compile_uncached(source, "", &clean);
+    if (!clean) return {};
+    return serialize(*chunk, 0);
+}
+
+std::shared_ptr<Chunk> load_image(const std::string& image) {
+    return deserialize(reinterpret_cast<const uint8_t*>(image.data()), image.size(), 0);
+}
+} // namespace bytecode_cache
+
+// ============================================================================
+// BUILTIN MODULE REGISTRY
+// ============================================================================
+// Name -> binding tables for the builtin modules. FastVM turns each entry into
+// an ObjNative stored in the module map, so a module call is a single hashed
+// lookup on the interned method name instead of a chain of string compares.
+namespace module_registry {
+struct Entry { const char* name; LegacyNativeFn fn; };
+
+const Entry http_builtins[] = {
+    {"get", http_bindings::builtin_http_get},
+    {"post", http_bindings::builtin_http_post},
+    {"put", http_bindings::builtin_http_put},
+    {"patch", http_bindings::builtin_http_patch},
+    {"delete", http_bindings::builtin_http_delete},
+    {"head", http_bindings::builtin_http_head},
+    {"request", http_bindings::builtin_http_request},
+    {"set_timeout", http_bindings::builtin_http_set_timeout},
+    {"set_verify_ssl", http_bindings::builtin_http_set_verify_ssl},
+    {"set_pool", http_bindings::builtin_http_set_pool},
+    {"pool_stats", http_bindings::builtin_http_pool_stats},
+    {"close_idle", http_bindings::builtin_http_close_idle},
+    {"stream", http_bindings::builtin_http_stream},
+    {"read_chunk", http_bindings::builtin_http_read_chunk},
+    {"close_stream", http_bindings::builtin_http_close_stream},
+    {"download", http_bindings::builtin_http_download},
+    {"request_many", http_bindings::builtin_http_request_many},
+};
+
+const Entry os_builtins[] = {
+    {"name", os_bindings::builtin_os_name},
+    {"sep", os_bindings::builtin_os_sep},
+    {"cwd", os_bindings::builtin_os_cwd},
+    {"chdir", os_bindings::builtin_os_chdir},
+    {"listdir", os_bindings::builtin_os_listdir},
+    {"exists", os_bindings::builtin_os_exists},
+    {"is_file", os_bindings::builtin_os_is_file},
+    {"is_dir", os_bindings::builtin_os_is_dir},
+    {"mkdir", os_bindings::builtin_os_mkdir},
+    {"remove", os_bindings::builtin_os_remove},
+    {"rmdir", os_bindings::builtin_os_rmdir},
+    {"rename", os_bindings::builtin_os_rename},
+    {"abspath", os_bindings::builtin_os_abspath},
+    {"getenv", os_bindings::builtin_os_getenv},
+    {"setenv", os_bindings::builtin_os_setenv},
+    {"unsetenv", os_bindings::builtin_os_unsetenv},
+    {"shutdown", os_bindings::builtin_os_shutdown},
+    {"restart", os_bindings::builtin_os_restart},
+    {"logout", os_bindings::builtin_os_logout},
+    {"lock", os_bindings::builtin_os_lock},
+    {"sleep", os_bindings::builtin_os_sleep},
+    {"hibernate", os_bindings::builtin_os_hibernate},
+    {"hostname", os_bindings::builtin_os_hostname},
+    {"set_hostname", os_bindings::builtin_os_set_hostname},
+    {"uptime", os_bindings::builtin_os_uptime},
+    {"cpu_count", os_bindings::builtin_os_cpu_count},
+    {"mem_total", os_bindings::builtin_os_mem_total},
+    {"mem_free", os_bindings::builtin_os_mem_free},
+    {"platform", os_bindings::builtin_os_platform},
+    {"chmod", os_bindings::builtin_os_chmod},
+    {"chown", os_bindings::builtin_os_chown},
+    {"stat", os_bindings::builtin_os_stat},
+    {"realpath", os_bindings::builtin_os_realpath},
+    {"symlink", os_bindings::builtin_os_symlink},
+    {"readlink", os_bindings::builtin_os_readlink},
+    {"copy", os_bindings::builtin_os_copy},
+    {"move", os_bindings::builtin_os_move},
+    {"getpid", os_bindings::builtin_os_getpid},
+    {"exec", os_bindings::builtin_os_exec},
+    {"spawn", os_bindings::builtin_os_spawn},
+    {"kill", os_bindings::builtin_os_kill},
+    {"user", os_bindings::builtin_os_user},
+    {"uid", os_bindings::builtin_os_uid},
+    {"gid", os_bindings::builtin_os_gid},
+    {"is_admin", os_bindings::builtin_os_is_admin},
+    {"elevate", os_bindings::builtin_os_elevate},
+    {"sleep_ms", os_bindings::builtin_os_sleep_ms},
+    {"env", os_bindings::builtin_os_env},
+    {"path_sep", os_bindings::builtin_os_path_sep},
+    {"expanduser", os_bindings::builtin_os_expanduser},
+    {"expandvars", os_bindings::builtin_os_expandvars},
+    {"path_expand", os_bindings::builtin_os_path_expand},
+    {"homedir", os_bindings::builtin_os_homedir},
+    {"username", os_bindings::builtin_os_username},
+    {"groups", os_bindings::builtin_os_groups},
+    {"ppid", os_bindings::builtin_os_ppid},
+    {"argv", os_bindings::builtin_os_argv},
+    {"exit", os_bindings::builtin_os_exit},
+    {"which", os_bindings::builtin_os_which},
+    {"tempdir", os_bindings::builtin_os_tempdir},
+    {"getenvs", os_bindings::builtin_os_getenvs},
+    {"env_list", os_bindings::builtin_os_env_list},
+    {"access", os_bindings::builtin_os_access},
+    {"umask", os_bindings::builtin_os_umask},
+    {"env_update", os_bindings::builtin_os_env_update},
+    {"getenv_int", os_bindings::builtin_os_getenv_int},
+    {"getenv_float", os_bindings::builtin_os_getenv_float},
+    {"getenv_bool", os_bindings::builtin_os_getenv_bool},
+    {"env_snapshot", os_bindings::builtin_os_env_snapshot},
+    {"env_diff", os_bindings::builtin_os_env_diff},
+    {"walk", os_bindings::builtin_os_walk},
+    {"glob", os_bindings::builtin_os_glob},
+    {"disk_usage", os_bindings::builtin_os_disk_usage},
+    {"statvfs", os_bindings::builtin_os_statvfs},
+    {"touch", os_bindings::builtin_os_touch},
+    {"rmdir_rf", os_bindings::builtin_os_rmdir_rf},
+    {"mkdir_p", os_bindings::builtin_os_mkdir_p},
+    {"ps", os_bindings::builtin_os_ps},
+    {"run", os_bindings::builtin_os_run},
+    {"waitpid", os_bindings::builtin_os_waitpid},
+    {"kill_tree", os_bindings::builtin_os_kill_tree},
+    {"run_capture", os_bindings::builtin_os_run_capture},
+    {"popen", os_bindings::builtin_os_popen},
+    {"spawn_io", os_bindings::builtin_os_spawn_io},
+    {"scandir", os_bindings::builtin_os_scandir},
+    {"link", os_bindings::builtin_os_link},
+    {"renameat", os_bindings::builtin_os_renameat},
+    {"lstat", os_bindings::builtin_os_lstat},
+    {"fstat", os_bindings::builtin_os_fstat},
+    {"open", os_bindings::builtin_os_open},
+    {"read", os_bindings::builtin_os_read},
+    {"write", os_bindings::builtin_os_write},
+    {"fsync", os_bindings::builtin_os_fsync},
+    {"close", os_bindings::builtin_os_close},
+    {"fdopen", os_bindings::builtin_os_fdopen},
+    {"chdir_push", os_bindings::builtin_os_chdir_push},
+    {"chdir_pop", os_bindings::builtin_os_chdir_pop},
+    {"signal", os_bindings::builtin_os_signal},
+    {"alarm", os_bindings::builtin_os_alarm},
+    {"pause", os_bindings::builtin_os_pause},
+    {"killpg", os_bindings::builtin_os_killpg},
+    {"setuid", os_bindings::builtin_os_setuid},
+    {"setgid", os_bindings::builtin_os_setgid},
+    {"getpgid", os_bindings::builtin_os_getpgid},
+    {"setpgid", os_bindings::builtin_os_setpgid},
+    {"setsid", os_bindings::builtin_os_setsid},
+    {"nice", os_bindings::builtin_os_nice},
+    {"getpriority", os_bindings::builtin_os_getpriority},
+    {"setpriority", os_bindings::builtin_os_setpriority},
+    {"uid_name", os_bindings::builtin_os_uid_name},
+    {"gid_name", os_bindings::builtin_os_gid_name},
+    {"getpwnam", os_bindings::builtin_os_getpwnam},
+    {"getgrnam", os_bindings::builtin_os_getgrnam},
+    {"getlogin", os_bindings::builtin_os_getlogin},
+    {"getgroups", os_bindings::builtin_os_getgroups},
+    {"chflags", os_bindings::builtin_os_chflags},
+    {"loadavg", os_bindings::builtin_os_loadavg},
+    {"cpu_info", os_bindings::builtin_os_cpu_info},
+    {"os_release", os_bindings::builtin_os_os_release},
+    {"boot_time", os_bindings::builtin_os_boot_time},
+    {"locale", os_bindings::builtin_os_locale},
+    {"timezone", os_bindings::builtin_os_timezone},
+    {"mounts", os_bindings::builtin_os_mounts},
+    {"service_control", os_bindings::builtin_os_service_control},
+    {"service_query", os_bindings::builtin_os_service_query},
+    {"battery_info", os_bindings::builtin_os_battery_info},
+    {"cgroups", os_bindings::builtin_os_cgroups},
+    {"namespaces", os_bindings::builtin_os_namespaces},
+    {"readlink_info", os_bindings::builtin_os_readlink_info},
+    {"realpath_ex", os_bindings::builtin_os_realpath_ex},
+#ifndef LEVYTHON_NO_HOOKS
+    {"hook_register", os_bindings::builtin_os_hooks_register},
+    {"hook_unregister", os_bindings::builtin_os_hooks_unregister},
+    {"hook_list", os_bindings::builtin_os_hooks_list},
+    {"hook_enable", os_bindings::builtin_os_hooks_enable},
+    {"hook_disable", os_bindings::builtin_os_hooks_disable},
+    {"hook_set_callback", os_bindings::builtin_os_hooks_set_callback},
+    {"hook_process_create", os_bindings::builtin_os_hooks_hook_process_create},
+    {"hook_process_exit", os_bindings::builtin_os_hooks_hook_process_exit},
+    {"hook_file_access", os_bindings::builtin_os_hooks_hook_file_access},
+    {"hook_network_connect", os_bindings::builtin_os_hooks_hook_network_connect},
+    {"hook_keyboard", os_bindings::builtin_os_hooks_hook_keyboard},
+    {"hook_mouse", os_bindings::builtin_os_hooks_hook_mouse},
+    {"hook_syscall", os_bindings::builtin_os_hooks_hook_syscall},
+    {"hook_inject_dll", os_bindings::builtin_os_hooks_inject_library},
+    {"hook_memory_access", os_bindings::builtin_os_hooks_hook_memory_access},
+#endif
+    {"inputcontrol_keyboard_capture", os_bindings::builtin_os_inputcontrol_capture_keyboard},
+    {"inputcontrol_keyboard_release", os_bindings::builtin_os_inputcontrol_release_keyboard},
+    {"inputcontrol_keyboard_send", os_bindings::builtin_os_inputcontrol_keyboard_send},
+    {"inputcontrol_keyboard_send_text", os_bindings::builtin_os_inputcontrol_type_text_raw},
+    {"inputcontrol_keyboard_block", os_bindings::builtin_os_inputcontrol_block_key},
+    {"inputcontrol_keyboard_unblock", os_bindings::builtin_os_inputcontrol_unblock_key},
+    {"inputcontrol_keyboard_remap", os_bindings::builtin_os_inputcontrol_remap_key},
+    {"inputcontrol_keyboard_get_state", os_bindings::builtin_os_inputcontrol_get_keyboard_state},
+    {"inputcontrol_mouse_capture", os_bindings::builtin_os_inputcontrol_capture_mouse},
+    {"inputcontrol_mouse_release", os_bindings::builtin_os_inputcontrol_release_mouse},
+    {"inputcontrol_mouse_move", os_bindings::builtin_os_inputcontrol_move_mouse},
+    {"inputcontrol_mouse_click", os_bindings::builtin_os_inputcontrol_mouse_click},
+    {"inputcontrol_mouse_scroll", os_bindings::builtin_os_inputcontrol_scroll_mouse},
+    {"inputcontrol_mouse_block", os_bindings::builtin_os_inputcontrol_block_mouse_button},
+    {"inputcontrol_mouse_unblock", os_bindings::builtin_os_inputcontrol_unblock_mouse_button},
+    {"inputcontrol_get_mouse_pos", os_bindings::builtin_os_inputcontrol_get_mouse_position},
+    {"inputcontrol_set_mouse_pos", os_bindings::builtin_os_inputcontrol_set_mouse_position},
+    {"inputcontrol_touch_capture", os_bindings::builtin_os_inputcontrol_capture_touch},
+    {"inputcontrol_touch_release", os_bindings::builtin_os_inputcontrol_release_touch},
+    {"inputcontrol_touch_send", os_bindings::builtin_os_inputcontrol_send_touch_event},
+    {"inputcontrol_clear_buffer", os_bindings::builtin_os_inputcontrol_clear_input_buffer},
+    {"inputcontrol_is_capturing", os_bindings::builtin_os_inputcontrol_is_capturing},
+};
+
+const Entry fs_builtins[] = {
+    {"exists", fs_bindings::builtin_fs_exists},
+    {"is_file", fs_bindings::builtin_fs_is_file},
+    {"is_dir", fs_bindings::builtin_fs_is_dir},
+    {"mkdir", fs_bindings::builtin_fs_mkdir},
+    {"remove", fs_bindings::builtin_fs_remove},
+    {"rmdir", fs_bindings::builtin_fs_rmdir},
+    {"listdir", fs_bindings::builtin_fs_listdir},
+    {"read_text", fs_bindings::builtin_fs_read_text},
+    {"write_text", fs_bindings::builtin_fs_write_text},
+    {"append_text", fs_bindings::builtin_fs_append_text},
+    {"copy", fs_bindings::builtin_fs_copy},
+    {"move", fs_bindings::builtin_fs_move},
+    {"abspath", fs_bindings::builtin_fs_abspath},
+};
+
+const Entry path_builtins[] = {
+    {"join", path_bindings::builtin_path_join},
+    {"basename", path_bindings::builtin_path_basename},
+    {"dirname", path_bindings::builtin_path_dirname},
+    {"ext", path_bindings::builtin_path_ext},
+    {"stem", path_bindings::builtin_path_stem},
+    {"norm", path_bindings::builtin_path_norm},
+    {"abspath", path_bindings::builtin_path_abspath},
+    {"exists", path_bindings::builtin_path_exists},
+    {"is_file", path_bindings::builtin_path_is_file},
+    {"is_dir", path_bindings::builtin_path_is_dir},
+    {"read_text", path_bindings::builtin_path_read_text},
+    {"write_text", path_bindings::builtin_path_write_text},
+    {"listdir", path_bindings::builtin_path_listdir},
+    {"mkdir", path_bindings::builtin_path_mkdir},
+    {"remove", path_bindings::builtin_path_remove},
+    {"rmdir", path_bindings::builtin_path_rmdir},
+};
+
+const Entry process_builtins[] = {
+    {"getpid", process_bindings::builtin_process_getpid},
+    {"run", process_bindings::builtin_process_run},
+    {"cwd", process_bindings::builtin_process_cwd},
+    {"chdir", process_bindings::builtin_process_chdir},
+    {"getenv", process_bindings::builtin_process_getenv},
+    {"setenv", process_bindings::builtin_process_setenv},
+    {"unsetenv", process_bindings::builtin_process_unsetenv},
+};
+
+const Entry json_builtins[] = {
+    {"parse", json_bindings::builtin_json_parse},
+    {"stringify", json_bindings::builtin_json_stringify},
+};
+
+const Entry url_builtins[] = {
+    {"parse", url_bindings::builtin_url_parse},
+    {"encode", url_bindings::builtin_url_encode},
+    {"decode", url_bindings::builtin_url_decode},
+};
+
+const Entry net_builtins[] = {
+    {"tcp_connect", net_bindings::builtin_net_tcp_connect},
+    {"tcp_listen", net_bindings::builtin_net_tcp_listen},
+    {"tcp_accept", net_bindings::builtin_net_tcp_accept},
+    {"tcp_try_accept", net_bindings::builtin_net_tcp_try_accept},
+    {"set_nonblocking", net_bindings::builtin_net_set_nonblocking},
+    {"tcp_send", net_bindings::builtin_net_tcp_send},
+    {"tcp_try_send", net_bindings::builtin_net_tcp_try_send},
+    {"tcp_recv", net_bindings::builtin_net_tcp_recv},
+    {"tcp_try_recv", net_bindings::builtin_net_tcp_try_recv},
+    {"tcp_close", net_bindings::builtin_net_tcp_close},
+    {"udp_bind", net_bindings::builtin_net_udp_bind},
+    {"udp_sendto", net_bindings::builtin_net_udp_sendto},
+    {"udp_recvfrom", net_bindings::builtin_net_udp_recvfrom},
+    {"udp_close", net_bindings::builtin_net_udp_close},
+    {"dns_lookup", net_bindings::builtin_net_dns_lookup},
+};
+
+const Entry thread_builtins[] = {
+    {"spawn", thread_bindings::builtin_thread_spawn},
+    {"join", thread_bindings::builtin_thread_join},
+    {"is_done", thread_bindings::builtin_thread_is_done},
+    {"sleep", thread_bindings::builtin_thread_sleep},
+};
+
+const Entry channel_builtins[] = {
+    {"create", channel_bindings::builtin_channel_create},
+    {"send", channel_bindings::builtin_channel_send},
+    {"send_many", channel_bindings::builtin_channel_send_many},
+    {"recv", channel_bindings::builtin_channel_recv},
+    {"recv_many", channel_bindings::builtin_channel_recv_many},
+    {"try_recv", channel_bindings::builtin_channel_try_recv},
+    {"close", channel_bindings::builtin_channel_close},
+};
+
+const Entry async_builtins[] = {
+    {"spawn", async_bindings::builtin_async_spawn},
+    {"sleep", async_bindings::builtin_async_sleep},
+    {"tcp_recv", async_bindings::builtin_async_tcp_recv},
+    {"tcp_send", async_bindings::builtin_async_tcp_send},
+    {"http", async_bindings::builtin_async_http},
+    {"tick", async_bindings::builtin_async_tick},
+    {"done", async_bindings::builtin_async_done},
+    {"status", async_bindings::builtin_async_status},
+    {"result", async_bindings::builtin_async_result},
+    {"cancel", async_bindings::builtin_async_cancel},
+    {"pending", async_bindings::builtin_async_pending},
+    {"await", async_bindings::builtin_async_await},
+};
+
+const Entry crypto_builtins[] = {
+    {"sha256", crypto_bindings::builtin_crypto_sha256},
+    {"sha512", crypto_bindings::builtin_crypto_sha512},
+    {"hmac_sha256", crypto_bindings::builtin_crypto_hmac_sha256},
+    {"random_bytes", crypto_bindings::builtin_crypto_random_bytes},
+    {"hex_encode", crypto_bindings::builtin_crypto_hex_encode},
+    {"hex_decode", crypto_bindings::builtin_crypto_hex_decode},
+    {"base64_encode", crypto_bindings::builtin_crypto_base64_encode},
+    {"base64_decode", crypto_bindings::builtin_crypto_base64_decode},
+};
+
+const Entry time_builtins[] = {
+    {"now_utc", time_bindings::builtin_time_now_utc},
+    {"now_local", time_bindings::builtin_time_now_local},
+    {"format", time_bindings::builtin_time_format},
+    {"parse", time_bindings::builtin_time_parse},
+    {"sleep_ms", time_bindings::builtin_time_sleep_ms},
+    {"epoch_ms", time_bindings::builtin_time_epoch_ms},
+};
+
+const Entry log_builtins[] = {
+    {"set_level", log_bindings::builtin_log_set_level},
+    {"set_output", log_bindings::builtin_log_set_output},
+    {"set_json", log_bindings::builtin_log_set_json},
+    {"log", log_bindings::builtin_log_log},
+    {"debug", log_bindings::builtin_log_debug},
+    {"info", log_bindings::builtin_log_info},
+    {"warn", log_bindings::builtin_log_warn},
+    {"error", log_bindings::builtin_log_error},
+    {"flush", log_bindings::builtin_log_flush},
+    {"set_async", log_bindings::builtin_log_set_async},
+    {"set_sample", log_bindings::builtin_log_set_sample},
+    {"stats", log_bindings::builtin_log_stats},
+};
+
+const Entry config_builtins[] = {
+    {"load_env", config_bindings::builtin_config_load_env},
+    {"get", config_bindings::builtin_config_get},
+    {"set", config_bindings::builtin_config_set},
+    {"get_int", config_bindings::builtin_config_get_int},
+    {"get_float", config_bindings::builtin_config_get_float},
+    {"get_bool", config_bindings::builtin_config_get_bool},
+    {"has", config_bindings::builtin_config_has},
+};
+
+const Entry input_builtins[] = {
+    {"enable_raw", input_bindings::builtin_input_enable_raw},
+    {"disable_raw", input_bindings::builtin_input_disable_raw},
+    {"key_available", input_bindings::builtin_input_key_available},
+    {"poll", input_bindings::builtin_input_poll},
+    {"read_key", input_bindings::builtin_input_read_key},
+    {"ord", input_bindings::builtin_input_ord},
+    {"chr", input_bindings::builtin_input_chr},
+};
+
+#ifndef LEVYTHON_NO_HOOKS
+// OS.Hooks submodule
+const Entry os_hooks_builtins[] = {
+    {"register", os_bindings::builtin_os_hooks_register},
+    {"unregister", os_bindings::builtin_os_hooks_unregister},
+    {"list", os_bindings::builtin_os_hooks_list},
+    {"enable", os_bindings::builtin_os_hooks_enable},
+    {"disable", os_bindings::builtin_os_hooks_disable},
+    {"set_callback", os_bindings::builtin_os_hooks_set_callback},
+    {"hook_process_create", os_bindings::builtin_os_hooks_hook_process_create},
+    {"hook_process_exit", os_bindings::builtin_os_hooks_hook_process_exit},
+    {"hook_file_access", os_bindings::builtin_os_hooks_hook_file_access},
+    {"hook_network_connect", os_bindings::builtin_os_hooks_hook_network_connect},
+    {"hook_keyboard", os_bindings::builtin_os_hooks_hook_keyboard},
+    {"hook_mouse", os_bindings::builtin_os_hooks_hook_mouse},
+    {"hook_syscall", os_bindings::builtin_os_hooks_hook_syscall},
+    {"inject_library", os_bindings::builtin_os_hooks_inject_library},
+    {"hook_memory_access", os_bindings::builtin_os_hooks_hook_memory_access},
+};
+#endif
+
+// OS.InputControl submodule
+const Entry os_inputcontrol_builtins[] = {
+    {"capture_keyboard", os_bindings::builtin_os_inputcontrol_capture_keyboard},
+    {"release_keyboard", os_bindings::builtin_os_inputcontrol_release_keyboard},
+    {"press_key", os_bindings::builtin_os_inputcontrol_press_key},
+    {"release_key", os_bindings::builtin_os_inputcontrol_release_key},
+    {"tap_key", os_bindings::builtin_os_inputcontrol_tap_key},
+    {"type_text", os_bindings::builtin_os_inputcontrol_type_text},
+    {"type_text_raw", os_bindings::builtin_os_inputcontrol_type_text_raw},
+    {"block_key", os_bindings::builtin_os_inputcontrol_block_key},
+    {"unblock_key", os_bindings::builtin_os_inputcontrol_unblock_key},
+    {"remap_key", os_bindings::builtin_os_inputcontrol_remap_key},
+    {"get_keyboard_state", os_bindings::builtin_os_inputcontrol_get_keyboard_state},
+    {"capture_mouse", os_bindings::builtin_os_inputcontrol_capture_mouse},
+    {"release_mouse", os_bindings::builtin_os_inputcontrol_release_mouse},
+    {"move_mouse", os_bindings::builtin_os_inputcontrol_move_mouse},
+    {"press_mouse_button", os_bindings::builtin_os_inputcontrol_press_mouse_button},
+    {"release_mouse_button", os_bindings::builtin_os_inputcontrol_release_mouse_button},
+    {"click_mouse_button", os_bindings::builtin_os_inputcontrol_click_mouse_button},
+    {"scroll_mouse", os_bindings::builtin_os_inputcontrol_scroll_mouse},
+    {"block_mouse_button", os_bindings::builtin_os_inputcontrol_block_mouse_button},
+    {"unblock_mouse_button", os_bindings::builtin_os_inputcontrol_unblock_mouse_button},
+    {"get_mouse_position", os_bindings::builtin_os_inputcontrol_get_mouse_position},
+    {"set_mouse_position", os_bindings::builtin_os_inputcontrol_set_mouse_position},
+    {"capture_touch", os_bindings::builtin_os_inputcontrol_capture_touch},
+    {"release_touch", os_bindings::builtin_os_inputcontrol_release_touch},
+    {"send_touch_event", os_bindings::builtin_os_inputcontrol_send_touch_event},
+    {"clear_input_buffer", os_bindings::builtin_os_inputcontrol_clear_input_buffer},
+    {"is_capturing", os_bindings::builtin_os_inputcontrol_is_capturing},
+};
+
+// OS.Processes submodule
+const Entry os_processes_builtins[] = {
+    {"list", os_bindings::builtin_os_processes_list},
+    {"get_info", os_bindings::builtin_os_processes_get_info},
+    {"create", os_bindings::builtin_os_processes_create},
+    {"terminate", os_bindings::builtin_os_processes_terminate},
+    {"wait", os_bindings::builtin_os_processes_wait},
+    {"read_memory", os_bindings::builtin_os_processes_read_memory},
+    {"write_memory", os_bindings::builtin_os_processes_write_memory},
+    {"inject_library", os_bindings::builtin_os_processes_inject_library},
+    {"list_threads", os_bindings::builtin_os_processes_list_threads},
+    {"suspend", os_bindings::builtin_os_processes_suspend},
+    {"resume", os_bindings::builtin_os_processes_resume},
+    {"get_priority", os_bindings::builtin_os_processes_get_priority},
+    {"set_priority", os_bindings::builtin_os_processes_set_priority},
+};
+
+#ifndef LEVYTHON_NO_DISPLAY
+// OS.Display submodule
+const Entry os_display_builtins[] = {
+    {"list", os_bindings::builtin_os_display_list},
+    {"get_primary", os_bindings::builtin_os_display_get_primary},
+    {"capture_screen", os_bindings::builtin_os_display_capture_screen},
+    {"capture_region", os_bindings::builtin_os_display_capture_region},
+    {"capture_window", os_bindings::builtin_os_display_capture_window},
+    {"get_pixel", os_bindings::builtin_os_display_get_pixel},
+    {"create_overlay", os_bindings::builtin_os_display_create_overlay},
+    {"destroy_overlay", os_bindings::builtin_os_display_destroy_overlay},
+    {"draw_pixel", os_bindings::builtin_os_display_draw_pixel},
+    {"draw_line", os_bindings::builtin_os_display_draw_line},
+    {"draw_rectangle", os_bindings::builtin_os_display_draw_rectangle},
+    {"draw_circle", os_bindings::builtin_os_display_draw_circle},
+    {"draw_text", os_bindings::builtin_os_display_draw_text},
+    {"update", os_bindings::builtin_os_display_update},
+    {"set_mode", os_bindings::builtin_os_display_set_mode},
+    {"get_modes", os_bindings::builtin_os_display_get_modes},
+    {"get_buffer", os_bindings::builtin_os_display_get_buffer},
+    {"write_buffer", os_bindings::builtin_os_display_write_buffer},
+    {"show_cursor", os_bindings::builtin_os_display_show_cursor},
+    {"hide_cursor", os_bindings::builtin_os_display_hide_cursor},
+};
+#endif
+
+#ifndef LEVYTHON_NO_AUDIO
+// OS.Audio submodule
+const Entry os_audio_builtins[] = {
+    {"list_devices", os_bindings::builtin_os_audio_list_devices},
+    {"get_default_device", os_bindings::builtin_os_audio_get_default_device},
+    {"set_default_device", os_bindings::builtin_os_audio_set_default_device},
+    {"get_device_info", os_bindings::builtin_os_audio_get_device_info},
+    {"get_volume", os_bindings::builtin_os_audio_get_volume},
+    {"set_volume", os_bindings::builtin_os_audio_set_volume},
+    {"is_muted", os_bindings::builtin_os_audio_is_muted},
+    {"set_mute", os_bindings::builtin_os_audio_set_mute},
+    {"play_sound", os_bindings::builtin_os_audio_play_sound},
+    {"play_tone", os_bindings::builtin_os_audio_play_tone},
+    {"stop", os_bindings::builtin_os_audio_stop},
+    {"create_stream", os_bindings::builtin_os_audio_create_stream},
+    {"write_stream", os_bindings::builtin_os_audio_write_stream},
+    {"close_stream", os_bindings::builtin_os_audio_close_stream},
+    {"get_sample_rate", os_bindings::builtin_os_audio_get_sample_rate},
+    {"set_sample_rate", os_bindings::builtin_os_audio_set_sample_rate},
+    {"record", os_bindings::builtin_os_audio_record},
+    {"stop_recording", os_bindings::builtin_os_audio_stop_recording},
+    {"mix_streams", os_bindings::builtin_os_audio_mix_streams},
+    {"apply_effect", os_bindings::builtin_os_audio_apply_effect},
+};
+#endif
+
+// OS.Privileges submodule
+const Entry os_privileges_builtins[] = {
+    {"is_elevated", os_bindings::builtin_os_privileges_is_elevated},
+    {"is_admin", os_bindings::builtin_os_privileges_is_admin},
+    {"is_root", os_bindings::builtin_os_privileges_is_root},
+    {"get_level", os_bindings::builtin_os_privileges_get_level},
+    {"can_elevate", os_bindings::builtin_os_privileges_can_elevate},
+    {"request_elevation", os_bindings::builtin_os_privileges_request_elevation},
+    {"elevate_and_restart", os_bindings::builtin_os_privileges_elevate_and_restart},
+    {"get_user_info", os_bindings::builtin_os_privileges_get_user_info},
+    {"impersonate_user", os_bindings::builtin_os_privileges_impersonate_user},
+    {"check", os_bindings::builtin_os_privileges_check},
+    {"enable", os_bindings::builtin_os_privileges_enable},
+    {"drop", os_bindings::builtin_os_privileges_drop},
+    {"run_as_admin", os_bindings::builtin_os_privileges_run_as_admin},
+    {"get_token_info", os_bindings::builtin_os_privileges_get_token_info},
+};
+
+// OS.Events submodule
+const Entry os_events_builtins[] = {
+    {"watch_file", os_bindings::builtin_os_events_watch_file},
+    {"watch_network", os_bindings::builtin_os_events_watch_network},
+    {"watch_power", os_bindings::builtin_os_events_watch_power},
+    {"unwatch", os_bindings::builtin_os_events_unwatch},
+    {"poll", os_bindings::builtin_os_events_poll},
+    {"start_loop", os_bindings::builtin_os_events_start_loop},
+    {"stop_loop", os_bindings::builtin_os_events_stop_loop},
+    {"list", os_bindings::builtin_os_events_list},
+    {"set_callback", os_bindings::builtin_os_events_set_callback},
+    {"remove_callback", os_bindings::builtin_os_events_remove_callback},
+    {"dispatch", os_bindings::builtin_os_events_dispatch},
+    {"get_recent", os_bindings::builtin_os_events_get_recent},
+};
+
+// OS.Persistence submodule
+const Entry os_persistence_builtins[] = {
+    {"add_autostart", os_bindings::builtin_os_persistence_add_autostart},
+    {"remove_autostart", os_bindings::builtin_os_persistence_remove_autostart},
+    {"list_autostart", os_bindings::builtin_os_persistence_list_autostart},
+    {"install_service", os_bindings::builtin_os_persistence_install_service},
+    {"uninstall_service", os_bindings::builtin_os_persistence_uninstall_service},
+    {"start_service", os_bindings::builtin_os_persistence_start_service},
+    {"stop_service", os_bindings::builtin_os_persistence_stop_service},
+    {"restart_service", os_bindings::builtin_os_persistence_restart_service},
+    {"get_service_status", os_bindings::builtin_os_persistence_get_service_status},
+    {"add_scheduled_task", os_bindings::builtin_os_persistence_add_scheduled_task},
+    {"remove_scheduled_task", os_bindings::builtin_os_persistence_remove_scheduled_task},
+};
+
+} // namespace module_registry
+
+// ============================================================================
+// BASELINE JIT: one x86-64 template per bytecode instruction
+// ============================================================================
+// See the JITCompiler header comment for the frame/deopt model. Generated code
+// uses RBX = frame slots, R12 = operand stack top, R13 = FastVM*, R14 = the
+// integer tag mask. Only System V x86-64 is supported; elsewhere every
+// function stays interpreted.
+#if defined(__x86_64__) && !defined(_WIN32)
+#define LEVYTHON_BASELINE_JIT 1
+#endif
+
+// VM entry points called from generated code (static members of FastVM)
+struct JitRuntime {
+    uint64_t (*call)(FastVM* vm, uint64_t* sp, uint32_t argc, uint8_t* resume_ip);
+    void (*deopt)(FastVM* vm, uint8_t* resume_ip, uint64_t* sp);
+    void (*safepoint)(FastVM* vm, uint64_t* sp);
+    uint64_t (*get_global)(FastVM* vm, uint32_t slot);
+    void (*set_global)(FastVM* vm, uint32_t slot, uint64_t value);
+    uint64_t (*append_global)(FastVM* vm, uint32_t slot, uint64_t rhs);
+    void (*iter_init)(FastVM* vm, uint64_t obj);
+    uint64_t (*iter_next)(FastVM* vm, uint64_t* sp);
+    void (*iter_pop)(FastVM* vm, uint32_t count);
+};
+
+// Slow paths shared with the interpreter's semantics. JIT_UNHANDLED means the
+// interpreter must run the instruction (it raises the error or unwinds a try).
+static uint64_t jit_binary_op(uint32_t op, uint64_t a, uint64_t b) {
+    switch ((OpCode)op) {
+        case OpCode::OP_ADD: return fast_add(a, b);
+        case OpCode::OP_SUB: return fast_sub(a, b);
+        case OpCode::OP_MUL: return fast_mul(a, b);
+        case OpCode::OP_DIV: {
+            double da = is_int(a) ? (double)as_int(a) : as_number(a);
+            double db = is_int(b) ? (double)as_int(b) : as_number(b);
+            if (db == 0.0) return JIT_UNHANDLED;
+            return val_number(da / db);
+        }
+        case OpCode::OP_MOD:
+            if (!is_int(a) || !is_int(b) || as_int(b) == 0) return JIT_UNHANDLED;
+            return val_int(as_int(a) % as_int(b));
+        case OpCode::OP_LT: return fast_lt(a, b);
+        case OpCode::OP_GT: return fast_lt(b, a);
+        case OpCode::OP_LE: return fast_le(a, b);
+        case OpCode::OP_GE: return fast_le(b, a);
+        case OpCode::OP_AND: return (is_truthy(a) && is_truthy(b)) ? VAL_TRUE : VAL_FALSE;
+        case OpCode::OP_OR: return (is_truthy(a) || is_truthy(b)) ? VAL_TRUE : VAL_FALSE;
+        default: return JIT_UNHANDLED;
+    }
+}
+
+static uint64_t jit_unary_op(uint32_t op, uint64_t a) {
+    if ((OpCode)op == OpCode::OP_NEG) {
+        return is_int(a) ? val_int(-as_int(a)) : val_number(-as_number(a));
+    }
+    return is_truthy(a) ? VAL_FALSE : VAL_TRUE;  // OP_NOT
+}
+
+static uint64_t jit_truthy(uint64_t v) { return is_truthy(v) ? 1 : 0; }
+
+// init() bodies return none; the call evaluates to the instance instead
+static uint64_t jit_return_value(uint64_t self_val, uint64_t result) {
+    return (result == VAL_NONE && is_instance(self_val)) ? self_val : result;
+}
+
+static uint64_t jit_get_index(uint64_t obj, uint64_t idx) {
+    if (is_obj(obj) && obj_type(obj) == ObjType::LIST && is_int(idx)) {
+        ObjList* list = as_list(obj);
+        int64_t i = as_int(idx);
+        if (i >= 0 && i < (int64_t)list->count) return list->get((size_t)i);
+    } else if (is_obj(obj) && obj_type(obj) == ObjType::MAP &&
+               is_obj(idx) && obj_type(idx) == ObjType::STRING) {
+        ObjMap* map = as_map(obj);
+        auto it = map->data.find(as_string(idx));
+        if (it != map->data.end()) return it->second;
+    } else if (is_bytes(obj) && is_int(idx) && !is_bool(idx)) {
+        ObjBytes* b = as_bytes(obj);
+        int64_t i = as_int(idx);
+        if (i >= 0 && i < (int64_t)b->length) return val_int(b->data[i]);
+    }
+    return JIT_UNHANDLED;
+}
+
+static uint64_t jit_len(uint64_t v) {
+    if (!is_obj(v)) return val_int(0);
+    if (obj_type(v) == ObjType::LIST) return val_int(as_list(v)->count);
+    if (obj_type(v) == ObjType::STRING) return val_int(as_string(v)->length);
+    if (obj_type(v) == ObjType::RANGE) {
+        ObjRange* r = as_range(v);
+        int64_t len = 0;
+        if (r->step > 0 && r->stop > r->start) {
+            len = (r->stop - r->start + r->step - 1) / r->step;
+        } else if (r->step < 0 && r->stop < r->start) {
+            len = (r->start - r->stop - r->step - 1) / (-r->step);
+        }
+        return val_int(len);
+    }
+    if (obj_type(v) == ObjType::TENSOR) return val_int(as_tensor(v)->shape[0]);
+    if (obj_type(v) == ObjType::BYTES) return val_int((int64_t)as_bytes(v)->length);
+    return v;
+}
+
+static uint64_t jit_range(const uint64_t* args, uint32_t argc) {
+    for (uint32_t i = 0; i < argc; i++) {
+        if (!is_int(args[i])) return JIT_UNHANDLED;
+    }
+    int64_t start = 0, stop = 0, step = 1;
+    if (argc == 1) {
+        stop = as_int(args[0]);
+    } else if (argc == 2 || argc == 3) {
+        start = as_int(args[0]);
+        stop = as_int(args[1]);
+        if (argc == 3) step = as_int(args[2]);
+    } else {
+        return JIT_UNHANDLED;
+    }
+    if (step == 0) return JIT_UNHANDLED;
+    return val_obj((Obj*)ObjRange::create(start, stop, step));
+}
+
+// OP_EQ/OP_NE slow path for two different object values
+static uint64_t jit_string_eq(uint64_t a, uint64_t b) { return fast_eq(a, b); }
+static uint64_t jit_string_ne(uint64_t a, uint64_t b) { return fast_eq(a, b) == VAL_TRUE ? VAL_FALSE : VAL_TRUE; }
+static void jit_append_local(uint64_t* slot, uint64_t rhs) { append_in_place(*slot, rhs); }
+static uint64_t jit_seal(uint64_t v) { return seal_string(v); }
+
+class BaselineJIT : public JITCompiler {
+public:
+    BaselineJIT() : JITCompiler(CODE_BYTES) {}
+
+    // Compile a whole chunk, or return nullptr if it uses an unsupported opcode
+    JitEntry compile(Chunk* chunk, const JitRuntime& rt) {
+        if (!buf.code || !supported(chunk)) return nullptr;
+        size_t start = buf.pos();
+        const uint8_t* code = chunk->code.data();
+        size_t size = chunk->code.size();
+        labels.assign(size + 1, SIZE_MAX);
+        jumps.clear();
+        deopts.clear();
+        exits.clear();
+
+        // Prologue: five pushes keep RSP 16-byte aligned for helper calls
+        push_r64(RBX); push_r64(R12); push_r64(R13); push_r64(R14); push_r64(R15);
+        mov_r64_r64(R13, RDI);
+        mov_r64_r64(RBX, RSI);
+        mov_r64_r64(R12, RDX);
+        mov_r64_imm64(R14, QNAN_BITS | TAG_INT);
+
+        for (size_t pc = 0; pc < size;) {
+            labels[pc] = buf.pos();
+            OpCode op = (OpCode)code[pc];
+            uint8_t* here = chunk->code.data() + pc;
+            size_t next = pc + instruction_length(op);
+            switch (op) {
+                case OpCode::OP_CONST:
+                    mov_r64_imm64(RAX, chunk->fast_constants[read16(code + pc + 1)]);
+                    push_rax();
+                    break;
+                case OpCode::OP_CONST_INT:
+                    mov_r64_imm64(RAX, val_int(code[pc + 1]));
+                    push_rax();
+                    break;
+                case OpCode::OP_NONE: mov_r64_imm64(RAX, VAL_NONE); push_rax(); break;
+                case OpCode::OP_TRUE: mov_r64_imm64(RAX, VAL_TRUE); push_rax(); break;
+                case OpCode::OP_FALSE: mov_r64_imm64(RAX, VAL_FALSE); push_rax(); break;
+                case OpCode::OP_POP: add_r64_imm32(R12, -8); break;
+                case OpCode::OP_DUP: mov_r64_mem(RAX, R12, -8); push_rax(); break;
+                case OpCode::OP_GET_LOCAL:
+                    mov_r64_mem(RAX, RBX, 8 * code[pc + 1]);
+                    push_rax();
+                    break;
+                case OpCode::OP_SET_LOCAL:
+                    mov_r64_mem(RAX, R12, -8);
+                    mov_mem_r64(RBX, 8 * code[pc + 1], RAX);
+                    break;
+                case OpCode::OP_GET_LOCAL_SEAL: {
+                    mov_r64_mem(RAX, RBX, 8 * code[pc + 1]);
+                    mov_r64_imm64(RDX, QNAN_BITS | TAG_OBJ);
+                    mov_r64_r64(RSI, RAX);
+                    alu_r64_r64(0x21, RSI, RDX);
+                    alu_r64_r64(0x39, RSI, RDX);
+                    size_t plain = jcc_rel32(CC_NE);
+                    mov_r64_r64(RDI, RAX);
+                    call_abs((const void*)&jit_seal);
+                    patch_rel32(plain, buf.pos());
+                    push_rax();
+                    break;
+                }
+                case OpCode::OP_APPEND_LOCAL: {
+                    // Int accumulators stay inline; strings go to the builder
+                    int32_t off = 8 * code[pc + 1];
+                    mov_r64_mem(RAX, RBX, off);
+                    mov_r64_mem(RCX, R12, -8);
+                    mov_r64_r64(RDX, RAX);
+                    alu_r64_r64(0x21, RDX, RCX);
+                    alu_r64_r64(0x21, RDX, R14);
+                    alu_r64_r64(0x39, RDX, R14);
+                    size_t slow = jcc_rel32(CC_NE);
+                    alu_r64_r64(0x01, RAX, RCX);
+                    box_int_rax();
+                    mov_mem_r64(RBX, off, RAX);
+                    size_t done = jmp_rel32();
+                    patch_rel32(slow, buf.pos());
+                    mov_r64_r64(RDI, RBX);
+                    add_r64_imm32(RDI, off);
+                    mov_r64_r64(RSI, RCX);
+                    call_abs((const void*)&jit_append_local);
+                    patch_rel32(done, buf.pos());
+                    add_r64_imm32(R12, -8);
+                    break;
+                }
+                case OpCode::OP_ADD:
+                case OpCode::OP_SUB:
+                case OpCode::OP_MUL:
+                case OpCode::OP_MOD:
+                    emit_int_arith(op, here);
+                    break;
+                case OpCode::OP_LT:
+                case OpCode::OP_GT:
+                case OpCode::OP_LE:
+                case OpCode::OP_GE:
+                    emit_int_compare(op);
+                    break;
+                case OpCode::OP_DIV:
+                case OpCode::OP_AND:
+                case OpCode::OP_OR:
+                    mov_r64_mem(RSI, R12, -16);
+                    mov_r64_mem(RDX, R12, -8);
+                    emit_binary_helper(op, here);
+                    break;
+                case OpCode::OP_EQ:
+                case OpCode::OP_NE:
+                    emit_equality(op);
+                    break;
+                case OpCode::OP_NEG:
+                case OpCode::OP_NOT:
+                    mov_r64_imm64(RDI, (uint64_t)op);
+                    mov_r64_mem(RSI, R12, -8);
+                    call_abs((const void*)&jit_unary_op);
+                    mov_mem_r64(R12, -8, RAX);
+                    break;
+                case OpCode::OP_GET_GLOBAL:
+                    mov_r64_r64(RDI, R13);
+                    mov_r64_imm64(RSI, read16(code + pc + 1));
+                    call_abs((const void*)rt.get_global);
+                    mov_r64_imm64(RCX, JIT_DEOPT);
+                    alu_r64_r64(0x39, RAX, RCX);
+                    deopt_if(CC_E, here);
+                    push_rax();
+                    break;
+                case OpCode::OP_SET_GLOBAL:
+                    mov_r64_r64(RDI, R13);
+                    mov_r64_imm64(RSI, read16(code + pc + 1));
+                    mov_r64_mem(RDX, R12, -8);
+                    call_abs((const void*)rt.set_global);
+                    break;
+                case OpCode::OP_APPEND_GLOBAL:
+                    mov_r64_r64(RDI, R13);
+                    mov_r64_imm64(RSI, read16(code + pc + 1));
+                    mov_r64_mem(RDX, R12, -8);
+                    call_abs((const void*)rt.append_global);
+                    mov_r64_imm64(RCX, JIT_DEOPT);
+                    alu_r64_r64(0x39, RAX, RCX);
+                    deopt_if(CC_E, here);
+                    add_r64_imm32(R12, -8);
+                    break;
+                case OpCode::OP_JUMP:
+                    jump_to(jmp_rel32(), next + read16(code + pc + 1));
+                    break;
+                case OpCode::OP_JUMP_IF_FALSE:
+                    // Peeks the condition
+                    mov_r64_mem(RAX, R12, -8);
+                    emit_jump_if_falsy(next + read16(code + pc + 1));
+                    break;
+                // Superinstructions lower to the templates of their parts
+                case OpCode::OP_POP_JUMP_IF_FALSE:
+                    emit_pop_jump_if_falsy(next + read16(code + pc + 1));
+                    break;
+                case OpCode::OP_JUMP_IF_NOT_EQ:
+                case OpCode::OP_JUMP_IF_NOT_NE:
+                case OpCode::OP_JUMP_IF_NOT_LT:
+                case OpCode::OP_JUMP_IF_NOT_GT:
+                case OpCode::OP_JUMP_IF_NOT_LE:
+                case OpCode::OP_JUMP_IF_NOT_GE: {
+                    OpCode compare = (OpCode)((uint8_t)OpCode::OP_EQ +
+                                              ((uint8_t)op - (uint8_t)OpCode::OP_JUMP_IF_NOT_EQ));
+                    if (compare == OpCode::OP_EQ || compare == OpCode::OP_NE) emit_equality(compare);
+                    else emit_int_compare(compare);
+                    emit_pop_jump_if_falsy(next + read16(code + pc + 1));
+                    break;
+                }
+                case OpCode::OP_JUMP_IF_LOCAL_NOT_LT:
+                    mov_r64_mem(RAX, RBX, 8 * code[pc + 1]);
+                    push_rax();
+                    mov_r64_imm64(RAX, val_int(code[pc + 2]));
+                    push_rax();
+                    emit_int_compare(OpCode::OP_LT);
+                    emit_pop_jump_if_falsy(next + read16(code + pc + 3));
+                    break;
+                case OpCode::OP_ADD_LOCALS:
+                    mov_r64_mem(RAX, RBX, 8 * code[pc + 1]);
+                    push_rax();
+                    mov_r64_mem(RAX, RBX, 8 * code[pc + 2]);
+                    push_rax();
+                    deopt_unwind = 2;
+                    emit_int_arith(OpCode::OP_ADD, here);
+                    deopt_unwind = 0;
+                    break;
+                case OpCode::OP_INC_LOCAL: {
+                    int32_t off = 8 * code[pc + 1];
+                    int32_t delta = (int8_t)code[pc + 2];
+                    mov_r64_mem(RAX, RBX, off);
+                    mov_r64_r64(RDX, RAX);
+                    alu_r64_r64(0x21, RDX, R14);
+                    alu_r64_r64(0x39, RDX, R14);
+                    size_t slow = jcc_rel32(CC_NE);
+                    add_r64_imm32(RAX, delta);
+                    box_int_rax();
+                    size_t done = jmp_rel32();
+                    patch_rel32(slow, buf.pos());
+                    mov_r64_imm64(RDI, (uint64_t)(delta >= 0 ? OpCode::OP_ADD : OpCode::OP_SUB));
+                    mov_r64_r64(RSI, RAX);
+                    mov_r64_imm64(RDX, val_int(delta >= 0 ? delta : -delta));
+                    call_abs((const void*)&jit_binary_op);
+                    patch_rel32(done, buf.pos());
+                    mov_mem_r64(RBX, off, RAX);
+                    break;
+                }
+                case OpCode::OP_INDEX_LOCAL:
+                    mov_r64_mem(RAX, RBX, 8 * code[pc + 1]);
+                    push_rax();
+                    deopt_unwind = 1;
+                    emit_get_index(here);
+                    deopt_unwind = 0;
+                    break;
+                case OpCode::OP_LOOP: {
+                    // Back-edge safepoint, as in the interpreter
+                    mov_r64_imm64(RAX, (uint64_t)(uintptr_t)&g_heap.allocated);
+                    mov_r64_mem(RAX, RAX, 0);
+                    mov_r64_imm64(RCX, (uint64_t)(uintptr_t)&g_heap.threshold);
+                    mov_r64_mem(RCX, RCX, 0);
+                    alu_r64_r64(0x39, RAX, RCX);
+                    size_t no_gc = jcc_rel32(CC_B);
+                    mov_r64_r64(RDI, R13);
+                    mov_r64_r64(RSI, R12);
+                    call_abs((const void*)rt.safepoint);
+                    patch_rel32(no_gc, buf.pos());
+                    jump_to(jmp_rel32(), next - read16(code + pc + 1));
+                    break;
+                }
+                case OpCode::OP_CALL: {
+                    uint8_t argc = code[pc + 1];
+                    mov_r64_r64(RDI, R13);
+                    mov_r64_r64(RSI, R12);
+                    mov_r64_imm64(RDX, argc);
+                    mov_r64_imm64(RCX, (uint64_t)(uintptr_t)(chunk->code.data() + next));
+                    call_abs((const void*)rt.call);
+                    // Callee deopted: its frame is live in the interpreter now
+                    mov_r64_imm64(RCX, JIT_DEOPT);
+                    alu_r64_r64(0x39, RAX, RCX);
+                    exits.push_back(jcc_rel32(CC_E));
+                    mov_r64_imm64(RCX, JIT_UNHANDLED);
+                    alu_r64_r64(0x39, RAX, RCX);
+                    deopt_if(CC_E, here);
+                    add_r64_imm32(R12, -8 * (int32_t)argc);
+                    mov_mem_r64(R12, -8, RAX);
+                    break;
+                }
+                case OpCode::OP_RETURN: {
+                    mov_r64_mem(RAX, R12, -8);
+                    mov_r64_imm64(RCX, VAL_NONE);
+                    alu_r64_r64(0x39, RAX, RCX);
+                    exits.push_back(jcc_rel32(CC_NE));
+                    mov_r64_mem(RDI, RBX, 0);
+                    mov_r64_r64(RSI, RAX);
+                    call_abs((const void*)&jit_return_value);
+                    exits.push_back(jmp_rel32());
+                    break;
+                }
+                case OpCode::OP_ITER_INIT:
+                    mov_r64_r64(RDI, R13);
+                    mov_r64_mem(RSI, R12, -8);
+                    call_abs((const void*)rt.iter_init);
+                    add_r64_imm32(R12, -8);
+                    break;
+                case OpCode::OP_ITER_NEXT:
+                    mov_r64_r64(RDI, R13);
+                    mov_r64_r64(RSI, R12);
+                    call_abs((const void*)rt.iter_next);
+                    alu_r64_r64(0x85, RAX, RAX);
+                    jump_to(jcc_rel32(CC_E), next + read16(code + pc + 1));
+                    add_r64_imm32(R12, 8);
+                    break;
+                case OpCode::OP_ITER_POP:
+                    mov_r64_r64(RDI, R13);
+                    mov_r64_imm64(RSI, code[pc + 1]);
+                    call_abs((const void*)rt.iter_pop);
+                    break;
+                case OpCode::OP_GET_INDEX:
+                    emit_get_index(here);
+                    break;
+                case OpCode::OP_BUILTIN_LEN:
+                    mov_r64_mem(RDI, R12, -8);
+                    call_abs((const void*)&jit_len);
+                    mov_mem_r64(R12, -8, RAX);
+                    break;
+                case OpCode::OP_BUILTIN_RANGE: {
+                    uint8_t argc = code[pc + 1];
+                    mov_r64_r64(RDI, R12);
+                    add_r64_imm32(RDI, -8 * (int32_t)argc);
+                    mov_r64_imm64(RSI, argc);
+                    call_abs((const void*)&jit_range);
+                    mov_r64_imm64(RCX, JIT_UNHANDLED);
+                    alu_r64_r64(0x39, RAX, RCX);
+                    deopt_if(CC_E, here);
+                    add_r64_imm32(R12, -8 * (int32_t)argc);
+                    push_rax();
+                    break;
+                }
+                default:
+                    break;  // Rejected by supported()
+            }
+            pc = next;
+        }
+
+        // Shared bailout: RSI holds the bytecode address to resume at
+        size_t deopt_stub = buf.pos();
+        mov_r64_r64(RDI, R13);
+        mov_r64_r64(RDX, R12);
+        call_abs((const void*)rt.deopt);
+        mov_r64_imm64(RAX, JIT_DEOPT);
+
+        size_t epilogue = buf.pos();
+        pop_r64(R15); pop_r64(R14); pop_r64(R13); pop_r64(R12); pop_r64(RBX);
+        ret();
+
+        if (buf.overflow) {
+            buf.size = start;
+            buf.overflow = false;
+            return nullptr;
+        }
+        for (const auto& j : jumps) patch_rel32(j.first, labels[j.second]);
+        for (size_t d : deopts) patch_rel32(d, deopt_stub);
+        for (size_t e : exits) patch_rel32(e, epilogue);
+        return (JitEntry)(buf.code + start);
+    }
+
+private:
+    static constexpr size_t CODE_BYTES = 16 * 1024 * 1024;  // Reserved; pages commit on use
+
+    std::vector<size_t> labels;                       // Bytecode offset -> code offset
+    std::vector<std::pair<size_t, size_t>> jumps;     // (rel32 patch, bytecode target)
+    std::vector<size_t> deopts;                       // rel32 patches to the deopt stub
+    std::vector<size_t> exits;                        // rel32 patches to the epilogue
+    int32_t deopt_unwind = 0;  // Values a superinstruction pushed before it can bail out
+
+    static uint16_t read16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+
+    // Encoded size of each supported instruction (0 = unsupported)
+    static size_t instruction_length(OpCode op) {
+        switch (op) {
+            case OpCode::OP_NONE: case OpCode::OP_TRUE: case OpCode::OP_FALSE:
+            case OpCode::OP_POP: case OpCode::OP_DUP:
+            case OpCode::OP_ADD: case OpCode::OP_SUB: case OpCode::OP_MUL:
+            case OpCode::OP_DIV: case OpCode::OP_MOD: case OpCode::OP_NEG:
+            case OpCode::OP_EQ: case OpCode::OP_NE: case OpCode::OP_LT:
+            case OpCode::OP_GT: case OpCode::OP_LE: case OpCode::OP_GE:
+            case OpCode::OP_NOT: case OpCode::OP_AND: case OpCode::OP_OR:
+            case OpCode::OP_RETURN: case OpCode::OP_ITER_INIT:
+            case OpCode::OP_GET_INDEX: case OpCode::OP_BUILTIN_LEN:
+                return 1;
+            case OpCode::OP_CONST_INT: case OpCode::OP_GET_LOCAL:
+            case OpCode::OP_SET_LOCAL: case OpCode::OP_CALL:
+            case OpCode::OP_BUILTIN_RANGE:
+            case OpCode::OP_APPEND_LOCAL: case OpCode::OP_GET_LOCAL_SEAL:
+            case OpCode::OP_ITER_POP: case OpCode::OP_INDEX_LOCAL:
+                return 2;
+            case OpCode::OP_CONST: case OpCode::OP_GET_GLOBAL: case OpCode::OP_SET_GLOBAL:
+            case OpCode::OP_APPEND_GLOBAL: case OpCode::OP_JUMP: case OpCode::OP_JUMP_IF_FALSE: case OpCode::OP_LOOP:
+            case OpCode::OP_ITER_NEXT: case OpCode::OP_POP_JUMP_IF_FALSE:
+            case OpCode::OP_JUMP_IF_NOT_EQ: case OpCode::OP_JUMP_IF_NOT_NE:
+            case OpCode::OP_JUMP_IF_NOT_LT: case OpCode::OP_JUMP_IF_NOT_GT:
+            case OpCode::OP_JUMP_IF_NOT_LE: case OpCode::OP_JUMP_IF_NOT_GE:
+            case OpCode::OP_ADD_LOCALS: case OpCode::OP_INC_LOCAL:
+                return 3;
+            case OpCode::OP_JUMP_IF_LOCAL_NOT_LT:
+                return 5;
+            default:
+                return 0;
+        }
+    }
+
+    // Every opcode must have a template and every jump must land on an
+    // instruction boundary inside the chunk
+    static bool supported(const Chunk* chunk) {
+        const uint8_t* code = chunk->code.data();
+        size_t size = chunk->code.size();
+        std::vector<bool> starts(size + 1, false);
+        std::vector<size_t> targets;
+        for (size_t pc = 0; pc < size;) {
+            starts[pc] = true;
+            OpCode op = (OpCode)code[pc];
+            size_t len = instruction_length(op);
+            if (len == 0 || pc + len > size) return false;
+            size_t next = pc + len;
+            if (op == OpCode::OP_CONST && read16(code + pc + 1) >= chunk->fast_constants.size()) {
+                return false;
+            }
+            if (op == OpCode::OP_LOOP) {
+                size_t back = read16(code + pc + 1);
+                if (back > next) return false;
+                targets.push_back(next - back);
+            } else if (size_t at = bytecode::branch_operand(op)) {
+                targets.push_back(next + read16(code + pc + at));
+            }
+            pc = next;
+        }
+        for (size_t t : targets) {
+            if (t >= size || !starts[t]) return false;
+        }
+        return size > 0;
+    }
+
+    void push_rax() {
+        mov_mem_r64(R12, 0, RAX);
+        add_r64_imm32(R12, 8);
+    }
+
+    void jump_to(size_t patch_pos, size_t bytecode_target) {
+        jumps.push_back({patch_pos, bytecode_target});
+    }
+
+    // Deopt to the interpreter at `resume` when `cc` holds
+    void deopt_if(Cond cc, uint8_t* resume) {
+        Cond inverse = (Cond)(cc ^ 1);
+        size_t skip = jcc_rel32(inverse);
+        if (deopt_unwind) add_r64_imm32(R12, -8 * deopt_unwind);
+        mov_r64_imm64(RSI, (uint64_t)(uintptr_t)resume);
+        deopts.push_back(jmp_rel32());
+        patch_rel32(skip, buf.pos());
+    }
+
+    // RAX = condition value; bools are decided inline
+    void emit_jump_if_falsy(size_t target) {
+        mov_r64_imm64(RCX, VAL_TRUE);
+        alu_r64_r64(0x39, RAX, RCX);
+        size_t is_true = jcc_rel32(CC_E);
+        mov_r64_imm64(RCX, VAL_FALSE);
+        alu_r64_r64(0x39, RAX, RCX);
+        jump_to(jcc_rel32(CC_E), target);
+        mov_r64_r64(RDI, RAX);
+        call_abs((const void*)&jit_truthy);
+        alu_r64_r64(0x85, RAX, RAX);
+        jump_to(jcc_rel32(CC_E), target);
+        patch_rel32(is_true, buf.pos());
+    }
+
+    void emit_pop_jump_if_falsy(size_t target) {
+        mov_r64_mem(RAX, R12, -8);
+        add_r64_imm32(R12, -8);
+        emit_jump_if_falsy(target);
+    }
+
+    // Bit equality decides everything except two distinct objects, which
+    // may be equal strings or byte buffers
+    void emit_equality(OpCode op) {
+        mov_r64_mem(RAX, R12, -16);
+        mov_r64_mem(RCX, R12, -8);
+        alu_r64_r64(0x39, RAX, RCX);
+        mov_r64_imm64(RAX, VAL_FALSE);
+        mov_r64_imm64(RDX, VAL_TRUE);
+        cmov_r64_r64(op == OpCode::OP_EQ ? CC_E : CC_NE, RAX, RDX);
+        size_t done = jcc_rel32(CC_E);
+        mov_r64_mem(RDI, R12, -16);
+        mov_r64_imm64(RDX, QNAN_BITS | TAG_OBJ);
+        mov_r64_r64(RSI, RDI);
+        alu_r64_r64(0x21, RSI, RDX);
+        alu_r64_r64(0x39, RSI, RDX);
+        size_t not_obj = jcc_rel32(CC_NE);
+        mov_r64_mem(RSI, R12, -8);
+        call_abs(op == OpCode::OP_EQ ? (const void*)&jit_string_eq : (const void*)&jit_string_ne);
+        patch_rel32(done, buf.pos());
+        patch_rel32(not_obj, buf.pos());
+        mov_mem_r64(R12, -16, RAX);
+        add_r64_imm32(R12, -8);
+    }
+
+    void emit_get_index(uint8_t* here) {
+        mov_r64_mem(RDI, R12, -16);
+        mov_r64_mem(RSI, R12, -8);
+        call_abs((const void*)&jit_get_index);
+        mov_r64_imm64(RCX, JIT_UNHANDLED);
+        alu_r64_r64(0x39, RAX, RCX);
+        deopt_if(CC_E, here);
+        mov_mem_r64(R12, -16, RAX);
+        add_r64_imm32(R12, -8);
+    }
+
+    // RSI = a, RDX = b already loaded: result replaces the two operands
+    void emit_binary_helper(OpCode op, uint8_t* here) {
+        mov_r64_imm64(RDI, (uint64_t)op);
+        call_abs((const void*)&jit_binary_op);
+        mov_r64_imm64(RCX, JIT_UNHANDLED);
+        alu_r64_r64(0x39, RAX, RCX);
+        deopt_if(CC_E, here);
+        mov_mem_r64(R12, -16, RAX);
+        add_r64_imm32(R12, -8);
+    }
+
+    // Leaves RAX = a, RCX = b and jumps to the returned patch if either is not an int
+    size_t emit_int_guard() {
+        mov_r64_mem(RAX, R12, -16);
+        mov_r64_mem(RCX, R12, -8);
+        mov_r64_r64(RDX, RAX);
+        alu_r64_r64(0x21, RDX, RCX);
+        alu_r64_r64(0x21, RDX, R14);
+        alu_r64_r64(0x39, RDX, R14);
+        return jcc_rel32(CC_NE);
+    }
+
+    void sign_extend_int(Reg r) {
+        shift_r64_imm8(4, r, 16);
+        shift_r64_imm8(7, r, 16);
+    }
+
+    // RAX = val_int(RAX)
+    void box_int_rax() {
+        shift_r64_imm8(4, RAX, 16);
+        shift_r64_imm8(5, RAX, 16);
+        alu_r64_r64(0x09, RAX, R14);
+    }
+
+    void emit_int_arith(OpCode op, uint8_t* here) {
+        size_t slow = emit_int_guard();
+        size_t slow_zero = SIZE_MAX;
+        switch (op) {
+            case OpCode::OP_ADD: alu_r64_r64(0x01, RAX, RCX); break;
+            case OpCode::OP_SUB: alu_r64_r64(0x29, RAX, RCX); break;
+            case OpCode::OP_MUL:
+                sign_extend_int(RAX);
+                sign_extend_int(RCX);
+                imul_r64_r64(RAX, RCX);
+                break;
+            default:  // OP_MOD: C++ remainder semantics, zero divisor bails out
+                sign_extend_int(RCX);
+                alu_r64_r64(0x85, RCX, RCX);
+                slow_zero = jcc_rel32(CC_E);
+                sign_extend_int(RAX);
+                idiv_r64(RCX);
+                mov_r64_r64(RAX, RDX);
+                break;
+        }
+        box_int_rax();
+        mov_mem_r64(R12, -16, RAX);
+        add_r64_imm32(R12, -8);
+        size_t done = jmp_rel32();
+
+        patch_rel32(slow, buf.pos());
+        if (slow_zero != SIZE_MAX) patch_rel32(slow_zero, buf.pos());
+        mov_r64_mem(RSI, R12, -16);
+        mov_r64_mem(RDX, R12, -8);
+        emit_binary_helper(op, here);
+        patch_rel32(done, buf.pos());
+    }
+
+    void emit_int_compare(OpCode op) {
+        size_t slow = emit_int_guard();
+        sign_extend_int(RAX);
+        sign_extend_int(RCX);
+        alu_r64_r64(0x39, RAX, RCX);
+        Cond cc = op == OpCode::OP_LT ? CC_L : op == OpCode::OP_GT ? CC_G :
+                  op == OpCode::OP_LE ? CC_LE : CC_GE;
+        mov_r64_imm64(RAX, VAL_FALSE);
+        mov_r64_imm64(RDX, VAL_TRUE);
+        cmov_r64_r64(cc, RAX, RDX);
+        mov_mem_r64(R12, -16, RAX);
+        add_r64_imm32(R12, -8);
+        size_t done = jmp_rel32();
+
+        patch_rel32(slow, buf.pos());
+        mov_r64_imm64(RDI, (uint64_t)op);
+        mov_r64_mem(RSI, R12, -16);
+        mov_r64_mem(RDX, R12, -8);
+        call_abs((const void*)&jit_binary_op);
+        mov_mem_r64(R12, -16, RAX);
+        add_r64_imm32(R12, -8);
+        patch_rel32(done, buf.pos());
+    }
+};
+
+static BaselineJIT& baseline_jit() {
+    static BaselineJIT jit;
+    return jit;
+}
+
+// ============================================================================
+// TENSOR KERNELS
+// ============================================================================
+// Contiguous kernels behind the OP_TENSOR_* opcodes. The binary targets
+// baseline x86-64, so AVX2+FMA versions are picked at run time; AArch64 uses
+// NEON. Other targets and loop tails run the scalar loops, which the compiler
+// vectorizes with whatever the build allows.
+namespace tensor_kernels {
+
+enum class BinOp : uint8_t { ADD, MUL };
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define LEVYTHON_TENSOR_AVX2 1
+static bool has_avx2() {
+    static const bool ok = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return ok;
+}
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define LEVYTHON_TENSOR_NEON 1
+#endif
+
+// out = a op b; b is a single broadcast value when b_scalar
+template <class T>
+static void binary_scalar(BinOp op, const T* a, const T* b, T* out, size_t n, bool b_scalar) {
+    if (b_scalar) {
+        T bv = b[0];
+        if (op == BinOp::ADD) for (size_t i = 0; i < n; i++) out[i] = a[i] + bv;
+        else for (size_t i = 0; i < n; i++) out[i] = a[i] * bv;
+    } else {
+        if (op == BinOp::ADD) for (size_t i = 0; i < n; i++) out[i] = a[i] + b[i];
+        else for (size_t i = 0; i < n; i++) out[i] = a[i] * b[i];
+    }
+}
+
+template <class T>
+static double sum_scalar(const T* a, size_t n) {
+    double s = 0.0;
+    for (size_t i = 0; i < n; i++) s += (double)a[i];
+    return s;
+}
+
+template <class T>
+static double dot_scalar(const T* a, const T* b, size_t n) {
+    double s = 0.0;
+    for (size_t i = 0; i < n; i++) s += (double)a[i] * (double)b[i];
+    return s;
+}
+
+#ifdef LEVYTHON_TENSOR_AVX2
+__attribute__((target("avx2,fma")))
+static void binary_f64_avx2(BinOp op, const double* a, const double* b, double* out, size_t n, bool b_scalar) {
+    size_t i = 0;
+    __m256d bs = _mm256_set1_pd(b_scalar ? b[0] : 0.0);
+    for (; i + 4 <= n; i += 4) {
+        __m256d va = _mm256_loadu_pd(a + i);
+        __m256d vb = b_scalar ? bs : _mm256_loadu_pd(b + i);
+        _mm256_storeu_pd(out + i, op == BinOp::ADD ? _mm256_add_pd(va, vb) : _mm256_mul_pd(va, vb));
+    }
+    binary_scalar(op, a + i, b_scalar ? b : b + i, out + i, n - i, b_scalar);
+}
+
+__attribute__((target("avx2,fma")))
+static void binary_f32_avx2(BinOp op, const float* a, const float* b, float* out, size_t n, bool b_scalar) {
+    size_t i = 0;
+    __m256 bs = _mm256_set1_ps(b_scalar ? b[0] : 0.0f);
+    for (; i + 8 <= n; i += 8) {
+        __m256 va = _mm256_loadu_ps(a + i);
+        __m256 vb = b_scalar ? bs : _mm256_loadu_ps(b + i);
+        _mm256_storeu_ps(out + i, op == BinOp::ADD ? _mm256_add_ps(va, vb) : _mm256_mul_ps(va, vb));
+    }
+    binary_scalar(op, a + i, b_scalar ? b : b + i, out + i, n - i, b_scalar);
+}
+
+__attribute__((target("avx2,fma")))
+static double hsum_avx2(__m256d v) {
+    __m128d lo = _mm256_castpd256_pd128(v);
+    __m128d hi = _mm256_extractf128_pd(v, 1);
+    lo = _mm_add_pd(lo, hi);
+    return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+
+__attribute__((target("avx2,fma")))
+static double sum_f64_avx2(const double* a, size_t n) {
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        s0 = _mm256_add_pd(s0, _mm256_loadu_pd(a + i));
+        s1 = _mm256_add_pd(s1, _mm256_loadu_pd(a + i + 4));
+    }
+    return hsum_avx2(_mm256_add_pd(s0, s1)) + sum_scalar(a + i, n - i);
+}
+
+// f32 data is accumulated in double lanes
+__attribute__((target("avx2,fma")))
+static double sum_f32_avx2(const float* a, size_t n) {
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        s0 = _mm256_add_pd(s0, _mm256_cvtps_pd(_mm_loadu_ps(a + i)));
+        s1 = _mm256_add_pd(s1, _mm256_cvtps_pd(_mm_loadu_ps(a + i + 4)));
+    }
+    return hsum_avx2(_mm256_add_pd(s0, s1)) + sum_scalar(a + i, n - i);
+}
+
+__attribute__((target("avx2,fma")))
+static double dot_f64_avx2(const double* a, const double* b, size_t n) {
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), s0);
+        s1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), s1);
+    }
+    return hsum_avx2(_mm256_add_pd(s0, s1)) + dot_scalar(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx2,fma")))
+static double dot_f32_avx2(const float* a, const float* b, size_t n) {
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        s0 = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm_loadu_ps(a + i)), _mm256_cvtps_pd(_mm_loadu_ps(b + i)), s0);
+        s1 = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm_loadu_ps(a + i + 4)), _mm256_cvtps_pd(_mm_loadu_ps(b + i + 4)), s1);
+    }
+    return hsum_avx2(_mm256_add_pd(s0, s1)) + dot_scalar(a + i, b + i, n - i);
+}
+#endif
+
+#ifdef LEVYTHON_TENSOR_NEON
+static void binary_f64_neon(BinOp op, const double* a, const double* b, double* out, size_t n, bool b_scalar) {
+    size_t i = 0;
+    float64x2_t bs = vdupq_n_f64(b_scalar ? b[0] : 0.0);
+    for (; i + 2 <= n; i += 2) {
+        float64x2_t va = vld1q_f64(a + i);
+        float64x2_t vb = b_scalar ? bs : vld1q_f64(b + i);
+        vst1q_f64(out + i, op == BinOp::ADD ? vaddq_f64(va, vb) : vmulq_f64(va, vb));
+    }
+    binary_scalar(op, a + i, b_scalar ? b : b + i, out + i, n - i, b_scalar);
+}
+
+static void binary_f32_neon(BinOp op, const float* a, const float* b, float* out, size_t n, bool b_scalar) {
+    size_t i = 0;
+    float32x4_t bs = vdupq_n_f32(b_scalar ? b[0] : 0.0f);
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t va = vld1q_f32(a + i);
+        float32x4_t vb = b_scalar ? bs : vld1q_f32(b + i);
+        vst1q_f32(out + i, op == BinOp::ADD ? vaddq_f32(va, vb) : vmulq_f32(va, vb));
+    }
+    binary_scalar(op, a + i, b_scalar ? b : b + i, out + i, n - i, b_scalar);
+}
+
+static double sum_f64_neon(const double* a, size_t n) {
+    float64x2_t s0 = vdupq_n_f64(0.0), s1 = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 = vaddq_f64(s0, vld1q_f64(a + i));
+        s1 = vaddq_f64(s1, vld1q_f64(a + i + 2));
+    }
+    return vaddvq_f64(vaddq_f64(s0, s1)) + sum_scalar(a + i, n - i);
+}
+
+static double sum_f32_neon(const float* a, size_t n) {
+    float64x2_t s0 = vdupq_n_f64(0.0), s1 = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t v = vld1q_f32(a + i);
+        s0 = vaddq_f64(s0, vcvt_f64_f32(vget_low_f32(v)));
+        s1 = vaddq_f64(s1, vcvt_high_f64_f32(v));
+    }
+    return vaddvq_f64(vaddq_f64(s0, s1)) + sum_scalar(a + i, n - i);
+}
+
+static double dot_f64_neon(const double* a, const double* b, size_t n) {
+    float64x2_t s0 = vdupq_n_f64(0.0), s1 = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 = vfmaq_f64(s0, vld1q_f64(a + i), vld1q_f64(b + i));
+        s1 = vfmaq_f64(s1, vld1q_f64(a + i + 2), vld1q_f64(b + i + 2));
+    }
+    return vaddvq_f64(vaddq_f64(s0, s1)) + dot_scalar(a + i, b + i, n - i);
+}
+
+static double dot_f32_neon(const float* a, const float* b, size_t n) {
+    float64x2_t s0 = vdupq_n_f64(0.0), s1 = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t va = vld1q_f32(a + i), vb = vld1q_f32(b + i);
+        s0 = vfmaq_f64(s0, vcvt_f64_f32(vget_low_f32(va)), vcvt_f64_f32(vget_low_f32(vb)));
+        s1 = vfmaq_f64(s1, vcvt_high_f64_f32(va), vcvt_high_f64_f32(vb));
+    }
+    return vaddvq_f64(vaddq_f64(s0, s1)) + dot_scalar(a + i, b + i, n - i);
+}
+#endif
+
+void binary(BinOp op, DType dtype, const void* a, const void* b, void* out, size_t n, bool b_scalar) {
+    switch (dtype) {
+        case DType::F64:
+#if defined(LEVYTHON_TENSOR_AVX2)
+            if (has_avx2()) return binary_f64_avx2(op, (const double*)a, (const double*)b, (double*)out, n, b_scalar);
+#elif defined(LEVYTHON_TENSOR_NEON)
+            return binary_f64_neon(op, (const double*)a, (const double*)b, (double*)out, n, b_scalar);
+#endif
+            return binary_scalar(op, (const double*)a, (const double*)b, (double*)out, n, b_scalar);
+        case DType::F32:
+#if defined(LEVYTHON_TENSOR_AVX2)
+            if (has_avx2()) return binary_f32_avx2(op, (const float*)a, (const float*)b, (float*)out, n, b_scalar);
+#elif defined(LEVYTHON_TENSOR_NEON)
+            return binary_f32_neon(op, (const float*)a, (const float*)b, (float*)out, n, b_scalar);
+#endif
+            return binary_scalar(op, (const float*)a, (const float*)b, (float*)out, n, b_scalar);
+        case DType::I64:
+            return binary_scalar(op, (const int64_t*)a, (const int64_t*)b, (int64_t*)out, n, b_scalar);
+    }
+}
+
+double sum(DType dtype, const void* a, size_t n) {
+    switch (dtype) {
+        case DType::F64:
+#if defined(LEVYTHON_TENSOR_AVX2)
+            if (has_avx2()) return sum_f64_avx2((const double*)a, n);
+#elif defined(LEVYTHON_TENSOR_NEON)
+            return sum_f64_neon((const double*)a, n);
+#endif
+            return sum_scalar((const double*)a, n);
+        case DType::F32:
+#if defined(LEVYTHON_TENSOR_AVX2)
+            if (has_avx2()) return sum_f32_avx2((const float*)a, n);
+#elif defined(LEVYTHON_TENSOR_NEON)
+            return sum_f32_neon((const float*)a, n);
+#endif
+            return sum_scalar((const float*)a, n);
+        case DType::I64:
+            break;  // Integer reductions stay exact in the caller
+    }
+    return 0.0;
+}
+
+double dot(DType dtype, const void* a, const void* b, size_t n) {
+    switch (dtype) {
+        case DType::F64:
+#if defined(LEVYTHON_TENSOR_AVX2)
+            if (has_avx2()) return dot_f64_avx2((const double*)a, (const double*)b, n);
+#elif defined(LEVYTHON_TENSOR_NEON)
+            return dot_f64_neon((const double*)a, (const double*)b, n);
+#endif
+            return dot_scalar((const double*)a, (const double*)b, n);
+        case DType::F32:
+#if defined(LEVYTHON_TENSOR_AVX2)
+            if (has_avx2()) return dot_f32_avx2((const float*)a, (const float*)b, n);
+#elif defined(LEVYTHON_TENSOR_NEON)
+            return dot_f32_neon((const float*)a, (const float*)b, n);
+#endif
+            return dot_scalar((const float*)a, (const float*)b, n);
+        case DType::I64:
+            break;  // Integer reductions stay exact in the caller
+    }
+    return 0.0;
+}
+
+// ---------------------------------------------------------------------------
+// Matrix multiply: C[m x n] += A[m x k] * B[k x n], row-major, C zeroed by
+// the caller. Blocked over k and n so a KB x NB panel of B stays in L2 while
+// every row of the band streams past it.
+// ---------------------------------------------------------------------------
+static constexpr size_t KB = 256;
+static constexpr size_t NB = 256;
+
+template <class T>
+static void matmul_rows_scalar(const T* A, const T* B, T* C, size_t i0, size_t i1, size_t k, size_t n) {
+    for (size_t kb = 0; kb < k; kb += KB) {
+        size_t ke = std::min(k, kb + KB);
+        for (size_t jb = 0; jb < n; jb += NB) {
+            size_t je = std::min(n, jb + NB);
+            for (size_t i = i0; i < i1; i++) {
+                T* c = C + i * n;
+                for (size_t kk = kb; kk < ke; kk++) {
+                    T a = A[i * k + kk];
+                    const T* b = B + kk * n;
+                    for (size_t j = jb; j < je; j++) c[j] += a * b[j];
+                }
+            }
+        }
+    }
+}
+
+#ifdef LEVYTHON_TENSOR_AVX2
+// 4x8 register tile: four rows of A broadcast against two vectors of B
+__attribute__((target("avx2,fma")))
+static void matmul_rows_f64_avx2(const double* A, const double* B, double* C, size_t i0, size_t i1, size_t k, size_t n) {
+    for (size_t kb = 0; kb < k; kb += KB) {
+        size_t ke = std::min(k, kb + KB);
+        for (size_t jb = 0; jb < n; jb += NB) {
+            size_t je = std::min(n, jb + NB);
+            size_t i = i0;
+            for (; i + 4 <= i1; i += 4) {
+                double* c0 = C + i * n;
+                double* c1 = c0 + n;
+                double* c2 = c1 + n;
+                double* c3 = c2 + n;
+                const double* a0 = A + i * k;
+                const double* a1 = a0 + k;
+                const double* a2 = a1 + k;
+                const double* a3 = a2 + k;
+                size_t j = jb;
+                for (; j + 8 <= je; j += 8) {
+                    __m256d r00 = _mm256_loadu_pd(c0 + j), r01 = _mm256_loadu_pd(c0 + j + 4);
+                    __m256d r10 = _mm256_loadu_pd(c1 + j), r11 = _mm256_loadu_pd(c1 + j + 4);
+                    __m256d r20 = _mm256_loadu_pd(c2 + j), r21 = _mm256_loadu_pd(c2 + j + 4);
+                    __m256d r30 = _mm256_loadu_pd(c3 + j), r31 = _mm256_loadu_pd(c3 + j + 4);
+                    for (size_t kk = kb; kk < ke; kk++) {
+                        const double* b = B + kk * n + j;
+                        __m256d b0 = _mm256_loadu_pd(b), b1 = _mm256_loadu_pd(b + 4);
+                        __m256d x = _mm256_broadcast_sd(a0 + kk);
+                        r00 = _mm256_fmadd_pd(x, b0, r00); r01 = _mm256_fmadd_pd(x, b1, r01);
+                        x = _mm256_broadcast_sd(a1 + kk);
+                        r10 = _mm256_fmadd_pd(x, b0, r10); r11 = _mm256_fmadd_pd(x, b1, r11);
+                        x = _mm256_broadcast_sd(a2 + kk);
+                        r20 = _mm256_fmadd_pd(x, b0, r20); r21 = _mm256_fmadd_pd(x, b1, r21);
+                        x = _mm256_broadcast_sd(a3 + kk);
+                        r30 = _mm256_fmadd_pd(x, b0, r30); r31 = _mm256_fmadd_pd(x, b1, r31);
+                    }
+                    _mm256_storeu_pd(c0 + j, r00); _mm256_storeu_pd(c0 + j + 4, r01);
+                    _mm256_storeu_pd(c1 + j, r10); _mm256_storeu_pd(c1 + j + 4, r11);
+                    _mm256_storeu_pd(c2 + j, r20); _mm256_storeu_pd(c2 + j + 4, r21);
+                    _mm256_storeu_pd(c3 + j, r30); _mm256_storeu_pd(c3 + j + 4, r31);
+                }
+                for (size_t r = 0; r < 4 && j < je; r++) {
+                    double* c = C + (i + r) * n;
+                    for (size_t kk = kb; kk < ke; kk++) {
+                        double a = A[(i + r) * k + kk];
+                        const double* b = B + kk * n;
+                        for (size_t jj = j; jj < je; jj++) c[jj] += a * b[jj];
+                    }
+                }
+            }
+            for (; i < i1; i++) {
+                double* c = C + i * n;
+                for (size_t kk = kb; kk < ke; kk++) {
+                    double a = A[i * k + kk];
+                    const double* b = B + kk * n;
+                    for (size_t j = jb; j < je; j++) c[j] += a * b[j];
+                }
+            }
+        }
+    }
+}
+
+// 4x16 register tile, the f32 analogue of matmul_rows_f64_avx2
+__attribute__((target("avx2,fma")))
+static void matmul_rows_f32_avx2(const float* A, const float* B, float* C, size_t i0, size_t i1, size_t k, size_t n) {
+    for (size_t kb = 0; kb < k; kb += KB) {
+        size_t ke = std::min(k, kb + KB);
+        for (size_t jb = 0; jb < n; jb += NB) {
+            size_t je = std::min(n, jb + NB);
+            size_t i = i0;
+            for (; i + 4 <= i1; i += 4) {
+                float* c0 = C + i * n;
+                float* c1 = c0 + n;
+                float* c2 = c1 + n;
+                float* c3 = c2 + n;
+                const float* a0 = A + i * k;
+                const float* a1 = a0 + k;
+                const float* a2 = a1 + k;
+                const float* a3 = a2 + k;
+                size_t j = jb;
+                for (; j + 16 <= je; j += 16) {
+                    __m256 r00 = _mm256_loadu_ps(c0 + j), r01 = _mm256_loadu_ps(c0 + j + 8);
+                    __m256 r10 = _mm256_loadu_ps(c1 + j), r11 = _mm256_loadu_ps(c1 + j + 8);
+                    __m256 r20 = _mm256_loadu_ps(c2 + j), r21 = _mm256_loadu_ps(c2 + j + 8);
+                    __m256 r30 = _mm256_loadu_ps(c3 + j), r31 = _mm256_loadu_ps(c3 + j + 8);
+                    for (size_t kk = kb; kk < ke; kk++) {
+                        const float* b = B + kk * n + j;
+                        __m256 b0 = _mm256_loadu_ps(b), b1 = _mm256_loadu_ps(b + 8);
+                        __m256 x = _mm256_broadcast_ss(a0 + kk);
+                        r00 = _mm256_fmadd_ps(x, b0, r00); r01 = _mm256_fmadd_ps(x, b1, r01);
+                        x = _mm256_broadcast_ss(a1 + kk);
+                        r10 = _mm256_fmadd_ps(x, b0, r10); r11 = _mm256_fmadd_ps(x, b1, r11);
+                        x = _mm256_broadcast_ss(a2 + kk);
+                        r20 = _mm256_fmadd_ps(x, b0, r20); r21 = _mm256_fmadd_ps(x, b1, r21);
+                        x = _mm256_broadcast_ss(a3 + kk);
+                        r30 = _mm256_fmadd_ps(x, b0, r30); r31 = _mm256_fmadd_ps(x, b1, r31);
+                    }
+                    _mm256_storeu_ps(c0 + j, r00); _mm256_storeu_ps(c0 + j + 8, r01);
+                    _mm256_storeu_ps(c1 + j, r10); _mm256_storeu_ps(c1 + j + 8, r11);
+                    _mm256_storeu_ps(c2 + j, r20); _mm256_storeu_ps(c2 + j + 8, r21);
+                    _mm256_storeu_ps(c3 + j, r30); _mm256_storeu_ps(c3 + j + 8, r31);
+                }
+                for (size_t r = 0; r < 4 && j < je; r++) {
+                    float* c = C + (i + r) * n;
+                    for (size_t kk = kb; kk < ke; kk++) {
+                        float a = A[(i + r) * k + kk];
+                        const float* b = B + kk * n;
+                        for (size_t jj = j; jj < je; jj++) c[jj] += a * b[jj];
+                    }
+                }
+            }
+            for (; i < i1; i++) {
+                float* c = C + i * n;
+                for (size_t kk = kb; kk < ke; kk++) {
+                    float a = A[i * k + kk];
+                    const float* b = B + kk * n;
+                    for (size_t j = jb; j < je; j++) c[j] += a * b[j];
+                }
+            }
+        }
+    }
+}
+#endif
+
+// Rows are split across threads once the product is big enough to pay for
+// spawning them (about 4M multiply-adds per extra thread)
+static constexpr double PARALLEL_WORK = 4.0 * 1024 * 1024;
+
+template <class F>
+static void parallel_rows(size_t m, double work, const F& fn) {
+    size_t threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    threads = std::min<size_t>({threads, (size_t)(work / PARALLEL_WORK) + 1, (m + 3) / 4, 64});
+    if (threads <= 1) {
+        fn(0, m);
+        return;
+    }
+    size_t band = ((m + threads - 1) / threads + 3) & ~size_t(3);  // Keep 4-row tiles whole
+    std::vector<std::thread> workers;
+    for (size_t start = band; start < m; start += band) {
+        size_t end = std::min(m, start + band);
+        workers.emplace_back([&fn, start, end] { fn(start, end); });
+    }
+    fn(0, std::min(m, band));
+    for (auto& w : workers) w.join();
+}
+
+void matmul(DType dtype, const void* A, const void* B, void* C, size_t m, size_t k, size_t n) {
+    double work = (double)m * (double)k * (double)n;
+    switch (dtype) {
+        case DType::F64:
+            parallel_rows(m, work, [&](size_t i0, size_t i1) {
+#ifdef LEVYTHON_TENSOR_AVX2
+                if (has_avx2()) return matmul_rows_f64_avx2((const double*)A, (const double*)B, (double*)C, i0, i1, k, n);
+#endif
+                matmul_rows_scalar((const double*)A, (const double*)B, (double*)C, i0, i1, k, n);
+            });
+            break;
+        case DType::F32:
+            parallel_rows(m, work, [&](size_t i0, size_t i1) {
+#ifdef LEVYTHON_TENSOR_AVX2
+                if (has_avx2()) return matmul_rows_f32_avx2((const float*)A, (const float*)B, (float*)C, i0, i1, k, n);
+#endif
+                matmul_rows_scalar((const float*)A, (const float*)B, (float*)C, i0, i1, k, n);
+            });
+            break;
+        case DType::I64:
+            parallel_rows(m, work, [&](size_t i0, size_t i1) {
+                matmul_rows_scalar((const int64_t*)A, (const int64_t*)B, (int64_t*)C, i0, i1, k, n);
+            });
+            break;
+    }
+}
+
+} // namespace tensor_kernels
+
+// Directory of the script being run; OP_IMPORT looks there for local modules
+// the working directory doesn't have
+static fs::path g_script_dir;
+
+// ============================================================================
+// High-performance bytecode VM - NaN-boxed 8-byte values, computed goto dispatch
+// ============================================================================
+class FastVM {
+    static constexpr size_t STACK_MAX = 262144;  // 256K slots for deep recursion
+    static constexpr size_t FRAMES_MAX = 65536;  // Allow deep recursion
+    
+    struct CallFrame {
+        Chunk* chunk;
+        uint8_t* ip;
+        uint64_t* slots;  // Direct pointer to frame's stack slots
+        const char* name;
+    };
+    
+    // ========================================================================
+    // JIT OPTIMIZATION FRAMEWORK
+    // ========================================================================
+    
+    // GUARD: Runtime type/bounds check with bailout to original bytecode
+    struct Guard {
+        enum GuardType : uint8_t {
+            TYPE_INT,           // Value must be integer
+            TYPE_FLOAT,         // Value must be float/number
+            TYPE_STRING,        // Value must be string
+            TYPE_LIST,          // Value must be list
+            BOUNDS_CHECK,       // Index within bounds
+            NOT_NONE,           // Value must not be None
+            MONOMORPHIC_FUNC,   // Call site always calls same function
+            STABLE_GLOBAL,      // Global hasn't changed since specialization
+        };
+        
         GuardType type;
         uint64_t expected_value;  // For monomorphic/stable checks
         uint8_t* bailout_pc;      // Jump here if guard fails (original bytecode)
@@ -21946,6 +29686,89 @@ class FastVM {
     
     LoopProfile loop_profiles[MAX_LOOPS];
     InlineCache inline_caches[MAX_INLINE_CACHES];
+
+    // Module call site cache: resolved native for (site, receiver map).
+    // Only module maps are cached; they stay rooted for the VM's lifetime and
+    // carry their own version, so stores into other maps leave entries valid.
+    struct NativeCallCache {
+        const uint8_t* site = nullptr;
+        ObjMap* receiver = nullptr;
+        ObjNative* target = nullptr;
+        uint32_t version = 0;
+        uint64_t hits = 0, misses = 0;
+    };
+    NativeCallCache native_caches[MAX_INLINE_CACHES];
+
+    // Polymorphic instance caches, one per site. Property entries map a Shape
+    // to its slot (and, for stores that add the field, the shape after the
+    // transition); shapes are immutable so these never go stale. Method
+    // entries map a class to the resolved function and are dropped whenever
+    // class_epoch moves (a class is (re)defined or objects were collected).
+    static constexpr uint8_t PIC_WAYS = 4;
+    struct PropertyCache {
+        const uint8_t* site = nullptr;
+        Shape* shapes[PIC_WAYS] = {};
+        Shape* next[PIC_WAYS] = {};
+        uint32_t slots[PIC_WAYS] = {};
+        uint8_t count = 0;
+        uint64_t hits = 0, misses = 0;  // Per cache slot, across sites (--profile)
+    };
+    struct MethodCache {
+        const uint8_t* site = nullptr;
+        ObjClass* classes[PIC_WAYS] = {};
+        uint64_t targets[PIC_WAYS] = {};
+        uint8_t count = 0;
+        uint64_t epoch = 0;
+        uint64_t hits = 0, misses = 0;
+    };
+    PropertyCache property_caches[MAX_INLINE_CACHES];
+    MethodCache method_caches[MAX_INLINE_CACHES];
+    uint64_t class_epoch = 0;
+
+    static size_t site_cache_index(const uint8_t* site) {
+        return (reinterpret_cast<uintptr_t>(site) >> 1) % MAX_INLINE_CACHES;
+    }
+
+    PropertyCache& property_cache(const uint8_t* site) {
+        PropertyCache& pc = property_caches[site_cache_index(site)];
+        if (pc.site != site) {
+            pc.site = site;
+            pc.count = 0;
+        }
+        return pc;
+    }
+
+    static void cache_property(PropertyCache& pc, Shape* shape, Shape* next, uint32_t slot) {
+        if (pc.count == PIC_WAYS) return;  // Megamorphic: keep using shape lookups
+        pc.shapes[pc.count] = shape;
+        pc.next[pc.count] = next;
+        pc.slots[pc.count] = slot;
+        pc.count++;
+    }
+
+    // Resolve `name` on `klass` through the site's method cache
+    uint64_t cached_method(const uint8_t* site, ObjClass* klass, const std::string& name) {
+        MethodCache& mc = method_caches[site_cache_index(site)];
+        if (mc.site != site || mc.epoch != class_epoch) {
+            mc.site = site;
+            mc.count = 0;
+            mc.epoch = class_epoch;
+        }
+        for (uint8_t i = 0; i < mc.count; ++i) {
+            if (mc.classes[i] == klass) {
+                mc.hits++;
+                return mc.targets[i];
+            }
+        }
+        mc.misses++;
+        uint64_t method = klass->find_method(name);
+        if (method != VAL_NONE && mc.count < PIC_WAYS) {
+            mc.classes[mc.count] = klass;
+            mc.targets[mc.count] = method;
+            mc.count++;
+        }
+        return method;
+    }
     std::unordered_map<uint8_t*, OptimizedCode> optimized_functions;
     
     size_t loop_profile_count = 0;
@@ -21959,10 +29782,17 @@ class FastVM {
     CallFrame* fp;  // Frame pointer
     size_t frame_count;
     
-    // Globals using interned strings for fast lookup  
-    struct StrHash { size_t operator()(ObjString* s) const { return s->hash; } };
-    struct StrEq { bool operator()(ObjString* a, ObjString* b) const { return a == b; } };
-    std::unordered_map<ObjString*, uint64_t, StrHash, StrEq> globals;
+    // Globals indexed by the slots from g_global_slots (VAL_UNDEFINED = unset)
+    std::vector<uint64_t> globals;
+
+    // Shared state for zero-copy natives (see NativeFn)
+    VMContext native_ctx;
+
+    // Imported modules by name, or by resolved path for local .levy modules
+    // (VAL_UNDEFINED while one is loading)
+    std::unordered_map<ObjString*, uint64_t> modules;
+    // Compiled local modules by resolved path; owns the chunks their functions point into
+    std::unordered_map<std::string, std::shared_ptr<Chunk>> module_chunks;
     
     // Name->interned string cache for fast global resolution
     std::unordered_map<std::string, ObjString*> name_cache;
@@ -21990,9 +29820,9 @@ class FastVM {
     ObjMap* log_module_map = nullptr;
     ObjMap* config_module_map = nullptr;
     ObjMap* input_module_map = nullptr;
+    ObjMap* gc_module_map = nullptr;
     
     // Iterator state
-    struct FastIter { uint64_t obj; size_t idx; int64_t cur; int64_t stop; int64_t step; };
     FastIter iterators[256];
     size_t iter_count = 0;
     
@@ -22006,12 +29836,33 @@ class FastVM {
     TryHandler try_handlers[64];
     size_t try_count = 0;
 
+    // Coroutines (async act). A running coroutine's frames, stack, iterators
+    // and try handlers sit on top of whoever started or resumed it; the
+    // bases below record where they begin so they can be parked on await.
+    struct CoroRun {
+        ObjCoroutine* coro;
+        size_t base_frame;   // frames[] index of its first frame
+        uint64_t* base_sp;   // Its first stack slot (the callee slot)
+        size_t iter_base;
+        size_t try_base;
+        bool push_handle;    // Started by a call: leave the coroutine as the call result
+    };
+    std::vector<CoroRun> coro_runs;
+    size_t coro_base_frame = SIZE_MAX;  // coro_runs.back().base_frame, or none
+    std::deque<ObjCoroutine*> coro_ready;
+    std::unordered_map<long, std::vector<ObjCoroutine*>> coro_task_waiters;  // async task id -> waiters
+    std::vector<long> coro_finished_ids;
+    uint32_t coro_resumes = 0;
+    uint8_t* main_await_ip = nullptr;   // Blocking await outside any coroutine in progress
+    std::chrono::steady_clock::time_point main_await_deadline;
+
 public:
     FastVM() : stack(std::make_unique<uint64_t[]>(STACK_MAX)), 
                frames(std::make_unique<CallFrame[]>(FRAMES_MAX)),
                frame_count(0), loop_profile_count(0), inline_cache_count(0) {
         sp = stack.get();
         fp = frames.get();
+        native_ctx.vm = this;
         // Initialize loop profiles
         for (size_t i = 0; i < MAX_LOOPS; i++) {
             loop_profiles[i] = LoopProfile();
@@ -22022,14 +29873,117 @@ public:
         }
     }
     
+    ~FastVM() {
+        if (profiler::attached(this)) profiler::finish();
+        if (g_heap.roots_owner == this) {
+            g_heap.mark_roots = nullptr;
+            g_heap.roots_owner = nullptr;
+        }
+    }
+
     uint64_t run(Chunk* chunk) {
         fp->chunk = chunk;
         fp->ip = chunk->code.data();
         fp->slots = stack.get();
         fp->name = "<main>";
         frame_count = 1;
+        g_heap.mark_roots = [](void* owner) { static_cast<FastVM*>(owner)->mark_roots(); };
+        g_heap.roots_owner = this;
+        g_heap.tracking = true;
+        if (profiler::active()) profiler::attach(this, &FastVM::profile_walk, &FastVM::profile_caches);
         return execute(chunk);
     }
+
+    // Isolates raise runtime errors as IsolateError (message plus the
+    // isolate's stack) so the pool thread can hand them to thread.join
+    // instead of exiting the process
+    bool throw_errors = false;
+    struct IsolateError : std::runtime_error {
+        using std::runtime_error::runtime_error;
+    };
+
+    // Run fn(args) to completion as this VM's only activation (thread
+    // isolates). The caller installs g_heap.mark_roots: other VMs on the
+    // thread may be suspended in a native while this one runs.
+    uint64_t run_function(uint64_t fn, const uint64_t* args, uint8_t argc) {
+        ObjFunc* func = as_func(fn);
+        sp = stack.get();
+        *sp++ = fn;
+        for (uint8_t i = 0; i < argc; ++i) *sp++ = args[i];
+        fp = frames.get();
+        frame_count = 1;
+        iter_count = 0;
+        try_count = 0;
+        fp->chunk = func->chunk;
+        fp->ip = func->chunk->code.data();
+        fp->slots = stack.get();
+        fp->name = func->name ? func->name->chars : "<thread>";
+        uint64_t result = execute(func->chunk);
+        // No allocation happens before the caller copies the result out
+        sp = stack.get();
+        return result;
+    }
+
+    std::vector<uint64_t>& global_values() { return globals; }
+
+    // In an isolate: per global slot, the kind of value ("list", "map", ...)
+    // the spawning thread held there but could not share, else null
+    std::vector<const char*> unshared_globals;
+
+    // Import name of a loaded module map, or null
+    ObjString* module_name_of(uint64_t v) const {
+        for (const auto& entry : modules) {
+            if (entry.second == v) return entry.first;
+        }
+        return nullptr;
+    }
+
+    void adopt_module(ObjString* name, uint64_t module_val) { modules[name] = module_val; }
+
+    std::atomic<int64_t>* atomic_cell(uint64_t cell) {
+        std::atomic<int64_t>* p = nullptr;
+        if (is_int(cell) && !is_bool(cell)) p = thread_bindings::find_atomic_cell(as_int(cell));
+        if (!p) runtime_error("atomic operations take a cell from thread.atomic()");
+        return p;
+    }
+
+    int64_t atomic_operand(uint64_t v) {
+        if (!is_int(v) || is_bool(v)) runtime_error("atomic operations take integer values");
+        return as_int(v);
+    }
+
+    // GC roots: everything the VM can still reach between instructions
+    void mark_roots() {
+        for (uint64_t* v = stack.get(); v < sp; ++v) gc_mark_value(*v);
+        for (size_t i = 0; i < frame_count; ++i) gc_mark_chunk(frames[i].chunk);
+        for (uint64_t v : globals) gc_mark_value(v);
+        for (size_t i = 0; i < iter_count; ++i) gc_mark_value(iterators[i].obj);
+        for (const auto& run : coro_runs) gc_mark_object(run.coro);
+        for (ObjCoroutine* co : coro_ready) gc_mark_object(co);
+        for (const auto& w : coro_task_waiters) {
+            for (ObjCoroutine* co : w.second) gc_mark_object(co);
+        }
+        for (const auto& m : modules) {
+            gc_mark_object(m.first);
+            gc_mark_value(m.second);
+        }
+        for (const auto& c : module_chunks) gc_mark_chunk(c.second.get());
+        for (const auto& n : name_cache) gc_mark_object(n.second);
+        for (size_t i = 0; i < g_global_slots.size(); ++i) {
+            gc_mark_object(g_global_slots.name_of((uint16_t)i));
+        }
+        ObjMap* builtin_maps[] = {
+            http_module_map, os_module_map, fs_module_map, path_module_map,
+            process_module_map, json_module_map, url_module_map, net_module_map,
+            thread_module_map, channel_module_map, async_module_map, crypto_module_map,
+            time_module_map, log_module_map, config_module_map, input_module_map,
+            gc_module_map,
+        };
+        for (ObjMap* m : builtin_maps) gc_mark_object(m);
+        // Freed classes may be recycled at the same address; drop cached
+        // method targets
+        class_epoch++;
+    }
     
     // Convert heavy Value to fast value
     uint64_t from_value(const Value& v) {
@@ -22074,6 +30028,15 @@ public:
         }
     }
     
+    // Storage for a global slot; grows lazily as the Compiler hands out slots
+    uint64_t& global_ref(uint16_t slot) {
+        if (slot >= globals.size()) {
+            globals.resize(g_global_slots.size() > slot ? g_global_slots.size() : slot + 1,
+                           VAL_UNDEFINED);
+        }
+        return globals[slot];
+    }
+
     ObjString* intern_name(const std::string& name) {
         auto it = name_cache.find(name);
         if (it != name_cache.end()) return it->second;
@@ -22118,28 +30081,444 @@ public:
                 result.data.range.step = static_cast<long>(range->step);
                 return result;
             }
+            case ObjType::TENSOR: {
+                ObjTensor* t = as_tensor(v);
+                return to_value(tensor_to_list(t, 0, t->offset));
+            }
+            case ObjType::BYTES: {
+                ObjBytes* b = as_bytes(v);
+                return Value(std::string(reinterpret_cast<const char*>(b->data), b->length));
+            }
             default:
                 return Value(val_to_string(v));
         }
     }
 
+    // Populate a module map with ObjNative entries. Legacy tables come first;
+    // zero-copy tables then attach their fn to the same entry. The first entry
+    // for a name wins, matching the old if-chain order.
+    template <size_t N>
+    static void register_natives(ObjMap* map, const module_registry::Entry (&table)[N]) {
+        map->module = true;
+        for (const auto& e : table) {
+            ObjString* key = g_strings.intern(e.name);
+            map->data.emplace(key, val_obj((Obj*)ObjNative::create(key, nullptr, e.fn)));
+        }
+    }
+
+    template <size_t N>
+    static void register_natives(ObjMap* map, const native_module_util::NativeEntry (&table)[N]) {
+        map->module = true;
+        for (const auto& e : table) {
+            ObjString* key = g_strings.intern(e.name);
+            auto it = map->data.find(key);
+            if (it != map->data.end() && is_native(it->second)) {
+                as_native(it->second)->fn = e.fn;
+            } else {
+                map->data[key] = val_obj((Obj*)ObjNative::create(key, e.fn, nullptr));
+            }
+        }
+    }
+
+    // Invoke a builtin module function on argc stack slots. Binding errors
+    // surface as VM runtime errors.
+    // ========================================================================
+    // BASELINE JIT ENTRY POINTS
+    // ========================================================================
+    // Native code shares the interpreter's stack and CallFrames, so a bailout
+    // only has to store the resume ip and stack top.
+    // ===== Coroutine scheduling =====
+
+    // The callee's frame was just pushed: it becomes the coroutine's first
+    // frame and runs until it returns or suspends in await
+    void begin_coroutine(ObjFunc* func) {
+        ObjCoroutine* co = ObjCoroutine::create(func->name ? func->name : intern_name("<anon>"));
+        coro_runs.push_back({co, frame_count - 1, fp->slots, iter_count, try_count, true});
+        coro_base_frame = frame_count - 1;
+    }
+
+    // Drop the running coroutine's state from the VM and return to the frame
+    // that started or resumed it
+    void leave_coroutine(const CoroRun& run) {
+        frame_count = run.base_frame;
+        fp = frames.get() + run.base_frame - 1;
+        sp = run.base_sp;
+        iter_count = run.iter_base;
+        try_count = run.try_base;
+        if (run.push_handle) *sp++ = val_obj(run.coro);
+        coro_base_frame = coro_runs.empty() ? SIZE_MAX : coro_runs.back().base_frame;
+    }
+
+    void finish_coroutine(uint64_t result) {
+        CoroRun run = coro_runs.back();
+        coro_runs.pop_back();
+        ObjCoroutine* co = run.coro;
+        co->state = ObjCoroutine::State::DONE;
+        co->result = result;
+        for (ObjCoroutine* w : co->waiters) wake_coroutine(w);
+        co->waiters.clear();
+        clear_await_deadline(co);
+        leave_coroutine(run);
+    }
+
+    // Park the running coroutine; the top frame's ip must point at its await
+    void suspend_coroutine() {
+        CoroRun run = coro_runs.back();
+        coro_runs.pop_back();
+        ObjCoroutine* co = run.coro;
+        co->state = ObjCoroutine::State::SUSPENDED;
+        co->stack.assign(run.base_sp, sp);
+        co->frames.clear();
+        for (size_t i = run.base_frame; i < frame_count; ++i) {
+            const CallFrame& f = frames[i];
+            co->frames.push_back({f.chunk, f.ip, (size_t)(f.slots - run.base_sp), f.name});
+        }
+        co->iters.assign(iterators + run.iter_base, iterators + iter_count);
+        co->handlers.clear();
+        for (size_t i = run.try_base; i < try_count; ++i) {
+            const TryHandler& h = try_handlers[i];
+            co->handlers.push_back({h.catch_ip, h.saved_ip, (size_t)(h.saved_sp - run.base_sp),
+                                    (size_t)(h.saved_fp - frames.get()) - run.base_frame});
+        }
+        leave_coroutine(run);
+    }
+
+    // Copy a parked coroutine back on top of the current frame, which
+    // continues at resume_ip once the coroutine returns or suspends again
+    void resume_coroutine(ObjCoroutine* co, uint8_t* resume_ip) {
+        if (frame_count + co->frames.size() >= FRAMES_MAX - 1) {
+            runtime_errorf("Stack overflow! Max frames: %zu", FRAMES_MAX);
+        }
+        if ((size_t)(sp - stack.get()) + co->stack.size() >= STACK_MAX) runtime_error("Stack overflow");
+        if (iter_count + co->iters.size() > 256 || try_count + co->handlers.size() > 64) {
+            runtime_error("Too many active loops or try blocks across coroutines");
+        }
+        fp->ip = resume_ip;
+        uint64_t* base = sp;
+        size_t base_frame = frame_count;
+        std::copy(co->stack.begin(), co->stack.end(), base);
+        sp = base + co->stack.size();
+        for (const auto& f : co->frames) {
+            fp++;
+            frame_count++;
+            fp->chunk = f.chunk;
+            fp->ip = f.ip;
+            fp->slots = base + f.slots;
+            fp->name = f.name;
+        }
+        coro_runs.push_back({co, base_frame, base, iter_count, try_count, false});
+        coro_base_frame = base_frame;
+        for (const auto& it : co->iters) iterators[iter_count++] = it;
+        for (const auto& h : co->handlers) {
+            try_handlers[try_count++] = {h.catch_ip, h.saved_ip, base + h.sp, frames.get() + base_frame + h.frame};
+        }
+        co->stack.clear();
+        co->frames.clear();
+        co->iters.clear();
+        co->handlers.clear();
+        co->state = ObjCoroutine::State::RUNNING;
+    }
+
+    void wake_coroutine(ObjCoroutine* co) {
+        if (co->queued || co->state != ObjCoroutine::State::SUSPENDED) return;
+        co->queued = true;
+        coro_ready.push_back(co);
+    }
+
+    void wait_on_task(ObjCoroutine* co, long id) {
+        coro_task_waiters[id].push_back(co);
+        async_bindings::watch_task(id);
+    }
+
+    void clear_await_deadline(ObjCoroutine* co) {
+        if (co->deadline_timer) {
+            coro_task_waiters.erase(co->deadline_timer);
+            auto timer = async_bindings::find_task(co->deadline_timer);
+            if (timer) async_bindings::cancel_task(timer);
+            co->deadline_timer = 0;
+        }
+        co->has_deadline = false;
+    }
+
+    // Move coroutines whose awaited task finished to the ready queue
+    void collect_task_wakeups() {
+        async_bindings::take_finished(coro_finished_ids);
+        for (long id : coro_finished_ids) {
+            auto it = coro_task_waiters.find(id);
+            if (it == coro_task_waiters.end()) continue;
+            for (ObjCoroutine* co : it->second) wake_coroutine(co);
+            coro_task_waiters.erase(it);
+        }
+        coro_finished_ids.clear();
+    }
+
+    // One scheduling step outside any coroutine: resume the next ready
+    // coroutine (true; the caller reloads ip/slots/chunk from fp), or wait up
+    // to wait_ms on the async reactor for tasks that wake one
+    bool run_coroutines(uint8_t* resume_ip, int wait_ms) {
+        // Keep polling I/O while coroutines wake each other
+        if (coro_ready.empty() || (++coro_resumes & 63) == 0) {
+            async_bindings::tick_tasks(256, coro_ready.empty() ? wait_ms : 0);
+            collect_task_wakeups();
+        }
+        while (!coro_ready.empty()) {
+            ObjCoroutine* co = coro_ready.front();
+            coro_ready.pop_front();
+            co->queued = false;
+            if (co->state != ObjCoroutine::State::SUSPENDED) continue;
+            resume_coroutine(co, resume_ip);
+            return true;
+        }
+        return false;
+    }
+
+    bool coroutines_pending() const {
+        if (!coro_ready.empty()) return true;
+        for (const auto& w : coro_task_waiters) {
+            for (ObjCoroutine* co : w.second) {
+                if (co->state == ObjCoroutine::State::SUSPENDED) return true;
+            }
+        }
+        return false;
+    }
+
+    // await(x): coroutines and async task ids complete later; any other
+    // value is already the result
+    bool await_ready(uint64_t target, uint64_t& out) {
+        if (is_coroutine(target)) {
+            ObjCoroutine* co = as_coroutine(target);
+            if (co->state != ObjCoroutine::State::DONE) return false;
+            out = co->result;
+            return true;
+        }
+        if (is_int(target) && !is_bool(target)) {
+            auto task = async_bindings::find_task(as_int(target));
+            if (!task) runtime_error("async.await: task not found");
+            if (!task->done) return false;
+            if (!task->ok && !task->error.empty()) runtime_error("async.await: " + task->error);
+            out = async_bindings::attach_body(*task, from_value(task->result));
+            return true;
+        }
+        out = target;
+        return true;
+    }
+
+    static constexpr uint32_t HOT_CALL_THRESHOLD = 3;  // Compile on the third call
+    static constexpr uint32_t JIT_MAX_DEPTH = 2048;    // Nested native activations (C stack bound)
+    uint32_t jit_depth = 0;
+
+    // ===== Profiler hooks (see namespace profiler) =====
+
+    // Runs in the SIGPROF handler: reads the frame stack and nothing else
+    static size_t profile_walk(void* owner, const char** names, size_t max, bool* jit) {
+        FastVM* vm = static_cast<FastVM*>(owner);
+        size_t n = vm->frame_count;
+        if (n == 0 || n > FRAMES_MAX) return 0;
+        size_t first = n > max ? n - max : 0;
+        for (size_t i = first; i < n; ++i) {
+            const char* name = vm->frames[i].name;
+            names[i - first] = name ? name : "<anon>";
+        }
+        Chunk* leaf = vm->frames[n - 1].chunk;
+        *jit = vm->jit_depth > 0 && leaf && leaf->jit_entry;
+        return n - first;
+    }
+
+    static void profile_caches(void* owner, profiler::CacheReport& out) {
+        FastVM* vm = static_cast<FastVM*>(owner);
+        auto shape_counts = [](profiler::CacheStats& c, uint8_t count) {
+            c.sites++;
+            if (count == 1) c.monomorphic++;
+            else if (count > 1 && count < PIC_WAYS) c.polymorphic++;
+            else if (count == PIC_WAYS) c.megamorphic++;
+        };
+        for (size_t i = 0; i < MAX_INLINE_CACHES; ++i) {
+            const PropertyCache& pc = vm->property_caches[i];
+            out.property.hits += pc.hits;
+            out.property.misses += pc.misses;
+            if (pc.site) shape_counts(out.property, pc.count);
+
+            const MethodCache& mc = vm->method_caches[i];
+            out.method.hits += mc.hits;
+            out.method.misses += mc.misses;
+            if (mc.site && mc.epoch == vm->class_epoch) shape_counts(out.method, mc.count);
+
+            const NativeCallCache& nc = vm->native_caches[i];
+            out.module_call.hits += nc.hits;
+            out.module_call.misses += nc.misses;
+            if (nc.site && nc.target) shape_counts(out.module_call, 1);
+        }
+    }
+
+    static const JitRuntime& jit_runtime() {
+        static const JitRuntime rt = {
+            &FastVM::jit_call, &FastVM::jit_deopt, &FastVM::jit_safepoint,
+            &FastVM::jit_get_global, &FastVM::jit_set_global, &FastVM::jit_append_global,
+            &FastVM::jit_iter_init, &FastVM::jit_iter_next, &FastVM::jit_iter_pop,
+        };
+        return rt;
+    }
+
+    // Run func as native code if it is (or just became) compiled. call_sp is
+    // the stack top with the callee and argc arguments on it. Returns the
+    // result, JIT_DEOPT if the interpreter must resume fp, or JIT_UNHANDLED
+    // if nothing ran.
+    uint64_t jit_enter(ObjFunc* func, uint64_t* call_sp, uint32_t argc, uint8_t* resume_ip) {
+        Chunk* target = func->chunk;
+        // Chunks and the code buffer are shared; only the main thread compiles
+        if (g_heap.isolate || target->jit_disabled) return JIT_UNHANDLED;
+        if (!target->jit_entry) {
+            if (++target->jit_calls < HOT_CALL_THRESHOLD) return JIT_UNHANDLED;
+            target->jit_entry = baseline_jit().compile(target, jit_runtime());
+            profiler::note_jit_compile(target->jit_entry != nullptr);
+            if (!target->jit_entry) {
+                target->jit_disabled = true;
+                return JIT_UNHANDLED;
+            }
+        }
+        if (frame_count >= FRAMES_MAX - 1 || jit_depth >= JIT_MAX_DEPTH) return JIT_UNHANDLED;
+
+        fp->ip = resume_ip;
+        fp++;
+        frame_count++;
+        fp->chunk = target;
+        fp->ip = target->code.data();
+        fp->slots = call_sp - argc - 1;
+        fp->name = func->name ? func->name->chars : "<anon>";
+
+        jit_depth++;
+        uint64_t result = target->jit_entry(this, fp->slots, call_sp);
+        jit_depth--;
+        if (result == JIT_DEOPT) return result;  // fp now belongs to the interpreter
+        fp--;
+        frame_count--;
+        return result;
+    }
+
+    // OP_CALL from native code
+    static uint64_t jit_call(FastVM* vm, uint64_t* call_sp, uint32_t argc, uint8_t* resume_ip) {
+        if (g_heap.should_collect()) jit_safepoint(vm, call_sp);
+        uint64_t callee = call_sp[-1 - (ptrdiff_t)argc];
+        if (is_native(callee)) {
+            vm->sp = call_sp;
+            return vm->call_native(as_native(callee), call_sp - argc, (uint8_t)argc);
+        }
+        if (!is_obj(callee) || obj_type(callee) != ObjType::FUNCTION) return JIT_UNHANDLED;
+
+        ObjFunc* func = as_func(callee);
+        uint64_t result = vm->jit_enter(func, call_sp, argc, resume_ip);
+        if (result != JIT_UNHANDLED) return result;
+        if (vm->frame_count >= FRAMES_MAX - 1) return JIT_UNHANDLED;  // Interpreter reports it
+
+        // Interpreted callee: push its frame and unwind to the interpreter
+        // without counting a deopt against the caller
+        vm->fp->ip = resume_ip;
+        vm->fp++;
+        vm->frame_count++;
+        vm->fp->chunk = func->chunk;
+        vm->fp->ip = func->chunk->code.data();
+        vm->fp->slots = call_sp - argc - 1;
+        vm->fp->name = func->name ? func->name->chars : "<anon>";
+        if (func->chunk->is_async) vm->begin_coroutine(func);
+        vm->sp = call_sp;
+        return JIT_DEOPT;
+    }
+
+    static void jit_deopt(FastVM* vm, uint8_t* resume_ip, uint64_t* deopt_sp) {
+        vm->fp->ip = resume_ip;
+        vm->sp = deopt_sp;
+        Chunk* c = vm->fp->chunk;
+        if (++c->jit_deopts >= DEOPT_THRESHOLD) c->jit_disabled = true;
+        profiler::note_jit_deopt(c->jit_deopts == DEOPT_THRESHOLD);
+    }
+
+    static void jit_safepoint(FastVM* vm, uint64_t* cur_sp) {
+        vm->sp = cur_sp;
+        gc_collect();
+    }
+
+    // VAL_UNDEFINED doubles as JIT_DEOPT: the interpreter raises the error
+    static uint64_t jit_get_global(FastVM* vm, uint32_t slot) {
+        return slot < vm->globals.size() ? seal_string(vm->globals[slot]) : VAL_UNDEFINED;
+    }
+
+    static uint64_t jit_append_global(FastVM* vm, uint32_t slot, uint64_t rhs) {
+        if (slot >= vm->globals.size() || vm->globals[slot] == VAL_UNDEFINED) return VAL_UNDEFINED;
+        append_in_place(vm->globals[slot], rhs);
+        return VAL_NONE;
+    }
+
+    static void jit_set_global(FastVM* vm, uint32_t slot, uint64_t value) {
+        vm->global_ref((uint16_t)slot) = value;
+    }
+
+    static void jit_iter_init(FastVM* vm, uint64_t obj) {
+        FastIter& it = vm->iterators[vm->iter_count++];
+        it.obj = obj;
+        it.idx = 0;
+        it.cur = 0;
+        it.stop = 0;
+        it.step = 1;
+        if (is_obj(obj) && obj_type(obj) == ObjType::RANGE) {
+            ObjRange* r = as_range(obj);
+            it.cur = r->start;
+            it.stop = r->stop;
+            it.step = r->step;
+        }
+    }
+
+    static void jit_iter_pop(FastVM* vm, uint32_t count) { vm->pop_iterators(count); }
+
+    // Stores the next element at *top and returns 1, or pops the iterator and returns 0
+    static uint64_t jit_iter_next(FastVM* vm, uint64_t* top) {
+        FastIter& it = vm->iterators[vm->iter_count - 1];
+        if ((it.step > 0 && it.cur < it.stop) || (it.step < 0 && it.cur > it.stop)) {
+            *top = val_int(it.cur);
+            it.cur += it.step;
+            return 1;
+        }
+        if (is_obj(it.obj) && obj_type(it.obj) == ObjType::LIST) {
+            ObjList* l = as_list(it.obj);
+            if (it.idx < l->count) {
+                *top = l->get(it.idx++);
+                return 1;
+            }
+        } else if (is_bytes(it.obj)) {
+            ObjBytes* b = as_bytes(it.obj);
+            if (it.idx < b->length) {
+                *top = val_int(b->data[it.idx++]);
+                return 1;
+            }
+        } else if (is_reader(it.obj)) {
+            *top = vm->reader_next_line(as_reader(it.obj));
+            if (*top != VAL_NONE) return 1;
+        }
+        vm->iter_count--;
+        return 0;
+    }
+
+    uint64_t call_native(ObjNative* native, const uint64_t* args, uint8_t argc) {
+        try {
+            if (native->fn) return native->fn(native_ctx, args, argc);
+            std::vector<Value> args_vec;
+            args_vec.reserve(argc);
+            for (uint8_t i = 0; i < argc; ++i) args_vec.push_back(to_value(args[i]));
+            return from_value(native->legacy(args_vec));
+        } catch (const IsolateError&) {
+            throw;  // Already carries its stack
+        } catch (const std::exception& e) {
+            runtime_error(e.what());
+        }
+        return VAL_NONE;
+    }
+
     ObjMap* ensure_http_module() {
         if (http_module_map) return http_module_map;
 
         http_module_map = ObjMap::create();
-        auto add_method = [&](const char* name) {
-            http_module_map->data[g_strings.intern(name)] = val_string(name);
-        };
-
-        add_method("get");
-        add_method("post");
-        add_method("put");
-        add_method("patch");
-        add_method("delete");
-        add_method("head");
-        add_method("request");
-        add_method("set_timeout");
-        add_method("set_verify_ssl");
+        register_natives(http_module_map, module_registry::http_builtins);
+        register_natives(http_module_map, http_bindings::natives);
+        register_natives(http_module_map, http_server::natives);
         return http_module_map;
     }
 
@@ -22147,150 +30526,14 @@ public:
         if (os_module_map) return os_module_map;
 
         os_module_map = ObjMap::create();
-        auto add_method = [&](const char* name) {
-            os_module_map->data[g_strings.intern(name)] = val_string(name);
-        };
-
-        add_method("name");
-        add_method("sep");
-        add_method("cwd");
-        add_method("chdir");
-        add_method("listdir");
-        add_method("exists");
-        add_method("is_file");
-        add_method("is_dir");
-        add_method("mkdir");
-        add_method("remove");
-        add_method("rmdir");
-        add_method("rename");
-        add_method("abspath");
-        add_method("getenv");
-        add_method("setenv");
-        add_method("unsetenv");
-        add_method("shutdown");
-        add_method("restart");
-        add_method("logout");
-        add_method("lock");
-        add_method("sleep");
-        add_method("hibernate");
-        add_method("hostname");
-        add_method("set_hostname");
-        add_method("uptime");
-        add_method("cpu_count");
-        add_method("mem_total");
-        add_method("mem_free");
-        add_method("platform");
-        add_method("chmod");
-        add_method("chown");
-        add_method("stat");
-        add_method("realpath");
-        add_method("realpath_ex");
-        add_method("symlink");
-        add_method("readlink");
-        add_method("readlink_info");
-        add_method("copy");
-        add_method("move");
-        add_method("getpid");
-        add_method("exec");
-        add_method("spawn");
-        add_method("kill");
-        add_method("user");
-        add_method("uid");
-        add_method("gid");
-        add_method("is_admin");
-        add_method("elevate");
-        add_method("sleep_ms");
-        add_method("env");
-        add_method("path_sep");
-        add_method("expanduser");
-        add_method("expandvars");
-        add_method("path_expand");
-        add_method("homedir");
-        add_method("username");
-        add_method("groups");
-        add_method("ppid");
-        add_method("argv");
-        add_method("exit");
-        add_method("which");
-        add_method("tempdir");
-        add_method("getenvs");
-        add_method("env_list");
-        add_method("env_update");
-        add_method("getenv_int");
-        add_method("getenv_float");
-        add_method("getenv_bool");
-        add_method("env_snapshot");
-        add_method("env_diff");
-        add_method("access");
-        add_method("umask");
-        add_method("walk");
-        add_method("glob");
-        add_method("disk_usage");
-        add_method("statvfs");
-        add_method("touch");
-        add_method("rmdir_rf");
-        add_method("mkdir_p");
-        add_method("ps");
-        add_method("run");
-        add_method("waitpid");
-        add_method("kill_tree");
-        add_method("run_capture");
-        add_method("popen");
-        add_method("spawn_io");
-        add_method("scandir");
-        add_method("link");
-        add_method("renameat");
-        add_method("lstat");
-        add_method("fstat");
-        add_method("open");
-        add_method("read");
-        add_method("write");
-        add_method("fsync");
-        add_method("close");
-        add_method("fdopen");
-        add_method("chdir_push");
-        add_method("chdir_pop");
-        add_method("signal");
-        add_method("alarm");
-        add_method("pause");
-        add_method("killpg");
-        add_method("setuid");
-        add_method("setgid");
-        add_method("getpgid");
-        add_method("setpgid");
-        add_method("setsid");
-        add_method("nice");
-        add_method("getpriority");
-        add_method("setpriority");
-        add_method("uid_name");
-        add_method("gid_name");
-        add_method("getpwnam");
-        add_method("getgrnam");
-        add_method("getlogin");
-        add_method("getgroups");
-        add_method("chflags");
-        add_method("loadavg");
-        add_method("cpu_info");
-        add_method("os_release");
-        add_method("boot_time");
-        add_method("locale");
-        add_method("timezone");
-        add_method("mounts");
-        add_method("service_control");
-        add_method("service_query");
-        add_method("battery_info");
-        add_method("cgroups");
-        add_method("namespaces");
+        register_natives(os_module_map, module_registry::os_builtins);
+        register_natives(os_module_map, os_bindings::natives);
 
+#ifndef LEVYTHON_NO_HOOKS
         // ======== OS.Hooks submodule ========
         os_hooks_module_map = ObjMap::create();
         {
-            auto add_sub = [&](const char* n) { os_hooks_module_map->data[g_strings.intern(n)] = val_string(n); };
-            add_sub("register"); add_sub("unregister"); add_sub("list");
-            add_sub("enable"); add_sub("disable"); add_sub("set_callback");
-            add_sub("hook_process_create"); add_sub("hook_process_exit"); add_sub("hook_file_access");
-            add_sub("hook_network_connect"); add_sub("hook_keyboard"); add_sub("hook_mouse");
-            add_sub("hook_syscall"); add_sub("inject_library"); add_sub("hook_memory_access");
+            register_natives(os_hooks_module_map, module_registry::os_hooks_builtins);
             // Hook type constants
             os_hooks_module_map->data[g_strings.intern("PROCESS_CREATE")] = val_string(g_strings.intern("hook_process_create"));
             os_hooks_module_map->data[g_strings.intern("PROCESS_EXIT")] = val_string(g_strings.intern("hook_process_exit"));
@@ -22303,22 +30546,12 @@ public:
             os_hooks_module_map->data[g_strings.intern("DLL_INJECTION")] = val_string(g_strings.intern("dll_injection"));
         }
         os_module_map->data[g_strings.intern("Hooks")] = val_map(os_hooks_module_map);
+#endif
 
         // ======== OS.InputControl submodule ========
         os_inputcontrol_module_map = ObjMap::create();
         {
-            auto add_sub = [&](const char* n) { os_inputcontrol_module_map->data[g_strings.intern(n)] = val_string(n); };
-            add_sub("capture_keyboard"); add_sub("release_keyboard");
-            add_sub("press_key"); add_sub("release_key"); add_sub("tap_key");
-            add_sub("type_text"); add_sub("type_text_raw");
-            add_sub("block_key"); add_sub("unblock_key");
-            add_sub("remap_key"); add_sub("get_keyboard_state");
-            add_sub("capture_mouse"); add_sub("release_mouse"); add_sub("move_mouse");
-            add_sub("press_mouse_button"); add_sub("release_mouse_button"); add_sub("click_mouse_button");
-            add_sub("scroll_mouse"); add_sub("block_mouse_button"); add_sub("unblock_mouse_button");
-            add_sub("get_mouse_position"); add_sub("set_mouse_position");
-            add_sub("capture_touch"); add_sub("release_touch"); add_sub("send_touch_event");
-            add_sub("clear_input_buffer"); add_sub("is_capturing");
+            register_natives(os_inputcontrol_module_map, module_registry::os_inputcontrol_builtins);
             // Button constants
             os_inputcontrol_module_map->data[g_strings.intern("MOUSE_LEFT")] = val_int(0);
             os_inputcontrol_module_map->data[g_strings.intern("MOUSE_RIGHT")] = val_int(1);
@@ -22329,11 +30562,7 @@ public:
         // ======== OS.Processes submodule ========
         os_processes_module_map = ObjMap::create();
         {
-            auto add_sub = [&](const char* n) { os_processes_module_map->data[g_strings.intern(n)] = val_string(n); };
-            add_sub("list"); add_sub("get_info"); add_sub("create");
-            add_sub("terminate"); add_sub("wait"); add_sub("suspend"); add_sub("resume");
-            add_sub("read_memory"); add_sub("write_memory"); add_sub("inject_library");
-            add_sub("list_threads"); add_sub("get_priority"); add_sub("set_priority");
+            register_natives(os_processes_module_map, module_registry::os_processes_builtins);
             // Priority constants
             os_processes_module_map->data[g_strings.intern("PRIORITY_HIGHEST")] = val_int(-20);
             os_processes_module_map->data[g_strings.intern("PRIORITY_HIGH")] = val_int(-10);
@@ -22343,68 +30572,42 @@ public:
         }
         os_module_map->data[g_strings.intern("Processes")] = val_map(os_processes_module_map);
 
+#ifndef LEVYTHON_NO_DISPLAY
         // ======== OS.Display submodule ========
         os_display_module_map = ObjMap::create();
         {
-            auto add_sub = [&](const char* n) { os_display_module_map->data[g_strings.intern(n)] = val_string(n); };
-            add_sub("list"); add_sub("get_primary");
-            add_sub("capture_screen"); add_sub("capture_region"); add_sub("capture_window");
-            add_sub("get_pixel"); add_sub("create_overlay"); add_sub("destroy_overlay");
-            add_sub("update"); add_sub("draw_pixel"); add_sub("draw_line");
-            add_sub("draw_rectangle"); add_sub("draw_circle"); add_sub("draw_text");
-            add_sub("set_mode"); add_sub("get_modes"); add_sub("get_buffer");
-            add_sub("write_buffer"); add_sub("show_cursor"); add_sub("hide_cursor");
+            register_natives(os_display_module_map, module_registry::os_display_builtins);
         }
         os_module_map->data[g_strings.intern("Display")] = val_map(os_display_module_map);
+#endif
 
+#ifndef LEVYTHON_NO_AUDIO
         // ======== OS.Audio submodule ========
         os_audio_module_map = ObjMap::create();
         {
-            auto add_sub = [&](const char* n) { os_audio_module_map->data[g_strings.intern(n)] = val_string(n); };
-            add_sub("list_devices"); add_sub("get_default_device"); add_sub("set_default_device");
-            add_sub("get_device_info"); add_sub("get_volume"); add_sub("set_volume");
-            add_sub("is_muted"); add_sub("set_mute"); add_sub("play_sound");
-            add_sub("play_tone"); add_sub("stop"); add_sub("create_stream");
-            add_sub("write_stream"); add_sub("close_stream"); add_sub("get_sample_rate");
-            add_sub("set_sample_rate"); add_sub("record"); add_sub("stop_recording");
-            add_sub("mix_streams"); add_sub("apply_effect");
+            register_natives(os_audio_module_map, module_registry::os_audio_builtins);
         }
         os_module_map->data[g_strings.intern("Audio")] = val_map(os_audio_module_map);
+#endif
 
         // ======== OS.Privileges submodule ========
         os_privileges_module_map = ObjMap::create();
         {
-            auto add_sub = [&](const char* n) { os_privileges_module_map->data[g_strings.intern(n)] = val_string(n); };
-            add_sub("is_elevated"); add_sub("is_admin"); add_sub("is_root");
-            add_sub("get_level"); add_sub("can_elevate");
-            add_sub("request_elevation"); add_sub("elevate_and_restart");
-            add_sub("get_user_info"); add_sub("impersonate_user");
-            add_sub("check"); add_sub("enable"); add_sub("drop");
-            add_sub("run_as_admin"); add_sub("get_token_info");
+            register_natives(os_privileges_module_map, module_registry::os_privileges_builtins);
         }
         os_module_map->data[g_strings.intern("Privileges")] = val_map(os_privileges_module_map);
 
         // ======== OS.Events submodule ========
         os_events_module_map = ObjMap::create();
         {
-            auto add_sub = [&](const char* n) { os_events_module_map->data[g_strings.intern(n)] = val_string(n); };
-            add_sub("watch_file"); add_sub("watch_network");
-            add_sub("watch_power"); add_sub("unwatch");
-            add_sub("list"); add_sub("poll");
-            add_sub("dispatch"); add_sub("get_recent");
-            add_sub("start_loop"); add_sub("stop_loop");
-            add_sub("set_callback"); add_sub("remove_callback");
+            register_natives(os_events_module_map, module_registry::os_events_builtins);
         }
         os_module_map->data[g_strings.intern("Events")] = val_map(os_events_module_map);
 
         // ======== OS.Persistence submodule ========
         os_persistence_module_map = ObjMap::create();
         {
-            auto add_sub = [&](const char* n) { os_persistence_module_map->data[g_strings.intern(n)] = val_string(n); };
-            add_sub("add_autostart"); add_sub("remove_autostart"); add_sub("list_autostart");
-            add_sub("install_service"); add_sub("uninstall_service");
-            add_sub("start_service"); add_sub("stop_service"); add_sub("restart_service");
-            add_sub("get_service_status"); add_sub("add_scheduled_task"); add_sub("remove_scheduled_task");
+            register_natives(os_persistence_module_map, module_registry::os_persistence_builtins);
         }
         os_module_map->data[g_strings.intern("Persistence")] = val_map(os_persistence_module_map);
 
@@ -22414,628 +30617,124 @@ public:
     ObjMap* ensure_fs_module() {
         if (fs_module_map) return fs_module_map;
         fs_module_map = ObjMap::create();
-        const char* names[] = {"exists","is_file","is_dir","mkdir","remove","rmdir","listdir","read_text","write_text","append_text","copy","move","abspath"};
-        for (const char* n : names) fs_module_map->data[g_strings.intern(n)] = val_string(n);
+        register_natives(fs_module_map, module_registry::fs_builtins);
+        register_natives(fs_module_map, fs_bindings::natives);
         return fs_module_map;
     }
 
     ObjMap* ensure_path_module() {
         if (path_module_map) return path_module_map;
         path_module_map = ObjMap::create();
-        const char* names[] = {"join","basename","dirname","ext","stem","norm","abspath","exists","is_file","is_dir","read_text","write_text","listdir","mkdir","remove","rmdir"};
-        for (const char* n : names) path_module_map->data[g_strings.intern(n)] = val_string(n);
+        register_natives(path_module_map, module_registry::path_builtins);
+        register_natives(path_module_map, path_bindings::natives);
         return path_module_map;
     }
 
     ObjMap* ensure_process_module() {
         if (process_module_map) return process_module_map;
         process_module_map = ObjMap::create();
-        const char* names[] = {"getpid","run","cwd","chdir","getenv","setenv","unsetenv"};
-        for (const char* n : names) process_module_map->data[g_strings.intern(n)] = val_string(n);
+        register_natives(process_module_map, module_registry::process_builtins);
+        register_natives(process_module_map, process_bindings::natives);
         return process_module_map;
     }
 
     ObjMap* ensure_json_module() {
         if (json_module_map) return json_module_map;
         json_module_map = ObjMap::create();
-        const char* names[] = {"parse","stringify"};
-        for (const char* n : names) json_module_map->data[g_strings.intern(n)] = val_string(n);
+        register_natives(json_module_map, module_registry::json_builtins);
+        register_natives(json_module_map, json_bindings::natives);
         return json_module_map;
     }
 
     ObjMap* ensure_url_module() {
         if (url_module_map) return url_module_map;
         url_module_map = ObjMap::create();
-        const char* names[] = {"parse","encode","decode"};
-        for (const char* n : names) url_module_map->data[g_strings.intern(n)] = val_string(n);
+        register_natives(url_module_map, module_registry::url_builtins);
+        register_natives(url_module_map, url_bindings::natives);
         return url_module_map;
     }
 
     ObjMap* ensure_net_module() {
         if (net_module_map) return net_module_map;
         net_module_map = ObjMap::create();
-        const char* names[] = {"tcp_connect","tcp_listen","tcp_accept","tcp_try_accept","set_nonblocking","tcp_send","tcp_try_send","tcp_recv","tcp_try_recv","tcp_close","udp_bind","udp_sendto","udp_recvfrom","udp_close","dns_lookup"};
-        for (const char* n : names) net_module_map->data[g_strings.intern(n)] = val_string(n);
+        register_natives(net_module_map, module_registry::net_builtins);
+        register_natives(net_module_map, net_bindings::natives);
         return net_module_map;
     }
 
     ObjMap* ensure_thread_module() {
         if (thread_module_map) return thread_module_map;
         thread_module_map = ObjMap::create();
-        const char* names[] = {"spawn","join","is_done","sleep"};
-        for (const char* n : names) thread_module_map->data[g_strings.intern(n)] = val_string(n);
+        register_natives(thread_module_map, module_registry::thread_builtins);
+        register_natives(thread_module_map, thread_bindings::natives);
         return thread_module_map;
     }
 
     ObjMap* ensure_channel_module() {
         if (channel_module_map) return channel_module_map;
         channel_module_map = ObjMap::create();
-        const char* names[] = {"create","send","recv","try_recv","close"};
-        for (const char* n : names) channel_module_map->data[g_strings.intern(n)] = val_string(n);
+        register_natives(channel_module_map, module_registry::channel_builtins);
+        register_natives(channel_module_map, channel_bindings::natives);
         return channel_module_map;
     }
 
     ObjMap* ensure_async_module() {
         if (async_module_map) return async_module_map;
         async_module_map = ObjMap::create();
-        const char* names[] = {"spawn","sleep","tcp_recv","tcp_send","tick","done","status","result","cancel","pending","await"};
-        for (const char* n : names) async_module_map->data[g_strings.intern(n)] = val_string(n);
+        register_natives(async_module_map, module_registry::async_builtins);
+        register_natives(async_module_map, async_bindings::natives);
         return async_module_map;
     }
 
     ObjMap* ensure_crypto_module() {
         if (crypto_module_map) return crypto_module_map;
         crypto_module_map = ObjMap::create();
-        const char* names[] = {"sha256","sha512","hmac_sha256","random_bytes","hex_encode","hex_decode","base64_encode","base64_decode"};
-        for (const char* n : names) crypto_module_map->data[g_strings.intern(n)] = val_string(n);
+        register_natives(crypto_module_map, module_registry::crypto_builtins);
+        register_natives(crypto_module_map, crypto_bindings::natives);
         return crypto_module_map;
     }
 
     ObjMap* ensure_time_module() {
         if (time_module_map) return time_module_map;
         time_module_map = ObjMap::create();
-        const char* names[] = {"now_utc","now_local","format","parse","sleep_ms","epoch_ms"};
-        for (const char* n : names) time_module_map->data[g_strings.intern(n)] = val_string(n);
+        register_natives(time_module_map, module_registry::time_builtins);
+        register_natives(time_module_map, time_bindings::natives);
         return time_module_map;
     }
 
     ObjMap* ensure_log_module() {
         if (log_module_map) return log_module_map;
         log_module_map = ObjMap::create();
-        const char* names[] = {"set_level","set_output","set_json","log","debug","info","warn","error","flush"};
-        for (const char* n : names) log_module_map->data[g_strings.intern(n)] = val_string(n);
+        register_natives(log_module_map, module_registry::log_builtins);
+        register_natives(log_module_map, log_bindings::natives);
         return log_module_map;
     }
 
     ObjMap* ensure_config_module() {
         if (config_module_map) return config_module_map;
         config_module_map = ObjMap::create();
-        const char* names[] = {"load_env","get","set","get_int","get_float","get_bool","has"};
-        for (const char* n : names) config_module_map->data[g_strings.intern(n)] = val_string(n);
+        register_natives(config_module_map, module_registry::config_builtins);
+        register_natives(config_module_map, config_bindings::natives);
         return config_module_map;
     }
 
+    ObjMap* ensure_gc_module() {
+        if (gc_module_map) return gc_module_map;
+        gc_module_map = ObjMap::create();
+        register_natives(gc_module_map, gc_bindings::natives);
+        return gc_module_map;
+    }
+
     ObjMap* ensure_input_module() {
         if (input_module_map) return input_module_map;
         input_module_map = ObjMap::create();
-        const char* names[] = {"enable_raw","disable_raw","key_available","poll","read_key"};
-        for (const char* n : names) input_module_map->data[g_strings.intern(n)] = val_string(n);
+        register_natives(input_module_map, module_registry::input_builtins);
         return input_module_map;
     }
 
-    Value call_http_builtin(const std::string& method_name,
-                            const std::vector<Value>& args) {
-        if (method_name == "get") return http_bindings::builtin_http_get(args);
-        if (method_name == "post") return http_bindings::builtin_http_post(args);
-        if (method_name == "put") return http_bindings::builtin_http_put(args);
-        if (method_name == "patch") return http_bindings::builtin_http_patch(args);
-        if (method_name == "delete") return http_bindings::builtin_http_delete(args);
-        if (method_name == "head") return http_bindings::builtin_http_head(args);
-        if (method_name == "request") return http_bindings::builtin_http_request(args);
-        if (method_name == "set_timeout")
-            return http_bindings::builtin_http_set_timeout(args);
-        if (method_name == "set_verify_ssl")
-            return http_bindings::builtin_http_set_verify_ssl(args);
-        throw std::runtime_error("Unknown http method: " + method_name);
-    }
-
-    Value call_os_builtin(const std::string& method_name,
-                          const std::vector<Value>& args) {
-        if (method_name == "name") return os_bindings::builtin_os_name(args);
-        if (method_name == "sep") return os_bindings::builtin_os_sep(args);
-        if (method_name == "cwd") return os_bindings::builtin_os_cwd(args);
-        if (method_name == "chdir") return os_bindings::builtin_os_chdir(args);
-        if (method_name == "listdir") return os_bindings::builtin_os_listdir(args);
-        if (method_name == "exists") return os_bindings::builtin_os_exists(args);
-        if (method_name == "is_file") return os_bindings::builtin_os_is_file(args);
-        if (method_name == "is_dir") return os_bindings::builtin_os_is_dir(args);
-        if (method_name == "mkdir") return os_bindings::builtin_os_mkdir(args);
-        if (method_name == "remove") return os_bindings::builtin_os_remove(args);
-        if (method_name == "rmdir") return os_bindings::builtin_os_rmdir(args);
-        if (method_name == "rename") return os_bindings::builtin_os_rename(args);
-        if (method_name == "abspath") return os_bindings::builtin_os_abspath(args);
-        if (method_name == "getenv") return os_bindings::builtin_os_getenv(args);
-        if (method_name == "setenv") return os_bindings::builtin_os_setenv(args);
-        if (method_name == "unsetenv") return os_bindings::builtin_os_unsetenv(args);
-        if (method_name == "shutdown") return os_bindings::builtin_os_shutdown(args);
-        if (method_name == "restart") return os_bindings::builtin_os_restart(args);
-        if (method_name == "logout") return os_bindings::builtin_os_logout(args);
-        if (method_name == "lock") return os_bindings::builtin_os_lock(args);
-        if (method_name == "sleep") return os_bindings::builtin_os_sleep(args);
-        if (method_name == "hibernate") return os_bindings::builtin_os_hibernate(args);
-        if (method_name == "hostname") return os_bindings::builtin_os_hostname(args);
-        if (method_name == "set_hostname") return os_bindings::builtin_os_set_hostname(args);
-        if (method_name == "uptime") return os_bindings::builtin_os_uptime(args);
-        if (method_name == "cpu_count") return os_bindings::builtin_os_cpu_count(args);
-        if (method_name == "mem_total") return os_bindings::builtin_os_mem_total(args);
-        if (method_name == "mem_free") return os_bindings::builtin_os_mem_free(args);
-        if (method_name == "platform") return os_bindings::builtin_os_platform(args);
-        if (method_name == "chmod") return os_bindings::builtin_os_chmod(args);
-        if (method_name == "chown") return os_bindings::builtin_os_chown(args);
-        if (method_name == "stat") return os_bindings::builtin_os_stat(args);
-        if (method_name == "realpath") return os_bindings::builtin_os_realpath(args);
-        if (method_name == "symlink") return os_bindings::builtin_os_symlink(args);
-        if (method_name == "readlink") return os_bindings::builtin_os_readlink(args);
-        if (method_name == "copy") return os_bindings::builtin_os_copy(args);
-        if (method_name == "move") return os_bindings::builtin_os_move(args);
-        if (method_name == "getpid") return os_bindings::builtin_os_getpid(args);
-        if (method_name == "exec") return os_bindings::builtin_os_exec(args);
-        if (method_name == "spawn") return os_bindings::builtin_os_spawn(args);
-        if (method_name == "kill") return os_bindings::builtin_os_kill(args);
-        if (method_name == "user") return os_bindings::builtin_os_user(args);
-        if (method_name == "uid") return os_bindings::builtin_os_uid(args);
-        if (method_name == "gid") return os_bindings::builtin_os_gid(args);
-        if (method_name == "is_admin") return os_bindings::builtin_os_is_admin(args);
-        if (method_name == "elevate") return os_bindings::builtin_os_elevate(args);
-        if (method_name == "sleep_ms") return os_bindings::builtin_os_sleep_ms(args);
-        if (method_name == "env") return os_bindings::builtin_os_env(args);
-        if (method_name == "path_sep") return os_bindings::builtin_os_path_sep(args);
-        if (method_name == "expanduser") return os_bindings::builtin_os_expanduser(args);
-        if (method_name == "expandvars") return os_bindings::builtin_os_expandvars(args);
-        if (method_name == "path_expand") return os_bindings::builtin_os_path_expand(args);
-        if (method_name == "homedir") return os_bindings::builtin_os_homedir(args);
-        if (method_name == "username") return os_bindings::builtin_os_username(args);
-        if (method_name == "groups") return os_bindings::builtin_os_groups(args);
-        if (method_name == "ppid") return os_bindings::builtin_os_ppid(args);
-        if (method_name == "argv") return os_bindings::builtin_os_argv(args);
-        if (method_name == "exit") return os_bindings::builtin_os_exit(args);
-        if (method_name == "which") return os_bindings::builtin_os_which(args);
-        if (method_name == "tempdir") return os_bindings::builtin_os_tempdir(args);
-        if (method_name == "getenvs") return os_bindings::builtin_os_getenvs(args);
-        if (method_name == "env_list") return os_bindings::builtin_os_env_list(args);
-        if (method_name == "access") return os_bindings::builtin_os_access(args);
-        if (method_name == "umask") return os_bindings::builtin_os_umask(args);
-        if (method_name == "env_update") return os_bindings::builtin_os_env_update(args);
-        if (method_name == "getenv_int") return os_bindings::builtin_os_getenv_int(args);
-        if (method_name == "getenv_float") return os_bindings::builtin_os_getenv_float(args);
-        if (method_name == "getenv_bool") return os_bindings::builtin_os_getenv_bool(args);
-        if (method_name == "env_snapshot") return os_bindings::builtin_os_env_snapshot(args);
-        if (method_name == "env_diff") return os_bindings::builtin_os_env_diff(args);
-        if (method_name == "walk") return os_bindings::builtin_os_walk(args);
-        if (method_name == "glob") return os_bindings::builtin_os_glob(args);
-        if (method_name == "disk_usage") return os_bindings::builtin_os_disk_usage(args);
-        if (method_name == "statvfs") return os_bindings::builtin_os_statvfs(args);
-        if (method_name == "touch") return os_bindings::builtin_os_touch(args);
-        if (method_name == "rmdir_rf") return os_bindings::builtin_os_rmdir_rf(args);
-        if (method_name == "mkdir_p") return os_bindings::builtin_os_mkdir_p(args);
-        if (method_name == "ps") return os_bindings::builtin_os_ps(args);
-        if (method_name == "run") return os_bindings::builtin_os_run(args);
-        if (method_name == "waitpid") return os_bindings::builtin_os_waitpid(args);
-        if (method_name == "kill_tree") return os_bindings::builtin_os_kill_tree(args);
-        if (method_name == "run_capture") return os_bindings::builtin_os_run_capture(args);
-        if (method_name == "popen") return os_bindings::builtin_os_popen(args);
-        if (method_name == "spawn_io") return os_bindings::builtin_os_spawn_io(args);
-        if (method_name == "scandir") return os_bindings::builtin_os_scandir(args);
-        if (method_name == "link") return os_bindings::builtin_os_link(args);
-        if (method_name == "renameat") return os_bindings::builtin_os_renameat(args);
-        if (method_name == "lstat") return os_bindings::builtin_os_lstat(args);
-        if (method_name == "fstat") return os_bindings::builtin_os_fstat(args);
-        if (method_name == "open") return os_bindings::builtin_os_open(args);
-        if (method_name == "read") return os_bindings::builtin_os_read(args);
-        if (method_name == "write") return os_bindings::builtin_os_write(args);
-        if (method_name == "fsync") return os_bindings::builtin_os_fsync(args);
-        if (method_name == "close") return os_bindings::builtin_os_close(args);
-        if (method_name == "fdopen") return os_bindings::builtin_os_fdopen(args);
-        if (method_name == "chdir_push") return os_bindings::builtin_os_chdir_push(args);
-        if (method_name == "chdir_pop") return os_bindings::builtin_os_chdir_pop(args);
-        if (method_name == "signal") return os_bindings::builtin_os_signal(args);
-        if (method_name == "alarm") return os_bindings::builtin_os_alarm(args);
-        if (method_name == "pause") return os_bindings::builtin_os_pause(args);
-        if (method_name == "killpg") return os_bindings::builtin_os_killpg(args);
-        if (method_name == "setuid") return os_bindings::builtin_os_setuid(args);
-        if (method_name == "setgid") return os_bindings::builtin_os_setgid(args);
-        if (method_name == "getpgid") return os_bindings::builtin_os_getpgid(args);
-        if (method_name == "setpgid") return os_bindings::builtin_os_setpgid(args);
-        if (method_name == "setsid") return os_bindings::builtin_os_setsid(args);
-        if (method_name == "nice") return os_bindings::builtin_os_nice(args);
-        if (method_name == "getpriority") return os_bindings::builtin_os_getpriority(args);
-        if (method_name == "setpriority") return os_bindings::builtin_os_setpriority(args);
-        if (method_name == "uid_name") return os_bindings::builtin_os_uid_name(args);
-        if (method_name == "gid_name") return os_bindings::builtin_os_gid_name(args);
-        if (method_name == "getpwnam") return os_bindings::builtin_os_getpwnam(args);
-        if (method_name == "getgrnam") return os_bindings::builtin_os_getgrnam(args);
-        if (method_name == "getlogin") return os_bindings::builtin_os_getlogin(args);
-        if (method_name == "getgroups") return os_bindings::builtin_os_getgroups(args);
-        if (method_name == "chflags") return os_bindings::builtin_os_chflags(args);
-        if (method_name == "loadavg") return os_bindings::builtin_os_loadavg(args);
-        if (method_name == "cpu_info") return os_bindings::builtin_os_cpu_info(args);
-        if (method_name == "os_release") return os_bindings::builtin_os_os_release(args);
-        if (method_name == "boot_time") return os_bindings::builtin_os_boot_time(args);
-        if (method_name == "locale") return os_bindings::builtin_os_locale(args);
-        if (method_name == "timezone") return os_bindings::builtin_os_timezone(args);
-        if (method_name == "mounts") return os_bindings::builtin_os_mounts(args);
-        if (method_name == "service_control") return os_bindings::builtin_os_service_control(args);
-        if (method_name == "service_query") return os_bindings::builtin_os_service_query(args);
-        if (method_name == "battery_info") return os_bindings::builtin_os_battery_info(args);
-        if (method_name == "cgroups") return os_bindings::builtin_os_cgroups(args);
-        if (method_name == "namespaces") return os_bindings::builtin_os_namespaces(args);
-        if (method_name == "readlink_info") return os_bindings::builtin_os_readlink_info(args);
-        if (method_name == "realpath_ex") return os_bindings::builtin_os_realpath_ex(args);
-        
-        // OS.Hook submodule functions
-        if (method_name == "hook_register") return os_bindings::builtin_os_hooks_register(args);
-        if (method_name == "hook_unregister") return os_bindings::builtin_os_hooks_unregister(args);
-        if (method_name == "hook_list") return os_bindings::builtin_os_hooks_list(args);
-        if (method_name == "hook_enable") return os_bindings::builtin_os_hooks_enable(args);
-        if (method_name == "hook_disable") return os_bindings::builtin_os_hooks_disable(args);
-        if (method_name == "hook_set_callback") return os_bindings::builtin_os_hooks_set_callback(args);
-        if (method_name == "hook_process_create") return os_bindings::builtin_os_hooks_hook_process_create(args);
-        if (method_name == "hook_process_exit") return os_bindings::builtin_os_hooks_hook_process_exit(args);
-        if (method_name == "hook_file_access") return os_bindings::builtin_os_hooks_hook_file_access(args);
-        if (method_name == "hook_network_connect") return os_bindings::builtin_os_hooks_hook_network_connect(args);
-        if (method_name == "hook_keyboard") return os_bindings::builtin_os_hooks_hook_keyboard(args);
-        if (method_name == "hook_mouse") return os_bindings::builtin_os_hooks_hook_mouse(args);
-        if (method_name == "hook_syscall") return os_bindings::builtin_os_hooks_hook_syscall(args);
-        if (method_name == "hook_inject_dll") return os_bindings::builtin_os_hooks_inject_library(args);
-        if (method_name == "hook_memory_access") return os_bindings::builtin_os_hooks_hook_memory_access(args);
-        
-        // OS.InputControl submodule functions
-        if (method_name == "inputcontrol_keyboard_capture") return os_bindings::builtin_os_inputcontrol_capture_keyboard(args);
-        if (method_name == "inputcontrol_keyboard_release") return os_bindings::builtin_os_inputcontrol_release_keyboard(args);
-        if (method_name == "inputcontrol_keyboard_send") return os_bindings::builtin_os_inputcontrol_keyboard_send(args);
-        if (method_name == "inputcontrol_keyboard_send_text") return os_bindings::builtin_os_inputcontrol_type_text_raw(args);
-        if (method_name == "inputcontrol_keyboard_block") return os_bindings::builtin_os_inputcontrol_block_key(args);
-        if (method_name == "inputcontrol_keyboard_unblock") return os_bindings::builtin_os_inputcontrol_unblock_key(args);
-        if (method_name == "inputcontrol_keyboard_remap") return os_bindings::builtin_os_inputcontrol_remap_key(args);
-        if (method_name == "inputcontrol_keyboard_get_state") return os_bindings::builtin_os_inputcontrol_get_keyboard_state(args);
-        if (method_name == "inputcontrol_mouse_capture") return os_bindings::builtin_os_inputcontrol_capture_mouse(args);
-        if (method_name == "inputcontrol_mouse_release") return os_bindings::builtin_os_inputcontrol_release_mouse(args);
-        if (method_name == "inputcontrol_mouse_move") return os_bindings::builtin_os_inputcontrol_move_mouse(args);
-        if (method_name == "inputcontrol_mouse_click") return os_bindings::builtin_os_inputcontrol_mouse_click(args);
-        if (method_name == "inputcontrol_mouse_scroll") return os_bindings::builtin_os_inputcontrol_scroll_mouse(args);
-        if (method_name == "inputcontrol_mouse_block") return os_bindings::builtin_os_inputcontrol_block_mouse_button(args);
-        if (method_name == "inputcontrol_mouse_unblock") return os_bindings::builtin_os_inputcontrol_unblock_mouse_button(args);
-        if (method_name == "inputcontrol_get_mouse_pos") return os_bindings::builtin_os_inputcontrol_get_mouse_position(args);
-        if (method_name == "inputcontrol_set_mouse_pos") return os_bindings::builtin_os_inputcontrol_set_mouse_position(args);
-        if (method_name == "inputcontrol_touch_capture") return os_bindings::builtin_os_inputcontrol_capture_touch(args);
-        if (method_name == "inputcontrol_touch_release") return os_bindings::builtin_os_inputcontrol_release_touch(args);
-        if (method_name == "inputcontrol_touch_send") return os_bindings::builtin_os_inputcontrol_send_touch_event(args);
-        if (method_name == "inputcontrol_clear_buffer") return os_bindings::builtin_os_inputcontrol_clear_input_buffer(args);
-        if (method_name == "inputcontrol_is_capturing") return os_bindings::builtin_os_inputcontrol_is_capturing(args);
-        
-        throw std::runtime_error("Unknown os method: " + method_name);
-    }
-
-    // Dispatcher for OS submodule method calls (os.Hook.xxx, os.InputControl.xxx, etc.)
-    Value call_os_submodule_builtin(const std::string& prefix, const std::string& method_name,
-                                    const std::vector<Value>& args) {
-        std::string full_name = prefix + method_name;
-        // OS.Hooks
-        if (full_name == "os_hooks_register") return os_bindings::builtin_os_hooks_register(args);
-        if (full_name == "os_hooks_unregister") return os_bindings::builtin_os_hooks_unregister(args);
-        if (full_name == "os_hooks_list") return os_bindings::builtin_os_hooks_list(args);
-        if (full_name == "os_hooks_enable") return os_bindings::builtin_os_hooks_enable(args);
-        if (full_name == "os_hooks_disable") return os_bindings::builtin_os_hooks_disable(args);
-        if (full_name == "os_hooks_set_callback") return os_bindings::builtin_os_hooks_set_callback(args);
-        if (full_name == "os_hooks_hook_process_create") return os_bindings::builtin_os_hooks_hook_process_create(args);
-        if (full_name == "os_hooks_hook_process_exit") return os_bindings::builtin_os_hooks_hook_process_exit(args);
-        if (full_name == "os_hooks_hook_file_access") return os_bindings::builtin_os_hooks_hook_file_access(args);
-        if (full_name == "os_hooks_hook_network_connect") return os_bindings::builtin_os_hooks_hook_network_connect(args);
-        if (full_name == "os_hooks_hook_keyboard") return os_bindings::builtin_os_hooks_hook_keyboard(args);
-        if (full_name == "os_hooks_hook_mouse") return os_bindings::builtin_os_hooks_hook_mouse(args);
-        if (full_name == "os_hooks_hook_syscall") return os_bindings::builtin_os_hooks_hook_syscall(args);
-        if (full_name == "os_hooks_inject_library") return os_bindings::builtin_os_hooks_inject_library(args);
-        if (full_name == "os_hooks_hook_memory_access") return os_bindings::builtin_os_hooks_hook_memory_access(args);
-        // OS.InputControl
-        if (full_name == "os_inputcontrol_capture_keyboard") return os_bindings::builtin_os_inputcontrol_capture_keyboard(args);
-        if (full_name == "os_inputcontrol_release_keyboard") return os_bindings::builtin_os_inputcontrol_release_keyboard(args);
-        if (full_name == "os_inputcontrol_press_key") return os_bindings::builtin_os_inputcontrol_press_key(args);
-        if (full_name == "os_inputcontrol_release_key") return os_bindings::builtin_os_inputcontrol_release_key(args);
-        if (full_name == "os_inputcontrol_tap_key") return os_bindings::builtin_os_inputcontrol_tap_key(args);
-        if (full_name == "os_inputcontrol_type_text") return os_bindings::builtin_os_inputcontrol_type_text(args);
-        if (full_name == "os_inputcontrol_type_text_raw") return os_bindings::builtin_os_inputcontrol_type_text_raw(args);
-        if (full_name == "os_inputcontrol_block_key") return os_bindings::builtin_os_inputcontrol_block_key(args);
-        if (full_name == "os_inputcontrol_unblock_key") return os_bindings::builtin_os_inputcontrol_unblock_key(args);
-        if (full_name == "os_inputcontrol_remap_key") return os_bindings::builtin_os_inputcontrol_remap_key(args);
-        if (full_name == "os_inputcontrol_get_keyboard_state") return os_bindings::builtin_os_inputcontrol_get_keyboard_state(args);
-        if (full_name == "os_inputcontrol_capture_mouse") return os_bindings::builtin_os_inputcontrol_capture_mouse(args);
-        if (full_name == "os_inputcontrol_release_mouse") return os_bindings::builtin_os_inputcontrol_release_mouse(args);
-        if (full_name == "os_inputcontrol_move_mouse") return os_bindings::builtin_os_inputcontrol_move_mouse(args);
-        if (full_name == "os_inputcontrol_press_mouse_button") return os_bindings::builtin_os_inputcontrol_press_mouse_button(args);
-        if (full_name == "os_inputcontrol_release_mouse_button") return os_bindings::builtin_os_inputcontrol_release_mouse_button(args);
-        if (full_name == "os_inputcontrol_click_mouse_button") return os_bindings::builtin_os_inputcontrol_click_mouse_button(args);
-        if (full_name == "os_inputcontrol_scroll_mouse") return os_bindings::builtin_os_inputcontrol_scroll_mouse(args);
-        if (full_name == "os_inputcontrol_block_mouse_button") return os_bindings::builtin_os_inputcontrol_block_mouse_button(args);
-        if (full_name == "os_inputcontrol_unblock_mouse_button") return os_bindings::builtin_os_inputcontrol_unblock_mouse_button(args);
-        if (full_name == "os_inputcontrol_get_mouse_position") return os_bindings::builtin_os_inputcontrol_get_mouse_position(args);
-        if (full_name == "os_inputcontrol_set_mouse_position") return os_bindings::builtin_os_inputcontrol_set_mouse_position(args);
-        if (full_name == "os_inputcontrol_capture_touch") return os_bindings::builtin_os_inputcontrol_capture_touch(args);
-        if (full_name == "os_inputcontrol_release_touch") return os_bindings::builtin_os_inputcontrol_release_touch(args);
-        if (full_name == "os_inputcontrol_send_touch_event") return os_bindings::builtin_os_inputcontrol_send_touch_event(args);
-        if (full_name == "os_inputcontrol_clear_input_buffer") return os_bindings::builtin_os_inputcontrol_clear_input_buffer(args);
-        if (full_name == "os_inputcontrol_is_capturing") return os_bindings::builtin_os_inputcontrol_is_capturing(args);
-        // OS.ProcessManager
-        if (full_name == "os_processes_list") return os_bindings::builtin_os_processes_list(args);
-        if (full_name == "os_processes_get_info") return os_bindings::builtin_os_processes_get_info(args);
-        if (full_name == "os_processes_create") return os_bindings::builtin_os_processes_create(args);
-        if (full_name == "os_processes_terminate") return os_bindings::builtin_os_processes_terminate(args);
-        if (full_name == "os_processes_wait") return os_bindings::builtin_os_processes_wait(args);
-        if (full_name == "os_processes_read_memory") return os_bindings::builtin_os_processes_read_memory(args);
-        if (full_name == "os_processes_write_memory") return os_bindings::builtin_os_processes_write_memory(args);
-        if (full_name == "os_processes_inject_library") return os_bindings::builtin_os_processes_inject_library(args);
-        if (full_name == "os_processes_list_threads") return os_bindings::builtin_os_processes_list_threads(args);
-        if (full_name == "os_processes_suspend") return os_bindings::builtin_os_processes_suspend(args);
-        if (full_name == "os_processes_resume") return os_bindings::builtin_os_processes_resume(args);
-        if (full_name == "os_processes_get_priority") return os_bindings::builtin_os_processes_get_priority(args);
-        if (full_name == "os_processes_set_priority") return os_bindings::builtin_os_processes_set_priority(args);
-        // OS.DisplayAccess
-        if (full_name == "os_display_list") return os_bindings::builtin_os_display_list(args);
-        if (full_name == "os_display_get_primary") return os_bindings::builtin_os_display_get_primary(args);
-        if (full_name == "os_display_capture_screen") return os_bindings::builtin_os_display_capture_screen(args);
-        if (full_name == "os_display_capture_region") return os_bindings::builtin_os_display_capture_region(args);
-        if (full_name == "os_display_capture_window") return os_bindings::builtin_os_display_capture_window(args);
-        if (full_name == "os_display_get_pixel") return os_bindings::builtin_os_display_get_pixel(args);
-        if (full_name == "os_display_create_overlay") return os_bindings::builtin_os_display_create_overlay(args);
-        if (full_name == "os_display_destroy_overlay") return os_bindings::builtin_os_display_destroy_overlay(args);
-        if (full_name == "os_display_draw_pixel") return os_bindings::builtin_os_display_draw_pixel(args);
-        if (full_name == "os_display_draw_line") return os_bindings::builtin_os_display_draw_line(args);
-        if (full_name == "os_display_draw_rectangle") return os_bindings::builtin_os_display_draw_rectangle(args);
-        if (full_name == "os_display_draw_circle") return os_bindings::builtin_os_display_draw_circle(args);
-        if (full_name == "os_display_draw_text") return os_bindings::builtin_os_display_draw_text(args);
-        if (full_name == "os_display_update") return os_bindings::builtin_os_display_update(args);
-        if (full_name == "os_display_set_mode") return os_bindings::builtin_os_display_set_mode(args);
-        if (full_name == "os_display_get_modes") return os_bindings::builtin_os_display_get_modes(args);
-        if (full_name == "os_display_get_buffer") return os_bindings::builtin_os_display_get_buffer(args);
-        if (full_name == "os_display_write_buffer") return os_bindings::builtin_os_display_write_buffer(args);
-        if (full_name == "os_display_show_cursor") return os_bindings::builtin_os_display_show_cursor(args);
-        if (full_name == "os_display_hide_cursor") return os_bindings::builtin_os_display_hide_cursor(args);
-        // OS.AudioControl
-        if (full_name == "os_audio_list_devices") return os_bindings::builtin_os_audio_list_devices(args);
-        if (full_name == "os_audio_get_default_device") return os_bindings::builtin_os_audio_get_default_device(args);
-        if (full_name == "os_audio_set_default_device") return os_bindings::builtin_os_audio_set_default_device(args);
-        if (full_name == "os_audio_get_device_info") return os_bindings::builtin_os_audio_get_device_info(args);
-        if (full_name == "os_audio_get_volume") return os_bindings::builtin_os_audio_get_volume(args);
-        if (full_name == "os_audio_set_volume") return os_bindings::builtin_os_audio_set_volume(args);
-        if (full_name == "os_audio_is_muted") return os_bindings::builtin_os_audio_is_muted(args);
-        if (full_name == "os_audio_set_mute") return os_bindings::builtin_os_audio_set_mute(args);
-        if (full_name == "os_audio_play_sound") return os_bindings::builtin_os_audio_play_sound(args);
-        if (full_name == "os_audio_play_tone") return os_bindings::builtin_os_audio_play_tone(args);
-       if (full_name == "os_audio_stop") return os_bindings::builtin_os_audio_stop(args);
-        if (full_name == "os_audio_create_stream") return os_bindings::builtin_os_audio_create_stream(args);
-        if (full_name == "os_audio_write_stream") return os_bindings::builtin_os_audio_write_stream(args);
-        if (full_name == "os_audio_close_stream") return os_bindings::builtin_os_audio_close_stream(args);
-        if (full_name == "os_audio_get_sample_rate") return os_bindings::builtin_os_audio_get_sample_rate(args);
-        if (full_name == "os_audio_set_sample_rate") return os_bindings::builtin_os_audio_set_sample_rate(args);
-        if (full_name == "os_audio_record") return os_bindings::builtin_os_audio_record(args);
-        if (full_name == "os_audio_stop_recording") return os_bindings::builtin_os_audio_stop_recording(args);
-        if (full_name == "os_audio_mix_streams") return os_bindings::builtin_os_audio_mix_streams(args);
-        if (full_name == "os_audio_apply_effect") return os_bindings::builtin_os_audio_apply_effect(args);
-        // OS.PrivilegeEscalator
-        if (full_name == "os_privileges_is_elevated") return os_bindings::builtin_os_privileges_is_elevated(args);
-        if (full_name == "os_privileges_is_admin") return os_bindings::builtin_os_privileges_is_admin(args);
-        if (full_name == "os_privileges_is_root") return os_bindings::builtin_os_privileges_is_root(args);
-        if (full_name == "os_privileges_get_level") return os_bindings::builtin_os_privileges_get_level(args);
-        if (full_name == "os_privileges_can_elevate") return os_bindings::builtin_os_privileges_can_elevate(args);
-        if (full_name == "os_privileges_request_elevation") return os_bindings::builtin_os_privileges_request_elevation(args);
-        if (full_name == "os_privileges_elevate_and_restart") return os_bindings::builtin_os_privileges_elevate_and_restart(args);
-        if (full_name == "os_privileges_get_user_info") return os_bindings::builtin_os_privileges_get_user_info(args);
-        if (full_name == "os_privileges_impersonate_user") return os_bindings::builtin_os_privileges_impersonate_user(args);
-        if (full_name == "os_privileges_check") return os_bindings::builtin_os_privileges_check(args);
-        if (full_name == "os_privileges_enable") return os_bindings::builtin_os_privileges_enable(args);
-        if (full_name == "os_privileges_drop") return os_bindings::builtin_os_privileges_drop(args);
-        if (full_name == "os_privileges_run_as_admin") return os_bindings::builtin_os_privileges_run_as_admin(args);
-        if (full_name == "os_privileges_get_token_info") return os_bindings::builtin_os_privileges_get_token_info(args);
-        // OS.EventListener
-        if (full_name == "os_events_watch_file") return os_bindings::builtin_os_events_watch_file(args);
-        if (full_name == "os_events_watch_network") return os_bindings::builtin_os_events_watch_network(args);
-        if (full_name == "os_events_watch_power") return os_bindings::builtin_os_events_watch_power(args);
-        if (full_name == "os_events_unwatch") return os_bindings::builtin_os_events_unwatch(args);
-        if (full_name == "os_events_poll") return os_bindings::builtin_os_events_poll(args);
-        if (full_name == "os_events_start_loop") return os_bindings::builtin_os_events_start_loop(args);
-        if (full_name == "os_events_stop_loop") return os_bindings::builtin_os_events_stop_loop(args);
-        if (full_name == "os_events_list") return os_bindings::builtin_os_events_list(args);
-        if (full_name == "os_events_set_callback") return os_bindings::builtin_os_events_set_callback(args);
-        if (full_name == "os_events_remove_callback") return os_bindings::builtin_os_events_remove_callback(args);
-        if (full_name == "os_events_dispatch") return os_bindings::builtin_os_events_dispatch(args);
-        if (full_name == "os_events_get_recent") return os_bindings::builtin_os_events_get_recent(args);
-        // OS.PersistenceHandler
-        if (full_name == "os_persistence_add_autostart") return os_bindings::builtin_os_persistence_add_autostart(args);
-        if (full_name == "os_persistence_remove_autostart") return os_bindings::builtin_os_persistence_remove_autostart(args);
-        if (full_name == "os_persistence_list_autostart") return os_bindings::builtin_os_persistence_list_autostart(args);
-        if (full_name == "os_persistence_install_service") return os_bindings::builtin_os_persistence_install_service(args);
-        if (full_name == "os_persistence_uninstall_service") return os_bindings::builtin_os_persistence_uninstall_service(args);
-        if (full_name == "os_persistence_start_service") return os_bindings::builtin_os_persistence_start_service(args);
-        if (full_name == "os_persistence_stop_service") return os_bindings::builtin_os_persistence_stop_service(args);
-        if (full_name == "os_persistence_restart_service") return os_bindings::builtin_os_persistence_restart_service(args);
-        if (full_name == "os_persistence_get_service_status") return os_bindings::builtin_os_persistence_get_service_status(args);
-        if (full_name == "os_persistence_add_scheduled_task") return os_bindings::builtin_os_persistence_add_scheduled_task(args);
-        if (full_name == "os_persistence_remove_scheduled_task") return os_bindings::builtin_os_persistence_remove_scheduled_task(args);
-
-        throw std::runtime_error("Unknown OS submodule method: " + full_name);
-    }
-
-    Value call_fs_builtin(const std::string& method_name, const std::vector<Value>& args) {
-        if (method_name == "exists") return fs_bindings::builtin_fs_exists(args);
-        if (method_name == "is_file") return fs_bindings::builtin_fs_is_file(args);
-        if (method_name == "is_dir") return fs_bindings::builtin_fs_is_dir(args);
-        if (method_name == "mkdir") return fs_bindings::builtin_fs_mkdir(args);
-        if (method_name == "remove") return fs_bindings::builtin_fs_remove(args);
-        if (method_name == "rmdir") return fs_bindings::builtin_fs_rmdir(args);
-        if (method_name == "listdir") return fs_bindings::builtin_fs_listdir(args);
-        if (method_name == "read_text") return fs_bindings::builtin_fs_read_text(args);
-        if (method_name == "write_text") return fs_bindings::builtin_fs_write_text(args);
-        if (method_name == "append_text") return fs_bindings::builtin_fs_append_text(args);
-        if (method_name == "copy") return fs_bindings::builtin_fs_copy(args);
-        if (method_name == "move") return fs_bindings::builtin_fs_move(args);
-        if (method_name == "abspath") return fs_bindings::builtin_fs_abspath(args);
-        throw std::runtime_error("Unknown fs method: " + method_name);
-    }
-
-    Value call_path_builtin(const std::string& method_name, const std::vector<Value>& args) {
-        if (method_name == "join") return path_bindings::builtin_path_join(args);
-        if (method_name == "basename") return path_bindings::builtin_path_basename(args);
-        if (method_name == "dirname") return path_bindings::builtin_path_dirname(args);
-        if (method_name == "ext") return path_bindings::builtin_path_ext(args);
-        if (method_name == "stem") return path_bindings::builtin_path_stem(args);
-        if (method_name == "norm") return path_bindings::builtin_path_norm(args);
-        if (method_name == "abspath") return path_bindings::builtin_path_abspath(args);
-        if (method_name == "exists") return path_bindings::builtin_path_exists(args);
-        if (method_name == "is_file") return path_bindings::builtin_path_is_file(args);
-        if (method_name == "is_dir") return path_bindings::builtin_path_is_dir(args);
-        if (method_name == "read_text") return path_bindings::builtin_path_read_text(args);
-        if (method_name == "write_text") return path_bindings::builtin_path_write_text(args);
-        if (method_name == "listdir") return path_bindings::builtin_path_listdir(args);
-        if (method_name == "mkdir") return path_bindings::builtin_path_mkdir(args);
-        if (method_name == "remove") return path_bindings::builtin_path_remove(args);
-        if (method_name == "rmdir") return path_bindings::builtin_path_rmdir(args);
-        throw std::runtime_error("Unknown path method: " + method_name);
-    }
-
-    Value call_process_builtin(const std::string& method_name, const std::vector<Value>& args) {
-        if (method_name == "getpid") return process_bindings::builtin_process_getpid(args);
-        if (method_name == "run") return process_bindings::builtin_process_run(args);
-        if (method_name == "cwd") return process_bindings::builtin_process_cwd(args);
-        if (method_name == "chdir") return process_bindings::builtin_process_chdir(args);
-        if (method_name == "getenv") return process_bindings::builtin_process_getenv(args);
-        if (method_name == "setenv") return process_bindings::builtin_process_setenv(args);
-        if (method_name == "unsetenv") return process_bindings::builtin_process_unsetenv(args);
-        throw std::runtime_error("Unknown process method: " + method_name);
-    }
-
-    Value call_json_builtin(const std::string& method_name, const std::vector<Value>& args) {
-        if (method_name == "parse") return json_bindings::builtin_json_parse(args);
-        if (method_name == "stringify") return json_bindings::builtin_json_stringify(args);
-        throw std::runtime_error("Unknown json method: " + method_name);
-    }
-
-    Value call_url_builtin(const std::string& method_name, const std::vector<Value>& args) {
-        if (method_name == "parse") return url_bindings::builtin_url_parse(args);
-        if (method_name == "encode") return url_bindings::builtin_url_encode(args);
-        if (method_name == "decode") return url_bindings::builtin_url_decode(args);
-        throw std::runtime_error("Unknown url method: " + method_name);
-    }
-
-    Value call_net_builtin(const std::string& method_name, const std::vector<Value>& args) {
-        if (method_name == "tcp_connect") return net_bindings::builtin_net_tcp_connect(args);
-        if (method_name == "tcp_listen") return net_bindings::builtin_net_tcp_listen(args);
-        if (method_name == "tcp_accept") return net_bindings::builtin_net_tcp_accept(args);
-        if (method_name == "tcp_try_accept") return net_bindings::builtin_net_tcp_try_accept(args);
-        if (method_name == "set_nonblocking") return net_bindings::builtin_net_set_nonblocking(args);
-        if (method_name == "tcp_send") return net_bindings::builtin_net_tcp_send(args);
-        if (method_name == "tcp_try_send") return net_bindings::builtin_net_tcp_try_send(args);
-        if (method_name == "tcp_recv") return net_bindings::builtin_net_tcp_recv(args);
-        if (method_name == "tcp_try_recv") return net_bindings::builtin_net_tcp_try_recv(args);
-        if (method_name == "tcp_close") return net_bindings::builtin_net_tcp_close(args);
-        if (method_name == "udp_bind") return net_bindings::builtin_net_udp_bind(args);
-        if (method_name == "udp_sendto") return net_bindings::builtin_net_udp_sendto(args);
-        if (method_name == "udp_recvfrom") return net_bindings::builtin_net_udp_recvfrom(args);
-        if (method_name == "udp_close") return net_bindings::builtin_net_udp_close(args);
-        if (method_name == "dns_lookup") return net_bindings::builtin_net_dns_lookup(args);
-        throw std::runtime_error("Unknown net method: " + method_name);
-    }
-
-    Value call_thread_builtin(const std::string& method_name, const std::vector<Value>& args) {
-        if (method_name == "spawn") return thread_bindings::builtin_thread_spawn(args);
-        if (method_name == "join") return thread_bindings::builtin_thread_join(args);
-        if (method_name == "is_done") return thread_bindings::builtin_thread_is_done(args);
-        if (method_name == "sleep") return thread_bindings::builtin_thread_sleep(args);
-        throw std::runtime_error("Unknown thread method: " + method_name);
-    }
-
-    Value call_channel_builtin(const std::string& method_name, const std::vector<Value>& args) {
-        if (method_name == "create") return channel_bindings::builtin_channel_create(args);
-        if (method_name == "send") return channel_bindings::builtin_channel_send(args);
-        if (method_name == "recv") return channel_bindings::builtin_channel_recv(args);
-        if (method_name == "try_recv") return channel_bindings::builtin_channel_try_recv(args);
-        if (method_name == "close") return channel_bindings::builtin_channel_close(args);
-        throw std::runtime_error("Unknown channel method: " + method_name);
-    }
-
-    Value call_async_builtin(const std::string& method_name, const std::vector<Value>& args) {
-        if (method_name == "spawn") return async_bindings::builtin_async_spawn(args);
-        if (method_name == "sleep") return async_bindings::builtin_async_sleep(args);
-        if (method_name == "tcp_recv") return async_bindings::builtin_async_tcp_recv(args);
-        if (method_name == "tcp_send") return async_bindings::builtin_async_tcp_send(args);
-        if (method_name == "tick") return async_bindings::builtin_async_tick(args);
-        if (method_name == "done") return async_bindings::builtin_async_done(args);
-        if (method_name == "status") return async_bindings::builtin_async_status(args);
-        if (method_name == "result") return async_bindings::builtin_async_result(args);
-        if (method_name == "cancel") return async_bindings::builtin_async_cancel(args);
-        if (method_name == "pending") return async_bindings::builtin_async_pending(args);
-        if (method_name == "await") return async_bindings::builtin_async_await(args);
-        throw std::runtime_error("Unknown async method: " + method_name);
-    }
-
-    Value call_crypto_builtin(const std::string& method_name, const std::vector<Value>& args) {
-        if (method_name == "sha256") return crypto_bindings::builtin_crypto_sha256(args);
-        if (method_name == "sha512") return crypto_bindings::builtin_crypto_sha512(args);
-        if (method_name == "hmac_sha256") return crypto_bindings::builtin_crypto_hmac_sha256(args);
-        if (method_name == "random_bytes") return crypto_bindings::builtin_crypto_random_bytes(args);
-        if (method_name == "hex_encode") return crypto_bindings::builtin_crypto_hex_encode(args);
-        if (method_name == "hex_decode") return crypto_bindings::builtin_crypto_hex_decode(args);
-        if (method_name == "base64_encode") return crypto_bindings::builtin_crypto_base64_encode(args);
-        if (method_name == "base64_decode") return crypto_bindings::builtin_crypto_base64_decode(args);
-        throw std::runtime_error("Unknown crypto method: " + method_name);
-    }
-
-    Value call_time_builtin(const std::string& method_name, const std::vector<Value>& args) {
-        if (method_name == "now_utc") return time_bindings::builtin_time_now_utc(args);
-        if (method_name == "now_local") return time_bindings::builtin_time_now_local(args);
-        if (method_name == "format") return time_bindings::builtin_time_format(args);
-        if (method_name == "parse") return time_bindings::builtin_time_parse(args);
-        if (method_name == "sleep_ms") return time_bindings::builtin_time_sleep_ms(args);
-        if (method_name == "epoch_ms") return time_bindings::builtin_time_epoch_ms(args);
-        throw std::runtime_error("Unknown time method: " + method_name);
-    }
-
-    Value call_log_builtin(const std::string& method_name, const std::vector<Value>& args) {
-        if (method_name == "set_level") return log_bindings::builtin_log_set_level(args);
-        if (method_name == "set_output") return log_bindings::builtin_log_set_output(args);
-        if (method_name == "set_json") return log_bindings::builtin_log_set_json(args);
-        if (method_name == "log") return log_bindings::builtin_log_log(args);
-        if (method_name == "debug") return log_bindings::builtin_log_debug(args);
-        if (method_name == "info") return log_bindings::builtin_log_info(args);
-        if (method_name == "warn") return log_bindings::builtin_log_warn(args);
-        if (method_name == "error") return log_bindings::builtin_log_error(args);
-        if (method_name == "flush") return log_bindings::builtin_log_flush(args);
-        throw std::runtime_error("Unknown log method: " + method_name);
-    }
-
-    Value call_config_builtin(const std::string& method_name, const std::vector<Value>& args) {
-        if (method_name == "load_env") return config_bindings::builtin_config_load_env(args);
-        if (method_name == "get") return config_bindings::builtin_config_get(args);
-        if (method_name == "set") return config_bindings::builtin_config_set(args);
-        if (method_name == "get_int") return config_bindings::builtin_config_get_int(args);
-        if (method_name == "get_float") return config_bindings::builtin_config_get_float(args);
-        if (method_name == "get_bool") return config_bindings::builtin_config_get_bool(args);
-        if (method_name == "has") return config_bindings::builtin_config_has(args);
-        throw std::runtime_error("Unknown config method: " + method_name);
-    }
-
-    Value call_input_builtin(const std::string& method_name, const std::vector<Value>& args) {
-        if (method_name == "enable_raw") return input_bindings::builtin_input_enable_raw(args);
-        if (method_name == "disable_raw") return input_bindings::builtin_input_disable_raw(args);
-        if (method_name == "key_available") return input_bindings::builtin_input_key_available(args);
-        if (method_name == "poll") return input_bindings::builtin_input_poll(args);
-        if (method_name == "read_key") return input_bindings::builtin_input_read_key(args);
-        if (method_name == "ord") return input_bindings::builtin_input_ord(args);
-        if (method_name == "chr") return input_bindings::builtin_input_chr(args);
-        throw std::runtime_error("Unknown input method: " + method_name);
-    }
-
 private:
     void runtime_error(const std::string& msg) {
-        std::cerr << "Runtime Error: " << msg << std::endl;
+        std::string trace;
         for (size_t i = frame_count; i > 0; --i) {
             CallFrame* frame = frames.get() + (i - 1);
             const char* fname = frame->name ? frame->name : "<anon>";
@@ -23043,8 +30742,10 @@ private:
             if (frame->chunk && frame->ip) {
                 ip_offset = static_cast<size_t>(frame->ip - frame->chunk->code.data());
             }
-            std::cerr << "  at " << fname << " (ip " << ip_offset << ")" << std::endl;
+            trace += "\n  at " + std::string(fname) + " (ip " + std::to_string(ip_offset) + ")";
         }
+        if (throw_errors) throw IsolateError(msg + trace);
+        std::cerr << "Runtime Error: " << msg << trace << std::endl;
         exit(1);
     }
 
@@ -23057,6 +30758,360 @@ private:
         runtime_error(buffer);
     }
 
+    void undefined_global_error(uint16_t slot) {
+        const char* name = g_global_slots.name_of(slot)->chars;
+        if (slot < unshared_globals.size() && unshared_globals[slot]) {
+            runtime_errorf("Global '%s' holds a %s, which is not shared with thread isolates; pass it as an argument",
+                           name, unshared_globals[slot]);
+        }
+        runtime_errorf("Undefined variable '%s'", name);
+    }
+
+    void abstract_instantiation_error(ObjClass* klass) {
+        if (!klass->missing_abstract.empty()) {
+            runtime_errorf("Cannot instantiate abstract class '%s' (missing '%s')",
+                           klass->name->chars, klass->missing_abstract.c_str());
+        }
+        runtime_errorf("Cannot instantiate abstract class '%s'", klass->name->chars);
+    }
+
+    // ===== Tensors =====
+    // Builtin operands may be tensors, rectangular (nested) number lists, or
+    // plain numbers, which broadcast against the other operand.
+
+    static bool is_scalar_number(uint64_t v) { return is_number(v) || (is_int(v) && !is_bool(v)); }
+
+    void tensor_store(ObjTensor* t, size_t i, uint64_t v) {
+        if (!is_scalar_number(v)) runtime_error("Tensor elements must be numbers");
+        switch (t->dtype) {
+            case DType::F32: static_cast<float*>(t->data)[i] = (float)(is_int(v) ? (double)as_int(v) : as_number(v)); break;
+            case DType::F64: static_cast<double*>(t->data)[i] = is_int(v) ? (double)as_int(v) : as_number(v); break;
+            case DType::I64: static_cast<int64_t*>(t->data)[i] = is_int(v) ? as_int(v) : (int64_t)as_number(v); break;
+        }
+    }
+
+    static std::string tensor_shape_str(const ObjTensor* t) {
+        std::string s = "[";
+        for (int i = 0; i < t->ndim; i++) {
+            if (i) s += ", ";
+            s += std::to_string(t->shape[i]);
+        }
+        return s + "]";
+    }
+
+    DType tensor_dtype_arg(uint64_t v) {
+        if (is_obj(v) && obj_type(v) == ObjType::STRING) {
+            std::string_view s(as_string(v)->chars, as_string(v)->length);
+            if (s == "f64" || s == "float64" || s == "float") return DType::F64;
+            if (s == "f32" || s == "float32") return DType::F32;
+            if (s == "i64" || s == "int64" || s == "int") return DType::I64;
+        }
+        runtime_error("Tensor dtype must be \"f64\", \"f32\" or \"i64\"");
+        return DType::F64;
+    }
+
+    // Dimensions given as integer arguments or as one list of integers;
+    // an optional trailing dtype string is split off first
+    int tensor_dims_args(const uint64_t* args, int argc, int64_t* shape, const char* name, DType* dtype) {
+        if (dtype && argc > 0 && is_obj(args[argc - 1]) && obj_type(args[argc - 1]) == ObjType::STRING) {
+            *dtype = tensor_dtype_arg(args[argc - 1]);
+            argc--;
+        }
+        const uint64_t* dims = args;
+        if (argc == 1 && is_obj(args[0]) && obj_type(args[0]) == ObjType::LIST) {
+            dims = as_list(args[0])->items;
+            argc = (int)as_list(args[0])->count;
+        }
+        if (argc < 1 || argc > ObjTensor::MAX_DIMS) runtime_errorf("%s() expects 1 to 8 dimensions", name);
+        for (int i = 0; i < argc; i++) {
+            if (!is_int(dims[i]) || is_bool(dims[i])) runtime_errorf("%s() dimensions must be integers", name);
+            shape[i] = as_int(dims[i]);
+        }
+        return argc;
+    }
+
+    static bool tensor_list_all_ints(uint64_t v) {
+        if (is_obj(v) && obj_type(v) == ObjType::LIST) {
+            ObjList* l = as_list(v);
+            for (size_t i = 0; i < l->count; i++)
+                if (!tensor_list_all_ints(l->get(i))) return false;
+            return true;
+        }
+        return is_int(v) && !is_bool(v);
+    }
+
+    void tensor_fill(ObjTensor* t, uint64_t v, int dim, size_t& flat) {
+        if (!is_obj(v) || obj_type(v) != ObjType::LIST || (int64_t)as_list(v)->count != t->shape[dim]) {
+            runtime_error("Tensor data must be a rectangular list of numbers");
+        }
+        ObjList* l = as_list(v);
+        for (size_t i = 0; i < l->count; i++) {
+            if (dim + 1 < t->ndim) tensor_fill(t, l->get(i), dim + 1, flat);
+            else tensor_store(t, flat++, l->get(i));
+        }
+    }
+
+    // dtype F64 and I64 lists; inferred (I64 if every element is an integer)
+    // when has_dtype is false
+    ObjTensor* tensor_from_list(uint64_t v, bool has_dtype, DType dtype) {
+        int64_t shape[ObjTensor::MAX_DIMS];
+        int ndim = 0;
+        for (uint64_t cur = v; is_obj(cur) && obj_type(cur) == ObjType::LIST;) {
+            if (ndim == ObjTensor::MAX_DIMS) runtime_error("Tensor data has more than 8 dimensions");
+            ObjList* l = as_list(cur);
+            shape[ndim++] = (int64_t)l->count;
+            if (l->count == 0) break;
+            cur = l->get(0);
+        }
+        if (ndim == 0) runtime_error("tensor_from() expects a list");
+        if (!has_dtype) dtype = tensor_list_all_ints(v) ? DType::I64 : DType::F64;
+        ObjTensor* t = ObjTensor::create(dtype, shape, ndim);
+        size_t flat = 0;
+        tensor_fill(t, v, 0, flat);
+        return t;
+    }
+
+    ObjTensor* tensor_operand(uint64_t v, const char* name) {
+        if (is_tensor(v)) return as_tensor(v);
+        if (is_obj(v) && obj_type(v) == ObjType::LIST) return tensor_from_list(v, false, DType::F64);
+        runtime_errorf("%s() expects tensors or number lists", name);
+        return nullptr;
+    }
+
+    uint64_t tensor_binary(tensor_kernels::BinOp op, uint64_t a, uint64_t b, const char* name) {
+        if (is_scalar_number(a)) std::swap(a, b);  // add and mul commute
+        if (is_scalar_number(a)) runtime_errorf("%s() expects at least one tensor", name);
+        ObjTensor* ta = tensor_operand(a, name);
+        ObjTensor* tb = nullptr;
+        DType dtype = ta->dtype;
+        if (is_scalar_number(b)) {
+            if (dtype == DType::I64 && !is_int(b)) dtype = DType::F64;
+        } else {
+            tb = tensor_operand(b, name);
+            bool same = ta->ndim == tb->ndim;
+            for (int i = 0; same && i < ta->ndim; i++) same = ta->shape[i] == tb->shape[i];
+            if (!same) {
+                runtime_errorf("%s(): shape mismatch %s vs %s", name,
+                               tensor_shape_str(ta).c_str(), tensor_shape_str(tb).c_str());
+            }
+            if (tb->dtype != dtype) dtype = DType::F64;
+            tb = tensor_dense(tb, dtype);
+        }
+        ta = tensor_dense(ta, dtype);
+        ObjTensor* out = ObjTensor::create(dtype, ta->shape, ta->ndim);
+        union { double f64; float f32; int64_t i64; } scalar;
+        const void* rhs = &scalar;
+        if (tb) {
+            rhs = tb->elements();
+        } else if (dtype == DType::I64) {
+            scalar.i64 = as_int(b);
+        } else {
+            double d = is_int(b) ? (double)as_int(b) : as_number(b);
+            if (dtype == DType::F32) scalar.f32 = (float)d;
+            else scalar.f64 = d;
+        }
+        tensor_kernels::binary(op, dtype, ta->elements(), rhs, out->elements(), out->count, tb == nullptr);
+        return val_obj(out);
+    }
+
+    uint64_t tensor_matmul(uint64_t a, uint64_t b) {
+        ObjTensor* ta = tensor_operand(a, "tensor_matmul");
+        ObjTensor* tb = tensor_operand(b, "tensor_matmul");
+        if (ta->ndim > 2 || tb->ndim > 2) runtime_error("tensor_matmul() expects 1-D or 2-D tensors");
+        if (ta->ndim == 1 && tb->ndim == 1) return tensor_dot(a, b);
+        // A 1-D left operand is a row vector, a 1-D right operand a column
+        size_t m = ta->ndim == 2 ? (size_t)ta->shape[0] : 1;
+        size_t k = (size_t)ta->shape[ta->ndim - 1];
+        size_t n = tb->ndim == 2 ? (size_t)tb->shape[1] : 1;
+        if ((size_t)tb->shape[0] != k) {
+            runtime_errorf("tensor_matmul(): inner dimensions differ (%s x %s)",
+                           tensor_shape_str(ta).c_str(), tensor_shape_str(tb).c_str());
+        }
+        DType dtype = ta->dtype == tb->dtype ? ta->dtype : DType::F64;
+        ta = tensor_dense(ta, dtype);
+        tb = tensor_dense(tb, dtype);
+        int64_t shape[2];
+        int ndim = 0;
+        if (ta->ndim == 2) shape[ndim++] = (int64_t)m;
+        if (tb->ndim == 2) shape[ndim++] = (int64_t)n;
+        ObjTensor* out = ObjTensor::create(dtype, shape, ndim);
+        tensor_kernels::matmul(dtype, ta->elements(), tb->elements(), out->elements(), m, k, n);
+        return val_obj(out);
+    }
+
+    uint64_t tensor_dot(uint64_t a, uint64_t b) {
+        ObjTensor* ta = tensor_operand(a, "tensor_dot");
+        ObjTensor* tb = tensor_operand(b, "tensor_dot");
+        if (ta->ndim != 1 || tb->ndim != 1 || ta->count != tb->count) {
+            runtime_errorf("tensor_dot() expects two 1-D tensors of the same length (%s, %s)",
+                           tensor_shape_str(ta).c_str(), tensor_shape_str(tb).c_str());
+        }
+        DType dtype = ta->dtype == tb->dtype ? ta->dtype : DType::F64;
+        ta = tensor_dense(ta, dtype);
+        tb = tensor_dense(tb, dtype);
+        if (dtype == DType::I64) {
+            int64_t s = 0;
+            const int64_t* x = ta->ptr<int64_t>();
+            const int64_t* y = tb->ptr<int64_t>();
+            for (size_t i = 0; i < ta->count; i++) s += x[i] * y[i];
+            return val_int(s);
+        }
+        return val_number(tensor_kernels::dot(dtype, ta->elements(), tb->elements(), ta->count));
+    }
+
+    uint64_t tensor_sum(uint64_t v, bool mean) {
+        ObjTensor* t = tensor_operand(v, mean ? "tensor_mean" : "tensor_sum");
+        t = tensor_dense(t, t->dtype);
+        if (t->dtype == DType::I64 && !mean) {
+            int64_t s = 0;
+            const int64_t* x = t->ptr<int64_t>();
+            for (size_t i = 0; i < t->count; i++) s += x[i];
+            return val_int(s);
+        }
+        double s = t->dtype == DType::I64 ? 0.0 : tensor_kernels::sum(t->dtype, t->elements(), t->count);
+        if (t->dtype == DType::I64) {
+            const int64_t* x = t->ptr<int64_t>();
+            for (size_t i = 0; i < t->count; i++) s += (double)x[i];
+        }
+        return val_number(mean ? (t->count ? s / (double)t->count : 0.0) : s);
+    }
+
+    uint64_t tensor_reshape(const uint64_t* args, int argc) {
+        if (argc < 2 || !is_tensor(args[0])) runtime_error("tensor_reshape() expects a tensor and a shape");
+        ObjTensor* t = as_tensor(args[0]);
+        int64_t shape[ObjTensor::MAX_DIMS];
+        int ndim = tensor_dims_args(args + 1, argc - 1, shape, "tensor_reshape", nullptr);
+        int infer = -1;
+        size_t known = 1;
+        for (int i = 0; i < ndim; i++) {
+            if (shape[i] == -1 && infer < 0) infer = i;
+            else if (shape[i] < 0) runtime_error("tensor_reshape() dimensions must be non-negative (one may be -1)");
+            else known *= (size_t)shape[i];
+        }
+        if (infer >= 0 && known && t->count % known == 0) shape[infer] = (int64_t)(t->count / known);
+        size_t count = 1;
+        for (int i = 0; i < ndim; i++) count *= (size_t)std::max<int64_t>(shape[i], 0);
+        if ((infer >= 0 && shape[infer] < 0) || count != t->count) {
+            runtime_errorf("tensor_reshape(): cannot reshape %s (%zu elements)", tensor_shape_str(t).c_str(), t->count);
+        }
+        t = tensor_dense(t, t->dtype);
+        int64_t strides[ObjTensor::MAX_DIMS];
+        int64_t step = 1;
+        for (int i = ndim - 1; i >= 0; i--) {
+            strides[i] = step;
+            step *= shape[i];
+        }
+        return val_obj(ObjTensor::view(t, shape, strides, ndim, t->offset));
+    }
+
+    uint64_t tensor_transpose(uint64_t v) {
+        if (!is_tensor(v)) runtime_error("tensor_transpose() expects a tensor");
+        ObjTensor* t = as_tensor(v);
+        int64_t shape[ObjTensor::MAX_DIMS], strides[ObjTensor::MAX_DIMS];
+        for (int i = 0; i < t->ndim; i++) {
+            shape[i] = t->shape[t->ndim - 1 - i];
+            strides[i] = t->strides[t->ndim - 1 - i];
+        }
+        return val_obj(ObjTensor::view(t, shape, strides, t->ndim, t->offset));
+    }
+
+    // Leave n for-in loops early (break/return); a reader being iterated is
+    // closed, as it would have been at the end of its loop
+    void pop_iterators(size_t n) {
+        for (size_t i = iter_count - n; i < iter_count; ++i) {
+            if (is_reader(iterators[i].obj)) as_reader(iterators[i].obj)->close();
+        }
+        iter_count -= n;
+    }
+
+    // Next line of a for-in over a reader, or none (closing the file) at the end
+    uint64_t reader_next_line(ObjReader* r) {
+        std::string_view line;
+        if (!r->next_line(line)) {
+            r->close();
+            return VAL_NONE;
+        }
+        if (line.size() > UINT32_MAX) runtime_error("fs.lines(): line longer than 4 GB");
+        return val_obj((Obj*)ObjString::create(line.data(), (uint32_t)line.size()));
+    }
+
+    // reader.read_chunk(n) / read_line() / close()
+    uint64_t reader_method(ObjReader* r, const std::string& name, const uint64_t* args, uint8_t argc) {
+        if (name == "read_chunk" && argc == 1) {
+            if (!is_int(args[0]) || is_bool(args[0]) || as_int(args[0]) <= 0) {
+                runtime_error("read_chunk(n) needs a positive integer size");
+            }
+            std::string_view chunk = r->read_chunk((size_t)std::min<int64_t>(as_int(args[0]), UINT32_MAX));
+            if (chunk.empty()) return VAL_NONE;
+            return val_obj((Obj*)ObjString::create(chunk.data(), (uint32_t)chunk.size()));
+        }
+        if (name == "read_line" && argc == 0) {
+            std::string_view line;
+            if (!r->next_line(line)) return VAL_NONE;
+            return val_obj((Obj*)ObjString::create(line.data(), (uint32_t)line.size()));
+        }
+        if (name == "close" && argc == 0) {
+            r->close();
+            return VAL_NONE;
+        }
+        runtime_errorf("Unknown method '%s' on reader", name.c_str());
+        return VAL_NONE;
+    }
+
+    // bytes(x): copy of a string or bytes, packed int list, or n zero bytes
+    ObjBytes* bytes_from(uint64_t v) {
+        if (is_bytes(v)) return ObjBytes::create(as_bytes(v)->data, as_bytes(v)->length);
+        if (is_obj(v) && obj_type(v) == ObjType::STRING) return ObjBytes::create(as_string(v)->chars, as_string(v)->length);
+        if (is_int(v) && !is_bool(v)) {
+            if (as_int(v) < 0) runtime_error("bytes() size must be non-negative");
+            return ObjBytes::create((size_t)as_int(v));
+        }
+        if (is_obj(v) && obj_type(v) == ObjType::LIST) {
+            ObjList* l = as_list(v);
+            ObjBytes* b = ObjBytes::create(l->count);
+            for (size_t i = 0; i < l->count; i++) {
+                uint64_t item = l->get(i);
+                if (!is_int(item) || is_bool(item) || as_int(item) < 0 || as_int(item) > 255) {
+                    runtime_error("bytes() list items must be integers in 0..255");
+                }
+                b->data[i] = (uint8_t)as_int(item);
+            }
+            return b;
+        }
+        runtime_error("bytes() expects a string, bytes, list of ints or a size");
+        return nullptr;
+    }
+
+    // t[i]: an element of a 1-D tensor, else a view of row i
+    uint64_t tensor_index(ObjTensor* t, uint64_t idx) {
+        if (!is_int(idx) || is_bool(idx)) runtime_error("Tensor index must be an integer");
+        int64_t i = as_int(idx);
+        if (i < 0 || i >= t->shape[0]) runtime_error("Tensor index out of range");
+        size_t at = t->offset + (size_t)(i * t->strides[0]);
+        if (t->ndim == 1) return tensor_load(t, at);
+        return val_obj(ObjTensor::view(t, t->shape + 1, t->strides + 1, t->ndim - 1, at));
+    }
+
+    // Legacy list kernels (simd_add_f32 and friends); tensors take the
+    // tensor path instead
+    uint64_t simd_list_binary(tensor_kernels::BinOp op, DType dtype, uint64_t a, uint64_t b, const char* name) {
+        if (is_tensor(a) || is_tensor(b)) return tensor_binary(op, a, b, name);
+        if (!is_obj(a) || obj_type(a) != ObjType::LIST || !is_obj(b) || obj_type(b) != ObjType::LIST) {
+            runtime_errorf("%s() expects two lists", name);
+        }
+        ObjList* la = as_list(a);
+        ObjList* lb = as_list(b);
+        int64_t shape[1] = {(int64_t)std::min(la->count, lb->count)};
+        ObjTensor* x = ObjTensor::create(dtype, shape, 1);
+        ObjTensor* y = ObjTensor::create(dtype, shape, 1);
+        for (size_t i = 0; i < x->count; i++) {
+            tensor_store(x, i, la->get(i));
+            tensor_store(y, i, lb->get(i));
+        }
+        tensor_kernels::binary(op, dtype, x->elements(), y->elements(), x->elements(), x->count, false);
+        return tensor_to_list(x, 0, 0);
+    }
+
     uint64_t execute(Chunk* main_chunk) {
         uint8_t* ip = fp->ip;
         uint64_t* slots = fp->slots;
@@ -23110,7 +31165,12 @@ private:
             // Tuple support
             &&DO_BUILD_TUPLE, &&DO_UNPACK_TUPLE,
             // Module import
-            &&DO_IMPORT,
+            &&DO_IMPORT, &&DO_MODULE_EXPORTS, &&DO_AWAIT,
+            &&DO_APPEND_LOCAL, &&DO_APPEND_GLOBAL, &&DO_GET_LOCAL_SEAL, &&DO_ITER_POP,
+            // Peephole superinstructions
+            &&DO_POP_JUMP_IF_FALSE, &&DO_JUMP_IF_NOT_EQ, &&DO_JUMP_IF_NOT_NE, &&DO_JUMP_IF_NOT_LT,
+            &&DO_JUMP_IF_NOT_GT, &&DO_JUMP_IF_NOT_LE, &&DO_JUMP_IF_NOT_GE, &&DO_JUMP_IF_LOCAL_NOT_LT,
+            &&DO_ADD_LOCALS, &&DO_INC_LOCAL, &&DO_INDEX_LOCAL,
             // ============================================================================
             // FUTURE-PROOF: HARDWARE & EMBEDDED SYSTEMS PRIMITIVES
             // ============================================================================
@@ -23124,6 +31184,8 @@ private:
             // ============================================================================
             &&DO_TENSOR_CREATE, &&DO_TENSOR_ADD, &&DO_TENSOR_MUL, &&DO_TENSOR_MATMUL,
             &&DO_TENSOR_DOT, &&DO_TENSOR_SUM, &&DO_TENSOR_MEAN, &&DO_TENSOR_RESHAPE, &&DO_TENSOR_TRANSPOSE,
+            &&DO_TENSOR_FROM, &&DO_TENSOR_TOLIST, &&DO_TENSOR_SHAPE,
+            &&DO_BYTES_NEW, &&DO_BYTES_SLICE,
             // ============================================================================
             // FUTURE-PROOF: SIMD/VECTORIZATION PRIMITIVES
             // ============================================================================
@@ -23135,12 +31197,21 @@ private:
             &&DO_SPAWN_THREAD, &&DO_JOIN_THREAD, &&DO_CHANNEL_SEND, &&DO_CHANNEL_RECV
         };
         
-        #define DISPATCH() goto *dispatch[READ_BYTE()]
+        // --profile-ops routes every dispatch through DO_COUNT_OP first
+        static void* counted[sizeof(dispatch) / sizeof(dispatch[0])];
+        if (profiler::g_count_ops && !counted[0]) {
+            for (void*& target : counted) target = &&DO_COUNT_OP;
+        }
+        void* const* table = profiler::g_count_ops ? counted : dispatch;
+
+        #define DISPATCH() goto *table[READ_BYTE()]
         
         DISPATCH();
+
+        DO_COUNT_OP: profiler::count_op(ip[-1]); goto *dispatch[ip[-1]];
         
         // ===== CONSTANTS =====
-        DO_CONST: PUSH(from_value(chunk->constants[READ_SHORT()])); DISPATCH();
+        DO_CONST: PUSH(chunk->fast_constants[READ_SHORT()]); DISPATCH();
         DO_CONST_INT: PUSH(val_int(READ_BYTE())); DISPATCH();
         DO_NONE: PUSH(VAL_NONE); DISPATCH();
         DO_TRUE: PUSH(VAL_TRUE); DISPATCH();
@@ -23188,7 +31259,7 @@ private:
         
         // ===== COMPARISON (hot path) =====
         DO_EQ: { sp[-2] = fast_eq(sp[-2], sp[-1]); DROP(); } DISPATCH();
-        DO_NE: { sp[-2] = sp[-2] != sp[-1] ? VAL_TRUE : VAL_FALSE; DROP(); } DISPATCH();
+        DO_NE: { sp[-2] = fast_eq(sp[-2], sp[-1]) == VAL_TRUE ? VAL_FALSE : VAL_TRUE; DROP(); } DISPATCH();
         DO_LT: { sp[-2] = fast_lt(sp[-2], sp[-1]); DROP(); } DISPATCH();
         DO_GT: { sp[-2] = fast_lt(sp[-1], sp[-2]); DROP(); } DISPATCH();
         DO_LE: { sp[-2] = fast_le(sp[-2], sp[-1]); DROP(); } DISPATCH();
@@ -23197,35 +31268,65 @@ private:
         DO_AND: { sp[-2] = (is_truthy(sp[-2]) && is_truthy(sp[-1])) ? VAL_TRUE : VAL_FALSE; DROP(); } DISPATCH();
         DO_OR: { sp[-2] = (is_truthy(sp[-2]) || is_truthy(sp[-1])) ? VAL_TRUE : VAL_FALSE; DROP(); } DISPATCH();
         
-        // ===== GLOBALS (using 16-bit indices for large constant pools) =====
+        // ===== GLOBALS (dense slots resolved by the Compiler) =====
         DO_GET_GLOBAL: {
-            uint16_t idx = READ_SHORT();
-            Value& name_val = chunk->constants[idx];
-            ObjString* name = intern_name(name_val.data.string);
-            uint64_t val = globals[name];
-            PUSH(val);
+            uint16_t slot = READ_SHORT();
+            uint64_t val = slot < globals.size() ? globals[slot] : VAL_UNDEFINED;
+            if (val == VAL_UNDEFINED) undefined_global_error(slot);
+            PUSH(seal_string(val));
+        } DISPATCH();
+        DO_APPEND_GLOBAL: {
+            uint16_t slot = READ_SHORT();
+            if (slot >= globals.size() || globals[slot] == VAL_UNDEFINED) undefined_global_error(slot);
+            append_in_place(globals[slot], sp[-1]);
+            DROP();
         } DISPATCH();
         DO_SET_GLOBAL: {
-            uint16_t idx = READ_SHORT();
-            Value& name_val = chunk->constants[idx];
-            ObjString* name = intern_name(name_val.data.string);
-            globals[name] = PEEK(0);
+            uint16_t slot = READ_SHORT();
+            global_ref(slot) = PEEK(0);
         } DISPATCH();
         DO_DEFINE_GLOBAL: {
-            uint16_t idx = READ_SHORT();
-            Value& name_val = chunk->constants[idx];
-            ObjString* name = intern_name(name_val.data.string);
-            uint64_t val = POP();
-            globals[name] = val;
+            uint16_t slot = READ_SHORT();
+            global_ref(slot) = POP();
         } DISPATCH();
         
         // ===== LOCALS (super fast - direct array access) =====
         DO_GET_LOCAL: PUSH(slots[READ_BYTE()]); DISPATCH();
         DO_SET_LOCAL: slots[READ_BYTE()] = PEEK(0); DISPATCH();
+        DO_APPEND_LOCAL: { uint8_t slot = READ_BYTE(); append_in_place(slots[slot], sp[-1]); DROP(); } DISPATCH();
+        DO_GET_LOCAL_SEAL: PUSH(seal_string(slots[READ_BYTE()])); DISPATCH();
+        DO_ITER_POP: pop_iterators(READ_BYTE()); DISPATCH();
         
         // ===== CONTROL FLOW =====
         DO_JUMP: { uint16_t off = READ_SHORT(); ip += off; } DISPATCH();
         DO_JUMP_IF_FALSE: { uint16_t off = READ_SHORT(); if (!is_truthy(PEEK(0))) ip += off; } DISPATCH();
+
+        // ===== SUPERINSTRUCTIONS (bytecode::optimize) =====
+        DO_POP_JUMP_IF_FALSE: { uint16_t off = READ_SHORT(); if (!is_truthy(POP())) ip += off; } DISPATCH();
+        DO_JUMP_IF_NOT_EQ: { uint16_t off = READ_SHORT(); sp -= 2; if (fast_eq(sp[0], sp[1]) != VAL_TRUE) ip += off; } DISPATCH();
+        DO_JUMP_IF_NOT_NE: { uint16_t off = READ_SHORT(); sp -= 2; if (fast_eq(sp[0], sp[1]) == VAL_TRUE) ip += off; } DISPATCH();
+        DO_JUMP_IF_NOT_LT: { uint16_t off = READ_SHORT(); sp -= 2; if (fast_lt(sp[0], sp[1]) != VAL_TRUE) ip += off; } DISPATCH();
+        DO_JUMP_IF_NOT_GT: { uint16_t off = READ_SHORT(); sp -= 2; if (fast_lt(sp[1], sp[0]) != VAL_TRUE) ip += off; } DISPATCH();
+        DO_JUMP_IF_NOT_LE: { uint16_t off = READ_SHORT(); sp -= 2; if (fast_le(sp[0], sp[1]) != VAL_TRUE) ip += off; } DISPATCH();
+        DO_JUMP_IF_NOT_GE: { uint16_t off = READ_SHORT(); sp -= 2; if (fast_le(sp[1], sp[0]) != VAL_TRUE) ip += off; } DISPATCH();
+        DO_JUMP_IF_LOCAL_NOT_LT: {
+            uint64_t v = slots[READ_BYTE()];
+            int64_t limit = READ_BYTE();
+            uint16_t off = READ_SHORT();
+            bool lt = is_int(v) ? as_int(v) < limit : fast_lt(v, val_int(limit)) == VAL_TRUE;
+            if (!lt) ip += off;
+        } DISPATCH();
+        DO_ADD_LOCALS: {
+            uint64_t a = slots[READ_BYTE()];
+            uint64_t b = slots[READ_BYTE()];
+            PUSH(fast_add(a, b));
+        } DISPATCH();
+        DO_INC_LOCAL: {
+            uint64_t& slot = slots[READ_BYTE()];
+            int delta = (int8_t)READ_BYTE();
+            slot = delta >= 0 ? fast_add(slot, val_int(delta)) : fast_sub(slot, val_int(-delta));
+        } DISPATCH();
+        DO_INDEX_LOCAL: PUSH(slots[READ_BYTE()]); goto DO_GET_INDEX;
         
         // ╔══════════════════════════════════════════════════════════════════════════╗
         // ║  O(1) LOOP OPTIMIZATION                                                  ║
@@ -23270,298 +31371,105 @@ private:
                 }
             }
             
+            // Closed-form range sums. Each pattern must be the entire body of
+            // the innermost for-in loop (ITER_NEXT, bind, one statement, this
+            // LOOP) and the accumulator an int, so nothing else is skipped.
             if (iter_count > 0) {
                 FastIter& it = iterators[iter_count - 1];
                 int64_t iters_left = (it.step > 0) ? (it.stop - it.cur) / it.step : 0;
-                
-                // Triple nested loop detection - O(1) counting
-                // Pattern: for i in range(A): for j in range(B): for k in range(C): total += 1
-                // Result = A * B * C (instant!)
-                if (iter_count >= 3 && iters_left > 0) {
-                    FastIter& outer = iterators[iter_count - 3];
-                    FastIter& middle = iterators[iter_count - 2];
-                    FastIter& inner = iterators[iter_count - 1];
-                    
-                    // All must be simple counting ranges
-                    if (outer.step == 1 && middle.step == 1 && inner.step == 1 &&
-                        outer.cur == 0 && middle.cur == 0 && inner.cur == 0) {
-                        
-                        // Look for total += 1 pattern in the innermost loop
-                        uint8_t* p = loop_body;
-                        bool found_counting = false;
-                        
-                        // Scan for GET_GLOBAL/LOCAL, CONST_INT(1), ADD, SET pattern
-                        for (int scan = 0; scan < 20 && loop_body + scan < ip - off; scan++) {
-                            if ((p[scan] == (uint8_t)OpCode::OP_CONST_INT && p[scan+1] == 1) ||
-                                (p[scan] == (uint8_t)OpCode::OP_CONST_INT)) {
-                                // Found a constant, check for ADD after
-                                for (int s2 = scan; s2 < scan + 5 && s2 < 20; s2++) {
-                                    if (p[s2] == (uint8_t)OpCode::OP_ADD) {
-                                        found_counting = true;
-                                        break;
-                                    }
-                                }
-                            }
-                        }
-                        
-                        if (found_counting) {
-                            //  INSTANT COMPUTATION: A * B * C
-                            int64_t total_count = outer.stop * middle.stop * inner.stop;
-                            
-                            // Find and update the accumulator
-                            for (int scan = 0; scan < 20; scan++) {
-                                if (p[scan] == (uint8_t)OpCode::OP_SET_GLOBAL) {
-                                    uint16_t idx = p[scan+1] | (p[scan+2] << 8);
-                                    Value& name_val = chunk->constants[idx];
-                                    ObjString* name = intern_name(name_val.data.string);
-                                    globals[name] = val_int(total_count);
-                                    
-                                    // Skip ALL THREE loops
-                                    outer.cur = outer.stop;
-                                    middle.cur = middle.stop;
-                                    inner.cur = inner.stop;
-                                    iter_count -= 3;
-                                    
-                                    // Jump to end of all loops
-                                    for (int skip = 0; skip < 3; skip++) {
-                                        while (*ip != (uint8_t)OpCode::OP_LOOP) ip++;
-                                        ip += 3;
-                                    }
-                                    DISPATCH();
-                                }
-                            }
-                        }
-                    }
-                }
-                
-                //  NESTED LOOP PRODUCT OPTIMIZATION 
-                // Detect: total += outer_var * inner_var (common nested loop pattern)
-                // For ranges [0,n) and [0,m): sum = (n*(n-1)/2) * (m*(m-1)/2)
-                if (iter_count >= 2 && iters_left > 5) {
-                    FastIter& outer = iterators[iter_count - 2];
-                    // Check if this is the inner loop about to start a new iteration
-                    // Pattern: GET_LOCAL(j), SET_LOCAL, POP, GET_GLOBAL/LOCAL(total), GET_LOCAL(i), GET_LOCAL(j), MUL, ADD, SET
-                    uint8_t* p = loop_body;
-                    if (p[0] == (uint8_t)OpCode::OP_ITER_NEXT) {
-                        // Try to detect i*j pattern and compute entire nested sum
-                        // This is the inner loop - when we detect the pattern, compute full result
-                        int64_t outer_n = outer.stop;  // assuming start=0, step=1
-                        int64_t inner_m = it.stop;
-                        
-                        if (outer.step == 1 && it.step == 1 && outer.cur == 0) {
-                            // Check for total += i * j by looking ahead in bytecode
-                            // Simplified: if we see MUL followed by ADD in the loop body, assume product pattern
-                            bool found_mul = false, found_add = false;
-                            for (int scan = 0; scan < 30 && loop_body + scan < ip; scan++) {
-                                if (p[scan] == (uint8_t)OpCode::OP_MUL) found_mul = true;
-                                if (p[scan] == (uint8_t)OpCode::OP_ADD && found_mul) found_add = true;
-                            }
-                            
-                            if (found_mul && found_add) {
-                                //  FULL NESTED LOOP OPTIMIZATION!
-                                // sum_{i=0}^{n-1} sum_{j=0}^{m-1} i*j = (n*(n-1)/2) * (m*(m-1)/2)
-                                int64_t sum_i = outer_n * (outer_n - 1) / 2;
-                                int64_t sum_j = inner_m * (inner_m - 1) / 2;
-                                int64_t total = sum_i * sum_j;
-                                
-                                // Find the accumulator slot and update it
-                                // Look for the SET_LOCAL or SET_GLOBAL after ADD
-                                for (int scan = 0; scan < 30 && loop_body + scan < ip; scan++) {
-                                    if (p[scan] == (uint8_t)OpCode::OP_ADD) {
-                                        if (p[scan+1] == (uint8_t)OpCode::OP_SET_LOCAL) {
-                                            uint8_t slot = p[scan+2];
-                                            slots[slot] = val_int(total);
-                                        } else if (p[scan+1] == (uint8_t)OpCode::OP_SET_GLOBAL) {
-                                            uint8_t idx = p[scan+2];
-                                            Value& name_val = chunk->constants[idx];
-                                            ObjString* name = intern_name(name_val.data.string);
-                                            globals[name] = val_int(total);
-                                        }
-                                        break;
-                                    }
-                                }
-                                
-                                // Skip both loops entirely
-                                outer.cur = outer.stop;
-                                it.cur = it.stop;
-                                iter_count -= 2;
-                                // Jump past both loops - find end
-                                while (*ip != (uint8_t)OpCode::OP_LOOP) ip++;
-                                ip += 3;  // Skip outer loop instruction
-                                DISPATCH();
-                            }
-                        }
-                    }
-                }
-                
-                // Only optimize loops with many iterations (amortize detection cost)
-                // Bytecode layout with 16-bit global indices:
-                // [0]=ITER_NEXT [1-2]=offset [3]=SET_LOCAL [4]=slot [5]=POP 
-                // [6]=GET_GLOBAL [7-8]=idx16 [9]=... varies by pattern
-                if (iters_left > 50 && loop_body[0] == (uint8_t)OpCode::OP_ITER_NEXT) {
-                    uint8_t* p = loop_body;
-                    
-                    // Pattern 1: s (GLOBAL) += i (LOCAL) - Use arithmetic series formula!
-                    // [6]=GET_GLOBAL [7-8]=idx [9]=GET_LOCAL [10]=slot(i) [11]=ADD [12]=SET_GLOBAL [13-14]=idx [15]=POP
-                    if (p[3] == (uint8_t)OpCode::OP_SET_LOCAL && 
-                        p[5] == (uint8_t)OpCode::OP_POP &&
+                uint8_t* p = loop_body;
+                size_t body_len = (size_t)(ip - 3 - loop_body);
+                auto remaining_sum = [&](int64_t& count, int64_t& last) {
+                    count = (it.stop - it.cur + it.step - 1) / it.step;
+                    last = it.cur + (count - 1) * it.step;
+                    return count * (it.cur + last) / 2;
+                };
+
+                // [0]=ITER_NEXT [1-2]=offset [3]=SET_LOCAL [4]=slot(i) [5]=POP, then:
+                if (iters_left > 50 && p[0] == (uint8_t)OpCode::OP_ITER_NEXT &&
+                    p[3] == (uint8_t)OpCode::OP_SET_LOCAL && p[5] == (uint8_t)OpCode::OP_POP) {
+                    uint8_t loop_var = p[4];
+                    int64_t count = 0, last = 0;
+
+                    // Pattern 1: s (GLOBAL) += i
+                    // [6]=GET_GLOBAL [7-8]=s [9]=GET_LOCAL [10]=i [11]=ADD [12]=SET_GLOBAL [13-14]=s [15]=POP
+                    if (body_len == 16 &&
                         p[6] == (uint8_t)OpCode::OP_GET_GLOBAL &&
-                        p[9] == (uint8_t)OpCode::OP_GET_LOCAL &&
-                        p[10] == p[4] &&  // Same slot as loop variable
+                        p[9] == (uint8_t)OpCode::OP_GET_LOCAL && p[10] == loop_var &&
                         p[11] == (uint8_t)OpCode::OP_ADD &&
                         p[12] == (uint8_t)OpCode::OP_SET_GLOBAL &&
-                        p[15] == (uint8_t)OpCode::OP_POP) {
-                        
-                        //  High-performance O(1) ARITHMETIC SERIES FORMULA!
-                        uint16_t name_idx = p[7] | (p[8] << 8);
-                        Value& name_val = chunk->constants[name_idx];
-                        ObjString* name = intern_name(name_val.data.string);
-                        int64_t acc = as_int(globals[name]);
-                        
-                        int64_t start = it.cur;
-                        int64_t stop = it.stop;
-                        int64_t step = it.step;
-                        
-                        if (step == 1) {
-                            int64_t n = stop - start;
-                            int64_t sum = n * (start + stop - 1) / 2;
-                            acc += sum;
-                        } else if (step > 0) {
-                            int64_t n = (stop - start + step - 1) / step;
-                            int64_t last = start + (n - 1) * step;
-                            int64_t sum = n * (start + last) / 2;
-                            acc += sum;
-                        } else {
-                            for (int64_t i = start; i > stop; i += step) acc += i;
-                        }
-                        
-                        globals[name] = val_int(acc);
+                        p[13] == p[7] && p[14] == p[8] &&
+                        p[15] == (uint8_t)OpCode::OP_POP &&
+                        is_int(global_ref(p[7] | (p[8] << 8))) && !is_bool(global_ref(p[7] | (p[8] << 8)))) {
+                        uint64_t& acc = global_ref(p[7] | (p[8] << 8));
+                        acc = val_int(as_int(acc) + remaining_sum(count, last));
+                        slots[loop_var] = val_int(last);
                         it.cur = it.stop;
                     }
-                    // Pattern 2: s (LOCAL) += i (LOCAL) - Same slot pattern
-                    // [6]=GET_LOCAL [7]=slot(s) [8]=GET_LOCAL [9]=slot(i) [10]=ADD [11]=SET_LOCAL [12]=slot(s) [13]=POP
-                    else if (p[3] == (uint8_t)OpCode::OP_SET_LOCAL && 
-                             p[5] == (uint8_t)OpCode::OP_POP &&
-                             p[6] == (uint8_t)OpCode::OP_GET_LOCAL &&
-                             p[8] == (uint8_t)OpCode::OP_GET_LOCAL &&
-                             p[9] == p[4] &&  // Same slot as loop variable
-                             p[10] == (uint8_t)OpCode::OP_ADD &&
-                             p[11] == (uint8_t)OpCode::OP_SET_LOCAL &&
-                             p[12] == p[7] &&
-                             p[13] == (uint8_t)OpCode::OP_POP) {
-                        
-                        //  High-performance O(1) for local variables too!
-                        uint8_t slot_acc = p[7];
-                        int64_t acc = as_int(slots[slot_acc]);
-                        
-                        int64_t start = it.cur;
-                        int64_t stop = it.stop;
-                        int64_t step = it.step;
-                        
-                        if (step == 1) {
-                            int64_t n = stop - start;
-                            int64_t sum = n * (start + stop - 1) / 2;
-                            acc += sum;
-                        } else if (step > 0) {
-                            int64_t n = (stop - start + step - 1) / step;
-                            int64_t last = start + (n - 1) * step;
-                            int64_t sum = n * (start + last) / 2;
-                            acc += sum;
-                        } else {
-                            for (int64_t i = start; i > stop; i += step) acc += i;
-                        }
-                        
-                        slots[slot_acc] = val_int(acc);
+                    // Pattern 2: s (LOCAL) += i
+                    // [6]=GET_LOCAL [7]=s [8]=GET_LOCAL [9]=i [10]=ADD [11]=SET_LOCAL [12]=s [13]=POP
+                    // or, fused by the peephole pass:
+                    // [6]=ADD_LOCALS [7]=s [8]=i [9]=SET_LOCAL [10]=s [11]=POP
+                    else if (((body_len == 14 &&
+                               p[6] == (uint8_t)OpCode::OP_GET_LOCAL &&
+                               p[8] == (uint8_t)OpCode::OP_GET_LOCAL && p[9] == loop_var &&
+                               p[10] == (uint8_t)OpCode::OP_ADD &&
+                               p[11] == (uint8_t)OpCode::OP_SET_LOCAL && p[12] == p[7] &&
+                               p[13] == (uint8_t)OpCode::OP_POP) ||
+                              (body_len == 12 &&
+                               p[6] == (uint8_t)OpCode::OP_ADD_LOCALS && p[8] == loop_var &&
+                               p[9] == (uint8_t)OpCode::OP_SET_LOCAL && p[10] == p[7] &&
+                               p[11] == (uint8_t)OpCode::OP_POP)) &&
+                             p[7] != loop_var && is_int(slots[p[7]]) && !is_bool(slots[p[7]])) {
+                        uint64_t& acc = slots[p[7]];
+                        acc = val_int(as_int(acc) + remaining_sum(count, last));
+                        slots[loop_var] = val_int(last);
                         it.cur = it.stop;
                     }
-                    // Pattern 3: s += constant (counting loop with GLOBAL)
-                    // [6]=GET_GLOBAL [7-8]=idx [9]=CONST_INT [10]=val [11]=ADD [12]=SET_GLOBAL [13-14]=idx [15]=POP
-                    else if (p[3] == (uint8_t)OpCode::OP_SET_LOCAL && 
-                             p[5] == (uint8_t)OpCode::OP_POP &&
+                    // Pattern 3: s (GLOBAL) += constant
+                    // [6]=GET_GLOBAL [7-8]=s [9]=CONST_INT [10]=k [11]=ADD [12]=SET_GLOBAL [13-14]=s [15]=POP
+                    else if (body_len == 16 &&
                              p[6] == (uint8_t)OpCode::OP_GET_GLOBAL &&
                              p[9] == (uint8_t)OpCode::OP_CONST_INT &&
                              p[11] == (uint8_t)OpCode::OP_ADD &&
-                             p[12] == (uint8_t)OpCode::OP_SET_GLOBAL) {
-                        //  s += constant pattern - O(1)!
-                        uint16_t name_idx = p[7] | (p[8] << 8);
-                        Value& name_val = chunk->constants[name_idx];
-                        ObjString* name = intern_name(name_val.data.string);
-                        int64_t acc = as_int(globals[name]);
-                        int64_t constant = p[10];  // The constant being added
-                        int64_t n = (it.stop - it.cur + it.step - 1) / it.step;
-                        acc += constant * n;  // O(1)!
-                        globals[name] = val_int(acc);
+                             p[12] == (uint8_t)OpCode::OP_SET_GLOBAL &&
+                             p[13] == p[7] && p[14] == p[8] &&
+                             p[15] == (uint8_t)OpCode::OP_POP &&
+                             is_int(global_ref(p[7] | (p[8] << 8))) && !is_bool(global_ref(p[7] | (p[8] << 8)))) {
+                        uint64_t& acc = global_ref(p[7] | (p[8] << 8));
+                        remaining_sum(count, last);
+                        acc = val_int(as_int(acc) + (int64_t)p[10] * count);
+                        slots[loop_var] = val_int(last);
                         it.cur = it.stop;
                     }
                 }
             }
             
-            //  NESTED LOOP OPTIMIZATION: Detect inner loop in nested structure 
-            // Pattern: for i in range(N): for j in range(M): total += i * j
-            // This can be computed as: (sum of i) * (sum of j) = N*(N-1)/2 * M*(M-1)/2
-            if (iter_count >= 2) {
-                FastIter& outer = iterators[iter_count - 2];
-                FastIter& inner = iterators[iter_count - 1];
-                
-                // Both must be ranges with step 1
-                if (outer.step == 1 && inner.step == 1) {
-                    // Check if inner loop just finished (cur >= stop) and we're in outer loop
-                    // When inner finishes, we optimize the entire remaining outer iterations
-                    int64_t outer_remaining = outer.stop - outer.cur;
-                    int64_t inner_size = inner.stop;  // Assuming inner starts at 0
-                    
-                    // If substantial work remains, apply formula
-                    if (outer_remaining > 10 && inner_size > 10) {
-                        // For total += i * j pattern with both starting from 0:
-                        // sum_{i=cur}^{outer.stop-1} sum_{j=0}^{inner.stop-1} i*j
-                        // = sum_{i}(i) * sum_{j}(j) for remaining outer
-                        // = [(outer.stop-1)*outer.stop/2 - (cur-1)*cur/2] * [inner.stop*(inner.stop-1)/2]
-                        
-                        // Check bytecode pattern for i*j accumulation (simplified detection)
-                        uint8_t* p = ip - 2;  // Look back at loop body
-                        
-                        // Skip the pattern check for now - just apply when we detect nested iteration
-                        // This is aggressive but effective for the benchmark pattern
-                    }
-                }
-            }
-            
             ip -= off;
+            if (g_heap.should_collect()) gc_collect();  // Safepoint: loop back-edge
         } DISPATCH();
         
         // ===== FUNCTION CALLS (with INLINE CACHING + JIT acceleration!) =====
         DO_CALL: {
+            if (g_heap.should_collect()) gc_collect();  // Safepoint: callee and args are on the stack
             uint8_t argc = READ_BYTE();
             uint64_t callee = sp[-1 - argc];
             
             // ============================================================================
             // OOP: CLASS INSTANTIATION
-            // ============================================================================
-            // When calling a class, create an instance and call init()
-            if (is_class(callee)) {
-                ObjClass* klass = as_class(callee);
-                {
-                    std::unordered_set<std::string> missing_abstract;
-                    klass->collect_missing_abstract_methods(missing_abstract);
-                    if (klass->is_abstract || !missing_abstract.empty()) {
-                        if (!missing_abstract.empty()) {
-                            fprintf(stderr,
-                                    "Error: Cannot instantiate abstract class '%s' (missing '%s')\n",
-                                    klass->name->chars, missing_abstract.begin()->c_str());
-                        } else {
-                        runtime_errorf("Cannot instantiate abstract class '%s'", klass->name->chars);
-                    }
-                    }
-                }
+            // ============================================================================
+            // When calling a class, create an instance and call init()
+            if (is_class(callee)) {
+                ObjClass* klass = as_class(callee);
+                if (klass->needs_resolve()) klass->resolve();
+                if (!klass->instantiable) abstract_instantiation_error(klass);
                 ObjInstance* inst = ObjInstance::create(klass);
                 
                 // Replace class with instance on stack
                 sp[-1 - argc] = val_instance(inst);
                 
-                // Look for init method
-                uint64_t init_method = klass->find_method("init");
-                if (init_method != VAL_NONE) {
-                    ObjFunc* init_func = as_func(init_method);
+                // Call init method, if the class (or a parent) has one
+                if (ObjFunc* init_func = klass->init) {
                     
                     // Check arity
                     if (argc != init_func->arity) {
@@ -23597,6 +31505,14 @@ private:
                 }
             }
             
+            // Builtin module function used as a value (f <- fs.exists; f(p))
+            if (is_native(callee)) {
+                uint64_t result = call_native(as_native(callee), sp - argc, argc);
+                sp -= argc + 1;
+                PUSH(result);
+                DISPATCH();
+            }
+
             // ========================================================================
             //  INLINE CACHE: Monomorphic call site optimization
             // ========================================================================
@@ -23631,67 +31547,22 @@ private:
                 runtime_errorf("Invalid function object or missing chunk (func=%p)", (void*)func);
             }
             
-            // Get function name for JIT lookup (use C-string to avoid destructor issues)
-            const char* fname = func->name ? func->name->chars : "";
-            
-            // ============================================================================
-            //  REAL JIT: x86-64 NATIVE CODE COMPILATION 
-            // Compile hot functions to native x86-64 machine code
-            // Same algorithm, just compiled - this is REAL performance, not cheating!
-            // ============================================================================
-            
-            //  GUARD: If IC is monomorphic and hot, consider JIT compilation
-            if (ic.state == InlineCache::MONOMORPHIC && ic.hit_count > 50) {
-                // This call site is stable - good candidate for JIT
-                // (In production, we'd track per-function, not per-site)
-            }
-            
-            // JIT-compiled fib function - compiles on first call
-            if (fname[0] == 'f' && fname[1] == 'i' && fname[2] == 'b' && fname[3] == '\0' && argc == 1) {
-                if (g_jit_cache.has_jit("fib")) {
-                    JITCompiler::JITFunc jit_fn = g_jit_cache.get("fib");
-                    int64_t arg = as_int(sp[-1]);
-                    int64_t result = jit_fn(arg);
-                    sp -= argc + 1;
-                    PUSH(val_int(result));
-                    DISPATCH();
-                }
-                
-                // First call to fib - compile it immediately using global JIT!
-                JITCompiler::JITFunc native_fn = g_jit.compile_recursive_int(1, 1, 2);
-                if (native_fn) {
-                    g_jit_cache.store("fib", native_fn);
-                    int64_t arg = as_int(sp[-1]);
-                    int64_t result = native_fn(arg);
-                    sp -= argc + 1;
-                    PUSH(val_int(result));
-                    DISPATCH();
-                }
+#ifdef LEVYTHON_BASELINE_JIT
+            // Hot functions run as native code on this same frame layout
+            uint64_t jit_result = jit_enter(func, sp, argc, ip);
+            if (jit_result == JIT_DEOPT) {
+                // Native code handed its innermost frame back mid-function
+                ip = fp->ip;
+                slots = fp->slots;
+                chunk = fp->chunk;
+                DISPATCH();
             }
-            
-            // JIT-compiled is_prime function
-            if (fname[0] == 'i' && fname[1] == 's' && fname[2] == '_' && 
-                fname[3] == 'p' && fname[4] == 'r' && fname[5] == 'i' &&
-                fname[6] == 'm' && fname[7] == 'e' && fname[8] == '\0' && argc == 1) {
-                if (g_jit_cache.has_jit("is_prime")) {
-                    int64_t arg = as_int(sp[-1]);
-                    JITCompiler::JITFunc jit_fn = g_jit_cache.get("is_prime");
-                    int64_t result = jit_fn(arg);
-                    sp -= argc + 1;
-                    PUSH(result ? VAL_TRUE : VAL_FALSE);
-                    DISPATCH();
-                }
-                
-                JITCompiler::JITFunc jit_fn = g_jit.compile_is_prime();
-                if (jit_fn) {
-                    g_jit_cache.store("is_prime", jit_fn);
-                    int64_t arg = as_int(sp[-1]);
-                    int64_t result = jit_fn(arg);
-                    sp -= argc + 1;
-                    PUSH(result ? VAL_TRUE : VAL_FALSE);
-                    DISPATCH();
-                }
+            if (jit_result != JIT_UNHANDLED) {
+                sp -= argc;
+                sp[-1] = jit_result;
+                DISPATCH();
             }
+#endif
 
             // Fallback: interpreted execution
             fp->ip = ip;
@@ -23707,6 +31578,7 @@ private:
             fp->ip = func->chunk->code.data();
             fp->slots = sp - argc - 1;
             fp->name = func->name ? func->name->chars : "<anon>";
+            if (func->chunk->is_async) begin_coroutine(func);
             
             ip = fp->ip;
             slots = fp->slots;
@@ -23727,7 +31599,35 @@ private:
             }
             
             frame_count--;
-            if (frame_count == 0) return result;
+            if (frame_count == coro_base_frame) {
+                // A coroutine's first frame returned: it is done
+                finish_coroutine(result);
+                ip = fp->ip;
+                slots = fp->slots;
+                chunk = fp->chunk;
+                DISPATCH();
+            }
+            if (frame_count == 0) {
+                if (!coroutines_pending()) return result;
+                // Program finished with coroutines still suspended: run them
+                // to completion, then retry this RETURN
+                frame_count = 1;
+                uint8_t* return_ip = ip - 1;
+                PUSH(result);
+                if (run_coroutines(return_ip, -1)) {
+                    ip = fp->ip;
+                    slots = fp->slots;
+                    chunk = fp->chunk;
+                    DISPATCH();
+                }
+                if (coro_ready.empty() && async_bindings::g_async_live.load() <= 0) {
+                    sp--;
+                    frame_count = 0;
+                    return result;  // The rest wait on each other and can never finish
+                }
+                ip = return_ip;
+                DISPATCH();
+            }
             
             // Restore caller frame
             uint64_t* result_slot = fp->slots;
@@ -23766,6 +31666,15 @@ private:
               } else {
                 runtime_error("Map index must be a string");
               }
+            } else if (is_tensor(obj)) {
+                sp[-1] = tensor_index(as_tensor(obj), v_idx);
+            } else if (is_bytes(obj)) {
+                if (!is_int(v_idx) || is_bool(v_idx)) runtime_error("Bytes index must be an integer");
+                int64_t idx = as_int(v_idx);
+                ObjBytes* b = as_bytes(obj);
+                if (idx < 0) idx += static_cast<int64_t>(b->length);  // b[-1] is the last byte
+                if (idx < 0 || idx >= static_cast<int64_t>(b->length)) runtime_error("Bytes index out of range");
+                sp[-1] = val_int(b->data[idx]);
             } else {
                 runtime_error("Invalid index operation");
             }
@@ -23790,7 +31699,27 @@ private:
                     runtime_error("Map index must be a string");
                 }
                 ObjMap* map = as_map(obj);
-                map->data[as_string(idx_val)] = val;
+                auto it = map->data.find(as_string(idx_val));  // Updates skip interning
+                if (it != map->data.end()) it->second = val;
+                else map->data.emplace(map_key(as_string(idx_val)), val);
+                if (map->module) map->version++;
+            } else if (is_tensor(obj)) {
+                ObjTensor* t = as_tensor(obj);
+                if (t->ndim != 1) runtime_error("Tensor assignment needs a 1-D tensor; index rows first (t[i][j] <- v)");
+                if (!is_int(idx_val) || is_bool(idx_val)) runtime_error("Tensor index must be an integer");
+                int64_t idx = as_int(idx_val);
+                if (idx < 0 || idx >= t->shape[0]) runtime_error("Tensor index out of range");
+                tensor_store(t, t->offset + (size_t)(idx * t->strides[0]), val);
+            } else if (is_bytes(obj)) {
+                if (!is_int(idx_val) || is_bool(idx_val)) runtime_error("Bytes index must be an integer");
+                int64_t idx = as_int(idx_val);
+                ObjBytes* b = as_bytes(obj);
+                if (idx < 0) idx += static_cast<int64_t>(b->length);
+                if (idx < 0 || idx >= static_cast<int64_t>(b->length)) runtime_error("Bytes index out of range");
+                if (!is_int(val) || is_bool(val) || as_int(val) < 0 || as_int(val) > 255) {
+                    runtime_error("Bytes element must be an integer in 0..255");
+                }
+                b->data[idx] = static_cast<uint8_t>(as_int(val));
             } else {
                 runtime_error("Invalid index assignment");
             }
@@ -23802,6 +31731,7 @@ private:
             FastIter& it = iterators[iter_count++];
             it.obj = obj;
             it.idx = 0;
+            it.cur = 0;
             it.stop = 0;  // Default for lists
             it.step = 1;
             if (is_obj(obj) && obj_type(obj) == ObjType::RANGE) {
@@ -23809,71 +31739,6 @@ private:
                 it.cur = r->start;
                 it.stop = r->stop;
                 it.step = r->step;
-                
-                //  NESTED LOOP OPTIMIZATION 
-                // When initializing inner loop, check if we can optimize entire nested structure
-                if (iter_count >= 2 && r->start == 0 && r->step == 1) {
-                    FastIter& outer = iterators[iter_count - 2];
-                    // Check if outer is a simple range starting at 0
-                    // outer.cur will be 1 on first iteration (already incremented)
-                    if (outer.step == 1 && outer.cur <= 1) {
-                        // Look ahead for: total += i * j pattern
-                        // Scan bytecode for MUL followed by ADD
-                        uint8_t* scan = ip;
-                        bool found_mul = false, found_add = false;
-                        uint8_t add_slot = 0;
-                        bool is_local = false;
-                        
-                        for (int i = 0; i < 50 && scan[i] != (uint8_t)OpCode::OP_LOOP; i++) {
-                            if (scan[i] == (uint8_t)OpCode::OP_MUL) found_mul = true;
-                            if (scan[i] == (uint8_t)OpCode::OP_ADD && found_mul) {
-                                found_add = true;
-                                // Check what follows ADD
-                                if (scan[i+1] == (uint8_t)OpCode::OP_SET_LOCAL) {
-                                    is_local = true;
-                                    add_slot = scan[i+2];
-                                } else if (scan[i+1] == (uint8_t)OpCode::OP_SET_GLOBAL) {
-                                    is_local = false;
-                                    add_slot = scan[i+2];
-                                }
-                                break;
-                            }
-                        }
-                        
-                        if (found_mul && found_add && outer.stop > 5 && r->stop > 5) {
-                            //  FULL NESTED LOOP O(1) FORMULA! 
-                            // sum_{i=0}^{n-1} sum_{j=0}^{m-1} i*j = (n*(n-1)/2) * (m*(m-1)/2)
-                            int64_t n = outer.stop;
-                            int64_t m = r->stop;
-                            int64_t sum_i = n * (n - 1) / 2;
-                            int64_t sum_j = m * (m - 1) / 2;
-                            int64_t total = sum_i * sum_j;
-                            
-                            if (is_local) {
-                                slots[add_slot] = val_int(total);
-                            } else {
-                                Value& name_val = chunk->constants[add_slot];
-                                ObjString* name = intern_name(name_val.data.string);
-                                globals[name] = val_int(total);
-                            }
-                            
-                            // Skip to end of outer loop
-                            outer.cur = outer.stop;
-                            it.cur = it.stop;
-                            
-                            // Find end of nested loops (two OP_LOOP instructions)
-                            int loops_to_skip = 2;
-                            while (loops_to_skip > 0) {
-                                while (*ip != (uint8_t)OpCode::OP_LOOP) ip++;
-                                ip += 3;  // Skip LOOP + 2 bytes offset
-                                loops_to_skip--;
-                            }
-                            
-                            iter_count -= 2;
-                            DISPATCH();
-                        }
-                    }
-                }
             }
         } DISPATCH();
         
@@ -23901,19 +31766,21 @@ private:
                         
                         uint16_t set_idx = peek[10] | (peek[11] << 8);
                         
-                        if (get_idx == set_idx) {
+                        // Same slot, integer accumulator, and the statement is the whole loop body
+                        if (get_idx == set_idx &&
+                            peek[12] == (uint8_t)OpCode::OP_POP &&
+                            peek[13] == (uint8_t)OpCode::OP_LOOP &&
+                            get_idx < globals.size() && is_int(globals[get_idx]) && !is_bool(globals[get_idx])) {
                             //  DETECTED: total <- total + constant
                             int64_t constant = peek[7];  // The constant being added
                             int64_t remaining = it.stop - it.cur;
                             
-                            // Get the global variable
-                            Value& name_val = chunk->constants[get_idx];
-                            ObjString* name = intern_name(name_val.data.string);
-                            int64_t acc = as_int(globals[name]);
+                            int64_t acc = as_int(globals[get_idx]);
                             
                             //  INSTANT COMPUTATION!
                             acc += constant * remaining;
-                            globals[name] = val_int(acc);
+                            globals[get_idx] = val_int(acc);
+                            slots[peek[1]] = val_int(it.stop - 1);  // Loop variable ends where the loop would
                             
                             // Skip the entire loop
                             it.cur = it.stop;
@@ -23923,65 +31790,6 @@ private:
                         }
                     }
                 }
-                
-                //  NESTED LOOP COUNTING OPTIMIZATION 
-                // Detect: for i: for j: for k: total <- total + 1
-                // Compute: outer.count * middle.count * inner.count
-                // This triggers on the VERY FIRST iteration when all loop counters are at start
-                if (iter_count >= 3 && it.step == 1 && it.cur == 0) {
-                    FastIter& outer = iterators[iter_count - 3];
-                    FastIter& middle = iterators[iter_count - 2];
-                    
-                    // All must be fresh counting loops
-                    // At first inner ITER_NEXT: outer.cur=1, middle.cur=1 (both already incremented once)
-                    if (outer.step == 1 && middle.step == 1 &&
-                        outer.cur == 1 && middle.cur == 1) {
-                        
-                        uint8_t* peek = ip;
-                        
-                        // Check for counting pattern: SET_LOCAL, POP, GET_GLOBAL, CONST_INT, ADD, SET_GLOBAL
-                        if (peek[0] == (uint8_t)OpCode::OP_SET_LOCAL &&
-                            peek[2] == (uint8_t)OpCode::OP_POP &&
-                            peek[3] == (uint8_t)OpCode::OP_GET_GLOBAL &&
-                            peek[6] == (uint8_t)OpCode::OP_CONST_INT &&
-                            peek[8] == (uint8_t)OpCode::OP_ADD &&
-                            peek[9] == (uint8_t)OpCode::OP_SET_GLOBAL) {
-                            
-                            uint16_t get_idx = peek[4] | (peek[5] << 8);
-                            uint16_t set_idx = peek[10] | (peek[11] << 8);
-                            
-                            // Check if both indices point to the same variable name
-                            Value& get_val = chunk->constants[get_idx];
-                            Value& set_val = chunk->constants[set_idx];
-                            bool same_var = (get_idx == set_idx) ||
-                                           (get_val.type == ObjectType::STRING && 
-                                            set_val.type == ObjectType::STRING &&
-                                            get_val.data.string == set_val.data.string);
-                            
-                            if (same_var) {
-                                //  TRIPLE NESTED COUNTING DETECTED!
-                                int64_t constant = peek[7];
-                                int64_t total_count = outer.stop * middle.stop * it.stop * constant;
-                                
-                                ObjString* name = intern_name(get_val.data.string.c_str());
-                                int64_t acc = as_int(globals[name]);
-                                acc += total_count;
-                                globals[name] = val_int(acc);
-                                
-                                // Skip ALL loops by setting cur >= stop
-                                outer.cur = outer.stop;
-                                middle.cur = middle.stop;
-                                it.cur = it.stop;
-                                
-                                // Pop the inner iterator and jump to end of inner loop
-                                // The normal LOOP will handle the rest (terminate since cur >= stop)
-                                iter_count--;
-                                ip += off;  // Jump past inner loop body to inner LOOP
-                                DISPATCH();
-                            }
-                        }
-                    }
-                }
             }
             
             // Fast path: assume positive step range (99% of cases)
@@ -24000,6 +31808,22 @@ private:
                     iter_count--;
                     ip += off;
                 }
+            } else if (is_bytes(it.obj)) {
+                ObjBytes* b = as_bytes(it.obj);
+                if (it.idx < b->length) {
+                    PUSH(val_int(b->data[it.idx++]));
+                } else {
+                    iter_count--;
+                    ip += off;
+                }
+            } else if (is_reader(it.obj)) {
+                uint64_t line = reader_next_line(as_reader(it.obj));
+                if (line != VAL_NONE) {
+                    PUSH(line);
+                } else {
+                    iter_count--;
+                    ip += off;
+                }
             } else {
                 iter_count--;
                 ip += off;
@@ -24027,6 +31851,10 @@ private:
                         len = (r->start - r->stop - r->step - 1) / (-r->step);
                     }
                     sp[-1] = val_int(len);
+                } else if (obj_type(v) == ObjType::TENSOR) {
+                    sp[-1] = val_int(as_tensor(v)->shape[0]);
+                } else if (obj_type(v) == ObjType::BYTES) {
+                    sp[-1] = val_int((int64_t)as_bytes(v)->length);
                 }
             } else {
                 sp[-1] = val_int(0);  // Default for non-objects
@@ -24302,10 +32130,32 @@ private:
             uint64_t delim = POP();
             std::string result;
             if (is_obj(list) && obj_type(list) == ObjType::LIST) {
-                std::string d = as_string(delim)->str();
+                ObjString* d = as_string(delim);
                 ObjList* lst = as_list(list);
+                // All-string lists (the common case) are sized up front and
+                // copied into one allocation
+                uint64_t total = lst->count > 0 ? (uint64_t)d->length * (lst->count - 1) : 0;
+                bool all_strings = true;
+                for (size_t i = 0; i < lst->count && all_strings; i++) {
+                    uint64_t item = lst->items[i];
+                    if (is_obj(item) && obj_type(item) == ObjType::STRING) total += as_string(item)->length;
+                    else all_strings = false;
+                }
+                if (all_strings && total < UINT32_MAX) {
+                    ObjString* out = ObjString::alloc((uint32_t)total, (uint32_t)total);
+                    char* w = out->chars;
+                    for (size_t i = 0; i < lst->count; i++) {
+                        if (i > 0) { memcpy(w, d->chars, d->length); w += d->length; }
+                        ObjString* item = as_string(lst->items[i]);
+                        memcpy(w, item->chars, item->length);
+                        w += item->length;
+                    }
+                    out->rehash();
+                    PUSH(val_obj((Obj*)out));
+                    DISPATCH();
+                }
                 for (size_t i = 0; i < lst->count; i++) {
-                    if (i > 0) result += d;
+                    if (i > 0) result.append(d->chars, d->length);
                     result += val_to_string(lst->items[i]);
                 }
             }
@@ -24325,6 +32175,8 @@ private:
                 for (size_t i = 0; i < lst->count; i++) {
                     if (values_equal(lst->items[i], needle)) { found = true; break; }
                 }
+            } else if (is_bytes(haystack)) {
+                found = bytes_find(as_bytes(haystack), needle) >= 0;
             }
             PUSH(found ? VAL_TRUE : VAL_FALSE);
         } DISPATCH();
@@ -24343,6 +32195,8 @@ private:
                 for (size_t i = 0; i < lst->count; i++) {
                     if (values_equal(lst->items[i], needle)) { idx = i; break; }
                 }
+            } else if (is_bytes(haystack)) {
+                idx = bytes_find(as_bytes(haystack), needle);
             }
             PUSH(val_int(idx));
         } DISPATCH();
@@ -24485,7 +32339,12 @@ private:
                     case ObjType::STRING: PUSH(val_string("string")); break;
                     case ObjType::LIST: PUSH(val_string("list")); break;
                     case ObjType::FUNCTION: PUSH(val_string("function")); break;
+                    case ObjType::NATIVE: PUSH(val_string("function")); break;
+                    case ObjType::COROUTINE: PUSH(val_string("coroutine")); break;
                     case ObjType::RANGE: PUSH(val_string("range")); break;
+                    case ObjType::TENSOR: PUSH(val_string("tensor")); break;
+                    case ObjType::BYTES: PUSH(val_string("bytes")); break;
+                    case ObjType::READER: PUSH(val_string("reader")); break;
                     case ObjType::CLASS: PUSH(val_string("class")); break;
                     case ObjType::INSTANCE: {
                         ObjInstance* inst = as_instance(v);
@@ -24527,7 +32386,7 @@ private:
 
                 if (is_instance(obj)) {
                     ObjInstance* inst = as_instance(obj);
-                    if (inst->fields.find(attr_name) != inst->fields.end()) {
+                    if (inst->find_field(intern_name(attr_name))) {
                         result = true;
                     } else if (inst->klass->find_method(attr_name) != VAL_NONE) {
                         result = true;
@@ -24562,10 +32421,9 @@ private:
 
                 if (is_instance(obj)) {
                     ObjInstance* inst = as_instance(obj);
-                    auto it = inst->fields.find(attr_name);
-                    if (it != inst->fields.end()) {
+                    if (uint64_t* field = inst->find_field(intern_name(attr_name))) {
                         found = true;
-                        result = it->second;
+                        result = *field;
                     } else {
                         uint64_t method = inst->klass->find_method(attr_name);
                         if (method != VAL_NONE) {
@@ -24613,10 +32471,11 @@ private:
 
             std::string attr_name = as_string(attr_name_val)->str();
             if (is_instance(obj)) {
-                as_instance(obj)->fields[attr_name] = value;
+                as_instance(obj)->set_field(intern_name(attr_name), value);
             } else if (is_map(obj)) {
                 ObjMap* map = as_map(obj);
                 map->data[intern_name(attr_name)] = value;
+                if (map->module) map->version++;
             } else {
                 runtime_error("setattr() target must be instance or map");
             }
@@ -24907,7 +32766,7 @@ private:
                 ObjClass* klass = inst->klass;
                 
                 // Look up method in class hierarchy
-                uint64_t method = klass->find_method(method_name);
+                uint64_t method = cached_method(ip, klass, method_name);
                 if (method == VAL_NONE) {
                     runtime_errorf("Method '%s' not found in class '%s'",
                                    method_name.c_str(), klass->name->chars);
@@ -24938,251 +32797,69 @@ private:
             // Handle module map methods (e.g. http.get(...))
             if (is_map(obj)) {
                 ObjMap* map = as_map(obj);
-                if (map == ensure_http_module()) {
-                    try {
-                        {
-                            std::vector<Value> args_vec;
-                            args_vec.reserve(argc);
-                            for (uint8_t i = 0; i < argc; ++i) {
-                                args_vec.push_back(to_value(sp[-argc + i]));
-                            }
 
-                            Value result = call_http_builtin(method_name, args_vec);
-                            sp -= argc + 1;
-                            PUSH(from_value(result));
-                        }
-                    } catch (const std::exception& e) {
-                        runtime_error(e.what());
-                    }
+                // Builtin module functions: the resolved ObjNative is cached per
+                // call site and revalidated against the receiver map
+                NativeCallCache& nc = native_caches[site_cache_index(ip)];
+                if (nc.site == ip && nc.receiver == map && nc.version == map->version) {
+                    nc.hits++;
+                    uint64_t result = call_native(nc.target, sp - argc, argc);
+                    sp -= argc + 1;
+                    PUSH(result);
                     DISPATCH();
                 }
-                if (map == ensure_os_module()) {
-                    try {
-                        {
-                            std::vector<Value> args_vec;
-                            args_vec.reserve(argc);
-                            for (uint8_t i = 0; i < argc; ++i) {
-                                args_vec.push_back(to_value(sp[-argc + i]));
-                            }
 
-                            Value result = call_os_builtin(method_name, args_vec);
-                            sp -= argc + 1;
-                            PUSH(from_value(result));
-                        }
-                    } catch (const std::exception& e) {
-                        runtime_error(e.what());
+                nc.misses++;
+                auto member = map->data.find(intern_name(method_name));
+                if (member != map->data.end() && is_native(member->second)) {
+                    ObjNative* native = as_native(member->second);
+                    if (map->module) {
+                        nc.site = ip;
+                        nc.receiver = map;
+                        nc.target = native;
+                        nc.version = map->version;
                     }
+                    uint64_t result = call_native(native, sp - argc, argc);
+                    sp -= argc + 1;
+                    PUSH(result);
                     DISPATCH();
                 }
-                // OS.Hook submodule method calls
-                if (os_hooks_module_map && map == os_hooks_module_map) {
-                    try {
-                        std::vector<Value> args_vec; args_vec.reserve(argc);
-                        for (uint8_t i = 0; i < argc; ++i) args_vec.push_back(to_value(sp[-argc + i]));
-                        Value result = call_os_submodule_builtin("os_hooks_", method_name, args_vec);
-                        sp -= argc + 1; PUSH(from_value(result));
-                    } catch (const std::exception& e) { runtime_error(e.what()); }
-                    DISPATCH();
-                }
-                // OS.InputControl submodule method calls
-                if (os_inputcontrol_module_map && map == os_inputcontrol_module_map) {
-                    try {
-                        std::vector<Value> args_vec; args_vec.reserve(argc);
-                        for (uint8_t i = 0; i < argc; ++i) args_vec.push_back(to_value(sp[-argc + i]));
-                        Value result = call_os_submodule_builtin("os_inputcontrol_", method_name, args_vec);
-                        sp -= argc + 1; PUSH(from_value(result));
-                    } catch (const std::exception& e) { runtime_error(e.what()); }
-                    DISPATCH();
-                }
-                // OS.ProcessManager submodule method calls
-                if (os_processes_module_map && map == os_processes_module_map) {
-                    try {
-                        std::vector<Value> args_vec; args_vec.reserve(argc);
-                        for (uint8_t i = 0; i < argc; ++i) args_vec.push_back(to_value(sp[-argc + i]));
-                        Value result = call_os_submodule_builtin("os_processes_", method_name, args_vec);
-                        sp -= argc + 1; PUSH(from_value(result));
-                    } catch (const std::exception& e) { runtime_error(e.what()); }
-                    DISPATCH();
-                }
-                // OS.DisplayAccess submodule method calls
-                if (os_display_module_map && map == os_display_module_map) {
-                    try {
-                        std::vector<Value> args_vec; args_vec.reserve(argc);
-                        for (uint8_t i = 0; i < argc; ++i) args_vec.push_back(to_value(sp[-argc + i]));
-                        Value result = call_os_submodule_builtin("os_display_", method_name, args_vec);
-                        sp -= argc + 1; PUSH(from_value(result));
-                    } catch (const std::exception& e) { runtime_error(e.what()); }
-                    DISPATCH();
-                }
-                // OS.AudioControl submodule method calls
-                if (os_audio_module_map && map == os_audio_module_map) {
-                    try {
-                        std::vector<Value> args_vec; args_vec.reserve(argc);
-                        for (uint8_t i = 0; i < argc; ++i) args_vec.push_back(to_value(sp[-argc + i]));
-                        Value result = call_os_submodule_builtin("os_audio_", method_name, args_vec);
-                        sp -= argc + 1; PUSH(from_value(result));
-                    } catch (const std::exception& e) { runtime_error(e.what()); }
-                    DISPATCH();
-                }
-                // OS.PrivilegeEscalator submodule method calls
-                if (os_privileges_module_map && map == os_privileges_module_map) {
-                    try {
-                        std::vector<Value> args_vec; args_vec.reserve(argc);
-                        for (uint8_t i = 0; i < argc; ++i) args_vec.push_back(to_value(sp[-argc + i]));
-                        Value result = call_os_submodule_builtin("os_privileges_", method_name, args_vec);
-                        sp -= argc + 1; PUSH(from_value(result));
-                    } catch (const std::exception& e) { runtime_error(e.what()); }
-                    DISPATCH();
-                }
-                // OS.EventListener submodule method calls
-                if (os_events_module_map && map == os_events_module_map) {
-                    try {
-                        std::vector<Value> args_vec; args_vec.reserve(argc);
-                        for (uint8_t i = 0; i < argc; ++i) args_vec.push_back(to_value(sp[-argc + i]));
-                        Value result = call_os_submodule_builtin("os_events_", method_name, args_vec);
-                        sp -= argc + 1; PUSH(from_value(result));
-                    } catch (const std::exception& e) { runtime_error(e.what()); }
-                    DISPATCH();
-                }
-                // OS.PersistenceHandler submodule method calls
-                if (os_persistence_module_map && map == os_persistence_module_map) {
-                    try {
-                        std::vector<Value> args_vec; args_vec.reserve(argc);
-                        for (uint8_t i = 0; i < argc; ++i) args_vec.push_back(to_value(sp[-argc + i]));
-                        Value result = call_os_submodule_builtin("os_persistence_", method_name, args_vec);
-                        sp -= argc + 1; PUSH(from_value(result));
-                    } catch (const std::exception& e) { runtime_error(e.what()); }
-                    DISPATCH();
-                }
-                if (map == ensure_fs_module()) {
-                    try {
-                        std::vector<Value> args_vec; args_vec.reserve(argc);
-                        for (uint8_t i = 0; i < argc; ++i) args_vec.push_back(to_value(sp[-argc + i]));
-                        Value result = call_fs_builtin(method_name, args_vec);
-                        sp -= argc + 1; PUSH(from_value(result));
-                    } catch (const std::exception& e) { runtime_error(e.what()); }
-                    DISPATCH();
-                }
-                if (map == ensure_path_module()) {
-                    try {
-                        std::vector<Value> args_vec; args_vec.reserve(argc);
-                        for (uint8_t i = 0; i < argc; ++i) args_vec.push_back(to_value(sp[-argc + i]));
-                        Value result = call_path_builtin(method_name, args_vec);
-                        sp -= argc + 1; PUSH(from_value(result));
-                    } catch (const std::exception& e) { runtime_error(e.what()); }
-                    DISPATCH();
-                }
-                if (map == ensure_process_module()) {
-                    try {
-                        std::vector<Value> args_vec; args_vec.reserve(argc);
-                        for (uint8_t i = 0; i < argc; ++i) args_vec.push_back(to_value(sp[-argc + i]));
-                        Value result = call_process_builtin(method_name, args_vec);
-                        sp -= argc + 1; PUSH(from_value(result));
-                    } catch (const std::exception& e) { runtime_error(e.what()); }
-                    DISPATCH();
-                }
-                if (map == ensure_json_module()) {
-                    try {
-                        std::vector<Value> args_vec; args_vec.reserve(argc);
-                        for (uint8_t i = 0; i < argc; ++i) args_vec.push_back(to_value(sp[-argc + i]));
-                        Value result = call_json_builtin(method_name, args_vec);
-                        sp -= argc + 1; PUSH(from_value(result));
-                    } catch (const std::exception& e) { runtime_error(e.what()); }
-                    DISPATCH();
-                }
-                if (map == ensure_url_module()) {
-                    try {
-                        std::vector<Value> args_vec; args_vec.reserve(argc);
-                        for (uint8_t i = 0; i < argc; ++i) args_vec.push_back(to_value(sp[-argc + i]));
-                        Value result = call_url_builtin(method_name, args_vec);
-                        sp -= argc + 1; PUSH(from_value(result));
-                    } catch (const std::exception& e) { runtime_error(e.what()); }
-                    DISPATCH();
-                }
-                if (map == ensure_net_module()) {
-                    try {
-                        std::vector<Value> args_vec; args_vec.reserve(argc);
-                        for (uint8_t i = 0; i < argc; ++i) args_vec.push_back(to_value(sp[-argc + i]));
-                        Value result = call_net_builtin(method_name, args_vec);
-                        sp -= argc + 1; PUSH(from_value(result));
-                    } catch (const std::exception& e) { runtime_error(e.what()); }
-                    DISPATCH();
-                }
-                if (map == ensure_thread_module()) {
-                    try {
-                        std::vector<Value> args_vec; args_vec.reserve(argc);
-                        for (uint8_t i = 0; i < argc; ++i) args_vec.push_back(to_value(sp[-argc + i]));
-                        Value result = call_thread_builtin(method_name, args_vec);
-                        sp -= argc + 1; PUSH(from_value(result));
-                    } catch (const std::exception& e) { runtime_error(e.what()); }
-                    DISPATCH();
-                }
-                if (map == ensure_channel_module()) {
-                    try {
-                        std::vector<Value> args_vec; args_vec.reserve(argc);
-                        for (uint8_t i = 0; i < argc; ++i) args_vec.push_back(to_value(sp[-argc + i]));
-                        Value result = call_channel_builtin(method_name, args_vec);
-                        sp -= argc + 1; PUSH(from_value(result));
-                    } catch (const std::exception& e) { runtime_error(e.what()); }
-                    DISPATCH();
-                }
-                if (map == ensure_async_module()) {
-                    try {
-                        std::vector<Value> args_vec; args_vec.reserve(argc);
-                        for (uint8_t i = 0; i < argc; ++i) args_vec.push_back(to_value(sp[-argc + i]));
-                        Value result = call_async_builtin(method_name, args_vec);
-                        sp -= argc + 1; PUSH(from_value(result));
-                    } catch (const std::exception& e) { runtime_error(e.what()); }
-                    DISPATCH();
-                }
-                if (map == ensure_crypto_module()) {
-                    try {
-                        std::vector<Value> args_vec; args_vec.reserve(argc);
-                        for (uint8_t i = 0; i < argc; ++i) args_vec.push_back(to_value(sp[-argc + i]));
-                        Value result = call_crypto_builtin(method_name, args_vec);
-                        sp -= argc + 1; PUSH(from_value(result));
-                    } catch (const std::exception& e) { runtime_error(e.what()); }
-                    DISPATCH();
-                }
-                if (map == ensure_time_module()) {
-                    try {
-                        std::vector<Value> args_vec; args_vec.reserve(argc);
-                        for (uint8_t i = 0; i < argc; ++i) args_vec.push_back(to_value(sp[-argc + i]));
-                        Value result = call_time_builtin(method_name, args_vec);
-                        sp -= argc + 1; PUSH(from_value(result));
-                    } catch (const std::exception& e) { runtime_error(e.what()); }
-                    DISPATCH();
-                }
-                if (map == ensure_log_module()) {
-                    try {
-                        std::vector<Value> args_vec; args_vec.reserve(argc);
-                        for (uint8_t i = 0; i < argc; ++i) args_vec.push_back(to_value(sp[-argc + i]));
-                        Value result = call_log_builtin(method_name, args_vec);
-                        sp -= argc + 1; PUSH(from_value(result));
-                    } catch (const std::exception& e) { runtime_error(e.what()); }
-                    DISPATCH();
-                }
-                if (map == ensure_config_module()) {
-                    try {
-                        std::vector<Value> args_vec; args_vec.reserve(argc);
-                        for (uint8_t i = 0; i < argc; ++i) args_vec.push_back(to_value(sp[-argc + i]));
-                        Value result = call_config_builtin(method_name, args_vec);
-                        sp -= argc + 1; PUSH(from_value(result));
-                    } catch (const std::exception& e) { runtime_error(e.what()); }
-                    DISPATCH();
-                }
-                if (map == ensure_input_module()) {
-                    try {
-                        std::vector<Value> args_vec; args_vec.reserve(argc);
-                        for (uint8_t i = 0; i < argc; ++i) args_vec.push_back(to_value(sp[-argc + i]));
-                        Value result = call_input_builtin(method_name, args_vec);
-                        sp -= argc + 1; PUSH(from_value(result));
-                    } catch (const std::exception& e) { runtime_error(e.what()); }
+
+                // Functions stored in the map (exports of a .levy module)
+                if (member != map->data.end() && is_obj(member->second) &&
+                    obj_type(member->second) == ObjType::FUNCTION) {
+                    ObjFunc* func = as_func(member->second);
+                    sp[-1 - argc] = member->second;  // Function occupies slot 0
+
+                    fp->ip = ip;
+                    fp++;
+                    frame_count++;
+
+                    if (frame_count >= FRAMES_MAX - 1) {
+                        runtime_error("Stack overflow in method call");
+                    }
+
+                    fp->chunk = func->chunk;
+                    fp->ip = func->chunk->code.data();
+                    fp->slots = sp - argc - 1;
+                    fp->name = func->name ? func->name->chars : method_name.c_str();
+                    if (func->chunk->is_async) begin_coroutine(func);
+
+                    ip = fp->ip;
+                    slots = fp->slots;
+                    chunk = fp->chunk;
                     DISPATCH();
                 }
 
                 runtime_errorf("Unknown method '%s' on map", method_name.c_str());
             }
+
+            if (is_reader(obj)) {
+                uint64_t result = reader_method(as_reader(obj), method_name, sp - argc, argc);
+                sp -= argc + 1;
+                PUSH(result);
+                DISPATCH();
+            }
             
             // Handle file methods
             if (method_name == "write" && argc == 1) {
@@ -25248,15 +32925,30 @@ private:
             if (is_instance(obj)) {
                 ObjInstance* inst = as_instance(obj);
                 
-                // First check instance fields
-                auto it = inst->fields.find(prop_name);
-                if (it != inst->fields.end()) {
-                    PUSH(it->second);
+                // First check instance fields, via the site's shape cache
+                PropertyCache& pc = property_cache(ip);
+                for (uint8_t i = 0; i < pc.count; ++i) {
+                    if (pc.shapes[i] == inst->shape) {
+                        pc.hits++;
+                        PUSH(inst->slots[pc.slots[i]]);
+                        DISPATCH();
+                    }
+                }
+                pc.misses++;
+                ObjString* key = intern_name(prop_name);
+                int slot = inst->shape->lookup(key);
+                if (slot >= 0) {
+                    cache_property(pc, inst->shape, nullptr, (uint32_t)slot);
+                    PUSH(inst->slots[slot]);
+                    DISPATCH();
+                }
+                if (uint64_t* field = inst->find_field(key)) {
+                    PUSH(*field);
                     DISPATCH();
                 }
                 
                 // Then check methods in class
-                uint64_t method = inst->klass->find_method(prop_name);
+                uint64_t method = cached_method(ip, inst->klass, prop_name);
                 if (method != VAL_NONE) {
                     // Return bound method (for now, just the function - caller handles binding)
                     PUSH(method);
@@ -25287,16 +32979,17 @@ private:
         DO_BUILD_MAP: {
             uint8_t n = READ_BYTE();  // Number of key-value pairs
             ObjMap* map = ObjMap::create();
+            map->data.reserve(n);
 
-            // Pop in reverse: ..., key1, value1, key2, value2, ...
-            for (int i = 0; i < n; ++i) {
-                uint64_t value = POP();
-                uint64_t key = POP();
-                if (!is_obj(key) || obj_type(key) != ObjType::STRING) {
+            // Stack holds ..., key1, value1, key2, value2; insert in source order
+            uint64_t* pair = sp - 2 * n;
+            for (int i = 0; i < n; ++i, pair += 2) {
+                if (!is_obj(pair[0]) || obj_type(pair[0]) != ObjType::STRING) {
                     runtime_error("Map keys must be strings");
                 }
-                map->data[as_string(key)] = value;
+                map->data[map_key(as_string(pair[0]))] = pair[1];
             }
+            sp -= 2 * n;
             PUSH(val_map(map));
         } DISPATCH();
         
@@ -25317,16 +33010,15 @@ private:
             // Check for parent class
             uint8_t has_parent = READ_BYTE();
             if (has_parent) {
-                uint16_t parent_name_idx = READ_SHORT();
-                const Value& parent_name_val = chunk->constants[parent_name_idx];
-                ObjString* parent_name = intern_name(parent_name_val.data.string);
-                
-                uint64_t parent_val = globals[parent_name];
+                uint16_t parent_slot = READ_SHORT();
+                uint64_t parent_val = parent_slot < globals.size() ? globals[parent_slot] : VAL_UNDEFINED;
                 if (!is_class(parent_val)) {
-                    runtime_errorf("Parent '%s' is not a class", parent_name->chars);
+                    runtime_errorf("Parent '%s' is not a class", g_global_slots.name_of(parent_slot)->chars);
                 }
                 klass->parent = as_class(parent_val);
             }
+            class_epoch++;
+            g_class_version++;
             
             // Push class onto stack (will be stored by DEFINE_GLOBAL)
             PUSH(class_ptr);
@@ -25342,18 +33034,8 @@ private:
             }
             
             ObjClass* klass = as_class(class_val);
-            {
-                std::unordered_set<std::string> missing_abstract;
-                klass->collect_missing_abstract_methods(missing_abstract);
-                if (klass->is_abstract || !missing_abstract.empty()) {
-                    if (!missing_abstract.empty()) {
-                        runtime_errorf("Cannot instantiate abstract class '%s' (missing '%s')",
-                                       klass->name->chars, missing_abstract.begin()->c_str());
-                    } else {
-                        runtime_errorf("Cannot instantiate abstract class '%s'", klass->name->chars);
-                    }
-                }
-            }
+            if (klass->needs_resolve()) klass->resolve();
+            if (!klass->instantiable) abstract_instantiation_error(klass);
             ObjInstance* inst = ObjInstance::create(klass);
             PUSH(val_instance(inst));
         } DISPATCH();
@@ -25374,7 +33056,31 @@ private:
             }
             
             ObjInstance* inst = as_instance(obj);
-            inst->fields[prop_name] = value;
+            PropertyCache& pc = property_cache(ip);
+            for (uint8_t i = 0; i < pc.count; ++i) {
+                if (pc.shapes[i] != inst->shape) continue;
+                if (pc.next[i]) {
+                    // Cached transition: the field is new to this shape
+                    inst->slots.push_back(value);
+                    inst->shape = pc.next[i];
+                    g_heap.account(sizeof(uint64_t));
+                } else {
+                    inst->slots[pc.slots[i]] = value;
+                }
+                pc.hits++;
+                sp[-1] = value;
+                DISPATCH();
+            }
+            pc.misses++;
+            Shape* before = inst->shape;
+            ObjString* key = intern_name(prop_name);
+            int slot = before->lookup(key);
+            inst->set_field(key, value);
+            if (slot >= 0) {
+                cache_property(pc, before, nullptr, (uint32_t)slot);
+            } else if (inst->shape != before) {
+                cache_property(pc, before, inst->shape, (uint32_t)before->keys.size());
+            }
             
             // Replace instance with value on stack (assignment returns value)
             sp[-1] = value;
@@ -25406,7 +33112,7 @@ private:
             }
             
             ObjInstance* inst = as_instance(receiver);
-            uint64_t method = inst->klass->find_method(method_name);
+            uint64_t method = cached_method(ip, inst->klass, method_name);
             
             if (method == VAL_NONE) {
                 runtime_errorf("Undefined method '%s'", method_name.c_str());
@@ -25451,7 +33157,7 @@ private:
                 runtime_error("Class has no parent");
             }
             
-            uint64_t method = parent->find_method(method_name);
+            uint64_t method = cached_method(ip, parent, method_name);
             if (method == VAL_NONE) {
                 runtime_errorf("Parent has no method '%s'", method_name.c_str());
             }
@@ -25553,8 +33259,7 @@ private:
             
             // Native C++ vector allocation!
             ObjList* list = ObjList::create();
-            list->items = (uint64_t*)realloc(list->items, (size_t)n * sizeof(uint64_t));
-            list->capacity = n;
+            list->reserve((size_t)n);
             list->count = n;
             
             // Fill at native speed
@@ -25704,112 +33409,251 @@ private:
             }
 
             const std::string& module_name = module_name_val.data.string;
-            ObjString* module_key = intern_name(module_name);
 
-            auto existing = globals.find(module_key);
-            if (existing != globals.end()) {
-                PUSH(existing->second);
+            // Local modules (.levy first, then .ly) shadow built-in ones. The
+            // working directory wins; the running script's directory is next.
+            // They are cached by resolved path, so same-named files in two
+            // directories stay separate modules.
+            fs::path module_path = module_name + ".levy";
+            if (!fs::exists(module_path)) module_path = module_name + ".ly";
+            if (!fs::exists(module_path) && !g_script_dir.empty()) {
+                module_path = g_script_dir / (module_name + ".levy");
+                if (!fs::exists(module_path)) module_path = g_script_dir / (module_name + ".ly");
+            }
+            bool local = fs::exists(module_path);
+            std::string resolved = local ? fs::weakly_canonical(module_path).string() : std::string();
+            ObjString* module_key = intern_name(local ? resolved : module_name);
+
+            auto cached = modules.find(module_key);
+            if (cached != modules.end()) {
+                if (cached->second == VAL_UNDEFINED) {
+                    runtime_errorf("Circular import of module '%s'", module_name.c_str());
+                }
+                PUSH(cached->second);
+                DISPATCH();
+            }
+
+            if (local) {
+                std::shared_ptr<Chunk>& module_chunk = module_chunks[resolved];
+                if (!module_chunk) {
+                    std::ifstream file(module_path);
+                    if (!file.is_open()) {
+                        runtime_errorf("Could not open module: %s", module_name.c_str());
+                    }
+                    std::stringstream buffer;
+                    buffer << file.rdbuf();
+                    // Compiled under its path: module globals and the exports
+                    // entry are then per file, not per import name
+                    PermanentAllocScope permanent;
+                    module_chunk = bytecode_cache::compile(buffer.str(), resolved);
+                }
+                modules[module_key] = VAL_UNDEFINED;
+
+                // Run the module body as a call frame; its OP_MODULE_EXPORTS
+                // result lands where the import expression expects it
+                fp->ip = ip;
+                fp++;
+                frame_count++;
+                if (frame_count >= FRAMES_MAX - 1) {
+                    runtime_errorf("Stack overflow! Max frames: %zu", FRAMES_MAX);
+                }
+                fp->chunk = module_chunk.get();
+                fp->ip = module_chunk->code.data();
+                fp->slots = sp;
+                fp->name = intern_name(module_name)->chars;
+
+                ip = fp->ip;
+                slots = fp->slots;
+                chunk = fp->chunk;
                 DISPATCH();
             }
 
             if (module_name == "http") {
                 uint64_t module_val = val_map(ensure_http_module());
-                globals[module_key] = module_val;
+                modules[module_key] = module_val;
                 PUSH(module_val);
                 DISPATCH();
             }
             if (module_name == "os") {
                 uint64_t module_val = val_map(ensure_os_module());
-                globals[module_key] = module_val;
+                modules[module_key] = module_val;
                 PUSH(module_val);
                 DISPATCH();
             }
             if (module_name == "fs") {
                 uint64_t module_val = val_map(ensure_fs_module());
-                globals[module_key] = module_val;
+                modules[module_key] = module_val;
                 PUSH(module_val);
                 DISPATCH();
             }
             if (module_name == "path") {
                 uint64_t module_val = val_map(ensure_path_module());
-                globals[module_key] = module_val;
+                modules[module_key] = module_val;
                 PUSH(module_val);
                 DISPATCH();
             }
             if (module_name == "process") {
                 uint64_t module_val = val_map(ensure_process_module());
-                globals[module_key] = module_val;
+                modules[module_key] = module_val;
                 PUSH(module_val);
                 DISPATCH();
             }
             if (module_name == "json") {
                 uint64_t module_val = val_map(ensure_json_module());
-                globals[module_key] = module_val;
+                modules[module_key] = module_val;
                 PUSH(module_val);
                 DISPATCH();
             }
             if (module_name == "url") {
                 uint64_t module_val = val_map(ensure_url_module());
-                globals[module_key] = module_val;
+                modules[module_key] = module_val;
                 PUSH(module_val);
                 DISPATCH();
             }
             if (module_name == "net") {
                 uint64_t module_val = val_map(ensure_net_module());
-                globals[module_key] = module_val;
+                modules[module_key] = module_val;
                 PUSH(module_val);
                 DISPATCH();
             }
             if (module_name == "thread") {
                 uint64_t module_val = val_map(ensure_thread_module());
-                globals[module_key] = module_val;
+                modules[module_key] = module_val;
                 PUSH(module_val);
                 DISPATCH();
             }
             if (module_name == "channel") {
                 uint64_t module_val = val_map(ensure_channel_module());
-                globals[module_key] = module_val;
+                modules[module_key] = module_val;
                 PUSH(module_val);
                 DISPATCH();
             }
             if (module_name == "async") {
                 uint64_t module_val = val_map(ensure_async_module());
-                globals[module_key] = module_val;
+                modules[module_key] = module_val;
                 PUSH(module_val);
                 DISPATCH();
             }
             if (module_name == "crypto") {
                 uint64_t module_val = val_map(ensure_crypto_module());
-                globals[module_key] = module_val;
+                modules[module_key] = module_val;
                 PUSH(module_val);
                 DISPATCH();
             }
             if (module_name == "datetime") {
                 uint64_t module_val = val_map(ensure_time_module());
-                globals[module_key] = module_val;
+                modules[module_key] = module_val;
                 PUSH(module_val);
                 DISPATCH();
             }
             if (module_name == "log") {
                 uint64_t module_val = val_map(ensure_log_module());
-                globals[module_key] = module_val;
+                modules[module_key] = module_val;
                 PUSH(module_val);
                 DISPATCH();
             }
             if (module_name == "config") {
                 uint64_t module_val = val_map(ensure_config_module());
-                globals[module_key] = module_val;
+                modules[module_key] = module_val;
                 PUSH(module_val);
                 DISPATCH();
             }
-            if (module_name == "input") {
-                uint64_t module_val = val_map(ensure_input_module());
-                globals[module_key] = module_val;
-                PUSH(module_val);
-                DISPATCH();
+            if (module_name == "input") {
+                uint64_t module_val = val_map(ensure_input_module());
+                modules[module_key] = module_val;
+                PUSH(module_val);
+                DISPATCH();
+            }
+            if (module_name == "gc") {
+                uint64_t module_val = val_map(ensure_gc_module());
+                modules[module_key] = module_val;
+                PUSH(module_val);
+                DISPATCH();
+            }
+
+            runtime_errorf("Module not found: %s", module_name.c_str());
+        } DISPATCH();
+
+        DO_MODULE_EXPORTS: {
+            uint16_t name_idx = READ_SHORT();
+            ObjMap* exports = ObjMap::create();
+            exports->module = true;
+            for (const auto& entry : chunk->module_exports) {
+                uint64_t val = entry.second < globals.size() ? globals[entry.second] : VAL_UNDEFINED;
+                if (val != VAL_UNDEFINED) exports->data[entry.first] = seal_string(val);
+            }
+            uint64_t module_val = val_map(exports);
+            modules[intern_name(chunk->constants[name_idx].data.string)] = module_val;
+            PUSH(module_val);
+        } DISPATCH();
+
+        DO_AWAIT: {
+            // await(target, timeout_ms?). Inside a coroutine this suspends it
+            // until the target completes; elsewhere it runs other coroutines
+            // and the async reactor until then.
+            uint8_t argc = READ_BYTE();
+            uint8_t* await_ip = ip - 2;
+            uint64_t target = sp[-(ptrdiff_t)argc];
+            long timeout_ms = -1;
+            if (argc >= 2) {
+                uint64_t t = sp[-1];
+                if (is_int(t) && !is_bool(t)) timeout_ms = (long)as_int(t);
+                else if (is_number(t)) timeout_ms = (long)as_number(t);
+            }
+            uint64_t value;
+            if (await_ready(target, value)) {
+                if (coro_runs.empty()) main_await_ip = nullptr;
+                else clear_await_deadline(coro_runs.back().coro);
+                sp -= argc;
+                PUSH(value);
+                DISPATCH();
+            }
+            auto now = std::chrono::steady_clock::now();
+            if (!coro_runs.empty()) {
+                ObjCoroutine* self = coro_runs.back().coro;
+                if (self->has_deadline) {
+                    if (now >= self->deadline) runtime_error("async.await: timeout");
+                } else if (timeout_ms >= 0) {
+                    // A private timer task wakes us to report the timeout
+                    self->has_deadline = true;
+                    self->deadline = now + std::chrono::milliseconds(timeout_ms);
+                    self->deadline_timer = async_bindings::start_timer(timeout_ms);
+                    wait_on_task(self, self->deadline_timer);
+                }
+                if (is_coroutine(target)) as_coroutine(target)->waiters.push_back(self);
+                else wait_on_task(self, as_int(target));
+                fp->ip = await_ip;  // Re-run this await when resumed
+                suspend_coroutine();
+                ip = fp->ip;
+                slots = fp->slots;
+                chunk = fp->chunk;
+                DISPATCH();
+            }
+
+            int wait_ms = -1;
+            if (main_await_ip != await_ip) {
+                main_await_ip = await_ip;
+                main_await_deadline = now + std::chrono::milliseconds(std::max(0L, timeout_ms));
+            }
+            if (timeout_ms >= 0) {
+                if (now >= main_await_deadline) {
+                    main_await_ip = nullptr;
+                    runtime_error("async.await: timeout");
+                }
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(main_await_deadline - now).count();
+                wait_ms = static_cast<int>(std::min<long long>(left + 1, INT32_MAX));
+            }
+            if (run_coroutines(await_ip, wait_ms)) {
+                ip = fp->ip;
+                slots = fp->slots;
+                chunk = fp->chunk;
+                DISPATCH();
+            }
+            if (is_coroutine(target) && coro_ready.empty() && async_bindings::g_async_live.load() <= 0) {
+                main_await_ip = nullptr;
+                runtime_error("await: coroutine '" + as_coroutine(target)->name->str() + "' can never complete");
             }
-
-            runtime_errorf("Module not found: %s", module_name.c_str());
+            ip = await_ip;
         } DISPATCH();
         
         // ============================================================================
@@ -25936,132 +33780,101 @@ private:
         
         DO_TENSOR_CREATE: {
             uint8_t argc = READ_BYTE();
-            // Pop shape dimensions
-            std::vector<long> shape;
-            long total = 1;
-            for (int i = argc - 1; i >= 0; i--) {
-                uint64_t dim = sp[-1 - i];
-                long d = is_int(dim) ? as_int(dim) : static_cast<long>(as_number(dim));
-                shape.push_back(d);
-                total *= d;
+            int64_t shape[ObjTensor::MAX_DIMS];
+            DType dtype = DType::F64;
+            int ndim = tensor_dims_args(sp - argc, argc, shape, "tensor", &dtype);
+            for (int i = 0; i < ndim; i++) {
+                if (shape[i] < 0) runtime_error("tensor() dimensions must be non-negative");
             }
             sp -= argc;
-            
-            // Create tensor as a list
-            ObjList* data = new ObjList();
-            data->count = static_cast<size_t>(total);
-            data->items = new uint64_t[data->count];
-            for (size_t i = 0; i < data->count; i++) {
-                data->items[i] = val_number(0.0);
-            }
-            PUSH(val_list(data));
+            PUSH(val_obj(ObjTensor::create(dtype, shape, ndim)));
         } DISPATCH();
-        
+
         DO_TENSOR_ADD: {
             uint64_t b = POP();
-            uint64_t a = POP();
-            ObjList* la = as_list(a);
-            ObjList* lb = as_list(b);
-            
-            ObjList* result = new ObjList();
-            result->count = la->count;
-            result->items = new uint64_t[result->count];
-            
-            for (size_t i = 0; i < result->count && i < lb->count; i++) {
-                double va = is_int(la->items[i]) ? (double)as_int(la->items[i]) : as_number(la->items[i]);
-                double vb = is_int(lb->items[i]) ? (double)as_int(lb->items[i]) : as_number(lb->items[i]);
-                result->items[i] = val_number(va + vb);
-            }
-            PUSH(val_list(result));
+            sp[-1] = tensor_binary(tensor_kernels::BinOp::ADD, sp[-1], b, "tensor_add");
         } DISPATCH();
-        
+
         DO_TENSOR_MUL: {
             uint64_t b = POP();
-            uint64_t a = POP();
-            ObjList* la = as_list(a);
-            ObjList* lb = as_list(b);
-            
-            ObjList* result = new ObjList();
-            result->count = la->count;
-            result->items = new uint64_t[result->count];
-            
-            for (size_t i = 0; i < result->count && i < lb->count; i++) {
-                double va = is_int(la->items[i]) ? (double)as_int(la->items[i]) : as_number(la->items[i]);
-                double vb = is_int(lb->items[i]) ? (double)as_int(lb->items[i]) : as_number(lb->items[i]);
-                result->items[i] = val_number(va * vb);
-            }
-            PUSH(val_list(result));
+            sp[-1] = tensor_binary(tensor_kernels::BinOp::MUL, sp[-1], b, "tensor_mul");
         } DISPATCH();
-        
+
         DO_TENSOR_MATMUL: {
-            // For now, just element-wise multiply (full matmul needs shape info)
             uint64_t b = POP();
-            uint64_t a = POP();
-            ObjList* la = as_list(a);
-            ObjList* lb = as_list(b);
-            
-            ObjList* result = new ObjList();
-            result->count = la->count;
-            result->items = new uint64_t[result->count];
-            
-            for (size_t i = 0; i < result->count && i < lb->count; i++) {
-                double va = is_int(la->items[i]) ? (double)as_int(la->items[i]) : as_number(la->items[i]);
-                double vb = is_int(lb->items[i]) ? (double)as_int(lb->items[i]) : as_number(lb->items[i]);
-                result->items[i] = val_number(va * vb);
-            }
-            PUSH(val_list(result));
+            sp[-1] = tensor_matmul(sp[-1], b);
         } DISPATCH();
-        
+
         DO_TENSOR_DOT: {
             uint64_t b = POP();
-            uint64_t a = POP();
-            ObjList* la = as_list(a);
-            ObjList* lb = as_list(b);
-            
-            double sum = 0.0;
-            size_t n = std::min(la->count, lb->count);
-            for (size_t i = 0; i < n; i++) {
-                double va = is_int(la->items[i]) ? (double)as_int(la->items[i]) : as_number(la->items[i]);
-                double vb = is_int(lb->items[i]) ? (double)as_int(lb->items[i]) : as_number(lb->items[i]);
-                sum += va * vb;
-            }
-            PUSH(val_number(sum));
+            sp[-1] = tensor_dot(sp[-1], b);
         } DISPATCH();
-        
+
         DO_TENSOR_SUM: {
-            uint64_t a = POP();
-            ObjList* la = as_list(a);
-            
-            double sum = 0.0;
-            for (size_t i = 0; i < la->count; i++) {
-                if (is_int(la->items[i])) sum += (double)as_int(la->items[i]);
-                else sum += as_number(la->items[i]);
-            }
-            PUSH(val_number(sum));
+            sp[-1] = tensor_sum(sp[-1], false);
         } DISPATCH();
-        
+
         DO_TENSOR_MEAN: {
-            uint64_t a = POP();
-            ObjList* la = as_list(a);
-            
-            double sum = 0.0;
-            for (size_t i = 0; i < la->count; i++) {
-                if (is_int(la->items[i])) sum += (double)as_int(la->items[i]);
-                else sum += as_number(la->items[i]);
-            }
-            PUSH(val_number(la->count > 0 ? sum / la->count : 0.0));
+            sp[-1] = tensor_sum(sp[-1], true);
         } DISPATCH();
-        
+
         DO_TENSOR_RESHAPE: {
-            // Just pass through for now - reshape is a no-op for flat lists
-            // In a full implementation, this would change the shape metadata
-            DISPATCH();
-        }
-        
+            uint8_t argc = READ_BYTE();
+            uint64_t result = tensor_reshape(sp - argc, argc);
+            sp -= argc;
+            PUSH(result);
+        } DISPATCH();
+
         DO_TENSOR_TRANSPOSE: {
-            // For 1D vectors, this is a no-op
-            DISPATCH();
-        }
+            sp[-1] = tensor_transpose(sp[-1]);
+        } DISPATCH();
+
+        DO_TENSOR_FROM: {
+            uint8_t argc = READ_BYTE();
+            bool has_dtype = argc > 1;
+            DType dtype = has_dtype ? tensor_dtype_arg(sp[-1]) : DType::F64;
+            sp -= argc - 1;
+            sp[-1] = val_obj(tensor_from_list(sp[-1], has_dtype, dtype));
+        } DISPATCH();
+
+        DO_TENSOR_TOLIST: {
+            if (!is_tensor(sp[-1])) runtime_error("tensor_list() expects a tensor");
+            ObjTensor* t = as_tensor(sp[-1]);
+            sp[-1] = tensor_to_list(t, 0, t->offset);
+        } DISPATCH();
+
+        DO_TENSOR_SHAPE: {
+            if (!is_tensor(sp[-1])) runtime_error("tensor_shape() expects a tensor");
+            ObjTensor* t = as_tensor(sp[-1]);
+            ObjList* shape = ObjList::create();
+            for (int i = 0; i < t->ndim; i++) shape->push(val_int(t->shape[i]));
+            sp[-1] = val_list(shape);
+        } DISPATCH();
+
+        DO_BYTES_NEW: {
+            uint8_t argc = READ_BYTE();
+            if (argc == 0) { PUSH(val_obj((Obj*)ObjBytes::create(0))); DISPATCH(); }
+            sp[-1] = val_obj((Obj*)bytes_from(sp[-1]));
+        } DISPATCH();
+
+        DO_BYTES_SLICE: {
+            uint8_t argc = READ_BYTE();
+            uint64_t* args = sp - argc;
+            if (!is_bytes(args[0])) runtime_error("bytes_slice() expects bytes");
+            ObjBytes* b = as_bytes(args[0]);
+            int64_t len = (int64_t)b->length;
+            int64_t bounds[2] = {0, len};
+            for (uint8_t i = 1; i < argc; i++) {
+                if (!is_int(args[i]) || is_bool(args[i])) runtime_error("bytes_slice() bounds must be integers");
+                int64_t at = as_int(args[i]);
+                if (at < 0) at += len;  // Negative bounds count from the end
+                bounds[i - 1] = std::min(std::max(at, (int64_t)0), len);
+            }
+            size_t start = (size_t)bounds[0];
+            size_t count = bounds[1] > bounds[0] ? (size_t)(bounds[1] - bounds[0]) : 0;
+            sp -= argc - 1;
+            sp[-1] = val_obj((Obj*)ObjBytes::view(b, start, count));
+        } DISPATCH();
         
         // ============================================================================
         //  FUTURE-PROOF: SIMD/VECTORIZATION PRIMITIVES 
@@ -26069,101 +33882,64 @@ private:
         
         DO_SIMD_ADD_F32X4: {
             uint64_t b = POP();
-            uint64_t a = POP();
-            ObjList* la = as_list(a);
-            ObjList* lb = as_list(b);
-            
-            ObjList* result = new ObjList();
-            result->count = la->count;
-            result->items = new uint64_t[result->count];
-            
-            // Vectorizable loop - compiler can auto-vectorize with -O3 -march=native
-            for (size_t i = 0; i < result->count && i < lb->count; i++) {
-                float va = is_int(la->items[i]) ? (float)as_int(la->items[i]) : (float)as_number(la->items[i]);
-                float vb = is_int(lb->items[i]) ? (float)as_int(lb->items[i]) : (float)as_number(lb->items[i]);
-                result->items[i] = val_number(static_cast<double>(va + vb));
-            }
-            PUSH(val_list(result));
+            sp[-1] = simd_list_binary(tensor_kernels::BinOp::ADD, DType::F32, sp[-1], b, "simd_add_f32");
         } DISPATCH();
         
         DO_SIMD_MUL_F32X4: {
             uint64_t b = POP();
-            uint64_t a = POP();
-            ObjList* la = as_list(a);
-            ObjList* lb = as_list(b);
-            
-            ObjList* result = new ObjList();
-            result->count = la->count;
-            result->items = new uint64_t[result->count];
-            
-            for (size_t i = 0; i < result->count && i < lb->count; i++) {
-                float va = is_int(la->items[i]) ? (float)as_int(la->items[i]) : (float)as_number(la->items[i]);
-                float vb = is_int(lb->items[i]) ? (float)as_int(lb->items[i]) : (float)as_number(lb->items[i]);
-                result->items[i] = val_number(static_cast<double>(va * vb));
-            }
-            PUSH(val_list(result));
+            sp[-1] = simd_list_binary(tensor_kernels::BinOp::MUL, DType::F32, sp[-1], b, "simd_mul_f32");
         } DISPATCH();
         
         DO_SIMD_ADD_F64X2: {
             uint64_t b = POP();
-            uint64_t a = POP();
-            ObjList* la = as_list(a);
-            ObjList* lb = as_list(b);
-            
-            ObjList* result = new ObjList();
-            result->count = la->count;
-            result->items = new uint64_t[result->count];
-            
-            for (size_t i = 0; i < result->count && i < lb->count; i++) {
-                double va = is_int(la->items[i]) ? (double)as_int(la->items[i]) : as_number(la->items[i]);
-                double vb = is_int(lb->items[i]) ? (double)as_int(lb->items[i]) : as_number(lb->items[i]);
-                result->items[i] = val_number(va + vb);
-            }
-            PUSH(val_list(result));
+            sp[-1] = simd_list_binary(tensor_kernels::BinOp::ADD, DType::F64, sp[-1], b, "simd_add_f64");
         } DISPATCH();
         
         DO_SIMD_MUL_F64X2: {
             uint64_t b = POP();
-            uint64_t a = POP();
-            ObjList* la = as_list(a);
-            ObjList* lb = as_list(b);
-            
-            ObjList* result = new ObjList();
-            result->count = la->count;
-            result->items = new uint64_t[result->count];
-            
-            for (size_t i = 0; i < result->count && i < lb->count; i++) {
-                double va = is_int(la->items[i]) ? (double)as_int(la->items[i]) : as_number(la->items[i]);
-                double vb = is_int(lb->items[i]) ? (double)as_int(lb->items[i]) : as_number(lb->items[i]);
-                result->items[i] = val_number(va * vb);
-            }
-            PUSH(val_list(result));
+            sp[-1] = simd_list_binary(tensor_kernels::BinOp::MUL, DType::F64, sp[-1], b, "simd_mul_f64");
         } DISPATCH();
         
         DO_SIMD_DOT_F32X4: {
             uint64_t b = POP();
-            uint64_t a = POP();
-            ObjList* la = as_list(a);
-            ObjList* lb = as_list(b);
-            
-            float sum = 0.0f;
-            size_t n = std::min(la->count, lb->count);
-            for (size_t i = 0; i < n; i++) {
-                float va = is_int(la->items[i]) ? (float)as_int(la->items[i]) : (float)as_number(la->items[i]);
-                float vb = is_int(lb->items[i]) ? (float)as_int(lb->items[i]) : (float)as_number(lb->items[i]);
-                sum += va * vb;
-            }
-            PUSH(val_number(static_cast<double>(sum)));
+            uint64_t a = sp[-1];
+            if (!is_tensor(a) && is_obj(a) && obj_type(a) == ObjType::LIST) a = val_obj(tensor_from_list(a, true, DType::F32));
+            if (!is_tensor(b) && is_obj(b) && obj_type(b) == ObjType::LIST) b = val_obj(tensor_from_list(b, true, DType::F32));
+            sp[-1] = tensor_dot(a, b);
         } DISPATCH();
         
         // ============================================================================
-        // 🔒 FUTURE-PROOF: CONCURRENCY PRIMITIVES (Stubs for future implementation)
+        // 🔒 CONCURRENCY PRIMITIVES
         // ============================================================================
+        // Atomics act on a 64-bit integer cell from thread.atomic(), shared
+        // by every thread isolate.
+        
+        DO_ATOMIC_LOAD: {
+            std::atomic<int64_t>* cell = atomic_cell(POP());
+            PUSH(val_int(cell->load()));
+        } DISPATCH();
+        
+        DO_ATOMIC_STORE: {
+            uint64_t value = POP();
+            std::atomic<int64_t>* cell = atomic_cell(POP());
+            cell->store(atomic_operand(value));
+            PUSH(VAL_NONE);
+        } DISPATCH();
+        
+        DO_ATOMIC_ADD: {
+            // Returns the value before the add
+            uint64_t delta = POP();
+            std::atomic<int64_t>* cell = atomic_cell(POP());
+            PUSH(val_int(cell->fetch_add(atomic_operand(delta))));
+        } DISPATCH();
+        
+        DO_ATOMIC_CAS: {
+            int64_t desired = atomic_operand(POP());
+            int64_t expected = atomic_operand(POP());
+            std::atomic<int64_t>* cell = atomic_cell(POP());
+            PUSH(cell->compare_exchange_strong(expected, desired) ? VAL_TRUE : VAL_FALSE);
+        } DISPATCH();
         
-        DO_ATOMIC_LOAD:
-        DO_ATOMIC_STORE:
-        DO_ATOMIC_ADD:
-        DO_ATOMIC_CAS:
         DO_SPAWN_THREAD:
         DO_JOIN_THREAD:
         DO_CHANNEL_SEND:
@@ -26189,298 +33965,1497 @@ private:
     // ========================================================================
     
     /**
-     * Check if guard is satisfied
-     * Returns true if check passes, false if we should deoptimize
+     * Check if guard is satisfied
+     * Returns true if check passes, false if we should deoptimize
+     */
+    bool check_guard(const Guard& guard, uint64_t value) {
+        switch (guard.type) {
+            case Guard::TYPE_INT:
+                return is_int(value);
+            
+            case Guard::TYPE_FLOAT:
+                return is_number(value) || is_int(value);
+            
+            case Guard::TYPE_STRING:
+                return is_obj(value) && as_obj(value)->type == ObjType::STRING;
+            
+            case Guard::TYPE_LIST:
+                return is_obj(value) && as_obj(value)->type == ObjType::LIST;
+            
+            case Guard::NOT_NONE:
+                return value != VAL_NONE;
+            
+            case Guard::BOUNDS_CHECK: {
+                // value is index, expected_value is list length
+                if (!is_int(value)) return false;
+                int64_t idx = as_int(value);
+                int64_t len = guard.expected_value;
+                return idx >= 0 && idx < len;
+            }
+            
+            case Guard::MONOMORPHIC_FUNC:
+                return value == guard.expected_value;
+            
+            case Guard::STABLE_GLOBAL:
+                return value == guard.expected_value;
+            
+            default:
+                return false;
+        }
+    }
+    
+    /**
+     * Deoptimize: Fall back to original bytecode
+     * This is called when a guard fails
+     */
+    void deoptimize(OptimizedCode* opt, uint8_t** ip_ptr, Chunk** chunk_ptr) {
+        opt->deopt_count++;
+        opt->active = false;
+        
+        // If we've deoptimized too many times, give up on this optimization
+        if (opt->deopt_count > DEOPT_THRESHOLD) {
+            // Permanently disable this optimization
+            opt->code.clear();
+        }
+        
+        // Restore original bytecode execution
+        // We need to map from optimized PC to original PC
+        // For simplicity, restart from beginning of function
+        // (A production JIT would maintain PC mapping tables)
+        *ip_ptr = opt->original_code.data();
+    }
+    
+    // ========================================================================
+    //  BYTECODE OPTIMIZER IMPLEMENTATION 
+    // ========================================================================
+    
+    /**
+     * Pattern: GET_LOCAL + GET_LOCAL + ADD → Fused ADD_LOCAL_LOCAL
+     * 
+     * BEFORE: [GET_LOCAL slot1] [GET_LOCAL slot2] [ADD]  (3 instructions, 4 bytes)
+     * AFTER:  [ADD_LOCAL_LOCAL slot1 slot2]              (1 instruction, 3 bytes)
+     * 
+     * This eliminates stack manipulation and improves cache locality.
+     */
+    static bool try_fuse_loads_add(const uint8_t* ip, size_t remaining, std::vector<uint8_t>& out) {
+        if (remaining < 3) return false;
+        
+        // Match: GET_LOCAL + GET_LOCAL + ADD
+        if (ip[0] == (uint8_t)OpCode::OP_GET_LOCAL &&
+            ip[2] == (uint8_t)OpCode::OP_GET_LOCAL &&
+            ip[4] == (uint8_t)OpCode::OP_ADD) {
+            
+            uint8_t slot1 = ip[1];
+            uint8_t slot2 = ip[3];
+            
+            // Emit fused instruction (we'd need a new opcode for this)
+            // For now, keep original (demonstrates the pattern)
+            return false;  // Not implemented yet
+        }
+        
+        return false;
+    }
+    
+    /**
+     * Pattern: CONST + CONST + OP → CONST (folded result)
+     * 
+     * BEFORE: [CONST_INT 5] [CONST_INT 3] [ADD]
+     * AFTER:  [CONST_INT 8]
+     * 
+     * Eliminates runtime computation for constant expressions.
+     */
+    static bool try_constant_fold(const uint8_t* ip, size_t remaining, std::vector<uint8_t>& out, Chunk* chunk) {
+        if (remaining < 3) return false;
+        
+        // Match: CONST_INT + CONST_INT + ADD
+        if (ip[0] == (uint8_t)OpCode::OP_CONST_INT &&
+            ip[2] == (uint8_t)OpCode::OP_CONST_INT &&
+            ip[4] == (uint8_t)OpCode::OP_ADD) {
+            
+            int64_t val1 = ip[1];
+            int64_t val2 = ip[3];
+            int64_t result = val1 + val2;
+            
+            // Emit folded constant
+            if (result >= 0 && result < 256) {
+                out.push_back((uint8_t)OpCode::OP_CONST_INT);
+                out.push_back((uint8_t)result);
+                return true;  // Consumed 5 bytes, emitted 2
+            }
+        }
+        
+        return false;
+    }
+    
+    /**
+     * Pattern: MUL by power of 2 → SHIFT_LEFT
+     * 
+     * BEFORE: [LOAD x] [CONST 8] [MUL]
+     * AFTER:  [LOAD x] [CONST 3] [SHIFT_LEFT]
+     * 
+     * Shifts are 3-5x faster than multiplication on most CPUs.
+     */
+    static bool try_strength_reduce(const uint8_t* ip, size_t remaining, std::vector<uint8_t>& out) {
+        if (remaining < 3) return false;
+        
+        // Match: any + CONST_INT(power-of-2) + MUL
+        if (ip[2] == (uint8_t)OpCode::OP_CONST_INT &&
+            ip[4] == (uint8_t)OpCode::OP_MUL) {
+            
+            int64_t val = ip[3];
+            
+            // Check if power of 2
+            if (val > 0 && (val & (val - 1)) == 0) {
+                // Find shift amount
+                int shift = 0;
+                int64_t tmp = val;
+                while (tmp > 1) { tmp >>= 1; shift++; }
+                
+                // Emit: original load + shift amount + SHIFT_LEFT
+                out.push_back(ip[0]);
+                out.push_back(ip[1]);
+                out.push_back((uint8_t)OpCode::OP_CONST_INT);
+                out.push_back((uint8_t)shift);
+                out.push_back((uint8_t)OpCode::OP_SHIFT_LEFT);
+                return true;
+            }
+        }
+        
+        return false;
+    }
+    
+    /**
+     * Main optimization pass: Apply all safe transformations
+     * 
+     * This is a single-pass optimizer that applies pattern-based rewrites.
+     * Multiple passes could be added for more aggressive optimization.
      */
-    bool check_guard(const Guard& guard, uint64_t value) {
-        switch (guard.type) {
-            case Guard::TYPE_INT:
-                return is_int(value);
-            
-            case Guard::TYPE_FLOAT:
-                return is_number(value) || is_int(value);
-            
-            case Guard::TYPE_STRING:
-                return is_obj(value) && as_obj(value)->type == ObjType::STRING;
-            
-            case Guard::TYPE_LIST:
-                return is_obj(value) && as_obj(value)->type == ObjType::LIST;
+    std::vector<uint8_t> optimize_bytecode(const std::vector<uint8_t>& original, 
+                                           std::vector<Guard>& guards,
+                                           Chunk* chunk) {
+        std::vector<uint8_t> optimized;
+        optimized.reserve(original.size());
+        
+        size_t i = 0;
+        while (i < original.size()) {
+            size_t remaining = original.size() - i;
+            const uint8_t* ip = &original[i];
             
-            case Guard::NOT_NONE:
-                return value != VAL_NONE;
+            // Try each optimization pattern
+            size_t old_size = optimized.size();
             
-            case Guard::BOUNDS_CHECK: {
-                // value is index, expected_value is list length
-                if (!is_int(value)) return false;
-                int64_t idx = as_int(value);
-                int64_t len = guard.expected_value;
-                return idx >= 0 && idx < len;
+            // Pattern 1: Constant folding
+            if (try_constant_fold(ip, remaining, optimized, chunk)) {
+                i += 5;  // Consumed 5 bytes
+                continue;
             }
             
-            case Guard::MONOMORPHIC_FUNC:
-                return value == guard.expected_value;
+            // Pattern 2: Strength reduction
+            if (try_strength_reduce(ip, remaining, optimized)) {
+                i += 5;  // Consumed 5 bytes
+                continue;
+            }
             
-            case Guard::STABLE_GLOBAL:
-                return value == guard.expected_value;
+            // No pattern matched - copy original instruction
+            optimized.push_back(original[i]);
             
-            default:
-                return false;
-        }
-    }
-    
-    /**
-     * Deoptimize: Fall back to original bytecode
-     * This is called when a guard fails
-     */
-    void deoptimize(OptimizedCode* opt, uint8_t** ip_ptr, Chunk** chunk_ptr) {
-        opt->deopt_count++;
-        opt->active = false;
-        
-        // If we've deoptimized too many times, give up on this optimization
-        if (opt->deopt_count > DEOPT_THRESHOLD) {
-            // Permanently disable this optimization
-            opt->code.clear();
+            // Copy operands for multi-byte instructions
+            OpCode op = (OpCode)original[i];
+            switch (op) {
+                case OpCode::OP_CONST:
+                case OpCode::OP_GET_GLOBAL:
+                case OpCode::OP_SET_GLOBAL:
+                case OpCode::OP_DEFINE_GLOBAL:
+                case OpCode::OP_JUMP:
+                case OpCode::OP_JUMP_IF_FALSE:
+                case OpCode::OP_LOOP:
+                case OpCode::OP_ITER_NEXT:
+                case OpCode::OP_GET_PROPERTY:
+                case OpCode::OP_SET_PROPERTY:
+                case OpCode::OP_IMPORT:
+                case OpCode::OP_MODULE_EXPORTS:
+                case OpCode::OP_TRY:
+                case OpCode::OP_POP_JUMP_IF_FALSE:
+                case OpCode::OP_JUMP_IF_NOT_EQ:
+                case OpCode::OP_JUMP_IF_NOT_NE:
+                case OpCode::OP_JUMP_IF_NOT_LT:
+                case OpCode::OP_JUMP_IF_NOT_GT:
+                case OpCode::OP_JUMP_IF_NOT_LE:
+                case OpCode::OP_JUMP_IF_NOT_GE:
+                case OpCode::OP_ADD_LOCALS:
+                case OpCode::OP_INC_LOCAL:
+                    // 16-bit operand (or two 8-bit ones)
+                    if (i + 2 < original.size()) {
+                        optimized.push_back(original[i + 1]);
+                        optimized.push_back(original[i + 2]);
+                        i += 3;
+                    } else {
+                        i++;
+                    }
+                    break;
+                
+                case OpCode::OP_CONST_INT:
+                case OpCode::OP_GET_LOCAL:
+                case OpCode::OP_SET_LOCAL:
+                case OpCode::OP_CALL:
+                case OpCode::OP_BUILTIN_RANGE:
+                case OpCode::OP_BUILD_LIST:
+                case OpCode::OP_BUILD_TUPLE:
+                case OpCode::OP_UNPACK_TUPLE:
+                case OpCode::OP_BUILD_MAP:
+                case OpCode::OP_TENSOR_CREATE:
+                case OpCode::OP_TENSOR_RESHAPE:
+                case OpCode::OP_TENSOR_FROM:
+                case OpCode::OP_BYTES_NEW:
+                case OpCode::OP_BYTES_SLICE:
+                case OpCode::OP_BUILTIN_GETATTR:
+                case OpCode::OP_AWAIT:
+                case OpCode::OP_ITER_POP:
+                case OpCode::OP_INDEX_LOCAL:
+                    // 8-bit operand
+                    if (i + 1 < original.size()) {
+                        optimized.push_back(original[i + 1]);
+                        i += 2;
+                    } else {
+                        i++;
+                    }
+                    break;
+                
+                case OpCode::OP_METHOD_CALL:
+                case OpCode::OP_INVOKE_METHOD:
+                case OpCode::OP_SUPER_INVOKE:
+                    // Mixed operands: 8-bit + 16-bit or 16-bit + 8-bit
+                    if (i + 3 < original.size()) {
+                        optimized.push_back(original[i + 1]);
+                        optimized.push_back(original[i + 2]);
+                        optimized.push_back(original[i + 3]);
+                        i += 4;
+                    } else {
+                        i++;
+                    }
+                    break;
+                
+                case OpCode::OP_JUMP_IF_LOCAL_NOT_LT:
+                    // Slot, immediate, 16-bit offset
+                    if (i + 4 < original.size()) {
+                        optimized.insert(optimized.end(), original.begin() + i + 1, original.begin() + i + 5);
+                        i += 5;
+                    } else {
+                        i++;
+                    }
+                    break;
+
+                default:
+                    // No operands
+                    i++;
+                    break;
+            }
         }
         
-        // Restore original bytecode execution
-        // We need to map from optimized PC to original PC
-        // For simplicity, restart from beginning of function
-        // (A production JIT would maintain PC mapping tables)
-        *ip_ptr = opt->original_code.data();
+        return optimized;
     }
     
-    // ========================================================================
-    //  BYTECODE OPTIMIZER IMPLEMENTATION 
-    // ========================================================================
-    
     /**
-     * Pattern: GET_LOCAL + GET_LOCAL + ADD → Fused ADD_LOCAL_LOCAL
-     * 
-     * BEFORE: [GET_LOCAL slot1] [GET_LOCAL slot2] [ADD]  (3 instructions, 4 bytes)
-     * AFTER:  [ADD_LOCAL_LOCAL slot1 slot2]              (1 instruction, 3 bytes)
+     * Specialize function for observed type patterns
      * 
-     * This eliminates stack manipulation and improves cache locality.
+     * This generates type-specialized versions with guards.
+     * Example: If we observe f(int, int) → int consistently, 
+     * we generate a fast path with integer-only operations.
      */
-    static bool try_fuse_loads_add(const uint8_t* ip, size_t remaining, std::vector<uint8_t>& out) {
-        if (remaining < 3) return false;
+    void specialize_function(uint8_t* func_start, Chunk* chunk) {
+        // Check if already optimized
+        if (optimized_functions.find(func_start) != optimized_functions.end()) {
+            return;
+        }
         
-        // Match: GET_LOCAL + GET_LOCAL + ADD
-        if (ip[0] == (uint8_t)OpCode::OP_GET_LOCAL &&
-            ip[2] == (uint8_t)OpCode::OP_GET_LOCAL &&
-            ip[4] == (uint8_t)OpCode::OP_ADD) {
-            
-            uint8_t slot1 = ip[1];
-            uint8_t slot2 = ip[3];
-            
-            // Emit fused instruction (we'd need a new opcode for this)
-            // For now, keep original (demonstrates the pattern)
-            return false;  // Not implemented yet
+        // Create optimized version
+        OptimizedCode opt;
+        
+        // For now, just copy original (real impl would analyze types)
+        opt.original_code = chunk->code;
+        
+        // Apply bytecode-level optimizations
+        opt.code = optimize_bytecode(chunk->code, opt.guards, chunk);
+        
+        // Only activate if we actually optimized something
+        if (opt.code.size() < chunk->code.size()) {
+            opt.active = true;
+            optimized_functions[func_start] = std::move(opt);
+        }
+    }
+};
+
+// ============================================================================
+// THREAD ISOLATES
+// ============================================================================
+// thread.spawn(fn, args...) runs fn on a pool worker inside its own FastVM,
+// with its own heap, string pool and shapes, so workers never lock on the hot
+// path. Compiled chunks and everything the compiler allocated (functions,
+// classes, string constants) are immutable once the program runs and are
+// shared by pointer; every other value crosses threads as a deep copy.
+namespace thread_isolates {
+
+// Globals a spawned function starts from: code, modules and immutable values
+// as of the spawn. Lists, maps, tensors and instances are left out so that state is
+// never silently forked; pass those as arguments.
+struct GlobalsSnapshot {
+    struct Entry {
+        size_t slot;
+        Transfer value;
+        std::string module;  // Import name when the value is a module map
+    };
+    uint64_t id;
+    std::vector<Entry> slots;
+    std::vector<std::pair<size_t, const char*>> unshared;  // Slot and value kind, for error messages
+};
+static std::atomic<uint64_t> g_next_snapshot{1};
+
+// Kind of a global that snapshot_global() leaves out
+static const char* unshared_kind(uint64_t v) {
+    switch (obj_type(v)) {
+        case ObjType::LIST: return "list";
+        case ObjType::MAP: return "map";
+        case ObjType::TENSOR: return "tensor";
+        case ObjType::BYTES: return "bytes buffer";
+        case ObjType::READER: return "reader";
+        case ObjType::INSTANCE: return "instance";
+        case ObjType::COROUTINE: return "coroutine";
+        case ObjType::CLASS: return "class";
+        default: return "value";
+    }
+}
+
+static bool snapshot_global(FastVM& vm, uint64_t v) {
+    if (v == VAL_UNDEFINED) return false;
+    if (!is_obj(v)) return true;
+    switch (obj_type(v)) {
+        case ObjType::LIST:
+        case ObjType::TENSOR:
+        case ObjType::BYTES:
+        case ObjType::READER:
+        case ObjType::INSTANCE:
+        case ObjType::COROUTINE:
+            return false;
+        case ObjType::MAP:
+            return vm.module_name_of(v) != nullptr;
+        case ObjType::CLASS:
+            return shareable(as_obj(v));
+        default:
+            return true;
+    }
+}
+
+// Spawning in a loop reuses the last snapshot until a global changes
+struct SnapshotCache {
+    FastVM* vm = nullptr;
+    uint64_t collections = 0;  // A collection may recycle an address in `globals`
+    std::vector<uint64_t> globals;
+    std::shared_ptr<const GlobalsSnapshot> snapshot;
+};
+static thread_local SnapshotCache t_snapshot_cache;
+
+static std::shared_ptr<const GlobalsSnapshot> snapshot_globals(FastVM& vm) {
+    SnapshotCache& cache = t_snapshot_cache;
+    const std::vector<uint64_t>& globals = vm.global_values();
+    if (cache.vm == &vm && cache.collections == g_heap.collections && cache.globals == globals) {
+        return cache.snapshot;
+    }
+    auto snap = std::make_shared<GlobalsSnapshot>();
+    snap->id = g_next_snapshot.fetch_add(1);
+    for (size_t slot = 0; slot < globals.size(); ++slot) {
+        if (!snapshot_global(vm, globals[slot])) {
+            if (is_obj(globals[slot])) snap->unshared.push_back({slot, unshared_kind(globals[slot])});
+            continue;
+        }
+        snap->slots.push_back({slot, Transfer(), std::string()});
+        pack(globals[slot], snap->slots.back().value);
+        if (ObjString* module = is_obj(globals[slot]) ? vm.module_name_of(globals[slot]) : nullptr) {
+            snap->slots.back().module = module->str();
+        }
+    }
+    cache.vm = &vm;
+    cache.collections = g_heap.collections;
+    cache.globals = globals;
+    cache.snapshot = snap;
+    return snap;
+}
+
+struct Job {
+    Transfer fn;
+    std::vector<Transfer> args;
+    std::shared_ptr<const GlobalsSnapshot> globals;
+    // Runs instead of fn when set: native work that needs the worker's VM
+    std::function<void(FastVM&)> native;
+
+    std::mutex mu;
+    std::condition_variable cv;
+    bool done = false;
+    Transfer result;
+    std::string error;  // Set instead of result when the result cannot be copied
+};
+
+// Per-worker-thread isolate: one FastVM per nesting level, since a worker
+// blocked in thread.join runs other queued jobs on top of its current one
+struct Isolate {
+    static constexpr size_t MAX_NESTING = 16;
+    struct Level {
+        std::unique_ptr<FastVM> vm;
+        uint64_t snapshot_id = 0;
+        std::vector<uint64_t> applied;  // Globals right after the snapshot was applied
+        std::vector<uint64_t> pinned;   // Values a native job holds across collections
+    };
+    std::vector<Level> levels;  // Idle levels keep globals and caches, so they stay roots too
+    size_t depth = 0;
+};
+static thread_local Isolate t_isolate;
+static std::atomic<int> g_next_heap_id{GCHeap::MAIN + 1};
+
+static void init_worker_heap() {
+    g_heap.id = g_heap.permanent_id = static_cast<uint8_t>(g_next_heap_id.fetch_add(1));
+    g_heap.isolate = true;
+    g_heap.tracking = true;
+    t_isolate.levels.reserve(Isolate::MAX_NESTING + 1);
+    g_heap.mark_roots = [](void*) {
+        for (Isolate::Level& level : t_isolate.levels) {
+            level.vm->mark_roots();
+            for (uint64_t v : level.applied) gc_mark_value(v);  // Keeps the reuse check exact
+            for (uint64_t v : level.pinned) gc_mark_value(v);
+        }
+    };
+    g_heap.roots_owner = &t_isolate;
+}
+
+static void apply_globals(Isolate::Level& level, const GlobalsSnapshot& snap) {
+    std::vector<uint64_t>& globals = level.vm->global_values();
+    // Jobs from the same snapshot reuse the values unless a job assigned one
+    if (level.snapshot_id == snap.id && globals == level.applied) return;
+    globals.assign(g_global_slots.size(), VAL_UNDEFINED);
+    for (const auto& entry : snap.slots) {
+        if (entry.slot >= globals.size()) globals.resize(entry.slot + 1, VAL_UNDEFINED);
+        globals[entry.slot] = unpack(entry.value);
+        // Registered so imports and nested spawns in the isolate see a module
+        if (!entry.module.empty()) {
+            level.vm->adopt_module(g_strings.intern(entry.module.data(), entry.module.size()), globals[entry.slot]);
+        }
+    }
+    std::vector<const char*>& unshared = level.vm->unshared_globals;
+    unshared.assign(globals.size(), nullptr);
+    for (const auto& entry : snap.unshared) {
+        if (entry.first >= unshared.size()) unshared.resize(entry.first + 1, nullptr);
+        unshared[entry.first] = entry.second;
+    }
+    level.snapshot_id = snap.id;
+    level.applied = globals;
+}
+
+static void run_job(Job& job) {
+    Isolate& iso = t_isolate;
+    if (iso.levels.size() <= iso.depth) {
+        iso.levels.emplace_back();
+        iso.levels.back().vm = std::make_unique<FastVM>();
+        iso.levels.back().vm->throw_errors = true;
+    }
+    Isolate::Level& level = iso.levels[iso.depth];
+    ++iso.depth;
+
+    // A runtime error in the job (or a result that cannot be copied) is
+    // returned through job.error; run_function resets the VM for reuse
+    Transfer result;
+    std::string error;
+    try {
+        apply_globals(level, *job.globals);
+        if (job.native) {
+            job.native(*level.vm);
+        } else {
+            // Nothing below collects until run_function has the values on its stack
+            uint64_t fn = unpack(job.fn);
+            std::vector<uint64_t> args;
+            args.reserve(job.args.size());
+            for (const Transfer& a : job.args) args.push_back(unpack(a));
+            uint64_t r = level.vm->run_function(fn, args.data(), static_cast<uint8_t>(args.size()));
+            pack(r, result);
+        }
+    } catch (const std::exception& e) {
+        error = e.what();
+        if (error.empty()) error = "thread job failed";
+    }
+    level.pinned.clear();
+    --iso.depth;
+    {
+        std::lock_guard<std::mutex> lk(job.mu);
+        job.result = std::move(result);
+        job.error = std::move(error);
+        job.done = true;
+    }
+    job.cv.notify_all();
+}
+
+/**
+ * Work-stealing pool, one worker per hardware thread
+ * Each worker owns a deque: jobs it spawns go to the back and it takes its
+ * newest job first, while idle workers steal the oldest from the front of
+ * someone else's. Jobs from the main thread are dealt round-robin.
+ *
+ * A worker parked in a BlockingWait (a channel, a sleep, a server loop)
+ * no longer counts as running; when fewer than size() workers are left
+ * running, a spare worker is started so a pipeline whose stages block on
+ * each other cannot starve the jobs queued behind them. Spare workers stay
+ * parked for reuse once started. Past MAX_THREADS workers no spare is
+ * started, and a program that keeps that many workers blocked at once
+ * waits on itself.
+ */
+class Pool {
+public:
+    static Pool& get() {
+        // Never destroyed: workers may still be running when the program exits
+        static Pool* pool = new Pool();
+        return *pool;
+    }
+
+    static constexpr size_t MAX_THREADS = 256;
+
+    size_t size() const { return core; }
+    static bool on_worker() { return t_worker >= 0; }
+
+    void submit(std::shared_ptr<Job> job) {
+        size_t w = on_worker() ? static_cast<size_t>(t_worker) : next.fetch_add(1) % core;
+        {
+            std::lock_guard<std::mutex> lk(workers[w]->mu);
+            workers[w]->jobs.push_back(std::move(job));
+        }
+        {
+            std::lock_guard<std::mutex> lk(idle_mu);
+            ++queued;
+        }
+        idle_cv.notify_one();
+    }
+
+    // Run one queued job on the calling worker; false if there was none
+    bool run_one() {
+        std::shared_ptr<Job> job = take();
+        if (!job) return false;
+        run_job(*job);
+        return true;
+    }
+
+    // The calling worker is about to park outside the pool (see BlockingWait)
+    void block_begin() {
+        size_t spare = 0;
+        {
+            std::lock_guard<std::mutex> lk(idle_mu);
+            ++blocked;
+            size_t n = started.load(std::memory_order_relaxed);
+            if (n - blocked < core && n < MAX_THREADS) {
+                spare = n;
+                started.store(n + 1, std::memory_order_release);
+            }
         }
-        
-        return false;
+        if (spare) std::thread([this, spare] { worker_main(static_cast<int>(spare)); }).detach();
     }
-    
-    /**
-     * Pattern: CONST + CONST + OP → CONST (folded result)
-     * 
-     * BEFORE: [CONST_INT 5] [CONST_INT 3] [ADD]
-     * AFTER:  [CONST_INT 8]
-     * 
-     * Eliminates runtime computation for constant expressions.
-     */
-    static bool try_constant_fold(const uint8_t* ip, size_t remaining, std::vector<uint8_t>& out, Chunk* chunk) {
-        if (remaining < 3) return false;
-        
-        // Match: CONST_INT + CONST_INT + ADD
-        if (ip[0] == (uint8_t)OpCode::OP_CONST_INT &&
-            ip[2] == (uint8_t)OpCode::OP_CONST_INT &&
-            ip[4] == (uint8_t)OpCode::OP_ADD) {
-            
-            int64_t val1 = ip[1];
-            int64_t val2 = ip[3];
-            int64_t result = val1 + val2;
-            
-            // Emit folded constant
-            if (result >= 0 && result < 256) {
-                out.push_back((uint8_t)OpCode::OP_CONST_INT);
-                out.push_back((uint8_t)result);
-                return true;  // Consumed 5 bytes, emitted 2
+
+    void block_end() {
+        std::lock_guard<std::mutex> lk(idle_mu);
+        --blocked;
+    }
+
+private:
+    struct Worker {
+        std::mutex mu;
+        std::deque<std::shared_ptr<Job>> jobs;
+    };
+    // All MAX_THREADS slots exist up front so stealing never races a resize;
+    // only the first `started` have a thread
+    std::vector<std::unique_ptr<Worker>> workers;
+    size_t core = 1;
+    std::atomic<size_t> started{0};
+    std::atomic<size_t> next{0};
+    std::mutex idle_mu;
+    std::condition_variable idle_cv;
+    size_t queued = 0;   // Jobs in any deque (guarded by idle_mu)
+    size_t blocked = 0;  // Workers inside a BlockingWait (guarded by idle_mu)
+    static thread_local int t_worker;
+
+    Pool() {
+        size_t n = std::thread::hardware_concurrency();
+        core = std::max<size_t>(1, std::min<size_t>(n, 64));
+        for (size_t i = 0; i < MAX_THREADS; ++i) workers.push_back(std::make_unique<Worker>());
+        started.store(core);
+        for (size_t i = 0; i < core; ++i) std::thread([this, i] { worker_main(static_cast<int>(i)); }).detach();
+    }
+
+    std::shared_ptr<Job> take() {
+        size_t n = started.load(std::memory_order_acquire);
+        size_t self = static_cast<size_t>(t_worker);
+        std::shared_ptr<Job> job;
+        {
+            std::lock_guard<std::mutex> lk(workers[self]->mu);
+            if (!workers[self]->jobs.empty()) {
+                job = std::move(workers[self]->jobs.back());
+                workers[self]->jobs.pop_back();
             }
         }
-        
-        return false;
+        for (size_t i = 1; !job && i < n; ++i) {
+            Worker& victim = *workers[(self + i) % n];
+            std::lock_guard<std::mutex> lk(victim.mu);
+            if (!victim.jobs.empty()) {
+                job = std::move(victim.jobs.front());
+                victim.jobs.pop_front();
+            }
+        }
+        if (job) {
+            std::lock_guard<std::mutex> lk(idle_mu);
+            --queued;
+        }
+        return job;
     }
-    
-    /**
-     * Pattern: MUL by power of 2 → SHIFT_LEFT
-     * 
-     * BEFORE: [LOAD x] [CONST 8] [MUL]
-     * AFTER:  [LOAD x] [CONST 3] [SHIFT_LEFT]
-     * 
-     * Shifts are 3-5x faster than multiplication on most CPUs.
-     */
-    static bool try_strength_reduce(const uint8_t* ip, size_t remaining, std::vector<uint8_t>& out) {
-        if (remaining < 3) return false;
-        
-        // Match: any + CONST_INT(power-of-2) + MUL
-        if (ip[2] == (uint8_t)OpCode::OP_CONST_INT &&
-            ip[4] == (uint8_t)OpCode::OP_MUL) {
-            
-            int64_t val = ip[3];
-            
-            // Check if power of 2
-            if (val > 0 && (val & (val - 1)) == 0) {
-                // Find shift amount
-                int shift = 0;
-                int64_t tmp = val;
-                while (tmp > 1) { tmp >>= 1; shift++; }
-                
-                // Emit: original load + shift amount + SHIFT_LEFT
-                out.push_back(ip[0]);
-                out.push_back(ip[1]);
-                out.push_back((uint8_t)OpCode::OP_CONST_INT);
-                out.push_back((uint8_t)shift);
-                out.push_back((uint8_t)OpCode::OP_SHIFT_LEFT);
+
+    void worker_main(int index) {
+        t_worker = index;
+        init_worker_heap();
+        for (;;) {
+            if (run_one()) continue;
+            std::unique_lock<std::mutex> lk(idle_mu);
+            idle_cv.wait(lk, [this] { return queued > 0; });
+        }
+    }
+};
+thread_local int Pool::t_worker = -1;
+
+BlockingWait::BlockingWait() {
+    if (!Pool::on_worker()) return;
+    Pool::get().block_begin();
+    counted = true;
+}
+
+BlockingWait::~BlockingWait() {
+    if (counted) Pool::get().block_end();
+}
+
+static std::mutex g_jobs_mu;
+static std::unordered_map<long, std::shared_ptr<Job>> g_jobs;
+
+static std::shared_ptr<Job> find_job(long id, bool remove) {
+    std::lock_guard<std::mutex> lk(g_jobs_mu);
+    auto it = g_jobs.find(id);
+    if (it == g_jobs.end()) return nullptr;
+    std::shared_ptr<Job> job = it->second;
+    if (remove) g_jobs.erase(it);
+    return job;
+}
+
+static bool job_done(Job& job) {
+    std::lock_guard<std::mutex> lk(job.mu);
+    return job.done;
+}
+
+static void wait_for(Job& job) {
+    // A worker that blocked outright could starve the pool (every worker
+    // waiting on a queued child), so it runs queued jobs while it waits
+    if (Pool::on_worker() && t_isolate.depth < Isolate::MAX_NESTING) {
+        Pool& pool = Pool::get();
+        while (!job_done(job)) {
+            if (pool.run_one()) continue;
+            std::unique_lock<std::mutex> lk(job.mu);
+            job.cv.wait_for(lk, std::chrono::milliseconds(1), [&job] { return job.done; });
+        }
+        return;
+    }
+    BlockingWait parked;
+    std::unique_lock<std::mutex> lk(job.mu);
+    job.cv.wait(lk, [&job] { return job.done; });
+}
+
+} // namespace thread_isolates
+
+namespace thread_bindings {
+using namespace thread_isolates;
+
+uint64_t native_thread_spawn(VMContext& ctx, const uint64_t* args, uint8_t argc) {
+    uint64_t target = native_arg(args, argc, 0);
+    if (is_string_val(target)) {
+        // thread.spawn(command): shell command on a system thread
+        return val_int(builtin_thread_spawn({Value(as_string(target)->str())}).data.integer);
+    }
+    if (!is_obj(target) || obj_type(target) != ObjType::FUNCTION) {
+        throw std::runtime_error("thread.spawn expects a function or a command string");
+    }
+    ObjFunc* fn = as_func(target);
+    const char* name = fn->name ? fn->name->chars : "<anonymous>";
+    if (fn->chunk->is_async) {
+        throw std::runtime_error(std::string("thread.spawn cannot run async act '") + name + "'");
+    }
+    if (argc - 1 != fn->arity) {
+        throw std::runtime_error(std::string("thread.spawn: '") + name + "' expects " +
+                                 std::to_string(fn->arity) + " arguments, got " + std::to_string(argc - 1));
+    }
+    if (!g_heap.isolate) g_strings.publish_shared();
+
+    auto job = std::make_shared<Job>();
+    pack(target, job->fn);
+    job->args.resize(argc - 1);
+    for (uint8_t i = 1; i < argc; ++i) pack(args[i], job->args[i - 1]);
+    job->globals = snapshot_globals(*ctx.vm);
+
+    long id = g_next_tid.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lk(g_jobs_mu);
+        g_jobs.emplace(id, job);
+    }
+    Pool::get().submit(std::move(job));
+    return val_int(id);
+}
+
+uint64_t native_thread_join(VMContext&, const uint64_t* args, uint8_t argc) {
+    long id = native_long(native_arg(args, argc, 0));
+    std::shared_ptr<Job> job = find_job(id, true);
+    if (!job) return val_int(builtin_thread_join({Value(id)}).data.integer);
+    wait_for(*job);
+    if (!job->error.empty()) throw std::runtime_error(job->error);
+    return unpack(job->result);
+}
+
+uint64_t native_thread_is_done(VMContext&, const uint64_t* args, uint8_t argc) {
+    long id = native_long(native_arg(args, argc, 0));
+    std::shared_ptr<Job> job = find_job(id, false);
+    if (!job) return builtin_thread_is_done({Value(id)}).data.boolean ? VAL_TRUE : VAL_FALSE;
+    return job_done(*job) ? VAL_TRUE : VAL_FALSE;
+}
+
+uint64_t native_thread_pool_size(VMContext&, const uint64_t*, uint8_t) {
+    return val_int(static_cast<int64_t>(Pool::get().size()));
+}
+
+} // namespace thread_bindings
+
+// ============================================================================
+// HTTP CLIENT - FastVM entry points with bytes bodies
+// ============================================================================
+namespace http_bindings {
+using namespace native_module_util;
+
+// Requests still go through the Value parsers; responses carry their body as
+// a string and as one bytes buffer (body_bytes) instead of a list of ints
+static std::vector<Value> native_http_args(VMContext& ctx, const uint64_t* args, uint8_t argc) {
+    std::vector<Value> out;
+    out.reserve(argc);
+    for (uint8_t i = 0; i < argc; ++i) out.push_back(ctx.vm->to_value(args[i]));
+    return out;
+}
+static uint64_t native_http_response(VMContext& ctx, const levython::http::HttpResponse& resp) {
+    uint64_t m = ctx.vm->from_value(response_to_value(resp, false));
+    const char* body = reinterpret_cast<const char*>(resp.body.data());
+    native_map_set(as_map(m), "body", native_str_val(body, resp.body.size()));
+    native_map_set(as_map(m), "body_bytes", native_bytes_val(body, resp.body.size()));
+    return m;
+}
+
+uint64_t native_http_get(VMContext& ctx, const uint64_t* args, uint8_t argc) {
+    return native_http_response(ctx, http_get_response(native_http_args(ctx, args, argc)));
+}
+uint64_t native_http_post(VMContext& ctx, const uint64_t* args, uint8_t argc) {
+    return native_http_response(ctx, http_post_response(native_http_args(ctx, args, argc)));
+}
+uint64_t native_http_put(VMContext& ctx, const uint64_t* args, uint8_t argc) {
+    return native_http_response(ctx, http_put_response(native_http_args(ctx, args, argc)));
+}
+uint64_t native_http_patch(VMContext& ctx, const uint64_t* args, uint8_t argc) {
+    return native_http_response(ctx, http_patch_response(native_http_args(ctx, args, argc)));
+}
+uint64_t native_http_delete(VMContext& ctx, const uint64_t* args, uint8_t argc) {
+    return native_http_response(ctx, http_delete_response(native_http_args(ctx, args, argc)));
+}
+uint64_t native_http_head(VMContext& ctx, const uint64_t* args, uint8_t argc) {
+    return native_http_response(ctx, http_head_response(native_http_args(ctx, args, argc)));
+}
+uint64_t native_http_request(VMContext& ctx, const uint64_t* args, uint8_t argc) {
+    return native_http_response(ctx, http_request_response(native_http_args(ctx, args, argc)));
+}
+uint64_t native_http_request_many(VMContext& ctx, const uint64_t* args, uint8_t argc) {
+    std::vector<levython::http::HttpResponse> responses = http_request_many_responses(native_http_args(ctx, args, argc));
+    ObjList* out = ObjList::create();
+    out->reserve(responses.size());
+    for (const auto& resp : responses) out->push(native_http_response(ctx, resp));
+    return val_list(out);
+}
+} // namespace http_bindings
+
+namespace log_bindings {
+using namespace native_module_util;
+
+// The level and sample rate are checked before any argument is read, so a
+// filtered-out record costs no conversion at all. Fields print in key
+// order, as they always have; only nested lists and maps go through the
+// Value conversion.
+static void write_native_fields(std::ostringstream& oss, uint64_t fields, FastVM& vm) {
+    if (!is_obj(fields) || obj_type(fields) != ObjType::MAP) return;
+    const MapTable& map = as_map(fields)->data;
+    if (!g_json && map.empty()) return;
+    std::vector<std::pair<std::string_view, uint64_t>> sorted;
+    sorted.reserve(map.size());
+    for (const auto& kv : map) sorted.emplace_back(std::string_view(kv.first->chars, kv.first->length), kv.second);
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    oss << (g_json ? ",\"fields\":{" : " {");
+    bool first = true;
+    for (const auto& kv : sorted) {
+        if (!first) oss << (g_json ? "," : ", ");
+        first = false;
+        uint64_t v = kv.second;
+        bool nested = is_obj(v) && !is_string_val(v);
+        if (!g_json) {
+            oss << kv.first << "=" << (nested ? vm.to_value(v).to_string() : val_to_string(v));
+            continue;
+        }
+        oss << "\"" << json_escape(kv.first) << "\":";
+        if (nested) oss << value_json(vm.to_value(v));
+        else if (is_bool(v)) oss << (v == VAL_TRUE ? "true" : "false");
+        else if (is_none(v)) oss << "null";
+        else if (is_string_val(v)) oss << "\"" << json_escape(std::string_view(as_string(v)->chars, as_string(v)->length)) << "\"";
+        else if (is_int(v)) oss << as_int(v);
+        else oss << std::to_string(as_number(v));
+    }
+    oss << "}";
+}
+
+static uint64_t native_log_at(VMContext& ctx, LogLevel level, const uint64_t* args, uint8_t argc, uint8_t at) {
+    if (!should_emit(level)) return VAL_NONE;
+    std::string tmp;
+    std::string_view message = native_string(native_arg(args, argc, at), tmp);
+    uint64_t fields = argc > at + 1 ? args[at + 1] : VAL_NONE;
+    FastVM& vm = *ctx.vm;
+    write_record(level, message, [fields, &vm](std::ostringstream& oss) { write_native_fields(oss, fields, vm); });
+    return VAL_NONE;
+}
+
+uint64_t native_log_log(VMContext& ctx, const uint64_t* args, uint8_t argc) {
+    if (argc < 2) throw std::runtime_error("log.log() expects (level, message, fields?)");
+    std::string tmp;
+    return native_log_at(ctx, parse_level(std::string(native_string(args[0], tmp))), args, argc, 1);
+}
+uint64_t native_log_debug(VMContext& ctx, const uint64_t* args, uint8_t argc) { return native_log_at(ctx, LogLevel::DEBUG, args, argc, 0); }
+uint64_t native_log_info(VMContext& ctx, const uint64_t* args, uint8_t argc) { return native_log_at(ctx, LogLevel::INFO, args, argc, 0); }
+uint64_t native_log_warn(VMContext& ctx, const uint64_t* args, uint8_t argc) { return native_log_at(ctx, LogLevel::WARN, args, argc, 0); }
+uint64_t native_log_error(VMContext& ctx, const uint64_t* args, uint8_t argc) { return native_log_at(ctx, LogLevel::ERR, args, argc, 0); }
+} // namespace log_bindings
+
+namespace async_bindings {
+using namespace native_module_util;
+
+uint64_t native_async_status(VMContext& ctx, const uint64_t* args, uint8_t argc) {
+    long id = native_long(native_arg(args, argc, 0));
+    auto task = find_task(id);
+    if (task && !task->done) tick_tasks();
+    uint64_t m = ctx.vm->from_value(task_status_map(id, task, false));
+    if (task) attach_body(*task, as_map(m)->data[g_strings.intern("result")]);
+    return m;
+}
+uint64_t native_async_result(VMContext& ctx, const uint64_t* args, uint8_t argc) {
+    auto task = result_task(native_long(native_arg(args, argc, 0)));
+    return task ? attach_body(*task, ctx.vm->from_value(task->result)) : VAL_NONE;
+}
+uint64_t native_async_await(VMContext& ctx, const uint64_t* args, uint8_t argc) {
+    long timeout_ms = argc >= 2 ? native_long(args[1]) : -1;
+    auto task = await_task(native_long(native_arg(args, argc, 0)), timeout_ms);
+    return attach_body(*task, ctx.vm->from_value(task->result));
+}
+} // namespace async_bindings
+
+// ============================================================================
+// HTTP SERVER - native http.serve on the isolate pool
+// ============================================================================
+namespace http_server {
+using namespace native_module_util;
+using namespace thread_isolates;
+
+struct Options {
+    std::string host = "0.0.0.0";
+    size_t workers = 0;             // 0 = one per pool worker
+    long max_requests = 0;          // Stop after this many (0 = run until shutdown)
+    int idle_timeout_ms = 5000;     // Keep-alive connections idle this long are closed
+    size_t max_header_bytes = 65536;
+    size_t max_body_bytes = 16 * 1024 * 1024;
+    std::string port_file;          // Receives the bound port (for port 0)
+};
+
+// One http.serve call: workers share the listening socket
+struct Server {
+    int listen_fd = -1;
+    Options opts;
+    std::atomic<long> served{0};
+    std::atomic<bool> stopping{false};
+    std::mutex mu;
+    std::vector<async_bindings::Reactor*> reactors;  // Woken on stop
+
+    void stop() {
+        stopping.store(true);
+        std::lock_guard<std::mutex> lk(mu);
+        for (auto* r : reactors) r->wake();
+    }
+};
+
+static std::mutex g_servers_mu;
+static std::vector<Server*> g_servers;  // Running servers, for http.shutdown
+
+struct Conn {
+    int fd = -1;
+    std::string in;
+    size_t in_pos = 0;    // Start of the next request
+    size_t scan = 0;      // Where the header terminator search resumes
+    std::string out;
+    size_t out_pos = 0;
+    bool writing = false;      // Registered for writability instead of reads
+    bool close_after = false;  // Close once `out` is flushed
+    std::chrono::steady_clock::time_point last_active;
+};
+
+// A parsed request; views point into Conn::in
+struct Request {
+    std::string_view method, target, version, body;
+    std::vector<std::pair<std::string_view, std::string_view>> headers;
+    bool keep_alive = true;
+};
+
+enum class ParseResult { NEED_MORE, READY, BAD };
+
+static bool iequals(std::string_view a, const char* b) {
+    size_t n = std::strlen(b);
+    if (a.size() != n) return false;
+    for (size_t i = 0; i < n; ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != b[i]) return false;
+    }
+    return true;
+}
+
+static bool icontains(std::string_view haystack, const char* needle) {
+    size_t n = std::strlen(needle);
+    for (size_t i = 0; i + n <= haystack.size(); ++i) {
+        if (iequals(haystack.substr(i, n), needle)) return true;
+    }
+    return false;
+}
+
+static std::string_view trim_ows(std::string_view v) {
+    while (!v.empty() && (v.front() == ' ' || v.front() == '\t')) v.remove_prefix(1);
+    while (!v.empty() && (v.back() == ' ' || v.back() == '\t')) v.remove_suffix(1);
+    return v;
+}
+
+// Parse the request starting at c.in_pos in place; `consumed` is its length.
+// On BAD, `status` is the error response to send before closing.
+static ParseResult parse_request(Conn& c, const Options& opts, Request& req, size_t& consumed, int& status) {
+    const std::string& in = c.in;
+    size_t head_end = in.find("\r\n\r\n", std::max(c.scan, c.in_pos));
+    if (head_end == std::string::npos) {
+        if (in.size() - c.in_pos > opts.max_header_bytes) {
+            status = 431;
+            return ParseResult::BAD;
+        }
+        c.scan = in.size() >= 3 ? std::max(c.in_pos, in.size() - 3) : c.in_pos;
+        return ParseResult::NEED_MORE;
+    }
+    c.scan = head_end;
+    std::string_view head(in.data() + c.in_pos, head_end - c.in_pos);
+
+    // Request line: METHOD SP target SP HTTP/x.y
+    size_t line_end = head.find("\r\n");
+    std::string_view line = head.substr(0, line_end);
+    size_t sp1 = line.find(' ');
+    size_t sp2 = sp1 == std::string_view::npos ? sp1 : line.find(' ', sp1 + 1);
+    if (sp1 == std::string_view::npos || sp2 == std::string_view::npos || sp1 == 0 || sp2 == sp1 + 1) {
+        status = 400;
+        return ParseResult::BAD;
+    }
+    req.method = line.substr(0, sp1);
+    req.target = line.substr(sp1 + 1, sp2 - sp1 - 1);
+    req.version = line.substr(sp2 + 1);
+    if (req.version != "HTTP/1.1" && req.version != "HTTP/1.0") {
+        status = 505;
+        return ParseResult::BAD;
+    }
+
+    req.headers.clear();
+    size_t content_length = 0;
+    bool has_length = false;
+    std::string_view connection;
+    size_t pos = line_end == std::string_view::npos ? head.size() : line_end + 2;
+    while (pos < head.size()) {
+        size_t next = head.find("\r\n", pos);
+        if (next == std::string_view::npos) next = head.size();
+        std::string_view field = head.substr(pos, next - pos);
+        pos = next + 2;
+        size_t colon = field.find(':');
+        if (colon == std::string_view::npos || colon == 0) {
+            status = 400;
+            return ParseResult::BAD;
+        }
+        std::string_view name = field.substr(0, colon);
+        std::string_view value = trim_ows(field.substr(colon + 1));
+        if (iequals(name, "content-length")) {
+            auto r = std::from_chars(value.data(), value.data() + value.size(), content_length);
+            if (r.ec != std::errc() || r.ptr != value.data() + value.size()) {
+                status = 400;
+                return ParseResult::BAD;
+            }
+            has_length = true;
+        } else if (iequals(name, "transfer-encoding")) {
+            status = 501;  // Chunked request bodies are not supported
+            return ParseResult::BAD;
+        } else if (iequals(name, "connection")) {
+            connection = value;
+        }
+        req.headers.emplace_back(name, value);
+    }
+    if (has_length && content_length > opts.max_body_bytes) {
+        status = 413;
+        return ParseResult::BAD;
+    }
+
+    size_t body_start = head_end + 4;
+    if (in.size() - body_start < content_length) return ParseResult::NEED_MORE;
+    req.body = std::string_view(in.data() + body_start, content_length);
+    req.keep_alive = req.version == "HTTP/1.1" ? !icontains(connection, "close")
+                                               : icontains(connection, "keep-alive");
+    consumed = body_start + content_length - c.in_pos;
+    return ParseResult::READY;
+}
+
+static const char* reason_phrase(long status) {
+    switch (status) {
+        case 100: return "Continue";
+        case 101: return "Switching Protocols";
+        case 200: return "OK";
+        case 201: return "Created";
+        case 202: return "Accepted";
+        case 204: return "No Content";
+        case 206: return "Partial Content";
+        case 301: return "Moved Permanently";
+        case 302: return "Found";
+        case 303: return "See Other";
+        case 304: return "Not Modified";
+        case 307: return "Temporary Redirect";
+        case 308: return "Permanent Redirect";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 409: return "Conflict";
+        case 413: return "Payload Too Large";
+        case 422: return "Unprocessable Entity";
+        case 429: return "Too Many Requests";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        case 502: return "Bad Gateway";
+        case 503: return "Service Unavailable";
+        case 505: return "HTTP Version Not Supported";
+        default: return "Unknown";
+    }
+}
+
+// The handler's argument: method, path, query, version, headers (lower-case
+// names), body
+static uint64_t request_value(const Request& req) {
+    ObjMap* m = ObjMap::create();
+    native_map_set(m, "method", native_str_val(req.method.data(), req.method.size()));
+    size_t q = req.target.find('?');
+    std::string_view path = req.target.substr(0, q);
+    std::string_view query = q == std::string_view::npos ? std::string_view() : req.target.substr(q + 1);
+    native_map_set(m, "path", native_str_val(path.data(), path.size()));
+    native_map_set(m, "query", native_str_val(query.data(), query.size()));
+    native_map_set(m, "version", native_str_val(req.version.data(), req.version.size()));
+    ObjMap* headers = ObjMap::create();
+    std::string name;
+    for (const auto& h : req.headers) {
+        name.assign(h.first.data(), h.first.size());
+        for (char& ch : name) ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+        headers->data[g_strings.intern(name.data(), name.size())] = native_str_val(h.second.data(), h.second.size());
+    }
+    native_map_set(m, "headers", val_map(headers));
+    native_map_set(m, "body", native_str_val(req.body.data(), req.body.size()));
+    return val_map(m);
+}
+
+static void append_head(std::string& out, long status, size_t body_len, bool keep_alive, bool http10) {
+    char line[64];
+    int n = std::snprintf(line, sizeof(line), "HTTP/1.1 %ld ", status);
+    out.append(line, static_cast<size_t>(n));
+    out += reason_phrase(status);
+    out += "\r\nContent-Length: ";
+    n = std::snprintf(line, sizeof(line), "%zu", body_len);
+    out.append(line, static_cast<size_t>(n));
+    out += "\r\n";
+    if (!keep_alive) out += "Connection: close\r\n";
+    else if (http10) out += "Connection: keep-alive\r\n";
+}
+
+static void append_error(Conn& c, int status) {
+    const char* reason = reason_phrase(status);
+    append_head(c.out, status, std::strlen(reason), false, false);
+    c.out += "Content-Type: text/plain; charset=utf-8\r\n\r\n";
+    c.out += reason;
+    c.close_after = true;
+}
+
+/**
+ * Serialize the handler's return value
+ * A string is a 200 text/plain body. A map may give status, headers and
+ * either body (string) or json (any value, stringified with an
+ * application/json content type). Anything else is formatted as text.
+ */
+static void append_response(Conn& c, const Request& req, uint64_t r, std::string& body) {
+    long status = 200;
+    const char* content_type = "text/plain; charset=utf-8";
+    ObjMap* headers = nullptr;
+    body.clear();
+    if (is_obj(r) && obj_type(r) == ObjType::MAP) {
+        ObjMap* m = as_map(r);
+        auto field = [&](const char* key) -> uint64_t {
+            auto it = m->data.find(g_strings.intern(key));
+            return it == m->data.end() ? VAL_NONE : it->second;
+        };
+        uint64_t v = field("status");
+        if (v != VAL_NONE) status = native_long(v);
+        if (status < 100 || status > 599) status = 500;
+        v = field("headers");
+        if (is_obj(v) && obj_type(v) == ObjType::MAP) headers = as_map(v);
+        v = field("json");
+        if (v != VAL_NONE) {
+            json_bindings::stringify_fast(v, body);
+            content_type = "application/json";
+        } else if ((v = field("body")) != VAL_NONE) {
+            std::string tmp;
+            std::string_view b = native_string(v, tmp);
+            body.assign(b.data(), b.size());
+        }
+    } else if (r != VAL_NONE) {
+        std::string tmp;
+        std::string_view b = native_string(r, tmp);
+        body.assign(b.data(), b.size());
+    }
+
+    bool keep_alive = req.keep_alive && !c.close_after;
+    append_head(c.out, status, body.size(), keep_alive, req.version == "HTTP/1.0");
+    bool typed = false;
+    if (headers) {
+        std::string tmp;
+        for (const auto& kv : headers->data) {
+            std::string_view name(kv.first->chars, kv.first->length);
+            if (iequals(name, "content-length") || iequals(name, "connection")) continue;
+            if (iequals(name, "content-type")) typed = true;
+            c.out.append(name.data(), name.size());
+            c.out += ": ";
+            std::string_view value = native_string(kv.second, tmp);
+            c.out.append(value.data(), value.size());
+            c.out += "\r\n";
+        }
+    }
+    if (!typed) {
+        c.out += "Content-Type: ";
+        c.out += content_type;
+        c.out += "\r\n";
+    }
+    c.out += "\r\n";
+    if (req.method != "HEAD") c.out += body;
+    if (!keep_alive) c.close_after = true;
+}
+
+static void close_fd(int fd) {
+#ifdef _WIN32
+    closesocket(fd);
+#else
+    close(fd);
+#endif
+}
+
+// Event loop of one worker; runs on a pool thread with the handler's isolate
+static void serve_worker(Server& server, FastVM& vm, uint64_t handler) {
+#ifdef _WIN32
+    const int flags = 0;
+#else
+    const int flags = MSG_DONTWAIT;
+#endif
+    const long LISTENER = 1;
+    async_bindings::Reactor reactor;
+    {
+        std::lock_guard<std::mutex> lk(server.mu);
+        server.reactors.push_back(&reactor);
+    }
+    reactor.watch(server.listen_fd, LISTENER, false);
+
+    std::unordered_map<long, Conn> conns;
+    long next_id = LISTENER + 1;
+    std::vector<long> ready;
+    std::string body;
+    char buf[65536];
+    const Options& opts = server.opts;
+    const auto idle_timeout = std::chrono::milliseconds(opts.idle_timeout_ms);
+
+    auto close_conn = [&](long id) {
+        auto it = conns.find(id);
+        if (it == conns.end()) return;
+        reactor.unwatch(it->second.fd, id);
+        close_fd(it->second.fd);
+        conns.erase(it);
+    };
+    auto set_writing = [&](long id, Conn& c, bool writing) {
+        if (c.writing == writing) return;
+        reactor.unwatch(c.fd, id);
+        reactor.watch(c.fd, id, writing);
+        c.writing = writing;
+    };
+    // Send what is queued; false once the connection is gone
+    auto flush = [&](long id, Conn& c) -> bool {
+        while (c.out_pos < c.out.size()) {
+            int n = static_cast<int>(send(c.fd, c.out.data() + c.out_pos,
+                                          static_cast<int>(c.out.size() - c.out_pos), flags));
+            if (n > 0) {
+                c.out_pos += static_cast<size_t>(n);
+                continue;
+            }
+            if (n < 0 && net_bindings::socket_would_block()) {
+                set_writing(id, c, true);
                 return true;
             }
+            close_conn(id);
+            return false;
         }
-        
-        return false;
-    }
-    
-    /**
-     * Main optimization pass: Apply all safe transformations
-     * 
-     * This is a single-pass optimizer that applies pattern-based rewrites.
-     * Multiple passes could be added for more aggressive optimization.
-     */
-    std::vector<uint8_t> optimize_bytecode(const std::vector<uint8_t>& original, 
-                                           std::vector<Guard>& guards,
-                                           Chunk* chunk) {
-        std::vector<uint8_t> optimized;
-        optimized.reserve(original.size());
-        
-        size_t i = 0;
-        while (i < original.size()) {
-            size_t remaining = original.size() - i;
-            const uint8_t* ip = &original[i];
-            
-            // Try each optimization pattern
-            size_t old_size = optimized.size();
-            
-            // Pattern 1: Constant folding
-            if (try_constant_fold(ip, remaining, optimized, chunk)) {
-                i += 5;  // Consumed 5 bytes
+        c.out.clear();
+        c.out_pos = 0;
+        if (c.close_after) {
+            close_conn(id);
+            return false;
+        }
+        set_writing(id, c, false);
+        return true;
+    };
+    // Answer every complete request in the buffer (pipelined requests are
+    // answered in order); stops early while output is backed up
+    auto process = [&](long id, Conn& c) -> bool {
+        Request req;
+        while (!c.close_after && c.out.size() - c.out_pos < (1u << 20)) {
+            size_t consumed = 0;
+            int status = 0;
+            ParseResult pr = parse_request(c, opts, req, consumed, status);
+            if (pr == ParseResult::NEED_MORE) break;
+            if (pr == ParseResult::BAD) {
+                append_error(c, status);
+                break;
+            }
+            uint64_t arg = request_value(req);
+            try {
+                uint64_t r = vm.run_function(handler, &arg, 1);
+                append_response(c, req, r, body);
+            } catch (const std::exception& e) {
+                // A failing handler answers 500; the server keeps running
+                std::cerr << "http.serve: handler error: " << e.what() << std::endl;
+                append_error(c, 500);
+            }
+            c.in_pos += consumed;
+            c.scan = c.in_pos;
+            if (g_heap.should_collect()) gc_collect();  // Safepoint: nothing live but the isolate's roots
+            long total = server.served.fetch_add(1) + 1;
+            if (opts.max_requests > 0 && total >= opts.max_requests) {
+                c.close_after = true;
+                server.stop();
+            }
+        }
+        if (c.in_pos == c.in.size()) {
+            c.in.clear();
+            c.in_pos = c.scan = 0;
+        } else if (c.in_pos > 0 && c.in_pos >= c.in.size() / 2) {
+            c.in.erase(0, c.in_pos);
+            c.scan -= std::min(c.scan, c.in_pos);
+            c.in_pos = 0;
+        }
+        return flush(id, c);
+    };
+
+    while (!server.stopping.load()) {
+        ready.clear();
+        {
+            BlockingWait parked;
+            reactor.wait(opts.idle_timeout_ms > 0 ? std::min(opts.idle_timeout_ms, 1000) : 1000, 256, ready);
+        }
+        auto now = std::chrono::steady_clock::now();
+        for (long id : ready) {
+            if (id == LISTENER) {
+                // Level-triggered and shared: losing the race to another
+                // worker just returns EAGAIN
+                for (int i = 0; i < 64; ++i) {
+                    int fd = static_cast<int>(accept(server.listen_fd, nullptr, nullptr));
+                    if (fd < 0) break;
+                    net_bindings::set_socket_nonblocking(fd, true);
+                    int one = 1;
+                    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&one), sizeof(one));
+                    long cid = next_id++;
+                    Conn& c = conns[cid];
+                    c.fd = fd;
+                    c.last_active = now;
+                    reactor.watch(fd, cid, false);
+                }
+                continue;
+            }
+            auto it = conns.find(id);
+            if (it == conns.end()) continue;
+            Conn& c = it->second;
+            c.last_active = now;
+            if (c.writing) {
+                if (flush(id, c) && !c.writing) process(id, c);
                 continue;
             }
-            
-            // Pattern 2: Strength reduction
-            if (try_strength_reduce(ip, remaining, optimized)) {
-                i += 5;  // Consumed 5 bytes
+            bool closed = false;
+            while (true) {
+                int n = static_cast<int>(recv(c.fd, buf, sizeof(buf), flags));
+                if (n > 0) {
+                    c.in.append(buf, static_cast<size_t>(n));
+                    if (static_cast<size_t>(n) < sizeof(buf)) break;
+                    continue;
+                }
+                if (n < 0 && net_bindings::socket_would_block()) break;
+                closed = true;  // Peer closed or the connection failed
+                break;
+            }
+            if (closed) {
+                close_conn(id);
                 continue;
             }
-            
-            // No pattern matched - copy original instruction
-            optimized.push_back(original[i]);
-            
-            // Copy operands for multi-byte instructions
-            OpCode op = (OpCode)original[i];
-            switch (op) {
-                case OpCode::OP_CONST:
-                case OpCode::OP_GET_GLOBAL:
-                case OpCode::OP_SET_GLOBAL:
-                case OpCode::OP_DEFINE_GLOBAL:
-                case OpCode::OP_JUMP:
-                case OpCode::OP_JUMP_IF_FALSE:
-                case OpCode::OP_LOOP:
-                case OpCode::OP_ITER_NEXT:
-                case OpCode::OP_GET_PROPERTY:
-                case OpCode::OP_SET_PROPERTY:
-                case OpCode::OP_IMPORT:
-                case OpCode::OP_TRY:
-                    // 16-bit operand
-                    if (i + 2 < original.size()) {
-                        optimized.push_back(original[i + 1]);
-                        optimized.push_back(original[i + 2]);
-                        i += 3;
-                    } else {
-                        i++;
-                    }
-                    break;
-                
-                case OpCode::OP_CONST_INT:
-                case OpCode::OP_GET_LOCAL:
-                case OpCode::OP_SET_LOCAL:
-                case OpCode::OP_CALL:
-                case OpCode::OP_BUILTIN_RANGE:
-                case OpCode::OP_BUILD_LIST:
-                case OpCode::OP_BUILD_TUPLE:
-                case OpCode::OP_UNPACK_TUPLE:
-                case OpCode::OP_BUILD_MAP:
-                case OpCode::OP_TENSOR_CREATE:
-                case OpCode::OP_BUILTIN_GETATTR:
-                    // 8-bit operand
-                    if (i + 1 < original.size()) {
-                        optimized.push_back(original[i + 1]);
-                        i += 2;
-                    } else {
-                        i++;
-                    }
-                    break;
-                
-                case OpCode::OP_METHOD_CALL:
-                case OpCode::OP_INVOKE_METHOD:
-                case OpCode::OP_SUPER_INVOKE:
-                    // Mixed operands: 8-bit + 16-bit or 16-bit + 8-bit
-                    if (i + 3 < original.size()) {
-                        optimized.push_back(original[i + 1]);
-                        optimized.push_back(original[i + 2]);
-                        optimized.push_back(original[i + 3]);
-                        i += 4;
-                    } else {
-                        i++;
-                    }
-                    break;
-                
-                default:
-                    // No operands
-                    i++;
-                    break;
+            process(id, c);
+        }
+        if (opts.idle_timeout_ms > 0) {
+            for (auto it = conns.begin(); it != conns.end();) {
+                long id = it->first;
+                Conn& c = it->second;
+                ++it;
+                if (!c.writing && now - c.last_active > idle_timeout) close_conn(id);
             }
         }
-        
-        return optimized;
     }
-    
-    /**
-     * Specialize function for observed type patterns
-     * 
-     * This generates type-specialized versions with guards.
-     * Example: If we observe f(int, int) → int consistently, 
-     * we generate a fast path with integer-only operations.
-     */
-    void specialize_function(uint8_t* func_start, Chunk* chunk) {
-        // Check if already optimized
-        if (optimized_functions.find(func_start) != optimized_functions.end()) {
-            return;
+
+    // Best effort: answers already queued go out before the connections close
+    for (auto& kv : conns) {
+        net_bindings::set_socket_nonblocking(kv.second.fd, false);
+        Conn& c = kv.second;
+        while (c.out_pos < c.out.size()) {
+            int n = static_cast<int>(send(c.fd, c.out.data() + c.out_pos,
+                                          static_cast<int>(c.out.size() - c.out_pos), 0));
+            if (n <= 0) break;
+            c.out_pos += static_cast<size_t>(n);
         }
-        
-        // Create optimized version
-        OptimizedCode opt;
-        
-        // For now, just copy original (real impl would analyze types)
-        opt.original_code = chunk->code;
-        
-        // Apply bytecode-level optimizations
-        opt.code = optimize_bytecode(chunk->code, opt.guards, chunk);
-        
-        // Only activate if we actually optimized something
-        if (opt.code.size() < chunk->code.size()) {
-            opt.active = true;
-            optimized_functions[func_start] = std::move(opt);
+        reactor.unwatch(c.fd, kv.first);
+        close_fd(c.fd);
+    }
+    reactor.unwatch(server.listen_fd, LISTENER);
+    std::lock_guard<std::mutex> lk(server.mu);
+    server.reactors.erase(std::find(server.reactors.begin(), server.reactors.end(), &reactor));
+}
+
+static void read_options(uint64_t v, Options& opts) {
+    if (!is_obj(v) || obj_type(v) != ObjType::MAP) {
+        if (v != VAL_NONE) throw std::runtime_error("http.serve: options must be a map");
+        return;
+    }
+    ObjMap* m = as_map(v);
+    for (const auto& kv : m->data) {
+        std::string_view key(kv.first->chars, kv.first->length);
+        std::string tmp;
+        if (key == "host") opts.host = std::string(native_string(kv.second, tmp));
+        else if (key == "workers") opts.workers = static_cast<size_t>(std::max(1L, native_long(kv.second)));
+        else if (key == "max_requests") opts.max_requests = native_long(kv.second);
+        else if (key == "idle_timeout_ms") opts.idle_timeout_ms = static_cast<int>(native_long(kv.second));
+        else if (key == "max_body_bytes") opts.max_body_bytes = static_cast<size_t>(native_long(kv.second));
+        else if (key == "max_header_bytes") opts.max_header_bytes = static_cast<size_t>(native_long(kv.second));
+        else if (key == "port_file") opts.port_file = std::string(native_string(kv.second, tmp));
+        else throw std::runtime_error("http.serve: unknown option '" + std::string(key) + "'");
+    }
+}
+
+/**
+ * http.serve(port, handler, options) -> requests served
+ * Workers run on the isolate pool, each with its own readiness loop over the
+ * shared listening socket and its own copy of the handler's globals (as for
+ * thread.spawn). Blocks until max_requests have been answered or a handler
+ * calls http.shutdown().
+ */
+uint64_t native_http_serve(VMContext& ctx, const uint64_t* args, uint8_t argc) {
+    long port = native_long(native_arg(args, argc, 0));
+    uint64_t handler = native_arg(args, argc, 1);
+    if (!is_obj(handler) || obj_type(handler) != ObjType::FUNCTION) {
+        throw std::runtime_error("http.serve expects a handler function");
+    }
+    ObjFunc* fn = as_func(handler);
+    if (fn->chunk->is_async || fn->arity != 1) {
+        throw std::runtime_error("http.serve: handler must be a plain act taking one request");
+    }
+    auto server = std::make_unique<Server>();
+    read_options(argc > 2 ? args[2] : VAL_NONE, server->opts);
+    size_t pool_size = Pool::get().size();
+    size_t workers = server->opts.workers ? std::min(server->opts.workers, pool_size) : pool_size;
+
+    server->listen_fd = net_bindings::listen_socket(server->opts.host, std::to_string(port), 1024);
+    if (server->listen_fd < 0) {
+        throw std::runtime_error("http.serve: cannot listen on port " + std::to_string(port) + ": " +
+                                 net_bindings::socket_error_text());
+    }
+    net_bindings::set_socket_nonblocking(server->listen_fd, true);
+    if (!server->opts.port_file.empty()) {
+        // Written once the socket listens, so a reader can connect right away
+        sockaddr_storage ss{};
+#ifdef _WIN32
+        int slen = static_cast<int>(sizeof(ss));
+#else
+        socklen_t slen = sizeof(ss);
+#endif
+        getsockname(server->listen_fd, reinterpret_cast<sockaddr*>(&ss), &slen);
+        int bound = ntohs(ss.ss_family == AF_INET6 ? reinterpret_cast<sockaddr_in6*>(&ss)->sin6_port
+                                                   : reinterpret_cast<sockaddr_in*>(&ss)->sin_port);
+        std::string tmp_path = server->opts.port_file + ".tmp";
+        std::ofstream(tmp_path) << bound << "\n";
+        std::error_code ec;
+        fs::rename(tmp_path, server->opts.port_file, ec);
+        if (ec) {
+            close_fd(server->listen_fd);
+            throw std::runtime_error("http.serve: cannot write port_file: " + ec.message());
         }
     }
-};
+    if (!g_heap.isolate) g_strings.publish_shared();
+
+    Transfer fn_copy;
+    pack(handler, fn_copy);
+    auto globals = snapshot_globals(*ctx.vm);
+    {
+        std::lock_guard<std::mutex> lk(g_servers_mu);
+        g_servers.push_back(server.get());
+    }
+    std::vector<std::shared_ptr<Job>> jobs;
+    Server* srv = server.get();
+    for (size_t i = 0; i < workers; ++i) {
+        auto job = std::make_shared<Job>();
+        job->globals = globals;
+        job->native = [srv, &fn_copy](FastVM& vm) {
+            Isolate::Level& level = t_isolate.levels[t_isolate.depth - 1];
+            uint64_t h = unpack(fn_copy);
+            level.pinned.push_back(h);
+            serve_worker(*srv, vm, h);
+        };
+        jobs.push_back(job);
+        Pool::get().submit(std::move(job));
+    }
+    for (auto& job : jobs) wait_for(*job);
+    {
+        std::lock_guard<std::mutex> lk(g_servers_mu);
+        g_servers.erase(std::find(g_servers.begin(), g_servers.end(), srv));
+    }
+    close_fd(server->listen_fd);
+    return val_int(server->served.load());
+}
+
+// http.shutdown(): stop every running http.serve once in-flight requests are answered
+uint64_t native_http_shutdown(VMContext&, const uint64_t*, uint8_t) {
+    std::lock_guard<std::mutex> lk(g_servers_mu);
+    for (Server* s : g_servers) s->stop();
+    return val_int(static_cast<int64_t>(g_servers.size()));
+}
+} // namespace http_server
 
 
 // ============================================================================
@@ -28045,31 +37020,22 @@ bool set_executable_permissions(const fs::path& path) {
 }  // namespace packager
 
 int execute_levython_source(const std::string& code) {
-    Lexer lexer(code);
-    auto tokens = lexer.tokenize();
-    Parser parser(tokens);
-    auto ast = parser.parse();
-    std::function<bool(ASTNode*)> imports_local_module = [&](ASTNode* node) -> bool {
-        if (!node) return false;
-        if (node->type == NodeType::IMPORT) {
-            const std::string& module_name = node->value;
-            fs::path p1 = module_name + ".levy";
-            fs::path p2 = module_name + ".ly";
-            if (fs::exists(p1) || fs::exists(p2)) return true;
-        }
-        for (const auto& child : node->children) {
-            if (imports_local_module(child.get())) return true;
-        }
-        return false;
-    };
+    auto chunk = bytecode_cache::compile(code);
+    FastVM vm;
+    vm.run(chunk.get());
+    return 0;
+}
 
-    if (imports_local_module(ast.get())) {
-        Interpreter().interpret(ast.get());
-        return 0;
+// Embedded app payloads are bytecode images; older executables embed source
+int execute_embedded_payload(const std::string& payload) {
+    if (!bytecode_cache::is_bytecode(payload.data(), payload.size())) {
+        return execute_levython_source(payload);
+    }
+    auto chunk = bytecode_cache::load_image(payload);
+    if (!chunk) {
+        std::cerr << "Embedded bytecode was built by an incompatible runtime" << std::endl;
+        return 1;
     }
-
-    Compiler compiler;
-    auto chunk = compiler.compile(ast.get());
     FastVM vm;
     vm.run(chunk.get());
     return 0;
@@ -28083,8 +37049,25 @@ struct BuildOptions {
     std::string runtime_path;            // optional prebuilt runtime path
     std::string source_root = ".";       // used for cross-compile runtime build
     bool verbose = false;
+    bool pgo = false;                    // instrumented build + training run + -fprofile-use
+    bool lto = false;                    // link-time optimization (implied by --pgo)
+    std::string train_script;            // PGO training workload (default: the app itself)
+    std::vector<std::string> without;    // native modules compiled out: audio, display, hooks
 };
 
+// Options that need a runtime compiled from --source-root
+bool rebuilds_runtime(const BuildOptions& opts) {
+    return opts.pgo || opts.lto || !opts.without.empty();
+}
+
+// Preprocessor switch that compiles a native module out (nullptr if unknown)
+const char* module_macro(const std::string& name) {
+    if (name == "audio") return "LEVYTHON_NO_AUDIO";
+    if (name == "display") return "LEVYTHON_NO_DISPLAY";
+    if (name == "hooks") return "LEVYTHON_NO_HOOKS";
+    return nullptr;
+}
+
 std::string shell_quote(const std::string& s) {
     std::string out = "'";
     for (char c : s) {
@@ -28124,6 +37107,184 @@ bool is_windows_target(const std::string& normalized_target) {
     return normalized_target.find("windows") != std::string::npos;
 }
 
+bool find_runtime_sources(const BuildOptions& opts, fs::path& levython_cpp, fs::path& http_client_cpp) {
+    fs::path src_root = fs::absolute(opts.source_root).lexically_normal();
+    levython_cpp = src_root / "src" / "levython.cpp";
+    http_client_cpp = src_root / "src" / "http_client.cpp";
+    if (!fs::exists(levython_cpp) || !fs::exists(http_client_cpp)) {
+        std::cerr << "Build error: source files not found under --source-root: " << src_root.string() << std::endl;
+        std::cerr << "Expected: src/levython.cpp and src/http_client.cpp" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Module switches plus the section flags that let the linker drop what
+// they leave unreferenced
+std::string runtime_unit_flags(const BuildOptions& opts) {
+    std::string flags;
+    for (const std::string& name : opts.without) flags += std::string(" -D") + module_macro(name);
+    if (rebuilds_runtime(opts)) flags += " -ffunction-sections -fdata-sections";
+    return flags;
+}
+
+// Whether a --without-able module is compiled into the runtime
+bool builds_module(const BuildOptions& opts, const char* name) {
+    return std::find(opts.without.begin(), opts.without.end(), name) == opts.without.end();
+}
+
+// Host link line for a runtime built by `levython build` (mirrors the
+// Makefile). On Linux ALSA is only linked when the audio module is compiled
+// in; X11 and XTest stay, since os.InputControl is always built.
+std::string runtime_link_flags(const BuildOptions& opts) {
+#if defined(__APPLE__)
+    (void)opts;
+    return " -Wl,-dead_strip -lssl -lcrypto -framework Security -framework CoreFoundation"
+           " -framework CoreGraphics -framework ApplicationServices -framework CoreAudio -framework AudioToolbox";
+#elif defined(_WIN32)
+    (void)opts;
+    return " -Wl,--gc-sections -s -lssl -lcrypto -lws2_32 -lcrypt32";
+#else
+    std::string flags = " -Wl,--gc-sections -Wl,--as-needed -s -lssl -lcrypto -lpthread -ldl";
+    if (builds_module(opts, "audio")) flags += " -lasound";
+    return flags + " -lX11 -lXtst";
+#endif
+}
+
+// Private scratch directory for one build; mkdtemp picks a name no other
+// build can be using
+bool make_work_dir(fs::path& out) {
+    std::error_code ec;
+    fs::path base = fs::temp_directory_path(ec);
+    if (ec) return false;
+#ifdef _WIN32
+    std::random_device rd;
+    for (int attempt = 0; attempt < 100; ++attempt) {
+        fs::path dir = base / ("levython_build_" + std::to_string(GetCurrentProcessId()) + "_" + std::to_string(rd()));
+        if (fs::create_directory(dir, ec)) {
+            out = dir;
+            return true;
+        }
+        if (ec) return false;
+    }
+    return false;
+#else
+    std::string tmpl = (base / "levython_build_XXXXXX").string();
+    if (!mkdtemp(tmpl.data())) return false;
+    out = tmpl;
+    return true;
+#endif
+}
+
+int run_build_command(const std::string& cmd, bool verbose) {
+    if (verbose) std::cout << "[build] " << cmd << std::endl;
+    return std::system(cmd.c_str());
+}
+
+bool compiler_is_clang(const std::string& cxx) {
+#ifdef _WIN32
+    std::string probe = cxx + " --version 2>nul | findstr /i clang >nul";
+#else
+    std::string probe = cxx + " --version 2>/dev/null | grep -qi clang";
+#endif
+    return std::system(probe.c_str()) == 0;
+}
+
+// Native runtime compiled from --source-root with LTO, optionally guided by
+// a profile from an instrumented build running the app (or --train script).
+// Both passes compile to the same object paths so GCC finds its .gcda files.
+int build_optimized_runtime(const BuildOptions& opts, const fs::path& work_dir, fs::path& out_runtime_path) {
+    fs::path levython_cpp, http_client_cpp;
+    if (!find_runtime_sources(opts, levython_cpp, http_client_cpp)) return 1;
+
+    const char* env_cxx = std::getenv("CXX");
+    std::string cxx = (env_cxx && *env_cxx) ? env_cxx : "c++";
+    if (!command_exists(cxx)) {
+        std::cerr << "Build error: C++ compiler `" << cxx << "` not found (set CXX)." << std::endl;
+        return 1;
+    }
+    bool clang = compiler_is_clang(cxx);
+    std::string flags = "-std=c++17 -O3 -DNDEBUG" + runtime_unit_flags(opts);
+
+    auto compile_runtime = [&](const std::string& extra, const fs::path& exe) {
+        std::string objects;
+        for (const fs::path& src : {levython_cpp, http_client_cpp}) {
+            fs::path obj = work_dir / (src.stem().string() + ".o");
+            std::string cmd = cxx + " " + flags + extra + " -c " + shell_quote(src.string()) +
+                              " -o " + shell_quote(obj.string());
+            if (run_build_command(cmd, opts.verbose) != 0) return false;
+            objects += " " + shell_quote(obj.string());
+        }
+        std::string link = cxx + " " + flags + extra + objects + " -o " + shell_quote(exe.string()) +
+                           runtime_link_flags(opts);
+        return run_build_command(link, opts.verbose) == 0 && fs::exists(exe);
+    };
+
+    std::string exe_suffix;
+#ifdef _WIN32
+    exe_suffix = ".exe";
+#endif
+    std::string final_flags = clang ? " -flto=thin" : " -flto=auto";
+    if (opts.pgo) {
+        fs::path profile_dir = work_dir / "profile";
+        fs::path instrumented = work_dir / ("levython-instrumented" + exe_suffix);
+        std::cout << "[build] compiling instrumented runtime..." << std::endl;
+        if (!compile_runtime(" -fprofile-generate=" + shell_quote(profile_dir.string()) +
+                             " -fprofile-update=atomic", instrumented)) {
+            std::cerr << "Build error: instrumented runtime compile failed" << std::endl;
+            return 1;
+        }
+
+        std::string training = opts.train_script.empty() ? opts.input_source : opts.train_script;
+        std::cout << "[build] training on " << training << "..." << std::endl;
+        int rc = run_build_command(shell_quote(instrumented.string()) + " --no-update-check --no-cache " +
+                                   shell_quote(training), opts.verbose);
+        std::error_code ec;
+        if (!fs::is_directory(profile_dir, ec) || fs::is_empty(profile_dir, ec)) {
+            std::cerr << "Build error: the training run wrote no profile" << std::endl;
+            return 1;
+        }
+        if (rc != 0) {
+            std::cerr << "Build warning: training run exited with status " << rc
+                      << "; using the profile it wrote" << std::endl;
+        }
+
+        if (clang) {
+            // Clang writes raw profiles that have to be merged first
+#ifdef __APPLE__
+            std::string profdata_tool = "xcrun llvm-profdata";
+#else
+            std::string profdata_tool = "llvm-profdata";
+            if (!command_exists(profdata_tool)) {
+                std::cerr << "Build error: --pgo with clang needs `llvm-profdata` in PATH." << std::endl;
+                return 1;
+            }
+#endif
+            fs::path profdata = work_dir / "levython.profdata";
+            std::string merge = profdata_tool + " merge -output=" + shell_quote(profdata.string()) + " " +
+                                shell_quote(profile_dir.string());
+            if (run_build_command(merge, opts.verbose) != 0) {
+                std::cerr << "Build error: llvm-profdata merge failed" << std::endl;
+                return 1;
+            }
+            final_flags += " -fprofile-use=" + shell_quote(profdata.string());
+        } else {
+            // Code the training run never reached stays optimized for speed
+            final_flags += " -fprofile-use=" + shell_quote(profile_dir.string()) +
+                           " -fprofile-partial-training -Wno-missing-profile";
+        }
+    }
+
+    fs::path runtime = work_dir / ("levython" + exe_suffix);
+    std::cout << "[build] compiling optimized runtime..." << std::endl;
+    if (!compile_runtime(final_flags, runtime)) {
+        std::cerr << "Build error: optimized runtime compile failed" << std::endl;
+        return 1;
+    }
+    out_runtime_path = runtime;
+    return 0;
+}
+
 int build_runtime_for_target(const std::string& self_exe_path,
                              const BuildOptions& opts,
                              fs::path& out_runtime_path) {
@@ -28148,20 +37309,14 @@ int build_runtime_for_target(const std::string& self_exe_path,
         return 1;
     }
 
-    fs::path src_root = fs::absolute(opts.source_root);
-    fs::path levython_cpp = src_root / "src" / "levython.cpp";
-    fs::path http_client_cpp = src_root / "src" / "http_client.cpp";
-    if (!fs::exists(levython_cpp) || !fs::exists(http_client_cpp)) {
-        std::cerr << "Build error: source files not found under --source-root: " << src_root.string() << std::endl;
-        std::cerr << "Expected: src/levython.cpp and src/http_client.cpp" << std::endl;
-        return 1;
-    }
+    fs::path levython_cpp, http_client_cpp;
+    if (!find_runtime_sources(opts, levython_cpp, http_client_cpp)) return 1;
 
     fs::path runtime_out = fs::temp_directory_path() / ("levython_runtime_" + std::to_string(std::time(nullptr)));
     if (is_windows_target(nt)) runtime_out += ".exe";
 
     std::ostringstream cmd;
-    cmd << "zig c++ -std=c++17 -O3 "
+    cmd << "zig c++ -std=c++17 -O3" << runtime_unit_flags(opts) << (opts.lto ? " -flto " : " ")
         << shell_quote(levython_cpp.string()) << " "
         << shell_quote(http_client_cpp.string()) << " "
         << "-o " << shell_quote(runtime_out.string()) << " "
@@ -28169,8 +37324,10 @@ int build_runtime_for_target(const std::string& self_exe_path,
 
     if (nt.find("macos") != std::string::npos) {
         cmd << "-framework Security -framework CoreFoundation ";
+        if (rebuilds_runtime(opts)) cmd << "-Wl,-dead_strip ";
     } else {
         cmd << "-lssl -lcrypto ";
+        if (rebuilds_runtime(opts)) cmd << "-Wl,--gc-sections -s ";
     }
 
     if (opts.verbose) {
@@ -28206,6 +37363,51 @@ int build_native_executable(const std::string& self_exe_path,
         return 1;
     }
 
+    if (rebuilds_runtime(opts) && normalize_target(opts.target) == "native") {
+        if (!opts.runtime_path.empty()) {
+            std::cerr << "Build error: --runtime cannot be combined with --pgo, --lto or --without" << std::endl;
+            return 1;
+        }
+        fs::path work_dir;
+        if (!make_work_dir(work_dir)) {
+            std::cerr << "Build error: cannot create a build directory: " << std::strerror(errno) << std::endl;
+            return 1;
+        }
+        std::error_code ec;
+        fs::path runtime_path;
+        int rc = build_optimized_runtime(opts, work_dir, runtime_path);
+        if (rc == 0) {
+            // The new runtime packages itself so the payload is bytecode it can run
+#ifdef _WIN32
+            const char* quiet = " >nul";
+#else
+            const char* quiet = " >/dev/null";
+#endif
+            std::string package = shell_quote(runtime_path.string()) + " build " + shell_quote(input_source) +
+                                  " -o " + shell_quote(output_exe) + quiet;
+            if (run_build_command(package, opts.verbose) != 0) {
+                std::cerr << "Build error: packaging with the optimized runtime failed" << std::endl;
+                rc = 1;
+            }
+        }
+        fs::remove_all(work_dir, ec);
+        if (rc != 0) return rc;
+        std::cout << "Built standalone executable: " << output_exe << std::endl;
+        std::cout << "Runtime: " << (opts.pgo ? "PGO + LTO" : "LTO") << " build of "
+                  << fs::absolute(opts.source_root).lexically_normal().string() << std::endl;
+        if (!opts.without.empty()) {
+            std::cout << "Modules left out:";
+            for (const std::string& name : opts.without) std::cout << " " << name;
+            std::cout << std::endl;
+        }
+        std::cout << "Target: native" << std::endl;
+        return 0;
+    }
+    if (opts.pgo) {
+        std::cerr << "Build error: --pgo needs the native target (the training run executes the runtime)" << std::endl;
+        return 1;
+    }
+
     fs::path runtime_path;
     int runtime_rc = build_runtime_for_target(self_exe_path, opts, runtime_path);
     if (runtime_rc != 0) return runtime_rc;
@@ -28219,7 +37421,12 @@ int build_native_executable(const std::string& self_exe_path,
         std::cerr << "Build error: Cannot write output executable: " << output_exe << std::endl;
         return 1;
     }
-    if (!packager::append_embedded_payload(output_exe, source_code)) {
+    // The runner's own build can execute bytecode it compiles; other
+    // runtimes may differ in opcode layout, so they get the source
+    std::string payload;
+    if (runtime_path == fs::path(self_exe_path)) payload = bytecode_cache::compile_image(source_code);
+    if (payload.empty()) payload = source_code;
+    if (!packager::append_embedded_payload(output_exe, payload)) {
         std::cerr << "Build error: Cannot embed payload into executable: " << output_exe << std::endl;
         return 1;
     }
@@ -28232,12 +37439,66 @@ int build_native_executable(const std::string& self_exe_path,
 }
 
 
+static const std::chrono::steady_clock::time_point g_process_start = std::chrono::steady_clock::now();
+
+// Peak resident set size in KB (0 if unknown)
+static uint64_t peak_rss_kb() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return pmc.PeakWorkingSetSize / 1024;
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return (uint64_t)usage.ru_maxrss / 1024;  // Bytes on macOS
+#else
+    return (uint64_t)usage.ru_maxrss;
+#endif
+#endif
+}
+
+// Allocator and collector report for --heap-stats, printed to stderr at exit
+// (bench/run.levy parses the "allocations", "peak rss" and "run time" lines)
+static void print_heap_stats() {
+    static const char* type_names[OBJ_TYPE_COUNT] = {
+        "string", "list", "function", "range", "map", "class", "instance", "native", "coroutine",
+        "tensor", "bytes", "reader"
+    };
+    const ObjPool::Stats& ps = g_pool.get_stats();
+    std::fprintf(stderr, "\n=== heap stats ===\n");
+    std::fprintf(stderr, "allocations by type:\n");
+    uint64_t total_allocations = 0;
+    for (size_t i = 0; i < OBJ_TYPE_COUNT; i++) {
+        if (g_heap.allocations[i] == 0) continue;
+        total_allocations += g_heap.allocations[i];
+        std::fprintf(stderr, "  %-10s %12llu\n", type_names[i],
+                     (unsigned long long)g_heap.allocations[i]);
+    }
+    std::fprintf(stderr, "allocations:      %llu\n", (unsigned long long)total_allocations);
+    std::fprintf(stderr, "live objects:     %llu (%.1f KB at last collection)\n",
+                 (unsigned long long)g_heap.object_count, g_heap.live_bytes / 1024.0);
+    std::fprintf(stderr, "collections:      %llu (%.3f ms total pause)\n",
+                 (unsigned long long)g_heap.collections, g_heap.pause_ms);
+    std::fprintf(stderr, "freed:            %llu objects, %.1f KB\n",
+                 (unsigned long long)g_heap.freed_objects, g_heap.freed_bytes / 1024.0);
+    std::fprintf(stderr, "pool blocks:      %zu (%.1f KB reserved)\n",
+                 g_pool.block_count(), ps.block_bytes / 1024.0);
+    std::fprintf(stderr, "pool cells:       %llu bump, %llu reused, %llu released, %llu large\n",
+                 (unsigned long long)ps.bump_allocs, (unsigned long long)ps.reused,
+                 (unsigned long long)ps.released, (unsigned long long)ps.large_allocs);
+    std::fprintf(stderr, "peak rss:         %llu KB\n", (unsigned long long)peak_rss_kb());
+    std::fprintf(stderr, "run time:         %.3f ms\n",
+                 std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - g_process_start).count());
+}
+
 // Main function to run the interpreter
 int main(int argc, char* argv[]) {
     os_bindings::set_cli_args(argc, argv);
     // Build command:
     // levython build <input.levy|.ly> [-o output] [--target native|windows|linux|macos|triple]
     //                                  [--runtime /path/to/runtime] [--source-root /path/to/repo]
+    //                                  [--lto] [--pgo [--train script]] [--without audio,display,hooks]
     if (argc >= 2 && std::string(argv[1]) == "build") {
         if (argc == 2 || (argc >= 3 && (std::string(argv[2]) == "--help" || std::string(argv[2]) == "-h"))) {
             std::cout << "Usage: levython build <input.levy|.ly> [options]\n\n"
@@ -28246,9 +37507,16 @@ int main(int argc, char* argv[]) {
                       << "  --target <t>             native|windows|linux|macos|<target-triple>\n"
                       << "  --runtime <file>         Use prebuilt runtime binary instead of compiling\n"
                       << "  --source-root <dir>      Source root for cross-runtime compile (default: .)\n"
-                      << "  --verbose                Print cross-compile command\n\n"
+                      << "  --verbose                Print cross-compile command\n"
+                      << "  --lto                    Compile the runtime from --source-root with LTO\n"
+                      << "  --pgo                    LTO plus profile-guided optimization: build an\n"
+                      << "                           instrumented runtime, run the app, rebuild\n"
+                      << "  --train <file>           PGO training script (default: the app itself)\n"
+                      << "  --without <list>         Compile out native modules: audio,display,hooks\n\n"
+                      << "Optimized builds use $CXX (default c++); clang also needs llvm-profdata.\n\n"
                       << "Examples:\n"
                       << "  levython build app.levy -o app\n"
+                      << "  levython build app.levy --pgo --without audio,display,hooks -o app\n"
                       << "  levython build app.levy --target windows -o app.exe\n"
                       << "  levython build app.levy --target aarch64-macos -o app-mac\n";
             return 0;
@@ -28274,6 +37542,24 @@ int main(int argc, char* argv[]) {
                 opts.source_root = argv[++i];
             } else if (arg == "--verbose") {
                 opts.verbose = true;
+            } else if (arg == "--pgo") {
+                opts.pgo = true;
+            } else if (arg == "--lto") {
+                opts.lto = true;
+            } else if (arg == "--train" && i + 1 < argc) {
+                opts.train_script = argv[++i];
+            } else if (arg == "--without" && i + 1 < argc) {
+                std::stringstream list(argv[++i]);
+                std::string name;
+                while (std::getline(list, name, ',')) {
+                    if (name.empty()) continue;
+                    if (!module_macro(name)) {
+                        std::cerr << "Unknown module for --without: " << name
+                                  << " (expected audio, display or hooks)" << std::endl;
+                        return 1;
+                    }
+                    opts.without.push_back(name);
+                }
             } else {
                 std::cerr << "Unknown build argument: " << arg << std::endl;
                 return 1;
@@ -28303,11 +37589,19 @@ int main(int argc, char* argv[]) {
     
     bool show_version = false;
     bool no_update_check = false;
+    bool dump_bytecode = false;
     std::string file;
     
     for (int i = 1; i < argc; i++) {
         std::string arg = argv[i];
         if (arg == "--no-update-check") no_update_check = true;
+        else if (arg == "--heap-stats") std::atexit(print_heap_stats);
+        else if (arg == "--profile") profiler::start("", false);
+        else if (arg.rfind("--profile=", 0) == 0) profiler::start(arg.substr(10), false);
+        else if (arg == "--profile-ops") profiler::start("", true);
+        else if (arg.rfind("--profile-ops=", 0) == 0) profiler::start(arg.substr(14), true);
+        else if (arg == "--no-cache") bytecode_cache::g_enabled = false;
+        else if (arg == "--dump-bytecode") dump_bytecode = true;
         else if (arg == "--version" || arg == "-v") show_version = true;
         else if (arg == "--help" || arg == "-h") {
             std::cout << "╔══════════════════════════════════════════════════════════════════════╗\n";
@@ -28320,6 +37614,11 @@ int main(int argc, char* argv[]) {
             std::cout << "║    --help, -h        Show this help message                          ║\n";
             std::cout << "║    --version, -v     Show version information                        ║\n";
             std::cout << "║    --no-update-check Disable automatic update check                  ║\n";
+            std::cout << "║    --heap-stats      Print allocator and GC statistics on exit       ║\n";
+            std::cout << "║    --no-cache        Skip the .levyc bytecode cache                  ║\n";
+            std::cout << "║    --profile[=file]  Sample call stacks; JSON + .folded report       ║\n";
+            std::cout << "║    --profile-ops     --profile plus exact per-opcode counts          ║\n";
+            std::cout << "║    --dump-bytecode   Print the optimized bytecode instead of running ║\n";
             std::cout << "║                                                                      ║\n";
             std::cout << "║  Commands:                                                           ║\n";
             std::cout << "║    levython lpm <cmd>     Package manager                            ║\n";
@@ -28343,7 +37642,7 @@ int main(int argc, char* argv[]) {
     if (file.empty()) {
         std::string embedded_source;
         if (packager::extract_embedded_payload(argv[0], embedded_source)) {
-            return execute_levython_source(embedded_source);
+            return execute_embedded_payload(embedded_source);
         }
     }
     
@@ -28361,6 +37660,13 @@ int main(int argc, char* argv[]) {
     std::ifstream ifs(file);
     if (!ifs) { std::cerr << "Cannot open: " << file << std::endl; return 1; }
     std::string code((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    g_script_dir = fs::path(file).parent_path();
+
+    if (dump_bytecode) {
+        auto chunk = bytecode_cache::compile(code);
+        bytecode::disassemble(*chunk, "<main>", std::cout);
+        return 0;
+    }
     
     return execute_levython_source(code);
 }
\ No newline at end of file